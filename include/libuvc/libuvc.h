@@ -358,6 +358,67 @@ typedef struct uvc_device uvc_device_t;
 struct uvc_device_handle;
 typedef struct uvc_device_handle uvc_device_handle_t;
 
+/** Flags for uvc_open_with_flags()
+ * @ingroup device
+ */
+enum uvc_open_flag {
+  /** Parse a VideoStreaming interface's descriptors when it is first used,
+   * rather than all of them at open time */
+  UVC_OPEN_DEFER_STREAMING = 1 << 0,
+  /** Do not read the status interrupt endpoint; status and button
+   * callbacks will not be called */
+  UVC_OPEN_NO_STATUS = 1 << 1,
+};
+
+/** Ways in which a device departs from the UVC specification
+ * @ingroup quirks
+ */
+enum uvc_quirk_flag {
+  /** Not a UVC device, although its interfaces look like one */
+  UVC_QUIRK_NOT_UVC = 1 << 0,
+  /** The video interfaces use the vendor-specific class (255) */
+  UVC_QUIRK_VENDOR_CLASS = 1 << 1,
+  /** Only payloads tagged with the iSight signature carry a header; all
+   * others are image data */
+  UVC_QUIRK_HEADER_ISIGHT = 1 << 2,
+  /** Payload header lengths do not follow from the PTS and SCR flags, and
+   * may exceed the usual 12 bytes */
+  UVC_QUIRK_HEADER_LENGTH = 1 << 3,
+  /** The reserved payload header bit may be set */
+  UVC_QUIRK_HEADER_RESERVED = 1 << 4,
+  /** Probe and commit with the 26-byte UVC 1.0 block, whatever bcdUVC says */
+  UVC_QUIRK_PROBE_SHORT = 1 << 5,
+  /** dwMaxPayloadTransferSize of uncompressed modes is too large; estimate
+   * it from the frame size and rate instead */
+  UVC_QUIRK_FIX_BANDWIDTH = 1 << 6,
+  /** Always negotiate with the device; never reuse probe results */
+  UVC_QUIRK_PROBE_NO_CACHE = 1 << 7,
+};
+
+/** Workarounds and streaming parameters for a range of devices
+ * @ingroup quirks
+ *
+ * See uvc_load_quirks(). Zeroed tuning fields mean "library default".
+ */
+typedef struct uvc_quirks {
+  /** Devices the entry applies to; the ranges are inclusive */
+  uint16_t idVendor;
+  uint16_t idProduct_min, idProduct_max;
+  uint16_t bcdDevice_min, bcdDevice_max;
+  /** Combination of enum uvc_quirk_flag */
+  uint32_t flags;
+  /** Transfers kept in flight while streaming */
+  uint16_t num_transfers;
+  /** Packets per isochronous transfer; by default a transfer holds up
+   * to one frame, at most 32 packets */
+  uint16_t packets_per_transfer;
+  /** Bytes per bulk transfer; by default dwMaxPayloadTransferSize */
+  uint32_t bulk_transfer_size;
+  /** A dwMaxVideoFrameSize the device reports wrongly, to be replaced by
+   * the size the frame descriptor implies; 0xffffffff for any value */
+  uint32_t bad_frame_size;
+} uvc_quirks_t;
+
 /** Handle on an open UVC stream.
  *
  * Get one of these from uvc_stream_open*().
@@ -444,6 +505,47 @@ typedef void(uvc_button_callback_t)(int button,
                                     int state,
                                     void *user_ptr);
 
+/** Longest status packet kept in a queued event */
+#define UVC_STATUS_EVENT_MAX_LEN 64
+
+/** A status interrupt packet taken off the queue (see uvc_set_status_queue_enabled())
+ * @ingroup device
+ */
+typedef struct uvc_status_event {
+  /** When the packet arrived (CLOCK_MONOTONIC, microseconds) */
+  uint64_t timestamp_us;
+  /** The packet as the device sent it: bStatusType, bOriginator, then
+   * bEvent, bSelector, bAttribute and the value for VideoControl events,
+   * or bEvent and bValue for VideoStreaming (button) events */
+  uint8_t data[UVC_STATUS_EVENT_MAX_LEN];
+  size_t data_len;
+} uvc_status_event_t;
+
+/** Status event counters (see uvc_get_status_stats())
+ * @ingroup device
+ */
+typedef struct uvc_status_stats {
+  /** Packets received while the queue existed */
+  uint64_t received;
+  /** Packets queued */
+  uint64_t queued;
+  /** Packets dropped because the queue was full */
+  uint64_t lost;
+  /** Events waiting in the queue */
+  uint32_t pending;
+  /** Status transfers currently submitted */
+  int transfers_in_flight;
+} uvc_status_stats_t;
+
+/** A callback function to accept the result of an asynchronous control request
+ * @ingroup ctrl
+ *
+ * @param result Number of bytes transferred or a uvc_error_t; UVC_SUCCESS
+ *   for the generated uvc_get_*_async and uvc_set_*_async accessors
+ * @param data Bytes read or sent, valid only during the call
+ */
+typedef void(uvc_ctrl_callback_t)(int result, void *data, void *user_ptr);
+
 /** Structure representing a UVC device descriptor.
  *
  * (This isn't a standard structure.)
@@ -516,11 +618,78 @@ typedef struct uvc_frame {
 
 } uvc_frame_t;
 
+/** Where and how uvc_get_frame_stats() measures a frame
+ * @ingroup frame
+ */
+typedef struct uvc_frame_stats_params {
+  /** The frame is split into grid_cols x grid_rows cells, each measured separately */
+  int grid_cols, grid_rows;
+  /** Luma at or below clip_low, or at or above clip_high, counts as clipped */
+  uint8_t clip_low, clip_high;
+  /** Measure every row_step-th row only */
+  int row_step;
+} uvc_frame_stats_params_t;
+
+/** Luma statistics of one cell of a frame (see uvc_get_frame_stats())
+ * @ingroup frame
+ */
+typedef struct uvc_frame_stats {
+  /** Luma histogram */
+  uint32_t hist[256];
+  /** Samples measured: pixels, or 8x8 blocks for MJPEG */
+  uint32_t samples;
+  /** Mean luma, 0 to 255 */
+  double mean;
+  /** Fraction of samples at or below clip_low and at or above clip_high */
+  double clipped_low, clipped_high;
+  /** Gradient energy: mean of dx^2 + dy^2 over the samples */
+  double sharpness;
+} uvc_frame_stats_t;
+
 /** A callback function to handle incoming assembled UVC frames
  * @ingroup streaming
  */
 typedef void(uvc_frame_callback_t)(struct uvc_frame *frame, void *user_ptr);
 
+/** What happened to a resumable stream's device (see uvc_stream_set_resume_enabled())
+ * @ingroup streaming
+ */
+enum uvc_stream_resume_event {
+  /** The device dropped off the bus; delivery has stopped */
+  UVC_STREAM_DEVICE_LOST,
+  /** The device came back and frames are being delivered again */
+  UVC_STREAM_RESUMED,
+  /** The device did not come back within the timeout; the stream stays dead */
+  UVC_STREAM_RESUME_FAILED
+};
+
+/** A callback function to learn about a resumable stream's outages
+ * @ingroup streaming
+ *
+ * Called on the stream's resume thread, never with a lock held.
+ *
+ * @param outage_us How long the device was gone; 0 for UVC_STREAM_DEVICE_LOST
+ */
+typedef void(uvc_stream_resume_callback_t)(uvc_stream_handle_t *strmh,
+                                           enum uvc_stream_resume_event event,
+                                           uint64_t outage_us,
+                                           void *user_ptr);
+
+/** Outage counters of a resumable stream (see uvc_stream_get_resume_stats())
+ * @ingroup streaming
+ */
+typedef struct uvc_stream_resume_stats {
+  /** Times the device was lost */
+  uint32_t outages;
+  /** Times the stream was resumed */
+  uint32_t resumes;
+  /** Duration of the most recent and the longest resumed outage */
+  uint64_t last_outage_us;
+  uint64_t max_outage_us;
+  /** Time spent without the device, including an outage in progress */
+  uint64_t total_outage_us;
+} uvc_stream_resume_stats_t;
+
 /** Streaming mode, includes all information needed to select stream
  * @ingroup streaming
  */
@@ -544,6 +713,50 @@ typedef struct uvc_stream_ctrl {
   uint8_t bInterfaceNumber;
 } uvc_stream_ctrl_t;
 
+/** What uvc_select_stream_mode() should look for
+ * @ingroup streaming
+ *
+ * Zeroed fields (see uvc_mode_prefs_init()) mean "no preference".
+ */
+typedef struct uvc_mode_prefs {
+  /** Acceptable formats, most preferred first; abstract formats such as
+   * UVC_FRAME_FORMAT_COMPRESSED match all their members. NULL accepts any
+   * format libuvc knows */
+  const enum uvc_frame_format *formats;
+  int num_formats;
+  /** Resolution to get as close to as possible; larger beats smaller. With
+   * neither set, the largest resolution wins */
+  int width, height;
+  /** Lowest acceptable frame rate; the slowest rate above it wins. With
+   * none set, the fastest rate wins */
+  double min_fps;
+  /** Highest acceptable bandwidth, in bytes per second */
+  uint64_t max_bandwidth;
+  /** Required aspect ratio, e.g. 16 and 9, within 1% */
+  int aspect_num, aspect_den;
+  /** Candidates to probe before giving up (default 4) */
+  int max_attempts;
+} uvc_mode_prefs_t;
+
+/** A streaming mode scored by uvc_rank_stream_modes()
+ * @ingroup streaming
+ */
+typedef struct uvc_mode_candidate {
+  const uvc_frame_desc_t *frame_desc;
+  enum uvc_frame_format frame_format;
+  uint8_t bInterfaceNumber;
+  uint8_t bFormatIndex;
+  uint8_t bFrameIndex;
+  uint32_t dwFrameInterval;
+  double fps;
+  /** Worst-case bytes per second */
+  uint64_t bandwidth;
+  /** Lower is better */
+  double score;
+  /** Position in descriptor order; breaks ties in score and bandwidth */
+  int desc_index;
+} uvc_mode_candidate_t;
+
 typedef struct uvc_still_ctrl {
   /* Video format index from a format descriptor */
   uint8_t bFormatIndex;
@@ -560,6 +773,9 @@ typedef struct uvc_still_ctrl {
 
 uvc_error_t uvc_init(uvc_context_t **ctx, struct libusb_context *usb_ctx);
 void uvc_exit(uvc_context_t *ctx);
+uvc_error_t uvc_set_desc_cache_dir(uvc_context_t *ctx, const char *dir);
+uvc_error_t uvc_set_probe_cache(uvc_context_t *ctx, int enabled, const char *dir);
+uvc_error_t uvc_load_quirks(uvc_context_t *ctx, const char *path);
 
 uvc_error_t uvc_get_device_list(
     uvc_context_t *ctx,
@@ -585,6 +801,13 @@ uvc_error_t uvc_find_devices(
     uvc_device_t ***devs,
     int vid, int pid, const char *sn);
 
+uvc_error_t uvc_find_device_by_port(
+    uvc_context_t *ctx,
+    uvc_device_t **dev,
+    uint8_t bus, const uint8_t *ports, int num_ports);
+
+uvc_error_t uvc_set_device_index_enabled(uvc_context_t *ctx, int enabled);
+
 #if LIBUSB_API_VERSION >= 0x01000107
 uvc_error_t uvc_wrap(
     int sys_dev,
@@ -595,7 +818,12 @@ uvc_error_t uvc_wrap(
 uvc_error_t uvc_open(
     uvc_device_t *dev,
     uvc_device_handle_t **devh);
+uvc_error_t uvc_open_with_flags(
+    uvc_device_t *dev,
+    uvc_device_handle_t **devh,
+    int flags);
 void uvc_close(uvc_device_handle_t *devh);
+const uvc_quirks_t *uvc_get_quirks(uvc_device_handle_t *devh);
 
 uvc_device_t *uvc_get_device(uvc_device_handle_t *devh);
 struct libusb_device_handle *uvc_get_libusb_handle(uvc_device_handle_t *devh);
@@ -611,6 +839,13 @@ void uvc_set_button_callback(uvc_device_handle_t *devh,
                              uvc_button_callback_t cb,
                              void *user_ptr);
 
+uvc_error_t uvc_set_status_queue_enabled(uvc_device_handle_t *devh, int enabled);
+int uvc_get_status_fd(uvc_device_handle_t *devh);
+uvc_error_t uvc_read_status_event(uvc_device_handle_t *devh, uvc_status_event_t *event,
+                                  int timeout_ms);
+int uvc_dispatch_status_events(uvc_device_handle_t *devh);
+void uvc_get_status_stats(uvc_device_handle_t *devh, uvc_status_stats_t *stats);
+
 const uvc_input_terminal_t *uvc_get_camera_terminal(uvc_device_handle_t *devh);
 const uvc_input_terminal_t *uvc_get_input_terminals(uvc_device_handle_t *devh);
 const uvc_output_terminal_t *uvc_get_output_terminals(uvc_device_handle_t *devh);
@@ -626,6 +861,13 @@ uvc_error_t uvc_get_stream_ctrl_format_size(
     int fps
     );
 
+void uvc_mode_prefs_init(uvc_mode_prefs_t *prefs);
+int uvc_rank_stream_modes(uvc_device_handle_t *devh, const uvc_mode_prefs_t *prefs,
+                          uvc_mode_candidate_t *modes, int max_modes);
+uvc_error_t uvc_select_stream_mode(uvc_device_handle_t *devh, uvc_stream_ctrl_t *ctrl,
+                                   const uvc_mode_prefs_t *prefs,
+                                   uvc_mode_candidate_t *chosen);
+
 uvc_error_t uvc_get_still_ctrl_format_size(
     uvc_device_handle_t *devh,
     uvc_stream_ctrl_t *ctrl,
@@ -677,134 +919,415 @@ uvc_error_t uvc_stream_get_frame(
 );
 uvc_error_t uvc_stream_stop(uvc_stream_handle_t *strmh);
 void uvc_stream_close(uvc_stream_handle_t *strmh);
+uvc_error_t uvc_stream_set_resume_enabled(uvc_stream_handle_t *strmh, int enabled,
+                                          uint32_t timeout_ms);
+void uvc_stream_set_resume_callback(uvc_stream_handle_t *strmh,
+                                    uvc_stream_resume_callback_t cb,
+                                    void *user_ptr);
+void uvc_stream_get_resume_stats(uvc_stream_handle_t *strmh,
+                                 uvc_stream_resume_stats_t *stats);
 
 int uvc_get_ctrl_len(uvc_device_handle_t *devh, uint8_t unit, uint8_t ctrl);
 int uvc_get_ctrl(uvc_device_handle_t *devh, uint8_t unit, uint8_t ctrl, void *data, int len, enum uvc_req_code req_code);
 int uvc_set_ctrl(uvc_device_handle_t *devh, uint8_t unit, uint8_t ctrl, void *data, int len);
 
+void uvc_set_ctrl_cache_enabled(uvc_device_handle_t *devh, int enabled);
+uvc_error_t uvc_prefetch_ctrl_ranges(uvc_device_handle_t *devh);
+void uvc_invalidate_ctrl_cache(uvc_device_handle_t *devh);
+
+/** Staleness bound meaning a cached current value is kept until the device
+ * reports a change (see uvc_set_ctrl_cur_cache()) */
+#define UVC_CTRL_CUR_NO_EXPIRY 0xffffffffu
+
+void uvc_set_ctrl_cur_cache(uvc_device_handle_t *devh, int enabled, uint32_t max_age_ms);
+uvc_error_t uvc_set_ctrl_cur_max_age(uvc_device_handle_t *devh, uint8_t unit, uint8_t ctrl,
+                                     uint32_t max_age_ms);
+
+uvc_error_t uvc_get_ctrl_async(uvc_device_handle_t *devh, uint8_t unit, uint8_t ctrl, int len,
+                               enum uvc_req_code req_code, uvc_ctrl_callback_t *cb,
+                               void *user_ptr);
+uvc_error_t uvc_set_ctrl_async(uvc_device_handle_t *devh, uint8_t unit, uint8_t ctrl,
+                               const void *data, int len, uvc_ctrl_callback_t *cb,
+                               void *user_ptr);
+void uvc_wait_ctrl_async(uvc_device_handle_t *devh);
+void uvc_cancel_ctrl_async(uvc_device_handle_t *devh);
+
+/** Counters of the control writer thread
+ * @ingroup ctrl
+ */
+typedef struct uvc_ctrl_writer_stats {
+  /** Values written by the application */
+  uint64_t queued;
+  /** Values sent to the device successfully */
+  uint64_t applied;
+  /** Values replaced by a newer one before they were sent */
+  uint64_t coalesced;
+  /** Values the device rejected or that could not be sent */
+  uint64_t failed;
+  /** Error of the last failed send */
+  uvc_error_t last_error;
+  /** Longest time from a value being written to it being applied */
+  uint64_t max_latency_us;
+} uvc_ctrl_writer_stats_t;
+
+/** Most fields a standard control's value has */
+#define UVC_CTRL_MAX_FIELDS 8
+
+/** Decoded state of one standard control, from uvc_read_all_controls()
+ * @ingroup ctrl
+ */
+typedef struct uvc_ctrl_snapshot {
+  /** Control name, as in the uvc_get_* accessor (e.g. "brightness") */
+  const char *name;
+  /** Unit or terminal ID and control selector */
+  uint8_t unit;
+  uint8_t selector;
+  /** UVC_CONTROL_CAP_* bits from GET_INFO */
+  uint8_t info;
+  /** Bit (req_code - UVC_GET_CUR) set: the values for req_code were read */
+  uint8_t valid;
+  uint8_t num_fields;
+  const char *field_names[UVC_CTRL_MAX_FIELDS];
+  int64_t cur[UVC_CTRL_MAX_FIELDS];
+  int64_t min[UVC_CTRL_MAX_FIELDS];
+  int64_t max[UVC_CTRL_MAX_FIELDS];
+  int64_t res[UVC_CTRL_MAX_FIELDS];
+  int64_t def[UVC_CTRL_MAX_FIELDS];
+} uvc_ctrl_snapshot_t;
+
+uvc_error_t uvc_read_all_controls(uvc_device_handle_t *devh, uvc_ctrl_snapshot_t **snapshots,
+                                  size_t *count);
+void uvc_free_ctrl_snapshots(uvc_ctrl_snapshot_t *snapshots);
+
+/** Saved settings of a device's controls (see uvc_capture_ctrl_profile())
+ * @ingroup ctrl
+ */
+typedef struct uvc_ctrl_profile uvc_ctrl_profile_t;
+
+/** What uvc_apply_ctrl_profile() did
+ * @ingroup ctrl
+ */
+typedef struct uvc_ctrl_profile_result {
+  /** Controls written because their value differed */
+  size_t sent;
+  /** Controls already at the profile's value */
+  size_t unchanged;
+  /** Controls the device lacks, or reports as read-only or disabled */
+  size_t skipped;
+  /** Controls that could not be read or written */
+  size_t failed;
+} uvc_ctrl_profile_result_t;
+
+uvc_error_t uvc_capture_ctrl_profile(uvc_device_handle_t *devh, uvc_ctrl_profile_t **profile);
+uvc_error_t uvc_apply_ctrl_profile(uvc_device_handle_t *devh, const uvc_ctrl_profile_t *profile,
+                                   uvc_ctrl_profile_result_t *result);
+size_t uvc_get_ctrl_profile_size(const uvc_ctrl_profile_t *profile);
+uvc_error_t uvc_serialize_ctrl_profile(const uvc_ctrl_profile_t *profile, void **data,
+                                       size_t *size);
+uvc_error_t uvc_deserialize_ctrl_profile(const void *data, size_t size,
+                                         uvc_ctrl_profile_t **profile);
+void uvc_free_ctrl_profile(uvc_ctrl_profile_t *profile);
+
+/** Per-frame statistic watched by uvc_measure_ctrl_settle()
+ * @ingroup ctrl
+ */
+enum uvc_settle_metric {
+  /** Mean luma; follows exposure, gain and brightness */
+  UVC_SETTLE_MEAN_LUMA,
+  /** Luma gradient energy; follows focus */
+  UVC_SETTLE_SHARPNESS
+};
+
+/** When uvc_measure_ctrl_settle() considers the image moved and settled
+ * @ingroup ctrl
+ */
+typedef struct uvc_settle_params {
+  enum uvc_settle_metric metric;
+  /** Frames averaged for the baseline before the write */
+  int baseline_frames;
+  /** Smallest relative change of the statistic counted as movement */
+  double tolerance;
+  /** Consecutive unmoving frames that make the image settled */
+  int stable_frames;
+  /** Frames after the write before giving up */
+  int max_frames;
+  /** Longest wait for any one frame, in microseconds */
+  int32_t frame_timeout_us;
+} uvc_settle_params_t;
+
+/** Result of uvc_measure_ctrl_settle()
+ * @ingroup ctrl
+ */
+typedef struct uvc_settle_result {
+  /** Sequence number of the last frame completed when the write returned */
+  uint32_t issue_sequence;
+  /** First frame, counted from issue_sequence, whose statistic moved; -1 if none did */
+  int response_frames;
+  /** Frame, counted from issue_sequence, at which the statistic settled; -1 if it did not */
+  int settle_frames;
+  /** Time from the end of the write to the settled frame's arrival */
+  double settle_us;
+  /** Duration of the control write itself */
+  double write_us;
+  /** Statistic before the write, and on the last frame examined */
+  double baseline, settled;
+  /** Change of the statistic counted as movement */
+  double threshold;
+  /** Frames examined after the write, and sequence numbers skipped among them */
+  int frames_seen, frames_skipped;
+} uvc_settle_result_t;
+
+void uvc_settle_params_init(uvc_settle_params_t *params);
+uvc_error_t uvc_measure_ctrl_settle(uvc_stream_handle_t *strmh, uint8_t unit, uint8_t selector,
+                                    const void *data, int len, const uvc_settle_params_t *params,
+                                    uvc_settle_result_t *result);
+
+/** Queued extension unit writes (see uvc_xu_batch_create())
+ * @ingroup ctrl
+ */
+typedef struct uvc_xu_batch uvc_xu_batch_t;
+
+/** What uvc_xu_batch_submit() did
+ * @ingroup ctrl
+ */
+typedef struct uvc_xu_batch_result {
+  /** Writes that reached the device */
+  size_t sent;
+  /** Writes of values the controls already held */
+  size_t skipped;
+  /** Writes that failed */
+  size_t failed;
+  /** Writes not attempted because an earlier one failed */
+  size_t unsent;
+  /** Error of the first failed write, and its position in the batch */
+  uvc_error_t first_error;
+  size_t first_failed;
+} uvc_xu_batch_result_t;
+
+int uvc_xu_get_len(uvc_device_handle_t *devh, uint8_t unit, uint8_t selector);
+int uvc_xu_get(uvc_device_handle_t *devh, uint8_t unit, uint8_t selector, void *data, int len,
+               enum uvc_req_code req_code);
+int uvc_xu_set(uvc_device_handle_t *devh, uint8_t unit, uint8_t selector, const void *data,
+               int len);
+int uvc_xu_get_shadow(uvc_device_handle_t *devh, uint8_t unit, uint8_t selector, void *data,
+                      int len);
+uvc_error_t uvc_xu_set_volatile(uvc_device_handle_t *devh, uint8_t unit, uint8_t selector,
+                                int is_volatile);
+uvc_error_t uvc_xu_batch_create(uvc_device_handle_t *devh, uvc_xu_batch_t **batch);
+uvc_error_t uvc_xu_batch_add(uvc_xu_batch_t *batch, uint8_t unit, uint8_t selector,
+                             const void *data, int len);
+uvc_error_t uvc_xu_batch_submit(uvc_xu_batch_t *batch, int max_in_flight,
+                                uvc_xu_batch_result_t *result);
+void uvc_xu_batch_clear(uvc_xu_batch_t *batch);
+void uvc_xu_batch_free(uvc_xu_batch_t *batch);
+
+uvc_error_t uvc_start_ctrl_writer(uvc_device_handle_t *devh, uint32_t max_rate_hz);
+void uvc_stop_ctrl_writer(uvc_device_handle_t *devh);
+uvc_error_t uvc_get_ctrl_writer_stats(uvc_device_handle_t *devh, uvc_ctrl_writer_stats_t *stats);
+
 uvc_error_t uvc_get_power_mode(uvc_device_handle_t *devh, enum uvc_device_power_mode *mode, enum uvc_req_code req_code);
 uvc_error_t uvc_set_power_mode(uvc_device_handle_t *devh, enum uvc_device_power_mode mode);
 
 /* AUTO-GENERATED control accessors! Update them with the output of `ctrl-gen.py decl`. */
 uvc_error_t uvc_get_scanning_mode(uvc_device_handle_t *devh, uint8_t* mode, enum uvc_req_code req_code);
 uvc_error_t uvc_set_scanning_mode(uvc_device_handle_t *devh, uint8_t mode);
+uvc_error_t uvc_get_scanning_mode_async(uvc_device_handle_t *devh, uint8_t* mode, enum uvc_req_code req_code, uvc_ctrl_callback_t *cb, void *user_ptr);
+uvc_error_t uvc_set_scanning_mode_async(uvc_device_handle_t *devh, uint8_t mode, uvc_ctrl_callback_t *cb, void *user_ptr);
 
 uvc_error_t uvc_get_ae_mode(uvc_device_handle_t *devh, uint8_t* mode, enum uvc_req_code req_code);
 uvc_error_t uvc_set_ae_mode(uvc_device_handle_t *devh, uint8_t mode);
+uvc_error_t uvc_get_ae_mode_async(uvc_device_handle_t *devh, uint8_t* mode, enum uvc_req_code req_code, uvc_ctrl_callback_t *cb, void *user_ptr);
+uvc_error_t uvc_set_ae_mode_async(uvc_device_handle_t *devh, uint8_t mode, uvc_ctrl_callback_t *cb, void *user_ptr);
 
 uvc_error_t uvc_get_ae_priority(uvc_device_handle_t *devh, uint8_t* priority, enum uvc_req_code req_code);
 uvc_error_t uvc_set_ae_priority(uvc_device_handle_t *devh, uint8_t priority);
+uvc_error_t uvc_get_ae_priority_async(uvc_device_handle_t *devh, uint8_t* priority, enum uvc_req_code req_code, uvc_ctrl_callback_t *cb, void *user_ptr);
+uvc_error_t uvc_set_ae_priority_async(uvc_device_handle_t *devh, uint8_t priority, uvc_ctrl_callback_t *cb, void *user_ptr);
 
 uvc_error_t uvc_get_exposure_abs(uvc_device_handle_t *devh, uint32_t* time, enum uvc_req_code req_code);
 uvc_error_t uvc_set_exposure_abs(uvc_device_handle_t *devh, uint32_t time);
+uvc_error_t uvc_get_exposure_abs_async(uvc_device_handle_t *devh, uint32_t* time, enum uvc_req_code req_code, uvc_ctrl_callback_t *cb, void *user_ptr);
+uvc_error_t uvc_set_exposure_abs_async(uvc_device_handle_t *devh, uint32_t time, uvc_ctrl_callback_t *cb, void *user_ptr);
 
 uvc_error_t uvc_get_exposure_rel(uvc_device_handle_t *devh, int8_t* step, enum uvc_req_code req_code);
 uvc_error_t uvc_set_exposure_rel(uvc_device_handle_t *devh, int8_t step);
+uvc_error_t uvc_get_exposure_rel_async(uvc_device_handle_t *devh, int8_t* step, enum uvc_req_code req_code, uvc_ctrl_callback_t *cb, void *user_ptr);
+uvc_error_t uvc_set_exposure_rel_async(uvc_device_handle_t *devh, int8_t step, uvc_ctrl_callback_t *cb, void *user_ptr);
 
 uvc_error_t uvc_get_focus_abs(uvc_device_handle_t *devh, uint16_t* focus, enum uvc_req_code req_code);
 uvc_error_t uvc_set_focus_abs(uvc_device_handle_t *devh, uint16_t focus);
+uvc_error_t uvc_get_focus_abs_async(uvc_device_handle_t *devh, uint16_t* focus, enum uvc_req_code req_code, uvc_ctrl_callback_t *cb, void *user_ptr);
+uvc_error_t uvc_set_focus_abs_async(uvc_device_handle_t *devh, uint16_t focus, uvc_ctrl_callback_t *cb, void *user_ptr);
 
 uvc_error_t uvc_get_focus_rel(uvc_device_handle_t *devh, int8_t* focus_rel, uint8_t* speed, enum uvc_req_code req_code);
 uvc_error_t uvc_set_focus_rel(uvc_device_handle_t *devh, int8_t focus_rel, uint8_t speed);
+uvc_error_t uvc_get_focus_rel_async(uvc_device_handle_t *devh, int8_t* focus_rel, uint8_t* speed, enum uvc_req_code req_code, uvc_ctrl_callback_t *cb, void *user_ptr);
+uvc_error_t uvc_set_focus_rel_async(uvc_device_handle_t *devh, int8_t focus_rel, uint8_t speed, uvc_ctrl_callback_t *cb, void *user_ptr);
 
 uvc_error_t uvc_get_focus_simple_range(uvc_device_handle_t *devh, uint8_t* focus, enum uvc_req_code req_code);
 uvc_error_t uvc_set_focus_simple_range(uvc_device_handle_t *devh, uint8_t focus);
+uvc_error_t uvc_get_focus_simple_range_async(uvc_device_handle_t *devh, uint8_t* focus, enum uvc_req_code req_code, uvc_ctrl_callback_t *cb, void *user_ptr);
+uvc_error_t uvc_set_focus_simple_range_async(uvc_device_handle_t *devh, uint8_t focus, uvc_ctrl_callback_t *cb, void *user_ptr);
 
 uvc_error_t uvc_get_focus_auto(uvc_device_handle_t *devh, uint8_t* state, enum uvc_req_code req_code);
 uvc_error_t uvc_set_focus_auto(uvc_device_handle_t *devh, uint8_t state);
+uvc_error_t uvc_get_focus_auto_async(uvc_device_handle_t *devh, uint8_t* state, enum uvc_req_code req_code, uvc_ctrl_callback_t *cb, void *user_ptr);
+uvc_error_t uvc_set_focus_auto_async(uvc_device_handle_t *devh, uint8_t state, uvc_ctrl_callback_t *cb, void *user_ptr);
 
 uvc_error_t uvc_get_iris_abs(uvc_device_handle_t *devh, uint16_t* iris, enum uvc_req_code req_code);
 uvc_error_t uvc_set_iris_abs(uvc_device_handle_t *devh, uint16_t iris);
+uvc_error_t uvc_get_iris_abs_async(uvc_device_handle_t *devh, uint16_t* iris, enum uvc_req_code req_code, uvc_ctrl_callback_t *cb, void *user_ptr);
+uvc_error_t uvc_set_iris_abs_async(uvc_device_handle_t *devh, uint16_t iris, uvc_ctrl_callback_t *cb, void *user_ptr);
 
 uvc_error_t uvc_get_iris_rel(uvc_device_handle_t *devh, uint8_t* iris_rel, enum uvc_req_code req_code);
 uvc_error_t uvc_set_iris_rel(uvc_device_handle_t *devh, uint8_t iris_rel);
+uvc_error_t uvc_get_iris_rel_async(uvc_device_handle_t *devh, uint8_t* iris_rel, enum uvc_req_code req_code, uvc_ctrl_callback_t *cb, void *user_ptr);
+uvc_error_t uvc_set_iris_rel_async(uvc_device_handle_t *devh, uint8_t iris_rel, uvc_ctrl_callback_t *cb, void *user_ptr);
 
 uvc_error_t uvc_get_zoom_abs(uvc_device_handle_t *devh, uint16_t* focal_length, enum uvc_req_code req_code);
 uvc_error_t uvc_set_zoom_abs(uvc_device_handle_t *devh, uint16_t focal_length);
+uvc_error_t uvc_get_zoom_abs_async(uvc_device_handle_t *devh, uint16_t* focal_length, enum uvc_req_code req_code, uvc_ctrl_callback_t *cb, void *user_ptr);
+uvc_error_t uvc_set_zoom_abs_async(uvc_device_handle_t *devh, uint16_t focal_length, uvc_ctrl_callback_t *cb, void *user_ptr);
 
 uvc_error_t uvc_get_zoom_rel(uvc_device_handle_t *devh, int8_t* zoom_rel, uint8_t* digital_zoom, uint8_t* speed, enum uvc_req_code req_code);
 uvc_error_t uvc_set_zoom_rel(uvc_device_handle_t *devh, int8_t zoom_rel, uint8_t digital_zoom, uint8_t speed);
+uvc_error_t uvc_get_zoom_rel_async(uvc_device_handle_t *devh, int8_t* zoom_rel, uint8_t* digital_zoom, uint8_t* speed, enum uvc_req_code req_code, uvc_ctrl_callback_t *cb, void *user_ptr);
+uvc_error_t uvc_set_zoom_rel_async(uvc_device_handle_t *devh, int8_t zoom_rel, uint8_t digital_zoom, uint8_t speed, uvc_ctrl_callback_t *cb, void *user_ptr);
 
 uvc_error_t uvc_get_pantilt_abs(uvc_device_handle_t *devh, int32_t* pan, int32_t* tilt, enum uvc_req_code req_code);
 uvc_error_t uvc_set_pantilt_abs(uvc_device_handle_t *devh, int32_t pan, int32_t tilt);
+uvc_error_t uvc_get_pantilt_abs_async(uvc_device_handle_t *devh, int32_t* pan, int32_t* tilt, enum uvc_req_code req_code, uvc_ctrl_callback_t *cb, void *user_ptr);
+uvc_error_t uvc_set_pantilt_abs_async(uvc_device_handle_t *devh, int32_t pan, int32_t tilt, uvc_ctrl_callback_t *cb, void *user_ptr);
 
 uvc_error_t uvc_get_pantilt_rel(uvc_device_handle_t *devh, int8_t* pan_rel, uint8_t* pan_speed, int8_t* tilt_rel, uint8_t* tilt_speed, enum uvc_req_code req_code);
 uvc_error_t uvc_set_pantilt_rel(uvc_device_handle_t *devh, int8_t pan_rel, uint8_t pan_speed, int8_t tilt_rel, uint8_t tilt_speed);
+uvc_error_t uvc_get_pantilt_rel_async(uvc_device_handle_t *devh, int8_t* pan_rel, uint8_t* pan_speed, int8_t* tilt_rel, uint8_t* tilt_speed, enum uvc_req_code req_code, uvc_ctrl_callback_t *cb, void *user_ptr);
+uvc_error_t uvc_set_pantilt_rel_async(uvc_device_handle_t *devh, int8_t pan_rel, uint8_t pan_speed, int8_t tilt_rel, uint8_t tilt_speed, uvc_ctrl_callback_t *cb, void *user_ptr);
 
 uvc_error_t uvc_get_roll_abs(uvc_device_handle_t *devh, int16_t* roll, enum uvc_req_code req_code);
 uvc_error_t uvc_set_roll_abs(uvc_device_handle_t *devh, int16_t roll);
+uvc_error_t uvc_get_roll_abs_async(uvc_device_handle_t *devh, int16_t* roll, enum uvc_req_code req_code, uvc_ctrl_callback_t *cb, void *user_ptr);
+uvc_error_t uvc_set_roll_abs_async(uvc_device_handle_t *devh, int16_t roll, uvc_ctrl_callback_t *cb, void *user_ptr);
 
 uvc_error_t uvc_get_roll_rel(uvc_device_handle_t *devh, int8_t* roll_rel, uint8_t* speed, enum uvc_req_code req_code);
 uvc_error_t uvc_set_roll_rel(uvc_device_handle_t *devh, int8_t roll_rel, uint8_t speed);
+uvc_error_t uvc_get_roll_rel_async(uvc_device_handle_t *devh, int8_t* roll_rel, uint8_t* speed, enum uvc_req_code req_code, uvc_ctrl_callback_t *cb, void *user_ptr);
+uvc_error_t uvc_set_roll_rel_async(uvc_device_handle_t *devh, int8_t roll_rel, uint8_t speed, uvc_ctrl_callback_t *cb, void *user_ptr);
 
 uvc_error_t uvc_get_privacy(uvc_device_handle_t *devh, uint8_t* privacy, enum uvc_req_code req_code);
 uvc_error_t uvc_set_privacy(uvc_device_handle_t *devh, uint8_t privacy);
+uvc_error_t uvc_get_privacy_async(uvc_device_handle_t *devh, uint8_t* privacy, enum uvc_req_code req_code, uvc_ctrl_callback_t *cb, void *user_ptr);
+uvc_error_t uvc_set_privacy_async(uvc_device_handle_t *devh, uint8_t privacy, uvc_ctrl_callback_t *cb, void *user_ptr);
 
 uvc_error_t uvc_get_digital_window(uvc_device_handle_t *devh, uint16_t* window_top, uint16_t* window_left, uint16_t* window_bottom, uint16_t* window_right, uint16_t* num_steps, uint16_t* num_steps_units, enum uvc_req_code req_code);
 uvc_error_t uvc_set_digital_window(uvc_device_handle_t *devh, uint16_t window_top, uint16_t window_left, uint16_t window_bottom, uint16_t window_right, uint16_t num_steps, uint16_t num_steps_units);
+uvc_error_t uvc_get_digital_window_async(uvc_device_handle_t *devh, uint16_t* window_top, uint16_t* window_left, uint16_t* window_bottom, uint16_t* window_right, uint16_t* num_steps, uint16_t* num_steps_units, enum uvc_req_code req_code, uvc_ctrl_callback_t *cb, void *user_ptr);
+uvc_error_t uvc_set_digital_window_async(uvc_device_handle_t *devh, uint16_t window_top, uint16_t window_left, uint16_t window_bottom, uint16_t window_right, uint16_t num_steps, uint16_t num_steps_units, uvc_ctrl_callback_t *cb, void *user_ptr);
 
 uvc_error_t uvc_get_digital_roi(uvc_device_handle_t *devh, uint16_t* roi_top, uint16_t* roi_left, uint16_t* roi_bottom, uint16_t* roi_right, uint16_t* auto_controls, enum uvc_req_code req_code);
 uvc_error_t uvc_set_digital_roi(uvc_device_handle_t *devh, uint16_t roi_top, uint16_t roi_left, uint16_t roi_bottom, uint16_t roi_right, uint16_t auto_controls);
+uvc_error_t uvc_get_digital_roi_async(uvc_device_handle_t *devh, uint16_t* roi_top, uint16_t* roi_left, uint16_t* roi_bottom, uint16_t* roi_right, uint16_t* auto_controls, enum uvc_req_code req_code, uvc_ctrl_callback_t *cb, void *user_ptr);
+uvc_error_t uvc_set_digital_roi_async(uvc_device_handle_t *devh, uint16_t roi_top, uint16_t roi_left, uint16_t roi_bottom, uint16_t roi_right, uint16_t auto_controls, uvc_ctrl_callback_t *cb, void *user_ptr);
 
 uvc_error_t uvc_get_backlight_compensation(uvc_device_handle_t *devh, uint16_t* backlight_compensation, enum uvc_req_code req_code);
 uvc_error_t uvc_set_backlight_compensation(uvc_device_handle_t *devh, uint16_t backlight_compensation);
+uvc_error_t uvc_get_backlight_compensation_async(uvc_device_handle_t *devh, uint16_t* backlight_compensation, enum uvc_req_code req_code, uvc_ctrl_callback_t *cb, void *user_ptr);
+uvc_error_t uvc_set_backlight_compensation_async(uvc_device_handle_t *devh, uint16_t backlight_compensation, uvc_ctrl_callback_t *cb, void *user_ptr);
 
 uvc_error_t uvc_get_brightness(uvc_device_handle_t *devh, int16_t* brightness, enum uvc_req_code req_code);
 uvc_error_t uvc_set_brightness(uvc_device_handle_t *devh, int16_t brightness);
+uvc_error_t uvc_get_brightness_async(uvc_device_handle_t *devh, int16_t* brightness, enum uvc_req_code req_code, uvc_ctrl_callback_t *cb, void *user_ptr);
+uvc_error_t uvc_set_brightness_async(uvc_device_handle_t *devh, int16_t brightness, uvc_ctrl_callback_t *cb, void *user_ptr);
 
 uvc_error_t uvc_get_contrast(uvc_device_handle_t *devh, uint16_t* contrast, enum uvc_req_code req_code);
 uvc_error_t uvc_set_contrast(uvc_device_handle_t *devh, uint16_t contrast);
+uvc_error_t uvc_get_contrast_async(uvc_device_handle_t *devh, uint16_t* contrast, enum uvc_req_code req_code, uvc_ctrl_callback_t *cb, void *user_ptr);
+uvc_error_t uvc_set_contrast_async(uvc_device_handle_t *devh, uint16_t contrast, uvc_ctrl_callback_t *cb, void *user_ptr);
 
 uvc_error_t uvc_get_contrast_auto(uvc_device_handle_t *devh, uint8_t* contrast_auto, enum uvc_req_code req_code);
 uvc_error_t uvc_set_contrast_auto(uvc_device_handle_t *devh, uint8_t contrast_auto);
+uvc_error_t uvc_get_contrast_auto_async(uvc_device_handle_t *devh, uint8_t* contrast_auto, enum uvc_req_code req_code, uvc_ctrl_callback_t *cb, void *user_ptr);
+uvc_error_t uvc_set_contrast_auto_async(uvc_device_handle_t *devh, uint8_t contrast_auto, uvc_ctrl_callback_t *cb, void *user_ptr);
 
 uvc_error_t uvc_get_gain(uvc_device_handle_t *devh, uint16_t* gain, enum uvc_req_code req_code);
 uvc_error_t uvc_set_gain(uvc_device_handle_t *devh, uint16_t gain);
+uvc_error_t uvc_get_gain_async(uvc_device_handle_t *devh, uint16_t* gain, enum uvc_req_code req_code, uvc_ctrl_callback_t *cb, void *user_ptr);
+uvc_error_t uvc_set_gain_async(uvc_device_handle_t *devh, uint16_t gain, uvc_ctrl_callback_t *cb, void *user_ptr);
 
 uvc_error_t uvc_get_power_line_frequency(uvc_device_handle_t *devh, uint8_t* power_line_frequency, enum uvc_req_code req_code);
 uvc_error_t uvc_set_power_line_frequency(uvc_device_handle_t *devh, uint8_t power_line_frequency);
+uvc_error_t uvc_get_power_line_frequency_async(uvc_device_handle_t *devh, uint8_t* power_line_frequency, enum uvc_req_code req_code, uvc_ctrl_callback_t *cb, void *user_ptr);
+uvc_error_t uvc_set_power_line_frequency_async(uvc_device_handle_t *devh, uint8_t power_line_frequency, uvc_ctrl_callback_t *cb, void *user_ptr);
 
 uvc_error_t uvc_get_hue(uvc_device_handle_t *devh, int16_t* hue, enum uvc_req_code req_code);
 uvc_error_t uvc_set_hue(uvc_device_handle_t *devh, int16_t hue);
+uvc_error_t uvc_get_hue_async(uvc_device_handle_t *devh, int16_t* hue, enum uvc_req_code req_code, uvc_ctrl_callback_t *cb, void *user_ptr);
+uvc_error_t uvc_set_hue_async(uvc_device_handle_t *devh, int16_t hue, uvc_ctrl_callback_t *cb, void *user_ptr);
 
 uvc_error_t uvc_get_hue_auto(uvc_device_handle_t *devh, uint8_t* hue_auto, enum uvc_req_code req_code);
 uvc_error_t uvc_set_hue_auto(uvc_device_handle_t *devh, uint8_t hue_auto);
+uvc_error_t uvc_get_hue_auto_async(uvc_device_handle_t *devh, uint8_t* hue_auto, enum uvc_req_code req_code, uvc_ctrl_callback_t *cb, void *user_ptr);
+uvc_error_t uvc_set_hue_auto_async(uvc_device_handle_t *devh, uint8_t hue_auto, uvc_ctrl_callback_t *cb, void *user_ptr);
 
 uvc_error_t uvc_get_saturation(uvc_device_handle_t *devh, uint16_t* saturation, enum uvc_req_code req_code);
 uvc_error_t uvc_set_saturation(uvc_device_handle_t *devh, uint16_t saturation);
+uvc_error_t uvc_get_saturation_async(uvc_device_handle_t *devh, uint16_t* saturation, enum uvc_req_code req_code, uvc_ctrl_callback_t *cb, void *user_ptr);
+uvc_error_t uvc_set_saturation_async(uvc_device_handle_t *devh, uint16_t saturation, uvc_ctrl_callback_t *cb, void *user_ptr);
 
 uvc_error_t uvc_get_sharpness(uvc_device_handle_t *devh, uint16_t* sharpness, enum uvc_req_code req_code);
 uvc_error_t uvc_set_sharpness(uvc_device_handle_t *devh, uint16_t sharpness);
+uvc_error_t uvc_get_sharpness_async(uvc_device_handle_t *devh, uint16_t* sharpness, enum uvc_req_code req_code, uvc_ctrl_callback_t *cb, void *user_ptr);
+uvc_error_t uvc_set_sharpness_async(uvc_device_handle_t *devh, uint16_t sharpness, uvc_ctrl_callback_t *cb, void *user_ptr);
 
 uvc_error_t uvc_get_gamma(uvc_device_handle_t *devh, uint16_t* gamma, enum uvc_req_code req_code);
 uvc_error_t uvc_set_gamma(uvc_device_handle_t *devh, uint16_t gamma);
+uvc_error_t uvc_get_gamma_async(uvc_device_handle_t *devh, uint16_t* gamma, enum uvc_req_code req_code, uvc_ctrl_callback_t *cb, void *user_ptr);
+uvc_error_t uvc_set_gamma_async(uvc_device_handle_t *devh, uint16_t gamma, uvc_ctrl_callback_t *cb, void *user_ptr);
 
 uvc_error_t uvc_get_white_balance_temperature(uvc_device_handle_t *devh, uint16_t* temperature, enum uvc_req_code req_code);
 uvc_error_t uvc_set_white_balance_temperature(uvc_device_handle_t *devh, uint16_t temperature);
+uvc_error_t uvc_get_white_balance_temperature_async(uvc_device_handle_t *devh, uint16_t* temperature, enum uvc_req_code req_code, uvc_ctrl_callback_t *cb, void *user_ptr);
+uvc_error_t uvc_set_white_balance_temperature_async(uvc_device_handle_t *devh, uint16_t temperature, uvc_ctrl_callback_t *cb, void *user_ptr);
 
 uvc_error_t uvc_get_white_balance_temperature_auto(uvc_device_handle_t *devh, uint8_t* temperature_auto, enum uvc_req_code req_code);
 uvc_error_t uvc_set_white_balance_temperature_auto(uvc_device_handle_t *devh, uint8_t temperature_auto);
+uvc_error_t uvc_get_white_balance_temperature_auto_async(uvc_device_handle_t *devh, uint8_t* temperature_auto, enum uvc_req_code req_code, uvc_ctrl_callback_t *cb, void *user_ptr);
+uvc_error_t uvc_set_white_balance_temperature_auto_async(uvc_device_handle_t *devh, uint8_t temperature_auto, uvc_ctrl_callback_t *cb, void *user_ptr);
 
 uvc_error_t uvc_get_white_balance_component(uvc_device_handle_t *devh, uint16_t* blue, uint16_t* red, enum uvc_req_code req_code);
 uvc_error_t uvc_set_white_balance_component(uvc_device_handle_t *devh, uint16_t blue, uint16_t red);
+uvc_error_t uvc_get_white_balance_component_async(uvc_device_handle_t *devh, uint16_t* blue, uint16_t* red, enum uvc_req_code req_code, uvc_ctrl_callback_t *cb, void *user_ptr);
+uvc_error_t uvc_set_white_balance_component_async(uvc_device_handle_t *devh, uint16_t blue, uint16_t red, uvc_ctrl_callback_t *cb, void *user_ptr);
 
 uvc_error_t uvc_get_white_balance_component_auto(uvc_device_handle_t *devh, uint8_t* white_balance_component_auto, enum uvc_req_code req_code);
 uvc_error_t uvc_set_white_balance_component_auto(uvc_device_handle_t *devh, uint8_t white_balance_component_auto);
+uvc_error_t uvc_get_white_balance_component_auto_async(uvc_device_handle_t *devh, uint8_t* white_balance_component_auto, enum uvc_req_code req_code, uvc_ctrl_callback_t *cb, void *user_ptr);
+uvc_error_t uvc_set_white_balance_component_auto_async(uvc_device_handle_t *devh, uint8_t white_balance_component_auto, uvc_ctrl_callback_t *cb, void *user_ptr);
 
 uvc_error_t uvc_get_digital_multiplier(uvc_device_handle_t *devh, uint16_t* multiplier_step, enum uvc_req_code req_code);
 uvc_error_t uvc_set_digital_multiplier(uvc_device_handle_t *devh, uint16_t multiplier_step);
+uvc_error_t uvc_get_digital_multiplier_async(uvc_device_handle_t *devh, uint16_t* multiplier_step, enum uvc_req_code req_code, uvc_ctrl_callback_t *cb, void *user_ptr);
+uvc_error_t uvc_set_digital_multiplier_async(uvc_device_handle_t *devh, uint16_t multiplier_step, uvc_ctrl_callback_t *cb, void *user_ptr);
 
 uvc_error_t uvc_get_digital_multiplier_limit(uvc_device_handle_t *devh, uint16_t* multiplier_step, enum uvc_req_code req_code);
 uvc_error_t uvc_set_digital_multiplier_limit(uvc_device_handle_t *devh, uint16_t multiplier_step);
+uvc_error_t uvc_get_digital_multiplier_limit_async(uvc_device_handle_t *devh, uint16_t* multiplier_step, enum uvc_req_code req_code, uvc_ctrl_callback_t *cb, void *user_ptr);
+uvc_error_t uvc_set_digital_multiplier_limit_async(uvc_device_handle_t *devh, uint16_t multiplier_step, uvc_ctrl_callback_t *cb, void *user_ptr);
 
 uvc_error_t uvc_get_analog_video_standard(uvc_device_handle_t *devh, uint8_t* video_standard, enum uvc_req_code req_code);
 uvc_error_t uvc_set_analog_video_standard(uvc_device_handle_t *devh, uint8_t video_standard);
+uvc_error_t uvc_get_analog_video_standard_async(uvc_device_handle_t *devh, uint8_t* video_standard, enum uvc_req_code req_code, uvc_ctrl_callback_t *cb, void *user_ptr);
+uvc_error_t uvc_set_analog_video_standard_async(uvc_device_handle_t *devh, uint8_t video_standard, uvc_ctrl_callback_t *cb, void *user_ptr);
 
 uvc_error_t uvc_get_analog_video_lock_status(uvc_device_handle_t *devh, uint8_t* status, enum uvc_req_code req_code);
 uvc_error_t uvc_set_analog_video_lock_status(uvc_device_handle_t *devh, uint8_t status);
+uvc_error_t uvc_get_analog_video_lock_status_async(uvc_device_handle_t *devh, uint8_t* status, enum uvc_req_code req_code, uvc_ctrl_callback_t *cb, void *user_ptr);
+uvc_error_t uvc_set_analog_video_lock_status_async(uvc_device_handle_t *devh, uint8_t status, uvc_ctrl_callback_t *cb, void *user_ptr);
 
 uvc_error_t uvc_get_input_select(uvc_device_handle_t *devh, uint8_t* selector, enum uvc_req_code req_code);
 uvc_error_t uvc_set_input_select(uvc_device_handle_t *devh, uint8_t selector);
+uvc_error_t uvc_get_input_select_async(uvc_device_handle_t *devh, uint8_t* selector, enum uvc_req_code req_code, uvc_ctrl_callback_t *cb, void *user_ptr);
+uvc_error_t uvc_set_input_select_async(uvc_device_handle_t *devh, uint8_t selector, uvc_ctrl_callback_t *cb, void *user_ptr);
 /* end AUTO-GENERATED control accessors */
 
 void uvc_perror(uvc_error_t err, const char *msg);
@@ -828,6 +1351,10 @@ uvc_error_t uvc_any2bgr(uvc_frame_t *in, uvc_frame_t *out);
 uvc_error_t uvc_yuyv2y(uvc_frame_t *in, uvc_frame_t *out);
 uvc_error_t uvc_yuyv2uv(uvc_frame_t *in, uvc_frame_t *out);
 
+void uvc_frame_stats_params_init(uvc_frame_stats_params_t *params);
+uvc_error_t uvc_get_frame_stats(uvc_frame_t *frame, const uvc_frame_stats_params_t *params,
+                                uvc_frame_stats_t *stats);
+
 #ifdef LIBUVC_HAS_JPEG
 uvc_error_t uvc_mjpeg2rgb(uvc_frame_t *in, uvc_frame_t *out);
 uvc_error_t uvc_mjpeg2gray(uvc_frame_t *in, uvc_frame_t *out);
@@ -181,6 +181,10 @@ typedef struct uvc_streaming_interface {
   uint8_t bEndpointAddress;
   uint8_t bTerminalLink;
   uint8_t bStillCaptureMethod;
+  /** Frame descriptors by [bFormatIndex - 1][bFrameIndex - 1], or NULL if
+   * the indices are too sparse for a table (see uvc_index_frames()) */
+  struct uvc_frame_desc **frame_index;
+  uint8_t frame_index_formats, frame_index_frames;
 } uvc_streaming_interface_t;
 
 /** VideoControl interface */
@@ -199,6 +203,7 @@ typedef struct uvc_control_interface {
 } uvc_control_interface_t;
 
 struct uvc_stream_ctrl;
+struct uvc_synthetic_device;
 
 struct uvc_device {
   struct uvc_context *ctx;
@@ -206,6 +211,50 @@ struct uvc_device {
   libusb_device *usb_dev;
 };
 
+/** Number of each kind of node in a parsed descriptor tree */
+struct uvc_desc_counts {
+  size_t input_terms;
+  size_t selector_units;
+  size_t processing_units;
+  size_t extension_units;
+  size_t stream_ifs;
+  size_t formats;
+  size_t frames;
+  /** Entries of the frames' interval lists, terminators included */
+  size_t intervals;
+  size_t still_frames;
+  size_t still_res;
+  /** Entries of the still frames' bCompression arrays */
+  size_t compression;
+  /** Slots of the streaming interfaces' frame lookup tables */
+  size_t frame_index;
+};
+
+/** Storage for the nodes of a parsed descriptor tree.
+ *
+ * uvc_scan_control() counts the nodes the descriptors will produce and
+ * allocates this header and one array per node type in a single block; the
+ * parsers hand out array entries in descriptor order and link them into
+ * the usual lists. */
+struct uvc_desc_arena {
+  uvc_input_terminal_t *input_terms;
+  uvc_selector_unit_t *selector_units;
+  uvc_processing_unit_t *processing_units;
+  uvc_extension_unit_t *extension_units;
+  uvc_streaming_interface_t *stream_ifs;
+  uvc_format_desc_t *formats;
+  uvc_frame_desc_t *frames;
+  uint32_t *intervals;
+  uvc_still_frame_desc_t *still_frames;
+  uvc_still_frame_res_t *still_res;
+  uint8_t *compression;
+  uvc_frame_desc_t **frame_index;
+  /** Entries allocated for each array */
+  struct uvc_desc_counts max;
+  /** Entries handed out so far */
+  struct uvc_desc_counts used;
+};
+
 typedef struct uvc_device_info {
   /** Configuration descriptor for USB device */
   struct libusb_config_descriptor *config;
@@ -213,26 +262,40 @@ typedef struct uvc_device_info {
   uvc_control_interface_t ctrl_if;
   /** VideoStreaming interfaces on the device */
   uvc_streaming_interface_t *stream_ifs;
+  /** Whether the whole tree is one allocation starting here (see desc-cache.c) */
+  uint8_t flat;
+  /** Block holding the tree's nodes, if it was parsed here (NULL when flat) */
+  struct uvc_desc_arena *arena;
+  /** Set before uvc_scan_control() to leave the streaming interfaces for
+   * uvc_scan_deferred_streaming() */
+  uint8_t defer_streaming;
+  /** Streaming interfaces not parsed yet, one bit per interface index */
+  uint32_t deferred_ifs;
+  /** Frame lookup table entries handed out to deferred interfaces */
+  size_t deferred_slots_used;
 } uvc_device_info_t;
 
 /*
-  set a high number of transfer buffers. This uses a lot of ram, but
-  avoids problems with scheduling delays on slow boards causing missed
-  transfers. A better approach may be to make the transfer thread FIFO
-  scheduled (if we have root).
-  Default number of transfer buffers can be overwritten by defining
-  this macro.
+  Most transfer buffers a stream can keep in flight. How many it actually
+  uses comes from the device's quirks entry, or the platform default in
+  quirks.c (which a LIBUVC_NUM_TRANSFER_BUFS definition still overrides).
+  Many buffers use a lot of ram, but avoid problems with scheduling delays
+  on slow boards causing missed transfers.
  */
-#ifndef LIBUVC_NUM_TRANSFER_BUFS
-#if defined(__APPLE__) && defined(__MACH__)
-#define LIBUVC_NUM_TRANSFER_BUFS 20
-#else
-#define LIBUVC_NUM_TRANSFER_BUFS 100
-#endif
-#endif
+#define LIBUVC_MAX_TRANSFER_BUFS 100
 
 #define LIBUVC_XFER_META_BUF_SIZE ( 4 * 1024 )
 
+/** Status interrupt transfers kept in flight at once */
+#ifndef LIBUVC_NUM_STATUS_XFERS
+#define LIBUVC_NUM_STATUS_XFERS 4
+#endif
+
+/** Status events the queue holds before it starts dropping them; a power of two */
+#ifndef LIBUVC_STATUS_QUEUE_LEN
+#define LIBUVC_STATUS_QUEUE_LEN 64
+#endif
+
 struct uvc_stream_handle {
   struct uvc_device_handle *devh;
   struct uvc_stream_handle *prev, *next;
@@ -287,15 +350,26 @@ struct uvc_stream_handle {
   uint32_t last_polled_seq;
   uvc_frame_callback_t *user_cb;
   void *user_ptr;
-  struct libusb_transfer *transfers[LIBUVC_NUM_TRANSFER_BUFS];
-  uint8_t *transfer_bufs[LIBUVC_NUM_TRANSFER_BUFS];
+  struct libusb_transfer *transfers[LIBUVC_MAX_TRANSFER_BUFS];
+  uint8_t *transfer_bufs[LIBUVC_MAX_TRANSFER_BUFS];
+  /** Entries of transfers[] in use, from the device's quirks */
+  int num_transfers;
   struct uvc_frame frame;
+  /** Mode of cur_ctrl, resolved when it is set (see _uvc_stream_set_mode()) */
+  uvc_frame_desc_t *frame_desc;
   enum uvc_frame_format frame_format;
+  size_t frame_step;
   struct timespec capture_time_finished;
 
   /* raw metadata buffer if available */
   uint8_t *meta_outbuf, *meta_holdbuf;
   size_t meta_got_bytes, meta_hold_bytes;
+
+  /** Reattachment after the device drops off the bus, if enabled
+   * (see stream-resume.c) */
+  struct uvc_stream_resume *resume;
+  uvc_stream_resume_callback_t *resume_cb;
+  void *resume_user_ptr;
 };
 
 /** Handle on an open UVC device
@@ -308,8 +382,18 @@ struct uvc_device_handle {
   /** Underlying USB device handle */
   libusb_device_handle *usb_devh;
   struct uvc_device_info *info;
-  struct libusb_transfer *status_xfer;
-  uint8_t status_buf[32];
+  /** Status interrupt transfers and the queue they feed (see status.c) */
+  struct libusb_transfer *status_xfers[LIBUVC_NUM_STATUS_XFERS];
+  int status_xfers_active;
+  /** Bit i set while status_xfers[i] is in flight */
+  uint32_t status_xfers_live;
+  /** Set by uvc_status_stop(); the callback stops resubmitting */
+  uint8_t status_stopping;
+  /** Transfer callbacks using the handle outside status_owner_mutex */
+  int status_in_callback;
+  pthread_mutex_t status_mutex;
+  pthread_cond_t status_cond;
+  struct uvc_status_queue *status_queue;
   /** Function to call when we receive status updates from the camera */
   uvc_status_callback_t *status_cb;
   void *status_user_ptr;
@@ -318,9 +402,44 @@ struct uvc_device_handle {
   void *button_user_ptr;
 
   uvc_stream_handle_t *streams;
-  /** Whether the camera is an iSight that sends one header per frame */
-  uint8_t is_isight;
+  /** Workarounds and streaming parameters for this device (see quirks.c) */
+  uvc_quirks_t quirks;
   uint32_t claimed;
+#ifdef LIBUVC_HAS_SYNTHETIC
+  /** Payload generator state if this is an in-memory device (see synthetic.c) */
+  struct uvc_synthetic_device *synthetic;
+#endif
+  /** Cached control values, capabilities and ranges (see ctrl-cache.c) */
+  struct uvc_ctrl_cache_entry *ctrl_cache;
+  uint8_t ctrl_cache_enabled;
+  uint8_t ctrl_cur_cache_enabled;
+  /** Staleness bound of cached GET_CUR values without their own */
+  uint32_t ctrl_cur_max_age_ms;
+  pthread_mutex_t ctrl_cache_mutex;
+  /** Asynchronous control requests in flight (see ctrl-async.c) */
+  struct uvc_ctrl_request *ctrl_requests;
+  pthread_mutex_t ctrl_async_mutex;
+  pthread_cond_t ctrl_async_cond;
+  /** Coalescing SET_CUR thread, if started (see ctrl-writer.c) */
+  struct uvc_ctrl_writer *ctrl_writer;
+  /** Held while the writer is started or stopped and while its stats are read */
+  pthread_mutex_t ctrl_writer_mutex;
+  /** Bumped each time usb_devh is replaced by uvc_reattach_device() */
+  uint32_t usb_generation;
+  /** Held for reading while a control request uses usb_devh, and for
+   * writing while uvc_reattach_device() replaces it */
+  pthread_rwlock_t usb_devh_lock;
+  /** uvc_open_flag bits the handle was opened with */
+  int open_flags;
+  /** Guards parsing of deferred streaming interfaces */
+  pthread_mutex_t info_mutex;
+  /** Device identity in the probe cache, once computed (see probe-cache.c) */
+  uint64_t probe_key;
+  uint8_t probe_key_ready;
+  /** A probe answered from the cache, until it is committed and checked */
+  uint8_t probe_pending;
+  uvc_stream_ctrl_t probe_request;
+  uvc_stream_ctrl_t probe_result;
 };
 
 /** Context within which we communicate with devices */
@@ -333,6 +452,30 @@ struct uvc_context {
   uvc_device_handle_t *open_devices;
   pthread_t handler_thread;
   int kill_handler_thread;
+  /** Whether handler_thread is handling events for us */
+  uint8_t handler_thread_running;
+  /** Where parsed descriptors are cached, or NULL, and the cache files
+   * mapped so far (see desc-cache.c) */
+  char *desc_cache_dir;
+  struct uvc_desc_cache_file *desc_cache_files;
+  pthread_mutex_t desc_cache_mutex;
+  /** Hotplug-maintained device index, or NULL (see device-index.c) */
+  struct uvc_device_index *dev_index;
+  /** Negotiated streaming parameters per device, and where they are kept
+   * on disk, or NULL (see probe-cache.c) */
+  uint8_t probe_cache_enabled;
+  char *probe_cache_dir;
+  struct uvc_probe_cache_dev *probe_cache;
+  pthread_mutex_t probe_cache_mutex;
+  /** Device strings read so far (see string-cache.c) */
+  struct uvc_string_cache_entry *string_cache;
+  int string_cache_size;
+  pthread_mutex_t string_cache_mutex;
+  /** Quirks entries loaded with uvc_load_quirks(), checked before the
+   * built-in table (see quirks.c) */
+  uvc_quirks_t *quirks;
+  int num_quirks;
+  pthread_mutex_t quirks_mutex;
 };
 
 uvc_error_t uvc_query_stream_ctrl(
@@ -340,10 +483,328 @@ uvc_error_t uvc_query_stream_ctrl(
     uvc_stream_ctrl_t *ctrl,
     uint8_t probe,
     enum uvc_req_code req);
+void uvc_stream_ctrl_pack(const uvc_stream_ctrl_t *ctrl, uint8_t *buf);
+void uvc_stream_ctrl_unpack(uvc_stream_ctrl_t *ctrl, const uint8_t *buf, size_t len);
 
 void uvc_start_handler_thread(uvc_context_t *ctx);
 uvc_error_t uvc_claim_if(uvc_device_handle_t *devh, int idx);
 uvc_error_t uvc_release_if(uvc_device_handle_t *devh, int idx);
+void uvc_free_devh(uvc_device_handle_t *devh);
+struct uvc_desc_arena *uvc_desc_arena_alloc(const struct uvc_desc_counts *counts);
+size_t uvc_frame_index_slots(int num_formats, int num_frames);
+size_t uvc_index_frames(uvc_device_info_t *info, uvc_frame_desc_t **slots, size_t num_slots);
+uvc_error_t uvc_scan_deferred_streaming(uvc_device_handle_t *devh, int interface_number);
+uvc_error_t uvc_scan_control(uvc_device_t *dev, uvc_device_info_t *info,
+    uint16_t idVendor, uint16_t idProduct);
+void uvc_free_device_info(uvc_device_info_t *info);
+
+/** Kind of unit a standard control lives on */
+enum uvc_ctrl_unit_type {
+  UVC_CTRL_UNIT_CAMERA_TERMINAL,
+  UVC_CTRL_UNIT_PROCESSING_UNIT,
+  UVC_CTRL_UNIT_SELECTOR_UNIT
+};
+
+/** One little-endian integer field of a control's value */
+typedef struct uvc_ctrl_field_def {
+  const char *name;
+  uint8_t position;
+  /** 1, 2 or 4 bytes */
+  uint8_t length;
+  uint8_t is_signed;
+} uvc_ctrl_field_def_t;
+
+/** Standard control, as listed in standard-units.yaml (see ctrl-table.c) */
+typedef struct uvc_ctrl_def {
+  const char *name;
+  enum uvc_ctrl_unit_type unit_type;
+  uint8_t selector;
+  uint8_t length;
+  uint8_t num_fields;
+  uvc_ctrl_field_def_t fields[UVC_CTRL_MAX_FIELDS];
+} uvc_ctrl_def_t;
+
+extern const uvc_ctrl_def_t uvc_ctrl_defs[];
+extern const size_t uvc_ctrl_def_count;
+
+/* AUTO-GENERATED control table indices! Update them with the output of `ctrl-gen.py index`. */
+/** @internal Position of each standard control in uvc_ctrl_defs */
+enum uvc_ctrl_def_index {
+  UVC_CTRL_DEF_SCANNING_MODE,
+  UVC_CTRL_DEF_AE_MODE,
+  UVC_CTRL_DEF_AE_PRIORITY,
+  UVC_CTRL_DEF_EXPOSURE_ABS,
+  UVC_CTRL_DEF_EXPOSURE_REL,
+  UVC_CTRL_DEF_FOCUS_ABS,
+  UVC_CTRL_DEF_FOCUS_REL,
+  UVC_CTRL_DEF_FOCUS_SIMPLE_RANGE,
+  UVC_CTRL_DEF_FOCUS_AUTO,
+  UVC_CTRL_DEF_IRIS_ABS,
+  UVC_CTRL_DEF_IRIS_REL,
+  UVC_CTRL_DEF_ZOOM_ABS,
+  UVC_CTRL_DEF_ZOOM_REL,
+  UVC_CTRL_DEF_PANTILT_ABS,
+  UVC_CTRL_DEF_PANTILT_REL,
+  UVC_CTRL_DEF_ROLL_ABS,
+  UVC_CTRL_DEF_ROLL_REL,
+  UVC_CTRL_DEF_PRIVACY,
+  UVC_CTRL_DEF_DIGITAL_WINDOW,
+  UVC_CTRL_DEF_DIGITAL_ROI,
+  UVC_CTRL_DEF_BACKLIGHT_COMPENSATION,
+  UVC_CTRL_DEF_BRIGHTNESS,
+  UVC_CTRL_DEF_CONTRAST,
+  UVC_CTRL_DEF_CONTRAST_AUTO,
+  UVC_CTRL_DEF_GAIN,
+  UVC_CTRL_DEF_POWER_LINE_FREQUENCY,
+  UVC_CTRL_DEF_HUE,
+  UVC_CTRL_DEF_HUE_AUTO,
+  UVC_CTRL_DEF_SATURATION,
+  UVC_CTRL_DEF_SHARPNESS,
+  UVC_CTRL_DEF_GAMMA,
+  UVC_CTRL_DEF_WHITE_BALANCE_TEMPERATURE,
+  UVC_CTRL_DEF_WHITE_BALANCE_TEMPERATURE_AUTO,
+  UVC_CTRL_DEF_WHITE_BALANCE_COMPONENT,
+  UVC_CTRL_DEF_WHITE_BALANCE_COMPONENT_AUTO,
+  UVC_CTRL_DEF_DIGITAL_MULTIPLIER,
+  UVC_CTRL_DEF_DIGITAL_MULTIPLIER_LIMIT,
+  UVC_CTRL_DEF_ANALOG_VIDEO_STANDARD,
+  UVC_CTRL_DEF_ANALOG_VIDEO_LOCK_STATUS,
+  UVC_CTRL_DEF_INPUT_SELECT,
+};
+/* end AUTO-GENERATED control table indices */
+
+/** Longest standard control value, in bytes */
+#define UVC_CTRL_DEF_MAX_LEN 32
+
+uint8_t uvc_ctrl_def_unit_id(uvc_device_handle_t *devh, const uvc_ctrl_def_t *def);
+/** Number of ranks uvc_ctrl_def_rank() sorts controls into */
+#define UVC_CTRL_RANKS 3
+int uvc_ctrl_def_rank(const uvc_ctrl_def_t *def);
+int64_t uvc_ctrl_field_decode(const uvc_ctrl_field_def_t *field, const uint8_t *data);
+void uvc_ctrl_field_encode(const uvc_ctrl_field_def_t *field, int64_t value, uint8_t *data);
+void uvc_ctrl_def_unpack(const uvc_ctrl_def_t *def, const uint8_t *data, void *const *out);
+void uvc_ctrl_def_pack(const uvc_ctrl_def_t *def, const int64_t *values, uint8_t *data);
+uvc_error_t uvc_get_ctrl_fields(uvc_device_handle_t *devh, const uvc_ctrl_def_t *def,
+                                void *const *out, enum uvc_req_code req_code);
+uvc_error_t uvc_set_ctrl_fields(uvc_device_handle_t *devh, const uvc_ctrl_def_t *def,
+                                const int64_t *values);
+int uvc_set_ctrl_now(uvc_device_handle_t *devh, uint8_t unit, uint8_t ctrl, const void *data, int len);
+int uvc_usb_control_transfer(uvc_device_handle_t *devh, uint8_t request_type, uint8_t request,
+                             uint16_t value, uint16_t index, unsigned char *data, uint16_t len);
+int uvc_ctrl_writer_queue(uvc_device_handle_t *devh, uint8_t unit, uint8_t selector,
+                          const void *data, int len);
+
+/** Number of request codes the control cache holds: GET_CUR through GET_DEF */
+#define UVC_CTRL_CACHE_SLOTS 7
+
+/** Cached responses for one control of one unit or terminal */
+typedef struct uvc_ctrl_cache_entry {
+  struct uvc_ctrl_cache_entry *prev, *next;
+  uint8_t unit;
+  uint8_t selector;
+  /** Bit n set: data[n] holds the response to request code UVC_GET_CUR + n */
+  uint8_t valid;
+  /** Bit n set: the device returned fewer bytes than were asked for, so
+   * data[n] is the whole response */
+  uint8_t complete;
+  uint16_t len[UVC_CTRL_CACHE_SLOTS];
+  uint8_t *data[UVC_CTRL_CACHE_SLOTS];
+  /** When the GET_CUR slot was last written (CLOCK_MONOTONIC) */
+  uint64_t cur_time_us;
+  /** How long the GET_CUR slot may be served, or UVC_CTRL_CUR_NO_EXPIRY */
+  uint32_t cur_max_age_ms;
+  /** Whether cur_max_age_ms was set for this control rather than inherited */
+  uint8_t cur_max_age_set;
+  /** Extension unit access (see ctrl-xu.c): length from GET_LEN, 0 if not
+   * read yet, and a shadow of the control's value, xu_len bytes */
+  uint16_t xu_len;
+  uint8_t *xu_shadow;
+  uint8_t xu_shadow_valid;
+  /** Writes always reach the device, even of the value it already holds */
+  uint8_t xu_volatile;
+} uvc_ctrl_cache_entry_t;
+
+void uvc_ctrl_cache_init(uvc_device_handle_t *devh);
+void uvc_ctrl_cache_free(uvc_device_handle_t *devh);
+int uvc_ctrl_cache_lookup(uvc_device_handle_t *devh, uint8_t unit, uint8_t selector,
+                          enum uvc_req_code req_code, void *data, int len);
+void uvc_ctrl_cache_store(uvc_device_handle_t *devh, uint8_t unit, uint8_t selector,
+                          enum uvc_req_code req_code, const void *data, int len, int ret);
+void uvc_ctrl_cache_update_cur(uvc_device_handle_t *devh, uint8_t unit, uint8_t selector,
+                               const void *data, int len);
+void uvc_ctrl_cache_invalidate_ctrl(uvc_device_handle_t *devh, uint8_t unit, uint8_t selector);
+void uvc_ctrl_cache_invalidate_ranges(uvc_device_handle_t *devh);
+uvc_ctrl_cache_entry_t *uvc_ctrl_cache_entry(uvc_device_handle_t *devh, uint8_t unit,
+                                             uint8_t selector);
+int uvc_ctrl_cache_restore(uvc_device_handle_t *devh);
+
+void uvc_ctrl_async_init(uvc_device_handle_t *devh);
+void uvc_ctrl_async_free(uvc_device_handle_t *devh);
+void uvc_ctrl_async_drain(uvc_device_handle_t *devh);
+uvc_error_t uvc_get_ctrl_fields_async(uvc_device_handle_t *devh, const uvc_ctrl_def_t *def,
+                                      void *const *out, enum uvc_req_code req_code,
+                                      uvc_ctrl_callback_t *cb, void *user_ptr);
+uvc_error_t uvc_set_ctrl_fields_async(uvc_device_handle_t *devh, const uvc_ctrl_def_t *def,
+                                      const int64_t *values,
+                                      uvc_ctrl_callback_t *cb, void *user_ptr);
+
+#ifdef LIBUVC_HAS_JPEG
+uvc_error_t uvc_mjpeg_dc2gray(uvc_frame_t *in, uvc_frame_t *out);
+#endif
+
+uint64_t uvc_desc_cache_key(const struct libusb_device_descriptor *desc,
+                            const struct libusb_config_descriptor *config);
+uvc_error_t uvc_desc_cache_load(uvc_context_t *ctx, const struct libusb_device_descriptor *desc,
+                                uint64_t key, uvc_device_info_t **info);
+uvc_error_t uvc_desc_cache_store(const char *dir, const struct libusb_device_descriptor *desc,
+                                 uint64_t key, const uvc_device_info_t *info);
+void uvc_desc_cache_free(uvc_context_t *ctx);
+
+uvc_error_t uvc_probe_cache_lookup(uvc_device_handle_t *devh, uvc_stream_ctrl_t *ctrl);
+void uvc_probe_cache_store(uvc_device_handle_t *devh, const uvc_stream_ctrl_t *request,
+                           const uvc_stream_ctrl_t *result);
+uvc_error_t uvc_probe_cache_commit(uvc_device_handle_t *devh, uvc_stream_ctrl_t *ctrl);
+void uvc_probe_cache_free(uvc_context_t *ctx);
+
+uvc_error_t uvc_string_cache_lookup(uvc_device_t *dev, const struct libusb_device_descriptor *desc,
+                                    char **manufacturer, char **product, char **serial);
+uvc_error_t uvc_string_cache_fetch(uvc_device_t *dev, const struct libusb_device_descriptor *desc,
+                                   char **manufacturer, char **product, char **serial);
+void uvc_string_cache_prefetch(uvc_device_t **devs, int num_devs);
+void uvc_string_cache_free(uvc_context_t *ctx);
+
+void uvc_quirks_lookup(uvc_context_t *ctx, uint16_t vid, uint16_t pid, int bcd,
+                       uvc_quirks_t *quirks);
+void uvc_quirks_fix_stream_ctrl(uvc_device_handle_t *devh, uvc_stream_ctrl_t *ctrl);
+
+int uvc_is_video_device(uvc_context_t *ctx, struct libusb_device *usb_dev);
+uvc_error_t uvc_reattach_device(uvc_device_handle_t *devh, uvc_device_t *dev);
+
+uvc_error_t uvc_stream_resume_transfers(uvc_stream_handle_t *strmh);
+void uvc_stream_resume_device_lost(uvc_stream_handle_t *strmh);
+void uvc_stream_resume_lock(uvc_stream_handle_t *strmh);
+void uvc_stream_resume_unlock(uvc_stream_handle_t *strmh);
+uvc_error_t uvc_device_index_find(uvc_context_t *ctx, int vid, int pid, const char *sn,
+                                  int max_devs, uvc_device_t ***list);
+
+void uvc_status_init(uvc_device_handle_t *devh);
+uvc_error_t uvc_status_start(uvc_device_handle_t *devh);
+void uvc_status_stop(uvc_device_handle_t *devh);
+void uvc_status_drain(uvc_device_handle_t *devh);
+void uvc_status_free(uvc_device_handle_t *devh);
+uvc_error_t uvc_status_restart(uvc_device_handle_t *devh);
+void uvc_status_received(uvc_device_handle_t *devh, const uint8_t *data, int len);
+void uvc_status_update_caches(uvc_device_handle_t *devh, const uint8_t *data, int len);
+void uvc_process_status_packet(uvc_device_handle_t *devh, uint8_t *data, int len);
+
+void _uvc_process_payload(uvc_stream_handle_t *strmh, uint8_t *payload, size_t payload_len);
+void _uvc_stream_set_mode(uvc_stream_handle_t *strmh, uvc_frame_desc_t *frame_desc,
+                          enum uvc_frame_format format);
+void *_uvc_user_caller(void *arg);
+
+uint64_t uvc_now_us(void);
+
+#ifdef LIBUVC_HAS_SYNTHETIC
+/** Payload generator behind an in-memory device */
+typedef struct uvc_synthetic_device {
+  enum uvc_frame_format format;
+  uint16_t width, height;
+  /** Frame interval in 100ns units, 0 for unpaced */
+  uint32_t interval;
+  /** Largest payload emitted, header included */
+  size_t max_payload;
+  /** Frame the producer emits, guarded by image_mutex while it runs */
+  uint8_t *image;
+  size_t image_bytes;
+  pthread_mutex_t image_mutex;
+  /** Set once uvc_synthetic_set_frame() has replaced the test pattern */
+  int custom_image;
+  uint8_t *payload_buf;
+  /** Frames and payloads generated so far */
+  uint64_t frames, payloads;
+  pthread_t producer;
+  volatile int producer_running;
+  /** Emulated standard controls, answered by uvc_synthetic_ctrl_transfer() */
+  struct uvc_synthetic_ctrl *ctrls;
+  size_t num_ctrls;
+  /** Time each control request takes, in microseconds */
+  uint32_t ctrl_delay_us;
+  pthread_mutex_t ctrl_mutex;
+  /** Whether brightness, gain and exposure changes reach the image */
+  int ctrl_response;
+  /** Frames between such a change and the image starting to follow it */
+  uint32_t response_frames;
+  /** Luma offset of the emitted image, the offset it is heading for,
+   * and the frame at which it starts moving */
+  int luma_offset, luma_target;
+  uint64_t luma_target_frame;
+} uvc_synthetic_device_t;
+
+/** Start a thread that pushes frames at the device's frame interval */
+#define UVC_SYNTHETIC_PRODUCER (1 << 0)
+
+uvc_error_t uvc_synthetic_open(uvc_context_t *ctx, enum uvc_frame_format format,
+    uint16_t width, uint16_t height, uint32_t interval, uvc_device_handle_t **devhp);
+uvc_error_t uvc_synthetic_set_frame(uvc_device_handle_t *devh,
+    const uint8_t *data, size_t data_bytes);
+uvc_error_t uvc_synthetic_set_max_payload(uvc_device_handle_t *devh, size_t max_payload);
+uvc_error_t uvc_synthetic_set_max_frame_size(uvc_device_handle_t *devh, uint32_t max_frame_size);
+uvc_error_t uvc_synthetic_stream_start(uvc_device_handle_t *devh, uvc_stream_handle_t **strmhp,
+    uvc_frame_callback_t *cb, void *user_ptr, uint8_t flags);
+void uvc_synthetic_set_ctrl_delay(uvc_device_handle_t *devh, uint32_t delay_us);
+void uvc_synthetic_set_ctrl_response(uvc_device_handle_t *devh, int enabled,
+    uint32_t response_frames);
+int uvc_synthetic_ctrl_transfer(uvc_device_handle_t *devh, enum uvc_req_code req_code,
+    uint8_t unit, uint8_t selector, void *data, int len);
+void uvc_synthetic_status_packet(uvc_device_handle_t *devh, const uint8_t *data, int len);
+void uvc_synthetic_feed(uvc_stream_handle_t *strmh, uint8_t *payload, size_t payload_len);
+size_t uvc_synthetic_push_frame(uvc_stream_handle_t *strmh,
+    const uint8_t *data, size_t data_bytes);
+void uvc_synthetic_stream_stop(uvc_stream_handle_t *strmh);
+void uvc_synthetic_close(uvc_device_handle_t *devh);
+
+/** Recorded VideoStreaming transfers (see replay.c for the file layout) */
+#define UVC_REPLAY_VERSION 1
+#define UVC_REPLAY_HEADER_SIZE 16
+
+enum uvc_replay_type {
+  UVC_REPLAY_ISOCHRONOUS = 0,
+  UVC_REPLAY_BULK = 1
+};
+
+typedef struct uvc_replay_header {
+  uint8_t bus;
+  uint8_t device;
+  uint8_t endpoint;
+} uvc_replay_header_t;
+
+typedef struct uvc_replay_packet {
+  int32_t status;
+  uint32_t length;
+} uvc_replay_packet_t;
+
+typedef struct uvc_replay_record {
+  enum uvc_replay_type type;
+  int32_t status;
+  uint64_t timestamp_us;
+  uint32_t num_packets;
+  uvc_replay_packet_t *packets;
+  uint32_t data_len;
+  uint8_t *data;
+  /* capacity of packets/data, managed by uvc_replay_read_record() */
+  uint32_t packets_alloc, data_alloc;
+} uvc_replay_record_t;
+
+uvc_error_t uvc_replay_write_header(FILE *fp, const uvc_replay_header_t *hdr);
+uvc_error_t uvc_replay_read_header(FILE *fp, uvc_replay_header_t *hdr);
+uvc_error_t uvc_replay_write_record(FILE *fp, const uvc_replay_record_t *rec);
+uvc_error_t uvc_replay_read_record(FILE *fp, uvc_replay_record_t *rec);
+void uvc_replay_free_record(uvc_replay_record_t *rec);
+typedef void (uvc_replay_payload_cb_t)(uvc_stream_handle_t *strmh, void *user_ptr);
+
+size_t uvc_replay_feed(uvc_stream_handle_t *strmh, const uvc_replay_record_t *rec,
+    uvc_replay_payload_cb_t *payload_cb, void *user_ptr);
+#endif
 
 #endif // !def(LIBUVC_INTERNAL_H)
 /** @endcond */
@@ -0,0 +1,432 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (C) 2010-2012 Ken Tossell
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the author nor other contributors may be
+*     used to endorse or promote products derived from this software
+*     without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+/**
+ * @internal
+ * @file ctrl-async.c
+ * @brief Asynchronous control requests.
+ *
+ * Each request is a libusb control transfer with its own completion
+ * callback, so a caller can have any number of requests on the device's
+ * control pipe at once instead of waiting out each round trip in turn.
+ * Completions run on whichever thread handles libusb events: the
+ * library's handler thread if it owns the USB context, otherwise the
+ * application's.
+ *
+ * Requests go through the same control cache as uvc_get_ctrl() and
+ * uvc_set_ctrl(). A GET the cache can answer, and every request to a
+ * synthetic device, completes before the submitting call returns.
+ */
+#include "libuvc/libuvc.h"
+#include "libuvc/libuvc_internal.h"
+
+static const int REQ_TYPE_SET = 0x21;
+static const int REQ_TYPE_GET = 0xa1;
+
+/** One submitted request */
+typedef struct uvc_ctrl_request {
+  struct uvc_ctrl_request *prev, *next;
+  uvc_device_handle_t *devh;
+  struct libusb_transfer *transfer;
+  uint8_t unit;
+  uint8_t selector;
+  enum uvc_req_code req_code;
+  int len;
+  /** For generated accessors: where to decode a complete response to */
+  const uvc_ctrl_def_t *def;
+  void *out[UVC_CTRL_MAX_FIELDS];
+  /** Report UVC_SUCCESS for a full-length transfer instead of its length */
+  uint8_t status_only;
+  uvc_ctrl_callback_t *cb;
+  void *user_ptr;
+} uvc_ctrl_request_t;
+
+static uvc_ctrl_request_t *ctrl_request_new(uvc_device_handle_t *devh, uint8_t unit,
+                                            uint8_t selector, enum uvc_req_code req_code,
+                                            int len, uvc_ctrl_callback_t *cb, void *user_ptr) {
+  uvc_ctrl_request_t *req = calloc(1, sizeof(*req));
+
+  if (!req)
+    return NULL;
+
+  req->devh = devh;
+  req->unit = unit;
+  req->selector = selector;
+  req->req_code = req_code;
+  req->len = len;
+  req->cb = cb;
+  req->user_ptr = user_ptr;
+
+  return req;
+}
+
+/* Reports the result of a request to its owner */
+static void ctrl_request_finish(uvc_ctrl_request_t *req, int result, uint8_t *data) {
+  if (result >= 0) {
+    if (req->req_code == UVC_SET_CUR) {
+      if (result == req->len)
+        uvc_ctrl_cache_update_cur(req->devh, req->unit, req->selector, data, req->len);
+    } else {
+      uvc_ctrl_cache_store(req->devh, req->unit, req->selector, req->req_code,
+                           data, req->len, result);
+    }
+  }
+
+  if (req->status_only && result == req->len) {
+    if (req->def && req->req_code != UVC_SET_CUR)
+      uvc_ctrl_def_unpack(req->def, data, req->out);
+    result = UVC_SUCCESS;
+  }
+
+  if (req->cb)
+    req->cb(result, data, req->user_ptr);
+}
+
+static int ctrl_transfer_result(struct libusb_transfer *transfer) {
+  switch (transfer->status) {
+  case LIBUSB_TRANSFER_COMPLETED:
+    return transfer->actual_length;
+  case LIBUSB_TRANSFER_STALL:
+    return UVC_ERROR_PIPE;
+  case LIBUSB_TRANSFER_TIMED_OUT:
+    return UVC_ERROR_TIMEOUT;
+  case LIBUSB_TRANSFER_CANCELLED:
+    return UVC_ERROR_INTERRUPTED;
+  case LIBUSB_TRANSFER_NO_DEVICE:
+    return UVC_ERROR_NO_DEVICE;
+  case LIBUSB_TRANSFER_OVERFLOW:
+    return UVC_ERROR_OVERFLOW;
+  default:
+    return UVC_ERROR_IO;
+  }
+}
+
+static void LIBUSB_CALL _uvc_ctrl_callback(struct libusb_transfer *transfer) {
+  uvc_ctrl_request_t *req = transfer->user_data;
+  uvc_device_handle_t *devh = req->devh;
+
+  ctrl_request_finish(req, ctrl_transfer_result(transfer),
+                      libusb_control_transfer_get_data(transfer));
+
+  pthread_mutex_lock(&devh->ctrl_async_mutex);
+  DL_DELETE(devh->ctrl_requests, req);
+  pthread_cond_broadcast(&devh->ctrl_async_cond);
+  pthread_mutex_unlock(&devh->ctrl_async_mutex);
+
+  free(transfer->buffer);
+  libusb_free_transfer(transfer);
+  free(req);
+}
+
+/* Sends the request, or completes it on the spot if it needs no USB
+ * traffic. Takes ownership of @p req. For SET_CUR, @p data is the value. */
+static uvc_error_t ctrl_request_submit(uvc_ctrl_request_t *req, const void *data) {
+  uvc_device_handle_t *devh = req->devh;
+  uint8_t *buf;
+  int ret;
+
+  if (req->len < 0 || req->len > UINT16_MAX) {
+    free(req);
+    return UVC_ERROR_INVALID_PARAM;
+  }
+
+  buf = malloc(LIBUSB_CONTROL_SETUP_SIZE + req->len);
+  if (!buf) {
+    free(req);
+    return UVC_ERROR_NO_MEM;
+  }
+
+  if (req->req_code == UVC_SET_CUR)
+    memcpy(buf + LIBUSB_CONTROL_SETUP_SIZE, data, req->len);
+
+  if (req->req_code != UVC_SET_CUR) {
+    ret = uvc_ctrl_cache_lookup(devh, req->unit, req->selector, req->req_code,
+                                buf + LIBUSB_CONTROL_SETUP_SIZE, req->len);
+    if (ret >= 0) {
+      ctrl_request_finish(req, ret, buf + LIBUSB_CONTROL_SETUP_SIZE);
+      free(buf);
+      free(req);
+      return UVC_SUCCESS;
+    }
+  }
+
+#ifdef LIBUVC_HAS_SYNTHETIC
+  if (devh->synthetic) {
+    ret = uvc_synthetic_ctrl_transfer(devh, req->req_code, req->unit, req->selector,
+                                      buf + LIBUSB_CONTROL_SETUP_SIZE, req->len);
+    ctrl_request_finish(req, ret, buf + LIBUSB_CONTROL_SETUP_SIZE);
+    free(buf);
+    free(req);
+    return UVC_SUCCESS;
+  }
+#endif
+
+  req->transfer = libusb_alloc_transfer(0);
+  if (!req->transfer) {
+    free(buf);
+    free(req);
+    return UVC_ERROR_NO_MEM;
+  }
+
+  libusb_fill_control_setup(buf,
+                            req->req_code == UVC_SET_CUR ? REQ_TYPE_SET : REQ_TYPE_GET,
+                            req->req_code,
+                            req->selector << 8,
+                            req->unit << 8 | devh->info->ctrl_if.bInterfaceNumber,
+                            req->len);
+
+  /* the device is gone while uvc_reattach_device() replaces usb_devh */
+  if (pthread_rwlock_tryrdlock(&devh->usb_devh_lock)) {
+    libusb_free_transfer(req->transfer);
+    free(buf);
+    free(req);
+    return UVC_ERROR_NO_DEVICE;
+  }
+
+  libusb_fill_control_transfer(req->transfer, devh->usb_devh, buf,
+                               _uvc_ctrl_callback, req, 0);
+
+  /* listed before submission: the callback may run before submit returns */
+  pthread_mutex_lock(&devh->ctrl_async_mutex);
+  DL_APPEND(devh->ctrl_requests, req);
+  pthread_mutex_unlock(&devh->ctrl_async_mutex);
+
+  ret = libusb_submit_transfer(req->transfer);
+  pthread_rwlock_unlock(&devh->usb_devh_lock);
+  if (ret < 0) {
+    pthread_mutex_lock(&devh->ctrl_async_mutex);
+    DL_DELETE(devh->ctrl_requests, req);
+    pthread_cond_broadcast(&devh->ctrl_async_cond);
+    pthread_mutex_unlock(&devh->ctrl_async_mutex);
+
+    libusb_free_transfer(req->transfer);
+    free(buf);
+    free(req);
+    return ret;
+  }
+
+  return UVC_SUCCESS;
+}
+
+/** @internal
+ * @brief Set up the asynchronous request state of a new device handle
+ */
+void uvc_ctrl_async_init(uvc_device_handle_t *devh) {
+  devh->ctrl_requests = NULL;
+  pthread_mutex_init(&devh->ctrl_async_mutex, NULL);
+  pthread_cond_init(&devh->ctrl_async_cond, NULL);
+}
+
+/** @internal
+ * @brief Release the asynchronous request state; no request may be pending
+ */
+void uvc_ctrl_async_free(uvc_device_handle_t *devh) {
+  pthread_cond_destroy(&devh->ctrl_async_cond);
+  pthread_mutex_destroy(&devh->ctrl_async_mutex);
+}
+
+/** @brief Submit a GET_* request without waiting for the answer
+ * @ingroup ctrl
+ *
+ * @p cb receives the number of bytes read, or a uvc_error_t, along with
+ * the data, which is only valid during the call. It runs on the thread that
+ * handles libusb events, or before this function returns if the request
+ * could be answered from the control cache or the device is synthetic.
+ *
+ * @param devh UVC device handle
+ * @param unit Unit or Terminal ID
+ * @param ctrl Control number to query
+ * @param len Number of bytes to request
+ * @param req_code GET_* request to execute
+ * @param cb Completion callback, or NULL
+ * @param user_ptr Passed to @p cb
+ * @return UVC_SUCCESS if the request was submitted; otherwise @p cb is not
+ *   called
+ */
+uvc_error_t uvc_get_ctrl_async(uvc_device_handle_t *devh, uint8_t unit, uint8_t ctrl, int len,
+                               enum uvc_req_code req_code, uvc_ctrl_callback_t *cb,
+                               void *user_ptr) {
+  uvc_ctrl_request_t *req;
+
+  if (req_code == UVC_SET_CUR)
+    return UVC_ERROR_INVALID_PARAM;
+
+  req = ctrl_request_new(devh, unit, ctrl, req_code, len, cb, user_ptr);
+  if (!req)
+    return UVC_ERROR_NO_MEM;
+
+  return ctrl_request_submit(req, NULL);
+}
+
+/** @brief Submit a SET_CUR request without waiting for it to complete
+ * @ingroup ctrl
+ *
+ * @p data is copied; it may be reused as soon as this returns. See
+ * uvc_get_ctrl_async() for when @p cb runs; it receives the number of
+ * bytes sent, or a uvc_error_t.
+ *
+ * @param devh UVC device handle
+ * @param unit Unit or Terminal ID
+ * @param ctrl Control number to set
+ * @param data Value to send
+ * @param len Size of @p data
+ * @param cb Completion callback, or NULL
+ * @param user_ptr Passed to @p cb
+ * @return UVC_SUCCESS if the request was submitted; otherwise @p cb is not
+ *   called
+ */
+uvc_error_t uvc_set_ctrl_async(uvc_device_handle_t *devh, uint8_t unit, uint8_t ctrl,
+                               const void *data, int len, uvc_ctrl_callback_t *cb,
+                               void *user_ptr) {
+  uvc_ctrl_request_t *req = ctrl_request_new(devh, unit, ctrl, UVC_SET_CUR, len, cb, user_ptr);
+
+  if (!req)
+    return UVC_ERROR_NO_MEM;
+
+  return ctrl_request_submit(req, data);
+}
+
+/** @internal
+ * @brief GET request of a generated asynchronous accessor
+ *
+ * On a full-length answer the fields are decoded through @p out (see
+ * uvc_ctrl_def_unpack()) and @p cb receives UVC_SUCCESS.
+ */
+uvc_error_t uvc_get_ctrl_fields_async(uvc_device_handle_t *devh, const uvc_ctrl_def_t *def,
+                                      void *const *out, enum uvc_req_code req_code,
+                                      uvc_ctrl_callback_t *cb, void *user_ptr) {
+  uvc_ctrl_request_t *req;
+  uint8_t unit = uvc_ctrl_def_unit_id(devh, def);
+
+  if (!unit)
+    return UVC_ERROR_NOT_SUPPORTED;
+  if (req_code == UVC_SET_CUR)
+    return UVC_ERROR_INVALID_PARAM;
+
+  req = ctrl_request_new(devh, unit, def->selector, req_code, def->length, cb, user_ptr);
+  if (!req)
+    return UVC_ERROR_NO_MEM;
+
+  req->def = def;
+  memcpy(req->out, out, def->num_fields * sizeof(out[0]));
+  req->status_only = 1;
+
+  return ctrl_request_submit(req, NULL);
+}
+
+/** @internal
+ * @brief SET_CUR request of a generated asynchronous accessor
+ *
+ * @p cb receives UVC_SUCCESS once the whole value has been sent.
+ */
+uvc_error_t uvc_set_ctrl_fields_async(uvc_device_handle_t *devh, const uvc_ctrl_def_t *def,
+                                      const int64_t *values,
+                                      uvc_ctrl_callback_t *cb, void *user_ptr) {
+  uvc_ctrl_request_t *req;
+  uint8_t data[UVC_CTRL_DEF_MAX_LEN];
+  uint8_t unit = uvc_ctrl_def_unit_id(devh, def);
+
+  if (!unit)
+    return UVC_ERROR_NOT_SUPPORTED;
+
+  req = ctrl_request_new(devh, unit, def->selector, UVC_SET_CUR, def->length, cb, user_ptr);
+  if (!req)
+    return UVC_ERROR_NO_MEM;
+
+  req->status_only = 1;
+  uvc_ctrl_def_pack(def, values, data);
+
+  return ctrl_request_submit(req, data);
+}
+
+/** @brief Wait until every asynchronous control request has completed
+ * @ingroup ctrl
+ *
+ * Something must keep handling libusb events meanwhile: the library's
+ * handler thread does if the library created the USB context.
+ *
+ * @param devh UVC device handle
+ */
+void uvc_wait_ctrl_async(uvc_device_handle_t *devh) {
+  pthread_mutex_lock(&devh->ctrl_async_mutex);
+  while (devh->ctrl_requests)
+    pthread_cond_wait(&devh->ctrl_async_cond, &devh->ctrl_async_mutex);
+  pthread_mutex_unlock(&devh->ctrl_async_mutex);
+}
+
+/** @brief Cancel the pending asynchronous control requests
+ * @ingroup ctrl
+ *
+ * Their callbacks still run, with UVC_ERROR_INTERRUPTED unless the request
+ * completed anyway. uvc_close() does this and then waits for them, handling
+ * libusb events itself if the application owns the USB context.
+ *
+ * @param devh UVC device handle
+ */
+void uvc_cancel_ctrl_async(uvc_device_handle_t *devh) {
+  uvc_ctrl_request_t *req;
+
+  pthread_mutex_lock(&devh->ctrl_async_mutex);
+  DL_FOREACH(devh->ctrl_requests, req)
+    libusb_cancel_transfer(req->transfer);
+  pthread_mutex_unlock(&devh->ctrl_async_mutex);
+}
+
+/** @internal
+ * @brief Cancel the pending asynchronous requests and wait for them to retire
+ *
+ * With the library's own event thread running, that thread completes them.
+ * Otherwise the application may not be handling events right now, so they
+ * are handled here until the cancelled requests are gone.
+ */
+void uvc_ctrl_async_drain(uvc_device_handle_t *devh) {
+  uvc_context_t *ctx = devh->dev->ctx;
+
+  uvc_cancel_ctrl_async(devh);
+
+  if (ctx->handler_thread_running) {
+    uvc_wait_ctrl_async(devh);
+    return;
+  }
+
+  pthread_mutex_lock(&devh->ctrl_async_mutex);
+  while (devh->ctrl_requests) {
+    struct timeval tv = { 0, 100000 };
+
+    /* the callbacks take ctrl_async_mutex */
+    pthread_mutex_unlock(&devh->ctrl_async_mutex);
+    libusb_handle_events_timeout_completed(ctx->usb_ctx, &tv, NULL);
+    pthread_mutex_lock(&devh->ctrl_async_mutex);
+  }
+  pthread_mutex_unlock(&devh->ctrl_async_mutex);
+}
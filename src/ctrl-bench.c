@@ -0,0 +1,332 @@
+/* uvc-ctrl-bench: measure control request round-trip latency.
+ *
+ * Walks every standard control in standard-units.yaml (through the table
+ * ctrl-gen.py generates into ctrl-table.c), skips those the device does not
+ * answer GET_INFO for, and times repeated GET_CUR, GET_MIN, GET_MAX,
+ * GET_INFO and SET_CUR requests on the rest. SET_CUR writes back the value
+ * GET_CUR returned, so the device ends up as it was. Latency percentiles per
+ * control and request are written as JSON.
+ *
+ * With --virtual the requests go to a synthetic device, optionally with an
+ * emulated round-trip delay; this measures the library's own overhead.
+ *
+ * The control caches are disabled so that every request reaches the
+ * device; --cached and --cur-max-age turn them on to measure what
+ * applications actually see.
+ */
+#include "libuvc/libuvc.h"
+#include "libuvc/libuvc_internal.h"
+#include "tools-common.h"
+
+#include <getopt.h>
+
+enum bench_request {
+  BENCH_GET_CUR,
+  BENCH_GET_MIN,
+  BENCH_GET_MAX,
+  BENCH_GET_INFO,
+  BENCH_SET_CUR,
+  BENCH_NUM_REQUESTS
+};
+
+static const struct {
+  const char *name;
+  enum uvc_req_code req_code;
+} bench_requests[BENCH_NUM_REQUESTS] = {
+  { "get_cur", UVC_GET_CUR },
+  { "get_min", UVC_GET_MIN },
+  { "get_max", UVC_GET_MAX },
+  { "get_info", UVC_GET_INFO },
+  { "set_cur", UVC_SET_CUR },
+};
+
+struct bench_result {
+  const char *skipped;
+  int ok, errors;
+  uvc_error_t last_error;
+  double min_us, p50_us, p90_us, p99_us, max_us, mean_us;
+};
+
+/** Time @p iterations identical requests on one control */
+static void bench_request(uvc_device_handle_t *devh, uint8_t unit, const uvc_ctrl_def_t *def,
+                          enum uvc_req_code req_code, uint8_t *value, int iterations,
+                          double *samples, struct bench_result *res) {
+  uint8_t buf[64];
+  double sum = 0;
+  int i, ret, len;
+
+  len = req_code == UVC_GET_INFO ? 1 : def->length;
+
+  for (i = 0; i < iterations; ++i) {
+    double start = tool_now();
+
+    if (req_code == UVC_SET_CUR) {
+      memcpy(buf, value, len);
+      ret = uvc_set_ctrl(devh, unit, def->selector, buf, len);
+    } else {
+      ret = uvc_get_ctrl(devh, unit, def->selector, buf, len, req_code);
+    }
+
+    if (ret < 0) {
+      res->errors++;
+      res->last_error = ret;
+      continue;
+    }
+
+    samples[res->ok] = (tool_now() - start) * 1e6;
+    sum += samples[res->ok];
+    res->ok++;
+  }
+
+  if (!res->ok)
+    return;
+
+  qsort(samples, res->ok, sizeof(double), tool_compare_double);
+  res->min_us = samples[0];
+  res->p50_us = tool_percentile(samples, res->ok, 50);
+  res->p90_us = tool_percentile(samples, res->ok, 90);
+  res->p99_us = tool_percentile(samples, res->ok, 99);
+  res->max_us = samples[res->ok - 1];
+  res->mean_us = sum / res->ok;
+}
+
+static int control_selected(const char *list, const char *name) {
+  size_t len = strlen(name);
+  const char *p = list;
+
+  if (!list)
+    return 1;
+
+  while ((p = strstr(p, name)) != NULL) {
+    if ((p == list || p[-1] == ',') && (p[len] == ',' || p[len] == '\0'))
+      return 1;
+    p += len;
+  }
+
+  return 0;
+}
+
+static void write_result(FILE *fp, const char *name, const struct bench_result *res, int last) {
+  fprintf(fp, "        \"%s\": ", name);
+  if (res->skipped) {
+    fprintf(fp, "{\"skipped\": \"%s\"}", res->skipped);
+  } else {
+    fprintf(fp, "{\"ok\": %d, \"errors\": %d", res->ok, res->errors);
+    if (res->errors) {
+      fprintf(fp, ", \"last_error\": ");
+      tool_json_string(fp, uvc_strerror(res->last_error));
+    }
+    if (res->ok) {
+      fprintf(fp, ", \"min_us\": %.2f, \"p50_us\": %.2f, \"p90_us\": %.2f, "
+              "\"p99_us\": %.2f, \"max_us\": %.2f, \"mean_us\": %.2f",
+              res->min_us, res->p50_us, res->p90_us, res->p99_us, res->max_us, res->mean_us);
+    }
+    fprintf(fp, "}");
+  }
+  fprintf(fp, "%s\n", last ? "" : ",");
+}
+
+static void usage(const char *argv0) {
+  fprintf(stderr,
+          "Usage: %s [options]\n"
+          "  -v, --device VID:PID   device to open (hex; default: first UVC device)\n"
+          "  -S, --serial SN        device serial number\n"
+          "  -n, --virtual          use a synthetic device instead of a camera\n"
+          "  -D, --mock-delay US    round-trip time of the synthetic device (default 0)\n"
+          "  -i, --iterations N     requests per control and request type (default 100)\n"
+          "  -c, --controls LIST    comma-separated control names (default: all)\n"
+          "  -C, --cached           keep the control range cache enabled\n"
+          "  -A, --cur-max-age MS   cache current values for up to MS milliseconds\n"
+          "  -o, --output FILE      write JSON to FILE instead of stdout\n",
+          argv0);
+}
+
+int main(int argc, char **argv) {
+  static const struct option long_options[] = {
+    { "device", required_argument, NULL, 'v' },
+    { "serial", required_argument, NULL, 'S' },
+    { "virtual", no_argument, NULL, 'n' },
+    { "mock-delay", required_argument, NULL, 'D' },
+    { "iterations", required_argument, NULL, 'i' },
+    { "controls", required_argument, NULL, 'c' },
+    { "cached", no_argument, NULL, 'C' },
+    { "cur-max-age", required_argument, NULL, 'A' },
+    { "output", required_argument, NULL, 'o' },
+    { "help", no_argument, NULL, 'h' },
+    { NULL, 0, NULL, 0 }
+  };
+  int vid = 0, pid = 0;
+  const char *serial = NULL, *controls = NULL, *output = NULL;
+  int use_virtual = 0, use_cache = 0, iterations = 100;
+  uint32_t mock_delay = 0;
+  long cur_max_age = -1;
+  uvc_context_t *ctx;
+  uvc_device_t *dev = NULL;
+  uvc_device_handle_t *devh;
+  uvc_device_descriptor_t *desc;
+  double *samples;
+  FILE *fp = stdout;
+  uvc_error_t res;
+  int opt, first = 1, supported = 0;
+  size_t i;
+
+  while ((opt = getopt_long(argc, argv, "v:S:nD:i:c:CA:o:h", long_options, NULL)) != -1) {
+    switch (opt) {
+    case 'v':
+      if (sscanf(optarg, "%x:%x", &vid, &pid) != 2) {
+        fprintf(stderr, "bad device '%s'\n", optarg);
+        return 1;
+      }
+      break;
+    case 'S':
+      serial = optarg;
+      break;
+    case 'n':
+      use_virtual = 1;
+      break;
+    case 'D':
+      mock_delay = (uint32_t) strtoul(optarg, NULL, 10);
+      break;
+    case 'i':
+      iterations = atoi(optarg);
+      break;
+    case 'c':
+      controls = optarg;
+      break;
+    case 'C':
+      use_cache = 1;
+      break;
+    case 'A':
+      cur_max_age = strtol(optarg, NULL, 10);
+      break;
+    case 'o':
+      output = optarg;
+      break;
+    default:
+      usage(argv[0]);
+      return opt == 'h' ? 0 : 1;
+    }
+  }
+
+  if (iterations <= 0) {
+    usage(argv[0]);
+    return 1;
+  }
+
+  res = uvc_init(&ctx, NULL);
+  if (res < 0) {
+    uvc_perror(res, "uvc_init");
+    return 1;
+  }
+
+  if (use_virtual) {
+    res = uvc_synthetic_open(ctx, UVC_FRAME_FORMAT_YUYV, 640, 480, 333333, &devh);
+    if (res == UVC_SUCCESS)
+      uvc_synthetic_set_ctrl_delay(devh, mock_delay);
+  } else {
+    res = uvc_find_device(ctx, &dev, vid, pid, serial);
+    if (res == UVC_SUCCESS)
+      res = uvc_open(dev, &devh);
+  }
+  if (res != UVC_SUCCESS) {
+    uvc_perror(res, use_virtual ? "uvc_synthetic_open" : "opening device");
+    if (dev)
+      uvc_unref_device(dev);
+    uvc_exit(ctx);
+    return 1;
+  }
+
+  uvc_set_ctrl_cache_enabled(devh, use_cache);
+  if (cur_max_age >= 0)
+    uvc_set_ctrl_cur_cache(devh, 1, (uint32_t) cur_max_age);
+
+  if (output) {
+    fp = fopen(output, "w");
+    if (!fp) {
+      perror(output);
+      fp = stdout;
+    }
+  }
+
+  samples = malloc(iterations * sizeof(double));
+
+  fprintf(fp, "{\n");
+  if (use_virtual) {
+    fprintf(fp, "  \"virtual\": true,\n  \"mock_delay_us\": %u,\n", mock_delay);
+  } else if (uvc_get_device_descriptor(dev, &desc) == UVC_SUCCESS) {
+    fprintf(fp, "  \"virtual\": false,\n  \"vid\": \"%04x\",\n  \"pid\": \"%04x\",\n  \"product\": ",
+            desc->idVendor, desc->idProduct);
+    tool_json_string(fp, desc->product);
+    fprintf(fp, ",\n");
+    uvc_free_device_descriptor(desc);
+  }
+  fprintf(fp, "  \"cached\": %s,\n  \"cur_max_age_ms\": %ld,\n  \"iterations\": %d,\n"
+          "  \"controls\": {\n", use_cache ? "true" : "false", cur_max_age, iterations);
+
+  for (i = 0; i < uvc_ctrl_def_count; ++i) {
+    const uvc_ctrl_def_t *def = &uvc_ctrl_defs[i];
+    struct bench_result results[BENCH_NUM_REQUESTS];
+    uint8_t info, value[64];
+    uint8_t unit;
+    int r, ret;
+
+    if (!control_selected(controls, def->name))
+      continue;
+
+    unit = uvc_ctrl_def_unit_id(devh, def);
+    if (!unit || uvc_get_ctrl(devh, unit, def->selector, &info, 1, UVC_GET_INFO) != 1)
+      continue;
+
+    memset(results, 0, sizeof(results));
+    for (r = 0; r < BENCH_NUM_REQUESTS; ++r) {
+      if (r == BENCH_SET_CUR) {
+        if (!(info & UVC_CONTROL_CAP_SET)) {
+          results[r].skipped = "not settable";
+          continue;
+        }
+        if (info & UVC_CONTROL_CAP_DISABLED) {
+          results[r].skipped = "disabled";
+          continue;
+        }
+        ret = uvc_get_ctrl(devh, unit, def->selector, value, def->length, UVC_GET_CUR);
+        if (ret != def->length) {
+          results[r].skipped = "current value unreadable";
+          continue;
+        }
+      } else if (r != BENCH_GET_INFO && !(info & UVC_CONTROL_CAP_GET)) {
+        results[r].skipped = "not readable";
+        continue;
+      }
+
+      bench_request(devh, unit, def, bench_requests[r].req_code, value, iterations,
+                    samples, &results[r]);
+    }
+
+    fprintf(fp, "%s    \"%s\": {\n", first ? "" : ",\n", def->name);
+    fprintf(fp, "      \"unit\": %u,\n      \"selector\": %u,\n      \"length\": %u,\n"
+            "      \"info\": %u,\n      \"requests\": {\n",
+            unit, def->selector, def->length, info);
+    for (r = 0; r < BENCH_NUM_REQUESTS; ++r)
+      write_result(fp, bench_requests[r].name, &results[r], r + 1 == BENCH_NUM_REQUESTS);
+    fprintf(fp, "      }\n    }");
+
+    first = 0;
+    supported++;
+  }
+
+  fprintf(fp, "%s  },\n  \"supported\": %d\n}\n", first ? "" : "\n", supported);
+
+  if (fp != stdout)
+    fclose(fp);
+  free(samples);
+
+  if (use_virtual) {
+    uvc_synthetic_close(devh);
+  } else {
+    uvc_close(devh);
+    uvc_unref_device(dev);
+  }
+  uvc_exit(ctx);
+
+  return supported ? 0 : 2;
+}
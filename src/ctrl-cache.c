@@ -0,0 +1,653 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (C) 2010-2012 Ken Tossell
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the author nor other contributors may be
+*     used to endorse or promote products derived from this software
+*     without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+/**
+ * @internal
+ * @file ctrl-cache.c
+ * @brief Per-device cache of control values, capabilities and ranges.
+ *
+ * GET_MIN, GET_MAX, GET_RES, GET_LEN and GET_DEF answers do not change
+ * while a device is open, except where the device says so with a status
+ * interrupt or a new streaming mode is committed. uvc_get_ctrl() serves
+ * those request codes from here once they have been read, either on first
+ * use or by uvc_prefetch_ctrl_ranges(). GET_INFO always goes to the device:
+ * its disabled bit follows the automatic modes.
+ *
+ * GET_CUR answers are only cached when the application asks for it with
+ * uvc_set_ctrl_cur_cache(). They are kept up to date from SET_CUR requests
+ * and from the value change events of the status endpoint, and are served
+ * until they are older than the control's staleness bound.
+ *
+ * Entries also carry the length and shadow value of extension unit
+ * controls accessed through ctrl-xu.c, so that the same events keep them
+ * coherent.
+ */
+#include "libuvc/libuvc.h"
+#include "libuvc/libuvc_internal.h"
+
+#define CUR_SLOT (UVC_GET_CUR - UVC_GET_CUR)
+
+static int ctrl_cache_slot(uvc_device_handle_t *devh, enum uvc_req_code req_code) {
+  if (req_code == UVC_GET_CUR)
+    return devh->ctrl_cur_cache_enabled ? CUR_SLOT : -1;
+
+  if (req_code < UVC_GET_MIN || req_code > UVC_GET_DEF || req_code == UVC_GET_INFO ||
+      !devh->ctrl_cache_enabled)
+    return -1;
+
+  return req_code - UVC_GET_CUR;
+}
+
+static uvc_ctrl_cache_entry_t *ctrl_cache_find(uvc_device_handle_t *devh,
+                                               uint8_t unit, uint8_t selector) {
+  uvc_ctrl_cache_entry_t *entry;
+
+  DL_FOREACH(devh->ctrl_cache, entry) {
+    if (entry->unit == unit && entry->selector == selector)
+      return entry;
+  }
+
+  return NULL;
+}
+
+static uvc_ctrl_cache_entry_t *ctrl_cache_find_or_add(uvc_device_handle_t *devh,
+                                                      uint8_t unit, uint8_t selector) {
+  uvc_ctrl_cache_entry_t *entry = ctrl_cache_find(devh, unit, selector);
+
+  if (entry)
+    return entry;
+
+  entry = calloc(1, sizeof(*entry));
+  if (!entry)
+    return NULL;
+
+  entry->unit = unit;
+  entry->selector = selector;
+  entry->cur_max_age_ms = devh->ctrl_cur_max_age_ms;
+  DL_APPEND(devh->ctrl_cache, entry);
+
+  return entry;
+}
+
+/* Drops the cached data but keeps the entry's staleness bound and
+ * whether it is volatile */
+static void ctrl_cache_clear_entry(uvc_ctrl_cache_entry_t *entry) {
+  int slot;
+
+  for (slot = 0; slot < UVC_CTRL_CACHE_SLOTS; ++slot) {
+    free(entry->data[slot]);
+    entry->data[slot] = NULL;
+    entry->len[slot] = 0;
+  }
+  entry->valid = entry->complete = 0;
+
+  free(entry->xu_shadow);
+  entry->xu_shadow = NULL;
+  entry->xu_shadow_valid = 0;
+  entry->xu_len = 0;
+}
+
+/* Drops the GET_MIN/MAX/RES/LEN/DEF answers but keeps the current
+ * value and the extension unit shadow */
+static void ctrl_cache_clear_ranges(uvc_ctrl_cache_entry_t *entry) {
+  int slot;
+
+  for (slot = 0; slot < UVC_CTRL_CACHE_SLOTS; ++slot) {
+    if (slot == CUR_SLOT)
+      continue;
+    free(entry->data[slot]);
+    entry->data[slot] = NULL;
+    entry->len[slot] = 0;
+    entry->valid &= ~(1 << slot);
+    entry->complete &= ~(1 << slot);
+  }
+}
+
+static void ctrl_cache_clear(uvc_device_handle_t *devh) {
+  uvc_ctrl_cache_entry_t *entry;
+
+  DL_FOREACH(devh->ctrl_cache, entry)
+    ctrl_cache_clear_entry(entry);
+}
+
+/* Caller holds ctrl_cache_mutex. Takes ownership of @p copy. */
+static void ctrl_cache_put(uvc_device_handle_t *devh, uint8_t unit, uint8_t selector,
+                           int slot, uint8_t *copy, int ret, int complete) {
+  uvc_ctrl_cache_entry_t *entry = ctrl_cache_find_or_add(devh, unit, selector);
+
+  if (!entry) {
+    free(copy);
+    return;
+  }
+
+  free(entry->data[slot]);
+  entry->data[slot] = copy;
+  entry->len[slot] = ret;
+  entry->valid |= 1 << slot;
+  if (complete)
+    entry->complete |= 1 << slot;
+  else
+    entry->complete &= ~(1 << slot);
+  if (slot == CUR_SLOT)
+    entry->cur_time_us = uvc_now_us();
+}
+
+static uint8_t *ctrl_cache_copy(const void *data, int len) {
+  uint8_t *copy = malloc(len > 0 ? len : 1);
+
+  if (copy && len > 0)
+    memcpy(copy, data, len);
+
+  return copy;
+}
+
+/** @internal
+ * @brief Set up the cache of a newly allocated device handle
+ */
+void uvc_ctrl_cache_init(uvc_device_handle_t *devh) {
+  devh->ctrl_cache = NULL;
+  devh->ctrl_cache_enabled = 1;
+  devh->ctrl_cur_cache_enabled = 0;
+  devh->ctrl_cur_max_age_ms = 0;
+  pthread_mutex_init(&devh->ctrl_cache_mutex, NULL);
+}
+
+/** @internal
+ * @brief Release everything held by the cache
+ */
+void uvc_ctrl_cache_free(uvc_device_handle_t *devh) {
+  uvc_ctrl_cache_entry_t *entry, *tmp;
+
+  DL_FOREACH_SAFE(devh->ctrl_cache, entry, tmp) {
+    DL_DELETE(devh->ctrl_cache, entry);
+    ctrl_cache_clear_entry(entry);
+    free(entry);
+  }
+
+  pthread_mutex_destroy(&devh->ctrl_cache_mutex);
+}
+
+/** @internal
+ * @brief Answer a GET request from the cache
+ *
+ * @return Number of bytes copied to @p data, or UVC_ERROR_NOT_FOUND if the
+ *   request has to go to the device
+ */
+int uvc_ctrl_cache_lookup(uvc_device_handle_t *devh, uint8_t unit, uint8_t selector,
+                          enum uvc_req_code req_code, void *data, int len) {
+  uvc_ctrl_cache_entry_t *entry;
+  int slot = ctrl_cache_slot(devh, req_code);
+  int ret = UVC_ERROR_NOT_FOUND;
+
+  if (slot < 0 || len < 0)
+    return UVC_ERROR_NOT_FOUND;
+
+  pthread_mutex_lock(&devh->ctrl_cache_mutex);
+
+  entry = ctrl_cache_find(devh, unit, selector);
+  if (entry && (entry->valid & (1 << slot))) {
+    if (slot == CUR_SLOT && entry->cur_max_age_ms != UVC_CTRL_CUR_NO_EXPIRY &&
+        uvc_now_us() - entry->cur_time_us >= (uint64_t) entry->cur_max_age_ms * 1000) {
+      /* stale; the device is asked again and the answer replaces it */
+    } else if (len <= entry->len[slot]) {
+      ret = len;
+    } else if (entry->complete & (1 << slot)) {
+      ret = entry->len[slot];
+    }
+
+    if (ret > 0)
+      memcpy(data, entry->data[slot], ret);
+  }
+
+  pthread_mutex_unlock(&devh->ctrl_cache_mutex);
+
+  return ret;
+}
+
+/** @internal
+ * @brief Remember the device's answer to a GET request
+ *
+ * @param len Number of bytes that were asked for
+ * @param ret Result of the transfer; failed transfers are not cached
+ */
+void uvc_ctrl_cache_store(uvc_device_handle_t *devh, uint8_t unit, uint8_t selector,
+                          enum uvc_req_code req_code, const void *data, int len, int ret) {
+  int slot = ctrl_cache_slot(devh, req_code);
+  uint8_t *copy;
+
+  if (slot < 0 || ret < 0 || ret > len || ret > UINT16_MAX)
+    return;
+
+  copy = ctrl_cache_copy(data, ret);
+  if (!copy)
+    return;
+
+  pthread_mutex_lock(&devh->ctrl_cache_mutex);
+  ctrl_cache_put(devh, unit, selector, slot, copy, ret, ret < len);
+  pthread_mutex_unlock(&devh->ctrl_cache_mutex);
+}
+
+/** @internal
+ * @brief Record a control's new current value
+ *
+ * Called with the value of a successful SET_CUR and with the content of a
+ * value change event. Neither says whether the value is the whole control,
+ * so only reads of at most @p len bytes are served from it.
+ */
+void uvc_ctrl_cache_update_cur(uvc_device_handle_t *devh, uint8_t unit, uint8_t selector,
+                               const void *data, int len) {
+  uvc_ctrl_cache_entry_t *entry;
+  uint8_t *copy = NULL;
+
+  if (len <= 0 || len > UINT16_MAX)
+    return;
+
+  if (devh->ctrl_cur_cache_enabled) {
+    copy = ctrl_cache_copy(data, len);
+    if (!copy)
+      return;
+  }
+
+  pthread_mutex_lock(&devh->ctrl_cache_mutex);
+
+  if (copy)
+    ctrl_cache_put(devh, unit, selector, CUR_SLOT, copy, len, 0);
+
+  /* extension unit shadows only hold whole values */
+  entry = ctrl_cache_find(devh, unit, selector);
+  if (entry && entry->xu_shadow && len == entry->xu_len) {
+    memcpy(entry->xu_shadow, data, len);
+    entry->xu_shadow_valid = 1;
+  }
+
+  pthread_mutex_unlock(&devh->ctrl_cache_mutex);
+}
+
+/** @internal
+ * @brief Forget what is cached for one control
+ */
+void uvc_ctrl_cache_invalidate_ctrl(uvc_device_handle_t *devh, uint8_t unit, uint8_t selector) {
+  uvc_ctrl_cache_entry_t *entry;
+
+  pthread_mutex_lock(&devh->ctrl_cache_mutex);
+
+  entry = ctrl_cache_find(devh, unit, selector);
+  if (entry)
+    ctrl_cache_clear_entry(entry);
+
+  pthread_mutex_unlock(&devh->ctrl_cache_mutex);
+}
+
+/** @internal
+ * @brief Find or create the cache entry of a control
+ *
+ * The caller holds ctrl_cache_mutex.
+ *
+ * @return The entry, or NULL if out of memory
+ */
+uvc_ctrl_cache_entry_t *uvc_ctrl_cache_entry(uvc_device_handle_t *devh, uint8_t unit,
+                                             uint8_t selector) {
+  return ctrl_cache_find_or_add(devh, unit, selector);
+}
+
+/** @brief Enable or disable the control range cache
+ * @ingroup ctrl
+ *
+ * The cache is enabled when a device is opened. While it is disabled every
+ * GET_MIN/MAX/RES/LEN/DEF request goes to the device; disabling it also
+ * empties it.
+ *
+ * @param devh UVC device handle
+ * @param enabled Nonzero to serve GET_MIN/MAX/RES/LEN/DEF from memory
+ */
+void uvc_set_ctrl_cache_enabled(uvc_device_handle_t *devh, int enabled) {
+  uvc_ctrl_cache_entry_t *entry;
+
+  pthread_mutex_lock(&devh->ctrl_cache_mutex);
+
+  devh->ctrl_cache_enabled = enabled ? 1 : 0;
+  if (!enabled) {
+    DL_FOREACH(devh->ctrl_cache, entry)
+      ctrl_cache_clear_ranges(entry);
+  }
+
+  pthread_mutex_unlock(&devh->ctrl_cache_mutex);
+}
+
+/** @brief Serve GET_CUR requests from memory
+ * @ingroup ctrl
+ *
+ * While enabled, uvc_get_ctrl() and the generated uvc_get_* accessors
+ * answer GET_CUR from the last value read from the device, written with
+ * SET_CUR or reported by a value change event on the status endpoint.
+ * A value older than the control's staleness bound is read again.
+ *
+ * This is off by default. Devices are not required to report every change
+ * (automatic exposure, for instance, may move without an event on some
+ * cameras), and a device may round a value it is sent; the staleness
+ * bound limits how long such a difference can go unnoticed.
+ *
+ * @param devh UVC device handle
+ * @param enabled Nonzero to cache current values
+ * @param max_age_ms Staleness bound of controls that do not have their own
+ *   (see uvc_set_ctrl_cur_max_age()); UVC_CTRL_CUR_NO_EXPIRY to rely on
+ *   status events alone
+ */
+void uvc_set_ctrl_cur_cache(uvc_device_handle_t *devh, int enabled, uint32_t max_age_ms) {
+  uvc_ctrl_cache_entry_t *entry;
+
+  pthread_mutex_lock(&devh->ctrl_cache_mutex);
+
+  DL_FOREACH(devh->ctrl_cache, entry) {
+    if (!entry->cur_max_age_set)
+      entry->cur_max_age_ms = max_age_ms;
+    if (!enabled) {
+      free(entry->data[CUR_SLOT]);
+      entry->data[CUR_SLOT] = NULL;
+      entry->len[CUR_SLOT] = 0;
+      entry->valid &= ~(1 << CUR_SLOT);
+    }
+  }
+
+  devh->ctrl_cur_max_age_ms = max_age_ms;
+  devh->ctrl_cur_cache_enabled = enabled ? 1 : 0;
+
+  pthread_mutex_unlock(&devh->ctrl_cache_mutex);
+}
+
+/** @brief Set how long one control's cached current value may be served
+ * @ingroup ctrl
+ *
+ * @param devh UVC device handle
+ * @param unit Unit or Terminal ID
+ * @param ctrl Control number
+ * @param max_age_ms Staleness bound in milliseconds; 0 to always read the
+ *   device, UVC_CTRL_CUR_NO_EXPIRY to rely on status events alone
+ * @return UVC_SUCCESS or UVC_ERROR_NO_MEM
+ */
+uvc_error_t uvc_set_ctrl_cur_max_age(uvc_device_handle_t *devh, uint8_t unit, uint8_t ctrl,
+                                     uint32_t max_age_ms) {
+  uvc_ctrl_cache_entry_t *entry;
+
+  pthread_mutex_lock(&devh->ctrl_cache_mutex);
+
+  entry = ctrl_cache_find_or_add(devh, unit, ctrl);
+  if (entry) {
+    entry->cur_max_age_ms = max_age_ms;
+    entry->cur_max_age_set = 1;
+  }
+
+  pthread_mutex_unlock(&devh->ctrl_cache_mutex);
+
+  return entry ? UVC_SUCCESS : UVC_ERROR_NO_MEM;
+}
+
+/** @internal
+ * @brief Forget the capabilities and ranges of every control
+ *
+ * Called when a streaming mode is committed. Current values and extension
+ * unit shadows are what the application last set; they are kept, so that
+ * uvc_ctrl_cache_restore() can still send them after a reattach.
+ */
+void uvc_ctrl_cache_invalidate_ranges(uvc_device_handle_t *devh) {
+  uvc_ctrl_cache_entry_t *entry;
+
+  pthread_mutex_lock(&devh->ctrl_cache_mutex);
+  DL_FOREACH(devh->ctrl_cache, entry)
+    ctrl_cache_clear_ranges(entry);
+  pthread_mutex_unlock(&devh->ctrl_cache_mutex);
+}
+
+/** @brief Empty the control cache
+ * @ingroup ctrl
+ *
+ * The library drops the cached capabilities and ranges itself when a
+ * streaming mode is committed, and single controls when the device
+ * reports a change of their capabilities or range. Call this if the
+ * device's settings may have changed in some other way. Staleness bounds
+ * are kept.
+ *
+ * @param devh UVC device handle
+ */
+void uvc_invalidate_ctrl_cache(uvc_device_handle_t *devh) {
+  pthread_mutex_lock(&devh->ctrl_cache_mutex);
+  ctrl_cache_clear(devh);
+  pthread_mutex_unlock(&devh->ctrl_cache_mutex);
+}
+
+struct ctrl_restore {
+  uint8_t unit, selector;
+  uint16_t len;
+  uint8_t *data;
+  /** Ask GET_INFO whether the device takes the value now */
+  uint8_t check_info;
+  /** See uvc_ctrl_def_rank() */
+  int rank;
+};
+
+/* Rank of a cached control; extension unit controls come last */
+static int restore_rank(uvc_device_handle_t *devh, uint8_t unit, uint8_t selector) {
+  size_t i;
+
+  for (i = 0; i < uvc_ctrl_def_count; ++i) {
+    if (uvc_ctrl_defs[i].selector == selector &&
+        uvc_ctrl_def_unit_id(devh, &uvc_ctrl_defs[i]) == unit)
+      return uvc_ctrl_def_rank(&uvc_ctrl_defs[i]);
+  }
+
+  return UVC_CTRL_RANKS - 1;
+}
+
+/** @internal
+ * @brief Write the cached values of settable controls back to the device
+ *
+ * Used after the device has been reattached (see stream-resume.c): the
+ * extension unit shadow values and the cached GET_CUR values are sent
+ * again. Automatic modes and limits go first, as in profile apply, so that
+ * the values they govern are judged against the restored modes; within a
+ * rank, controls keep the order they were first cached in. Volatile
+ * extension unit controls (see uvc_xu_set_volatile()) are not replayed:
+ * writing one is an action, not a setting. A GET_CUR value is skipped if
+ * GET_INFO now reports the control as not settable or disabled by an
+ * automatic mode. Failures are ignored.
+ *
+ * @return Number of controls restored
+ */
+int uvc_ctrl_cache_restore(uvc_device_handle_t *devh) {
+  uvc_ctrl_cache_entry_t *entry;
+  struct ctrl_restore *ctrls = NULL;
+  int num = 0, restored = 0, rank, i;
+
+  pthread_mutex_lock(&devh->ctrl_cache_mutex);
+  DL_FOREACH(devh->ctrl_cache, entry) {
+    const uint8_t *data = NULL;
+    uint16_t len = 0;
+    struct ctrl_restore *p;
+
+    if (entry->xu_volatile)
+      continue;
+
+    if (entry->xu_shadow_valid) {
+      data = entry->xu_shadow;
+      len = entry->xu_len;
+    } else if (entry->valid & (1 << CUR_SLOT)) {
+      data = entry->data[CUR_SLOT];
+      len = entry->len[CUR_SLOT];
+    }
+    if (!data || !len)
+      continue;
+
+    p = realloc(ctrls, (num + 1) * sizeof(*ctrls));
+    if (!p)
+      break;
+    ctrls = p;
+    ctrls[num].unit = entry->unit;
+    ctrls[num].selector = entry->selector;
+    ctrls[num].len = len;
+    ctrls[num].check_info = !entry->xu_shadow_valid;
+    ctrls[num].rank = restore_rank(devh, entry->unit, entry->selector);
+    ctrls[num].data = ctrl_cache_copy(data, len);
+    if (ctrls[num].data)
+      num++;
+  }
+  pthread_mutex_unlock(&devh->ctrl_cache_mutex);
+
+  for (rank = 0; rank < UVC_CTRL_RANKS; ++rank) {
+    for (i = 0; i < num; ++i) {
+      uint8_t info;
+
+      if (ctrls[i].rank != rank)
+        continue;
+      if (ctrls[i].check_info &&
+          uvc_get_ctrl(devh, ctrls[i].unit, ctrls[i].selector, &info, 1, UVC_GET_INFO) == 1 &&
+          (!(info & UVC_CONTROL_CAP_SET) || (info & UVC_CONTROL_CAP_DISABLED)))
+        continue;
+      if (uvc_set_ctrl_now(devh, ctrls[i].unit, ctrls[i].selector, ctrls[i].data,
+                           ctrls[i].len) == ctrls[i].len)
+        restored++;
+    }
+  }
+
+  for (i = 0; i < num; ++i)
+    free(ctrls[i].data);
+  free(ctrls);
+
+  return restored;
+}
+
+/* Reads GET_INFO and, for readable controls, the range of one control.
+ * Controls the device stalls on are skipped. */
+static uvc_error_t prefetch_ctrl(uvc_device_handle_t *devh, uint8_t unit, uint8_t selector,
+                                 int length) {
+  static const enum uvc_req_code range_reqs[] = {
+    UVC_GET_MIN, UVC_GET_MAX, UVC_GET_RES, UVC_GET_DEF
+  };
+  uint8_t stack_buf[64];
+  uint8_t *buf = stack_buf;
+  uint8_t info;
+  int i, ret;
+
+  ret = uvc_get_ctrl(devh, unit, selector, &info, 1, UVC_GET_INFO);
+  if (ret == UVC_ERROR_PIPE)
+    return UVC_SUCCESS;
+  if (ret < 0)
+    return ret;
+  if (ret != 1 || !(info & UVC_CONTROL_CAP_GET))
+    return UVC_SUCCESS;
+
+  if (length > (int) sizeof(stack_buf)) {
+    buf = malloc(length);
+    if (!buf)
+      return UVC_ERROR_NO_MEM;
+  }
+
+  for (i = 0; i < (int) (sizeof(range_reqs) / sizeof(range_reqs[0])); ++i) {
+    ret = uvc_get_ctrl(devh, unit, selector, buf, length, range_reqs[i]);
+    if (ret < 0 && ret != UVC_ERROR_PIPE)
+      break;
+    ret = UVC_SUCCESS;
+  }
+
+  if (buf != stack_buf)
+    free(buf);
+
+  return ret;
+}
+
+/** @brief Read the capabilities and ranges of every control into the cache
+ * @ingroup ctrl
+ *
+ * Covers the standard controls of the camera terminal, processing unit and
+ * selector unit, and every control an extension unit advertises in its
+ * bmControls. Afterwards uvc_get_ctrl() and the generated uvc_get_*
+ * accessors answer GET_MIN/MAX/RES/LEN/DEF without USB traffic.
+ * Calling this right after uvc_open() moves the cost of those requests to
+ * open time; without it the cache fills as controls are first queried.
+ *
+ * @param devh UVC device handle
+ * @return UVC_SUCCESS, or the error of a request that failed other than
+ *   with a stall
+ */
+uvc_error_t uvc_prefetch_ctrl_ranges(uvc_device_handle_t *devh) {
+  const uvc_extension_unit_t *xu;
+  uvc_error_t ret;
+  size_t i;
+  int bit;
+
+  UVC_ENTER();
+
+  if (!devh->ctrl_cache_enabled) {
+    UVC_EXIT(UVC_ERROR_INVALID_MODE);
+    return UVC_ERROR_INVALID_MODE;
+  }
+
+  for (i = 0; i < uvc_ctrl_def_count; ++i) {
+    const uvc_ctrl_def_t *def = &uvc_ctrl_defs[i];
+    uint8_t unit = uvc_ctrl_def_unit_id(devh, def);
+
+    if (!unit)
+      continue;
+
+    ret = prefetch_ctrl(devh, unit, def->selector, def->length);
+    if (ret != UVC_SUCCESS) {
+      UVC_EXIT(ret);
+      return ret;
+    }
+  }
+
+  DL_FOREACH(uvc_get_extension_units(devh), xu) {
+    for (bit = 0; bit < 64; ++bit) {
+      int length;
+
+      if (!(xu->bmControls & ((uint64_t) 1 << bit)))
+        continue;
+
+      length = uvc_get_ctrl_len(devh, xu->bUnitID, bit + 1);
+      if (length == UVC_ERROR_PIPE || length == 0)
+        continue;
+      if (length < 0) {
+        UVC_EXIT(length);
+        return length;
+      }
+
+      ret = prefetch_ctrl(devh, xu->bUnitID, bit + 1, length);
+      if (ret != UVC_SUCCESS) {
+        UVC_EXIT(ret);
+        return ret;
+      }
+    }
+  }
+
+  UVC_EXIT(UVC_SUCCESS);
+  return UVC_SUCCESS;
+}
@@ -0,0 +1,357 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (C) 2010-2012 Ken Tossell
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the author nor other contributors may be
+*     used to endorse or promote products derived from this software
+*     without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+/**
+ * @internal
+ * @file ctrl-engine.c
+ * @brief Table-driven access to the standard controls.
+ *
+ * ctrl-gen.py describes every standard control in uvc_ctrl_defs: its unit,
+ * selector, length and the position, size and signedness of each field.
+ * The generated uvc_get_* and uvc_set_* accessors are thin wrappers that
+ * hand the table entry to the functions here, which do the transfer and
+ * convert between the wire format and the accessor's arguments.
+ */
+#include "libuvc/libuvc.h"
+#include "libuvc/libuvc_internal.h"
+
+/** @internal
+ * @brief Read one field of a control value
+ */
+int64_t uvc_ctrl_field_decode(const uvc_ctrl_field_def_t *field, const uint8_t *data) {
+  uint32_t raw = 0;
+  int i;
+
+  for (i = field->length - 1; i >= 0; --i)
+    raw = (raw << 8) | data[field->position + i];
+
+  if (!field->is_signed)
+    return raw;
+
+  switch (field->length) {
+  case 1:
+    return (int8_t) raw;
+  case 2:
+    return (int16_t) raw;
+  default:
+    return (int32_t) raw;
+  }
+}
+
+/** @internal
+ * @brief Write one field of a control value
+ */
+void uvc_ctrl_field_encode(const uvc_ctrl_field_def_t *field, int64_t value, uint8_t *data) {
+  int i;
+
+  for (i = 0; i < field->length; ++i)
+    data[field->position + i] = (uint8_t) (value >> (8 * i));
+}
+
+/** @internal
+ * @brief Store each field of a control value through a pointer to the
+ * accessor's integer type for it (uint8_t, int16_t, uint32_t, ...)
+ */
+void uvc_ctrl_def_unpack(const uvc_ctrl_def_t *def, const uint8_t *data, void *const *out) {
+  int i;
+
+  for (i = 0; i < def->num_fields; ++i) {
+    const uvc_ctrl_field_def_t *field = &def->fields[i];
+    int64_t value = uvc_ctrl_field_decode(field, data);
+
+    switch (field->length) {
+    case 1:
+      *(uint8_t *) out[i] = (uint8_t) value;
+      break;
+    case 2:
+      *(uint16_t *) out[i] = (uint16_t) value;
+      break;
+    default:
+      *(uint32_t *) out[i] = (uint32_t) value;
+      break;
+    }
+  }
+}
+
+/** @internal
+ * @brief Build a control value from its fields
+ */
+void uvc_ctrl_def_pack(const uvc_ctrl_def_t *def, const int64_t *values, uint8_t *data) {
+  int i;
+
+  memset(data, 0, def->length);
+  for (i = 0; i < def->num_fields; ++i)
+    uvc_ctrl_field_encode(&def->fields[i], values[i], data);
+}
+
+/** @internal
+ * @brief GET request of a generated accessor
+ */
+uvc_error_t uvc_get_ctrl_fields(uvc_device_handle_t *devh, const uvc_ctrl_def_t *def,
+                                void *const *out, enum uvc_req_code req_code) {
+  uint8_t data[UVC_CTRL_DEF_MAX_LEN];
+  uint8_t unit = uvc_ctrl_def_unit_id(devh, def);
+  int ret;
+
+  if (!unit)
+    return UVC_ERROR_NOT_SUPPORTED;
+
+  ret = uvc_get_ctrl(devh, unit, def->selector, data, def->length, req_code);
+
+  if (ret == def->length) {
+    uvc_ctrl_def_unpack(def, data, out);
+    return UVC_SUCCESS;
+  } else {
+    return ret;
+  }
+}
+
+/** @internal
+ * @brief SET_CUR request of a generated accessor
+ */
+uvc_error_t uvc_set_ctrl_fields(uvc_device_handle_t *devh, const uvc_ctrl_def_t *def,
+                                const int64_t *values) {
+  uint8_t data[UVC_CTRL_DEF_MAX_LEN];
+  uint8_t unit = uvc_ctrl_def_unit_id(devh, def);
+  int ret;
+
+  if (!unit)
+    return UVC_ERROR_NOT_SUPPORTED;
+
+  uvc_ctrl_def_pack(def, values, data);
+
+  ret = uvc_set_ctrl(devh, unit, def->selector, data, def->length);
+
+  if (ret == def->length)
+    return UVC_SUCCESS;
+  else
+    return ret;
+}
+
+/* Requests of one uvc_read_all_controls() call still in flight */
+struct snapshot_pass {
+  pthread_mutex_t mutex;
+  pthread_cond_t cond;
+  int outstanding;
+};
+
+struct snapshot_request {
+  struct snapshot_pass *pass;
+  uvc_ctrl_snapshot_t *snap;
+  const uvc_ctrl_def_t *def;
+  enum uvc_req_code req_code;
+};
+
+static void snapshot_callback(int result, void *data, void *user_ptr) {
+  struct snapshot_request *sr = user_ptr;
+  uvc_ctrl_snapshot_t *snap = sr->snap;
+  int64_t *values = NULL;
+  uint8_t valid = 0;
+  int i;
+
+  if (sr->req_code == UVC_GET_INFO) {
+    if (result == 1) {
+      snap->info = *(uint8_t *) data;
+      valid = 1 << (UVC_GET_INFO - UVC_GET_CUR);
+    }
+  } else if (result == sr->def->length) {
+    switch (sr->req_code) {
+    case UVC_GET_CUR: values = snap->cur; break;
+    case UVC_GET_MIN: values = snap->min; break;
+    case UVC_GET_MAX: values = snap->max; break;
+    case UVC_GET_RES: values = snap->res; break;
+    case UVC_GET_DEF: values = snap->def; break;
+    default: break;
+    }
+
+    if (values) {
+      for (i = 0; i < sr->def->num_fields; ++i)
+        values[i] = uvc_ctrl_field_decode(&sr->def->fields[i], data);
+      valid = 1 << (sr->req_code - UVC_GET_CUR);
+    }
+  }
+
+  /* the requests of one control may complete on different threads */
+  pthread_mutex_lock(&sr->pass->mutex);
+  snap->valid |= valid;
+  sr->pass->outstanding--;
+  pthread_cond_broadcast(&sr->pass->cond);
+  pthread_mutex_unlock(&sr->pass->mutex);
+
+  free(sr);
+}
+
+static uvc_error_t snapshot_submit(uvc_device_handle_t *devh, struct snapshot_pass *pass,
+                                   uvc_ctrl_snapshot_t *snap, const uvc_ctrl_def_t *def,
+                                   enum uvc_req_code req_code) {
+  struct snapshot_request *sr = malloc(sizeof(*sr));
+  uvc_error_t ret;
+
+  if (!sr)
+    return UVC_ERROR_NO_MEM;
+
+  sr->pass = pass;
+  sr->snap = snap;
+  sr->def = def;
+  sr->req_code = req_code;
+
+  /* counted first: the callback may run before the request is submitted */
+  pthread_mutex_lock(&pass->mutex);
+  pass->outstanding++;
+  pthread_mutex_unlock(&pass->mutex);
+
+  ret = uvc_get_ctrl_async(devh, snap->unit, snap->selector,
+                           req_code == UVC_GET_INFO ? 1 : def->length, req_code,
+                           snapshot_callback, sr);
+  if (ret != UVC_SUCCESS) {
+    pthread_mutex_lock(&pass->mutex);
+    pass->outstanding--;
+    pthread_mutex_unlock(&pass->mutex);
+    free(sr);
+  }
+
+  return ret;
+}
+
+static void snapshot_wait(struct snapshot_pass *pass) {
+  pthread_mutex_lock(&pass->mutex);
+  while (pass->outstanding)
+    pthread_cond_wait(&pass->cond, &pass->mutex);
+  pthread_mutex_unlock(&pass->mutex);
+}
+
+/** @brief Read and decode the state of every standard control
+ * @ingroup ctrl
+ *
+ * Covers each control of the camera terminal, processing unit and selector
+ * unit that answers GET_INFO. Its current value, range and default are read
+ * if the control is readable; @c valid tells which of them the device
+ * answered. All requests of a pass go out together (see
+ * uvc_get_ctrl_async()), and ranges already in the control cache are not
+ * read again, so the cost is close to two round trips rather than one per
+ * request.
+ *
+ * As with uvc_wait_ctrl_async(), libusb events must be handled meanwhile.
+ *
+ * @param devh UVC device handle
+ * @param[out] snapshots Array of the supported controls, in uvc_ctrl_defs
+ *   order; free it with uvc_free_ctrl_snapshots()
+ * @param[out] count Number of entries in @p snapshots
+ * @return UVC_SUCCESS or an error
+ */
+uvc_error_t uvc_read_all_controls(uvc_device_handle_t *devh, uvc_ctrl_snapshot_t **snapshots,
+                                  size_t *count) {
+  static const enum uvc_req_code value_reqs[] = {
+    UVC_GET_CUR, UVC_GET_MIN, UVC_GET_MAX, UVC_GET_RES, UVC_GET_DEF
+  };
+  struct snapshot_pass pass;
+  uvc_ctrl_snapshot_t *snaps;
+  const uvc_ctrl_def_t **defs;
+  uvc_error_t ret = UVC_SUCCESS;
+  size_t i, n = 0, kept = 0;
+  int r, f;
+
+  UVC_ENTER();
+
+  snaps = calloc(uvc_ctrl_def_count, sizeof(*snaps));
+  defs = calloc(uvc_ctrl_def_count, sizeof(*defs));
+  if (!snaps || !defs) {
+    free(snaps);
+    free(defs);
+    UVC_EXIT(UVC_ERROR_NO_MEM);
+    return UVC_ERROR_NO_MEM;
+  }
+
+  pthread_mutex_init(&pass.mutex, NULL);
+  pthread_cond_init(&pass.cond, NULL);
+  pass.outstanding = 0;
+
+  /* pass 1: which controls exist and what they support */
+  for (i = 0; i < uvc_ctrl_def_count && ret == UVC_SUCCESS; ++i) {
+    const uvc_ctrl_def_t *def = &uvc_ctrl_defs[i];
+    uint8_t unit = uvc_ctrl_def_unit_id(devh, def);
+
+    if (!unit)
+      continue;
+
+    snaps[n].name = def->name;
+    snaps[n].unit = unit;
+    snaps[n].selector = def->selector;
+    snaps[n].num_fields = def->num_fields;
+    for (f = 0; f < def->num_fields; ++f)
+      snaps[n].field_names[f] = def->fields[f].name;
+    defs[n] = def;
+
+    ret = snapshot_submit(devh, &pass, &snaps[n], def, UVC_GET_INFO);
+    n++;
+  }
+  snapshot_wait(&pass);
+
+  /* pass 2: values of the readable ones */
+  for (i = 0; i < n && ret == UVC_SUCCESS; ++i) {
+    if (!(snaps[i].info & UVC_CONTROL_CAP_GET))
+      continue;
+
+    for (r = 0; r < (int) (sizeof(value_reqs) / sizeof(value_reqs[0])) && ret == UVC_SUCCESS; ++r)
+      ret = snapshot_submit(devh, &pass, &snaps[i], defs[i], value_reqs[r]);
+  }
+  snapshot_wait(&pass);
+
+  pthread_cond_destroy(&pass.cond);
+  pthread_mutex_destroy(&pass.mutex);
+  free(defs);
+
+  if (ret != UVC_SUCCESS) {
+    free(snaps);
+    UVC_EXIT(ret);
+    return ret;
+  }
+
+  for (i = 0; i < n; ++i) {
+    if (snaps[i].valid & (1 << (UVC_GET_INFO - UVC_GET_CUR)))
+      snaps[kept++] = snaps[i];
+  }
+
+  *snapshots = snaps;
+  *count = kept;
+
+  UVC_EXIT(UVC_SUCCESS);
+  return UVC_SUCCESS;
+}
+
+/** @brief Free the array returned by uvc_read_all_controls()
+ * @ingroup ctrl
+ */
+void uvc_free_ctrl_snapshots(uvc_ctrl_snapshot_t *snapshots) {
+  free(snapshots);
+}
@@ -2,9 +2,6 @@
 #include "libuvc/libuvc.h"
 #include "libuvc/libuvc_internal.h"
 
-static const int REQ_TYPE_SET = 0x21;
-static const int REQ_TYPE_GET = 0xa1;
-
 /** @ingroup ctrl
  * @brief Reads the SCANNING_MODE control.
  * @param devh UVC device handle
@@ -12,24 +9,9 @@ static const int REQ_TYPE_GET = 0xa1;
  * @param req_code UVC_GET_* request to execute
  */
 uvc_error_t uvc_get_scanning_mode(uvc_device_handle_t *devh, uint8_t* mode, enum uvc_req_code req_code) {
-  uint8_t data[1];
-  uvc_error_t ret;
-
-  ret = libusb_control_transfer(
-    devh->usb_devh,
-    REQ_TYPE_GET, req_code,
-    UVC_CT_SCANNING_MODE_CONTROL << 8,
-    uvc_get_camera_terminal(devh)->bTerminalID << 8 | devh->info->ctrl_if.bInterfaceNumber,
-    data,
-    sizeof(data),
-    0);
+  void *out[] = { mode };
 
-  if (ret == sizeof(data)) {
-    *mode = data[0];
-    return UVC_SUCCESS;
-  } else {
-    return ret;
-  }
+  return uvc_get_ctrl_fields(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_SCANNING_MODE], out, req_code);
 }
 
 
@@ -39,24 +21,46 @@ uvc_error_t uvc_get_scanning_mode(uvc_device_handle_t *devh, uint8_t* mode, enum
  * @param mode 0: interlaced, 1: progressive
  */
 uvc_error_t uvc_set_scanning_mode(uvc_device_handle_t *devh, uint8_t mode) {
-  uint8_t data[1];
-  uvc_error_t ret;
+  const int64_t values[] = { mode };
+
+  return uvc_set_ctrl_fields(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_SCANNING_MODE], values);
+}
+
+
+/** @ingroup ctrl
+ * @brief Reads the SCANNING_MODE control without waiting for the answer.
+ *
+ * The fields are filled in just before @p cb is called with UVC_SUCCESS;
+ * they must stay valid until then. See uvc_get_ctrl_async().
+ * @param devh UVC device handle
+ * @param[out] mode 0: interlaced, 1: progressive
+ * @param req_code UVC_GET_* request to execute
+ * @param cb Completion callback, or NULL
+ * @param user_ptr Passed to @p cb
+ */
+uvc_error_t uvc_get_scanning_mode_async(uvc_device_handle_t *devh, uint8_t* mode, enum uvc_req_code req_code, uvc_ctrl_callback_t *cb, void *user_ptr) {
+  void *out[] = { mode };
+
+  return uvc_get_ctrl_fields_async(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_SCANNING_MODE], out, req_code,
+                                   cb, user_ptr);
+}
 
-  data[0] = mode;
 
-  ret = libusb_control_transfer(
-    devh->usb_devh,
-    REQ_TYPE_SET, UVC_SET_CUR,
-    UVC_CT_SCANNING_MODE_CONTROL << 8,
-    uvc_get_camera_terminal(devh)->bTerminalID << 8 | devh->info->ctrl_if.bInterfaceNumber,
-    data,
-    sizeof(data),
-    0);
+/** @ingroup ctrl
+ * @brief Sets the SCANNING_MODE control without waiting for it to complete.
+ *
+ * @p cb is called with UVC_SUCCESS once the value has been sent. See
+ * uvc_set_ctrl_async().
+ * @param devh UVC device handle
+ * @param mode 0: interlaced, 1: progressive
+ * @param cb Completion callback, or NULL
+ * @param user_ptr Passed to @p cb
+ */
+uvc_error_t uvc_set_scanning_mode_async(uvc_device_handle_t *devh, uint8_t mode, uvc_ctrl_callback_t *cb, void *user_ptr) {
+  const int64_t values[] = { mode };
 
-  if (ret == sizeof(data))
-    return UVC_SUCCESS;
-  else
-    return ret;
+  return uvc_set_ctrl_fields_async(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_SCANNING_MODE], values,
+                                   cb, user_ptr);
 }
 
 /** @ingroup ctrl
@@ -68,24 +72,9 @@ uvc_error_t uvc_set_scanning_mode(uvc_device_handle_t *devh, uint8_t mode) {
  * @param req_code UVC_GET_* request to execute
  */
 uvc_error_t uvc_get_ae_mode(uvc_device_handle_t *devh, uint8_t* mode, enum uvc_req_code req_code) {
-  uint8_t data[1];
-  uvc_error_t ret;
-
-  ret = libusb_control_transfer(
-    devh->usb_devh,
-    REQ_TYPE_GET, req_code,
-    UVC_CT_AE_MODE_CONTROL << 8,
-    uvc_get_camera_terminal(devh)->bTerminalID << 8 | devh->info->ctrl_if.bInterfaceNumber,
-    data,
-    sizeof(data),
-    0);
+  void *out[] = { mode };
 
-  if (ret == sizeof(data)) {
-    *mode = data[0];
-    return UVC_SUCCESS;
-  } else {
-    return ret;
-  }
+  return uvc_get_ctrl_fields(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_AE_MODE], out, req_code);
 }
 
 
@@ -103,24 +92,46 @@ uvc_error_t uvc_get_ae_mode(uvc_device_handle_t *devh, uint8_t* mode, enum uvc_r
  * @param mode 1: manual mode; 2: auto mode; 4: shutter priority mode; 8: aperture priority mode
  */
 uvc_error_t uvc_set_ae_mode(uvc_device_handle_t *devh, uint8_t mode) {
-  uint8_t data[1];
-  uvc_error_t ret;
+  const int64_t values[] = { mode };
+
+  return uvc_set_ctrl_fields(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_AE_MODE], values);
+}
+
+
+/** @ingroup ctrl
+ * @brief Reads the AE_MODE control without waiting for the answer.
+ *
+ * The fields are filled in just before @p cb is called with UVC_SUCCESS;
+ * they must stay valid until then. See uvc_get_ctrl_async().
+ * @param devh UVC device handle
+ * @param[out] mode 1: manual mode; 2: auto mode; 4: shutter priority mode; 8: aperture priority mode
+ * @param req_code UVC_GET_* request to execute
+ * @param cb Completion callback, or NULL
+ * @param user_ptr Passed to @p cb
+ */
+uvc_error_t uvc_get_ae_mode_async(uvc_device_handle_t *devh, uint8_t* mode, enum uvc_req_code req_code, uvc_ctrl_callback_t *cb, void *user_ptr) {
+  void *out[] = { mode };
+
+  return uvc_get_ctrl_fields_async(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_AE_MODE], out, req_code,
+                                   cb, user_ptr);
+}
 
-  data[0] = mode;
 
-  ret = libusb_control_transfer(
-    devh->usb_devh,
-    REQ_TYPE_SET, UVC_SET_CUR,
-    UVC_CT_AE_MODE_CONTROL << 8,
-    uvc_get_camera_terminal(devh)->bTerminalID << 8 | devh->info->ctrl_if.bInterfaceNumber,
-    data,
-    sizeof(data),
-    0);
+/** @ingroup ctrl
+ * @brief Sets the AE_MODE control without waiting for it to complete.
+ *
+ * @p cb is called with UVC_SUCCESS once the value has been sent. See
+ * uvc_set_ctrl_async().
+ * @param devh UVC device handle
+ * @param mode 1: manual mode; 2: auto mode; 4: shutter priority mode; 8: aperture priority mode
+ * @param cb Completion callback, or NULL
+ * @param user_ptr Passed to @p cb
+ */
+uvc_error_t uvc_set_ae_mode_async(uvc_device_handle_t *devh, uint8_t mode, uvc_ctrl_callback_t *cb, void *user_ptr) {
+  const int64_t values[] = { mode };
 
-  if (ret == sizeof(data))
-    return UVC_SUCCESS;
-  else
-    return ret;
+  return uvc_set_ctrl_fields_async(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_AE_MODE], values,
+                                   cb, user_ptr);
 }
 
 /** @ingroup ctrl
@@ -131,24 +142,9 @@ uvc_error_t uvc_set_ae_mode(uvc_device_handle_t *devh, uint8_t mode) {
  * @param req_code UVC_GET_* request to execute
  */
 uvc_error_t uvc_get_ae_priority(uvc_device_handle_t *devh, uint8_t* priority, enum uvc_req_code req_code) {
-  uint8_t data[1];
-  uvc_error_t ret;
-
-  ret = libusb_control_transfer(
-    devh->usb_devh,
-    REQ_TYPE_GET, req_code,
-    UVC_CT_AE_PRIORITY_CONTROL << 8,
-    uvc_get_camera_terminal(devh)->bTerminalID << 8 | devh->info->ctrl_if.bInterfaceNumber,
-    data,
-    sizeof(data),
-    0);
+  void *out[] = { priority };
 
-  if (ret == sizeof(data)) {
-    *priority = data[0];
-    return UVC_SUCCESS;
-  } else {
-    return ret;
-  }
+  return uvc_get_ctrl_fields(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_AE_PRIORITY], out, req_code);
 }
 
 
@@ -161,24 +157,46 @@ uvc_error_t uvc_get_ae_priority(uvc_device_handle_t *devh, uint8_t* priority, en
  * @param priority 0: frame rate must remain constant; 1: frame rate may be varied for AE purposes
  */
 uvc_error_t uvc_set_ae_priority(uvc_device_handle_t *devh, uint8_t priority) {
-  uint8_t data[1];
-  uvc_error_t ret;
+  const int64_t values[] = { priority };
+
+  return uvc_set_ctrl_fields(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_AE_PRIORITY], values);
+}
+
+
+/** @ingroup ctrl
+ * @brief Reads the AE_PRIORITY control without waiting for the answer.
+ *
+ * The fields are filled in just before @p cb is called with UVC_SUCCESS;
+ * they must stay valid until then. See uvc_get_ctrl_async().
+ * @param devh UVC device handle
+ * @param[out] priority 0: frame rate must remain constant; 1: frame rate may be varied for AE purposes
+ * @param req_code UVC_GET_* request to execute
+ * @param cb Completion callback, or NULL
+ * @param user_ptr Passed to @p cb
+ */
+uvc_error_t uvc_get_ae_priority_async(uvc_device_handle_t *devh, uint8_t* priority, enum uvc_req_code req_code, uvc_ctrl_callback_t *cb, void *user_ptr) {
+  void *out[] = { priority };
+
+  return uvc_get_ctrl_fields_async(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_AE_PRIORITY], out, req_code,
+                                   cb, user_ptr);
+}
 
-  data[0] = priority;
 
-  ret = libusb_control_transfer(
-    devh->usb_devh,
-    REQ_TYPE_SET, UVC_SET_CUR,
-    UVC_CT_AE_PRIORITY_CONTROL << 8,
-    uvc_get_camera_terminal(devh)->bTerminalID << 8 | devh->info->ctrl_if.bInterfaceNumber,
-    data,
-    sizeof(data),
-    0);
+/** @ingroup ctrl
+ * @brief Sets the AE_PRIORITY control without waiting for it to complete.
+ *
+ * @p cb is called with UVC_SUCCESS once the value has been sent. See
+ * uvc_set_ctrl_async().
+ * @param devh UVC device handle
+ * @param priority 0: frame rate must remain constant; 1: frame rate may be varied for AE purposes
+ * @param cb Completion callback, or NULL
+ * @param user_ptr Passed to @p cb
+ */
+uvc_error_t uvc_set_ae_priority_async(uvc_device_handle_t *devh, uint8_t priority, uvc_ctrl_callback_t *cb, void *user_ptr) {
+  const int64_t values[] = { priority };
 
-  if (ret == sizeof(data))
-    return UVC_SUCCESS;
-  else
-    return ret;
+  return uvc_set_ctrl_fields_async(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_AE_PRIORITY], values,
+                                   cb, user_ptr);
 }
 
 /** @ingroup ctrl
@@ -190,24 +208,9 @@ uvc_error_t uvc_set_ae_priority(uvc_device_handle_t *devh, uint8_t priority) {
  * @param req_code UVC_GET_* request to execute
  */
 uvc_error_t uvc_get_exposure_abs(uvc_device_handle_t *devh, uint32_t* time, enum uvc_req_code req_code) {
-  uint8_t data[4];
-  uvc_error_t ret;
-
-  ret = libusb_control_transfer(
-    devh->usb_devh,
-    REQ_TYPE_GET, req_code,
-    UVC_CT_EXPOSURE_TIME_ABSOLUTE_CONTROL << 8,
-    uvc_get_camera_terminal(devh)->bTerminalID << 8 | devh->info->ctrl_if.bInterfaceNumber,
-    data,
-    sizeof(data),
-    0);
+  void *out[] = { time };
 
-  if (ret == sizeof(data)) {
-    *time = DW_TO_INT(data + 0);
-    return UVC_SUCCESS;
-  } else {
-    return ret;
-  }
+  return uvc_get_ctrl_fields(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_EXPOSURE_ABS], out, req_code);
 }
 
 
@@ -221,24 +224,46 @@ uvc_error_t uvc_get_exposure_abs(uvc_device_handle_t *devh, uint32_t* time, enum
  * @param time 
  */
 uvc_error_t uvc_set_exposure_abs(uvc_device_handle_t *devh, uint32_t time) {
-  uint8_t data[4];
-  uvc_error_t ret;
+  const int64_t values[] = { time };
+
+  return uvc_set_ctrl_fields(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_EXPOSURE_ABS], values);
+}
+
+
+/** @ingroup ctrl
+ * @brief Reads the EXPOSURE_TIME_ABSOLUTE control without waiting for the answer.
+ *
+ * The fields are filled in just before @p cb is called with UVC_SUCCESS;
+ * they must stay valid until then. See uvc_get_ctrl_async().
+ * @param devh UVC device handle
+ * @param[out] time 
+ * @param req_code UVC_GET_* request to execute
+ * @param cb Completion callback, or NULL
+ * @param user_ptr Passed to @p cb
+ */
+uvc_error_t uvc_get_exposure_abs_async(uvc_device_handle_t *devh, uint32_t* time, enum uvc_req_code req_code, uvc_ctrl_callback_t *cb, void *user_ptr) {
+  void *out[] = { time };
+
+  return uvc_get_ctrl_fields_async(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_EXPOSURE_ABS], out, req_code,
+                                   cb, user_ptr);
+}
 
-  INT_TO_DW(time, data + 0);
 
-  ret = libusb_control_transfer(
-    devh->usb_devh,
-    REQ_TYPE_SET, UVC_SET_CUR,
-    UVC_CT_EXPOSURE_TIME_ABSOLUTE_CONTROL << 8,
-    uvc_get_camera_terminal(devh)->bTerminalID << 8 | devh->info->ctrl_if.bInterfaceNumber,
-    data,
-    sizeof(data),
-    0);
+/** @ingroup ctrl
+ * @brief Sets the EXPOSURE_TIME_ABSOLUTE control without waiting for it to complete.
+ *
+ * @p cb is called with UVC_SUCCESS once the value has been sent. See
+ * uvc_set_ctrl_async().
+ * @param devh UVC device handle
+ * @param time 
+ * @param cb Completion callback, or NULL
+ * @param user_ptr Passed to @p cb
+ */
+uvc_error_t uvc_set_exposure_abs_async(uvc_device_handle_t *devh, uint32_t time, uvc_ctrl_callback_t *cb, void *user_ptr) {
+  const int64_t values[] = { time };
 
-  if (ret == sizeof(data))
-    return UVC_SUCCESS;
-  else
-    return ret;
+  return uvc_set_ctrl_fields_async(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_EXPOSURE_ABS], values,
+                                   cb, user_ptr);
 }
 
 /** @ingroup ctrl
@@ -248,24 +273,9 @@ uvc_error_t uvc_set_exposure_abs(uvc_device_handle_t *devh, uint32_t time) {
  * @param req_code UVC_GET_* request to execute
  */
 uvc_error_t uvc_get_exposure_rel(uvc_device_handle_t *devh, int8_t* step, enum uvc_req_code req_code) {
-  uint8_t data[1];
-  uvc_error_t ret;
-
-  ret = libusb_control_transfer(
-    devh->usb_devh,
-    REQ_TYPE_GET, req_code,
-    UVC_CT_EXPOSURE_TIME_RELATIVE_CONTROL << 8,
-    uvc_get_camera_terminal(devh)->bTerminalID << 8 | devh->info->ctrl_if.bInterfaceNumber,
-    data,
-    sizeof(data),
-    0);
+  void *out[] = { step };
 
-  if (ret == sizeof(data)) {
-    *step = data[0];
-    return UVC_SUCCESS;
-  } else {
-    return ret;
-  }
+  return uvc_get_ctrl_fields(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_EXPOSURE_REL], out, req_code);
 }
 
 
@@ -275,24 +285,46 @@ uvc_error_t uvc_get_exposure_rel(uvc_device_handle_t *devh, int8_t* step, enum u
  * @param step number of steps by which to change the exposure time, or zero to set the default exposure time
  */
 uvc_error_t uvc_set_exposure_rel(uvc_device_handle_t *devh, int8_t step) {
-  uint8_t data[1];
-  uvc_error_t ret;
+  const int64_t values[] = { step };
+
+  return uvc_set_ctrl_fields(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_EXPOSURE_REL], values);
+}
+
+
+/** @ingroup ctrl
+ * @brief Reads the EXPOSURE_TIME_RELATIVE control without waiting for the answer.
+ *
+ * The fields are filled in just before @p cb is called with UVC_SUCCESS;
+ * they must stay valid until then. See uvc_get_ctrl_async().
+ * @param devh UVC device handle
+ * @param[out] step number of steps by which to change the exposure time, or zero to set the default exposure time
+ * @param req_code UVC_GET_* request to execute
+ * @param cb Completion callback, or NULL
+ * @param user_ptr Passed to @p cb
+ */
+uvc_error_t uvc_get_exposure_rel_async(uvc_device_handle_t *devh, int8_t* step, enum uvc_req_code req_code, uvc_ctrl_callback_t *cb, void *user_ptr) {
+  void *out[] = { step };
+
+  return uvc_get_ctrl_fields_async(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_EXPOSURE_REL], out, req_code,
+                                   cb, user_ptr);
+}
 
-  data[0] = step;
 
-  ret = libusb_control_transfer(
-    devh->usb_devh,
-    REQ_TYPE_SET, UVC_SET_CUR,
-    UVC_CT_EXPOSURE_TIME_RELATIVE_CONTROL << 8,
-    uvc_get_camera_terminal(devh)->bTerminalID << 8 | devh->info->ctrl_if.bInterfaceNumber,
-    data,
-    sizeof(data),
-    0);
+/** @ingroup ctrl
+ * @brief Sets the EXPOSURE_TIME_RELATIVE control without waiting for it to complete.
+ *
+ * @p cb is called with UVC_SUCCESS once the value has been sent. See
+ * uvc_set_ctrl_async().
+ * @param devh UVC device handle
+ * @param step number of steps by which to change the exposure time, or zero to set the default exposure time
+ * @param cb Completion callback, or NULL
+ * @param user_ptr Passed to @p cb
+ */
+uvc_error_t uvc_set_exposure_rel_async(uvc_device_handle_t *devh, int8_t step, uvc_ctrl_callback_t *cb, void *user_ptr) {
+  const int64_t values[] = { step };
 
-  if (ret == sizeof(data))
-    return UVC_SUCCESS;
-  else
-    return ret;
+  return uvc_set_ctrl_fields_async(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_EXPOSURE_REL], values,
+                                   cb, user_ptr);
 }
 
 /** @ingroup ctrl
@@ -302,24 +334,9 @@ uvc_error_t uvc_set_exposure_rel(uvc_device_handle_t *devh, int8_t step) {
  * @param req_code UVC_GET_* request to execute
  */
 uvc_error_t uvc_get_focus_abs(uvc_device_handle_t *devh, uint16_t* focus, enum uvc_req_code req_code) {
-  uint8_t data[2];
-  uvc_error_t ret;
-
-  ret = libusb_control_transfer(
-    devh->usb_devh,
-    REQ_TYPE_GET, req_code,
-    UVC_CT_FOCUS_ABSOLUTE_CONTROL << 8,
-    uvc_get_camera_terminal(devh)->bTerminalID << 8 | devh->info->ctrl_if.bInterfaceNumber,
-    data,
-    sizeof(data),
-    0);
+  void *out[] = { focus };
 
-  if (ret == sizeof(data)) {
-    *focus = SW_TO_SHORT(data + 0);
-    return UVC_SUCCESS;
-  } else {
-    return ret;
-  }
+  return uvc_get_ctrl_fields(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_FOCUS_ABS], out, req_code);
 }
 
 
@@ -329,24 +346,46 @@ uvc_error_t uvc_get_focus_abs(uvc_device_handle_t *devh, uint16_t* focus, enum u
  * @param focus focal target distance in millimeters
  */
 uvc_error_t uvc_set_focus_abs(uvc_device_handle_t *devh, uint16_t focus) {
-  uint8_t data[2];
-  uvc_error_t ret;
+  const int64_t values[] = { focus };
+
+  return uvc_set_ctrl_fields(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_FOCUS_ABS], values);
+}
+
+
+/** @ingroup ctrl
+ * @brief Reads the FOCUS_ABSOLUTE control without waiting for the answer.
+ *
+ * The fields are filled in just before @p cb is called with UVC_SUCCESS;
+ * they must stay valid until then. See uvc_get_ctrl_async().
+ * @param devh UVC device handle
+ * @param[out] focus focal target distance in millimeters
+ * @param req_code UVC_GET_* request to execute
+ * @param cb Completion callback, or NULL
+ * @param user_ptr Passed to @p cb
+ */
+uvc_error_t uvc_get_focus_abs_async(uvc_device_handle_t *devh, uint16_t* focus, enum uvc_req_code req_code, uvc_ctrl_callback_t *cb, void *user_ptr) {
+  void *out[] = { focus };
+
+  return uvc_get_ctrl_fields_async(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_FOCUS_ABS], out, req_code,
+                                   cb, user_ptr);
+}
 
-  SHORT_TO_SW(focus, data + 0);
 
-  ret = libusb_control_transfer(
-    devh->usb_devh,
-    REQ_TYPE_SET, UVC_SET_CUR,
-    UVC_CT_FOCUS_ABSOLUTE_CONTROL << 8,
-    uvc_get_camera_terminal(devh)->bTerminalID << 8 | devh->info->ctrl_if.bInterfaceNumber,
-    data,
-    sizeof(data),
-    0);
+/** @ingroup ctrl
+ * @brief Sets the FOCUS_ABSOLUTE control without waiting for it to complete.
+ *
+ * @p cb is called with UVC_SUCCESS once the value has been sent. See
+ * uvc_set_ctrl_async().
+ * @param devh UVC device handle
+ * @param focus focal target distance in millimeters
+ * @param cb Completion callback, or NULL
+ * @param user_ptr Passed to @p cb
+ */
+uvc_error_t uvc_set_focus_abs_async(uvc_device_handle_t *devh, uint16_t focus, uvc_ctrl_callback_t *cb, void *user_ptr) {
+  const int64_t values[] = { focus };
 
-  if (ret == sizeof(data))
-    return UVC_SUCCESS;
-  else
-    return ret;
+  return uvc_set_ctrl_fields_async(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_FOCUS_ABS], values,
+                                   cb, user_ptr);
 }
 
 /** @ingroup ctrl
@@ -357,25 +396,9 @@ uvc_error_t uvc_set_focus_abs(uvc_device_handle_t *devh, uint16_t focus) {
  * @param req_code UVC_GET_* request to execute
  */
 uvc_error_t uvc_get_focus_rel(uvc_device_handle_t *devh, int8_t* focus_rel, uint8_t* speed, enum uvc_req_code req_code) {
-  uint8_t data[2];
-  uvc_error_t ret;
-
-  ret = libusb_control_transfer(
-    devh->usb_devh,
-    REQ_TYPE_GET, req_code,
-    UVC_CT_FOCUS_RELATIVE_CONTROL << 8,
-    uvc_get_camera_terminal(devh)->bTerminalID << 8 | devh->info->ctrl_if.bInterfaceNumber,
-    data,
-    sizeof(data),
-    0);
+  void *out[] = { focus_rel, speed };
 
-  if (ret == sizeof(data)) {
-    *focus_rel = data[0];
-    *speed = data[1];
-    return UVC_SUCCESS;
-  } else {
-    return ret;
-  }
+  return uvc_get_ctrl_fields(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_FOCUS_REL], out, req_code);
 }
 
 
@@ -386,25 +409,48 @@ uvc_error_t uvc_get_focus_rel(uvc_device_handle_t *devh, int8_t* focus_rel, uint
  * @param speed TODO
  */
 uvc_error_t uvc_set_focus_rel(uvc_device_handle_t *devh, int8_t focus_rel, uint8_t speed) {
-  uint8_t data[2];
-  uvc_error_t ret;
+  const int64_t values[] = { focus_rel, speed };
+
+  return uvc_set_ctrl_fields(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_FOCUS_REL], values);
+}
+
+
+/** @ingroup ctrl
+ * @brief Reads the FOCUS_RELATIVE control without waiting for the answer.
+ *
+ * The fields are filled in just before @p cb is called with UVC_SUCCESS;
+ * they must stay valid until then. See uvc_get_ctrl_async().
+ * @param devh UVC device handle
+ * @param[out] focus_rel TODO
+ * @param[out] speed TODO
+ * @param req_code UVC_GET_* request to execute
+ * @param cb Completion callback, or NULL
+ * @param user_ptr Passed to @p cb
+ */
+uvc_error_t uvc_get_focus_rel_async(uvc_device_handle_t *devh, int8_t* focus_rel, uint8_t* speed, enum uvc_req_code req_code, uvc_ctrl_callback_t *cb, void *user_ptr) {
+  void *out[] = { focus_rel, speed };
+
+  return uvc_get_ctrl_fields_async(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_FOCUS_REL], out, req_code,
+                                   cb, user_ptr);
+}
 
-  data[0] = focus_rel;
-  data[1] = speed;
 
-  ret = libusb_control_transfer(
-    devh->usb_devh,
-    REQ_TYPE_SET, UVC_SET_CUR,
-    UVC_CT_FOCUS_RELATIVE_CONTROL << 8,
-    uvc_get_camera_terminal(devh)->bTerminalID << 8 | devh->info->ctrl_if.bInterfaceNumber,
-    data,
-    sizeof(data),
-    0);
+/** @ingroup ctrl
+ * @brief Sets the FOCUS_RELATIVE control without waiting for it to complete.
+ *
+ * @p cb is called with UVC_SUCCESS once the value has been sent. See
+ * uvc_set_ctrl_async().
+ * @param devh UVC device handle
+ * @param focus_rel TODO
+ * @param speed TODO
+ * @param cb Completion callback, or NULL
+ * @param user_ptr Passed to @p cb
+ */
+uvc_error_t uvc_set_focus_rel_async(uvc_device_handle_t *devh, int8_t focus_rel, uint8_t speed, uvc_ctrl_callback_t *cb, void *user_ptr) {
+  const int64_t values[] = { focus_rel, speed };
 
-  if (ret == sizeof(data))
-    return UVC_SUCCESS;
-  else
-    return ret;
+  return uvc_set_ctrl_fields_async(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_FOCUS_REL], values,
+                                   cb, user_ptr);
 }
 
 /** @ingroup ctrl
@@ -414,24 +460,9 @@ uvc_error_t uvc_set_focus_rel(uvc_device_handle_t *devh, int8_t focus_rel, uint8
  * @param req_code UVC_GET_* request to execute
  */
 uvc_error_t uvc_get_focus_simple_range(uvc_device_handle_t *devh, uint8_t* focus, enum uvc_req_code req_code) {
-  uint8_t data[1];
-  uvc_error_t ret;
-
-  ret = libusb_control_transfer(
-    devh->usb_devh,
-    REQ_TYPE_GET, req_code,
-    UVC_CT_FOCUS_SIMPLE_CONTROL << 8,
-    uvc_get_camera_terminal(devh)->bTerminalID << 8 | devh->info->ctrl_if.bInterfaceNumber,
-    data,
-    sizeof(data),
-    0);
+  void *out[] = { focus };
 
-  if (ret == sizeof(data)) {
-    *focus = data[0];
-    return UVC_SUCCESS;
-  } else {
-    return ret;
-  }
+  return uvc_get_ctrl_fields(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_FOCUS_SIMPLE_RANGE], out, req_code);
 }
 
 
@@ -441,24 +472,46 @@ uvc_error_t uvc_get_focus_simple_range(uvc_device_handle_t *devh, uint8_t* focus
  * @param focus TODO
  */
 uvc_error_t uvc_set_focus_simple_range(uvc_device_handle_t *devh, uint8_t focus) {
-  uint8_t data[1];
-  uvc_error_t ret;
+  const int64_t values[] = { focus };
+
+  return uvc_set_ctrl_fields(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_FOCUS_SIMPLE_RANGE], values);
+}
+
+
+/** @ingroup ctrl
+ * @brief Reads the FOCUS_SIMPLE control without waiting for the answer.
+ *
+ * The fields are filled in just before @p cb is called with UVC_SUCCESS;
+ * they must stay valid until then. See uvc_get_ctrl_async().
+ * @param devh UVC device handle
+ * @param[out] focus TODO
+ * @param req_code UVC_GET_* request to execute
+ * @param cb Completion callback, or NULL
+ * @param user_ptr Passed to @p cb
+ */
+uvc_error_t uvc_get_focus_simple_range_async(uvc_device_handle_t *devh, uint8_t* focus, enum uvc_req_code req_code, uvc_ctrl_callback_t *cb, void *user_ptr) {
+  void *out[] = { focus };
+
+  return uvc_get_ctrl_fields_async(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_FOCUS_SIMPLE_RANGE], out, req_code,
+                                   cb, user_ptr);
+}
 
-  data[0] = focus;
 
-  ret = libusb_control_transfer(
-    devh->usb_devh,
-    REQ_TYPE_SET, UVC_SET_CUR,
-    UVC_CT_FOCUS_SIMPLE_CONTROL << 8,
-    uvc_get_camera_terminal(devh)->bTerminalID << 8 | devh->info->ctrl_if.bInterfaceNumber,
-    data,
-    sizeof(data),
-    0);
+/** @ingroup ctrl
+ * @brief Sets the FOCUS_SIMPLE control without waiting for it to complete.
+ *
+ * @p cb is called with UVC_SUCCESS once the value has been sent. See
+ * uvc_set_ctrl_async().
+ * @param devh UVC device handle
+ * @param focus TODO
+ * @param cb Completion callback, or NULL
+ * @param user_ptr Passed to @p cb
+ */
+uvc_error_t uvc_set_focus_simple_range_async(uvc_device_handle_t *devh, uint8_t focus, uvc_ctrl_callback_t *cb, void *user_ptr) {
+  const int64_t values[] = { focus };
 
-  if (ret == sizeof(data))
-    return UVC_SUCCESS;
-  else
-    return ret;
+  return uvc_set_ctrl_fields_async(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_FOCUS_SIMPLE_RANGE], values,
+                                   cb, user_ptr);
 }
 
 /** @ingroup ctrl
@@ -468,24 +521,9 @@ uvc_error_t uvc_set_focus_simple_range(uvc_device_handle_t *devh, uint8_t focus)
  * @param req_code UVC_GET_* request to execute
  */
 uvc_error_t uvc_get_focus_auto(uvc_device_handle_t *devh, uint8_t* state, enum uvc_req_code req_code) {
-  uint8_t data[1];
-  uvc_error_t ret;
-
-  ret = libusb_control_transfer(
-    devh->usb_devh,
-    REQ_TYPE_GET, req_code,
-    UVC_CT_FOCUS_AUTO_CONTROL << 8,
-    uvc_get_camera_terminal(devh)->bTerminalID << 8 | devh->info->ctrl_if.bInterfaceNumber,
-    data,
-    sizeof(data),
-    0);
+  void *out[] = { state };
 
-  if (ret == sizeof(data)) {
-    *state = data[0];
-    return UVC_SUCCESS;
-  } else {
-    return ret;
-  }
+  return uvc_get_ctrl_fields(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_FOCUS_AUTO], out, req_code);
 }
 
 
@@ -495,24 +533,46 @@ uvc_error_t uvc_get_focus_auto(uvc_device_handle_t *devh, uint8_t* state, enum u
  * @param state TODO
  */
 uvc_error_t uvc_set_focus_auto(uvc_device_handle_t *devh, uint8_t state) {
-  uint8_t data[1];
-  uvc_error_t ret;
+  const int64_t values[] = { state };
+
+  return uvc_set_ctrl_fields(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_FOCUS_AUTO], values);
+}
+
+
+/** @ingroup ctrl
+ * @brief Reads the FOCUS_AUTO control without waiting for the answer.
+ *
+ * The fields are filled in just before @p cb is called with UVC_SUCCESS;
+ * they must stay valid until then. See uvc_get_ctrl_async().
+ * @param devh UVC device handle
+ * @param[out] state TODO
+ * @param req_code UVC_GET_* request to execute
+ * @param cb Completion callback, or NULL
+ * @param user_ptr Passed to @p cb
+ */
+uvc_error_t uvc_get_focus_auto_async(uvc_device_handle_t *devh, uint8_t* state, enum uvc_req_code req_code, uvc_ctrl_callback_t *cb, void *user_ptr) {
+  void *out[] = { state };
+
+  return uvc_get_ctrl_fields_async(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_FOCUS_AUTO], out, req_code,
+                                   cb, user_ptr);
+}
 
-  data[0] = state;
 
-  ret = libusb_control_transfer(
-    devh->usb_devh,
-    REQ_TYPE_SET, UVC_SET_CUR,
-    UVC_CT_FOCUS_AUTO_CONTROL << 8,
-    uvc_get_camera_terminal(devh)->bTerminalID << 8 | devh->info->ctrl_if.bInterfaceNumber,
-    data,
-    sizeof(data),
-    0);
+/** @ingroup ctrl
+ * @brief Sets the FOCUS_AUTO control without waiting for it to complete.
+ *
+ * @p cb is called with UVC_SUCCESS once the value has been sent. See
+ * uvc_set_ctrl_async().
+ * @param devh UVC device handle
+ * @param state TODO
+ * @param cb Completion callback, or NULL
+ * @param user_ptr Passed to @p cb
+ */
+uvc_error_t uvc_set_focus_auto_async(uvc_device_handle_t *devh, uint8_t state, uvc_ctrl_callback_t *cb, void *user_ptr) {
+  const int64_t values[] = { state };
 
-  if (ret == sizeof(data))
-    return UVC_SUCCESS;
-  else
-    return ret;
+  return uvc_set_ctrl_fields_async(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_FOCUS_AUTO], values,
+                                   cb, user_ptr);
 }
 
 /** @ingroup ctrl
@@ -522,24 +582,9 @@ uvc_error_t uvc_set_focus_auto(uvc_device_handle_t *devh, uint8_t state) {
  * @param req_code UVC_GET_* request to execute
  */
 uvc_error_t uvc_get_iris_abs(uvc_device_handle_t *devh, uint16_t* iris, enum uvc_req_code req_code) {
-  uint8_t data[2];
-  uvc_error_t ret;
-
-  ret = libusb_control_transfer(
-    devh->usb_devh,
-    REQ_TYPE_GET, req_code,
-    UVC_CT_IRIS_ABSOLUTE_CONTROL << 8,
-    uvc_get_camera_terminal(devh)->bTerminalID << 8 | devh->info->ctrl_if.bInterfaceNumber,
-    data,
-    sizeof(data),
-    0);
+  void *out[] = { iris };
 
-  if (ret == sizeof(data)) {
-    *iris = SW_TO_SHORT(data + 0);
-    return UVC_SUCCESS;
-  } else {
-    return ret;
-  }
+  return uvc_get_ctrl_fields(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_IRIS_ABS], out, req_code);
 }
 
 
@@ -549,24 +594,46 @@ uvc_error_t uvc_get_iris_abs(uvc_device_handle_t *devh, uint16_t* iris, enum uvc
  * @param iris TODO
  */
 uvc_error_t uvc_set_iris_abs(uvc_device_handle_t *devh, uint16_t iris) {
-  uint8_t data[2];
-  uvc_error_t ret;
+  const int64_t values[] = { iris };
+
+  return uvc_set_ctrl_fields(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_IRIS_ABS], values);
+}
+
+
+/** @ingroup ctrl
+ * @brief Reads the IRIS_ABSOLUTE control without waiting for the answer.
+ *
+ * The fields are filled in just before @p cb is called with UVC_SUCCESS;
+ * they must stay valid until then. See uvc_get_ctrl_async().
+ * @param devh UVC device handle
+ * @param[out] iris TODO
+ * @param req_code UVC_GET_* request to execute
+ * @param cb Completion callback, or NULL
+ * @param user_ptr Passed to @p cb
+ */
+uvc_error_t uvc_get_iris_abs_async(uvc_device_handle_t *devh, uint16_t* iris, enum uvc_req_code req_code, uvc_ctrl_callback_t *cb, void *user_ptr) {
+  void *out[] = { iris };
+
+  return uvc_get_ctrl_fields_async(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_IRIS_ABS], out, req_code,
+                                   cb, user_ptr);
+}
 
-  SHORT_TO_SW(iris, data + 0);
 
-  ret = libusb_control_transfer(
-    devh->usb_devh,
-    REQ_TYPE_SET, UVC_SET_CUR,
-    UVC_CT_IRIS_ABSOLUTE_CONTROL << 8,
-    uvc_get_camera_terminal(devh)->bTerminalID << 8 | devh->info->ctrl_if.bInterfaceNumber,
-    data,
-    sizeof(data),
-    0);
+/** @ingroup ctrl
+ * @brief Sets the IRIS_ABSOLUTE control without waiting for it to complete.
+ *
+ * @p cb is called with UVC_SUCCESS once the value has been sent. See
+ * uvc_set_ctrl_async().
+ * @param devh UVC device handle
+ * @param iris TODO
+ * @param cb Completion callback, or NULL
+ * @param user_ptr Passed to @p cb
+ */
+uvc_error_t uvc_set_iris_abs_async(uvc_device_handle_t *devh, uint16_t iris, uvc_ctrl_callback_t *cb, void *user_ptr) {
+  const int64_t values[] = { iris };
 
-  if (ret == sizeof(data))
-    return UVC_SUCCESS;
-  else
-    return ret;
+  return uvc_set_ctrl_fields_async(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_IRIS_ABS], values,
+                                   cb, user_ptr);
 }
 
 /** @ingroup ctrl
@@ -576,24 +643,9 @@ uvc_error_t uvc_set_iris_abs(uvc_device_handle_t *devh, uint16_t iris) {
  * @param req_code UVC_GET_* request to execute
  */
 uvc_error_t uvc_get_iris_rel(uvc_device_handle_t *devh, uint8_t* iris_rel, enum uvc_req_code req_code) {
-  uint8_t data[1];
-  uvc_error_t ret;
-
-  ret = libusb_control_transfer(
-    devh->usb_devh,
-    REQ_TYPE_GET, req_code,
-    UVC_CT_IRIS_RELATIVE_CONTROL << 8,
-    uvc_get_camera_terminal(devh)->bTerminalID << 8 | devh->info->ctrl_if.bInterfaceNumber,
-    data,
-    sizeof(data),
-    0);
+  void *out[] = { iris_rel };
 
-  if (ret == sizeof(data)) {
-    *iris_rel = data[0];
-    return UVC_SUCCESS;
-  } else {
-    return ret;
-  }
+  return uvc_get_ctrl_fields(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_IRIS_REL], out, req_code);
 }
 
 
@@ -603,24 +655,46 @@ uvc_error_t uvc_get_iris_rel(uvc_device_handle_t *devh, uint8_t* iris_rel, enum
  * @param iris_rel TODO
  */
 uvc_error_t uvc_set_iris_rel(uvc_device_handle_t *devh, uint8_t iris_rel) {
-  uint8_t data[1];
-  uvc_error_t ret;
+  const int64_t values[] = { iris_rel };
+
+  return uvc_set_ctrl_fields(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_IRIS_REL], values);
+}
+
+
+/** @ingroup ctrl
+ * @brief Reads the IRIS_RELATIVE control without waiting for the answer.
+ *
+ * The fields are filled in just before @p cb is called with UVC_SUCCESS;
+ * they must stay valid until then. See uvc_get_ctrl_async().
+ * @param devh UVC device handle
+ * @param[out] iris_rel TODO
+ * @param req_code UVC_GET_* request to execute
+ * @param cb Completion callback, or NULL
+ * @param user_ptr Passed to @p cb
+ */
+uvc_error_t uvc_get_iris_rel_async(uvc_device_handle_t *devh, uint8_t* iris_rel, enum uvc_req_code req_code, uvc_ctrl_callback_t *cb, void *user_ptr) {
+  void *out[] = { iris_rel };
+
+  return uvc_get_ctrl_fields_async(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_IRIS_REL], out, req_code,
+                                   cb, user_ptr);
+}
 
-  data[0] = iris_rel;
 
-  ret = libusb_control_transfer(
-    devh->usb_devh,
-    REQ_TYPE_SET, UVC_SET_CUR,
-    UVC_CT_IRIS_RELATIVE_CONTROL << 8,
-    uvc_get_camera_terminal(devh)->bTerminalID << 8 | devh->info->ctrl_if.bInterfaceNumber,
-    data,
-    sizeof(data),
-    0);
+/** @ingroup ctrl
+ * @brief Sets the IRIS_RELATIVE control without waiting for it to complete.
+ *
+ * @p cb is called with UVC_SUCCESS once the value has been sent. See
+ * uvc_set_ctrl_async().
+ * @param devh UVC device handle
+ * @param iris_rel TODO
+ * @param cb Completion callback, or NULL
+ * @param user_ptr Passed to @p cb
+ */
+uvc_error_t uvc_set_iris_rel_async(uvc_device_handle_t *devh, uint8_t iris_rel, uvc_ctrl_callback_t *cb, void *user_ptr) {
+  const int64_t values[] = { iris_rel };
 
-  if (ret == sizeof(data))
-    return UVC_SUCCESS;
-  else
-    return ret;
+  return uvc_set_ctrl_fields_async(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_IRIS_REL], values,
+                                   cb, user_ptr);
 }
 
 /** @ingroup ctrl
@@ -630,24 +704,9 @@ uvc_error_t uvc_set_iris_rel(uvc_device_handle_t *devh, uint8_t iris_rel) {
  * @param req_code UVC_GET_* request to execute
  */
 uvc_error_t uvc_get_zoom_abs(uvc_device_handle_t *devh, uint16_t* focal_length, enum uvc_req_code req_code) {
-  uint8_t data[2];
-  uvc_error_t ret;
-
-  ret = libusb_control_transfer(
-    devh->usb_devh,
-    REQ_TYPE_GET, req_code,
-    UVC_CT_ZOOM_ABSOLUTE_CONTROL << 8,
-    uvc_get_camera_terminal(devh)->bTerminalID << 8 | devh->info->ctrl_if.bInterfaceNumber,
-    data,
-    sizeof(data),
-    0);
+  void *out[] = { focal_length };
 
-  if (ret == sizeof(data)) {
-    *focal_length = SW_TO_SHORT(data + 0);
-    return UVC_SUCCESS;
-  } else {
-    return ret;
-  }
+  return uvc_get_ctrl_fields(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_ZOOM_ABS], out, req_code);
 }
 
 
@@ -657,24 +716,46 @@ uvc_error_t uvc_get_zoom_abs(uvc_device_handle_t *devh, uint16_t* focal_length,
  * @param focal_length TODO
  */
 uvc_error_t uvc_set_zoom_abs(uvc_device_handle_t *devh, uint16_t focal_length) {
-  uint8_t data[2];
-  uvc_error_t ret;
+  const int64_t values[] = { focal_length };
+
+  return uvc_set_ctrl_fields(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_ZOOM_ABS], values);
+}
+
+
+/** @ingroup ctrl
+ * @brief Reads the ZOOM_ABSOLUTE control without waiting for the answer.
+ *
+ * The fields are filled in just before @p cb is called with UVC_SUCCESS;
+ * they must stay valid until then. See uvc_get_ctrl_async().
+ * @param devh UVC device handle
+ * @param[out] focal_length TODO
+ * @param req_code UVC_GET_* request to execute
+ * @param cb Completion callback, or NULL
+ * @param user_ptr Passed to @p cb
+ */
+uvc_error_t uvc_get_zoom_abs_async(uvc_device_handle_t *devh, uint16_t* focal_length, enum uvc_req_code req_code, uvc_ctrl_callback_t *cb, void *user_ptr) {
+  void *out[] = { focal_length };
+
+  return uvc_get_ctrl_fields_async(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_ZOOM_ABS], out, req_code,
+                                   cb, user_ptr);
+}
 
-  SHORT_TO_SW(focal_length, data + 0);
 
-  ret = libusb_control_transfer(
-    devh->usb_devh,
-    REQ_TYPE_SET, UVC_SET_CUR,
-    UVC_CT_ZOOM_ABSOLUTE_CONTROL << 8,
-    uvc_get_camera_terminal(devh)->bTerminalID << 8 | devh->info->ctrl_if.bInterfaceNumber,
-    data,
-    sizeof(data),
-    0);
+/** @ingroup ctrl
+ * @brief Sets the ZOOM_ABSOLUTE control without waiting for it to complete.
+ *
+ * @p cb is called with UVC_SUCCESS once the value has been sent. See
+ * uvc_set_ctrl_async().
+ * @param devh UVC device handle
+ * @param focal_length TODO
+ * @param cb Completion callback, or NULL
+ * @param user_ptr Passed to @p cb
+ */
+uvc_error_t uvc_set_zoom_abs_async(uvc_device_handle_t *devh, uint16_t focal_length, uvc_ctrl_callback_t *cb, void *user_ptr) {
+  const int64_t values[] = { focal_length };
 
-  if (ret == sizeof(data))
-    return UVC_SUCCESS;
-  else
-    return ret;
+  return uvc_set_ctrl_fields_async(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_ZOOM_ABS], values,
+                                   cb, user_ptr);
 }
 
 /** @ingroup ctrl
@@ -686,26 +767,9 @@ uvc_error_t uvc_set_zoom_abs(uvc_device_handle_t *devh, uint16_t focal_length) {
  * @param req_code UVC_GET_* request to execute
  */
 uvc_error_t uvc_get_zoom_rel(uvc_device_handle_t *devh, int8_t* zoom_rel, uint8_t* digital_zoom, uint8_t* speed, enum uvc_req_code req_code) {
-  uint8_t data[3];
-  uvc_error_t ret;
-
-  ret = libusb_control_transfer(
-    devh->usb_devh,
-    REQ_TYPE_GET, req_code,
-    UVC_CT_ZOOM_RELATIVE_CONTROL << 8,
-    uvc_get_camera_terminal(devh)->bTerminalID << 8 | devh->info->ctrl_if.bInterfaceNumber,
-    data,
-    sizeof(data),
-    0);
+  void *out[] = { zoom_rel, digital_zoom, speed };
 
-  if (ret == sizeof(data)) {
-    *zoom_rel = data[0];
-    *digital_zoom = data[1];
-    *speed = data[2];
-    return UVC_SUCCESS;
-  } else {
-    return ret;
-  }
+  return uvc_get_ctrl_fields(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_ZOOM_REL], out, req_code);
 }
 
 
@@ -717,26 +781,50 @@ uvc_error_t uvc_get_zoom_rel(uvc_device_handle_t *devh, int8_t* zoom_rel, uint8_
  * @param speed TODO
  */
 uvc_error_t uvc_set_zoom_rel(uvc_device_handle_t *devh, int8_t zoom_rel, uint8_t digital_zoom, uint8_t speed) {
-  uint8_t data[3];
-  uvc_error_t ret;
+  const int64_t values[] = { zoom_rel, digital_zoom, speed };
+
+  return uvc_set_ctrl_fields(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_ZOOM_REL], values);
+}
+
+
+/** @ingroup ctrl
+ * @brief Reads the ZOOM_RELATIVE control without waiting for the answer.
+ *
+ * The fields are filled in just before @p cb is called with UVC_SUCCESS;
+ * they must stay valid until then. See uvc_get_ctrl_async().
+ * @param devh UVC device handle
+ * @param[out] zoom_rel TODO
+ * @param[out] digital_zoom TODO
+ * @param[out] speed TODO
+ * @param req_code UVC_GET_* request to execute
+ * @param cb Completion callback, or NULL
+ * @param user_ptr Passed to @p cb
+ */
+uvc_error_t uvc_get_zoom_rel_async(uvc_device_handle_t *devh, int8_t* zoom_rel, uint8_t* digital_zoom, uint8_t* speed, enum uvc_req_code req_code, uvc_ctrl_callback_t *cb, void *user_ptr) {
+  void *out[] = { zoom_rel, digital_zoom, speed };
+
+  return uvc_get_ctrl_fields_async(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_ZOOM_REL], out, req_code,
+                                   cb, user_ptr);
+}
 
-  data[0] = zoom_rel;
-  data[1] = digital_zoom;
-  data[2] = speed;
 
-  ret = libusb_control_transfer(
-    devh->usb_devh,
-    REQ_TYPE_SET, UVC_SET_CUR,
-    UVC_CT_ZOOM_RELATIVE_CONTROL << 8,
-    uvc_get_camera_terminal(devh)->bTerminalID << 8 | devh->info->ctrl_if.bInterfaceNumber,
-    data,
-    sizeof(data),
-    0);
+/** @ingroup ctrl
+ * @brief Sets the ZOOM_RELATIVE control without waiting for it to complete.
+ *
+ * @p cb is called with UVC_SUCCESS once the value has been sent. See
+ * uvc_set_ctrl_async().
+ * @param devh UVC device handle
+ * @param zoom_rel TODO
+ * @param digital_zoom TODO
+ * @param speed TODO
+ * @param cb Completion callback, or NULL
+ * @param user_ptr Passed to @p cb
+ */
+uvc_error_t uvc_set_zoom_rel_async(uvc_device_handle_t *devh, int8_t zoom_rel, uint8_t digital_zoom, uint8_t speed, uvc_ctrl_callback_t *cb, void *user_ptr) {
+  const int64_t values[] = { zoom_rel, digital_zoom, speed };
 
-  if (ret == sizeof(data))
-    return UVC_SUCCESS;
-  else
-    return ret;
+  return uvc_set_ctrl_fields_async(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_ZOOM_REL], values,
+                                   cb, user_ptr);
 }
 
 /** @ingroup ctrl
@@ -747,25 +835,9 @@ uvc_error_t uvc_set_zoom_rel(uvc_device_handle_t *devh, int8_t zoom_rel, uint8_t
  * @param req_code UVC_GET_* request to execute
  */
 uvc_error_t uvc_get_pantilt_abs(uvc_device_handle_t *devh, int32_t* pan, int32_t* tilt, enum uvc_req_code req_code) {
-  uint8_t data[8];
-  uvc_error_t ret;
-
-  ret = libusb_control_transfer(
-    devh->usb_devh,
-    REQ_TYPE_GET, req_code,
-    UVC_CT_PANTILT_ABSOLUTE_CONTROL << 8,
-    uvc_get_camera_terminal(devh)->bTerminalID << 8 | devh->info->ctrl_if.bInterfaceNumber,
-    data,
-    sizeof(data),
-    0);
+  void *out[] = { pan, tilt };
 
-  if (ret == sizeof(data)) {
-    *pan = DW_TO_INT(data + 0);
-    *tilt = DW_TO_INT(data + 4);
-    return UVC_SUCCESS;
-  } else {
-    return ret;
-  }
+  return uvc_get_ctrl_fields(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_PANTILT_ABS], out, req_code);
 }
 
 
@@ -776,25 +848,48 @@ uvc_error_t uvc_get_pantilt_abs(uvc_device_handle_t *devh, int32_t* pan, int32_t
  * @param tilt TODO
  */
 uvc_error_t uvc_set_pantilt_abs(uvc_device_handle_t *devh, int32_t pan, int32_t tilt) {
-  uint8_t data[8];
-  uvc_error_t ret;
+  const int64_t values[] = { pan, tilt };
+
+  return uvc_set_ctrl_fields(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_PANTILT_ABS], values);
+}
+
+
+/** @ingroup ctrl
+ * @brief Reads the PANTILT_ABSOLUTE control without waiting for the answer.
+ *
+ * The fields are filled in just before @p cb is called with UVC_SUCCESS;
+ * they must stay valid until then. See uvc_get_ctrl_async().
+ * @param devh UVC device handle
+ * @param[out] pan TODO
+ * @param[out] tilt TODO
+ * @param req_code UVC_GET_* request to execute
+ * @param cb Completion callback, or NULL
+ * @param user_ptr Passed to @p cb
+ */
+uvc_error_t uvc_get_pantilt_abs_async(uvc_device_handle_t *devh, int32_t* pan, int32_t* tilt, enum uvc_req_code req_code, uvc_ctrl_callback_t *cb, void *user_ptr) {
+  void *out[] = { pan, tilt };
+
+  return uvc_get_ctrl_fields_async(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_PANTILT_ABS], out, req_code,
+                                   cb, user_ptr);
+}
 
-  INT_TO_DW(pan, data + 0);
-  INT_TO_DW(tilt, data + 4);
 
-  ret = libusb_control_transfer(
-    devh->usb_devh,
-    REQ_TYPE_SET, UVC_SET_CUR,
-    UVC_CT_PANTILT_ABSOLUTE_CONTROL << 8,
-    uvc_get_camera_terminal(devh)->bTerminalID << 8 | devh->info->ctrl_if.bInterfaceNumber,
-    data,
-    sizeof(data),
-    0);
+/** @ingroup ctrl
+ * @brief Sets the PANTILT_ABSOLUTE control without waiting for it to complete.
+ *
+ * @p cb is called with UVC_SUCCESS once the value has been sent. See
+ * uvc_set_ctrl_async().
+ * @param devh UVC device handle
+ * @param pan TODO
+ * @param tilt TODO
+ * @param cb Completion callback, or NULL
+ * @param user_ptr Passed to @p cb
+ */
+uvc_error_t uvc_set_pantilt_abs_async(uvc_device_handle_t *devh, int32_t pan, int32_t tilt, uvc_ctrl_callback_t *cb, void *user_ptr) {
+  const int64_t values[] = { pan, tilt };
 
-  if (ret == sizeof(data))
-    return UVC_SUCCESS;
-  else
-    return ret;
+  return uvc_set_ctrl_fields_async(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_PANTILT_ABS], values,
+                                   cb, user_ptr);
 }
 
 /** @ingroup ctrl
@@ -807,27 +902,9 @@ uvc_error_t uvc_set_pantilt_abs(uvc_device_handle_t *devh, int32_t pan, int32_t
  * @param req_code UVC_GET_* request to execute
  */
 uvc_error_t uvc_get_pantilt_rel(uvc_device_handle_t *devh, int8_t* pan_rel, uint8_t* pan_speed, int8_t* tilt_rel, uint8_t* tilt_speed, enum uvc_req_code req_code) {
-  uint8_t data[4];
-  uvc_error_t ret;
-
-  ret = libusb_control_transfer(
-    devh->usb_devh,
-    REQ_TYPE_GET, req_code,
-    UVC_CT_PANTILT_RELATIVE_CONTROL << 8,
-    uvc_get_camera_terminal(devh)->bTerminalID << 8 | devh->info->ctrl_if.bInterfaceNumber,
-    data,
-    sizeof(data),
-    0);
+  void *out[] = { pan_rel, pan_speed, tilt_rel, tilt_speed };
 
-  if (ret == sizeof(data)) {
-    *pan_rel = data[0];
-    *pan_speed = data[1];
-    *tilt_rel = data[2];
-    *tilt_speed = data[3];
-    return UVC_SUCCESS;
-  } else {
-    return ret;
-  }
+  return uvc_get_ctrl_fields(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_PANTILT_REL], out, req_code);
 }
 
 
@@ -840,27 +917,52 @@ uvc_error_t uvc_get_pantilt_rel(uvc_device_handle_t *devh, int8_t* pan_rel, uint
  * @param tilt_speed TODO
  */
 uvc_error_t uvc_set_pantilt_rel(uvc_device_handle_t *devh, int8_t pan_rel, uint8_t pan_speed, int8_t tilt_rel, uint8_t tilt_speed) {
-  uint8_t data[4];
-  uvc_error_t ret;
+  const int64_t values[] = { pan_rel, pan_speed, tilt_rel, tilt_speed };
+
+  return uvc_set_ctrl_fields(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_PANTILT_REL], values);
+}
+
+
+/** @ingroup ctrl
+ * @brief Reads the PANTILT_RELATIVE control without waiting for the answer.
+ *
+ * The fields are filled in just before @p cb is called with UVC_SUCCESS;
+ * they must stay valid until then. See uvc_get_ctrl_async().
+ * @param devh UVC device handle
+ * @param[out] pan_rel TODO
+ * @param[out] pan_speed TODO
+ * @param[out] tilt_rel TODO
+ * @param[out] tilt_speed TODO
+ * @param req_code UVC_GET_* request to execute
+ * @param cb Completion callback, or NULL
+ * @param user_ptr Passed to @p cb
+ */
+uvc_error_t uvc_get_pantilt_rel_async(uvc_device_handle_t *devh, int8_t* pan_rel, uint8_t* pan_speed, int8_t* tilt_rel, uint8_t* tilt_speed, enum uvc_req_code req_code, uvc_ctrl_callback_t *cb, void *user_ptr) {
+  void *out[] = { pan_rel, pan_speed, tilt_rel, tilt_speed };
+
+  return uvc_get_ctrl_fields_async(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_PANTILT_REL], out, req_code,
+                                   cb, user_ptr);
+}
 
-  data[0] = pan_rel;
-  data[1] = pan_speed;
-  data[2] = tilt_rel;
-  data[3] = tilt_speed;
 
-  ret = libusb_control_transfer(
-    devh->usb_devh,
-    REQ_TYPE_SET, UVC_SET_CUR,
-    UVC_CT_PANTILT_RELATIVE_CONTROL << 8,
-    uvc_get_camera_terminal(devh)->bTerminalID << 8 | devh->info->ctrl_if.bInterfaceNumber,
-    data,
-    sizeof(data),
-    0);
+/** @ingroup ctrl
+ * @brief Sets the PANTILT_RELATIVE control without waiting for it to complete.
+ *
+ * @p cb is called with UVC_SUCCESS once the value has been sent. See
+ * uvc_set_ctrl_async().
+ * @param devh UVC device handle
+ * @param pan_rel TODO
+ * @param pan_speed TODO
+ * @param tilt_rel TODO
+ * @param tilt_speed TODO
+ * @param cb Completion callback, or NULL
+ * @param user_ptr Passed to @p cb
+ */
+uvc_error_t uvc_set_pantilt_rel_async(uvc_device_handle_t *devh, int8_t pan_rel, uint8_t pan_speed, int8_t tilt_rel, uint8_t tilt_speed, uvc_ctrl_callback_t *cb, void *user_ptr) {
+  const int64_t values[] = { pan_rel, pan_speed, tilt_rel, tilt_speed };
 
-  if (ret == sizeof(data))
-    return UVC_SUCCESS;
-  else
-    return ret;
+  return uvc_set_ctrl_fields_async(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_PANTILT_REL], values,
+                                   cb, user_ptr);
 }
 
 /** @ingroup ctrl
@@ -870,24 +972,9 @@ uvc_error_t uvc_set_pantilt_rel(uvc_device_handle_t *devh, int8_t pan_rel, uint8
  * @param req_code UVC_GET_* request to execute
  */
 uvc_error_t uvc_get_roll_abs(uvc_device_handle_t *devh, int16_t* roll, enum uvc_req_code req_code) {
-  uint8_t data[2];
-  uvc_error_t ret;
-
-  ret = libusb_control_transfer(
-    devh->usb_devh,
-    REQ_TYPE_GET, req_code,
-    UVC_CT_ROLL_ABSOLUTE_CONTROL << 8,
-    uvc_get_camera_terminal(devh)->bTerminalID << 8 | devh->info->ctrl_if.bInterfaceNumber,
-    data,
-    sizeof(data),
-    0);
+  void *out[] = { roll };
 
-  if (ret == sizeof(data)) {
-    *roll = SW_TO_SHORT(data + 0);
-    return UVC_SUCCESS;
-  } else {
-    return ret;
-  }
+  return uvc_get_ctrl_fields(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_ROLL_ABS], out, req_code);
 }
 
 
@@ -897,24 +984,46 @@ uvc_error_t uvc_get_roll_abs(uvc_device_handle_t *devh, int16_t* roll, enum uvc_
  * @param roll TODO
  */
 uvc_error_t uvc_set_roll_abs(uvc_device_handle_t *devh, int16_t roll) {
-  uint8_t data[2];
-  uvc_error_t ret;
+  const int64_t values[] = { roll };
+
+  return uvc_set_ctrl_fields(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_ROLL_ABS], values);
+}
 
-  SHORT_TO_SW(roll, data + 0);
 
-  ret = libusb_control_transfer(
-    devh->usb_devh,
-    REQ_TYPE_SET, UVC_SET_CUR,
-    UVC_CT_ROLL_ABSOLUTE_CONTROL << 8,
-    uvc_get_camera_terminal(devh)->bTerminalID << 8 | devh->info->ctrl_if.bInterfaceNumber,
-    data,
-    sizeof(data),
-    0);
+/** @ingroup ctrl
+ * @brief Reads the ROLL_ABSOLUTE control without waiting for the answer.
+ *
+ * The fields are filled in just before @p cb is called with UVC_SUCCESS;
+ * they must stay valid until then. See uvc_get_ctrl_async().
+ * @param devh UVC device handle
+ * @param[out] roll TODO
+ * @param req_code UVC_GET_* request to execute
+ * @param cb Completion callback, or NULL
+ * @param user_ptr Passed to @p cb
+ */
+uvc_error_t uvc_get_roll_abs_async(uvc_device_handle_t *devh, int16_t* roll, enum uvc_req_code req_code, uvc_ctrl_callback_t *cb, void *user_ptr) {
+  void *out[] = { roll };
 
-  if (ret == sizeof(data))
-    return UVC_SUCCESS;
-  else
-    return ret;
+  return uvc_get_ctrl_fields_async(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_ROLL_ABS], out, req_code,
+                                   cb, user_ptr);
+}
+
+
+/** @ingroup ctrl
+ * @brief Sets the ROLL_ABSOLUTE control without waiting for it to complete.
+ *
+ * @p cb is called with UVC_SUCCESS once the value has been sent. See
+ * uvc_set_ctrl_async().
+ * @param devh UVC device handle
+ * @param roll TODO
+ * @param cb Completion callback, or NULL
+ * @param user_ptr Passed to @p cb
+ */
+uvc_error_t uvc_set_roll_abs_async(uvc_device_handle_t *devh, int16_t roll, uvc_ctrl_callback_t *cb, void *user_ptr) {
+  const int64_t values[] = { roll };
+
+  return uvc_set_ctrl_fields_async(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_ROLL_ABS], values,
+                                   cb, user_ptr);
 }
 
 /** @ingroup ctrl
@@ -925,25 +1034,9 @@ uvc_error_t uvc_set_roll_abs(uvc_device_handle_t *devh, int16_t roll) {
  * @param req_code UVC_GET_* request to execute
  */
 uvc_error_t uvc_get_roll_rel(uvc_device_handle_t *devh, int8_t* roll_rel, uint8_t* speed, enum uvc_req_code req_code) {
-  uint8_t data[2];
-  uvc_error_t ret;
-
-  ret = libusb_control_transfer(
-    devh->usb_devh,
-    REQ_TYPE_GET, req_code,
-    UVC_CT_ROLL_RELATIVE_CONTROL << 8,
-    uvc_get_camera_terminal(devh)->bTerminalID << 8 | devh->info->ctrl_if.bInterfaceNumber,
-    data,
-    sizeof(data),
-    0);
+  void *out[] = { roll_rel, speed };
 
-  if (ret == sizeof(data)) {
-    *roll_rel = data[0];
-    *speed = data[1];
-    return UVC_SUCCESS;
-  } else {
-    return ret;
-  }
+  return uvc_get_ctrl_fields(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_ROLL_REL], out, req_code);
 }
 
 
@@ -954,25 +1047,48 @@ uvc_error_t uvc_get_roll_rel(uvc_device_handle_t *devh, int8_t* roll_rel, uint8_
  * @param speed TODO
  */
 uvc_error_t uvc_set_roll_rel(uvc_device_handle_t *devh, int8_t roll_rel, uint8_t speed) {
-  uint8_t data[2];
-  uvc_error_t ret;
+  const int64_t values[] = { roll_rel, speed };
 
-  data[0] = roll_rel;
-  data[1] = speed;
+  return uvc_set_ctrl_fields(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_ROLL_REL], values);
+}
 
-  ret = libusb_control_transfer(
-    devh->usb_devh,
-    REQ_TYPE_SET, UVC_SET_CUR,
-    UVC_CT_ROLL_RELATIVE_CONTROL << 8,
-    uvc_get_camera_terminal(devh)->bTerminalID << 8 | devh->info->ctrl_if.bInterfaceNumber,
-    data,
-    sizeof(data),
-    0);
 
-  if (ret == sizeof(data))
-    return UVC_SUCCESS;
-  else
-    return ret;
+/** @ingroup ctrl
+ * @brief Reads the ROLL_RELATIVE control without waiting for the answer.
+ *
+ * The fields are filled in just before @p cb is called with UVC_SUCCESS;
+ * they must stay valid until then. See uvc_get_ctrl_async().
+ * @param devh UVC device handle
+ * @param[out] roll_rel TODO
+ * @param[out] speed TODO
+ * @param req_code UVC_GET_* request to execute
+ * @param cb Completion callback, or NULL
+ * @param user_ptr Passed to @p cb
+ */
+uvc_error_t uvc_get_roll_rel_async(uvc_device_handle_t *devh, int8_t* roll_rel, uint8_t* speed, enum uvc_req_code req_code, uvc_ctrl_callback_t *cb, void *user_ptr) {
+  void *out[] = { roll_rel, speed };
+
+  return uvc_get_ctrl_fields_async(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_ROLL_REL], out, req_code,
+                                   cb, user_ptr);
+}
+
+
+/** @ingroup ctrl
+ * @brief Sets the ROLL_RELATIVE control without waiting for it to complete.
+ *
+ * @p cb is called with UVC_SUCCESS once the value has been sent. See
+ * uvc_set_ctrl_async().
+ * @param devh UVC device handle
+ * @param roll_rel TODO
+ * @param speed TODO
+ * @param cb Completion callback, or NULL
+ * @param user_ptr Passed to @p cb
+ */
+uvc_error_t uvc_set_roll_rel_async(uvc_device_handle_t *devh, int8_t roll_rel, uint8_t speed, uvc_ctrl_callback_t *cb, void *user_ptr) {
+  const int64_t values[] = { roll_rel, speed };
+
+  return uvc_set_ctrl_fields_async(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_ROLL_REL], values,
+                                   cb, user_ptr);
 }
 
 /** @ingroup ctrl
@@ -982,24 +1098,9 @@ uvc_error_t uvc_set_roll_rel(uvc_device_handle_t *devh, int8_t roll_rel, uint8_t
  * @param req_code UVC_GET_* request to execute
  */
 uvc_error_t uvc_get_privacy(uvc_device_handle_t *devh, uint8_t* privacy, enum uvc_req_code req_code) {
-  uint8_t data[1];
-  uvc_error_t ret;
-
-  ret = libusb_control_transfer(
-    devh->usb_devh,
-    REQ_TYPE_GET, req_code,
-    UVC_CT_PRIVACY_CONTROL << 8,
-    uvc_get_camera_terminal(devh)->bTerminalID << 8 | devh->info->ctrl_if.bInterfaceNumber,
-    data,
-    sizeof(data),
-    0);
+  void *out[] = { privacy };
 
-  if (ret == sizeof(data)) {
-    *privacy = data[0];
-    return UVC_SUCCESS;
-  } else {
-    return ret;
-  }
+  return uvc_get_ctrl_fields(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_PRIVACY], out, req_code);
 }
 
 
@@ -1009,24 +1110,46 @@ uvc_error_t uvc_get_privacy(uvc_device_handle_t *devh, uint8_t* privacy, enum uv
  * @param privacy TODO
  */
 uvc_error_t uvc_set_privacy(uvc_device_handle_t *devh, uint8_t privacy) {
-  uint8_t data[1];
-  uvc_error_t ret;
+  const int64_t values[] = { privacy };
+
+  return uvc_set_ctrl_fields(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_PRIVACY], values);
+}
+
+
+/** @ingroup ctrl
+ * @brief Reads the PRIVACY control without waiting for the answer.
+ *
+ * The fields are filled in just before @p cb is called with UVC_SUCCESS;
+ * they must stay valid until then. See uvc_get_ctrl_async().
+ * @param devh UVC device handle
+ * @param[out] privacy TODO
+ * @param req_code UVC_GET_* request to execute
+ * @param cb Completion callback, or NULL
+ * @param user_ptr Passed to @p cb
+ */
+uvc_error_t uvc_get_privacy_async(uvc_device_handle_t *devh, uint8_t* privacy, enum uvc_req_code req_code, uvc_ctrl_callback_t *cb, void *user_ptr) {
+  void *out[] = { privacy };
 
-  data[0] = privacy;
+  return uvc_get_ctrl_fields_async(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_PRIVACY], out, req_code,
+                                   cb, user_ptr);
+}
 
-  ret = libusb_control_transfer(
-    devh->usb_devh,
-    REQ_TYPE_SET, UVC_SET_CUR,
-    UVC_CT_PRIVACY_CONTROL << 8,
-    uvc_get_camera_terminal(devh)->bTerminalID << 8 | devh->info->ctrl_if.bInterfaceNumber,
-    data,
-    sizeof(data),
-    0);
 
-  if (ret == sizeof(data))
-    return UVC_SUCCESS;
-  else
-    return ret;
+/** @ingroup ctrl
+ * @brief Sets the PRIVACY control without waiting for it to complete.
+ *
+ * @p cb is called with UVC_SUCCESS once the value has been sent. See
+ * uvc_set_ctrl_async().
+ * @param devh UVC device handle
+ * @param privacy TODO
+ * @param cb Completion callback, or NULL
+ * @param user_ptr Passed to @p cb
+ */
+uvc_error_t uvc_set_privacy_async(uvc_device_handle_t *devh, uint8_t privacy, uvc_ctrl_callback_t *cb, void *user_ptr) {
+  const int64_t values[] = { privacy };
+
+  return uvc_set_ctrl_fields_async(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_PRIVACY], values,
+                                   cb, user_ptr);
 }
 
 /** @ingroup ctrl
@@ -1041,29 +1164,9 @@ uvc_error_t uvc_set_privacy(uvc_device_handle_t *devh, uint8_t privacy) {
  * @param req_code UVC_GET_* request to execute
  */
 uvc_error_t uvc_get_digital_window(uvc_device_handle_t *devh, uint16_t* window_top, uint16_t* window_left, uint16_t* window_bottom, uint16_t* window_right, uint16_t* num_steps, uint16_t* num_steps_units, enum uvc_req_code req_code) {
-  uint8_t data[12];
-  uvc_error_t ret;
-
-  ret = libusb_control_transfer(
-    devh->usb_devh,
-    REQ_TYPE_GET, req_code,
-    UVC_CT_DIGITAL_WINDOW_CONTROL << 8,
-    uvc_get_camera_terminal(devh)->bTerminalID << 8 | devh->info->ctrl_if.bInterfaceNumber,
-    data,
-    sizeof(data),
-    0);
+  void *out[] = { window_top, window_left, window_bottom, window_right, num_steps, num_steps_units };
 
-  if (ret == sizeof(data)) {
-    *window_top = SW_TO_SHORT(data + 0);
-    *window_left = SW_TO_SHORT(data + 2);
-    *window_bottom = SW_TO_SHORT(data + 4);
-    *window_right = SW_TO_SHORT(data + 6);
-    *num_steps = SW_TO_SHORT(data + 8);
-    *num_steps_units = SW_TO_SHORT(data + 10);
-    return UVC_SUCCESS;
-  } else {
-    return ret;
-  }
+  return uvc_get_ctrl_fields(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_DIGITAL_WINDOW], out, req_code);
 }
 
 
@@ -1078,29 +1181,56 @@ uvc_error_t uvc_get_digital_window(uvc_device_handle_t *devh, uint16_t* window_t
  * @param num_steps_units TODO
  */
 uvc_error_t uvc_set_digital_window(uvc_device_handle_t *devh, uint16_t window_top, uint16_t window_left, uint16_t window_bottom, uint16_t window_right, uint16_t num_steps, uint16_t num_steps_units) {
-  uint8_t data[12];
-  uvc_error_t ret;
+  const int64_t values[] = { window_top, window_left, window_bottom, window_right, num_steps, num_steps_units };
+
+  return uvc_set_ctrl_fields(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_DIGITAL_WINDOW], values);
+}
+
 
-  SHORT_TO_SW(window_top, data + 0);
-  SHORT_TO_SW(window_left, data + 2);
-  SHORT_TO_SW(window_bottom, data + 4);
-  SHORT_TO_SW(window_right, data + 6);
-  SHORT_TO_SW(num_steps, data + 8);
-  SHORT_TO_SW(num_steps_units, data + 10);
+/** @ingroup ctrl
+ * @brief Reads the DIGITAL_WINDOW control without waiting for the answer.
+ *
+ * The fields are filled in just before @p cb is called with UVC_SUCCESS;
+ * they must stay valid until then. See uvc_get_ctrl_async().
+ * @param devh UVC device handle
+ * @param[out] window_top TODO
+ * @param[out] window_left TODO
+ * @param[out] window_bottom TODO
+ * @param[out] window_right TODO
+ * @param[out] num_steps TODO
+ * @param[out] num_steps_units TODO
+ * @param req_code UVC_GET_* request to execute
+ * @param cb Completion callback, or NULL
+ * @param user_ptr Passed to @p cb
+ */
+uvc_error_t uvc_get_digital_window_async(uvc_device_handle_t *devh, uint16_t* window_top, uint16_t* window_left, uint16_t* window_bottom, uint16_t* window_right, uint16_t* num_steps, uint16_t* num_steps_units, enum uvc_req_code req_code, uvc_ctrl_callback_t *cb, void *user_ptr) {
+  void *out[] = { window_top, window_left, window_bottom, window_right, num_steps, num_steps_units };
 
-  ret = libusb_control_transfer(
-    devh->usb_devh,
-    REQ_TYPE_SET, UVC_SET_CUR,
-    UVC_CT_DIGITAL_WINDOW_CONTROL << 8,
-    uvc_get_camera_terminal(devh)->bTerminalID << 8 | devh->info->ctrl_if.bInterfaceNumber,
-    data,
-    sizeof(data),
-    0);
+  return uvc_get_ctrl_fields_async(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_DIGITAL_WINDOW], out, req_code,
+                                   cb, user_ptr);
+}
 
-  if (ret == sizeof(data))
-    return UVC_SUCCESS;
-  else
-    return ret;
+
+/** @ingroup ctrl
+ * @brief Sets the DIGITAL_WINDOW control without waiting for it to complete.
+ *
+ * @p cb is called with UVC_SUCCESS once the value has been sent. See
+ * uvc_set_ctrl_async().
+ * @param devh UVC device handle
+ * @param window_top TODO
+ * @param window_left TODO
+ * @param window_bottom TODO
+ * @param window_right TODO
+ * @param num_steps TODO
+ * @param num_steps_units TODO
+ * @param cb Completion callback, or NULL
+ * @param user_ptr Passed to @p cb
+ */
+uvc_error_t uvc_set_digital_window_async(uvc_device_handle_t *devh, uint16_t window_top, uint16_t window_left, uint16_t window_bottom, uint16_t window_right, uint16_t num_steps, uint16_t num_steps_units, uvc_ctrl_callback_t *cb, void *user_ptr) {
+  const int64_t values[] = { window_top, window_left, window_bottom, window_right, num_steps, num_steps_units };
+
+  return uvc_set_ctrl_fields_async(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_DIGITAL_WINDOW], values,
+                                   cb, user_ptr);
 }
 
 /** @ingroup ctrl
@@ -1114,28 +1244,9 @@ uvc_error_t uvc_set_digital_window(uvc_device_handle_t *devh, uint16_t window_to
  * @param req_code UVC_GET_* request to execute
  */
 uvc_error_t uvc_get_digital_roi(uvc_device_handle_t *devh, uint16_t* roi_top, uint16_t* roi_left, uint16_t* roi_bottom, uint16_t* roi_right, uint16_t* auto_controls, enum uvc_req_code req_code) {
-  uint8_t data[10];
-  uvc_error_t ret;
-
-  ret = libusb_control_transfer(
-    devh->usb_devh,
-    REQ_TYPE_GET, req_code,
-    UVC_CT_REGION_OF_INTEREST_CONTROL << 8,
-    uvc_get_camera_terminal(devh)->bTerminalID << 8 | devh->info->ctrl_if.bInterfaceNumber,
-    data,
-    sizeof(data),
-    0);
+  void *out[] = { roi_top, roi_left, roi_bottom, roi_right, auto_controls };
 
-  if (ret == sizeof(data)) {
-    *roi_top = SW_TO_SHORT(data + 0);
-    *roi_left = SW_TO_SHORT(data + 2);
-    *roi_bottom = SW_TO_SHORT(data + 4);
-    *roi_right = SW_TO_SHORT(data + 6);
-    *auto_controls = SW_TO_SHORT(data + 8);
-    return UVC_SUCCESS;
-  } else {
-    return ret;
-  }
+  return uvc_get_ctrl_fields(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_DIGITAL_ROI], out, req_code);
 }
 
 
@@ -1149,28 +1260,54 @@ uvc_error_t uvc_get_digital_roi(uvc_device_handle_t *devh, uint16_t* roi_top, ui
  * @param auto_controls TODO
  */
 uvc_error_t uvc_set_digital_roi(uvc_device_handle_t *devh, uint16_t roi_top, uint16_t roi_left, uint16_t roi_bottom, uint16_t roi_right, uint16_t auto_controls) {
-  uint8_t data[10];
-  uvc_error_t ret;
+  const int64_t values[] = { roi_top, roi_left, roi_bottom, roi_right, auto_controls };
 
-  SHORT_TO_SW(roi_top, data + 0);
-  SHORT_TO_SW(roi_left, data + 2);
-  SHORT_TO_SW(roi_bottom, data + 4);
-  SHORT_TO_SW(roi_right, data + 6);
-  SHORT_TO_SW(auto_controls, data + 8);
+  return uvc_set_ctrl_fields(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_DIGITAL_ROI], values);
+}
 
-  ret = libusb_control_transfer(
-    devh->usb_devh,
-    REQ_TYPE_SET, UVC_SET_CUR,
-    UVC_CT_REGION_OF_INTEREST_CONTROL << 8,
-    uvc_get_camera_terminal(devh)->bTerminalID << 8 | devh->info->ctrl_if.bInterfaceNumber,
-    data,
-    sizeof(data),
-    0);
 
-  if (ret == sizeof(data))
-    return UVC_SUCCESS;
-  else
-    return ret;
+/** @ingroup ctrl
+ * @brief Reads the REGION_OF_INTEREST control without waiting for the answer.
+ *
+ * The fields are filled in just before @p cb is called with UVC_SUCCESS;
+ * they must stay valid until then. See uvc_get_ctrl_async().
+ * @param devh UVC device handle
+ * @param[out] roi_top TODO
+ * @param[out] roi_left TODO
+ * @param[out] roi_bottom TODO
+ * @param[out] roi_right TODO
+ * @param[out] auto_controls TODO
+ * @param req_code UVC_GET_* request to execute
+ * @param cb Completion callback, or NULL
+ * @param user_ptr Passed to @p cb
+ */
+uvc_error_t uvc_get_digital_roi_async(uvc_device_handle_t *devh, uint16_t* roi_top, uint16_t* roi_left, uint16_t* roi_bottom, uint16_t* roi_right, uint16_t* auto_controls, enum uvc_req_code req_code, uvc_ctrl_callback_t *cb, void *user_ptr) {
+  void *out[] = { roi_top, roi_left, roi_bottom, roi_right, auto_controls };
+
+  return uvc_get_ctrl_fields_async(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_DIGITAL_ROI], out, req_code,
+                                   cb, user_ptr);
+}
+
+
+/** @ingroup ctrl
+ * @brief Sets the REGION_OF_INTEREST control without waiting for it to complete.
+ *
+ * @p cb is called with UVC_SUCCESS once the value has been sent. See
+ * uvc_set_ctrl_async().
+ * @param devh UVC device handle
+ * @param roi_top TODO
+ * @param roi_left TODO
+ * @param roi_bottom TODO
+ * @param roi_right TODO
+ * @param auto_controls TODO
+ * @param cb Completion callback, or NULL
+ * @param user_ptr Passed to @p cb
+ */
+uvc_error_t uvc_set_digital_roi_async(uvc_device_handle_t *devh, uint16_t roi_top, uint16_t roi_left, uint16_t roi_bottom, uint16_t roi_right, uint16_t auto_controls, uvc_ctrl_callback_t *cb, void *user_ptr) {
+  const int64_t values[] = { roi_top, roi_left, roi_bottom, roi_right, auto_controls };
+
+  return uvc_set_ctrl_fields_async(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_DIGITAL_ROI], values,
+                                   cb, user_ptr);
 }
 
 /** @ingroup ctrl
@@ -1180,24 +1317,9 @@ uvc_error_t uvc_set_digital_roi(uvc_device_handle_t *devh, uint16_t roi_top, uin
  * @param req_code UVC_GET_* request to execute
  */
 uvc_error_t uvc_get_backlight_compensation(uvc_device_handle_t *devh, uint16_t* backlight_compensation, enum uvc_req_code req_code) {
-  uint8_t data[2];
-  uvc_error_t ret;
-
-  ret = libusb_control_transfer(
-    devh->usb_devh,
-    REQ_TYPE_GET, req_code,
-    UVC_PU_BACKLIGHT_COMPENSATION_CONTROL << 8,
-    uvc_get_processing_units(devh)->bUnitID << 8 | devh->info->ctrl_if.bInterfaceNumber,
-    data,
-    sizeof(data),
-    0);
+  void *out[] = { backlight_compensation };
 
-  if (ret == sizeof(data)) {
-    *backlight_compensation = SW_TO_SHORT(data + 0);
-    return UVC_SUCCESS;
-  } else {
-    return ret;
-  }
+  return uvc_get_ctrl_fields(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_BACKLIGHT_COMPENSATION], out, req_code);
 }
 
 
@@ -1207,24 +1329,46 @@ uvc_error_t uvc_get_backlight_compensation(uvc_device_handle_t *devh, uint16_t*
  * @param backlight_compensation device-dependent backlight compensation mode; zero means backlight compensation is disabled
  */
 uvc_error_t uvc_set_backlight_compensation(uvc_device_handle_t *devh, uint16_t backlight_compensation) {
-  uint8_t data[2];
-  uvc_error_t ret;
+  const int64_t values[] = { backlight_compensation };
+
+  return uvc_set_ctrl_fields(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_BACKLIGHT_COMPENSATION], values);
+}
+
+
+/** @ingroup ctrl
+ * @brief Reads the BACKLIGHT_COMPENSATION control without waiting for the answer.
+ *
+ * The fields are filled in just before @p cb is called with UVC_SUCCESS;
+ * they must stay valid until then. See uvc_get_ctrl_async().
+ * @param devh UVC device handle
+ * @param[out] backlight_compensation device-dependent backlight compensation mode; zero means backlight compensation is disabled
+ * @param req_code UVC_GET_* request to execute
+ * @param cb Completion callback, or NULL
+ * @param user_ptr Passed to @p cb
+ */
+uvc_error_t uvc_get_backlight_compensation_async(uvc_device_handle_t *devh, uint16_t* backlight_compensation, enum uvc_req_code req_code, uvc_ctrl_callback_t *cb, void *user_ptr) {
+  void *out[] = { backlight_compensation };
 
-  SHORT_TO_SW(backlight_compensation, data + 0);
+  return uvc_get_ctrl_fields_async(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_BACKLIGHT_COMPENSATION], out, req_code,
+                                   cb, user_ptr);
+}
 
-  ret = libusb_control_transfer(
-    devh->usb_devh,
-    REQ_TYPE_SET, UVC_SET_CUR,
-    UVC_PU_BACKLIGHT_COMPENSATION_CONTROL << 8,
-    uvc_get_processing_units(devh)->bUnitID << 8 | devh->info->ctrl_if.bInterfaceNumber,
-    data,
-    sizeof(data),
-    0);
 
-  if (ret == sizeof(data))
-    return UVC_SUCCESS;
-  else
-    return ret;
+/** @ingroup ctrl
+ * @brief Sets the BACKLIGHT_COMPENSATION control without waiting for it to complete.
+ *
+ * @p cb is called with UVC_SUCCESS once the value has been sent. See
+ * uvc_set_ctrl_async().
+ * @param devh UVC device handle
+ * @param backlight_compensation device-dependent backlight compensation mode; zero means backlight compensation is disabled
+ * @param cb Completion callback, or NULL
+ * @param user_ptr Passed to @p cb
+ */
+uvc_error_t uvc_set_backlight_compensation_async(uvc_device_handle_t *devh, uint16_t backlight_compensation, uvc_ctrl_callback_t *cb, void *user_ptr) {
+  const int64_t values[] = { backlight_compensation };
+
+  return uvc_set_ctrl_fields_async(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_BACKLIGHT_COMPENSATION], values,
+                                   cb, user_ptr);
 }
 
 /** @ingroup ctrl
@@ -1234,24 +1378,9 @@ uvc_error_t uvc_set_backlight_compensation(uvc_device_handle_t *devh, uint16_t b
  * @param req_code UVC_GET_* request to execute
  */
 uvc_error_t uvc_get_brightness(uvc_device_handle_t *devh, int16_t* brightness, enum uvc_req_code req_code) {
-  uint8_t data[2];
-  uvc_error_t ret;
+  void *out[] = { brightness };
 
-  ret = libusb_control_transfer(
-    devh->usb_devh,
-    REQ_TYPE_GET, req_code,
-    UVC_PU_BRIGHTNESS_CONTROL << 8,
-    uvc_get_processing_units(devh)->bUnitID << 8 | devh->info->ctrl_if.bInterfaceNumber,
-    data,
-    sizeof(data),
-    0);
-
-  if (ret == sizeof(data)) {
-    *brightness = SW_TO_SHORT(data + 0);
-    return UVC_SUCCESS;
-  } else {
-    return ret;
-  }
+  return uvc_get_ctrl_fields(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_BRIGHTNESS], out, req_code);
 }
 
 
@@ -1261,24 +1390,46 @@ uvc_error_t uvc_get_brightness(uvc_device_handle_t *devh, int16_t* brightness, e
  * @param brightness TODO
  */
 uvc_error_t uvc_set_brightness(uvc_device_handle_t *devh, int16_t brightness) {
-  uint8_t data[2];
-  uvc_error_t ret;
+  const int64_t values[] = { brightness };
 
-  SHORT_TO_SW(brightness, data + 0);
+  return uvc_set_ctrl_fields(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_BRIGHTNESS], values);
+}
 
-  ret = libusb_control_transfer(
-    devh->usb_devh,
-    REQ_TYPE_SET, UVC_SET_CUR,
-    UVC_PU_BRIGHTNESS_CONTROL << 8,
-    uvc_get_processing_units(devh)->bUnitID << 8 | devh->info->ctrl_if.bInterfaceNumber,
-    data,
-    sizeof(data),
-    0);
 
-  if (ret == sizeof(data))
-    return UVC_SUCCESS;
-  else
-    return ret;
+/** @ingroup ctrl
+ * @brief Reads the BRIGHTNESS control without waiting for the answer.
+ *
+ * The fields are filled in just before @p cb is called with UVC_SUCCESS;
+ * they must stay valid until then. See uvc_get_ctrl_async().
+ * @param devh UVC device handle
+ * @param[out] brightness TODO
+ * @param req_code UVC_GET_* request to execute
+ * @param cb Completion callback, or NULL
+ * @param user_ptr Passed to @p cb
+ */
+uvc_error_t uvc_get_brightness_async(uvc_device_handle_t *devh, int16_t* brightness, enum uvc_req_code req_code, uvc_ctrl_callback_t *cb, void *user_ptr) {
+  void *out[] = { brightness };
+
+  return uvc_get_ctrl_fields_async(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_BRIGHTNESS], out, req_code,
+                                   cb, user_ptr);
+}
+
+
+/** @ingroup ctrl
+ * @brief Sets the BRIGHTNESS control without waiting for it to complete.
+ *
+ * @p cb is called with UVC_SUCCESS once the value has been sent. See
+ * uvc_set_ctrl_async().
+ * @param devh UVC device handle
+ * @param brightness TODO
+ * @param cb Completion callback, or NULL
+ * @param user_ptr Passed to @p cb
+ */
+uvc_error_t uvc_set_brightness_async(uvc_device_handle_t *devh, int16_t brightness, uvc_ctrl_callback_t *cb, void *user_ptr) {
+  const int64_t values[] = { brightness };
+
+  return uvc_set_ctrl_fields_async(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_BRIGHTNESS], values,
+                                   cb, user_ptr);
 }
 
 /** @ingroup ctrl
@@ -1288,24 +1439,9 @@ uvc_error_t uvc_set_brightness(uvc_device_handle_t *devh, int16_t brightness) {
  * @param req_code UVC_GET_* request to execute
  */
 uvc_error_t uvc_get_contrast(uvc_device_handle_t *devh, uint16_t* contrast, enum uvc_req_code req_code) {
-  uint8_t data[2];
-  uvc_error_t ret;
-
-  ret = libusb_control_transfer(
-    devh->usb_devh,
-    REQ_TYPE_GET, req_code,
-    UVC_PU_CONTRAST_CONTROL << 8,
-    uvc_get_processing_units(devh)->bUnitID << 8 | devh->info->ctrl_if.bInterfaceNumber,
-    data,
-    sizeof(data),
-    0);
+  void *out[] = { contrast };
 
-  if (ret == sizeof(data)) {
-    *contrast = SW_TO_SHORT(data + 0);
-    return UVC_SUCCESS;
-  } else {
-    return ret;
-  }
+  return uvc_get_ctrl_fields(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_CONTRAST], out, req_code);
 }
 
 
@@ -1315,24 +1451,46 @@ uvc_error_t uvc_get_contrast(uvc_device_handle_t *devh, uint16_t* contrast, enum
  * @param contrast TODO
  */
 uvc_error_t uvc_set_contrast(uvc_device_handle_t *devh, uint16_t contrast) {
-  uint8_t data[2];
-  uvc_error_t ret;
+  const int64_t values[] = { contrast };
 
-  SHORT_TO_SW(contrast, data + 0);
+  return uvc_set_ctrl_fields(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_CONTRAST], values);
+}
 
-  ret = libusb_control_transfer(
-    devh->usb_devh,
-    REQ_TYPE_SET, UVC_SET_CUR,
-    UVC_PU_CONTRAST_CONTROL << 8,
-    uvc_get_processing_units(devh)->bUnitID << 8 | devh->info->ctrl_if.bInterfaceNumber,
-    data,
-    sizeof(data),
-    0);
 
-  if (ret == sizeof(data))
-    return UVC_SUCCESS;
-  else
-    return ret;
+/** @ingroup ctrl
+ * @brief Reads the CONTRAST control without waiting for the answer.
+ *
+ * The fields are filled in just before @p cb is called with UVC_SUCCESS;
+ * they must stay valid until then. See uvc_get_ctrl_async().
+ * @param devh UVC device handle
+ * @param[out] contrast TODO
+ * @param req_code UVC_GET_* request to execute
+ * @param cb Completion callback, or NULL
+ * @param user_ptr Passed to @p cb
+ */
+uvc_error_t uvc_get_contrast_async(uvc_device_handle_t *devh, uint16_t* contrast, enum uvc_req_code req_code, uvc_ctrl_callback_t *cb, void *user_ptr) {
+  void *out[] = { contrast };
+
+  return uvc_get_ctrl_fields_async(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_CONTRAST], out, req_code,
+                                   cb, user_ptr);
+}
+
+
+/** @ingroup ctrl
+ * @brief Sets the CONTRAST control without waiting for it to complete.
+ *
+ * @p cb is called with UVC_SUCCESS once the value has been sent. See
+ * uvc_set_ctrl_async().
+ * @param devh UVC device handle
+ * @param contrast TODO
+ * @param cb Completion callback, or NULL
+ * @param user_ptr Passed to @p cb
+ */
+uvc_error_t uvc_set_contrast_async(uvc_device_handle_t *devh, uint16_t contrast, uvc_ctrl_callback_t *cb, void *user_ptr) {
+  const int64_t values[] = { contrast };
+
+  return uvc_set_ctrl_fields_async(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_CONTRAST], values,
+                                   cb, user_ptr);
 }
 
 /** @ingroup ctrl
@@ -1342,24 +1500,9 @@ uvc_error_t uvc_set_contrast(uvc_device_handle_t *devh, uint16_t contrast) {
  * @param req_code UVC_GET_* request to execute
  */
 uvc_error_t uvc_get_contrast_auto(uvc_device_handle_t *devh, uint8_t* contrast_auto, enum uvc_req_code req_code) {
-  uint8_t data[1];
-  uvc_error_t ret;
-
-  ret = libusb_control_transfer(
-    devh->usb_devh,
-    REQ_TYPE_GET, req_code,
-    UVC_PU_CONTRAST_AUTO_CONTROL << 8,
-    uvc_get_processing_units(devh)->bUnitID << 8 | devh->info->ctrl_if.bInterfaceNumber,
-    data,
-    sizeof(data),
-    0);
+  void *out[] = { contrast_auto };
 
-  if (ret == sizeof(data)) {
-    *contrast_auto = data[0];
-    return UVC_SUCCESS;
-  } else {
-    return ret;
-  }
+  return uvc_get_ctrl_fields(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_CONTRAST_AUTO], out, req_code);
 }
 
 
@@ -1369,24 +1512,46 @@ uvc_error_t uvc_get_contrast_auto(uvc_device_handle_t *devh, uint8_t* contrast_a
  * @param contrast_auto TODO
  */
 uvc_error_t uvc_set_contrast_auto(uvc_device_handle_t *devh, uint8_t contrast_auto) {
-  uint8_t data[1];
-  uvc_error_t ret;
+  const int64_t values[] = { contrast_auto };
+
+  return uvc_set_ctrl_fields(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_CONTRAST_AUTO], values);
+}
+
+
+/** @ingroup ctrl
+ * @brief Reads the CONTRAST_AUTO control without waiting for the answer.
+ *
+ * The fields are filled in just before @p cb is called with UVC_SUCCESS;
+ * they must stay valid until then. See uvc_get_ctrl_async().
+ * @param devh UVC device handle
+ * @param[out] contrast_auto TODO
+ * @param req_code UVC_GET_* request to execute
+ * @param cb Completion callback, or NULL
+ * @param user_ptr Passed to @p cb
+ */
+uvc_error_t uvc_get_contrast_auto_async(uvc_device_handle_t *devh, uint8_t* contrast_auto, enum uvc_req_code req_code, uvc_ctrl_callback_t *cb, void *user_ptr) {
+  void *out[] = { contrast_auto };
+
+  return uvc_get_ctrl_fields_async(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_CONTRAST_AUTO], out, req_code,
+                                   cb, user_ptr);
+}
 
-  data[0] = contrast_auto;
 
-  ret = libusb_control_transfer(
-    devh->usb_devh,
-    REQ_TYPE_SET, UVC_SET_CUR,
-    UVC_PU_CONTRAST_AUTO_CONTROL << 8,
-    uvc_get_processing_units(devh)->bUnitID << 8 | devh->info->ctrl_if.bInterfaceNumber,
-    data,
-    sizeof(data),
-    0);
+/** @ingroup ctrl
+ * @brief Sets the CONTRAST_AUTO control without waiting for it to complete.
+ *
+ * @p cb is called with UVC_SUCCESS once the value has been sent. See
+ * uvc_set_ctrl_async().
+ * @param devh UVC device handle
+ * @param contrast_auto TODO
+ * @param cb Completion callback, or NULL
+ * @param user_ptr Passed to @p cb
+ */
+uvc_error_t uvc_set_contrast_auto_async(uvc_device_handle_t *devh, uint8_t contrast_auto, uvc_ctrl_callback_t *cb, void *user_ptr) {
+  const int64_t values[] = { contrast_auto };
 
-  if (ret == sizeof(data))
-    return UVC_SUCCESS;
-  else
-    return ret;
+  return uvc_set_ctrl_fields_async(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_CONTRAST_AUTO], values,
+                                   cb, user_ptr);
 }
 
 /** @ingroup ctrl
@@ -1396,24 +1561,9 @@ uvc_error_t uvc_set_contrast_auto(uvc_device_handle_t *devh, uint8_t contrast_au
  * @param req_code UVC_GET_* request to execute
  */
 uvc_error_t uvc_get_gain(uvc_device_handle_t *devh, uint16_t* gain, enum uvc_req_code req_code) {
-  uint8_t data[2];
-  uvc_error_t ret;
+  void *out[] = { gain };
 
-  ret = libusb_control_transfer(
-    devh->usb_devh,
-    REQ_TYPE_GET, req_code,
-    UVC_PU_GAIN_CONTROL << 8,
-    uvc_get_processing_units(devh)->bUnitID << 8 | devh->info->ctrl_if.bInterfaceNumber,
-    data,
-    sizeof(data),
-    0);
-
-  if (ret == sizeof(data)) {
-    *gain = SW_TO_SHORT(data + 0);
-    return UVC_SUCCESS;
-  } else {
-    return ret;
-  }
+  return uvc_get_ctrl_fields(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_GAIN], out, req_code);
 }
 
 
@@ -1423,24 +1573,46 @@ uvc_error_t uvc_get_gain(uvc_device_handle_t *devh, uint16_t* gain, enum uvc_req
  * @param gain TODO
  */
 uvc_error_t uvc_set_gain(uvc_device_handle_t *devh, uint16_t gain) {
-  uint8_t data[2];
-  uvc_error_t ret;
+  const int64_t values[] = { gain };
+
+  return uvc_set_ctrl_fields(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_GAIN], values);
+}
 
-  SHORT_TO_SW(gain, data + 0);
 
-  ret = libusb_control_transfer(
-    devh->usb_devh,
-    REQ_TYPE_SET, UVC_SET_CUR,
-    UVC_PU_GAIN_CONTROL << 8,
-    uvc_get_processing_units(devh)->bUnitID << 8 | devh->info->ctrl_if.bInterfaceNumber,
-    data,
-    sizeof(data),
-    0);
+/** @ingroup ctrl
+ * @brief Reads the GAIN control without waiting for the answer.
+ *
+ * The fields are filled in just before @p cb is called with UVC_SUCCESS;
+ * they must stay valid until then. See uvc_get_ctrl_async().
+ * @param devh UVC device handle
+ * @param[out] gain TODO
+ * @param req_code UVC_GET_* request to execute
+ * @param cb Completion callback, or NULL
+ * @param user_ptr Passed to @p cb
+ */
+uvc_error_t uvc_get_gain_async(uvc_device_handle_t *devh, uint16_t* gain, enum uvc_req_code req_code, uvc_ctrl_callback_t *cb, void *user_ptr) {
+  void *out[] = { gain };
 
-  if (ret == sizeof(data))
-    return UVC_SUCCESS;
-  else
-    return ret;
+  return uvc_get_ctrl_fields_async(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_GAIN], out, req_code,
+                                   cb, user_ptr);
+}
+
+
+/** @ingroup ctrl
+ * @brief Sets the GAIN control without waiting for it to complete.
+ *
+ * @p cb is called with UVC_SUCCESS once the value has been sent. See
+ * uvc_set_ctrl_async().
+ * @param devh UVC device handle
+ * @param gain TODO
+ * @param cb Completion callback, or NULL
+ * @param user_ptr Passed to @p cb
+ */
+uvc_error_t uvc_set_gain_async(uvc_device_handle_t *devh, uint16_t gain, uvc_ctrl_callback_t *cb, void *user_ptr) {
+  const int64_t values[] = { gain };
+
+  return uvc_set_ctrl_fields_async(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_GAIN], values,
+                                   cb, user_ptr);
 }
 
 /** @ingroup ctrl
@@ -1450,24 +1622,9 @@ uvc_error_t uvc_set_gain(uvc_device_handle_t *devh, uint16_t gain) {
  * @param req_code UVC_GET_* request to execute
  */
 uvc_error_t uvc_get_power_line_frequency(uvc_device_handle_t *devh, uint8_t* power_line_frequency, enum uvc_req_code req_code) {
-  uint8_t data[1];
-  uvc_error_t ret;
-
-  ret = libusb_control_transfer(
-    devh->usb_devh,
-    REQ_TYPE_GET, req_code,
-    UVC_PU_POWER_LINE_FREQUENCY_CONTROL << 8,
-    uvc_get_processing_units(devh)->bUnitID << 8 | devh->info->ctrl_if.bInterfaceNumber,
-    data,
-    sizeof(data),
-    0);
+  void *out[] = { power_line_frequency };
 
-  if (ret == sizeof(data)) {
-    *power_line_frequency = data[0];
-    return UVC_SUCCESS;
-  } else {
-    return ret;
-  }
+  return uvc_get_ctrl_fields(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_POWER_LINE_FREQUENCY], out, req_code);
 }
 
 
@@ -1477,24 +1634,46 @@ uvc_error_t uvc_get_power_line_frequency(uvc_device_handle_t *devh, uint8_t* pow
  * @param power_line_frequency TODO
  */
 uvc_error_t uvc_set_power_line_frequency(uvc_device_handle_t *devh, uint8_t power_line_frequency) {
-  uint8_t data[1];
-  uvc_error_t ret;
+  const int64_t values[] = { power_line_frequency };
 
-  data[0] = power_line_frequency;
+  return uvc_set_ctrl_fields(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_POWER_LINE_FREQUENCY], values);
+}
 
-  ret = libusb_control_transfer(
-    devh->usb_devh,
-    REQ_TYPE_SET, UVC_SET_CUR,
-    UVC_PU_POWER_LINE_FREQUENCY_CONTROL << 8,
-    uvc_get_processing_units(devh)->bUnitID << 8 | devh->info->ctrl_if.bInterfaceNumber,
-    data,
-    sizeof(data),
-    0);
 
-  if (ret == sizeof(data))
-    return UVC_SUCCESS;
-  else
-    return ret;
+/** @ingroup ctrl
+ * @brief Reads the POWER_LINE_FREQUENCY control without waiting for the answer.
+ *
+ * The fields are filled in just before @p cb is called with UVC_SUCCESS;
+ * they must stay valid until then. See uvc_get_ctrl_async().
+ * @param devh UVC device handle
+ * @param[out] power_line_frequency TODO
+ * @param req_code UVC_GET_* request to execute
+ * @param cb Completion callback, or NULL
+ * @param user_ptr Passed to @p cb
+ */
+uvc_error_t uvc_get_power_line_frequency_async(uvc_device_handle_t *devh, uint8_t* power_line_frequency, enum uvc_req_code req_code, uvc_ctrl_callback_t *cb, void *user_ptr) {
+  void *out[] = { power_line_frequency };
+
+  return uvc_get_ctrl_fields_async(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_POWER_LINE_FREQUENCY], out, req_code,
+                                   cb, user_ptr);
+}
+
+
+/** @ingroup ctrl
+ * @brief Sets the POWER_LINE_FREQUENCY control without waiting for it to complete.
+ *
+ * @p cb is called with UVC_SUCCESS once the value has been sent. See
+ * uvc_set_ctrl_async().
+ * @param devh UVC device handle
+ * @param power_line_frequency TODO
+ * @param cb Completion callback, or NULL
+ * @param user_ptr Passed to @p cb
+ */
+uvc_error_t uvc_set_power_line_frequency_async(uvc_device_handle_t *devh, uint8_t power_line_frequency, uvc_ctrl_callback_t *cb, void *user_ptr) {
+  const int64_t values[] = { power_line_frequency };
+
+  return uvc_set_ctrl_fields_async(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_POWER_LINE_FREQUENCY], values,
+                                   cb, user_ptr);
 }
 
 /** @ingroup ctrl
@@ -1504,24 +1683,9 @@ uvc_error_t uvc_set_power_line_frequency(uvc_device_handle_t *devh, uint8_t powe
  * @param req_code UVC_GET_* request to execute
  */
 uvc_error_t uvc_get_hue(uvc_device_handle_t *devh, int16_t* hue, enum uvc_req_code req_code) {
-  uint8_t data[2];
-  uvc_error_t ret;
-
-  ret = libusb_control_transfer(
-    devh->usb_devh,
-    REQ_TYPE_GET, req_code,
-    UVC_PU_HUE_CONTROL << 8,
-    uvc_get_processing_units(devh)->bUnitID << 8 | devh->info->ctrl_if.bInterfaceNumber,
-    data,
-    sizeof(data),
-    0);
+  void *out[] = { hue };
 
-  if (ret == sizeof(data)) {
-    *hue = SW_TO_SHORT(data + 0);
-    return UVC_SUCCESS;
-  } else {
-    return ret;
-  }
+  return uvc_get_ctrl_fields(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_HUE], out, req_code);
 }
 
 
@@ -1531,24 +1695,46 @@ uvc_error_t uvc_get_hue(uvc_device_handle_t *devh, int16_t* hue, enum uvc_req_co
  * @param hue TODO
  */
 uvc_error_t uvc_set_hue(uvc_device_handle_t *devh, int16_t hue) {
-  uint8_t data[2];
-  uvc_error_t ret;
+  const int64_t values[] = { hue };
+
+  return uvc_set_ctrl_fields(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_HUE], values);
+}
+
 
-  SHORT_TO_SW(hue, data + 0);
+/** @ingroup ctrl
+ * @brief Reads the HUE control without waiting for the answer.
+ *
+ * The fields are filled in just before @p cb is called with UVC_SUCCESS;
+ * they must stay valid until then. See uvc_get_ctrl_async().
+ * @param devh UVC device handle
+ * @param[out] hue TODO
+ * @param req_code UVC_GET_* request to execute
+ * @param cb Completion callback, or NULL
+ * @param user_ptr Passed to @p cb
+ */
+uvc_error_t uvc_get_hue_async(uvc_device_handle_t *devh, int16_t* hue, enum uvc_req_code req_code, uvc_ctrl_callback_t *cb, void *user_ptr) {
+  void *out[] = { hue };
+
+  return uvc_get_ctrl_fields_async(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_HUE], out, req_code,
+                                   cb, user_ptr);
+}
 
-  ret = libusb_control_transfer(
-    devh->usb_devh,
-    REQ_TYPE_SET, UVC_SET_CUR,
-    UVC_PU_HUE_CONTROL << 8,
-    uvc_get_processing_units(devh)->bUnitID << 8 | devh->info->ctrl_if.bInterfaceNumber,
-    data,
-    sizeof(data),
-    0);
 
-  if (ret == sizeof(data))
-    return UVC_SUCCESS;
-  else
-    return ret;
+/** @ingroup ctrl
+ * @brief Sets the HUE control without waiting for it to complete.
+ *
+ * @p cb is called with UVC_SUCCESS once the value has been sent. See
+ * uvc_set_ctrl_async().
+ * @param devh UVC device handle
+ * @param hue TODO
+ * @param cb Completion callback, or NULL
+ * @param user_ptr Passed to @p cb
+ */
+uvc_error_t uvc_set_hue_async(uvc_device_handle_t *devh, int16_t hue, uvc_ctrl_callback_t *cb, void *user_ptr) {
+  const int64_t values[] = { hue };
+
+  return uvc_set_ctrl_fields_async(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_HUE], values,
+                                   cb, user_ptr);
 }
 
 /** @ingroup ctrl
@@ -1558,24 +1744,9 @@ uvc_error_t uvc_set_hue(uvc_device_handle_t *devh, int16_t hue) {
  * @param req_code UVC_GET_* request to execute
  */
 uvc_error_t uvc_get_hue_auto(uvc_device_handle_t *devh, uint8_t* hue_auto, enum uvc_req_code req_code) {
-  uint8_t data[1];
-  uvc_error_t ret;
-
-  ret = libusb_control_transfer(
-    devh->usb_devh,
-    REQ_TYPE_GET, req_code,
-    UVC_PU_HUE_AUTO_CONTROL << 8,
-    uvc_get_processing_units(devh)->bUnitID << 8 | devh->info->ctrl_if.bInterfaceNumber,
-    data,
-    sizeof(data),
-    0);
+  void *out[] = { hue_auto };
 
-  if (ret == sizeof(data)) {
-    *hue_auto = data[0];
-    return UVC_SUCCESS;
-  } else {
-    return ret;
-  }
+  return uvc_get_ctrl_fields(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_HUE_AUTO], out, req_code);
 }
 
 
@@ -1585,24 +1756,46 @@ uvc_error_t uvc_get_hue_auto(uvc_device_handle_t *devh, uint8_t* hue_auto, enum
  * @param hue_auto TODO
  */
 uvc_error_t uvc_set_hue_auto(uvc_device_handle_t *devh, uint8_t hue_auto) {
-  uint8_t data[1];
-  uvc_error_t ret;
+  const int64_t values[] = { hue_auto };
+
+  return uvc_set_ctrl_fields(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_HUE_AUTO], values);
+}
 
-  data[0] = hue_auto;
 
-  ret = libusb_control_transfer(
-    devh->usb_devh,
-    REQ_TYPE_SET, UVC_SET_CUR,
-    UVC_PU_HUE_AUTO_CONTROL << 8,
-    uvc_get_processing_units(devh)->bUnitID << 8 | devh->info->ctrl_if.bInterfaceNumber,
-    data,
-    sizeof(data),
-    0);
+/** @ingroup ctrl
+ * @brief Reads the HUE_AUTO control without waiting for the answer.
+ *
+ * The fields are filled in just before @p cb is called with UVC_SUCCESS;
+ * they must stay valid until then. See uvc_get_ctrl_async().
+ * @param devh UVC device handle
+ * @param[out] hue_auto TODO
+ * @param req_code UVC_GET_* request to execute
+ * @param cb Completion callback, or NULL
+ * @param user_ptr Passed to @p cb
+ */
+uvc_error_t uvc_get_hue_auto_async(uvc_device_handle_t *devh, uint8_t* hue_auto, enum uvc_req_code req_code, uvc_ctrl_callback_t *cb, void *user_ptr) {
+  void *out[] = { hue_auto };
 
-  if (ret == sizeof(data))
-    return UVC_SUCCESS;
-  else
-    return ret;
+  return uvc_get_ctrl_fields_async(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_HUE_AUTO], out, req_code,
+                                   cb, user_ptr);
+}
+
+
+/** @ingroup ctrl
+ * @brief Sets the HUE_AUTO control without waiting for it to complete.
+ *
+ * @p cb is called with UVC_SUCCESS once the value has been sent. See
+ * uvc_set_ctrl_async().
+ * @param devh UVC device handle
+ * @param hue_auto TODO
+ * @param cb Completion callback, or NULL
+ * @param user_ptr Passed to @p cb
+ */
+uvc_error_t uvc_set_hue_auto_async(uvc_device_handle_t *devh, uint8_t hue_auto, uvc_ctrl_callback_t *cb, void *user_ptr) {
+  const int64_t values[] = { hue_auto };
+
+  return uvc_set_ctrl_fields_async(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_HUE_AUTO], values,
+                                   cb, user_ptr);
 }
 
 /** @ingroup ctrl
@@ -1612,24 +1805,9 @@ uvc_error_t uvc_set_hue_auto(uvc_device_handle_t *devh, uint8_t hue_auto) {
  * @param req_code UVC_GET_* request to execute
  */
 uvc_error_t uvc_get_saturation(uvc_device_handle_t *devh, uint16_t* saturation, enum uvc_req_code req_code) {
-  uint8_t data[2];
-  uvc_error_t ret;
-
-  ret = libusb_control_transfer(
-    devh->usb_devh,
-    REQ_TYPE_GET, req_code,
-    UVC_PU_SATURATION_CONTROL << 8,
-    uvc_get_processing_units(devh)->bUnitID << 8 | devh->info->ctrl_if.bInterfaceNumber,
-    data,
-    sizeof(data),
-    0);
+  void *out[] = { saturation };
 
-  if (ret == sizeof(data)) {
-    *saturation = SW_TO_SHORT(data + 0);
-    return UVC_SUCCESS;
-  } else {
-    return ret;
-  }
+  return uvc_get_ctrl_fields(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_SATURATION], out, req_code);
 }
 
 
@@ -1639,24 +1817,46 @@ uvc_error_t uvc_get_saturation(uvc_device_handle_t *devh, uint16_t* saturation,
  * @param saturation TODO
  */
 uvc_error_t uvc_set_saturation(uvc_device_handle_t *devh, uint16_t saturation) {
-  uint8_t data[2];
-  uvc_error_t ret;
+  const int64_t values[] = { saturation };
 
-  SHORT_TO_SW(saturation, data + 0);
+  return uvc_set_ctrl_fields(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_SATURATION], values);
+}
 
-  ret = libusb_control_transfer(
-    devh->usb_devh,
-    REQ_TYPE_SET, UVC_SET_CUR,
-    UVC_PU_SATURATION_CONTROL << 8,
-    uvc_get_processing_units(devh)->bUnitID << 8 | devh->info->ctrl_if.bInterfaceNumber,
-    data,
-    sizeof(data),
-    0);
 
-  if (ret == sizeof(data))
-    return UVC_SUCCESS;
-  else
-    return ret;
+/** @ingroup ctrl
+ * @brief Reads the SATURATION control without waiting for the answer.
+ *
+ * The fields are filled in just before @p cb is called with UVC_SUCCESS;
+ * they must stay valid until then. See uvc_get_ctrl_async().
+ * @param devh UVC device handle
+ * @param[out] saturation TODO
+ * @param req_code UVC_GET_* request to execute
+ * @param cb Completion callback, or NULL
+ * @param user_ptr Passed to @p cb
+ */
+uvc_error_t uvc_get_saturation_async(uvc_device_handle_t *devh, uint16_t* saturation, enum uvc_req_code req_code, uvc_ctrl_callback_t *cb, void *user_ptr) {
+  void *out[] = { saturation };
+
+  return uvc_get_ctrl_fields_async(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_SATURATION], out, req_code,
+                                   cb, user_ptr);
+}
+
+
+/** @ingroup ctrl
+ * @brief Sets the SATURATION control without waiting for it to complete.
+ *
+ * @p cb is called with UVC_SUCCESS once the value has been sent. See
+ * uvc_set_ctrl_async().
+ * @param devh UVC device handle
+ * @param saturation TODO
+ * @param cb Completion callback, or NULL
+ * @param user_ptr Passed to @p cb
+ */
+uvc_error_t uvc_set_saturation_async(uvc_device_handle_t *devh, uint16_t saturation, uvc_ctrl_callback_t *cb, void *user_ptr) {
+  const int64_t values[] = { saturation };
+
+  return uvc_set_ctrl_fields_async(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_SATURATION], values,
+                                   cb, user_ptr);
 }
 
 /** @ingroup ctrl
@@ -1666,24 +1866,9 @@ uvc_error_t uvc_set_saturation(uvc_device_handle_t *devh, uint16_t saturation) {
  * @param req_code UVC_GET_* request to execute
  */
 uvc_error_t uvc_get_sharpness(uvc_device_handle_t *devh, uint16_t* sharpness, enum uvc_req_code req_code) {
-  uint8_t data[2];
-  uvc_error_t ret;
+  void *out[] = { sharpness };
 
-  ret = libusb_control_transfer(
-    devh->usb_devh,
-    REQ_TYPE_GET, req_code,
-    UVC_PU_SHARPNESS_CONTROL << 8,
-    uvc_get_processing_units(devh)->bUnitID << 8 | devh->info->ctrl_if.bInterfaceNumber,
-    data,
-    sizeof(data),
-    0);
-
-  if (ret == sizeof(data)) {
-    *sharpness = SW_TO_SHORT(data + 0);
-    return UVC_SUCCESS;
-  } else {
-    return ret;
-  }
+  return uvc_get_ctrl_fields(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_SHARPNESS], out, req_code);
 }
 
 
@@ -1693,24 +1878,46 @@ uvc_error_t uvc_get_sharpness(uvc_device_handle_t *devh, uint16_t* sharpness, en
  * @param sharpness TODO
  */
 uvc_error_t uvc_set_sharpness(uvc_device_handle_t *devh, uint16_t sharpness) {
-  uint8_t data[2];
-  uvc_error_t ret;
+  const int64_t values[] = { sharpness };
+
+  return uvc_set_ctrl_fields(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_SHARPNESS], values);
+}
+
+
+/** @ingroup ctrl
+ * @brief Reads the SHARPNESS control without waiting for the answer.
+ *
+ * The fields are filled in just before @p cb is called with UVC_SUCCESS;
+ * they must stay valid until then. See uvc_get_ctrl_async().
+ * @param devh UVC device handle
+ * @param[out] sharpness TODO
+ * @param req_code UVC_GET_* request to execute
+ * @param cb Completion callback, or NULL
+ * @param user_ptr Passed to @p cb
+ */
+uvc_error_t uvc_get_sharpness_async(uvc_device_handle_t *devh, uint16_t* sharpness, enum uvc_req_code req_code, uvc_ctrl_callback_t *cb, void *user_ptr) {
+  void *out[] = { sharpness };
+
+  return uvc_get_ctrl_fields_async(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_SHARPNESS], out, req_code,
+                                   cb, user_ptr);
+}
 
-  SHORT_TO_SW(sharpness, data + 0);
 
-  ret = libusb_control_transfer(
-    devh->usb_devh,
-    REQ_TYPE_SET, UVC_SET_CUR,
-    UVC_PU_SHARPNESS_CONTROL << 8,
-    uvc_get_processing_units(devh)->bUnitID << 8 | devh->info->ctrl_if.bInterfaceNumber,
-    data,
-    sizeof(data),
-    0);
+/** @ingroup ctrl
+ * @brief Sets the SHARPNESS control without waiting for it to complete.
+ *
+ * @p cb is called with UVC_SUCCESS once the value has been sent. See
+ * uvc_set_ctrl_async().
+ * @param devh UVC device handle
+ * @param sharpness TODO
+ * @param cb Completion callback, or NULL
+ * @param user_ptr Passed to @p cb
+ */
+uvc_error_t uvc_set_sharpness_async(uvc_device_handle_t *devh, uint16_t sharpness, uvc_ctrl_callback_t *cb, void *user_ptr) {
+  const int64_t values[] = { sharpness };
 
-  if (ret == sizeof(data))
-    return UVC_SUCCESS;
-  else
-    return ret;
+  return uvc_set_ctrl_fields_async(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_SHARPNESS], values,
+                                   cb, user_ptr);
 }
 
 /** @ingroup ctrl
@@ -1720,24 +1927,9 @@ uvc_error_t uvc_set_sharpness(uvc_device_handle_t *devh, uint16_t sharpness) {
  * @param req_code UVC_GET_* request to execute
  */
 uvc_error_t uvc_get_gamma(uvc_device_handle_t *devh, uint16_t* gamma, enum uvc_req_code req_code) {
-  uint8_t data[2];
-  uvc_error_t ret;
+  void *out[] = { gamma };
 
-  ret = libusb_control_transfer(
-    devh->usb_devh,
-    REQ_TYPE_GET, req_code,
-    UVC_PU_GAMMA_CONTROL << 8,
-    uvc_get_processing_units(devh)->bUnitID << 8 | devh->info->ctrl_if.bInterfaceNumber,
-    data,
-    sizeof(data),
-    0);
-
-  if (ret == sizeof(data)) {
-    *gamma = SW_TO_SHORT(data + 0);
-    return UVC_SUCCESS;
-  } else {
-    return ret;
-  }
+  return uvc_get_ctrl_fields(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_GAMMA], out, req_code);
 }
 
 
@@ -1747,24 +1939,46 @@ uvc_error_t uvc_get_gamma(uvc_device_handle_t *devh, uint16_t* gamma, enum uvc_r
  * @param gamma TODO
  */
 uvc_error_t uvc_set_gamma(uvc_device_handle_t *devh, uint16_t gamma) {
-  uint8_t data[2];
-  uvc_error_t ret;
+  const int64_t values[] = { gamma };
+
+  return uvc_set_ctrl_fields(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_GAMMA], values);
+}
+
+
+/** @ingroup ctrl
+ * @brief Reads the GAMMA control without waiting for the answer.
+ *
+ * The fields are filled in just before @p cb is called with UVC_SUCCESS;
+ * they must stay valid until then. See uvc_get_ctrl_async().
+ * @param devh UVC device handle
+ * @param[out] gamma TODO
+ * @param req_code UVC_GET_* request to execute
+ * @param cb Completion callback, or NULL
+ * @param user_ptr Passed to @p cb
+ */
+uvc_error_t uvc_get_gamma_async(uvc_device_handle_t *devh, uint16_t* gamma, enum uvc_req_code req_code, uvc_ctrl_callback_t *cb, void *user_ptr) {
+  void *out[] = { gamma };
+
+  return uvc_get_ctrl_fields_async(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_GAMMA], out, req_code,
+                                   cb, user_ptr);
+}
 
-  SHORT_TO_SW(gamma, data + 0);
 
-  ret = libusb_control_transfer(
-    devh->usb_devh,
-    REQ_TYPE_SET, UVC_SET_CUR,
-    UVC_PU_GAMMA_CONTROL << 8,
-    uvc_get_processing_units(devh)->bUnitID << 8 | devh->info->ctrl_if.bInterfaceNumber,
-    data,
-    sizeof(data),
-    0);
+/** @ingroup ctrl
+ * @brief Sets the GAMMA control without waiting for it to complete.
+ *
+ * @p cb is called with UVC_SUCCESS once the value has been sent. See
+ * uvc_set_ctrl_async().
+ * @param devh UVC device handle
+ * @param gamma TODO
+ * @param cb Completion callback, or NULL
+ * @param user_ptr Passed to @p cb
+ */
+uvc_error_t uvc_set_gamma_async(uvc_device_handle_t *devh, uint16_t gamma, uvc_ctrl_callback_t *cb, void *user_ptr) {
+  const int64_t values[] = { gamma };
 
-  if (ret == sizeof(data))
-    return UVC_SUCCESS;
-  else
-    return ret;
+  return uvc_set_ctrl_fields_async(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_GAMMA], values,
+                                   cb, user_ptr);
 }
 
 /** @ingroup ctrl
@@ -1774,24 +1988,9 @@ uvc_error_t uvc_set_gamma(uvc_device_handle_t *devh, uint16_t gamma) {
  * @param req_code UVC_GET_* request to execute
  */
 uvc_error_t uvc_get_white_balance_temperature(uvc_device_handle_t *devh, uint16_t* temperature, enum uvc_req_code req_code) {
-  uint8_t data[2];
-  uvc_error_t ret;
-
-  ret = libusb_control_transfer(
-    devh->usb_devh,
-    REQ_TYPE_GET, req_code,
-    UVC_PU_WHITE_BALANCE_TEMPERATURE_CONTROL << 8,
-    uvc_get_processing_units(devh)->bUnitID << 8 | devh->info->ctrl_if.bInterfaceNumber,
-    data,
-    sizeof(data),
-    0);
+  void *out[] = { temperature };
 
-  if (ret == sizeof(data)) {
-    *temperature = SW_TO_SHORT(data + 0);
-    return UVC_SUCCESS;
-  } else {
-    return ret;
-  }
+  return uvc_get_ctrl_fields(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_WHITE_BALANCE_TEMPERATURE], out, req_code);
 }
 
 
@@ -1801,24 +2000,46 @@ uvc_error_t uvc_get_white_balance_temperature(uvc_device_handle_t *devh, uint16_
  * @param temperature TODO
  */
 uvc_error_t uvc_set_white_balance_temperature(uvc_device_handle_t *devh, uint16_t temperature) {
-  uint8_t data[2];
-  uvc_error_t ret;
+  const int64_t values[] = { temperature };
 
-  SHORT_TO_SW(temperature, data + 0);
+  return uvc_set_ctrl_fields(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_WHITE_BALANCE_TEMPERATURE], values);
+}
 
-  ret = libusb_control_transfer(
-    devh->usb_devh,
-    REQ_TYPE_SET, UVC_SET_CUR,
-    UVC_PU_WHITE_BALANCE_TEMPERATURE_CONTROL << 8,
-    uvc_get_processing_units(devh)->bUnitID << 8 | devh->info->ctrl_if.bInterfaceNumber,
-    data,
-    sizeof(data),
-    0);
 
-  if (ret == sizeof(data))
-    return UVC_SUCCESS;
-  else
-    return ret;
+/** @ingroup ctrl
+ * @brief Reads the WHITE_BALANCE_TEMPERATURE control without waiting for the answer.
+ *
+ * The fields are filled in just before @p cb is called with UVC_SUCCESS;
+ * they must stay valid until then. See uvc_get_ctrl_async().
+ * @param devh UVC device handle
+ * @param[out] temperature TODO
+ * @param req_code UVC_GET_* request to execute
+ * @param cb Completion callback, or NULL
+ * @param user_ptr Passed to @p cb
+ */
+uvc_error_t uvc_get_white_balance_temperature_async(uvc_device_handle_t *devh, uint16_t* temperature, enum uvc_req_code req_code, uvc_ctrl_callback_t *cb, void *user_ptr) {
+  void *out[] = { temperature };
+
+  return uvc_get_ctrl_fields_async(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_WHITE_BALANCE_TEMPERATURE], out, req_code,
+                                   cb, user_ptr);
+}
+
+
+/** @ingroup ctrl
+ * @brief Sets the WHITE_BALANCE_TEMPERATURE control without waiting for it to complete.
+ *
+ * @p cb is called with UVC_SUCCESS once the value has been sent. See
+ * uvc_set_ctrl_async().
+ * @param devh UVC device handle
+ * @param temperature TODO
+ * @param cb Completion callback, or NULL
+ * @param user_ptr Passed to @p cb
+ */
+uvc_error_t uvc_set_white_balance_temperature_async(uvc_device_handle_t *devh, uint16_t temperature, uvc_ctrl_callback_t *cb, void *user_ptr) {
+  const int64_t values[] = { temperature };
+
+  return uvc_set_ctrl_fields_async(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_WHITE_BALANCE_TEMPERATURE], values,
+                                   cb, user_ptr);
 }
 
 /** @ingroup ctrl
@@ -1828,24 +2049,9 @@ uvc_error_t uvc_set_white_balance_temperature(uvc_device_handle_t *devh, uint16_
  * @param req_code UVC_GET_* request to execute
  */
 uvc_error_t uvc_get_white_balance_temperature_auto(uvc_device_handle_t *devh, uint8_t* temperature_auto, enum uvc_req_code req_code) {
-  uint8_t data[1];
-  uvc_error_t ret;
-
-  ret = libusb_control_transfer(
-    devh->usb_devh,
-    REQ_TYPE_GET, req_code,
-    UVC_PU_WHITE_BALANCE_TEMPERATURE_AUTO_CONTROL << 8,
-    uvc_get_processing_units(devh)->bUnitID << 8 | devh->info->ctrl_if.bInterfaceNumber,
-    data,
-    sizeof(data),
-    0);
+  void *out[] = { temperature_auto };
 
-  if (ret == sizeof(data)) {
-    *temperature_auto = data[0];
-    return UVC_SUCCESS;
-  } else {
-    return ret;
-  }
+  return uvc_get_ctrl_fields(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_WHITE_BALANCE_TEMPERATURE_AUTO], out, req_code);
 }
 
 
@@ -1855,24 +2061,46 @@ uvc_error_t uvc_get_white_balance_temperature_auto(uvc_device_handle_t *devh, ui
  * @param temperature_auto TODO
  */
 uvc_error_t uvc_set_white_balance_temperature_auto(uvc_device_handle_t *devh, uint8_t temperature_auto) {
-  uint8_t data[1];
-  uvc_error_t ret;
+  const int64_t values[] = { temperature_auto };
+
+  return uvc_set_ctrl_fields(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_WHITE_BALANCE_TEMPERATURE_AUTO], values);
+}
 
-  data[0] = temperature_auto;
 
-  ret = libusb_control_transfer(
-    devh->usb_devh,
-    REQ_TYPE_SET, UVC_SET_CUR,
-    UVC_PU_WHITE_BALANCE_TEMPERATURE_AUTO_CONTROL << 8,
-    uvc_get_processing_units(devh)->bUnitID << 8 | devh->info->ctrl_if.bInterfaceNumber,
-    data,
-    sizeof(data),
-    0);
+/** @ingroup ctrl
+ * @brief Reads the WHITE_BALANCE_TEMPERATURE_AUTO control without waiting for the answer.
+ *
+ * The fields are filled in just before @p cb is called with UVC_SUCCESS;
+ * they must stay valid until then. See uvc_get_ctrl_async().
+ * @param devh UVC device handle
+ * @param[out] temperature_auto TODO
+ * @param req_code UVC_GET_* request to execute
+ * @param cb Completion callback, or NULL
+ * @param user_ptr Passed to @p cb
+ */
+uvc_error_t uvc_get_white_balance_temperature_auto_async(uvc_device_handle_t *devh, uint8_t* temperature_auto, enum uvc_req_code req_code, uvc_ctrl_callback_t *cb, void *user_ptr) {
+  void *out[] = { temperature_auto };
+
+  return uvc_get_ctrl_fields_async(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_WHITE_BALANCE_TEMPERATURE_AUTO], out, req_code,
+                                   cb, user_ptr);
+}
+
+
+/** @ingroup ctrl
+ * @brief Sets the WHITE_BALANCE_TEMPERATURE_AUTO control without waiting for it to complete.
+ *
+ * @p cb is called with UVC_SUCCESS once the value has been sent. See
+ * uvc_set_ctrl_async().
+ * @param devh UVC device handle
+ * @param temperature_auto TODO
+ * @param cb Completion callback, or NULL
+ * @param user_ptr Passed to @p cb
+ */
+uvc_error_t uvc_set_white_balance_temperature_auto_async(uvc_device_handle_t *devh, uint8_t temperature_auto, uvc_ctrl_callback_t *cb, void *user_ptr) {
+  const int64_t values[] = { temperature_auto };
 
-  if (ret == sizeof(data))
-    return UVC_SUCCESS;
-  else
-    return ret;
+  return uvc_set_ctrl_fields_async(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_WHITE_BALANCE_TEMPERATURE_AUTO], values,
+                                   cb, user_ptr);
 }
 
 /** @ingroup ctrl
@@ -1883,25 +2111,9 @@ uvc_error_t uvc_set_white_balance_temperature_auto(uvc_device_handle_t *devh, ui
  * @param req_code UVC_GET_* request to execute
  */
 uvc_error_t uvc_get_white_balance_component(uvc_device_handle_t *devh, uint16_t* blue, uint16_t* red, enum uvc_req_code req_code) {
-  uint8_t data[4];
-  uvc_error_t ret;
+  void *out[] = { blue, red };
 
-  ret = libusb_control_transfer(
-    devh->usb_devh,
-    REQ_TYPE_GET, req_code,
-    UVC_PU_WHITE_BALANCE_COMPONENT_CONTROL << 8,
-    uvc_get_processing_units(devh)->bUnitID << 8 | devh->info->ctrl_if.bInterfaceNumber,
-    data,
-    sizeof(data),
-    0);
-
-  if (ret == sizeof(data)) {
-    *blue = SW_TO_SHORT(data + 0);
-    *red = SW_TO_SHORT(data + 2);
-    return UVC_SUCCESS;
-  } else {
-    return ret;
-  }
+  return uvc_get_ctrl_fields(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_WHITE_BALANCE_COMPONENT], out, req_code);
 }
 
 
@@ -1912,25 +2124,48 @@ uvc_error_t uvc_get_white_balance_component(uvc_device_handle_t *devh, uint16_t*
  * @param red TODO
  */
 uvc_error_t uvc_set_white_balance_component(uvc_device_handle_t *devh, uint16_t blue, uint16_t red) {
-  uint8_t data[4];
-  uvc_error_t ret;
+  const int64_t values[] = { blue, red };
+
+  return uvc_set_ctrl_fields(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_WHITE_BALANCE_COMPONENT], values);
+}
+
+
+/** @ingroup ctrl
+ * @brief Reads the WHITE_BALANCE_COMPONENT control without waiting for the answer.
+ *
+ * The fields are filled in just before @p cb is called with UVC_SUCCESS;
+ * they must stay valid until then. See uvc_get_ctrl_async().
+ * @param devh UVC device handle
+ * @param[out] blue TODO
+ * @param[out] red TODO
+ * @param req_code UVC_GET_* request to execute
+ * @param cb Completion callback, or NULL
+ * @param user_ptr Passed to @p cb
+ */
+uvc_error_t uvc_get_white_balance_component_async(uvc_device_handle_t *devh, uint16_t* blue, uint16_t* red, enum uvc_req_code req_code, uvc_ctrl_callback_t *cb, void *user_ptr) {
+  void *out[] = { blue, red };
+
+  return uvc_get_ctrl_fields_async(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_WHITE_BALANCE_COMPONENT], out, req_code,
+                                   cb, user_ptr);
+}
 
-  SHORT_TO_SW(blue, data + 0);
-  SHORT_TO_SW(red, data + 2);
 
-  ret = libusb_control_transfer(
-    devh->usb_devh,
-    REQ_TYPE_SET, UVC_SET_CUR,
-    UVC_PU_WHITE_BALANCE_COMPONENT_CONTROL << 8,
-    uvc_get_processing_units(devh)->bUnitID << 8 | devh->info->ctrl_if.bInterfaceNumber,
-    data,
-    sizeof(data),
-    0);
+/** @ingroup ctrl
+ * @brief Sets the WHITE_BALANCE_COMPONENT control without waiting for it to complete.
+ *
+ * @p cb is called with UVC_SUCCESS once the value has been sent. See
+ * uvc_set_ctrl_async().
+ * @param devh UVC device handle
+ * @param blue TODO
+ * @param red TODO
+ * @param cb Completion callback, or NULL
+ * @param user_ptr Passed to @p cb
+ */
+uvc_error_t uvc_set_white_balance_component_async(uvc_device_handle_t *devh, uint16_t blue, uint16_t red, uvc_ctrl_callback_t *cb, void *user_ptr) {
+  const int64_t values[] = { blue, red };
 
-  if (ret == sizeof(data))
-    return UVC_SUCCESS;
-  else
-    return ret;
+  return uvc_set_ctrl_fields_async(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_WHITE_BALANCE_COMPONENT], values,
+                                   cb, user_ptr);
 }
 
 /** @ingroup ctrl
@@ -1940,24 +2175,9 @@ uvc_error_t uvc_set_white_balance_component(uvc_device_handle_t *devh, uint16_t
  * @param req_code UVC_GET_* request to execute
  */
 uvc_error_t uvc_get_white_balance_component_auto(uvc_device_handle_t *devh, uint8_t* white_balance_component_auto, enum uvc_req_code req_code) {
-  uint8_t data[1];
-  uvc_error_t ret;
+  void *out[] = { white_balance_component_auto };
 
-  ret = libusb_control_transfer(
-    devh->usb_devh,
-    REQ_TYPE_GET, req_code,
-    UVC_PU_WHITE_BALANCE_COMPONENT_AUTO_CONTROL << 8,
-    uvc_get_processing_units(devh)->bUnitID << 8 | devh->info->ctrl_if.bInterfaceNumber,
-    data,
-    sizeof(data),
-    0);
-
-  if (ret == sizeof(data)) {
-    *white_balance_component_auto = data[0];
-    return UVC_SUCCESS;
-  } else {
-    return ret;
-  }
+  return uvc_get_ctrl_fields(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_WHITE_BALANCE_COMPONENT_AUTO], out, req_code);
 }
 
 
@@ -1967,24 +2187,46 @@ uvc_error_t uvc_get_white_balance_component_auto(uvc_device_handle_t *devh, uint
  * @param white_balance_component_auto TODO
  */
 uvc_error_t uvc_set_white_balance_component_auto(uvc_device_handle_t *devh, uint8_t white_balance_component_auto) {
-  uint8_t data[1];
-  uvc_error_t ret;
+  const int64_t values[] = { white_balance_component_auto };
 
-  data[0] = white_balance_component_auto;
+  return uvc_set_ctrl_fields(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_WHITE_BALANCE_COMPONENT_AUTO], values);
+}
 
-  ret = libusb_control_transfer(
-    devh->usb_devh,
-    REQ_TYPE_SET, UVC_SET_CUR,
-    UVC_PU_WHITE_BALANCE_COMPONENT_AUTO_CONTROL << 8,
-    uvc_get_processing_units(devh)->bUnitID << 8 | devh->info->ctrl_if.bInterfaceNumber,
-    data,
-    sizeof(data),
-    0);
 
-  if (ret == sizeof(data))
-    return UVC_SUCCESS;
-  else
-    return ret;
+/** @ingroup ctrl
+ * @brief Reads the WHITE_BALANCE_COMPONENT_AUTO control without waiting for the answer.
+ *
+ * The fields are filled in just before @p cb is called with UVC_SUCCESS;
+ * they must stay valid until then. See uvc_get_ctrl_async().
+ * @param devh UVC device handle
+ * @param[out] white_balance_component_auto TODO
+ * @param req_code UVC_GET_* request to execute
+ * @param cb Completion callback, or NULL
+ * @param user_ptr Passed to @p cb
+ */
+uvc_error_t uvc_get_white_balance_component_auto_async(uvc_device_handle_t *devh, uint8_t* white_balance_component_auto, enum uvc_req_code req_code, uvc_ctrl_callback_t *cb, void *user_ptr) {
+  void *out[] = { white_balance_component_auto };
+
+  return uvc_get_ctrl_fields_async(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_WHITE_BALANCE_COMPONENT_AUTO], out, req_code,
+                                   cb, user_ptr);
+}
+
+
+/** @ingroup ctrl
+ * @brief Sets the WHITE_BALANCE_COMPONENT_AUTO control without waiting for it to complete.
+ *
+ * @p cb is called with UVC_SUCCESS once the value has been sent. See
+ * uvc_set_ctrl_async().
+ * @param devh UVC device handle
+ * @param white_balance_component_auto TODO
+ * @param cb Completion callback, or NULL
+ * @param user_ptr Passed to @p cb
+ */
+uvc_error_t uvc_set_white_balance_component_auto_async(uvc_device_handle_t *devh, uint8_t white_balance_component_auto, uvc_ctrl_callback_t *cb, void *user_ptr) {
+  const int64_t values[] = { white_balance_component_auto };
+
+  return uvc_set_ctrl_fields_async(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_WHITE_BALANCE_COMPONENT_AUTO], values,
+                                   cb, user_ptr);
 }
 
 /** @ingroup ctrl
@@ -1994,24 +2236,9 @@ uvc_error_t uvc_set_white_balance_component_auto(uvc_device_handle_t *devh, uint
  * @param req_code UVC_GET_* request to execute
  */
 uvc_error_t uvc_get_digital_multiplier(uvc_device_handle_t *devh, uint16_t* multiplier_step, enum uvc_req_code req_code) {
-  uint8_t data[2];
-  uvc_error_t ret;
-
-  ret = libusb_control_transfer(
-    devh->usb_devh,
-    REQ_TYPE_GET, req_code,
-    UVC_PU_DIGITAL_MULTIPLIER_CONTROL << 8,
-    uvc_get_processing_units(devh)->bUnitID << 8 | devh->info->ctrl_if.bInterfaceNumber,
-    data,
-    sizeof(data),
-    0);
+  void *out[] = { multiplier_step };
 
-  if (ret == sizeof(data)) {
-    *multiplier_step = SW_TO_SHORT(data + 0);
-    return UVC_SUCCESS;
-  } else {
-    return ret;
-  }
+  return uvc_get_ctrl_fields(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_DIGITAL_MULTIPLIER], out, req_code);
 }
 
 
@@ -2021,24 +2248,46 @@ uvc_error_t uvc_get_digital_multiplier(uvc_device_handle_t *devh, uint16_t* mult
  * @param multiplier_step TODO
  */
 uvc_error_t uvc_set_digital_multiplier(uvc_device_handle_t *devh, uint16_t multiplier_step) {
-  uint8_t data[2];
-  uvc_error_t ret;
+  const int64_t values[] = { multiplier_step };
 
-  SHORT_TO_SW(multiplier_step, data + 0);
+  return uvc_set_ctrl_fields(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_DIGITAL_MULTIPLIER], values);
+}
 
-  ret = libusb_control_transfer(
-    devh->usb_devh,
-    REQ_TYPE_SET, UVC_SET_CUR,
-    UVC_PU_DIGITAL_MULTIPLIER_CONTROL << 8,
-    uvc_get_processing_units(devh)->bUnitID << 8 | devh->info->ctrl_if.bInterfaceNumber,
-    data,
-    sizeof(data),
-    0);
 
-  if (ret == sizeof(data))
-    return UVC_SUCCESS;
-  else
-    return ret;
+/** @ingroup ctrl
+ * @brief Reads the DIGITAL_MULTIPLIER control without waiting for the answer.
+ *
+ * The fields are filled in just before @p cb is called with UVC_SUCCESS;
+ * they must stay valid until then. See uvc_get_ctrl_async().
+ * @param devh UVC device handle
+ * @param[out] multiplier_step TODO
+ * @param req_code UVC_GET_* request to execute
+ * @param cb Completion callback, or NULL
+ * @param user_ptr Passed to @p cb
+ */
+uvc_error_t uvc_get_digital_multiplier_async(uvc_device_handle_t *devh, uint16_t* multiplier_step, enum uvc_req_code req_code, uvc_ctrl_callback_t *cb, void *user_ptr) {
+  void *out[] = { multiplier_step };
+
+  return uvc_get_ctrl_fields_async(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_DIGITAL_MULTIPLIER], out, req_code,
+                                   cb, user_ptr);
+}
+
+
+/** @ingroup ctrl
+ * @brief Sets the DIGITAL_MULTIPLIER control without waiting for it to complete.
+ *
+ * @p cb is called with UVC_SUCCESS once the value has been sent. See
+ * uvc_set_ctrl_async().
+ * @param devh UVC device handle
+ * @param multiplier_step TODO
+ * @param cb Completion callback, or NULL
+ * @param user_ptr Passed to @p cb
+ */
+uvc_error_t uvc_set_digital_multiplier_async(uvc_device_handle_t *devh, uint16_t multiplier_step, uvc_ctrl_callback_t *cb, void *user_ptr) {
+  const int64_t values[] = { multiplier_step };
+
+  return uvc_set_ctrl_fields_async(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_DIGITAL_MULTIPLIER], values,
+                                   cb, user_ptr);
 }
 
 /** @ingroup ctrl
@@ -2048,24 +2297,9 @@ uvc_error_t uvc_set_digital_multiplier(uvc_device_handle_t *devh, uint16_t multi
  * @param req_code UVC_GET_* request to execute
  */
 uvc_error_t uvc_get_digital_multiplier_limit(uvc_device_handle_t *devh, uint16_t* multiplier_step, enum uvc_req_code req_code) {
-  uint8_t data[2];
-  uvc_error_t ret;
-
-  ret = libusb_control_transfer(
-    devh->usb_devh,
-    REQ_TYPE_GET, req_code,
-    UVC_PU_DIGITAL_MULTIPLIER_LIMIT_CONTROL << 8,
-    uvc_get_processing_units(devh)->bUnitID << 8 | devh->info->ctrl_if.bInterfaceNumber,
-    data,
-    sizeof(data),
-    0);
+  void *out[] = { multiplier_step };
 
-  if (ret == sizeof(data)) {
-    *multiplier_step = SW_TO_SHORT(data + 0);
-    return UVC_SUCCESS;
-  } else {
-    return ret;
-  }
+  return uvc_get_ctrl_fields(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_DIGITAL_MULTIPLIER_LIMIT], out, req_code);
 }
 
 
@@ -2075,24 +2309,46 @@ uvc_error_t uvc_get_digital_multiplier_limit(uvc_device_handle_t *devh, uint16_t
  * @param multiplier_step TODO
  */
 uvc_error_t uvc_set_digital_multiplier_limit(uvc_device_handle_t *devh, uint16_t multiplier_step) {
-  uint8_t data[2];
-  uvc_error_t ret;
+  const int64_t values[] = { multiplier_step };
+
+  return uvc_set_ctrl_fields(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_DIGITAL_MULTIPLIER_LIMIT], values);
+}
 
-  SHORT_TO_SW(multiplier_step, data + 0);
 
-  ret = libusb_control_transfer(
-    devh->usb_devh,
-    REQ_TYPE_SET, UVC_SET_CUR,
-    UVC_PU_DIGITAL_MULTIPLIER_LIMIT_CONTROL << 8,
-    uvc_get_processing_units(devh)->bUnitID << 8 | devh->info->ctrl_if.bInterfaceNumber,
-    data,
-    sizeof(data),
-    0);
+/** @ingroup ctrl
+ * @brief Reads the DIGITAL_MULTIPLIER_LIMIT control without waiting for the answer.
+ *
+ * The fields are filled in just before @p cb is called with UVC_SUCCESS;
+ * they must stay valid until then. See uvc_get_ctrl_async().
+ * @param devh UVC device handle
+ * @param[out] multiplier_step TODO
+ * @param req_code UVC_GET_* request to execute
+ * @param cb Completion callback, or NULL
+ * @param user_ptr Passed to @p cb
+ */
+uvc_error_t uvc_get_digital_multiplier_limit_async(uvc_device_handle_t *devh, uint16_t* multiplier_step, enum uvc_req_code req_code, uvc_ctrl_callback_t *cb, void *user_ptr) {
+  void *out[] = { multiplier_step };
+
+  return uvc_get_ctrl_fields_async(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_DIGITAL_MULTIPLIER_LIMIT], out, req_code,
+                                   cb, user_ptr);
+}
+
+
+/** @ingroup ctrl
+ * @brief Sets the DIGITAL_MULTIPLIER_LIMIT control without waiting for it to complete.
+ *
+ * @p cb is called with UVC_SUCCESS once the value has been sent. See
+ * uvc_set_ctrl_async().
+ * @param devh UVC device handle
+ * @param multiplier_step TODO
+ * @param cb Completion callback, or NULL
+ * @param user_ptr Passed to @p cb
+ */
+uvc_error_t uvc_set_digital_multiplier_limit_async(uvc_device_handle_t *devh, uint16_t multiplier_step, uvc_ctrl_callback_t *cb, void *user_ptr) {
+  const int64_t values[] = { multiplier_step };
 
-  if (ret == sizeof(data))
-    return UVC_SUCCESS;
-  else
-    return ret;
+  return uvc_set_ctrl_fields_async(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_DIGITAL_MULTIPLIER_LIMIT], values,
+                                   cb, user_ptr);
 }
 
 /** @ingroup ctrl
@@ -2102,24 +2358,9 @@ uvc_error_t uvc_set_digital_multiplier_limit(uvc_device_handle_t *devh, uint16_t
  * @param req_code UVC_GET_* request to execute
  */
 uvc_error_t uvc_get_analog_video_standard(uvc_device_handle_t *devh, uint8_t* video_standard, enum uvc_req_code req_code) {
-  uint8_t data[1];
-  uvc_error_t ret;
+  void *out[] = { video_standard };
 
-  ret = libusb_control_transfer(
-    devh->usb_devh,
-    REQ_TYPE_GET, req_code,
-    UVC_PU_ANALOG_VIDEO_STANDARD_CONTROL << 8,
-    uvc_get_processing_units(devh)->bUnitID << 8 | devh->info->ctrl_if.bInterfaceNumber,
-    data,
-    sizeof(data),
-    0);
-
-  if (ret == sizeof(data)) {
-    *video_standard = data[0];
-    return UVC_SUCCESS;
-  } else {
-    return ret;
-  }
+  return uvc_get_ctrl_fields(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_ANALOG_VIDEO_STANDARD], out, req_code);
 }
 
 
@@ -2129,24 +2370,46 @@ uvc_error_t uvc_get_analog_video_standard(uvc_device_handle_t *devh, uint8_t* vi
  * @param video_standard TODO
  */
 uvc_error_t uvc_set_analog_video_standard(uvc_device_handle_t *devh, uint8_t video_standard) {
-  uint8_t data[1];
-  uvc_error_t ret;
+  const int64_t values[] = { video_standard };
 
-  data[0] = video_standard;
+  return uvc_set_ctrl_fields(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_ANALOG_VIDEO_STANDARD], values);
+}
 
-  ret = libusb_control_transfer(
-    devh->usb_devh,
-    REQ_TYPE_SET, UVC_SET_CUR,
-    UVC_PU_ANALOG_VIDEO_STANDARD_CONTROL << 8,
-    uvc_get_processing_units(devh)->bUnitID << 8 | devh->info->ctrl_if.bInterfaceNumber,
-    data,
-    sizeof(data),
-    0);
 
-  if (ret == sizeof(data))
-    return UVC_SUCCESS;
-  else
-    return ret;
+/** @ingroup ctrl
+ * @brief Reads the ANALOG_VIDEO_STANDARD control without waiting for the answer.
+ *
+ * The fields are filled in just before @p cb is called with UVC_SUCCESS;
+ * they must stay valid until then. See uvc_get_ctrl_async().
+ * @param devh UVC device handle
+ * @param[out] video_standard TODO
+ * @param req_code UVC_GET_* request to execute
+ * @param cb Completion callback, or NULL
+ * @param user_ptr Passed to @p cb
+ */
+uvc_error_t uvc_get_analog_video_standard_async(uvc_device_handle_t *devh, uint8_t* video_standard, enum uvc_req_code req_code, uvc_ctrl_callback_t *cb, void *user_ptr) {
+  void *out[] = { video_standard };
+
+  return uvc_get_ctrl_fields_async(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_ANALOG_VIDEO_STANDARD], out, req_code,
+                                   cb, user_ptr);
+}
+
+
+/** @ingroup ctrl
+ * @brief Sets the ANALOG_VIDEO_STANDARD control without waiting for it to complete.
+ *
+ * @p cb is called with UVC_SUCCESS once the value has been sent. See
+ * uvc_set_ctrl_async().
+ * @param devh UVC device handle
+ * @param video_standard TODO
+ * @param cb Completion callback, or NULL
+ * @param user_ptr Passed to @p cb
+ */
+uvc_error_t uvc_set_analog_video_standard_async(uvc_device_handle_t *devh, uint8_t video_standard, uvc_ctrl_callback_t *cb, void *user_ptr) {
+  const int64_t values[] = { video_standard };
+
+  return uvc_set_ctrl_fields_async(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_ANALOG_VIDEO_STANDARD], values,
+                                   cb, user_ptr);
 }
 
 /** @ingroup ctrl
@@ -2156,24 +2419,9 @@ uvc_error_t uvc_set_analog_video_standard(uvc_device_handle_t *devh, uint8_t vid
  * @param req_code UVC_GET_* request to execute
  */
 uvc_error_t uvc_get_analog_video_lock_status(uvc_device_handle_t *devh, uint8_t* status, enum uvc_req_code req_code) {
-  uint8_t data[1];
-  uvc_error_t ret;
+  void *out[] = { status };
 
-  ret = libusb_control_transfer(
-    devh->usb_devh,
-    REQ_TYPE_GET, req_code,
-    UVC_PU_ANALOG_LOCK_STATUS_CONTROL << 8,
-    uvc_get_processing_units(devh)->bUnitID << 8 | devh->info->ctrl_if.bInterfaceNumber,
-    data,
-    sizeof(data),
-    0);
-
-  if (ret == sizeof(data)) {
-    *status = data[0];
-    return UVC_SUCCESS;
-  } else {
-    return ret;
-  }
+  return uvc_get_ctrl_fields(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_ANALOG_VIDEO_LOCK_STATUS], out, req_code);
 }
 
 
@@ -2183,24 +2431,46 @@ uvc_error_t uvc_get_analog_video_lock_status(uvc_device_handle_t *devh, uint8_t*
  * @param status TODO
  */
 uvc_error_t uvc_set_analog_video_lock_status(uvc_device_handle_t *devh, uint8_t status) {
-  uint8_t data[1];
-  uvc_error_t ret;
+  const int64_t values[] = { status };
 
-  data[0] = status;
+  return uvc_set_ctrl_fields(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_ANALOG_VIDEO_LOCK_STATUS], values);
+}
 
-  ret = libusb_control_transfer(
-    devh->usb_devh,
-    REQ_TYPE_SET, UVC_SET_CUR,
-    UVC_PU_ANALOG_LOCK_STATUS_CONTROL << 8,
-    uvc_get_processing_units(devh)->bUnitID << 8 | devh->info->ctrl_if.bInterfaceNumber,
-    data,
-    sizeof(data),
-    0);
 
-  if (ret == sizeof(data))
-    return UVC_SUCCESS;
-  else
-    return ret;
+/** @ingroup ctrl
+ * @brief Reads the ANALOG_LOCK_STATUS control without waiting for the answer.
+ *
+ * The fields are filled in just before @p cb is called with UVC_SUCCESS;
+ * they must stay valid until then. See uvc_get_ctrl_async().
+ * @param devh UVC device handle
+ * @param[out] status TODO
+ * @param req_code UVC_GET_* request to execute
+ * @param cb Completion callback, or NULL
+ * @param user_ptr Passed to @p cb
+ */
+uvc_error_t uvc_get_analog_video_lock_status_async(uvc_device_handle_t *devh, uint8_t* status, enum uvc_req_code req_code, uvc_ctrl_callback_t *cb, void *user_ptr) {
+  void *out[] = { status };
+
+  return uvc_get_ctrl_fields_async(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_ANALOG_VIDEO_LOCK_STATUS], out, req_code,
+                                   cb, user_ptr);
+}
+
+
+/** @ingroup ctrl
+ * @brief Sets the ANALOG_LOCK_STATUS control without waiting for it to complete.
+ *
+ * @p cb is called with UVC_SUCCESS once the value has been sent. See
+ * uvc_set_ctrl_async().
+ * @param devh UVC device handle
+ * @param status TODO
+ * @param cb Completion callback, or NULL
+ * @param user_ptr Passed to @p cb
+ */
+uvc_error_t uvc_set_analog_video_lock_status_async(uvc_device_handle_t *devh, uint8_t status, uvc_ctrl_callback_t *cb, void *user_ptr) {
+  const int64_t values[] = { status };
+
+  return uvc_set_ctrl_fields_async(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_ANALOG_VIDEO_LOCK_STATUS], values,
+                                   cb, user_ptr);
 }
 
 /** @ingroup ctrl
@@ -2210,24 +2480,9 @@ uvc_error_t uvc_set_analog_video_lock_status(uvc_device_handle_t *devh, uint8_t
  * @param req_code UVC_GET_* request to execute
  */
 uvc_error_t uvc_get_input_select(uvc_device_handle_t *devh, uint8_t* selector, enum uvc_req_code req_code) {
-  uint8_t data[1];
-  uvc_error_t ret;
+  void *out[] = { selector };
 
-  ret = libusb_control_transfer(
-    devh->usb_devh,
-    REQ_TYPE_GET, req_code,
-    UVC_SU_INPUT_SELECT_CONTROL << 8,
-    uvc_get_selector_units(devh)->bUnitID << 8 | devh->info->ctrl_if.bInterfaceNumber,
-    data,
-    sizeof(data),
-    0);
-
-  if (ret == sizeof(data)) {
-    *selector = data[0];
-    return UVC_SUCCESS;
-  } else {
-    return ret;
-  }
+  return uvc_get_ctrl_fields(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_INPUT_SELECT], out, req_code);
 }
 
 
@@ -2237,23 +2492,45 @@ uvc_error_t uvc_get_input_select(uvc_device_handle_t *devh, uint8_t* selector, e
  * @param selector TODO
  */
 uvc_error_t uvc_set_input_select(uvc_device_handle_t *devh, uint8_t selector) {
-  uint8_t data[1];
-  uvc_error_t ret;
-
-  data[0] = selector;
-
-  ret = libusb_control_transfer(
-    devh->usb_devh,
-    REQ_TYPE_SET, UVC_SET_CUR,
-    UVC_SU_INPUT_SELECT_CONTROL << 8,
-    uvc_get_selector_units(devh)->bUnitID << 8 | devh->info->ctrl_if.bInterfaceNumber,
-    data,
-    sizeof(data),
-    0);
-
-  if (ret == sizeof(data))
-    return UVC_SUCCESS;
-  else
-    return ret;
+  const int64_t values[] = { selector };
+
+  return uvc_set_ctrl_fields(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_INPUT_SELECT], values);
+}
+
+
+/** @ingroup ctrl
+ * @brief Reads the INPUT_SELECT control without waiting for the answer.
+ *
+ * The fields are filled in just before @p cb is called with UVC_SUCCESS;
+ * they must stay valid until then. See uvc_get_ctrl_async().
+ * @param devh UVC device handle
+ * @param[out] selector TODO
+ * @param req_code UVC_GET_* request to execute
+ * @param cb Completion callback, or NULL
+ * @param user_ptr Passed to @p cb
+ */
+uvc_error_t uvc_get_input_select_async(uvc_device_handle_t *devh, uint8_t* selector, enum uvc_req_code req_code, uvc_ctrl_callback_t *cb, void *user_ptr) {
+  void *out[] = { selector };
+
+  return uvc_get_ctrl_fields_async(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_INPUT_SELECT], out, req_code,
+                                   cb, user_ptr);
+}
+
+
+/** @ingroup ctrl
+ * @brief Sets the INPUT_SELECT control without waiting for it to complete.
+ *
+ * @p cb is called with UVC_SUCCESS once the value has been sent. See
+ * uvc_set_ctrl_async().
+ * @param devh UVC device handle
+ * @param selector TODO
+ * @param cb Completion callback, or NULL
+ * @param user_ptr Passed to @p cb
+ */
+uvc_error_t uvc_set_input_select_async(uvc_device_handle_t *devh, uint8_t selector, uvc_ctrl_callback_t *cb, void *user_ptr) {
+  const int64_t values[] = { selector };
+
+  return uvc_set_ctrl_fields_async(devh, &uvc_ctrl_defs[UVC_CTRL_DEF_INPUT_SELECT], values,
+                                   cb, user_ptr);
 }
 
@@ -41,25 +41,9 @@ class IntField(object):
     def getter_sig(self):
         return "{0}* {1}".format(self.user_type, self.name)
 
-    def unpack(self):
-        if self.length == 1:
-            return "*{0} = data[{1}];".format(self.name, self.position)
-        elif self.length == 2:
-            return "*{0} = SW_TO_SHORT(data + {1});".format(self.name, self.position)
-        elif self.length == 4:
-            return "*{0} = DW_TO_INT(data + {1});".format(self.name, self.position)
-
     def setter_sig(self):
         return "{0} {1}".format(self.user_type, self.name)
 
-    def pack(self):
-        if self.length == 1:
-            return "data[{0}] = {1};".format(self.position, self.name)
-        elif self.length == 2:
-            return "SHORT_TO_SW({0}, data + {1});".format(self.name, self.position)
-        elif self.length == 4:
-            return "INT_TO_DW({0}, data + {1});".format(self.name, self.position)
-
     def spec(self):
         rep = [('position', self.position), ('length', self.length)]
         if self.signed:
@@ -83,24 +67,9 @@ GETTER_TEMPLATE = """/** @ingroup ctrl
  * @param req_code UVC_GET_* request to execute
  */
 uvc_error_t uvc_get_{control_name}(uvc_device_handle_t *devh, {args_signature}, enum uvc_req_code req_code) {{
-  uint8_t data[{control_length}];
-  uvc_error_t ret;
-
-  ret = libusb_control_transfer(
-    devh->usb_devh,
-    REQ_TYPE_GET, req_code,
-    {control_code} << 8,
-    {unit_fn} << 8 | devh->info->ctrl_if.bInterfaceNumber,
-    data,
-    sizeof(data),
-    0);
-
-  if (ret == sizeof(data)) {{
-    {unpack}
-    return UVC_SUCCESS;
-  }} else {{
-    return ret;
-  }}
+  void *out[] = {{ {out_list} }};
+
+  return uvc_get_ctrl_fields(devh, &uvc_ctrl_defs[{def_index}], out, req_code);
 }}
 """
 
@@ -110,24 +79,46 @@ SETTER_TEMPLATE = """/** @ingroup ctrl
  * {args_doc}
  */
 uvc_error_t uvc_set_{control_name}(uvc_device_handle_t *devh, {args_signature}) {{
-  uint8_t data[{control_length}];
-  uvc_error_t ret;
-
-  {pack}
-
-  ret = libusb_control_transfer(
-    devh->usb_devh,
-    REQ_TYPE_SET, UVC_SET_CUR,
-    {control_code} << 8,
-    {unit_fn} << 8 | devh->info->ctrl_if.bInterfaceNumber,
-    data,
-    sizeof(data),
-    0);
-
-  if (ret == sizeof(data))
-    return UVC_SUCCESS;
-  else
-    return ret;
+  const int64_t values[] = {{ {value_list} }};
+
+  return uvc_set_ctrl_fields(devh, &uvc_ctrl_defs[{def_index}], values);
+}}
+"""
+
+ASYNC_GETTER_TEMPLATE = """/** @ingroup ctrl
+ * @brief Reads the {control} control without waiting for the answer.
+ *
+ * The fields are filled in just before @p cb is called with UVC_SUCCESS;
+ * they must stay valid until then. See uvc_get_ctrl_async().
+ * @param devh UVC device handle
+ * {args_doc}
+ * @param req_code UVC_GET_* request to execute
+ * @param cb Completion callback, or NULL
+ * @param user_ptr Passed to @p cb
+ */
+uvc_error_t uvc_get_{control_name}_async(uvc_device_handle_t *devh, {args_signature}, enum uvc_req_code req_code, uvc_ctrl_callback_t *cb, void *user_ptr) {{
+  void *out[] = {{ {out_list} }};
+
+  return uvc_get_ctrl_fields_async(devh, &uvc_ctrl_defs[{def_index}], out, req_code,
+                                   cb, user_ptr);
+}}
+"""
+
+ASYNC_SETTER_TEMPLATE = """/** @ingroup ctrl
+ * @brief Sets the {control} control without waiting for it to complete.
+ *
+ * @p cb is called with UVC_SUCCESS once the value has been sent. See
+ * uvc_set_ctrl_async().
+ * @param devh UVC device handle
+ * {args_doc}
+ * @param cb Completion callback, or NULL
+ * @param user_ptr Passed to @p cb
+ */
+uvc_error_t uvc_set_{control_name}_async(uvc_device_handle_t *devh, {args_signature}, uvc_ctrl_callback_t *cb, void *user_ptr) {{
+  const int64_t values[] = {{ {value_list} }};
+
+  return uvc_set_ctrl_fields_async(devh, &uvc_ctrl_defs[{def_index}], values,
+                                   cb, user_ptr);
 }}
 """
 
@@ -143,6 +134,12 @@ def gen_decl(unit_name, unit, control_name, control):
     }) + "uvc_error_t uvc_set_{function_name}(uvc_device_handle_t *devh, {args_signature});\n".format(**{
         "function_name": control_name,
         "args_signature": set_args_signature
+    }) + "uvc_error_t uvc_get_{function_name}_async(uvc_device_handle_t *devh, {args_signature}, enum uvc_req_code req_code, uvc_ctrl_callback_t *cb, void *user_ptr);\n".format(**{
+        "function_name": control_name,
+        "args_signature": get_args_signature
+    }) + "uvc_error_t uvc_set_{function_name}_async(uvc_device_handle_t *devh, {args_signature}, uvc_ctrl_callback_t *cb, void *user_ptr);\n".format(**{
+        "function_name": control_name,
+        "args_signature": set_args_signature
     })
 
 def gen_ctrl(unit_name, unit, control_name, control):
@@ -150,9 +147,6 @@ def gen_ctrl(unit_name, unit, control_name, control):
 
     get_args_signature = ', '.join([field.getter_sig() for (field, desc) in fields])
     set_args_signature = ', '.join([field.setter_sig() for (field, desc) in fields])
-    unpack = "\n    ".join([field.unpack() for (field, desc) in fields])
-    pack = "\n  ".join([field.pack() for (field, desc) in fields])
-
     get_gen_doc_raw = None
     set_gen_doc_raw = None
 
@@ -181,30 +175,61 @@ def gen_ctrl(unit_name, unit, control_name, control):
     get_args_doc = "\n * ".join(["@param[out] {0} {1}".format(field.name, desc) for (field, desc) in fields])
     set_args_doc = "\n * ".join(["@param {0} {1}".format(field.name, desc) for (field, desc) in fields])
 
-    control_code = 'UVC_' + unit['control_prefix'] + '_' + control['control'] + '_CONTROL'
-
-    unit_fn = "uvc_get_camera_terminal(devh)->bTerminalID" if (unit_name == "camera_terminal") else ("uvc_get_" + unit_name + "s(devh)->bUnitID")
+    out_list = ", ".join([field.name for (field, desc) in fields])
+    value_list = ", ".join([field.name for (field, desc) in fields])
 
     return GETTER_TEMPLATE.format(
-        unit=unit,
-        unit_fn=unit_fn,
         control_name=control_name,
-        control_code=control_code,
-        control_length=control['length'],
+        def_index=def_index(control_name),
         args_signature=get_args_signature,
         args_doc=get_args_doc,
         gen_doc=get_gen_doc,
-        unpack=unpack) + "\n\n" + SETTER_TEMPLATE.format(
-            unit=unit,
-            unit_fn=unit_fn,
+        out_list=out_list) + "\n\n" + SETTER_TEMPLATE.format(
             control_name=control_name,
-            control_code=control_code,
-            control_length=control['length'],
+            def_index=def_index(control_name),
             args_signature=set_args_signature,
             args_doc=set_args_doc,
             gen_doc=set_gen_doc,
-            pack=pack
-        )
+            value_list=value_list
+        ) + "\n\n" + ASYNC_GETTER_TEMPLATE.format(
+            control=control['control'],
+            control_name=control_name,
+            def_index=def_index(control_name),
+            args_signature=get_args_signature,
+            args_doc=get_args_doc,
+            out_list=out_list) + "\n\n" + ASYNC_SETTER_TEMPLATE.format(
+                control=control['control'],
+                control_name=control_name,
+                def_index=def_index(control_name),
+                args_signature=set_args_signature,
+                args_doc=set_args_doc,
+                value_list=value_list
+            )
+
+def def_index(control_name):
+    return 'UVC_CTRL_DEF_' + control_name.upper()
+
+TABLE_ENTRY_TEMPLATE = """  {{ "{control_name}", UVC_CTRL_UNIT_{unit_type}, {control_code}, {control_length}, {num_fields},
+    {{ {fields} }} }},"""
+
+TABLE_FIELD_TEMPLATE = """{{ "{name}", {position}, {length}, {signed} }}"""
+
+def gen_table_entry(unit_name, unit, control_name, control):
+    fields = [load_field(field_name, field_details) for field_name, field_details in control['fields'].items()] if 'fields' in control else []
+
+    return TABLE_ENTRY_TEMPLATE.format(
+        control_name=control_name,
+        unit_type=unit_name.upper(),
+        control_code='UVC_' + unit['control_prefix'] + '_' + control['control'] + '_CONTROL',
+        control_length=control['length'],
+        num_fields=len(fields),
+        fields=",\n      ".join([TABLE_FIELD_TEMPLATE.format(
+            name=field.name,
+            position=field.position,
+            length=field.length,
+            signed=1 if field.signed else 0) for field in fields]))
+
+INDEX_ENTRY_TEMPLATE = """  {def_index},"""
 
 def export_unit(unit):
     def fmt_doc(doc):
@@ -260,7 +285,7 @@ if __name__ == '__main__':
 
     mode = None
     for arg in args:
-        if arg in ('def', 'decl', 'yaml'):
+        if arg in ('def', 'decl', 'table', 'index', 'yaml'):
             if mode is None:
                 mode = arg
             else:
@@ -273,21 +298,42 @@ if __name__ == '__main__':
     def iterunits():
         for input_file in inputs:
             with open(input_file, "r") as fp:
-                units = yaml.load(fp)['units']
-                for unit_name, unit_details in units.iteritems():
+                units = yaml.load(fp, Loader=yaml.Loader)['units']
+                for unit_name, unit_details in units.items():
                     yield unit_name, unit_details
 
     if mode == 'def':
         print("""/* This is an AUTO-GENERATED file! Update it with the output of `ctrl-gen.py def`. */
 #include "libuvc/libuvc.h"
 #include "libuvc/libuvc_internal.h"
-
-static const int REQ_TYPE_SET = 0x21;
-static const int REQ_TYPE_GET = 0xa1;
 """)
         fun = gen_ctrl
     elif mode == 'decl':
         fun = gen_decl
+    elif mode == 'table':
+        print("""/* This is an AUTO-GENERATED file! Update it with the output of `ctrl-gen.py table`. */
+#include "libuvc/libuvc.h"
+#include "libuvc/libuvc_internal.h"
+
+/** @internal Every standard control described in standard-units.yaml */
+const uvc_ctrl_def_t uvc_ctrl_defs[] = {""")
+        for unit_name, unit_details in iterunits():
+            for control_name, control_details in unit_details['controls'].items():
+                print(gen_table_entry(unit_name, unit_details, control_name, control_details))
+        print("""};
+
+const size_t uvc_ctrl_def_count = sizeof(uvc_ctrl_defs) / sizeof(uvc_ctrl_defs[0]);""")
+        sys.exit(0)
+    elif mode == 'index':
+        print("""/* AUTO-GENERATED control table indices! Update them with the output of `ctrl-gen.py index`. */
+/** @internal Position of each standard control in uvc_ctrl_defs */
+enum uvc_ctrl_def_index {""")
+        for unit_name, unit_details in iterunits():
+            for control_name, control_details in unit_details['controls'].items():
+                print(INDEX_ENTRY_TEMPLATE.format(def_index=def_index(control_name)))
+        print("""};
+/* end AUTO-GENERATED control table indices */""")
+        sys.exit(0)
     elif mode == 'yaml':
         exported_units = OrderedDict()
         for unit_name, unit_details in iterunits():
@@ -297,6 +343,6 @@ static const int REQ_TYPE_GET = 0xa1;
         sys.exit(0)
 
     for unit_name, unit_details in iterunits():
-        for control_name, control_details in unit_details['controls'].iteritems():
+        for control_name, control_details in unit_details['controls'].items():
             code = fun(unit_name, unit_details, control_name, control_details)
             print(code)
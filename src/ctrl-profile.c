@@ -0,0 +1,390 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (C) 2010-2012 Ken Tossell
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the author nor other contributors may be
+*     used to endorse or promote products derived from this software
+*     without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+/**
+ * @internal
+ * @file ctrl-profile.c
+ * @brief Saving and restoring the settings of the standard controls.
+ *
+ * A profile holds the current value of every standard control that can be
+ * both read and written, in wire format, keyed by unit type and selector so
+ * that it applies to any camera with the same controls. Relative controls
+ * (zoom_rel and the like) start movements rather than hold a setting and
+ * are left out.
+ *
+ * Serialized profiles are little-endian:
+ *
+ *   char[4] magic "UVCF", u16 version (1), u16 number of controls,
+ *   per control: u8 unit type, u8 selector, u8 length, u8 value[length]
+ */
+#include "libuvc/libuvc.h"
+#include "libuvc/libuvc_internal.h"
+
+#define UVC_CTRL_PROFILE_VERSION 1
+
+static const char uvc_ctrl_profile_magic[4] = { 'U', 'V', 'C', 'F' };
+
+typedef struct uvc_ctrl_profile_entry {
+  enum uvc_ctrl_unit_type unit_type;
+  uint8_t selector;
+  uint8_t length;
+  uint8_t value[UVC_CTRL_DEF_MAX_LEN];
+} uvc_ctrl_profile_entry_t;
+
+struct uvc_ctrl_profile {
+  size_t count;
+  uvc_ctrl_profile_entry_t *entries;
+};
+
+/* Controls that change what others accept, and so are restored first:
+ * automatic modes before the values they take over, limits before the
+ * values they limit. Everything else has rank 2. */
+static const struct {
+  const char *name;
+  int rank;
+} profile_order[] = {
+  { "ae_mode", 0 },
+  { "focus_auto", 0 },
+  { "contrast_auto", 0 },
+  { "hue_auto", 0 },
+  { "white_balance_temperature_auto", 0 },
+  { "white_balance_component_auto", 0 },
+  { "ae_priority", 1 },
+  { "digital_multiplier_limit", 1 },
+};
+
+/** @internal
+ * @brief Rank of a control in the order settings are written back
+ *
+ * Used by profile apply and by uvc_ctrl_cache_restore(); controls of a
+ * lower rank are written first.
+ */
+int uvc_ctrl_def_rank(const uvc_ctrl_def_t *def) {
+  size_t i;
+
+  for (i = 0; i < sizeof(profile_order) / sizeof(profile_order[0]); ++i) {
+    if (!strcmp(profile_order[i].name, def->name))
+      return profile_order[i].rank;
+  }
+
+  return UVC_CTRL_RANKS - 1;
+}
+
+static int profile_is_relative(const uvc_ctrl_def_t *def) {
+  size_t len = strlen(def->name);
+
+  return len > 4 && !strcmp(def->name + len - 4, "_rel");
+}
+
+static const uvc_ctrl_def_t *profile_find_def(enum uvc_ctrl_unit_type unit_type,
+                                              uint8_t selector) {
+  size_t i;
+
+  for (i = 0; i < uvc_ctrl_def_count; ++i) {
+    if (uvc_ctrl_defs[i].unit_type == unit_type && uvc_ctrl_defs[i].selector == selector)
+      return &uvc_ctrl_defs[i];
+  }
+
+  return NULL;
+}
+
+/** @brief Record the current settings of the device's controls
+ * @ingroup ctrl
+ *
+ * @param devh UVC device handle
+ * @param[out] profile New profile; free it with uvc_free_ctrl_profile()
+ * @return UVC_SUCCESS or an error
+ */
+uvc_error_t uvc_capture_ctrl_profile(uvc_device_handle_t *devh, uvc_ctrl_profile_t **profile) {
+  uvc_ctrl_snapshot_t *snaps;
+  uvc_ctrl_profile_t *prof;
+  uvc_error_t ret;
+  size_t count, i, d;
+
+  UVC_ENTER();
+
+  ret = uvc_read_all_controls(devh, &snaps, &count);
+  if (ret != UVC_SUCCESS) {
+    UVC_EXIT(ret);
+    return ret;
+  }
+
+  prof = calloc(1, sizeof(*prof));
+  if (prof)
+    prof->entries = calloc(count ? count : 1, sizeof(*prof->entries));
+  if (!prof || !prof->entries) {
+    free(prof);
+    uvc_free_ctrl_snapshots(snaps);
+    UVC_EXIT(UVC_ERROR_NO_MEM);
+    return UVC_ERROR_NO_MEM;
+  }
+
+  for (i = 0; i < count; ++i) {
+    const uvc_ctrl_def_t *def = NULL;
+    uvc_ctrl_profile_entry_t *entry;
+
+    if ((snaps[i].info & (UVC_CONTROL_CAP_GET | UVC_CONTROL_CAP_SET)) !=
+        (UVC_CONTROL_CAP_GET | UVC_CONTROL_CAP_SET))
+      continue;
+    if (!(snaps[i].valid & (1 << (UVC_GET_CUR - UVC_GET_CUR))))
+      continue;
+
+    for (d = 0; d < uvc_ctrl_def_count; ++d) {
+      if (!strcmp(uvc_ctrl_defs[d].name, snaps[i].name)) {
+        def = &uvc_ctrl_defs[d];
+        break;
+      }
+    }
+    if (!def || profile_is_relative(def))
+      continue;
+
+    entry = &prof->entries[prof->count++];
+    entry->unit_type = def->unit_type;
+    entry->selector = def->selector;
+    entry->length = def->length;
+    uvc_ctrl_def_pack(def, snaps[i].cur, entry->value);
+  }
+
+  uvc_free_ctrl_snapshots(snaps);
+  *profile = prof;
+
+  UVC_EXIT(UVC_SUCCESS);
+  return UVC_SUCCESS;
+}
+
+/** @brief Bring the device's controls to the settings of a profile
+ * @ingroup ctrl
+ *
+ * Each control's current value is compared with the profile's, through the
+ * current value cache if it is enabled (see uvc_set_ctrl_cur_cache()), and
+ * only controls that differ are written. Automatic modes and limits are
+ * restored before the controls that depend on them; once one of those has
+ * changed, the dependent controls' cached state is dropped and their
+ * capabilities read again, and controls the device now reports as
+ * disabled (manual exposure under automatic exposure, say) are skipped.
+ * Controls are written directly, not through the control writer (see
+ * uvc_start_ctrl_writer()).
+ *
+ * @param devh UVC device handle
+ * @param profile Profile from uvc_capture_ctrl_profile() or
+ *   uvc_deserialize_ctrl_profile()
+ * @param[out] result What was done with each control, or NULL
+ * @return UVC_SUCCESS, or the error of the first control that could not be
+ *   read or written; the remaining controls are still restored
+ */
+uvc_error_t uvc_apply_ctrl_profile(uvc_device_handle_t *devh, const uvc_ctrl_profile_t *profile,
+                                   uvc_ctrl_profile_result_t *result) {
+  uvc_ctrl_profile_result_t res;
+  uvc_error_t first_error = UVC_SUCCESS;
+  int rank, changed = 0;
+  size_t i, j;
+
+  UVC_ENTER();
+
+  memset(&res, 0, sizeof(res));
+
+  for (rank = 0; rank < UVC_CTRL_RANKS; ++rank) {
+    for (i = 0; i < profile->count; ++i) {
+      const uvc_ctrl_profile_entry_t *entry = &profile->entries[i];
+      const uvc_ctrl_def_t *def = profile_find_def(entry->unit_type, entry->selector);
+      uint8_t cur[UVC_CTRL_DEF_MAX_LEN];
+      uint8_t unit, info;
+      int ret;
+
+      if (def && uvc_ctrl_def_rank(def) != rank)
+        continue;
+      if (!def && rank != UVC_CTRL_RANKS - 1)
+        continue;
+
+      unit = def ? uvc_ctrl_def_unit_id(devh, def) : 0;
+      if (!unit || entry->length != def->length) {
+        res.skipped++;
+        continue;
+      }
+
+      ret = uvc_get_ctrl(devh, unit, def->selector, &info, 1, UVC_GET_INFO);
+      if (ret != 1 || !(info & UVC_CONTROL_CAP_SET) || (info & UVC_CONTROL_CAP_DISABLED)) {
+        res.skipped++;
+        continue;
+      }
+
+      ret = uvc_get_ctrl(devh, unit, def->selector, cur, def->length, UVC_GET_CUR);
+      if (ret == def->length && !memcmp(cur, entry->value, def->length)) {
+        res.unchanged++;
+        continue;
+      }
+
+      /* written now even with the control writer running: the capabilities
+       * of the next rank are read right after */
+      ret = uvc_set_ctrl_now(devh, unit, def->selector, entry->value, def->length);
+      if (ret == def->length) {
+        res.sent++;
+        changed = 1;
+      } else {
+        res.failed++;
+        if (first_error == UVC_SUCCESS)
+          first_error = ret < 0 ? ret : UVC_ERROR_IO;
+      }
+    }
+
+    /* what the later ranks accept may have changed with this one */
+    if (changed) {
+      for (j = 0; j < profile->count; ++j) {
+        const uvc_ctrl_def_t *def = profile_find_def(profile->entries[j].unit_type,
+                                                     profile->entries[j].selector);
+        uint8_t unit = def ? uvc_ctrl_def_unit_id(devh, def) : 0;
+
+        if (unit && uvc_ctrl_def_rank(def) > rank)
+          uvc_ctrl_cache_invalidate_ctrl(devh, unit, def->selector);
+      }
+      changed = 0;
+    }
+  }
+
+  if (result)
+    *result = res;
+
+  UVC_EXIT(first_error);
+  return first_error;
+}
+
+/** @brief Number of controls a profile holds
+ * @ingroup ctrl
+ */
+size_t uvc_get_ctrl_profile_size(const uvc_ctrl_profile_t *profile) {
+  return profile->count;
+}
+
+/** @brief Turn a profile into bytes, to be stored or sent elsewhere
+ * @ingroup ctrl
+ *
+ * @param profile Profile
+ * @param[out] data Serialized profile; release it with free()
+ * @param[out] size Number of bytes in @p data
+ * @return UVC_SUCCESS or UVC_ERROR_NO_MEM
+ */
+uvc_error_t uvc_serialize_ctrl_profile(const uvc_ctrl_profile_t *profile, void **data,
+                                       size_t *size) {
+  size_t len = 8, i;
+  uint8_t *buf, *p;
+
+  for (i = 0; i < profile->count; ++i)
+    len += 3 + profile->entries[i].length;
+
+  buf = malloc(len);
+  if (!buf)
+    return UVC_ERROR_NO_MEM;
+
+  memcpy(buf, uvc_ctrl_profile_magic, 4);
+  SHORT_TO_SW(UVC_CTRL_PROFILE_VERSION, buf + 4);
+  SHORT_TO_SW(profile->count, buf + 6);
+
+  p = buf + 8;
+  for (i = 0; i < profile->count; ++i) {
+    const uvc_ctrl_profile_entry_t *entry = &profile->entries[i];
+
+    p[0] = entry->unit_type;
+    p[1] = entry->selector;
+    p[2] = entry->length;
+    memcpy(p + 3, entry->value, entry->length);
+    p += 3 + entry->length;
+  }
+
+  *data = buf;
+  *size = len;
+
+  return UVC_SUCCESS;
+}
+
+/** @brief Rebuild a profile from uvc_serialize_ctrl_profile() output
+ * @ingroup ctrl
+ *
+ * @param data Serialized profile
+ * @param size Number of bytes in @p data
+ * @param[out] profile New profile; free it with uvc_free_ctrl_profile()
+ * @return UVC_SUCCESS, UVC_ERROR_INVALID_PARAM if @p data is not a valid
+ *   profile, or UVC_ERROR_NO_MEM
+ */
+uvc_error_t uvc_deserialize_ctrl_profile(const void *data, size_t size,
+                                         uvc_ctrl_profile_t **profile) {
+  const uint8_t *buf = data, *p, *end = buf + size;
+  uvc_ctrl_profile_t *prof;
+  size_t count, i;
+
+  if (size < 8 || memcmp(buf, uvc_ctrl_profile_magic, 4) ||
+      SW_TO_SHORT(buf + 4) != UVC_CTRL_PROFILE_VERSION)
+    return UVC_ERROR_INVALID_PARAM;
+
+  count = SW_TO_SHORT(buf + 6);
+
+  prof = calloc(1, sizeof(*prof));
+  if (prof)
+    prof->entries = calloc(count ? count : 1, sizeof(*prof->entries));
+  if (!prof || !prof->entries) {
+    free(prof);
+    return UVC_ERROR_NO_MEM;
+  }
+
+  p = buf + 8;
+  for (i = 0; i < count; ++i) {
+    uvc_ctrl_profile_entry_t *entry = &prof->entries[i];
+
+    if (end - p < 3 || p[2] > UVC_CTRL_DEF_MAX_LEN || end - p < 3 + p[2] ||
+        p[0] > UVC_CTRL_UNIT_SELECTOR_UNIT) {
+      uvc_free_ctrl_profile(prof);
+      return UVC_ERROR_INVALID_PARAM;
+    }
+
+    entry->unit_type = p[0];
+    entry->selector = p[1];
+    entry->length = p[2];
+    memcpy(entry->value, p + 3, entry->length);
+    p += 3 + entry->length;
+  }
+  prof->count = count;
+
+  *profile = prof;
+
+  return UVC_SUCCESS;
+}
+
+/** @brief Free a profile
+ * @ingroup ctrl
+ */
+void uvc_free_ctrl_profile(uvc_ctrl_profile_t *profile) {
+  if (!profile)
+    return;
+
+  free(profile->entries);
+  free(profile);
+}
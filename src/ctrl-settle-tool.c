@@ -0,0 +1,416 @@
+/* uvc-ctrl-settle: measure how many frames a control change takes to show.
+ *
+ * Streams from a camera, then for each control given with --control
+ * changes it and back again, several times, with uvc_measure_ctrl_settle()
+ * watching mean luma (or sharpness, for focus controls) of every frame.
+ * Reports per control the frame at which the image first responded and the
+ * frame at which it settled, counted from the last frame completed when the
+ * write returned, as JSON. Control loops driving these controls should wait
+ * at least the settle latency between corrections.
+ *
+ * Controls are written as given; automatic modes that lock them out are
+ * only switched off with --manual. With --virtual the synthetic device
+ * emulates a sensor whose luma follows brightness, gain and exposure after
+ * --response frames.
+ */
+#include "libuvc/libuvc.h"
+#include "libuvc/libuvc_internal.h"
+#include "tools-common.h"
+
+#include <getopt.h>
+
+#define SETTLE_MAX_CONTROLS 16
+
+struct settle_control {
+  const uvc_ctrl_def_t *def;
+  int has_value;
+  int64_t value;
+  const char *skipped;
+  uvc_error_t error;
+  int runs;
+  double response[2 * 64], settle[2 * 64], settle_ms[2 * 64];
+  int responded, settled;
+};
+
+static const uvc_ctrl_def_t *find_def(const char *name, size_t len) {
+  size_t i;
+
+  for (i = 0; i < uvc_ctrl_def_count; ++i) {
+    if (strlen(uvc_ctrl_defs[i].name) == len && !strncmp(uvc_ctrl_defs[i].name, name, len))
+      return &uvc_ctrl_defs[i];
+  }
+
+  return NULL;
+}
+
+/** Parse NAME or NAME=VALUE */
+static int parse_control(const char *arg, struct settle_control *ctl) {
+  const char *eq = strchr(arg, '=');
+
+  memset(ctl, 0, sizeof(*ctl));
+  ctl->def = find_def(arg, eq ? (size_t) (eq - arg) : strlen(arg));
+  if (!ctl->def || ctl->def->num_fields != 1)
+    return -1;
+  if (eq) {
+    ctl->has_value = 1;
+    ctl->value = strtoll(eq + 1, NULL, 0);
+  }
+
+  return 0;
+}
+
+static int read_field(uvc_device_handle_t *devh, uint8_t unit, const uvc_ctrl_def_t *def,
+                      enum uvc_req_code req_code, int64_t *value) {
+  uint8_t buf[UVC_CTRL_DEF_MAX_LEN];
+
+  if (uvc_get_ctrl(devh, unit, def->selector, buf, def->length, req_code) != def->length)
+    return -1;
+  *value = uvc_ctrl_field_decode(&def->fields[0], buf);
+  return 0;
+}
+
+/** Turn off an automatic mode (value @p manual) if the device has it */
+static void set_manual(uvc_device_handle_t *devh, int index, int64_t manual, int64_t *saved) {
+  const uvc_ctrl_def_t *def = &uvc_ctrl_defs[index];
+  uint8_t unit = uvc_ctrl_def_unit_id(devh, def);
+
+  if (unit && read_field(devh, unit, def, UVC_GET_CUR, saved) == 0)
+    uvc_set_ctrl_fields(devh, def, &manual);
+  else
+    *saved = -1;
+}
+
+static void restore_mode(uvc_device_handle_t *devh, int index, int64_t saved) {
+  if (saved >= 0)
+    uvc_set_ctrl_fields(devh, &uvc_ctrl_defs[index], &saved);
+}
+
+static void measure_control(uvc_stream_handle_t *strmh, struct settle_control *ctl,
+                            const uvc_settle_params_t *base_params, int metric_set,
+                            int iterations) {
+  uvc_device_handle_t *devh = strmh->devh;
+  const uvc_ctrl_def_t *def = ctl->def;
+  uvc_settle_params_t params = *base_params;
+  uint8_t unit, info, values[2][UVC_CTRL_DEF_MAX_LEN];
+  int64_t cur, min, max, target;
+  int i, dir;
+
+  unit = uvc_ctrl_def_unit_id(devh, def);
+  if (!unit || uvc_get_ctrl(devh, unit, def->selector, &info, 1, UVC_GET_INFO) != 1) {
+    ctl->skipped = "not supported";
+    return;
+  }
+  if (!(info & UVC_CONTROL_CAP_SET)) {
+    ctl->skipped = "not settable";
+    return;
+  }
+  if (info & UVC_CONTROL_CAP_DISABLED) {
+    ctl->skipped = "disabled (try --manual)";
+    return;
+  }
+  if (read_field(devh, unit, def, UVC_GET_CUR, &cur) ||
+      read_field(devh, unit, def, UVC_GET_MIN, &min) ||
+      read_field(devh, unit, def, UVC_GET_MAX, &max)) {
+    ctl->skipped = "range unreadable";
+    return;
+  }
+
+  /* by default, a quarter of the range away from where it is */
+  target = ctl->has_value ? ctl->value
+    : cur < min + (max - min) / 2 ? cur + (max - min) / 4 : cur - (max - min) / 4;
+  ctl->value = target;
+  if (target == cur) {
+    ctl->skipped = "no change to make";
+    return;
+  }
+
+  if (!metric_set)
+    params.metric = strstr(def->name, "focus") ? UVC_SETTLE_SHARPNESS : UVC_SETTLE_MEAN_LUMA;
+
+  uvc_ctrl_def_pack(def, &target, values[0]);
+  uvc_ctrl_def_pack(def, &cur, values[1]);
+
+  for (i = 0; i < iterations; ++i) {
+    for (dir = 0; dir < 2; ++dir) {
+      uvc_settle_result_t res;
+      uvc_error_t ret;
+
+      ret = uvc_measure_ctrl_settle(strmh, unit, def->selector, values[dir], def->length,
+                                    &params, &res);
+      if (ret != UVC_SUCCESS) {
+        ctl->error = ret;
+        uvc_set_ctrl(devh, unit, def->selector, values[1], def->length);
+        return;
+      }
+
+      if (res.response_frames >= 0)
+        ctl->response[ctl->responded++] = res.response_frames;
+      if (res.settle_frames >= 0) {
+        ctl->settle[ctl->settled] = res.settle_frames;
+        ctl->settle_ms[ctl->settled] = res.settle_us / 1000;
+        ctl->settled++;
+      }
+      ctl->runs++;
+    }
+  }
+}
+
+static void write_stats(FILE *fp, const char *name, double *samples, int count) {
+  qsort(samples, count, sizeof(double), tool_compare_double);
+  fprintf(fp, ",\n      \"%s\": {\"min\": %.1f, \"p50\": %.1f, \"max\": %.1f}", name,
+          samples[0], tool_percentile(samples, count, 50), samples[count - 1]);
+}
+
+static void write_control(FILE *fp, const struct settle_control *ctl, int first) {
+  struct settle_control sorted = *ctl;
+
+  fprintf(fp, "%s    \"%s\": {\n", first ? "" : ",\n", ctl->def->name);
+  if (ctl->skipped) {
+    fprintf(fp, "      \"skipped\": ");
+    tool_json_string(fp, ctl->skipped);
+    fprintf(fp, "\n    }");
+    return;
+  }
+
+  fprintf(fp, "      \"value\": %lld,\n      \"runs\": %d,\n      \"responded\": %d,\n"
+          "      \"settled\": %d", (long long) ctl->value, ctl->runs, ctl->responded,
+          ctl->settled);
+  if (ctl->error) {
+    fprintf(fp, ",\n      \"error\": ");
+    tool_json_string(fp, uvc_strerror(ctl->error));
+  }
+  if (sorted.responded)
+    write_stats(fp, "response_frames", sorted.response, sorted.responded);
+  if (sorted.settled) {
+    write_stats(fp, "settle_frames", sorted.settle, sorted.settled);
+    write_stats(fp, "settle_ms", sorted.settle_ms, sorted.settled);
+  }
+  fprintf(fp, "\n    }");
+}
+
+static void usage(const char *argv0) {
+  fprintf(stderr,
+          "Usage: %s [options]\n"
+          "  -v, --device VID:PID     device to open (hex; default: first UVC device)\n"
+          "  -S, --serial SN          device serial number\n"
+          "  -n, --virtual            use a synthetic device instead of a camera\n"
+          "  -R, --response N         frames before the synthetic image responds (default 3)\n"
+          "  -f, --format NAME        yuyv, uyvy, nv12, gray8, mjpeg (default yuyv)\n"
+          "  -s, --size WxH           frame size (default 640x480)\n"
+          "  -r, --fps N              frame rate (default 30)\n"
+          "  -c, --control NAME[=V]   control to change, and to what value (repeatable;\n"
+          "                           default exposure_abs, gain and focus_abs, each moved\n"
+          "                           by a quarter of its range)\n"
+          "  -m, --metric NAME        luma or sharpness (default: sharpness for focus)\n"
+          "  -t, --tolerance F        relative change counted as movement (default 0.02)\n"
+          "  -M, --max-frames N       frames to wait for settling (default 90)\n"
+          "  -i, --iterations N       changes and restores per control (default 5, max 64)\n"
+          "  -a, --manual             switch off auto exposure and autofocus while measuring\n"
+          "  -o, --output FILE        write JSON to FILE instead of stdout\n",
+          argv0);
+}
+
+int main(int argc, char **argv) {
+  static const struct option long_options[] = {
+    { "device", required_argument, NULL, 'v' },
+    { "serial", required_argument, NULL, 'S' },
+    { "virtual", no_argument, NULL, 'n' },
+    { "response", required_argument, NULL, 'R' },
+    { "format", required_argument, NULL, 'f' },
+    { "size", required_argument, NULL, 's' },
+    { "fps", required_argument, NULL, 'r' },
+    { "control", required_argument, NULL, 'c' },
+    { "metric", required_argument, NULL, 'm' },
+    { "tolerance", required_argument, NULL, 't' },
+    { "max-frames", required_argument, NULL, 'M' },
+    { "iterations", required_argument, NULL, 'i' },
+    { "manual", no_argument, NULL, 'a' },
+    { "output", required_argument, NULL, 'o' },
+    { "help", no_argument, NULL, 'h' },
+    { NULL, 0, NULL, 0 }
+  };
+  static const char *default_controls[] = { "exposure_abs", "gain", "focus_abs" };
+  static struct settle_control controls[SETTLE_MAX_CONTROLS];
+  int num_controls = 0;
+  int vid = 0, pid = 0, width = 640, height = 480, fps = 30;
+  int use_virtual = 0, manual = 0, metric_set = 0, iterations = 5;
+  uint32_t response = 3;
+  int64_t saved_ae = -1, saved_focus = -1;
+  enum uvc_frame_format format = UVC_FRAME_FORMAT_YUYV;
+  const char *serial = NULL, *output = NULL;
+  uvc_settle_params_t params;
+  uvc_context_t *ctx;
+  uvc_device_t *dev = NULL;
+  uvc_device_handle_t *devh;
+  uvc_stream_handle_t *strmh = NULL;
+  uvc_stream_ctrl_t ctrl;
+  FILE *fp = stdout;
+  uvc_error_t res;
+  int opt, i, measured = 0;
+
+  uvc_settle_params_init(&params);
+
+  while ((opt = getopt_long(argc, argv, "v:S:nR:f:s:r:c:m:t:M:i:ao:h", long_options,
+                            NULL)) != -1) {
+    switch (opt) {
+    case 'v':
+      if (sscanf(optarg, "%x:%x", &vid, &pid) != 2) {
+        fprintf(stderr, "bad device '%s'\n", optarg);
+        return 1;
+      }
+      break;
+    case 'S':
+      serial = optarg;
+      break;
+    case 'n':
+      use_virtual = 1;
+      break;
+    case 'R':
+      response = (uint32_t) strtoul(optarg, NULL, 10);
+      break;
+    case 'f':
+      if (tool_parse_format(optarg, &format) || format == UVC_FRAME_FORMAT_ANY) {
+        fprintf(stderr, "unknown format '%s'\n", optarg);
+        return 1;
+      }
+      break;
+    case 's':
+      if (tool_parse_size(optarg, &width, &height)) {
+        fprintf(stderr, "bad size '%s'\n", optarg);
+        return 1;
+      }
+      break;
+    case 'r':
+      fps = atoi(optarg);
+      break;
+    case 'c':
+      if (num_controls == SETTLE_MAX_CONTROLS ||
+          parse_control(optarg, &controls[num_controls])) {
+        fprintf(stderr, "unknown or multi-field control '%s'\n", optarg);
+        return 1;
+      }
+      num_controls++;
+      break;
+    case 'm':
+      if (!strcmp(optarg, "luma")) {
+        params.metric = UVC_SETTLE_MEAN_LUMA;
+      } else if (!strcmp(optarg, "sharpness")) {
+        params.metric = UVC_SETTLE_SHARPNESS;
+      } else {
+        fprintf(stderr, "unknown metric '%s'\n", optarg);
+        return 1;
+      }
+      metric_set = 1;
+      break;
+    case 't':
+      params.tolerance = strtod(optarg, NULL);
+      break;
+    case 'M':
+      params.max_frames = atoi(optarg);
+      break;
+    case 'i':
+      iterations = atoi(optarg);
+      break;
+    case 'a':
+      manual = 1;
+      break;
+    case 'o':
+      output = optarg;
+      break;
+    default:
+      usage(argv[0]);
+      return opt == 'h' ? 0 : 1;
+    }
+  }
+
+  if (iterations <= 0 || iterations > 64 || fps <= 0 || params.max_frames <= 0) {
+    usage(argv[0]);
+    return 1;
+  }
+
+  if (!num_controls) {
+    for (i = 0; i < (int) (sizeof(default_controls) / sizeof(default_controls[0])); ++i)
+      parse_control(default_controls[i], &controls[num_controls++]);
+  }
+
+  res = uvc_init(&ctx, NULL);
+  if (res < 0) {
+    uvc_perror(res, "uvc_init");
+    return 1;
+  }
+
+  if (use_virtual) {
+    res = uvc_synthetic_open(ctx, format, width, height, 10000000 / fps, &devh);
+    if (res == UVC_SUCCESS) {
+      uvc_synthetic_set_ctrl_response(devh, 1, response);
+      res = uvc_synthetic_stream_start(devh, &strmh, NULL, NULL, UVC_SYNTHETIC_PRODUCER);
+    }
+  } else {
+    res = uvc_find_device(ctx, &dev, vid, pid, serial);
+    if (res == UVC_SUCCESS)
+      res = uvc_open(dev, &devh);
+    if (res == UVC_SUCCESS) {
+      res = uvc_get_stream_ctrl_format_size(devh, &ctrl, format, width, height, fps);
+      if (res == UVC_SUCCESS)
+        res = uvc_stream_open_ctrl(devh, &strmh, &ctrl);
+      if (res == UVC_SUCCESS)
+        res = uvc_stream_start(strmh, NULL, NULL, 0);
+      if (res != UVC_SUCCESS)
+        uvc_close(devh);
+    }
+  }
+  if (res != UVC_SUCCESS) {
+    uvc_perror(res, use_virtual ? "synthetic stream" : "starting stream");
+    if (dev)
+      uvc_unref_device(dev);
+    uvc_exit(ctx);
+    return 1;
+  }
+
+  if (manual) {
+    set_manual(devh, UVC_CTRL_DEF_AE_MODE, 1, &saved_ae);
+    set_manual(devh, UVC_CTRL_DEF_FOCUS_AUTO, 0, &saved_focus);
+  }
+
+  for (i = 0; i < num_controls; ++i) {
+    measure_control(strmh, &controls[i], &params, metric_set, iterations);
+    if (controls[i].runs)
+      measured++;
+  }
+
+  if (manual) {
+    restore_mode(devh, UVC_CTRL_DEF_FOCUS_AUTO, saved_focus);
+    restore_mode(devh, UVC_CTRL_DEF_AE_MODE, saved_ae);
+  }
+
+  if (output) {
+    fp = fopen(output, "w");
+    if (!fp) {
+      perror(output);
+      fp = stdout;
+    }
+  }
+
+  fprintf(fp, "{\n  \"virtual\": %s,\n", use_virtual ? "true" : "false");
+  fprintf(fp, "  \"format\": \"%s\",\n  \"width\": %d,\n  \"height\": %d,\n  \"fps\": %d,\n",
+          tool_format_name(format), width, height, fps);
+  fprintf(fp, "  \"tolerance\": %g,\n  \"iterations\": %d,\n  \"controls\": {\n",
+          params.tolerance, iterations);
+  for (i = 0; i < num_controls; ++i)
+    write_control(fp, &controls[i], i == 0);
+  fprintf(fp, "\n  }\n}\n");
+
+  if (fp != stdout)
+    fclose(fp);
+
+  if (use_virtual) {
+    uvc_synthetic_close(devh);
+  } else {
+    uvc_stream_close(strmh);
+    uvc_close(devh);
+    uvc_unref_device(dev);
+  }
+  uvc_exit(ctx);
+
+  return measured ? 0 : 2;
+}
@@ -0,0 +1,227 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (C) 2010-2012 Ken Tossell
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the author nor other contributors may be
+*     used to endorse or promote products derived from this software
+*     without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+/**
+ * @internal
+ * @file ctrl-settle.c
+ * @brief Measuring how many frames a control change takes to show.
+ *
+ * A control write completes long before its effect reaches the image:
+ * sensors latch exposure and gain at frame boundaries, and the ISP and
+ * auto-exposure loops smooth what follows. uvc_measure_ctrl_settle()
+ * takes a baseline of a per-frame statistic, writes the control, notes the
+ * last frame completed at that moment, and counts frames until the
+ * statistic first moves and then until it stops moving.
+ */
+#include "libuvc/libuvc.h"
+#include "libuvc/libuvc_internal.h"
+
+#define SETTLE_DEFAULT_BASELINE_FRAMES 8
+#define SETTLE_DEFAULT_TOLERANCE 0.02
+#define SETTLE_DEFAULT_STABLE_FRAMES 3
+#define SETTLE_DEFAULT_MAX_FRAMES 90
+#define SETTLE_DEFAULT_FRAME_TIMEOUT_US 1000000
+
+/** Smallest change of the statistic counted as movement, whatever the tolerance */
+#define SETTLE_MIN_DELTA 0.5
+
+static double settle_abs(double v) {
+  return v < 0 ? -v : v;
+}
+
+static uvc_error_t settle_next_frame(uvc_stream_handle_t *strmh, int32_t timeout_us,
+                                     enum uvc_settle_metric metric, uint32_t *sequence,
+                                     double *value) {
+  uvc_frame_t *frame;
+  uvc_frame_stats_t stats;
+  uvc_error_t ret;
+
+  do {
+    ret = uvc_stream_get_frame(strmh, &frame, timeout_us);
+    if (ret != UVC_SUCCESS)
+      return ret;
+  } while (!frame);
+
+  *sequence = frame->sequence;
+
+  ret = uvc_get_frame_stats(frame, NULL, &stats);
+  if (ret == UVC_SUCCESS)
+    *value = metric == UVC_SETTLE_SHARPNESS ? stats.sharpness : stats.mean;
+
+  return ret;
+}
+
+/** @brief Fill in the default settle-measurement parameters
+ * @ingroup ctrl
+ */
+void uvc_settle_params_init(uvc_settle_params_t *params) {
+  params->metric = UVC_SETTLE_MEAN_LUMA;
+  params->baseline_frames = SETTLE_DEFAULT_BASELINE_FRAMES;
+  params->tolerance = SETTLE_DEFAULT_TOLERANCE;
+  params->stable_frames = SETTLE_DEFAULT_STABLE_FRAMES;
+  params->max_frames = SETTLE_DEFAULT_MAX_FRAMES;
+  params->frame_timeout_us = SETTLE_DEFAULT_FRAME_TIMEOUT_US;
+}
+
+/** @brief Write a control and count the frames until the image settles
+ * @ingroup ctrl
+ *
+ * The stream must have been started without a callback, since frames are
+ * taken with uvc_stream_get_frame(). The control is written directly, not
+ * through the writer thread, so the write's timing is known.
+ *
+ * Frames are numbered from the last frame completed when the write
+ * returned: frame 1 was on the wire during the write. The statistic is
+ * considered to have moved once it differs from the baseline by more than
+ * @c tolerance (relative) and more than three times the baseline's own
+ * frame-to-frame noise. It has settled at the frame after which
+ * @c stable_frames consecutive frames each stay within that threshold of
+ * their predecessor.
+ *
+ * @param strmh Polling stream on the device owning the control
+ * @param unit Unit or terminal ID of the control
+ * @param selector Control selector
+ * @param data New value, in wire format
+ * @param len Length of @p data
+ * @param params What to watch and when to stop, or NULL for the defaults
+ *   (see uvc_settle_params_init())
+ * @param[out] result Measurement
+ * @return UVC_SUCCESS, even if the image never moved or settled (see
+ *   @p result), or an error from the write or the stream
+ */
+uvc_error_t uvc_measure_ctrl_settle(uvc_stream_handle_t *strmh, uint8_t unit, uint8_t selector,
+                                    const void *data, int len, const uvc_settle_params_t *params,
+                                    uvc_settle_result_t *result) {
+  uvc_settle_params_t defaults;
+  uint32_t seq, last_seq, issue_seq;
+  double value, prev, sum = 0, noise = 0, threshold, issue_us, start_us, prev_us, now_us;
+  int i, stable = 0, ret;
+
+  UVC_ENTER();
+
+  if (!params) {
+    uvc_settle_params_init(&defaults);
+    params = &defaults;
+  }
+
+  memset(result, 0, sizeof(*result));
+  result->response_frames = -1;
+  result->settle_frames = -1;
+
+  /* baseline, and how much the statistic moves on its own */
+  for (i = 0; i < params->baseline_frames || i < 1; ++i) {
+    ret = settle_next_frame(strmh, params->frame_timeout_us, params->metric, &seq, &value);
+    if (ret != UVC_SUCCESS) {
+      UVC_EXIT(ret);
+      return ret;
+    }
+    if (i > 0 && settle_abs(value - prev) > noise)
+      noise = settle_abs(value - prev);
+    sum += value;
+    prev = value;
+  }
+  result->baseline = sum / i;
+
+  threshold = settle_abs(result->baseline) * params->tolerance;
+  if (threshold < 3 * noise)
+    threshold = 3 * noise;
+  if (threshold < SETTLE_MIN_DELTA)
+    threshold = SETTLE_MIN_DELTA;
+  result->threshold = threshold;
+
+  start_us = (double) uvc_now_us();
+  ret = uvc_set_ctrl_now(strmh->devh, unit, selector, data, len);
+  issue_us = (double) uvc_now_us();
+  if (ret != len) {
+    ret = ret < 0 ? ret : UVC_ERROR_IO;
+    UVC_EXIT(ret);
+    return ret;
+  }
+  result->write_us = issue_us - start_us;
+
+  pthread_mutex_lock(&strmh->cb_mutex);
+  issue_seq = strmh->hold_seq;
+  pthread_mutex_unlock(&strmh->cb_mutex);
+  result->issue_sequence = issue_seq;
+
+  prev = result->baseline;
+  prev_us = issue_us;
+  last_seq = issue_seq;
+  for (;;) {
+    int frame_no;
+
+    ret = settle_next_frame(strmh, params->frame_timeout_us, params->metric, &seq, &value);
+    if (ret != UVC_SUCCESS) {
+      UVC_EXIT(ret);
+      return ret;
+    }
+    if (seq <= issue_seq)
+      continue;
+    now_us = (double) uvc_now_us();
+
+    frame_no = (int) (seq - issue_seq);
+    result->frames_seen++;
+    result->frames_skipped += seq - last_seq - 1;
+    last_seq = seq;
+    result->settled = value;
+
+    if (result->response_frames < 0) {
+      if (settle_abs(value - result->baseline) > threshold)
+        result->response_frames = frame_no;
+    } else if (settle_abs(value - prev) <= threshold) {
+      /* the settled frame is the first of the stable run's predecessors */
+      if (++stable == 1) {
+        result->settle_frames = frame_no - 1;
+        result->settle_us = prev_us - issue_us;
+      }
+      if (stable >= params->stable_frames)
+        break;
+    } else {
+      stable = 0;
+      result->settle_frames = -1;
+    }
+    prev = value;
+    prev_us = now_us;
+
+    if (frame_no >= params->max_frames) {
+      if (stable < params->stable_frames) {
+        result->settle_frames = -1;
+        result->settle_us = 0;
+      }
+      break;
+    }
+  }
+
+  UVC_EXIT(UVC_SUCCESS);
+  return UVC_SUCCESS;
+}
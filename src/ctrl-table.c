@@ -0,0 +1,107 @@
+/* This is an AUTO-GENERATED file! Update it with the output of `ctrl-gen.py table`. */
+#include "libuvc/libuvc.h"
+#include "libuvc/libuvc_internal.h"
+
+/** @internal Every standard control described in standard-units.yaml */
+const uvc_ctrl_def_t uvc_ctrl_defs[] = {
+  { "scanning_mode", UVC_CTRL_UNIT_CAMERA_TERMINAL, UVC_CT_SCANNING_MODE_CONTROL, 1, 1,
+    { { "mode", 0, 1, 0 } } },
+  { "ae_mode", UVC_CTRL_UNIT_CAMERA_TERMINAL, UVC_CT_AE_MODE_CONTROL, 1, 1,
+    { { "mode", 0, 1, 0 } } },
+  { "ae_priority", UVC_CTRL_UNIT_CAMERA_TERMINAL, UVC_CT_AE_PRIORITY_CONTROL, 1, 1,
+    { { "priority", 0, 1, 0 } } },
+  { "exposure_abs", UVC_CTRL_UNIT_CAMERA_TERMINAL, UVC_CT_EXPOSURE_TIME_ABSOLUTE_CONTROL, 4, 1,
+    { { "time", 0, 4, 0 } } },
+  { "exposure_rel", UVC_CTRL_UNIT_CAMERA_TERMINAL, UVC_CT_EXPOSURE_TIME_RELATIVE_CONTROL, 1, 1,
+    { { "step", 0, 1, 1 } } },
+  { "focus_abs", UVC_CTRL_UNIT_CAMERA_TERMINAL, UVC_CT_FOCUS_ABSOLUTE_CONTROL, 2, 1,
+    { { "focus", 0, 2, 0 } } },
+  { "focus_rel", UVC_CTRL_UNIT_CAMERA_TERMINAL, UVC_CT_FOCUS_RELATIVE_CONTROL, 2, 2,
+    { { "focus_rel", 0, 1, 1 },
+      { "speed", 1, 1, 0 } } },
+  { "focus_simple_range", UVC_CTRL_UNIT_CAMERA_TERMINAL, UVC_CT_FOCUS_SIMPLE_CONTROL, 1, 1,
+    { { "focus", 0, 1, 0 } } },
+  { "focus_auto", UVC_CTRL_UNIT_CAMERA_TERMINAL, UVC_CT_FOCUS_AUTO_CONTROL, 1, 1,
+    { { "state", 0, 1, 0 } } },
+  { "iris_abs", UVC_CTRL_UNIT_CAMERA_TERMINAL, UVC_CT_IRIS_ABSOLUTE_CONTROL, 2, 1,
+    { { "iris", 0, 2, 0 } } },
+  { "iris_rel", UVC_CTRL_UNIT_CAMERA_TERMINAL, UVC_CT_IRIS_RELATIVE_CONTROL, 1, 1,
+    { { "iris_rel", 0, 1, 0 } } },
+  { "zoom_abs", UVC_CTRL_UNIT_CAMERA_TERMINAL, UVC_CT_ZOOM_ABSOLUTE_CONTROL, 2, 1,
+    { { "focal_length", 0, 2, 0 } } },
+  { "zoom_rel", UVC_CTRL_UNIT_CAMERA_TERMINAL, UVC_CT_ZOOM_RELATIVE_CONTROL, 3, 3,
+    { { "zoom_rel", 0, 1, 1 },
+      { "digital_zoom", 1, 1, 0 },
+      { "speed", 2, 1, 0 } } },
+  { "pantilt_abs", UVC_CTRL_UNIT_CAMERA_TERMINAL, UVC_CT_PANTILT_ABSOLUTE_CONTROL, 8, 2,
+    { { "pan", 0, 4, 1 },
+      { "tilt", 4, 4, 1 } } },
+  { "pantilt_rel", UVC_CTRL_UNIT_CAMERA_TERMINAL, UVC_CT_PANTILT_RELATIVE_CONTROL, 4, 4,
+    { { "pan_rel", 0, 1, 1 },
+      { "pan_speed", 1, 1, 0 },
+      { "tilt_rel", 2, 1, 1 },
+      { "tilt_speed", 3, 1, 0 } } },
+  { "roll_abs", UVC_CTRL_UNIT_CAMERA_TERMINAL, UVC_CT_ROLL_ABSOLUTE_CONTROL, 2, 1,
+    { { "roll", 0, 2, 1 } } },
+  { "roll_rel", UVC_CTRL_UNIT_CAMERA_TERMINAL, UVC_CT_ROLL_RELATIVE_CONTROL, 2, 2,
+    { { "roll_rel", 0, 1, 1 },
+      { "speed", 1, 1, 0 } } },
+  { "privacy", UVC_CTRL_UNIT_CAMERA_TERMINAL, UVC_CT_PRIVACY_CONTROL, 1, 1,
+    { { "privacy", 0, 1, 0 } } },
+  { "digital_window", UVC_CTRL_UNIT_CAMERA_TERMINAL, UVC_CT_DIGITAL_WINDOW_CONTROL, 12, 6,
+    { { "window_top", 0, 2, 0 },
+      { "window_left", 2, 2, 0 },
+      { "window_bottom", 4, 2, 0 },
+      { "window_right", 6, 2, 0 },
+      { "num_steps", 8, 2, 0 },
+      { "num_steps_units", 10, 2, 0 } } },
+  { "digital_roi", UVC_CTRL_UNIT_CAMERA_TERMINAL, UVC_CT_REGION_OF_INTEREST_CONTROL, 10, 5,
+    { { "roi_top", 0, 2, 0 },
+      { "roi_left", 2, 2, 0 },
+      { "roi_bottom", 4, 2, 0 },
+      { "roi_right", 6, 2, 0 },
+      { "auto_controls", 8, 2, 0 } } },
+  { "backlight_compensation", UVC_CTRL_UNIT_PROCESSING_UNIT, UVC_PU_BACKLIGHT_COMPENSATION_CONTROL, 2, 1,
+    { { "backlight_compensation", 0, 2, 0 } } },
+  { "brightness", UVC_CTRL_UNIT_PROCESSING_UNIT, UVC_PU_BRIGHTNESS_CONTROL, 2, 1,
+    { { "brightness", 0, 2, 1 } } },
+  { "contrast", UVC_CTRL_UNIT_PROCESSING_UNIT, UVC_PU_CONTRAST_CONTROL, 2, 1,
+    { { "contrast", 0, 2, 0 } } },
+  { "contrast_auto", UVC_CTRL_UNIT_PROCESSING_UNIT, UVC_PU_CONTRAST_AUTO_CONTROL, 1, 1,
+    { { "contrast_auto", 0, 1, 0 } } },
+  { "gain", UVC_CTRL_UNIT_PROCESSING_UNIT, UVC_PU_GAIN_CONTROL, 2, 1,
+    { { "gain", 0, 2, 0 } } },
+  { "power_line_frequency", UVC_CTRL_UNIT_PROCESSING_UNIT, UVC_PU_POWER_LINE_FREQUENCY_CONTROL, 1, 1,
+    { { "power_line_frequency", 0, 1, 0 } } },
+  { "hue", UVC_CTRL_UNIT_PROCESSING_UNIT, UVC_PU_HUE_CONTROL, 2, 1,
+    { { "hue", 0, 2, 1 } } },
+  { "hue_auto", UVC_CTRL_UNIT_PROCESSING_UNIT, UVC_PU_HUE_AUTO_CONTROL, 1, 1,
+    { { "hue_auto", 0, 1, 0 } } },
+  { "saturation", UVC_CTRL_UNIT_PROCESSING_UNIT, UVC_PU_SATURATION_CONTROL, 2, 1,
+    { { "saturation", 0, 2, 0 } } },
+  { "sharpness", UVC_CTRL_UNIT_PROCESSING_UNIT, UVC_PU_SHARPNESS_CONTROL, 2, 1,
+    { { "sharpness", 0, 2, 0 } } },
+  { "gamma", UVC_CTRL_UNIT_PROCESSING_UNIT, UVC_PU_GAMMA_CONTROL, 2, 1,
+    { { "gamma", 0, 2, 0 } } },
+  { "white_balance_temperature", UVC_CTRL_UNIT_PROCESSING_UNIT, UVC_PU_WHITE_BALANCE_TEMPERATURE_CONTROL, 2, 1,
+    { { "temperature", 0, 2, 0 } } },
+  { "white_balance_temperature_auto", UVC_CTRL_UNIT_PROCESSING_UNIT, UVC_PU_WHITE_BALANCE_TEMPERATURE_AUTO_CONTROL, 1, 1,
+    { { "temperature_auto", 0, 1, 0 } } },
+  { "white_balance_component", UVC_CTRL_UNIT_PROCESSING_UNIT, UVC_PU_WHITE_BALANCE_COMPONENT_CONTROL, 4, 2,
+    { { "blue", 0, 2, 0 },
+      { "red", 2, 2, 0 } } },
+  { "white_balance_component_auto", UVC_CTRL_UNIT_PROCESSING_UNIT, UVC_PU_WHITE_BALANCE_COMPONENT_AUTO_CONTROL, 1, 1,
+    { { "white_balance_component_auto", 0, 1, 0 } } },
+  { "digital_multiplier", UVC_CTRL_UNIT_PROCESSING_UNIT, UVC_PU_DIGITAL_MULTIPLIER_CONTROL, 2, 1,
+    { { "multiplier_step", 0, 2, 0 } } },
+  { "digital_multiplier_limit", UVC_CTRL_UNIT_PROCESSING_UNIT, UVC_PU_DIGITAL_MULTIPLIER_LIMIT_CONTROL, 2, 1,
+    { { "multiplier_step", 0, 2, 0 } } },
+  { "analog_video_standard", UVC_CTRL_UNIT_PROCESSING_UNIT, UVC_PU_ANALOG_VIDEO_STANDARD_CONTROL, 1, 1,
+    { { "video_standard", 0, 1, 0 } } },
+  { "analog_video_lock_status", UVC_CTRL_UNIT_PROCESSING_UNIT, UVC_PU_ANALOG_LOCK_STATUS_CONTROL, 1, 1,
+    { { "status", 0, 1, 0 } } },
+  { "input_select", UVC_CTRL_UNIT_SELECTOR_UNIT, UVC_SU_INPUT_SELECT_CONTROL, 1, 1,
+    { { "selector", 0, 1, 0 } } },
+};
+
+const size_t uvc_ctrl_def_count = sizeof(uvc_ctrl_defs) / sizeof(uvc_ctrl_defs[0]);
@@ -0,0 +1,375 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (C) 2010-2012 Ken Tossell
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the author nor other contributors may be
+*     used to endorse or promote products derived from this software
+*     without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+/**
+ * @internal
+ * @file ctrl-writer.c
+ * @brief Coalescing control writer thread.
+ *
+ * While a device's writer runs, uvc_set_ctrl() (and so every generated
+ * uvc_set_* accessor) only records the value and returns. The writer sends
+ * the latest recorded value of each control with SET_CUR, at most
+ * max_rate_hz requests per second. A value written again before the writer
+ * got to it replaces the old one, which is counted as coalesced.
+ *
+ * Each control has at most one pending value, and pending controls are
+ * sent oldest first, so a value waits at most as many send intervals as
+ * there are controls being written, however fast the application writes.
+ */
+#include "libuvc/libuvc.h"
+#include "libuvc/libuvc_internal.h"
+#include <time.h>
+
+/** The latest value written to one control */
+typedef struct uvc_ctrl_writer_slot {
+  struct uvc_ctrl_writer_slot *prev, *next;
+  uint8_t unit;
+  uint8_t selector;
+  uint8_t pending;
+  uint8_t *data;
+  int len;
+  int alloc;
+  /** Order in which pending slots are sent */
+  uint64_t seq;
+  /** When the pending value was first queued */
+  uint64_t queued_us;
+} uvc_ctrl_writer_slot_t;
+
+struct uvc_ctrl_writer {
+  uvc_device_handle_t *devh;
+  pthread_t thread;
+  pthread_mutex_t mutex;
+  pthread_cond_t cond;
+  int stop;
+  uint64_t interval_us;
+  uint64_t next_seq;
+  uvc_ctrl_writer_slot_t *slots;
+  uvc_ctrl_writer_stats_t stats;
+};
+
+static void writer_sleep_us(uint64_t us) {
+  struct timespec ts;
+
+  ts.tv_sec = us / 1000000;
+  ts.tv_nsec = (us % 1000000) * 1000;
+  nanosleep(&ts, NULL);
+}
+
+/* Caller holds the mutex */
+static uvc_ctrl_writer_slot_t *writer_oldest_pending(struct uvc_ctrl_writer *w) {
+  uvc_ctrl_writer_slot_t *slot, *oldest = NULL;
+
+  DL_FOREACH(w->slots, slot) {
+    if (slot->pending && (!oldest || slot->seq < oldest->seq))
+      oldest = slot;
+  }
+
+  return oldest;
+}
+
+/* Sends the oldest pending value. Called and returns with the mutex held;
+ * drops it around the transfer. Returns 0 if nothing was pending. */
+static int writer_send_one(struct uvc_ctrl_writer *w) {
+  uvc_ctrl_writer_slot_t *slot = writer_oldest_pending(w);
+  uint8_t buf[64];
+  uint8_t *data = buf;
+  uint8_t unit, selector;
+  uint64_t queued_us, latency_us;
+  int len, ret;
+
+  if (!slot)
+    return 0;
+
+  unit = slot->unit;
+  selector = slot->selector;
+  len = slot->len;
+  queued_us = slot->queued_us;
+  if (len > (int) sizeof(buf)) {
+    data = malloc(len);
+    if (!data) {
+      slot->pending = 0;
+      w->stats.failed++;
+      w->stats.last_error = UVC_ERROR_NO_MEM;
+      return 1;
+    }
+  }
+  memcpy(data, slot->data, len);
+  slot->pending = 0;
+
+  pthread_mutex_unlock(&w->mutex);
+  ret = uvc_set_ctrl_now(w->devh, unit, selector, data, len);
+  pthread_mutex_lock(&w->mutex);
+
+  if (data != buf)
+    free(data);
+
+  if (ret == len) {
+    w->stats.applied++;
+    latency_us = uvc_now_us() - queued_us;
+    if (latency_us > w->stats.max_latency_us)
+      w->stats.max_latency_us = latency_us;
+  } else {
+    w->stats.failed++;
+    w->stats.last_error = ret < 0 ? ret : UVC_ERROR_IO;
+  }
+
+  return 1;
+}
+
+static void *_uvc_ctrl_writer_thread(void *arg) {
+  struct uvc_ctrl_writer *w = arg;
+  uint64_t next_send_us = 0, now_us;
+
+  pthread_mutex_lock(&w->mutex);
+
+  for (;;) {
+    while (!w->stop && !writer_oldest_pending(w))
+      pthread_cond_wait(&w->cond, &w->mutex);
+
+    if (w->stop)
+      break;
+
+    now_us = uvc_now_us();
+    if (now_us < next_send_us) {
+      /* values written meanwhile replace the pending ones */
+      pthread_mutex_unlock(&w->mutex);
+      writer_sleep_us(next_send_us - now_us);
+      pthread_mutex_lock(&w->mutex);
+      continue;
+    }
+
+    next_send_us = now_us + w->interval_us;
+    writer_send_one(w);
+  }
+
+  /* send the final value of every control before stopping */
+  while (writer_send_one(w))
+    ;
+
+  pthread_mutex_unlock(&w->mutex);
+
+  return NULL;
+}
+
+/** @internal
+ * @brief Record a SET_CUR for the writer thread to send
+ *
+ * @return @p len, as if the value had been sent
+ */
+int uvc_ctrl_writer_queue(uvc_device_handle_t *devh, uint8_t unit, uint8_t selector,
+                          const void *data, int len) {
+  struct uvc_ctrl_writer *w = devh->ctrl_writer;
+  uvc_ctrl_writer_slot_t *slot;
+
+  if (len < 0)
+    return UVC_ERROR_INVALID_PARAM;
+
+  pthread_mutex_lock(&w->mutex);
+
+  DL_FOREACH(w->slots, slot) {
+    if (slot->unit == unit && slot->selector == selector)
+      break;
+  }
+
+  if (!slot) {
+    slot = calloc(1, sizeof(*slot));
+    if (!slot) {
+      pthread_mutex_unlock(&w->mutex);
+      return UVC_ERROR_NO_MEM;
+    }
+    slot->unit = unit;
+    slot->selector = selector;
+    DL_APPEND(w->slots, slot);
+  }
+
+  if (len > slot->alloc) {
+    uint8_t *p = realloc(slot->data, len);
+    if (!p) {
+      pthread_mutex_unlock(&w->mutex);
+      return UVC_ERROR_NO_MEM;
+    }
+    slot->data = p;
+    slot->alloc = len;
+  }
+
+  if (slot->pending) {
+    w->stats.coalesced++;
+  } else {
+    slot->pending = 1;
+    slot->seq = w->next_seq++;
+    slot->queued_us = uvc_now_us();
+  }
+  memcpy(slot->data, data, len);
+  slot->len = len;
+  w->stats.queued++;
+
+  pthread_cond_signal(&w->cond);
+  pthread_mutex_unlock(&w->mutex);
+
+  return len;
+}
+
+/** @brief Send control writes from a background thread, keeping only the
+ * latest value of each control
+ * @ingroup ctrl
+ *
+ * Once started, uvc_set_ctrl() and the generated uvc_set_* accessors
+ * return as soon as the value is recorded, and report success. The writer
+ * sends it unless a newer value for the same control arrives first. Send
+ * failures are counted in uvc_get_ctrl_writer_stats().
+ *
+ * @param devh UVC device handle
+ * @param max_rate_hz Most SET_CUR requests to send per second; 0 for no limit
+ * @return UVC_SUCCESS, UVC_ERROR_BUSY if the writer is already running, or
+ *   an error
+ */
+uvc_error_t uvc_start_ctrl_writer(uvc_device_handle_t *devh, uint32_t max_rate_hz) {
+  struct uvc_ctrl_writer *w;
+
+  UVC_ENTER();
+
+  pthread_mutex_lock(&devh->ctrl_writer_mutex);
+
+  if (devh->ctrl_writer) {
+    pthread_mutex_unlock(&devh->ctrl_writer_mutex);
+    UVC_EXIT(UVC_ERROR_BUSY);
+    return UVC_ERROR_BUSY;
+  }
+
+  w = calloc(1, sizeof(*w));
+  if (!w) {
+    pthread_mutex_unlock(&devh->ctrl_writer_mutex);
+    UVC_EXIT(UVC_ERROR_NO_MEM);
+    return UVC_ERROR_NO_MEM;
+  }
+
+  w->devh = devh;
+  w->interval_us = max_rate_hz ? 1000000 / max_rate_hz : 0;
+  pthread_mutex_init(&w->mutex, NULL);
+  pthread_cond_init(&w->cond, NULL);
+
+  devh->ctrl_writer = w;
+
+  if (pthread_create(&w->thread, NULL, _uvc_ctrl_writer_thread, w)) {
+    devh->ctrl_writer = NULL;
+    pthread_cond_destroy(&w->cond);
+    pthread_mutex_destroy(&w->mutex);
+    free(w);
+    pthread_mutex_unlock(&devh->ctrl_writer_mutex);
+    UVC_EXIT(UVC_ERROR_OTHER);
+    return UVC_ERROR_OTHER;
+  }
+
+  pthread_mutex_unlock(&devh->ctrl_writer_mutex);
+
+  UVC_EXIT(UVC_SUCCESS);
+  return UVC_SUCCESS;
+}
+
+/** @brief Stop the control writer thread
+ * @ingroup ctrl
+ *
+ * Values still pending are sent first. Afterwards uvc_set_ctrl() sends
+ * synchronously again. No other thread may be writing controls of the
+ * device meanwhile. uvc_close() calls this.
+ *
+ * @param devh UVC device handle
+ */
+void uvc_stop_ctrl_writer(uvc_device_handle_t *devh) {
+  struct uvc_ctrl_writer *w;
+  uvc_ctrl_writer_slot_t *slot, *tmp;
+
+  UVC_ENTER();
+
+  pthread_mutex_lock(&devh->ctrl_writer_mutex);
+
+  w = devh->ctrl_writer;
+  if (!w) {
+    pthread_mutex_unlock(&devh->ctrl_writer_mutex);
+    UVC_EXIT_VOID();
+    return;
+  }
+
+  /* later writes are sent synchronously */
+  devh->ctrl_writer = NULL;
+
+  pthread_mutex_lock(&w->mutex);
+  w->stop = 1;
+  pthread_cond_signal(&w->cond);
+  pthread_mutex_unlock(&w->mutex);
+
+  pthread_join(w->thread, NULL);
+
+  DL_FOREACH_SAFE(w->slots, slot, tmp) {
+    DL_DELETE(w->slots, slot);
+    free(slot->data);
+    free(slot);
+  }
+
+  pthread_cond_destroy(&w->cond);
+  pthread_mutex_destroy(&w->mutex);
+  free(w);
+
+  pthread_mutex_unlock(&devh->ctrl_writer_mutex);
+
+  UVC_EXIT_VOID();
+}
+
+/** @brief Read the control writer's counters
+ * @ingroup ctrl
+ *
+ * Safe to call while another thread starts or stops the writer.
+ *
+ * @param devh UVC device handle
+ * @param[out] stats Counters since the writer was started
+ * @return UVC_SUCCESS, or UVC_ERROR_INVALID_MODE if the writer is not running
+ */
+uvc_error_t uvc_get_ctrl_writer_stats(uvc_device_handle_t *devh, uvc_ctrl_writer_stats_t *stats) {
+  struct uvc_ctrl_writer *w;
+
+  pthread_mutex_lock(&devh->ctrl_writer_mutex);
+
+  w = devh->ctrl_writer;
+  if (!w) {
+    pthread_mutex_unlock(&devh->ctrl_writer_mutex);
+    return UVC_ERROR_INVALID_MODE;
+  }
+
+  pthread_mutex_lock(&w->mutex);
+  *stats = w->stats;
+  pthread_mutex_unlock(&w->mutex);
+
+  pthread_mutex_unlock(&devh->ctrl_writer_mutex);
+
+  return UVC_SUCCESS;
+}
@@ -0,0 +1,511 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (C) 2010-2012 Ken Tossell
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the author nor other contributors may be
+*     used to endorse or promote products derived from this software
+*     without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+/**
+ * @internal
+ * @file ctrl-xu.c
+ * @brief Extension unit control access with cached lengths and shadow
+ * values.
+ *
+ * Vendor extension unit controls have no fixed length, so plain access
+ * costs a GET_LEN before every request. Here each control's length is read
+ * once and kept in its control cache entry together with a shadow copy of
+ * the value last written to or read from it. A write of the value the
+ * shadow already holds is skipped, unless the control has been marked
+ * volatile because writing it has an effect beyond storing the value (a
+ * command register, or the address half of a register window).
+ *
+ * Shadows follow value change events from the status endpoint and are
+ * dropped, with the lengths, whenever the control cache is invalidated.
+ *
+ * Batches queue many writes and keep several of them in flight on the
+ * control pipe at once. Control transfers complete in the order they were
+ * submitted, so a batch reaches the device in order.
+ */
+#include "libuvc/libuvc.h"
+#include "libuvc/libuvc_internal.h"
+
+#define XU_BATCH_DEFAULT_IN_FLIGHT 8
+
+/** One queued write */
+typedef struct uvc_xu_write {
+  struct uvc_xu_batch *batch;
+  uint8_t unit;
+  uint8_t selector;
+  uint16_t len;
+  /** Where the value starts in the batch's data buffer */
+  size_t offset;
+} uvc_xu_write_t;
+
+struct uvc_xu_batch {
+  uvc_device_handle_t *devh;
+  uvc_xu_write_t *writes;
+  size_t num_writes, writes_alloc;
+  uint8_t *data;
+  size_t data_len, data_alloc;
+
+  /* submission state */
+  pthread_mutex_t mutex;
+  pthread_cond_t cond;
+  int in_flight;
+  int stop;
+  uvc_xu_batch_result_t result;
+};
+
+/* Length of a control, read from the device on first use. Also makes sure
+ * the entry has room for a shadow. */
+static int xu_len(uvc_device_handle_t *devh, uint8_t unit, uint8_t selector) {
+  uvc_ctrl_cache_entry_t *entry;
+  uint8_t buf[2];
+  int ret;
+
+  pthread_mutex_lock(&devh->ctrl_cache_mutex);
+  entry = uvc_ctrl_cache_entry(devh, unit, selector);
+  ret = entry && entry->xu_len ? entry->xu_len : 0;
+  pthread_mutex_unlock(&devh->ctrl_cache_mutex);
+
+  if (ret)
+    return ret;
+
+  ret = uvc_get_ctrl(devh, unit, selector, buf, 2, UVC_GET_LEN);
+  if (ret < 0)
+    return ret;
+  if (ret != 2 || SW_TO_SHORT(buf) == 0)
+    return UVC_ERROR_IO;
+  ret = SW_TO_SHORT(buf);
+
+  pthread_mutex_lock(&devh->ctrl_cache_mutex);
+  entry = uvc_ctrl_cache_entry(devh, unit, selector);
+  if (entry && !entry->xu_len) {
+    entry->xu_shadow = malloc(ret);
+    if (entry->xu_shadow)
+      entry->xu_len = (uint16_t) ret;
+  }
+  pthread_mutex_unlock(&devh->ctrl_cache_mutex);
+
+  return ret;
+}
+
+/* Whether the device already holds @p data; if not, and @p update is set,
+ * the shadow takes @p data on the assumption that the write will succeed */
+static int xu_shadow_matches(uvc_device_handle_t *devh, uint8_t unit, uint8_t selector,
+                             const void *data, int len, int update) {
+  uvc_ctrl_cache_entry_t *entry;
+  int matches = 0;
+
+  pthread_mutex_lock(&devh->ctrl_cache_mutex);
+
+  entry = uvc_ctrl_cache_entry(devh, unit, selector);
+  if (entry && entry->xu_shadow && entry->xu_len == len) {
+    matches = entry->xu_shadow_valid && !entry->xu_volatile &&
+      !memcmp(entry->xu_shadow, data, len);
+    if (!matches && update) {
+      memcpy(entry->xu_shadow, data, len);
+      entry->xu_shadow_valid = 1;
+    }
+  }
+
+  pthread_mutex_unlock(&devh->ctrl_cache_mutex);
+
+  return matches;
+}
+
+static void xu_shadow_drop(uvc_device_handle_t *devh, uint8_t unit, uint8_t selector) {
+  uvc_ctrl_cache_entry_t *entry;
+
+  pthread_mutex_lock(&devh->ctrl_cache_mutex);
+  entry = uvc_ctrl_cache_entry(devh, unit, selector);
+  if (entry)
+    entry->xu_shadow_valid = 0;
+  pthread_mutex_unlock(&devh->ctrl_cache_mutex);
+}
+
+/** @brief Length of an extension unit control
+ * @ingroup ctrl
+ *
+ * Read with GET_LEN the first time, and from memory until the control
+ * cache is invalidated.
+ *
+ * @param devh UVC device handle
+ * @param unit Extension unit ID
+ * @param selector Control selector
+ * @return Length in bytes, or a uvc_error_t
+ */
+int uvc_xu_get_len(uvc_device_handle_t *devh, uint8_t unit, uint8_t selector) {
+  return xu_len(devh, unit, selector);
+}
+
+/** @brief Read an extension unit control
+ * @ingroup ctrl
+ *
+ * Reads the whole control, whose length is cached (see uvc_xu_get_len()).
+ * A GET_CUR also refreshes the control's shadow.
+ *
+ * @param devh UVC device handle
+ * @param unit Extension unit ID
+ * @param selector Control selector
+ * @param[out] data Buffer for the value
+ * @param len Size of @p data; at least the control's length, except for
+ *   GET_INFO (1 byte) and GET_LEN (2 bytes)
+ * @param req_code GET_* request to execute
+ * @return Number of bytes read, or a uvc_error_t
+ */
+int uvc_xu_get(uvc_device_handle_t *devh, uint8_t unit, uint8_t selector, void *data, int len,
+               enum uvc_req_code req_code) {
+  int ctrl_len, ret;
+
+  if (req_code == UVC_GET_INFO || req_code == UVC_GET_LEN)
+    return uvc_get_ctrl(devh, unit, selector, data, len, req_code);
+
+  ctrl_len = xu_len(devh, unit, selector);
+  if (ctrl_len < 0)
+    return ctrl_len;
+  if (len < ctrl_len)
+    return UVC_ERROR_INVALID_PARAM;
+
+  ret = uvc_get_ctrl(devh, unit, selector, data, ctrl_len, req_code);
+  if (req_code == UVC_GET_CUR && ret == ctrl_len)
+    xu_shadow_matches(devh, unit, selector, data, ctrl_len, 1);
+
+  return ret;
+}
+
+/** @brief Write an extension unit control unless it already holds the value
+ * @ingroup ctrl
+ *
+ * The write is skipped if the control's shadow equals @p data and the
+ * control is not volatile (see uvc_xu_set_volatile()). The write goes
+ * straight to the device, bypassing the control writer thread, so that
+ * writes to extension units stay in order.
+ *
+ * @param devh UVC device handle
+ * @param unit Extension unit ID
+ * @param selector Control selector
+ * @param data New value
+ * @param len Length of @p data; must be the control's length
+ * @return @p len on success, whether or not the write was needed, or a
+ *   uvc_error_t
+ */
+int uvc_xu_set(uvc_device_handle_t *devh, uint8_t unit, uint8_t selector, const void *data,
+               int len) {
+  int ctrl_len, ret;
+
+  ctrl_len = xu_len(devh, unit, selector);
+  if (ctrl_len < 0)
+    return ctrl_len;
+  if (len != ctrl_len)
+    return UVC_ERROR_INVALID_PARAM;
+
+  if (xu_shadow_matches(devh, unit, selector, data, len, 0))
+    return len;
+
+  /* the shadow follows a successful write through uvc_ctrl_cache_update_cur() */
+  ret = uvc_set_ctrl_now(devh, unit, selector, data, len);
+  if (ret != len)
+    xu_shadow_drop(devh, unit, selector);
+
+  return ret;
+}
+
+/** @brief Copy an extension unit control's shadow without any USB traffic
+ * @ingroup ctrl
+ *
+ * @param devh UVC device handle
+ * @param unit Extension unit ID
+ * @param selector Control selector
+ * @param[out] data Buffer for the value
+ * @param len Size of @p data
+ * @return Number of bytes copied, or UVC_ERROR_NOT_FOUND if the value is
+ *   not known (never read or written, or invalidated since)
+ */
+int uvc_xu_get_shadow(uvc_device_handle_t *devh, uint8_t unit, uint8_t selector, void *data,
+                      int len) {
+  uvc_ctrl_cache_entry_t *entry;
+  int ret = UVC_ERROR_NOT_FOUND;
+
+  pthread_mutex_lock(&devh->ctrl_cache_mutex);
+
+  entry = uvc_ctrl_cache_entry(devh, unit, selector);
+  if (entry && entry->xu_shadow_valid) {
+    ret = len < entry->xu_len ? len : entry->xu_len;
+    memcpy(data, entry->xu_shadow, ret);
+  }
+
+  pthread_mutex_unlock(&devh->ctrl_cache_mutex);
+
+  return ret;
+}
+
+/** @brief Mark an extension unit control as volatile
+ * @ingroup ctrl
+ *
+ * Writes to a volatile control always reach the device. Use this for
+ * controls where writing has an effect beyond storing the value, such as
+ * command or address registers.
+ *
+ * @param devh UVC device handle
+ * @param unit Extension unit ID
+ * @param selector Control selector
+ * @param is_volatile Nonzero to never skip writes
+ */
+uvc_error_t uvc_xu_set_volatile(uvc_device_handle_t *devh, uint8_t unit, uint8_t selector,
+                                int is_volatile) {
+  uvc_ctrl_cache_entry_t *entry;
+
+  pthread_mutex_lock(&devh->ctrl_cache_mutex);
+  entry = uvc_ctrl_cache_entry(devh, unit, selector);
+  if (entry)
+    entry->xu_volatile = is_volatile ? 1 : 0;
+  pthread_mutex_unlock(&devh->ctrl_cache_mutex);
+
+  return entry ? UVC_SUCCESS : UVC_ERROR_NO_MEM;
+}
+
+/** @brief Create an empty batch of extension unit writes
+ * @ingroup ctrl
+ *
+ * @param devh UVC device handle
+ * @param[out] batch New batch; free it with uvc_xu_batch_free()
+ */
+uvc_error_t uvc_xu_batch_create(uvc_device_handle_t *devh, uvc_xu_batch_t **batch) {
+  uvc_xu_batch_t *b = calloc(1, sizeof(*b));
+
+  if (!b)
+    return UVC_ERROR_NO_MEM;
+
+  b->devh = devh;
+  pthread_mutex_init(&b->mutex, NULL);
+  pthread_cond_init(&b->cond, NULL);
+
+  *batch = b;
+
+  return UVC_SUCCESS;
+}
+
+/** @brief Queue a write; the value is copied
+ * @ingroup ctrl
+ *
+ * Nothing is sent until uvc_xu_batch_submit(). Writes are sent in the
+ * order they were added.
+ *
+ * @param batch Batch
+ * @param unit Extension unit ID
+ * @param selector Control selector
+ * @param data New value
+ * @param len Length of @p data; must be the control's length
+ */
+uvc_error_t uvc_xu_batch_add(uvc_xu_batch_t *batch, uint8_t unit, uint8_t selector,
+                             const void *data, int len) {
+  uvc_xu_write_t *write;
+
+  if (len <= 0 || len > UINT16_MAX)
+    return UVC_ERROR_INVALID_PARAM;
+
+  if (batch->num_writes == batch->writes_alloc) {
+    size_t alloc = batch->writes_alloc ? batch->writes_alloc * 2 : 16;
+    void *p = realloc(batch->writes, alloc * sizeof(*batch->writes));
+
+    if (!p)
+      return UVC_ERROR_NO_MEM;
+    batch->writes = p;
+    batch->writes_alloc = alloc;
+  }
+
+  if (batch->data_len + len > batch->data_alloc) {
+    size_t alloc = batch->data_alloc ? batch->data_alloc : 256;
+    void *p;
+
+    while (alloc < batch->data_len + len)
+      alloc *= 2;
+    p = realloc(batch->data, alloc);
+    if (!p)
+      return UVC_ERROR_NO_MEM;
+    batch->data = p;
+    batch->data_alloc = alloc;
+  }
+
+  write = &batch->writes[batch->num_writes++];
+  write->batch = batch;
+  write->unit = unit;
+  write->selector = selector;
+  write->len = (uint16_t) len;
+  write->offset = batch->data_len;
+  memcpy(batch->data + batch->data_len, data, len);
+  batch->data_len += len;
+
+  return UVC_SUCCESS;
+}
+
+static void xu_batch_fail(uvc_xu_batch_t *batch, size_t index, uvc_error_t error) {
+  batch->result.failed++;
+  if (!batch->stop) {
+    batch->stop = 1;
+    batch->result.first_error = error;
+    batch->result.first_failed = index;
+  }
+}
+
+static void xu_batch_cb(int result, void *data, void *user_ptr) {
+  uvc_xu_write_t *write = user_ptr;
+  uvc_xu_batch_t *batch = write->batch;
+
+  (void) data;
+
+  if (result != write->len)
+    xu_shadow_drop(batch->devh, write->unit, write->selector);
+
+  pthread_mutex_lock(&batch->mutex);
+  if (result == write->len)
+    batch->result.sent++;
+  else
+    xu_batch_fail(batch, write - batch->writes, result < 0 ? result : UVC_ERROR_IO);
+  batch->in_flight--;
+  pthread_cond_broadcast(&batch->cond);
+  pthread_mutex_unlock(&batch->mutex);
+}
+
+/** @brief Send a batch's writes and wait for them to complete
+ * @ingroup ctrl
+ *
+ * Writes of values the controls already hold are skipped, judged against
+ * the shadows as the earlier writes of the batch leave them. Up to
+ * @p max_in_flight writes are on the control pipe at once. After a write
+ * fails no further writes are submitted, but those already in flight
+ * complete.
+ *
+ * Completions are delivered by libusb event handling; if the application
+ * handles libusb events itself, it must keep doing so from another thread
+ * while this waits.
+ *
+ * The batch keeps its writes and may be submitted again, or emptied with
+ * uvc_xu_batch_clear().
+ *
+ * @param batch Batch
+ * @param max_in_flight Most writes outstanding at once, or 0 for the default (8)
+ * @param[out] result What happened to the writes, or NULL
+ * @return UVC_SUCCESS if every write was sent or skipped, otherwise the
+ *   error of the first failed write
+ */
+uvc_error_t uvc_xu_batch_submit(uvc_xu_batch_t *batch, int max_in_flight,
+                                uvc_xu_batch_result_t *result) {
+  uvc_device_handle_t *devh = batch->devh;
+  uvc_error_t ret;
+  size_t i;
+
+  UVC_ENTER();
+
+  if (max_in_flight <= 0)
+    max_in_flight = XU_BATCH_DEFAULT_IN_FLIGHT;
+
+  memset(&batch->result, 0, sizeof(batch->result));
+  batch->stop = 0;
+  batch->in_flight = 0;
+
+  for (i = 0; i < batch->num_writes; ++i) {
+    uvc_xu_write_t *write = &batch->writes[i];
+    uint8_t *data = batch->data + write->offset;
+    int len;
+
+    pthread_mutex_lock(&batch->mutex);
+    while (batch->in_flight >= max_in_flight)
+      pthread_cond_wait(&batch->cond, &batch->mutex);
+    if (batch->stop) {
+      pthread_mutex_unlock(&batch->mutex);
+      break;
+    }
+    pthread_mutex_unlock(&batch->mutex);
+
+    len = xu_len(devh, write->unit, write->selector);
+    if (len != write->len) {
+      pthread_mutex_lock(&batch->mutex);
+      xu_batch_fail(batch, i, len < 0 ? len : UVC_ERROR_INVALID_PARAM);
+      pthread_mutex_unlock(&batch->mutex);
+      break;
+    }
+
+    if (xu_shadow_matches(devh, write->unit, write->selector, data, len, 1)) {
+      batch->result.skipped++;
+      continue;
+    }
+
+    pthread_mutex_lock(&batch->mutex);
+    batch->in_flight++;
+    pthread_mutex_unlock(&batch->mutex);
+
+    ret = uvc_set_ctrl_async(devh, write->unit, write->selector, data, len,
+                             xu_batch_cb, write);
+    if (ret != UVC_SUCCESS) {
+      xu_shadow_drop(devh, write->unit, write->selector);
+      pthread_mutex_lock(&batch->mutex);
+      batch->in_flight--;
+      xu_batch_fail(batch, i, ret);
+      pthread_mutex_unlock(&batch->mutex);
+      break;
+    }
+  }
+
+  pthread_mutex_lock(&batch->mutex);
+  while (batch->in_flight > 0)
+    pthread_cond_wait(&batch->cond, &batch->mutex);
+  batch->result.unsent = batch->num_writes - batch->result.sent - batch->result.skipped -
+    batch->result.failed;
+  ret = batch->result.first_error;
+  if (result)
+    *result = batch->result;
+  pthread_mutex_unlock(&batch->mutex);
+
+  UVC_EXIT(ret);
+  return ret;
+}
+
+/** @brief Remove every write from a batch
+ * @ingroup ctrl
+ */
+void uvc_xu_batch_clear(uvc_xu_batch_t *batch) {
+  batch->num_writes = 0;
+  batch->data_len = 0;
+}
+
+/** @brief Free a batch
+ * @ingroup ctrl
+ */
+void uvc_xu_batch_free(uvc_xu_batch_t *batch) {
+  if (!batch)
+    return;
+
+  pthread_cond_destroy(&batch->cond);
+  pthread_mutex_destroy(&batch->mutex);
+  free(batch->writes);
+  free(batch->data);
+  free(batch);
+}
@@ -45,6 +45,27 @@
 static const int REQ_TYPE_SET = 0x21;
 static const int REQ_TYPE_GET = 0xa1;
 
+/** @internal
+ * @brief Synchronous control transfer on the handle's current usb_devh
+ *
+ * While uvc_reattach_device() is replacing usb_devh the device is gone, so
+ * this fails with UVC_ERROR_NO_DEVICE instead of waiting for it.
+ */
+int uvc_usb_control_transfer(uvc_device_handle_t *devh, uint8_t request_type, uint8_t request,
+                             uint16_t value, uint16_t index, unsigned char *data, uint16_t len) {
+  int ret;
+
+  if (pthread_rwlock_tryrdlock(&devh->usb_devh_lock))
+    return UVC_ERROR_NO_DEVICE;
+
+  ret = libusb_control_transfer(devh->usb_devh, request_type, request, value, index,
+                                data, len, 0 /* timeout */);
+
+  pthread_rwlock_unlock(&devh->usb_devh_lock);
+
+  return ret;
+}
+
 /***** GENERIC CONTROLS *****/
 /**
  * @brief Get the length of a control on a terminal or unit.
@@ -58,15 +79,9 @@ static const int REQ_TYPE_GET = 0xa1;
  */
 int uvc_get_ctrl_len(uvc_device_handle_t *devh, uint8_t unit, uint8_t ctrl) {
   unsigned char buf[2];
+  int ret;
 
-  int ret = libusb_control_transfer(
-    devh->usb_devh,
-    REQ_TYPE_GET, UVC_GET_LEN,
-    ctrl << 8,
-    unit << 8 | devh->info->ctrl_if.bInterfaceNumber,		// XXX saki
-    buf,
-    2,
-    0 /* timeout */);
+  ret = uvc_get_ctrl(devh, unit, ctrl, buf, 2, UVC_GET_LEN);
 
   if (ret < 0)
     return ret;
@@ -85,17 +100,36 @@ int uvc_get_ctrl_len(uvc_device_handle_t *devh, uint8_t unit, uint8_t ctrl) {
  * @param req_code GET_* request to execute
  * @return On success, the number of bytes actually transferred. Otherwise,
  *   a uvc_error_t error describing the error encountered.
+ *
+ * GET_MIN, GET_MAX, GET_RES, GET_LEN and GET_DEF are answered from the
+ * device's control range cache once they have been read
+ * (see uvc_set_ctrl_cache_enabled()), and so is GET_CUR if current values
+ * are cached (see uvc_set_ctrl_cur_cache()).
  * @ingroup ctrl
  */
 int uvc_get_ctrl(uvc_device_handle_t *devh, uint8_t unit, uint8_t ctrl, void *data, int len, enum uvc_req_code req_code) {
-  return libusb_control_transfer(
-    devh->usb_devh,
-    REQ_TYPE_GET, req_code,
-    ctrl << 8,
-    unit << 8 | devh->info->ctrl_if.bInterfaceNumber,		// XXX saki
-    data,
-    len,
-    0 /* timeout */);
+  int ret;
+
+  ret = uvc_ctrl_cache_lookup(devh, unit, ctrl, req_code, data, len);
+  if (ret >= 0)
+    return ret;
+
+#ifdef LIBUVC_HAS_SYNTHETIC
+  if (devh->synthetic)
+    ret = uvc_synthetic_ctrl_transfer(devh, req_code, unit, ctrl, data, len);
+  else
+#endif
+    ret = uvc_usb_control_transfer(
+      devh,
+      REQ_TYPE_GET, req_code,
+      ctrl << 8,
+      unit << 8 | devh->info->ctrl_if.bInterfaceNumber,		// XXX saki
+      data,
+      len);
+
+  uvc_ctrl_cache_store(devh, unit, ctrl, req_code, data, len, ret);
+
+  return ret;
 }
 
 /**
@@ -108,17 +142,66 @@ int uvc_get_ctrl(uvc_device_handle_t *devh, uint8_t unit, uint8_t ctrl, void *da
  * @param len Size of data buffer
  * @return On success, the number of bytes actually transferred. Otherwise,
  *   a uvc_error_t error describing the error encountered.
+ *
+ * While the device's control writer runs (see uvc_start_ctrl_writer()),
+ * the value is only handed to it and @p len is returned.
  * @ingroup ctrl
  */
 int uvc_set_ctrl(uvc_device_handle_t *devh, uint8_t unit, uint8_t ctrl, void *data, int len) {
-  return libusb_control_transfer(
-    devh->usb_devh,
-    REQ_TYPE_SET, UVC_SET_CUR,
-    ctrl << 8,
-    unit << 8 | devh->info->ctrl_if.bInterfaceNumber,		// XXX saki
-    data,
-    len,
-    0 /* timeout */);
+  if (devh->ctrl_writer)
+    return uvc_ctrl_writer_queue(devh, unit, ctrl, data, len);
+
+  return uvc_set_ctrl_now(devh, unit, ctrl, data, len);
+}
+
+/** @internal
+ * @brief Perform a SET_CUR request, bypassing the control writer
+ */
+int uvc_set_ctrl_now(uvc_device_handle_t *devh, uint8_t unit, uint8_t ctrl, const void *data, int len) {
+  int ret;
+
+#ifdef LIBUVC_HAS_SYNTHETIC
+  if (devh->synthetic)
+    ret = uvc_synthetic_ctrl_transfer(devh, UVC_SET_CUR, unit, ctrl, (void *) data, len);
+  else
+#endif
+    ret = uvc_usb_control_transfer(
+      devh,
+      REQ_TYPE_SET, UVC_SET_CUR,
+      ctrl << 8,
+      unit << 8 | devh->info->ctrl_if.bInterfaceNumber,		// XXX saki
+      (unsigned char *) data,
+      len);
+
+  if (ret == len)
+    uvc_ctrl_cache_update_cur(devh, unit, ctrl, data, len);
+
+  return ret;
+}
+
+/** @internal
+ * @brief Find the unit or terminal that carries a standard control
+ *
+ * @return The unit or terminal ID, or 0 if the device has no such unit
+ */
+uint8_t uvc_ctrl_def_unit_id(uvc_device_handle_t *devh, const uvc_ctrl_def_t *def) {
+  const uvc_input_terminal_t *term;
+  const uvc_processing_unit_t *proc;
+  const uvc_selector_unit_t *sel;
+
+  switch (def->unit_type) {
+  case UVC_CTRL_UNIT_CAMERA_TERMINAL:
+    term = uvc_get_camera_terminal(devh);
+    return term ? term->bTerminalID : 0;
+  case UVC_CTRL_UNIT_PROCESSING_UNIT:
+    proc = uvc_get_processing_units(devh);
+    return proc ? proc->bUnitID : 0;
+  case UVC_CTRL_UNIT_SELECTOR_UNIT:
+    sel = uvc_get_selector_units(devh);
+    return sel ? sel->bUnitID : 0;
+  }
+
+  return 0;
 }
 
 /***** INTERFACE CONTROLS *****/
@@ -126,14 +209,13 @@ uvc_error_t uvc_get_power_mode(uvc_device_handle_t *devh, enum uvc_device_power_
   uint8_t mode_char;
   uvc_error_t ret;
 
-  ret = libusb_control_transfer(
-    devh->usb_devh,
+  ret = uvc_usb_control_transfer(
+    devh,
     REQ_TYPE_GET, req_code,
     UVC_VC_VIDEO_POWER_MODE_CONTROL << 8,
     devh->info->ctrl_if.bInterfaceNumber,	// XXX saki
     &mode_char,
-    sizeof(mode_char),
-    0);
+    sizeof(mode_char));
 
   if (ret == 1) {
     *mode = mode_char;
@@ -147,14 +229,13 @@ uvc_error_t uvc_set_power_mode(uvc_device_handle_t *devh, enum uvc_device_power_
   uint8_t mode_char = mode;
   uvc_error_t ret;
 
-  ret = libusb_control_transfer(
-    devh->usb_devh,
+  ret = uvc_usb_control_transfer(
+    devh,
     REQ_TYPE_SET, UVC_SET_CUR,
     UVC_VC_VIDEO_POWER_MODE_CONTROL << 8,
     devh->info->ctrl_if.bInterfaceNumber,	// XXX saki
     &mode_char,
-    sizeof(mode_char),
-    0);
+    sizeof(mode_char));
 
   if (ret == 1)
     return UVC_SUCCESS;
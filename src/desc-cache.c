@@ -0,0 +1,697 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (C) 2010-2012 Ken Tossell
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the author nor other contributors may be
+*     used to endorse or promote products derived from this software
+*     without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+/**
+ * @internal
+ * @file desc-cache.c
+ * @brief On-disk cache of parsed descriptor trees.
+ *
+ * When a cache directory is set (uvc_set_desc_cache_dir()), uvc_open()
+ * looks for a file holding the uvc_device_info tree that parsing the
+ * device's configuration descriptor would build, and loads it instead of
+ * parsing. After a miss, the freshly parsed tree is written out for the
+ * next open.
+ *
+ * The file is a flat image of the tree's structs as this build lays them
+ * out, with every pointer stored as an offset into the image (plus one, so
+ * that zero stays NULL) and listed in a relocation table:
+ *
+ *   header: char[4] magic "UVCD", u32 version, u64 layout, u64 key,
+ *           u32 image size, u32 relocation count
+ *   image:  the uvc_device_info_t at offset 0, then the nodes it points to
+ *   relocs: u32 image offset of each non-NULL pointer
+ *
+ * A file is mapped and checked once per context. Loading a tree from it
+ * copies the image into one allocation and adds that allocation's address
+ * to each relocated pointer; nothing is parsed. Integers are in host order;
+ * the layout word, a hash of the struct sizes and pointer offsets, rejects
+ * files written by a build that lays the structs out differently.
+ *
+ * The key hashes the vendor and product IDs, bcdDevice and every field and
+ * class-specific byte of the configuration descriptor, so a firmware update
+ * or a different device revision gets a file of its own. The cache
+ * directory is trusted: the loader checks the relocations, not the values.
+ */
+#include "libuvc/libuvc.h"
+#include "libuvc/libuvc_internal.h"
+
+#include <fcntl.h>
+#include <stddef.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/* Bump when the parser starts filling in the tree differently */
+#define DESC_CACHE_VERSION 1
+
+#define DESC_CACHE_ALIGN 8
+#define DESC_CACHE_NULL ((size_t) -1)
+
+static const char desc_cache_magic[4] = { 'U', 'V', 'C', 'D' };
+
+struct desc_cache_header {
+  char magic[4];
+  uint32_t version;
+  uint64_t layout;
+  uint64_t key;
+  uint32_t image_size;
+  uint32_t num_relocs;
+};
+
+/** Image being built by the writer */
+struct desc_flat {
+  uint8_t *image;
+  size_t len, cap;
+  uint32_t *relocs;
+  size_t num_relocs, relocs_cap;
+  int failed;
+};
+
+static uint64_t fnv1a(uint64_t hash, const void *data, size_t len) {
+  const uint8_t *p = data;
+  size_t i;
+
+  for (i = 0; i < len; ++i) {
+    hash ^= p[i];
+    hash *= 0x100000001b3ULL;
+  }
+
+  return hash;
+}
+
+#define FNV_INIT 0xcbf29ce484222325ULL
+#define FNV_FIELD(hash, field) fnv1a(hash, &(field), sizeof(field))
+
+/* Struct sizes and pointer positions the image depends on */
+static uint64_t desc_cache_layout(void) {
+  static const size_t layout[] = {
+    sizeof(void *),
+    sizeof(uvc_device_info_t),
+    offsetof(uvc_device_info_t, ctrl_if),
+    offsetof(uvc_device_info_t, stream_ifs),
+    offsetof(uvc_device_info_t, flat),
+    offsetof(uvc_device_info_t, arena),
+    sizeof(uvc_control_interface_t),
+    offsetof(uvc_control_interface_t, input_term_descs),
+    offsetof(uvc_control_interface_t, selector_unit_descs),
+    offsetof(uvc_control_interface_t, processing_unit_descs),
+    offsetof(uvc_control_interface_t, extension_unit_descs),
+    sizeof(uvc_input_terminal_t),
+    sizeof(uvc_selector_unit_t),
+    sizeof(uvc_processing_unit_t),
+    sizeof(uvc_extension_unit_t),
+    sizeof(uvc_streaming_interface_t),
+    offsetof(uvc_streaming_interface_t, format_descs),
+    offsetof(uvc_streaming_interface_t, frame_index),
+    sizeof(uvc_format_desc_t),
+    offsetof(uvc_format_desc_t, frame_descs),
+    offsetof(uvc_format_desc_t, still_frame_desc),
+    sizeof(uvc_frame_desc_t),
+    offsetof(uvc_frame_desc_t, intervals),
+    sizeof(uvc_still_frame_desc_t),
+    offsetof(uvc_still_frame_desc_t, imageSizePatterns),
+    offsetof(uvc_still_frame_desc_t, bCompression),
+    sizeof(uvc_still_frame_res_t),
+  };
+
+  return fnv1a(FNV_INIT, layout, sizeof(layout));
+}
+
+/** @internal
+ * @brief Cache key of a device's descriptors
+ */
+uint64_t uvc_desc_cache_key(const struct libusb_device_descriptor *desc,
+                            const struct libusb_config_descriptor *config) {
+  uint64_t hash = FNV_INIT;
+  int i, a, e;
+
+  hash = FNV_FIELD(hash, desc->idVendor);
+  hash = FNV_FIELD(hash, desc->idProduct);
+  hash = FNV_FIELD(hash, desc->bcdDevice);
+
+  hash = FNV_FIELD(hash, config->wTotalLength);
+  hash = FNV_FIELD(hash, config->bNumInterfaces);
+  hash = FNV_FIELD(hash, config->bConfigurationValue);
+  hash = fnv1a(hash, config->extra, config->extra_length);
+
+  for (i = 0; i < config->bNumInterfaces; ++i) {
+    const struct libusb_interface *iface = &config->interface[i];
+
+    hash = FNV_FIELD(hash, iface->num_altsetting);
+    for (a = 0; a < iface->num_altsetting; ++a) {
+      const struct libusb_interface_descriptor *alt = &iface->altsetting[a];
+
+      hash = FNV_FIELD(hash, alt->bInterfaceNumber);
+      hash = FNV_FIELD(hash, alt->bAlternateSetting);
+      hash = FNV_FIELD(hash, alt->bNumEndpoints);
+      hash = FNV_FIELD(hash, alt->bInterfaceClass);
+      hash = FNV_FIELD(hash, alt->bInterfaceSubClass);
+      hash = FNV_FIELD(hash, alt->bInterfaceProtocol);
+      hash = fnv1a(hash, alt->extra, alt->extra_length);
+
+      for (e = 0; e < alt->bNumEndpoints; ++e) {
+        hash = FNV_FIELD(hash, alt->endpoint[e].bEndpointAddress);
+        hash = FNV_FIELD(hash, alt->endpoint[e].bmAttributes);
+        hash = FNV_FIELD(hash, alt->endpoint[e].wMaxPacketSize);
+        hash = fnv1a(hash, alt->endpoint[e].extra, alt->endpoint[e].extra_length);
+      }
+    }
+  }
+
+  return hash;
+}
+
+static char *desc_cache_path(const char *dir, const struct libusb_device_descriptor *desc,
+                             uint64_t key) {
+  size_t len = strlen(dir) + 64;
+  char *path = malloc(len);
+
+  if (path)
+    snprintf(path, len, "%s/%04x-%04x-%04x-%016llx.uvcd", dir, desc->idVendor,
+             desc->idProduct, desc->bcdDevice, (unsigned long long) key);
+
+  return path;
+}
+
+/** A validated cache file, mapped for the life of the context */
+struct uvc_desc_cache_file {
+  struct uvc_desc_cache_file *prev, *next;
+  uint64_t key;
+  void *map;
+  size_t map_len;
+  const uint8_t *image;
+  uint32_t image_size;
+  const uint32_t *relocs;
+  uint32_t num_relocs;
+};
+
+/* Map and check the file for @p key; NULL if there is no usable one */
+static struct uvc_desc_cache_file *desc_cache_map(const char *dir,
+                                                  const struct libusb_device_descriptor *desc,
+                                                  uint64_t key) {
+  struct uvc_desc_cache_file *file;
+  struct desc_cache_header hdr;
+  struct stat st;
+  uint8_t *map;
+  size_t image_off, i;
+  char *path;
+  int fd;
+
+  path = desc_cache_path(dir, desc, key);
+  if (!path)
+    return NULL;
+
+  fd = open(path, O_RDONLY);
+  free(path);
+  if (fd < 0)
+    return NULL;
+
+  if (fstat(fd, &st) || (size_t) st.st_size < sizeof(hdr) ||
+      pread(fd, &hdr, sizeof(hdr), 0) != sizeof(hdr)) {
+    close(fd);
+    return NULL;
+  }
+
+  image_off = (sizeof(hdr) + DESC_CACHE_ALIGN - 1) & ~(size_t) (DESC_CACHE_ALIGN - 1);
+  if (memcmp(hdr.magic, desc_cache_magic, 4) || hdr.version != DESC_CACHE_VERSION ||
+      hdr.layout != desc_cache_layout() || hdr.key != key ||
+      hdr.image_size < sizeof(uvc_device_info_t) || hdr.image_size % DESC_CACHE_ALIGN ||
+      (size_t) st.st_size != image_off + hdr.image_size + hdr.num_relocs * sizeof(uint32_t)) {
+    close(fd);
+    return NULL;
+  }
+
+  map = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (map == MAP_FAILED)
+    return NULL;
+
+  file = calloc(1, sizeof(*file));
+  if (!file) {
+    munmap(map, st.st_size);
+    return NULL;
+  }
+
+  file->key = key;
+  file->map = map;
+  file->map_len = st.st_size;
+  file->image = map + image_off;
+  file->image_size = hdr.image_size;
+  file->relocs = (const uint32_t *) (file->image + hdr.image_size);
+  file->num_relocs = hdr.num_relocs;
+
+  for (i = 0; i < file->num_relocs; ++i) {
+    uint32_t field = file->relocs[i];
+    uintptr_t value;
+
+    if (field % sizeof(uintptr_t) || field + sizeof(uintptr_t) > file->image_size)
+      break;
+    memcpy(&value, file->image + field, sizeof(value));
+    if (value == 0 || value > file->image_size)
+      break;
+  }
+
+  if (i != file->num_relocs) {
+    munmap(map, st.st_size);
+    free(file);
+    return NULL;
+  }
+
+  return file;
+}
+
+/** @internal
+ * @brief Load a cached descriptor tree
+ *
+ * The cache file is mapped on first use and stays mapped until the context
+ * is closed or the cache directory changes, so later opens of the same
+ * device cost one allocation, a copy and the pointer fixups. The tree is a
+ * single allocation (info->flat); free it with uvc_free_device_info() as
+ * usual. info->config is left NULL.
+ *
+ * @return UVC_SUCCESS, UVC_ERROR_NOT_FOUND if there is no usable file
+ */
+uvc_error_t uvc_desc_cache_load(uvc_context_t *ctx, const struct libusb_device_descriptor *desc,
+                                uint64_t key, uvc_device_info_t **info) {
+  struct uvc_desc_cache_file *file;
+  uint8_t *image;
+  uint32_t i;
+
+  pthread_mutex_lock(&ctx->desc_cache_mutex);
+
+  DL_FOREACH(ctx->desc_cache_files, file) {
+    if (file->key == key)
+      break;
+  }
+
+  if (!file && ctx->desc_cache_dir) {
+    file = desc_cache_map(ctx->desc_cache_dir, desc, key);
+    if (file)
+      DL_APPEND(ctx->desc_cache_files, file);
+  }
+
+  if (!file) {
+    pthread_mutex_unlock(&ctx->desc_cache_mutex);
+    return UVC_ERROR_NOT_FOUND;
+  }
+
+  image = malloc(file->image_size);
+  if (!image) {
+    pthread_mutex_unlock(&ctx->desc_cache_mutex);
+    return UVC_ERROR_NO_MEM;
+  }
+
+  memcpy(image, file->image, file->image_size);
+  for (i = 0; i < file->num_relocs; ++i) {
+    uintptr_t *field = (uintptr_t *) (image + file->relocs[i]);
+
+    *field = (uintptr_t) image + *field - 1;
+  }
+
+  pthread_mutex_unlock(&ctx->desc_cache_mutex);
+
+  *info = (uvc_device_info_t *) image;
+  (*info)->config = NULL;
+  (*info)->flat = 1;
+
+  return UVC_SUCCESS;
+}
+
+/** @internal
+ * @brief Unmap the context's cache files
+ */
+void uvc_desc_cache_free(uvc_context_t *ctx) {
+  struct uvc_desc_cache_file *file, *tmp;
+
+  pthread_mutex_lock(&ctx->desc_cache_mutex);
+  DL_FOREACH_SAFE(ctx->desc_cache_files, file, tmp) {
+    DL_DELETE(ctx->desc_cache_files, file);
+    munmap(file->map, file->map_len);
+    free(file);
+  }
+  pthread_mutex_unlock(&ctx->desc_cache_mutex);
+}
+
+/* Append a copy of @p size bytes; returns its offset */
+static size_t flat_add(struct desc_flat *f, const void *src, size_t size) {
+  size_t off = (f->len + DESC_CACHE_ALIGN - 1) & ~(size_t) (DESC_CACHE_ALIGN - 1);
+
+  if (off + size > f->cap) {
+    size_t cap = f->cap ? f->cap * 2 : 4096;
+    uint8_t *p;
+
+    while (cap < off + size)
+      cap *= 2;
+    p = realloc(f->image, cap);
+    if (!p) {
+      f->failed = 1;
+      return DESC_CACHE_NULL;
+    }
+    f->image = p;
+    f->cap = cap;
+  }
+
+  memset(f->image + f->len, 0, off - f->len);
+  memcpy(f->image + off, src, size);
+  f->len = off + size;
+
+  return off;
+}
+
+/* Point the pointer at image offset @p field to image offset @p target */
+static void flat_ptr(struct desc_flat *f, size_t field, size_t target) {
+  uintptr_t value = target == DESC_CACHE_NULL ? 0 : (uintptr_t) target + 1;
+
+  if (f->failed || field == DESC_CACHE_NULL)
+    return;
+
+  memcpy(f->image + field, &value, sizeof(value));
+  if (!value)
+    return;
+
+  if (f->num_relocs == f->relocs_cap) {
+    size_t cap = f->relocs_cap ? f->relocs_cap * 2 : 256;
+    uint32_t *p = realloc(f->relocs, cap * sizeof(*p));
+
+    if (!p) {
+      f->failed = 1;
+      return;
+    }
+    f->relocs = p;
+    f->relocs_cap = cap;
+  }
+  f->relocs[f->num_relocs++] = (uint32_t) field;
+}
+
+/* Copy a utlist DL list into consecutive nodes and link them up. Returns the
+ * offset of the first node, or DESC_CACHE_NULL for an empty list; *count
+ * gets the number of nodes, which are ALIGN(size) bytes apart. */
+static size_t flat_list(struct desc_flat *f, const void *head, size_t size,
+                        size_t prev_off, size_t next_off, int *count) {
+  size_t stride = (size + DESC_CACHE_ALIGN - 1) & ~(size_t) (DESC_CACHE_ALIGN - 1);
+  size_t first = DESC_CACHE_NULL, off;
+  const uint8_t *node;
+  int n = 0, k;
+
+  for (node = head; node; node = *(const uint8_t *const *) (node + next_off)) {
+    off = flat_add(f, node, size);
+    if (f->failed)
+      return DESC_CACHE_NULL;
+    if (!n)
+      first = off;
+    n++;
+  }
+
+  for (k = 0; k < n; ++k) {
+    off = first + k * stride;
+    flat_ptr(f, off + prev_off, first + (k ? k - 1 : n - 1) * stride);
+    flat_ptr(f, off + next_off, k + 1 < n ? first + (k + 1) * stride : DESC_CACHE_NULL);
+  }
+
+  *count = n;
+  return first;
+}
+
+#define FLAT_LIST(f, head, type, count) \
+  flat_list(f, head, sizeof(type), offsetof(type, prev), offsetof(type, next), count)
+#define FLAT_STRIDE(type) \
+  ((sizeof(type) + DESC_CACHE_ALIGN - 1) & ~(size_t) (DESC_CACHE_ALIGN - 1))
+
+static void flat_still_frames(struct desc_flat *f, const uvc_still_frame_desc_t *head,
+                              size_t format_off, size_t field) {
+  const uvc_still_frame_desc_t *still;
+  size_t first, off;
+  int n, k = 0;
+
+  first = FLAT_LIST(f, head, uvc_still_frame_desc_t, &n);
+  flat_ptr(f, field, first);
+
+  for (still = head; still && !f->failed; still = still->next, ++k) {
+    size_t res_first, comp = DESC_CACHE_NULL;
+    int res_n;
+
+    off = first + k * FLAT_STRIDE(uvc_still_frame_desc_t);
+    flat_ptr(f, off + offsetof(uvc_still_frame_desc_t, parent), format_off);
+
+    res_first = FLAT_LIST(f, still->imageSizePatterns, uvc_still_frame_res_t, &res_n);
+    flat_ptr(f, off + offsetof(uvc_still_frame_desc_t, imageSizePatterns), res_first);
+
+    if (still->bCompression && still->bNumCompressionPattern)
+      comp = flat_add(f, still->bCompression, still->bNumCompressionPattern);
+    flat_ptr(f, off + offsetof(uvc_still_frame_desc_t, bCompression), comp);
+  }
+}
+
+static void flat_frames(struct desc_flat *f, const uvc_frame_desc_t *head,
+                        size_t format_off, size_t field) {
+  const uvc_frame_desc_t *frame;
+  size_t first, off;
+  int n, k = 0;
+
+  first = FLAT_LIST(f, head, uvc_frame_desc_t, &n);
+  flat_ptr(f, field, first);
+
+  for (frame = head; frame && !f->failed; frame = frame->next, ++k) {
+    size_t intervals = DESC_CACHE_NULL;
+
+    off = first + k * FLAT_STRIDE(uvc_frame_desc_t);
+    flat_ptr(f, off + offsetof(uvc_frame_desc_t, parent), format_off);
+
+    if (frame->intervals) {
+      size_t count = 0;
+
+      while (frame->intervals[count])
+        count++;
+      intervals = flat_add(f, frame->intervals, (count + 1) * sizeof(frame->intervals[0]));
+    }
+    flat_ptr(f, off + offsetof(uvc_frame_desc_t, intervals), intervals);
+  }
+}
+
+/* Image offset of @p frame, whose format's frame list has been copied into
+ * the image; @p formats is the offset of @p stream_if's first format */
+static size_t flat_frame_offset(struct desc_flat *f, const uvc_streaming_interface_t *stream_if,
+                                size_t formats, const uvc_frame_desc_t *frame) {
+  const uvc_format_desc_t *format;
+  const uvc_frame_desc_t *p;
+  uintptr_t frames;
+  size_t j = 0, k = 0;
+
+  if (!frame || f->failed)
+    return DESC_CACHE_NULL;
+
+  for (format = stream_if->format_descs; format != frame->parent; format = format->next)
+    j++;
+  for (p = format->frame_descs; p != frame; p = p->next)
+    k++;
+
+  /* the format's frame_descs field already holds the list's offset + 1 */
+  memcpy(&frames, f->image + formats + j * FLAT_STRIDE(uvc_format_desc_t) +
+         offsetof(uvc_format_desc_t, frame_descs), sizeof(frames));
+
+  return frames - 1 + k * FLAT_STRIDE(uvc_frame_desc_t);
+}
+
+/* Copy a streaming interface's frame lookup table, pointing its slots at
+ * the copied frames */
+static void flat_frame_index(struct desc_flat *f, const uvc_streaming_interface_t *stream_if,
+                             size_t off, size_t formats) {
+  size_t table = DESC_CACHE_NULL, n, i;
+
+  if (stream_if->frame_index) {
+    n = (size_t) stream_if->frame_index_formats * stream_if->frame_index_frames;
+    table = flat_add(f, stream_if->frame_index, n * sizeof(stream_if->frame_index[0]));
+    for (i = 0; i < n && !f->failed; ++i)
+      flat_ptr(f, table + i * sizeof(stream_if->frame_index[0]),
+               flat_frame_offset(f, stream_if, formats, stream_if->frame_index[i]));
+  }
+  flat_ptr(f, off + offsetof(uvc_streaming_interface_t, frame_index), table);
+}
+
+static void flat_stream_ifs(struct desc_flat *f, const uvc_streaming_interface_t *head,
+                            size_t info_off) {
+  const uvc_streaming_interface_t *stream_if;
+  size_t first, off;
+  int n, k = 0;
+
+  first = FLAT_LIST(f, head, uvc_streaming_interface_t, &n);
+  flat_ptr(f, info_off + offsetof(uvc_device_info_t, stream_ifs), first);
+
+  for (stream_if = head; stream_if && !f->failed; stream_if = stream_if->next, ++k) {
+    const uvc_format_desc_t *format;
+    size_t formats;
+    int num_formats, j = 0;
+
+    off = first + k * FLAT_STRIDE(uvc_streaming_interface_t);
+    flat_ptr(f, off + offsetof(uvc_streaming_interface_t, parent), info_off);
+
+    formats = FLAT_LIST(f, stream_if->format_descs, uvc_format_desc_t, &num_formats);
+    flat_ptr(f, off + offsetof(uvc_streaming_interface_t, format_descs), formats);
+
+    for (format = stream_if->format_descs; format && !f->failed; format = format->next, ++j) {
+      size_t format_off = formats + j * FLAT_STRIDE(uvc_format_desc_t);
+
+      flat_ptr(f, format_off + offsetof(uvc_format_desc_t, parent), off);
+      flat_frames(f, format->frame_descs, format_off,
+                  format_off + offsetof(uvc_format_desc_t, frame_descs));
+      flat_still_frames(f, format->still_frame_desc, format_off,
+                        format_off + offsetof(uvc_format_desc_t, still_frame_desc));
+    }
+
+    flat_frame_index(f, stream_if, off, formats);
+  }
+}
+
+/** @internal
+ * @brief Write a parsed descriptor tree to the cache
+ *
+ * The file is written under a temporary name and renamed into place, so
+ * concurrent opens see either no file or a complete one.
+ */
+uvc_error_t uvc_desc_cache_store(const char *dir, const struct libusb_device_descriptor *desc,
+                                 uint64_t key, const uvc_device_info_t *info) {
+  struct desc_flat f;
+  struct desc_cache_header hdr;
+  static const uint8_t pad[DESC_CACHE_ALIGN];
+  size_t image_off, ctrl_off;
+  char *path, *tmp_path;
+  uvc_error_t ret = UVC_SUCCESS;
+  FILE *fp;
+  int n;
+
+  memset(&f, 0, sizeof(f));
+
+  /* the info struct itself, at offset 0 */
+  flat_add(&f, info, sizeof(*info));
+  flat_ptr(&f, offsetof(uvc_device_info_t, config), DESC_CACHE_NULL);
+  flat_ptr(&f, offsetof(uvc_device_info_t, arena), DESC_CACHE_NULL);
+  if (!f.failed) {
+    f.image[offsetof(uvc_device_info_t, flat)] = 0;
+  }
+
+  ctrl_off = offsetof(uvc_device_info_t, ctrl_if);
+  flat_ptr(&f, ctrl_off + offsetof(uvc_control_interface_t, parent), 0);
+  flat_ptr(&f, ctrl_off + offsetof(uvc_control_interface_t, input_term_descs),
+           FLAT_LIST(&f, info->ctrl_if.input_term_descs, uvc_input_terminal_t, &n));
+  flat_ptr(&f, ctrl_off + offsetof(uvc_control_interface_t, selector_unit_descs),
+           FLAT_LIST(&f, info->ctrl_if.selector_unit_descs, uvc_selector_unit_t, &n));
+  flat_ptr(&f, ctrl_off + offsetof(uvc_control_interface_t, processing_unit_descs),
+           FLAT_LIST(&f, info->ctrl_if.processing_unit_descs, uvc_processing_unit_t, &n));
+  flat_ptr(&f, ctrl_off + offsetof(uvc_control_interface_t, extension_unit_descs),
+           FLAT_LIST(&f, info->ctrl_if.extension_unit_descs, uvc_extension_unit_t, &n));
+
+  flat_stream_ifs(&f, info->stream_ifs, 0);
+  /* keep the relocation table after the image aligned */
+  flat_add(&f, pad, 0);
+
+  if (f.failed) {
+    ret = UVC_ERROR_NO_MEM;
+    goto done;
+  }
+
+  memset(&hdr, 0, sizeof(hdr));
+  memcpy(hdr.magic, desc_cache_magic, 4);
+  hdr.version = DESC_CACHE_VERSION;
+  hdr.layout = desc_cache_layout();
+  hdr.key = key;
+  hdr.image_size = (uint32_t) f.len;
+  hdr.num_relocs = (uint32_t) f.num_relocs;
+  image_off = (sizeof(hdr) + DESC_CACHE_ALIGN - 1) & ~(size_t) (DESC_CACHE_ALIGN - 1);
+
+  path = desc_cache_path(dir, desc, key);
+  tmp_path = path ? malloc(strlen(path) + 32) : NULL;
+  if (!tmp_path) {
+    free(path);
+    ret = UVC_ERROR_NO_MEM;
+    goto done;
+  }
+  sprintf(tmp_path, "%s.%ld.tmp", path, (long) getpid());
+
+  fp = fopen(tmp_path, "wb");
+  if (!fp) {
+    ret = UVC_ERROR_ACCESS;
+  } else {
+    if (fwrite(&hdr, sizeof(hdr), 1, fp) != 1 ||
+        (image_off > sizeof(hdr) && fwrite(pad, image_off - sizeof(hdr), 1, fp) != 1) ||
+        fwrite(f.image, f.len, 1, fp) != 1 ||
+        (f.num_relocs && fwrite(f.relocs, f.num_relocs * sizeof(uint32_t), 1, fp) != 1))
+      ret = UVC_ERROR_IO;
+    if (fclose(fp) && ret == UVC_SUCCESS)
+      ret = UVC_ERROR_IO;
+    if (ret == UVC_SUCCESS && rename(tmp_path, path))
+      ret = UVC_ERROR_IO;
+    if (ret != UVC_SUCCESS)
+      unlink(tmp_path);
+  }
+
+  free(tmp_path);
+  free(path);
+
+done:
+  free(f.image);
+  free(f.relocs);
+
+  return ret;
+}
+
+/** @brief Keep parsed descriptors in a directory, to skip parsing on later opens
+ * @ingroup init
+ *
+ * uvc_open() looks up each device in @p dir by a hash of its descriptors
+ * and maps the parsed form in if it is there; otherwise it parses as usual
+ * and saves the result. The directory must exist and be writable for new
+ * entries to be saved. Stale entries are never used, as a changed
+ * descriptor changes the hash, but are not removed either. Set the
+ * directory before opening devices, not while another thread opens one.
+ *
+ * @param ctx UVC context
+ * @param dir Cache directory, or NULL to stop using the cache
+ */
+uvc_error_t uvc_set_desc_cache_dir(uvc_context_t *ctx, const char *dir) {
+  char *copy = NULL;
+
+  if (dir) {
+    copy = strdup(dir);
+    if (!copy)
+      return UVC_ERROR_NO_MEM;
+  }
+
+  uvc_desc_cache_free(ctx);
+
+  pthread_mutex_lock(&ctx->desc_cache_mutex);
+  free(ctx->desc_cache_dir);
+  ctx->desc_cache_dir = copy;
+  pthread_mutex_unlock(&ctx->desc_cache_mutex);
+
+  return UVC_SUCCESS;
+}
@@ -0,0 +1,564 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (C) 2010-2012 Ken Tossell
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the author nor other contributors may be
+*     used to endorse or promote products derived from this software
+*     without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+/**
+ * @internal
+ * @file device-index.c
+ * @brief Per-context index of attached UVC devices, kept by hotplug events.
+ *
+ * Without the index, every uvc_find_device() walks the whole USB device
+ * list, reads each device's configuration descriptor and opens each UVC
+ * device to fetch its strings. With uvc_set_device_index_enabled(), a
+ * libusb hotplug callback maintains the set of UVC devices instead, and
+ * lookups by vendor/product ID, serial number or port path are hash table
+ * probes that never touch a non-video device.
+ *
+ * The callback runs on the event thread and only reads the configuration
+ * descriptor libusb has already cached; it does no I/O. Serial numbers need
+ * a string descriptor request, so they are fetched on the first lookup by
+ * serial, outside the index lock, and kept until the device leaves.
+ */
+#include "libuvc/libuvc.h"
+#include "libuvc/libuvc_internal.h"
+
+#define INDEX_BUCKETS 64
+#define INDEX_MAX_DEPTH 8
+
+struct uvc_index_entry {
+  uvc_device_t *dev;
+  uint16_t vid, pid;
+  uint8_t bus;
+  uint8_t num_ports;
+  uint8_t ports[INDEX_MAX_DEPTH];
+  uint8_t serial_fetched;
+  char *serial;
+  /** Hash chains by ID, serial and port path */
+  struct uvc_index_entry *next_id, *next_serial, *next_port;
+  struct uvc_index_entry *prev, *next;
+};
+
+struct uvc_device_index {
+  pthread_mutex_t mutex;
+  libusb_hotplug_callback_handle handle;
+  struct uvc_index_entry *entries;
+  struct uvc_index_entry *by_id[INDEX_BUCKETS];
+  struct uvc_index_entry *by_serial[INDEX_BUCKETS];
+  struct uvc_index_entry *by_port[INDEX_BUCKETS];
+};
+
+static uint32_t index_hash(const void *data, size_t len, uint32_t h) {
+  const uint8_t *p = data;
+  size_t i;
+
+  for (i = 0; i < len; ++i)
+    h = (h ^ p[i]) * 16777619u;
+
+  return h;
+}
+
+static uint32_t id_bucket(uint16_t vid, uint16_t pid) {
+  uint32_t id = ((uint32_t) vid << 16) | pid;
+  return index_hash(&id, sizeof(id), 2166136261u) % INDEX_BUCKETS;
+}
+
+static uint32_t serial_bucket(const char *serial) {
+  return index_hash(serial, strlen(serial), 2166136261u) % INDEX_BUCKETS;
+}
+
+static uint32_t port_bucket(uint8_t bus, const uint8_t *ports, int num_ports) {
+  return index_hash(ports, num_ports, index_hash(&bus, 1, 2166136261u)) % INDEX_BUCKETS;
+}
+
+/* Unlinks @p entry from the hash chain threaded through @p field */
+#define CHAIN_REMOVE(head, entry, field)                    \
+  do {                                                      \
+    struct uvc_index_entry **pp_ = &(head);                 \
+    while (*pp_ && *pp_ != (entry))                         \
+      pp_ = &(*pp_)->field;                                 \
+    if (*pp_)                                               \
+      *pp_ = (entry)->field;                                \
+  } while (0)
+
+static struct uvc_index_entry *index_find_usb(struct uvc_device_index *index,
+                                              struct libusb_device *usb_dev) {
+  struct uvc_index_entry *entry;
+
+  DL_FOREACH(index->entries, entry) {
+    if (entry->dev->usb_dev == usb_dev)
+      return entry;
+  }
+
+  return NULL;
+}
+
+static void index_add(uvc_context_t *ctx, struct libusb_device *usb_dev) {
+  struct uvc_device_index *index = ctx->dev_index;
+  struct libusb_device_descriptor desc;
+  struct uvc_index_entry *entry;
+  uint32_t b;
+  int n;
+
+  if (libusb_get_device_descriptor(usb_dev, &desc) != LIBUSB_SUCCESS ||
+      !uvc_is_video_device(ctx, usb_dev))
+    return;
+
+  /* out of memory: the device stays unindexed until it is replugged */
+  entry = calloc(1, sizeof(*entry));
+  if (!entry)
+    return;
+  entry->dev = malloc(sizeof(*entry->dev));
+  if (!entry->dev) {
+    free(entry);
+    return;
+  }
+  entry->dev->ctx = ctx;
+  entry->dev->ref = 0;
+  entry->dev->usb_dev = usb_dev;
+  uvc_ref_device(entry->dev);
+
+  entry->vid = desc.idVendor;
+  entry->pid = desc.idProduct;
+  entry->bus = libusb_get_bus_number(usb_dev);
+  n = libusb_get_port_numbers(usb_dev, entry->ports, INDEX_MAX_DEPTH);
+  entry->num_ports = n > 0 ? n : 0;
+  entry->serial_fetched = desc.iSerialNumber == 0;
+
+  pthread_mutex_lock(&index->mutex);
+  if (index_find_usb(index, usb_dev)) {
+    /* reported by both the enumeration pass and a real arrival */
+    pthread_mutex_unlock(&index->mutex);
+    uvc_unref_device(entry->dev);
+    free(entry);
+    return;
+  }
+  DL_APPEND(index->entries, entry);
+  b = id_bucket(entry->vid, entry->pid);
+  entry->next_id = index->by_id[b];
+  index->by_id[b] = entry;
+  b = port_bucket(entry->bus, entry->ports, entry->num_ports);
+  entry->next_port = index->by_port[b];
+  index->by_port[b] = entry;
+  pthread_mutex_unlock(&index->mutex);
+
+  UVC_DEBUG("indexed %04x:%04x on bus %d", entry->vid, entry->pid, entry->bus);
+}
+
+/* Called with the index lock held */
+static void index_unlink(struct uvc_device_index *index, struct uvc_index_entry *entry) {
+  DL_DELETE(index->entries, entry);
+  CHAIN_REMOVE(index->by_id[id_bucket(entry->vid, entry->pid)], entry, next_id);
+  CHAIN_REMOVE(index->by_port[port_bucket(entry->bus, entry->ports, entry->num_ports)], entry,
+               next_port);
+  if (entry->serial)
+    CHAIN_REMOVE(index->by_serial[serial_bucket(entry->serial)], entry, next_serial);
+}
+
+static void index_free_entry(struct uvc_index_entry *entry) {
+  uvc_unref_device(entry->dev);
+  free(entry->serial);
+  free(entry);
+}
+
+static void index_remove(uvc_context_t *ctx, struct libusb_device *usb_dev) {
+  struct uvc_device_index *index = ctx->dev_index;
+  struct uvc_index_entry *entry;
+
+  pthread_mutex_lock(&index->mutex);
+  entry = index_find_usb(index, usb_dev);
+  if (entry)
+    index_unlink(index, entry);
+  pthread_mutex_unlock(&index->mutex);
+
+  if (entry)
+    index_free_entry(entry);
+}
+
+static int LIBUSB_CALL index_hotplug_cb(struct libusb_context *usb_ctx,
+                                        struct libusb_device *usb_dev,
+                                        libusb_hotplug_event event, void *user_data) {
+  uvc_context_t *ctx = user_data;
+
+  (void) usb_ctx;
+
+  if (event == LIBUSB_HOTPLUG_EVENT_DEVICE_ARRIVED)
+    index_add(ctx, usb_dev);
+  else if (event == LIBUSB_HOTPLUG_EVENT_DEVICE_LEFT)
+    index_remove(ctx, usb_dev);
+
+  return 0;
+}
+
+static int entry_matches(const struct uvc_index_entry *entry, int vid, int pid, const char *sn) {
+  if ((vid && entry->vid != vid) || (pid && entry->pid != pid))
+    return 0;
+  if (sn && (!entry->serial || strcmp(entry->serial, sn)))
+    return 0;
+  return 1;
+}
+
+/* Reads the serial number of every candidate that has not been asked yet.
+ * The devices are opened here, so the index lock must not be held. */
+static void index_fetch_serials(uvc_context_t *ctx, int vid, int pid) {
+  struct uvc_device_index *index = ctx->dev_index;
+  struct uvc_index_entry *entry;
+  uvc_device_t **pending = NULL, **grown;
+  char **serials;
+  int num_pending = 0, i;
+
+  pthread_mutex_lock(&index->mutex);
+  DL_FOREACH(index->entries, entry) {
+    if (!entry->serial_fetched && entry_matches(entry, vid, pid, NULL)) {
+      /* the rest are asked next time */
+      grown = realloc(pending, (num_pending + 1) * sizeof(*pending));
+      if (!grown)
+        break;
+      pending = grown;
+      pending[num_pending++] = entry->dev;
+      uvc_ref_device(entry->dev);
+    }
+  }
+  pthread_mutex_unlock(&index->mutex);
+
+  if (!num_pending)
+    return;
+
+  serials = calloc(num_pending, sizeof(*serials));
+  if (!serials) {
+    for (i = 0; i < num_pending; ++i)
+      uvc_unref_device(pending[i]);
+    free(pending);
+    return;
+  }
+
+  /* devices not asked before are opened in parallel */
+  uvc_string_cache_prefetch(pending, num_pending);
+
+  for (i = 0; i < num_pending; ++i) {
+    struct libusb_device_descriptor desc;
+
+    if (libusb_get_device_descriptor(pending[i]->usb_dev, &desc) == LIBUSB_SUCCESS)
+      uvc_string_cache_fetch(pending[i], &desc, NULL, NULL, &serials[i]);
+  }
+
+  pthread_mutex_lock(&index->mutex);
+  for (i = 0; i < num_pending; ++i) {
+    /* the device may have left while we were asking it */
+    DL_FOREACH(index->entries, entry) {
+      if (entry->dev == pending[i])
+        break;
+    }
+    if (entry && !entry->serial_fetched) {
+      /* a device that could not be opened now is asked again next time */
+      if (serials[i]) {
+        uint32_t b = serial_bucket(serials[i]);
+        entry->serial = serials[i];
+        entry->serial_fetched = 1;
+        entry->next_serial = index->by_serial[b];
+        index->by_serial[b] = entry;
+        serials[i] = NULL;
+      }
+    }
+  }
+  pthread_mutex_unlock(&index->mutex);
+
+  for (i = 0; i < num_pending; ++i) {
+    free(serials[i]);
+    uvc_unref_device(pending[i]);
+  }
+  free(serials);
+  free(pending);
+}
+
+/* Appends @p dev, referenced, to a NULL-terminated list. On failure the
+ * list is left as it was. */
+static uvc_error_t list_append(uvc_device_t ***list, int *num, uvc_device_t *dev) {
+  uvc_device_t **grown = realloc(*list, (*num + 2) * sizeof(**list));
+
+  if (!grown)
+    return UVC_ERROR_NO_MEM;
+
+  *list = grown;
+  uvc_ref_device(dev);
+  (*list)[(*num)++] = dev;
+  (*list)[*num] = NULL;
+  return UVC_SUCCESS;
+}
+
+/** @internal
+ * @brief Look up indexed devices
+ * @ingroup device
+ *
+ * @param ctx Context with the index enabled
+ * @param vid Vendor ID to match, or 0 to match any
+ * @param pid Product ID to match, or 0 to match any
+ * @param sn Serial number to match, or NULL to match any
+ * @param max_devs Stop after this many matches, or 0 for no limit
+ * @param[out] list NULL-terminated list of referenced devices, possibly
+ * empty; free it with uvc_free_device_list()
+ */
+uvc_error_t uvc_device_index_find(uvc_context_t *ctx, int vid, int pid, const char *sn,
+                                  int max_devs, uvc_device_t ***list) {
+  struct uvc_device_index *index = ctx->dev_index;
+  struct uvc_index_entry *entry;
+  uvc_device_t **list_internal;
+  uvc_error_t ret = UVC_SUCCESS;
+  int num = 0;
+
+  UVC_ENTER();
+
+  if (sn)
+    index_fetch_serials(ctx, vid, pid);
+
+  list_internal = malloc(sizeof(*list_internal));
+  if (!list_internal) {
+    UVC_EXIT(UVC_ERROR_NO_MEM);
+    return UVC_ERROR_NO_MEM;
+  }
+  *list_internal = NULL;
+
+  pthread_mutex_lock(&index->mutex);
+  if (sn) {
+    for (entry = index->by_serial[serial_bucket(sn)]; entry; entry = entry->next_serial) {
+      if (entry_matches(entry, vid, pid, sn)) {
+        ret = list_append(&list_internal, &num, entry->dev);
+        if (ret != UVC_SUCCESS || num == max_devs)
+          break;
+      }
+    }
+  } else if (vid && pid) {
+    for (entry = index->by_id[id_bucket(vid, pid)]; entry; entry = entry->next_id) {
+      if (entry_matches(entry, vid, pid, NULL)) {
+        ret = list_append(&list_internal, &num, entry->dev);
+        if (ret != UVC_SUCCESS || num == max_devs)
+          break;
+      }
+    }
+  } else {
+    DL_FOREACH(index->entries, entry) {
+      if (entry_matches(entry, vid, pid, NULL)) {
+        ret = list_append(&list_internal, &num, entry->dev);
+        if (ret != UVC_SUCCESS || num == max_devs)
+          break;
+      }
+    }
+  }
+  pthread_mutex_unlock(&index->mutex);
+
+  if (ret != UVC_SUCCESS) {
+    uvc_free_device_list(list_internal, 1);
+    UVC_EXIT(ret);
+    return ret;
+  }
+
+  *list = list_internal;
+
+  UVC_EXIT(UVC_SUCCESS);
+  return UVC_SUCCESS;
+}
+
+static int ports_equal(uint8_t bus, const uint8_t *ports, int num_ports,
+                       uint8_t dev_bus, const uint8_t *dev_ports, int dev_num_ports) {
+  return bus == dev_bus && num_ports == dev_num_ports &&
+         !memcmp(ports, dev_ports, num_ports);
+}
+
+/** @brief Finds the camera attached at a given port
+ * @ingroup device
+ *
+ * The port path is the list of hub port numbers from the root hub down, as
+ * returned by libusb_get_port_numbers(). Unlike the bus address, it stays
+ * the same when the camera is replugged into the same port.
+ *
+ * @param ctx UVC context in which to search for the camera
+ * @param[out] dev Reference to the camera, or NULL if not found
+ * @param bus Bus number
+ * @param ports Port numbers from the root hub to the camera
+ * @param num_ports Number of entries in @p ports
+ * @return Error if unable to find the camera, else SUCCESS
+ */
+uvc_error_t uvc_find_device_by_port(uvc_context_t *ctx, uvc_device_t **dev,
+                                    uint8_t bus, const uint8_t *ports, int num_ports) {
+  struct libusb_device **usb_dev_list;
+  struct libusb_device *usb_dev;
+  uint8_t dev_ports[INDEX_MAX_DEPTH];
+  int num_usb_devices, n, dev_idx;
+
+  UVC_ENTER();
+
+  *dev = NULL;
+
+  if (num_ports < 0 || num_ports > INDEX_MAX_DEPTH) {
+    UVC_EXIT(UVC_ERROR_INVALID_PARAM);
+    return UVC_ERROR_INVALID_PARAM;
+  }
+
+  if (ctx->dev_index) {
+    struct uvc_device_index *index = ctx->dev_index;
+    struct uvc_index_entry *entry;
+
+    pthread_mutex_lock(&index->mutex);
+    for (entry = index->by_port[port_bucket(bus, ports, num_ports)]; entry;
+         entry = entry->next_port) {
+      if (ports_equal(bus, ports, num_ports, entry->bus, entry->ports, entry->num_ports)) {
+        uvc_ref_device(entry->dev);
+        *dev = entry->dev;
+        break;
+      }
+    }
+    pthread_mutex_unlock(&index->mutex);
+
+    UVC_EXIT(*dev ? UVC_SUCCESS : UVC_ERROR_NO_DEVICE);
+    return *dev ? UVC_SUCCESS : UVC_ERROR_NO_DEVICE;
+  }
+
+  num_usb_devices = libusb_get_device_list(ctx->usb_ctx, &usb_dev_list);
+
+  if (num_usb_devices < 0) {
+    UVC_EXIT(UVC_ERROR_IO);
+    return UVC_ERROR_IO;
+  }
+
+  dev_idx = -1;
+  while ((usb_dev = usb_dev_list[++dev_idx]) != NULL) {
+    n = libusb_get_port_numbers(usb_dev, dev_ports, INDEX_MAX_DEPTH);
+    if (n < 0 || !ports_equal(bus, ports, num_ports,
+                              libusb_get_bus_number(usb_dev), dev_ports, n))
+      continue;
+
+    if (uvc_is_video_device(ctx, usb_dev)) {
+      *dev = malloc(sizeof(**dev));
+      if (!*dev) {
+        libusb_free_device_list(usb_dev_list, 1);
+        UVC_EXIT(UVC_ERROR_NO_MEM);
+        return UVC_ERROR_NO_MEM;
+      }
+      (*dev)->ctx = ctx;
+      (*dev)->ref = 0;
+      (*dev)->usb_dev = usb_dev;
+      uvc_ref_device(*dev);
+    }
+    break;
+  }
+
+  libusb_free_device_list(usb_dev_list, 1);
+
+  UVC_EXIT(*dev ? UVC_SUCCESS : UVC_ERROR_NO_DEVICE);
+  return *dev ? UVC_SUCCESS : UVC_ERROR_NO_DEVICE;
+}
+
+/** @brief Keep an index of attached cameras instead of enumerating the bus
+ * @ingroup device
+ *
+ * While the index is enabled, uvc_get_device_list(), uvc_find_device(),
+ * uvc_find_devices() and uvc_find_device_by_port() answer from a table that
+ * libusb hotplug events keep current, without walking or opening every USB
+ * device. Hotplug events are delivered by libusb's event handling: libuvc
+ * runs it on its own thread if it created the USB context, otherwise the
+ * application must keep handling events, as it already has to for streams.
+ *
+ * @param ctx UVC context
+ * @param enabled Nonzero to build and maintain the index, zero to drop it
+ * @return UVC_ERROR_NOT_SUPPORTED if libusb has no hotplug support on this
+ * platform, else an error or SUCCESS
+ */
+uvc_error_t uvc_set_device_index_enabled(uvc_context_t *ctx, int enabled) {
+  struct uvc_device_index *index = ctx->dev_index;
+  struct uvc_index_entry *entry, *tmp;
+  int ret;
+
+  UVC_ENTER();
+
+  if (!enabled == !index) {
+    UVC_EXIT(UVC_SUCCESS);
+    return UVC_SUCCESS;
+  }
+
+  if (enabled) {
+    if (!libusb_has_capability(LIBUSB_CAP_HAS_HOTPLUG)) {
+      UVC_EXIT(UVC_ERROR_NOT_SUPPORTED);
+      return UVC_ERROR_NOT_SUPPORTED;
+    }
+
+    index = calloc(1, sizeof(*index));
+    if (!index) {
+      UVC_EXIT(UVC_ERROR_NO_MEM);
+      return UVC_ERROR_NO_MEM;
+    }
+    pthread_mutex_init(&index->mutex, NULL);
+    ctx->dev_index = index;
+
+    /* ENUMERATE reports the devices already attached before returning */
+    ret = libusb_hotplug_register_callback(
+        ctx->usb_ctx,
+        LIBUSB_HOTPLUG_EVENT_DEVICE_ARRIVED | LIBUSB_HOTPLUG_EVENT_DEVICE_LEFT,
+        LIBUSB_HOTPLUG_ENUMERATE, LIBUSB_HOTPLUG_MATCH_ANY, LIBUSB_HOTPLUG_MATCH_ANY,
+        LIBUSB_HOTPLUG_MATCH_ANY, index_hotplug_cb, ctx, &index->handle);
+    if (ret != LIBUSB_SUCCESS) {
+      ctx->dev_index = NULL;
+      DL_FOREACH_SAFE(index->entries, entry, tmp) {
+        DL_DELETE(index->entries, entry);
+        index_free_entry(entry);
+      }
+      pthread_mutex_destroy(&index->mutex);
+      free(index);
+      UVC_EXIT(ret);
+      return ret;
+    }
+
+    /* hotplug events need the event thread even with no device open */
+    if (ctx->own_usb_ctx && ctx->open_devices == NULL)
+      uvc_start_handler_thread(ctx);
+  } else {
+    libusb_hotplug_deregister_callback(ctx->usb_ctx, index->handle);
+
+    if (ctx->own_usb_ctx && ctx->open_devices == NULL) {
+      ctx->kill_handler_thread = 1;
+#if LIBUSB_API_VERSION >= 0x01000105
+      libusb_interrupt_event_handler(ctx->usb_ctx);
+#endif
+      pthread_join(ctx->handler_thread, NULL);
+      ctx->handler_thread_running = 0;
+    }
+
+    ctx->dev_index = NULL;
+    DL_FOREACH_SAFE(index->entries, entry, tmp) {
+      DL_DELETE(index->entries, entry);
+      index_free_entry(entry);
+    }
+    pthread_mutex_destroy(&index->mutex);
+    free(index);
+  }
+
+  UVC_EXIT(UVC_SUCCESS);
+  return UVC_SUCCESS;
+}
@@ -43,9 +43,7 @@ int uvc_already_open(uvc_context_t *ctx, struct libusb_device *usb_dev);
 void uvc_free_devh(uvc_device_handle_t *devh);
 
 uvc_error_t uvc_get_device_info(uvc_device_handle_t *devh, uvc_device_info_t **info);
-void uvc_free_device_info(uvc_device_info_t *info);
 
-uvc_error_t uvc_scan_control(uvc_device_handle_t *devh, uvc_device_info_t *info);
 uvc_error_t uvc_parse_vc(uvc_device_t *dev,
 			 uvc_device_info_t *info,
 			 const unsigned char *block, size_t block_size);
@@ -70,7 +68,8 @@ uvc_error_t uvc_parse_vc_processing_unit(uvc_device_t *dev,
 
 uvc_error_t uvc_scan_streaming(uvc_device_t *dev,
 			       uvc_device_info_t *info,
-			       int interface_idx);
+			       int interface_idx,
+			       uvc_streaming_interface_t **stream_ifs);
 uvc_error_t uvc_parse_vs(uvc_device_t *dev,
 			 uvc_device_info_t *info,
 			 uvc_streaming_interface_t *stream_if,
@@ -94,8 +93,6 @@ uvc_error_t uvc_parse_vs_input_header(uvc_streaming_interface_t *stream_if,
 				      const unsigned char *block,
 				      size_t block_size);
 
-void LIBUSB_CALL _uvc_status_callback(struct libusb_transfer *transfer);
-
 /** @internal
  * @brief Test whether the specified USB device has been opened as a UVC device
  * @ingroup device
@@ -115,6 +112,51 @@ int uvc_already_open(uvc_context_t *ctx, struct libusb_device *usb_dev) {
   return 0;
 }
 
+/** @internal
+ * @brief Pick the devices of @p list that match vendor, product and serial
+ *
+ * Vendor and product come from the cached device descriptor. Checking the
+ * serial number means opening the device, so that is left until the other
+ * fields have narrowed the list down, and the remaining candidates are then
+ * asked in parallel.
+ *
+ * @param[out] matches Space for as many devices as @p list holds; receives
+ *   the matches in list order, unreferenced
+ * @return Number of matches, at most @p max_matches
+ */
+static int uvc_match_devices(uvc_device_t **list, int vid, int pid, const char *sn,
+                             int max_matches, uvc_device_t **matches) {
+  struct libusb_device_descriptor desc;
+  int num_candidates = 0, num_matches = 0;
+  int dev_idx;
+
+  for (dev_idx = 0; list[dev_idx]; ++dev_idx) {
+    if (libusb_get_device_descriptor(list[dev_idx]->usb_dev, &desc) != LIBUSB_SUCCESS)
+      continue;
+
+    if ((!vid || desc.idVendor == vid) && (!pid || desc.idProduct == pid))
+      matches[num_candidates++] = list[dev_idx];
+  }
+
+  if (!sn)
+    return num_candidates < max_matches ? num_candidates : max_matches;
+
+  uvc_string_cache_prefetch(matches, num_candidates);
+
+  for (dev_idx = 0; dev_idx < num_candidates && num_matches < max_matches; ++dev_idx) {
+    char *serial = NULL;
+
+    if (libusb_get_device_descriptor(matches[dev_idx]->usb_dev, &desc) == LIBUSB_SUCCESS
+        && uvc_string_cache_fetch(matches[dev_idx], &desc, NULL, NULL, &serial) == UVC_SUCCESS
+        && serial && !strcmp(serial, sn))
+      matches[num_matches++] = matches[dev_idx];
+
+    free(serial);
+  }
+
+  return num_matches;
+}
+
 /** @brief Finds a camera identified by vendor, product and/or serial number
  * @ingroup device
  *
@@ -131,12 +173,23 @@ uvc_error_t uvc_find_device(
   uvc_error_t ret = UVC_SUCCESS;
 
   uvc_device_t **list;
-  uvc_device_t *test_dev;
-  int dev_idx;
-  int found_dev;
+  uvc_device_t **matches;
+  int num_devs;
 
   UVC_ENTER();
 
+  if (ctx->dev_index) {
+    ret = uvc_device_index_find(ctx, vid, pid, sn, 1, &list);
+    if (ret == UVC_SUCCESS) {
+      *dev = list[0];
+      free(list);
+      if (!*dev)
+        ret = UVC_ERROR_NO_DEVICE;
+    }
+    UVC_EXIT(ret);
+    return ret;
+  }
+
   ret = uvc_get_device_list(ctx, &list);
 
   if (ret != UVC_SUCCESS) {
@@ -144,36 +197,28 @@ uvc_error_t uvc_find_device(
     return ret;
   }
 
-  dev_idx = 0;
-  found_dev = 0;
-
-  while (!found_dev && (test_dev = list[dev_idx++]) != NULL) {
-    uvc_device_descriptor_t *desc;
+  for (num_devs = 0; list[num_devs]; ++num_devs)
+    ;
 
-    if (uvc_get_device_descriptor(test_dev, &desc) != UVC_SUCCESS)
-      continue;
-
-    if ((!vid || desc->idVendor == vid)
-        && (!pid || desc->idProduct == pid)
-        && (!sn || (desc->serialNumber && !strcmp(desc->serialNumber, sn))))
-      found_dev = 1;
-
-    uvc_free_device_descriptor(desc);
+  matches = malloc((num_devs + 1) * sizeof(*matches));
+  if (!matches) {
+    uvc_free_device_list(list, 1);
+    UVC_EXIT(UVC_ERROR_NO_MEM);
+    return UVC_ERROR_NO_MEM;
   }
 
-  if (found_dev)
-    uvc_ref_device(test_dev);
+  if (uvc_match_devices(list, vid, pid, sn, 1, matches)) {
+    *dev = matches[0];
+    uvc_ref_device(*dev);
+  } else {
+    ret = UVC_ERROR_NO_DEVICE;
+  }
 
+  free(matches);
   uvc_free_device_list(list, 1);
 
-  if (found_dev) {
-    *dev = test_dev;
-    UVC_EXIT(UVC_SUCCESS);
-    return UVC_SUCCESS;
-  } else {
-    UVC_EXIT(UVC_ERROR_NO_DEVICE);
-    return UVC_ERROR_NO_DEVICE;
-  }
+  UVC_EXIT(ret);
+  return ret;
 }
 
 /** @brief Finds all cameras identified by vendor, product and/or serial number
@@ -192,15 +237,26 @@ uvc_error_t uvc_find_devices(
   uvc_error_t ret = UVC_SUCCESS;
 
   uvc_device_t **list;
-  uvc_device_t *test_dev;
-  int dev_idx;
-  int found_dev;
-
   uvc_device_t **list_internal;
-  int num_uvc_devices;
+  int num_devs, num_uvc_devices;
+  int dev_idx;
 
   UVC_ENTER();
 
+  if (ctx->dev_index) {
+    ret = uvc_device_index_find(ctx, vid, pid, sn, 0, &list);
+    if (ret == UVC_SUCCESS) {
+      if (list[0]) {
+        *devs = list;
+      } else {
+        free(list);
+        ret = UVC_ERROR_NO_DEVICE;
+      }
+    }
+    UVC_EXIT(ret);
+    return ret;
+  }
+
   ret = uvc_get_device_list(ctx, &list);
 
   if (ret != UVC_SUCCESS) {
@@ -208,45 +264,33 @@ uvc_error_t uvc_find_devices(
     return ret;
   }
 
-  num_uvc_devices = 0;
-  dev_idx = 0;
-  found_dev = 0;
-
-  list_internal = malloc(sizeof(*list_internal));
-  *list_internal = NULL;
+  for (num_devs = 0; list[num_devs]; ++num_devs)
+    ;
 
-  while ((test_dev = list[dev_idx++]) != NULL) {
-    uvc_device_descriptor_t *desc;
-
-    if (uvc_get_device_descriptor(test_dev, &desc) != UVC_SUCCESS)
-      continue;
-
-    if ((!vid || desc->idVendor == vid)
-        && (!pid || desc->idProduct == pid)
-        && (!sn || (desc->serialNumber && !strcmp(desc->serialNumber, sn)))) {
-      found_dev = 1;
-      uvc_ref_device(test_dev);
-
-      num_uvc_devices++;
-      list_internal = realloc(list_internal, (num_uvc_devices + 1) * sizeof(*list_internal));
+  list_internal = malloc((num_devs + 1) * sizeof(*list_internal));
+  if (!list_internal) {
+    uvc_free_device_list(list, 1);
+    UVC_EXIT(UVC_ERROR_NO_MEM);
+    return UVC_ERROR_NO_MEM;
+  }
 
-      list_internal[num_uvc_devices - 1] = test_dev;
-      list_internal[num_uvc_devices] = NULL;
-    }
+  num_uvc_devices = uvc_match_devices(list, vid, pid, sn, num_devs, list_internal);
+  list_internal[num_uvc_devices] = NULL;
 
-    uvc_free_device_descriptor(desc);
-  }
+  for (dev_idx = 0; dev_idx < num_uvc_devices; ++dev_idx)
+    uvc_ref_device(list_internal[dev_idx]);
 
   uvc_free_device_list(list, 1);
 
-  if (found_dev) {
+  if (num_uvc_devices) {
     *devs = list_internal;
-    UVC_EXIT(UVC_SUCCESS);
-    return UVC_SUCCESS;
   } else {
-    UVC_EXIT(UVC_ERROR_NO_DEVICE);
-    return UVC_ERROR_NO_DEVICE;
+    free(list_internal);
+    ret = UVC_ERROR_NO_DEVICE;
   }
+
+  UVC_EXIT(ret);
+  return ret;
 }
 
 /** @brief Get the number of the bus to which the device is attached
@@ -263,7 +307,7 @@ uint8_t uvc_get_device_address(uvc_device_t *dev) {
   return libusb_get_device_address(dev->usb_dev);
 }
 
-static uvc_error_t uvc_open_internal(uvc_device_t *dev, struct libusb_device_handle *usb_devh, uvc_device_handle_t **devh);
+static uvc_error_t uvc_open_internal(uvc_device_t *dev, struct libusb_device_handle *usb_devh, uvc_device_handle_t **devh, int flags);
 
 #if LIBUSB_API_VERSION >= 0x01000107
 /** @brief Wrap a platform-specific system device handle and obtain a UVC device handle.
@@ -300,7 +344,7 @@ uvc_error_t uvc_wrap(
   dev->ctx = context;
   dev->usb_dev = libusb_get_device(usb_devh);
 
-  ret = uvc_open_internal(dev, usb_devh, devh);
+  ret = uvc_open_internal(dev, usb_devh, devh, 0);
   UVC_EXIT(ret);
   return ret;
 }
@@ -316,6 +360,34 @@ uvc_error_t uvc_wrap(
 uvc_error_t uvc_open(
     uvc_device_t *dev,
     uvc_device_handle_t **devh) {
+  return uvc_open_with_flags(dev, devh, 0);
+}
+
+/** @brief Open a UVC device, doing less work up front
+ * @ingroup device
+ *
+ * With UVC_OPEN_DEFER_STREAMING, only the VideoControl interface is parsed
+ * at open time. Each VideoStreaming interface is parsed when it is first
+ * needed: uvc_stream_open_ctrl() and the still capture functions parse just
+ * the interface they use, while uvc_get_format_descs(),
+ * uvc_get_stream_ctrl_format_size() and the other functions that look at
+ * every interface parse them all. Interfaces parsed this way are listed in
+ * interface number order.
+ *
+ * With UVC_OPEN_NO_STATUS, the status interrupt endpoint is left alone.
+ *
+ * Only the VideoControl interface is claimed at open time; streaming
+ * interfaces are claimed when a stream is set up on them.
+ *
+ * @param dev Device to open
+ * @param[out] devh Handle on opened device
+ * @param flags Bitwise OR of uvc_open_flag values
+ * @return Error opening device or SUCCESS
+ */
+uvc_error_t uvc_open_with_flags(
+    uvc_device_t *dev,
+    uvc_device_handle_t **devh,
+    int flags) {
   uvc_error_t ret;
   struct libusb_device_handle *usb_devh;
 
@@ -329,7 +401,7 @@ uvc_error_t uvc_open(
     return ret;
   }
 
-  ret = uvc_open_internal(dev, usb_devh, devh);
+  ret = uvc_open_internal(dev, usb_devh, devh, flags);
   UVC_EXIT(ret);
   return ret;
 }
@@ -337,7 +409,8 @@ uvc_error_t uvc_open(
 static uvc_error_t uvc_open_internal(
     uvc_device_t *dev,
     struct libusb_device_handle *usb_devh,
-    uvc_device_handle_t **devh) {
+    uvc_device_handle_t **devh,
+    int flags) {
   uvc_error_t ret;
   uvc_device_handle_t *internal_devh;
   struct libusb_device_descriptor desc;
@@ -347,8 +420,19 @@ static uvc_error_t uvc_open_internal(
   uvc_ref_device(dev);
 
   internal_devh = calloc(1, sizeof(*internal_devh));
+  uvc_ctrl_cache_init(internal_devh);
+  uvc_ctrl_async_init(internal_devh);
+  uvc_status_init(internal_devh);
+  pthread_mutex_init(&internal_devh->info_mutex, NULL);
+  pthread_mutex_init(&internal_devh->ctrl_writer_mutex, NULL);
+  pthread_rwlock_init(&internal_devh->usb_devh_lock, NULL);
   internal_devh->dev = dev;
   internal_devh->usb_devh = usb_devh;
+  internal_devh->open_flags = flags;
+
+  libusb_get_device_descriptor(dev->usb_dev, &desc);
+  uvc_quirks_lookup(dev->ctx, desc.idVendor, desc.idProduct, desc.bcdDevice,
+                    &internal_devh->quirks);
 
   ret = uvc_get_device_info(internal_devh, &(internal_devh->info));
 
@@ -360,35 +444,14 @@ static uvc_error_t uvc_open_internal(
   if (ret != UVC_SUCCESS)
     goto fail;
 
-  libusb_get_device_descriptor(dev->usb_dev, &desc);
-  internal_devh->is_isight = (desc.idVendor == 0x05ac && desc.idProduct == 0x8501);
-
-  if (internal_devh->info->ctrl_if.bEndpointAddress) {
-    internal_devh->status_xfer = libusb_alloc_transfer(0);
-    if (!internal_devh->status_xfer) {
-      ret = UVC_ERROR_NO_MEM;
-      goto fail;
-    }
-
-    libusb_fill_interrupt_transfer(internal_devh->status_xfer,
-                                   usb_devh,
-                                   internal_devh->info->ctrl_if.bEndpointAddress,
-                                   internal_devh->status_buf,
-                                   sizeof(internal_devh->status_buf),
-                                   _uvc_status_callback,
-                                   internal_devh,
-                                   0);
-    ret = libusb_submit_transfer(internal_devh->status_xfer);
-    UVC_DEBUG("libusb_submit_transfer() = %d", ret);
-
-    if (ret) {
-      fprintf(stderr,
-              "uvc: device has a status interrupt endpoint, but unable to read from it\n");
-      goto fail;
-    }
+  ret = uvc_status_start(internal_devh);
+  if (ret != UVC_SUCCESS) {
+    fprintf(stderr,
+            "uvc: device has a status interrupt endpoint, but unable to read from it\n");
+    goto fail;
   }
 
-  if (dev->ctx->own_usb_ctx && dev->ctx->open_devices == NULL) {
+  if (dev->ctx->own_usb_ctx && dev->ctx->open_devices == NULL && !dev->ctx->dev_index) {
     /* Since this is our first device, we need to spawn the event handler thread */
     uvc_start_handler_thread(dev->ctx);
   }
@@ -413,6 +476,84 @@ static uvc_error_t uvc_open_internal(
   return ret;
 }
 
+/** @internal
+ * @brief Move an open handle onto a re-enumerated instance of its device
+ * @ingroup device
+ *
+ * After the device dropped off the bus and came back, opens @p dev, claims
+ * the interfaces the handle had claimed, restarts the status transfers and
+ * writes the cached control values back. The descriptors parsed at open
+ * time are kept; @p dev must be the same model. Streams are not touched.
+ *
+ * Control requests from other threads, the control writer's included,
+ * fail with UVC_ERROR_NO_DEVICE until the new handle is in place, and the
+ * asynchronous requests and status transfers still on the old handle are
+ * retired before it is closed.
+ *
+ * On failure the handle is left without a working device, ready for
+ * another attempt.
+ *
+ * @param devh Handle whose device is gone
+ * @param dev The device's new instance; a reference is taken
+ */
+uvc_error_t uvc_reattach_device(uvc_device_handle_t *devh, uvc_device_t *dev) {
+  struct libusb_device_handle *usb_devh;
+  uvc_device_t *old_dev;
+  uint32_t wanted;
+  uvc_error_t ret;
+  int idx;
+
+  UVC_ENTER();
+
+  ret = libusb_open(dev->usb_dev, &usb_devh);
+  UVC_DEBUG("libusb_open() = %d", ret);
+  if (ret != UVC_SUCCESS) {
+    UVC_EXIT(ret);
+    return ret;
+  }
+
+  pthread_rwlock_wrlock(&devh->usb_devh_lock);
+  uvc_ctrl_async_drain(devh);
+  uvc_status_drain(devh);
+
+  /* the dead handle's claims go with it */
+  libusb_close(devh->usb_devh);
+  devh->usb_devh = usb_devh;
+  wanted = devh->claimed;
+  devh->claimed = 0;
+
+  old_dev = devh->dev;
+  uvc_ref_device(dev);
+  devh->dev = dev;
+  uvc_unref_device(old_dev);
+
+  for (idx = 0; idx < 32; ++idx) {
+    if (!(wanted & (1u << idx)))
+      continue;
+    ret = uvc_claim_if(devh, idx);
+    if (ret != UVC_SUCCESS) {
+      devh->claimed = wanted;
+      pthread_rwlock_unlock(&devh->usb_devh_lock);
+      UVC_EXIT(ret);
+      return ret;
+    }
+  }
+
+  pthread_rwlock_unlock(&devh->usb_devh_lock);
+
+  ret = uvc_status_restart(devh);
+  if (ret != UVC_SUCCESS) {
+    UVC_EXIT(ret);
+    return ret;
+  }
+
+  uvc_ctrl_cache_restore(devh);
+  devh->usb_generation++;
+
+  UVC_EXIT(UVC_SUCCESS);
+  return UVC_SUCCESS;
+}
+
 /**
  * @internal
  * @brief Parses the complete device descriptor for a device
@@ -426,6 +567,9 @@ uvc_error_t uvc_get_device_info(uvc_device_handle_t *devh,
 				uvc_device_info_t **info) {
   uvc_error_t ret;
   uvc_device_info_t *internal_info;
+  struct libusb_device_descriptor desc;
+  const char *cache_dir;
+  uint64_t key = 0;
 
   UVC_ENTER();
 
@@ -443,13 +587,43 @@ uvc_error_t uvc_get_device_info(uvc_device_handle_t *devh,
     return UVC_ERROR_IO;
   }
 
-  ret = uvc_scan_control(devh, internal_info);
+  ret = libusb_get_device_descriptor(devh->dev->usb_dev, &desc);
   if (ret != UVC_SUCCESS) {
     uvc_free_device_info(internal_info);
     UVC_EXIT(ret);
     return ret;
   }
 
+  internal_info->defer_streaming = !!(devh->open_flags & UVC_OPEN_DEFER_STREAMING);
+
+  cache_dir = devh->dev->ctx->desc_cache_dir;
+  if (cache_dir) {
+    uvc_device_info_t *cached;
+
+    key = uvc_desc_cache_key(&desc, internal_info->config);
+    if (uvc_desc_cache_load(devh->dev->ctx, &desc, key, &cached) == UVC_SUCCESS) {
+      UVC_DEBUG("descriptors for %04x:%04x from cache", desc.idVendor, desc.idProduct);
+      cached->config = internal_info->config;
+      free(internal_info);
+      *info = cached;
+      UVC_EXIT(UVC_SUCCESS);
+      return UVC_SUCCESS;
+    }
+  }
+
+  ret = uvc_scan_control(devh->dev, internal_info, desc.idVendor, desc.idProduct);
+  if (ret != UVC_SUCCESS) {
+    uvc_free_device_info(internal_info);
+    UVC_EXIT(ret);
+    return ret;
+  }
+
+  /* a deferred tree is saved once it is complete */
+  if (cache_dir && !internal_info->deferred_ifs &&
+      uvc_desc_cache_store(cache_dir, &desc, key, internal_info) != UVC_SUCCESS) {
+    UVC_DEBUG("could not cache descriptors in %s", cache_dir);
+  }
+
   *info = internal_info;
 
   UVC_EXIT(ret);
@@ -464,63 +638,11 @@ uvc_error_t uvc_get_device_info(uvc_device_handle_t *devh,
  * @param info Which device info block to free
  */
 void uvc_free_device_info(uvc_device_info_t *info) {
-  uvc_input_terminal_t *input_term, *input_term_tmp;
-  uvc_processing_unit_t *proc_unit, *proc_unit_tmp;
-  uvc_extension_unit_t *ext_unit, *ext_unit_tmp;
-
-  uvc_streaming_interface_t *stream_if, *stream_if_tmp;
-  uvc_format_desc_t *format, *format_tmp;
-  uvc_frame_desc_t *frame, *frame_tmp;
-  uvc_still_frame_desc_t *still_frame, *still_frame_tmp;
-  uvc_still_frame_res_t *still_res, *still_res_tmp;
-
   UVC_ENTER();
 
-  DL_FOREACH_SAFE(info->ctrl_if.input_term_descs, input_term, input_term_tmp) {
-    DL_DELETE(info->ctrl_if.input_term_descs, input_term);
-    free(input_term);
-  }
-
-  DL_FOREACH_SAFE(info->ctrl_if.processing_unit_descs, proc_unit, proc_unit_tmp) {
-    DL_DELETE(info->ctrl_if.processing_unit_descs, proc_unit);
-    free(proc_unit);
-  }
-
-  DL_FOREACH_SAFE(info->ctrl_if.extension_unit_descs, ext_unit, ext_unit_tmp) {
-    DL_DELETE(info->ctrl_if.extension_unit_descs, ext_unit);
-    free(ext_unit);
-  }
-
-  DL_FOREACH_SAFE(info->stream_ifs, stream_if, stream_if_tmp) {
-    DL_FOREACH_SAFE(stream_if->format_descs, format, format_tmp) {
-      DL_FOREACH_SAFE(format->frame_descs, frame, frame_tmp) {
-        if (frame->intervals)
-          free(frame->intervals);
-
-        DL_DELETE(format->frame_descs, frame);
-        free(frame);
-      }
-
-      if(format->still_frame_desc) {
-        DL_FOREACH_SAFE(format->still_frame_desc, still_frame, still_frame_tmp) {
-          DL_FOREACH_SAFE(still_frame->imageSizePatterns, still_res, still_res_tmp) {
-            free(still_res);
-          }
-
-          if(still_frame->bCompression) {
-              free(still_frame->bCompression);
-          }
-          free(still_frame);
-        }
-      }
-
-      DL_DELETE(stream_if->format_descs, format);
-      free(format);
-    }
-
-    DL_DELETE(info->stream_ifs, stream_if);
-    free(stream_if);
-  }
+  /* a parsed tree's nodes are all in info->arena; a cached tree is one
+   * allocation with info at its start and no arena */
+  free(info->arena);
 
   if (info->config)
     libusb_free_config_descriptor(info->config);
@@ -530,53 +652,6 @@ void uvc_free_device_info(uvc_device_info_t *info) {
   UVC_EXIT_VOID();
 }
 
-static uvc_error_t get_device_descriptor(
-        uvc_device_handle_t *devh,
-        uvc_device_descriptor_t **desc) {
-  uvc_device_descriptor_t *desc_internal;
-  struct libusb_device_descriptor usb_desc;
-  struct libusb_device_handle *usb_devh = devh->usb_devh;
-  uvc_error_t ret;
-
-  UVC_ENTER();
-
-  ret = libusb_get_device_descriptor(devh->dev->usb_dev, &usb_desc);
-
-  if (ret != UVC_SUCCESS) {
-    UVC_EXIT(ret);
-    return ret;
-  }
-
-  desc_internal = calloc(1, sizeof(*desc_internal));
-  desc_internal->idVendor = usb_desc.idVendor;
-  desc_internal->idProduct = usb_desc.idProduct;
-
-  unsigned char buf[64];
-
-  int bytes = libusb_get_string_descriptor_ascii(
-          usb_devh, usb_desc.iSerialNumber, buf, sizeof(buf));
-
-  if (bytes > 0)
-    desc_internal->serialNumber = strdup((const char*) buf);
-
-  bytes = libusb_get_string_descriptor_ascii(
-          usb_devh, usb_desc.iManufacturer, buf, sizeof(buf));
-
-  if (bytes > 0)
-    desc_internal->manufacturer = strdup((const char*) buf);
-
-  bytes = libusb_get_string_descriptor_ascii(
-          usb_devh, usb_desc.iProduct, buf, sizeof(buf));
-
-  if (bytes > 0)
-    desc_internal->product = strdup((const char*) buf);
-
-  *desc = desc_internal;
-
-  UVC_EXIT(ret);
-  return ret;
-}
-
 /**
  * @brief Get a descriptor that contains the general information about
  * a device
@@ -593,7 +668,6 @@ uvc_error_t uvc_get_device_descriptor(
     uvc_device_descriptor_t **desc) {
   uvc_device_descriptor_t *desc_internal;
   struct libusb_device_descriptor usb_desc;
-  struct libusb_device_handle *usb_devh;
   uvc_error_t ret;
 
   UVC_ENTER();
@@ -609,29 +683,10 @@ uvc_error_t uvc_get_device_descriptor(
   desc_internal->idVendor = usb_desc.idVendor;
   desc_internal->idProduct = usb_desc.idProduct;
 
-  if (libusb_open(dev->usb_dev, &usb_devh) == 0) {
-    unsigned char buf[64];
-
-    int bytes = libusb_get_string_descriptor_ascii(
-        usb_devh, usb_desc.iSerialNumber, buf, sizeof(buf));
-
-    if (bytes > 0)
-      desc_internal->serialNumber = strdup((const char*) buf);
-
-    bytes = libusb_get_string_descriptor_ascii(
-        usb_devh, usb_desc.iManufacturer, buf, sizeof(buf));
-
-    if (bytes > 0)
-      desc_internal->manufacturer = strdup((const char*) buf);
-
-    bytes = libusb_get_string_descriptor_ascii(
-        usb_devh, usb_desc.iProduct, buf, sizeof(buf));
-
-    if (bytes > 0)
-      desc_internal->product = strdup((const char*) buf);
-
-    libusb_close(usb_devh);
-  } else {
+  /* strings come from the context's cache, which opens the device on a miss */
+  if (uvc_string_cache_fetch(dev, &usb_desc, (char **) &desc_internal->manufacturer,
+                             (char **) &desc_internal->product,
+                             (char **) &desc_internal->serialNumber) != UVC_SUCCESS) {
     UVC_DEBUG("can't open device %04x:%04x, not fetching serial etc.",
 	      usb_desc.idVendor, usb_desc.idProduct);
   }
@@ -666,10 +721,75 @@ void uvc_free_device_descriptor(
   UVC_EXIT_VOID();
 }
 
+/** @internal
+ * @brief Test whether a USB device has a VideoStreaming interface
+ * @ingroup device
+ *
+ * Reads only the cached configuration descriptor, without opening the device.
+ */
+int uvc_is_video_device(uvc_context_t *ctx, struct libusb_device *usb_dev) {
+  struct libusb_config_descriptor *config;
+  struct libusb_device_descriptor desc;
+  uvc_quirks_t quirks;
+  const struct libusb_interface *interface;
+  const struct libusb_interface_descriptor *if_desc;
+  int interface_idx, altsetting_idx;
+  uint8_t got_interface = 0;
+
+  if (libusb_get_config_descriptor(usb_dev, 0, &config) != 0)
+    return 0;
+
+  if ( libusb_get_device_descriptor ( usb_dev, &desc ) != LIBUSB_SUCCESS ) {
+    libusb_free_config_descriptor(config);
+    return 0;
+  }
+
+  uvc_quirks_lookup(ctx, desc.idVendor, desc.idProduct, desc.bcdDevice, &quirks);
+
+  // Skip cameras that definitely aren't UVC even though they might
+  // look that way
+  if (quirks.flags & UVC_QUIRK_NOT_UVC) {
+    libusb_free_config_descriptor(config);
+    return 0;
+  }
+
+  for (interface_idx = 0;
+       !got_interface && interface_idx < config->bNumInterfaces;
+       ++interface_idx) {
+    interface = &config->interface[interface_idx];
+
+    for (altsetting_idx = 0;
+         !got_interface && altsetting_idx < interface->num_altsetting;
+         ++altsetting_idx) {
+      if_desc = &interface->altsetting[altsetting_idx];
+
+      // Special case for cameras with vendor-specific video interfaces
+      /* Video, Streaming */
+      if ((quirks.flags & UVC_QUIRK_VENDOR_CLASS) &&
+          if_desc->bInterfaceClass == 255 &&
+          if_desc->bInterfaceSubClass == 2 ) {
+        got_interface = 1;
+      }
+
+      /* Video, Streaming */
+      if (if_desc->bInterfaceClass == 14 && if_desc->bInterfaceSubClass == 2) {
+        got_interface = 1;
+      }
+    }
+  }
+
+  libusb_free_config_descriptor(config);
+
+  return got_interface;
+}
+
 /**
  * @brief Get a list of the UVC devices attached to the system
  * @ingroup device
  *
+ * With the device index enabled (uvc_set_device_index_enabled()), the list
+ * comes from the index and no USB device is queried.
+ *
  * @note Free the list with uvc_free_device_list when you're done.
  *
  * @param ctx UVC context in which to list devices
@@ -688,20 +808,15 @@ uvc_error_t uvc_get_device_list(
 
   /* per device */
   int dev_idx;
-  struct libusb_config_descriptor *config;
-  struct libusb_device_descriptor desc;
-  uint8_t got_interface;
-
-  /* per interface */
-  int interface_idx;
-  const struct libusb_interface *interface;
-
-  /* per altsetting */
-  int altsetting_idx;
-  const struct libusb_interface_descriptor *if_desc;
 
   UVC_ENTER();
 
+  if (ctx->dev_index) {
+    uvc_error_t ret = uvc_device_index_find(ctx, 0, 0, NULL, 0, list);
+    UVC_EXIT(ret);
+    return ret;
+  }
+
   num_usb_devices = libusb_get_device_list(ctx->usb_ctx, &usb_dev_list);
 
   if (num_usb_devices < 0) {
@@ -716,51 +831,7 @@ uvc_error_t uvc_get_device_list(
   dev_idx = -1;
 
   while ((usb_dev = usb_dev_list[++dev_idx]) != NULL) {
-    got_interface = 0;
-
-    if (libusb_get_config_descriptor(usb_dev, 0, &config) != 0)
-      continue;
-
-    if ( libusb_get_device_descriptor ( usb_dev, &desc ) != LIBUSB_SUCCESS )
-      continue;
-
-    for (interface_idx = 0;
-	 !got_interface && interface_idx < config->bNumInterfaces;
-	 ++interface_idx) {
-      interface = &config->interface[interface_idx];
-
-      for (altsetting_idx = 0;
-	   !got_interface && altsetting_idx < interface->num_altsetting;
-	   ++altsetting_idx) {
-	if_desc = &interface->altsetting[altsetting_idx];
-
-        // Skip TIS cameras that definitely aren't UVC even though they might
-        // look that way
-
-        if ( 0x199e == desc.idVendor && desc.idProduct  >= 0x8201 &&
-            desc.idProduct <= 0x8208 ) {
-          continue;
-        }
-
-        // Special case for Imaging Source cameras
-	/* Video, Streaming */
-        if ( 0x199e == desc.idVendor && ( 0x8101 == desc.idProduct ||
-            0x8102 == desc.idProduct ) &&
-            if_desc->bInterfaceClass == 255 &&
-            if_desc->bInterfaceSubClass == 2 ) {
-	  got_interface = 1;
-	}
-
-	/* Video, Streaming */
-	if (if_desc->bInterfaceClass == 14 && if_desc->bInterfaceSubClass == 2) {
-	  got_interface = 1;
-	}
-      }
-    }
-
-    libusb_free_config_descriptor(config);
-
-    if (got_interface) {
+    if (uvc_is_video_device(ctx, usb_dev)) {
       uvc_device_t *uvc_dev = malloc(sizeof(*uvc_dev));
       uvc_dev->ctx = ctx;
       uvc_dev->ref = 0;
@@ -938,7 +1009,7 @@ const uvc_extension_unit_t *uvc_get_extension_units(uvc_device_handle_t *devh) {
 void uvc_ref_device(uvc_device_t *dev) {
   UVC_ENTER();
 
-  dev->ref++;
+  __atomic_add_fetch(&dev->ref, 1, __ATOMIC_RELAXED);
   libusb_ref_device(dev->usb_dev);
 
   UVC_EXIT_VOID();
@@ -955,9 +1026,9 @@ void uvc_unref_device(uvc_device_t *dev) {
   UVC_ENTER();
 
   libusb_unref_device(dev->usb_dev);
-  dev->ref--;
 
-  if (dev->ref == 0)
+  /* the device index may drop its reference from the event thread */
+  if (__atomic_sub_fetch(&dev->ref, 1, __ATOMIC_ACQ_REL) == 0)
     free(dev);
 
   UVC_EXIT_VOID();
@@ -1042,36 +1113,279 @@ uvc_error_t uvc_release_if(uvc_device_handle_t *devh, int idx) {
   return ret;
 }
 
+/* Hand out @p n entries of one of the arena's arrays, or NULL if the count
+ * pass set aside fewer */
+#define DESC_ARENA_TAKE(arena, array, n)                                      \
+  ((arena)->used.array + (n) <= (arena)->max.array                            \
+   ? ((arena)->used.array += (n), (arena)->array + (arena)->used.array - (n)) \
+   : NULL)
+
+#define DESC_ARENA_ALIGN 8
+
+/* Largest frame lookup table built for one streaming interface; devices
+ * with sparser indices are searched instead */
+#define FRAME_INDEX_MAX_SLOTS 4096
+
+/** @internal
+ * @brief Size of a frame lookup table for the given highest format and
+ * frame indices, or 0 if none should be built
+ * @ingroup device
+ */
+size_t uvc_frame_index_slots(int num_formats, int num_frames) {
+  size_t slots = (size_t) num_formats * num_frames;
+
+  return slots <= FRAME_INDEX_MAX_SLOTS ? slots : 0;
+}
+
+/* Build one interface's table in @p slots; returns the entries it took */
+static size_t uvc_index_stream_frames(uvc_streaming_interface_t *stream_if,
+                                      uvc_frame_desc_t **slots, size_t num_slots) {
+  uvc_format_desc_t *format;
+  uvc_frame_desc_t *frame;
+  int num_formats = 0, num_frames = 0;
+  size_t n;
+
+  DL_FOREACH(stream_if->format_descs, format) {
+    if (format->bFormatIndex > num_formats)
+      num_formats = format->bFormatIndex;
+    DL_FOREACH(format->frame_descs, frame) {
+      if (frame->bFrameIndex > num_frames)
+        num_frames = frame->bFrameIndex;
+    }
+  }
+
+  n = uvc_frame_index_slots(num_formats, num_frames);
+  stream_if->frame_index = NULL;
+  if (!n || n > num_slots)
+    return 0;
+
+  stream_if->frame_index = slots;
+  stream_if->frame_index_formats = (uint8_t) num_formats;
+  stream_if->frame_index_frames = (uint8_t) num_frames;
+  memset(slots, 0, n * sizeof(*slots));
+
+  DL_FOREACH(stream_if->format_descs, format) {
+    if (!format->bFormatIndex)
+      continue;
+    DL_FOREACH(format->frame_descs, frame) {
+      uvc_frame_desc_t **slot;
+
+      if (!frame->bFrameIndex)
+        continue;
+      slot = &slots[(format->bFormatIndex - 1) * num_frames + frame->bFrameIndex - 1];
+      if (!*slot)
+        *slot = frame;
+    }
+  }
+
+  return n;
+}
+
+/** @internal
+ * @brief Build each streaming interface's frame lookup table
+ * @ingroup device
+ *
+ * The tables map (bFormatIndex, bFrameIndex) straight to the frame
+ * descriptor, so that uvc_find_frame_desc() and friends need not walk the
+ * format and frame lists. Where indices repeat, the first descriptor wins,
+ * as it would in a search. Interfaces whose tables do not fit in the
+ * remaining @p num_slots get none.
+ *
+ * @param info Parsed descriptor tree
+ * @param slots Storage for the tables
+ * @param num_slots Number of entries in @p slots
+ * @return Number of entries used
+ */
+size_t uvc_index_frames(uvc_device_info_t *info, uvc_frame_desc_t **slots, size_t num_slots) {
+  uvc_streaming_interface_t *stream_if;
+  size_t used = 0;
+
+  DL_FOREACH(info->stream_ifs, stream_if) {
+    size_t n = uvc_index_stream_frames(stream_if, slots + used, num_slots - used);
+
+    used += n;
+  }
+
+  return used;
+}
+
+/* Count the nodes uvc_parse_vs() will build for one VideoStreaming interface */
+static void uvc_count_streaming(const struct libusb_config_descriptor *config,
+                                int interface_idx, struct uvc_desc_counts *counts) {
+  const struct libusb_interface_descriptor *if_desc;
+  const unsigned char *block;
+  size_t buffer_left;
+  int n, num_formats = 0, num_frames = 0;
+
+  if (interface_idx >= config->bNumInterfaces)
+    return;
+
+  if_desc = &config->interface[interface_idx].altsetting[0];
+  block = if_desc->extra;
+  buffer_left = if_desc->extra_length;
+  counts->stream_ifs++;
+
+  for (; buffer_left >= 3 && block[0] && block[0] <= buffer_left;
+       buffer_left -= block[0], block += block[0]) {
+    switch (block[2]) {
+    case UVC_VS_FORMAT_UNCOMPRESSED:
+    case UVC_VS_FORMAT_MJPEG:
+    case UVC_VS_FORMAT_FRAME_BASED:
+      counts->formats++;
+      if (block[3] > num_formats)
+        num_formats = block[3];
+      break;
+    case UVC_VS_FRAME_UNCOMPRESSED:
+    case UVC_VS_FRAME_MJPEG:
+    case UVC_VS_FRAME_FRAME_BASED:
+      n = block[2] == UVC_VS_FRAME_FRAME_BASED ? block[21] : block[25];
+      counts->frames++;
+      if (n)
+        counts->intervals += n + 1;
+      if (block[3] > num_frames)
+        num_frames = block[3];
+      break;
+    case UVC_VS_STILL_IMAGE_FRAME:
+      n = block[4];
+      counts->still_frames++;
+      counts->still_res += n;
+      counts->compression += block[5 + 4 * n];
+      break;
+    }
+  }
+
+  counts->frame_index += uvc_frame_index_slots(num_formats, num_frames);
+}
+
+/* Count the nodes uvc_parse_vc() and the streaming interfaces it scans will
+ * build, so that they can all be allocated at once */
+static void uvc_count_control(const struct libusb_config_descriptor *config,
+                              const struct libusb_interface_descriptor *if_desc,
+                              struct uvc_desc_counts *counts) {
+  const unsigned char *block = if_desc->extra;
+  size_t buffer_left = if_desc->extra_length;
+  size_t i;
+
+  for (; buffer_left >= 3 && block[0] && block[0] <= buffer_left;
+       buffer_left -= block[0], block += block[0]) {
+    if (block[1] != 36)
+      continue;
+
+    switch (block[2]) {
+    case UVC_VC_HEADER:
+      for (i = 12; i < block[0]; ++i)
+        uvc_count_streaming(config, block[i], counts);
+      break;
+    case UVC_VC_INPUT_TERMINAL:
+      if (SW_TO_SHORT(&block[4]) == UVC_ITT_CAMERA)
+        counts->input_terms++;
+      break;
+    case UVC_VC_SELECTOR_UNIT:
+      counts->selector_units++;
+      break;
+    case UVC_VC_PROCESSING_UNIT:
+      counts->processing_units++;
+      break;
+    case UVC_VC_EXTENSION_UNIT:
+      counts->extension_units++;
+      break;
+    }
+  }
+}
+
+/* Lay out an array of @p count entries at *size; returns its offset */
+static size_t uvc_desc_arena_reserve(size_t *size, size_t count, size_t entry_size) {
+  size_t offset = *size;
+
+  *size += (count * entry_size + DESC_ARENA_ALIGN - 1) & ~(size_t) (DESC_ARENA_ALIGN - 1);
+  return offset;
+}
+
+/** @internal
+ * @brief Allocate a zeroed descriptor arena with room for @p counts nodes
+ * @ingroup device
+ *
+ * @return The arena, to be attached to a uvc_device_info_t, or NULL
+ */
+struct uvc_desc_arena *uvc_desc_arena_alloc(const struct uvc_desc_counts *counts) {
+  struct uvc_desc_arena *arena;
+  size_t size = 0, off[12];
+  uint8_t *base;
+
+  uvc_desc_arena_reserve(&size, 1, sizeof(*arena));
+  off[0] = uvc_desc_arena_reserve(&size, counts->input_terms, sizeof(*arena->input_terms));
+  off[1] = uvc_desc_arena_reserve(&size, counts->selector_units, sizeof(*arena->selector_units));
+  off[2] = uvc_desc_arena_reserve(&size, counts->processing_units, sizeof(*arena->processing_units));
+  off[3] = uvc_desc_arena_reserve(&size, counts->extension_units, sizeof(*arena->extension_units));
+  off[4] = uvc_desc_arena_reserve(&size, counts->stream_ifs, sizeof(*arena->stream_ifs));
+  off[5] = uvc_desc_arena_reserve(&size, counts->formats, sizeof(*arena->formats));
+  off[6] = uvc_desc_arena_reserve(&size, counts->frames, sizeof(*arena->frames));
+  off[7] = uvc_desc_arena_reserve(&size, counts->intervals, sizeof(*arena->intervals));
+  off[8] = uvc_desc_arena_reserve(&size, counts->still_frames, sizeof(*arena->still_frames));
+  off[9] = uvc_desc_arena_reserve(&size, counts->still_res, sizeof(*arena->still_res));
+  off[10] = uvc_desc_arena_reserve(&size, counts->compression, sizeof(*arena->compression));
+  off[11] = uvc_desc_arena_reserve(&size, counts->frame_index, sizeof(*arena->frame_index));
+
+  base = calloc(1, size);
+  if (!base)
+    return NULL;
+
+  arena = (struct uvc_desc_arena *) base;
+  arena->input_terms = (uvc_input_terminal_t *) (base + off[0]);
+  arena->selector_units = (uvc_selector_unit_t *) (base + off[1]);
+  arena->processing_units = (uvc_processing_unit_t *) (base + off[2]);
+  arena->extension_units = (uvc_extension_unit_t *) (base + off[3]);
+  arena->stream_ifs = (uvc_streaming_interface_t *) (base + off[4]);
+  arena->formats = (uvc_format_desc_t *) (base + off[5]);
+  arena->frames = (uvc_frame_desc_t *) (base + off[6]);
+  arena->intervals = (uint32_t *) (base + off[7]);
+  arena->still_frames = (uvc_still_frame_desc_t *) (base + off[8]);
+  arena->still_res = (uvc_still_frame_res_t *) (base + off[9]);
+  arena->compression = base + off[10];
+  arena->frame_index = (uvc_frame_desc_t **) (base + off[11]);
+  arena->max = *counts;
+
+  return arena;
+}
+
 /** @internal
  * Find a device's VideoControl interface and process its descriptor
  * @ingroup device
+ *
+ * Works on info->config alone, without talking to the device, so it can
+ * also parse descriptors that were read earlier.
+ *
+ * The nodes of the tree are counted first and allocated together in
+ * info->arena, each kind in an array of its own, along with the frame
+ * lookup tables; uvc_free_device_info() releases them with one free().
+ *
+ * @param dev Device the descriptors belong to, or NULL
+ * @param info Device info with the configuration descriptor filled in
+ * @param idVendor Vendor ID, for devices that need special treatment
+ * @param idProduct Product ID, likewise
  */
-uvc_error_t uvc_scan_control(uvc_device_handle_t *devh, uvc_device_info_t *info) {
+uvc_error_t uvc_scan_control(uvc_device_t *dev, uvc_device_info_t *info,
+                             uint16_t idVendor, uint16_t idProduct) {
   const struct libusb_interface_descriptor *if_desc;
   uvc_error_t parse_ret, ret;
   int interface_idx;
   const unsigned char *buffer;
   size_t buffer_left, block_size;
+  struct uvc_desc_counts counts;
 
   UVC_ENTER();
 
   ret = UVC_SUCCESS;
   if_desc = NULL;
 
-  uvc_device_descriptor_t* dev_desc;
-  int haveTISCamera = 0;
-  if ( get_device_descriptor ( devh, &dev_desc ) == UVC_SUCCESS ) {
-    if ( 0x199e == dev_desc->idVendor && ( 0x8101 == dev_desc->idProduct ||
-        0x8102 == dev_desc->idProduct )) {
-      haveTISCamera = 1;
-    }
-    uvc_free_device_descriptor ( dev_desc );
-  }
+  uvc_quirks_t quirks;
+
+  uvc_quirks_lookup(dev ? dev->ctx : NULL, idVendor, idProduct, -1, &quirks);
 
   for (interface_idx = 0; interface_idx < info->config->bNumInterfaces; ++interface_idx) {
     if_desc = &info->config->interface[interface_idx].altsetting[0];
 
-    if ( haveTISCamera && if_desc->bInterfaceClass == 255 && if_desc->bInterfaceSubClass == 1) // Video, Control
+    if ((quirks.flags & UVC_QUIRK_VENDOR_CLASS) && if_desc->bInterfaceClass == 255 && if_desc->bInterfaceSubClass == 1) // Video, Control
       break;
 
     if (if_desc->bInterfaceClass == 14 && if_desc->bInterfaceSubClass == 1) // Video, Control
@@ -1090,12 +1404,20 @@ uvc_error_t uvc_scan_control(uvc_device_handle_t *devh, uvc_device_info_t *info)
     info->ctrl_if.bEndpointAddress = if_desc->endpoint[0].bEndpointAddress;
   }
 
+  memset(&counts, 0, sizeof(counts));
+  uvc_count_control(info->config, if_desc, &counts);
+  info->arena = uvc_desc_arena_alloc(&counts);
+  if (!info->arena) {
+    UVC_EXIT(UVC_ERROR_NO_MEM);
+    return UVC_ERROR_NO_MEM;
+  }
+
   buffer = if_desc->extra;
   buffer_left = if_desc->extra_length;
 
   while (buffer_left >= 3) { // parseX needs to see buf[0,2] = length,type
     block_size = buffer[0];
-    parse_ret = uvc_parse_vc(devh->dev, info, buffer, block_size);
+    parse_ret = uvc_parse_vc(dev, info, buffer, block_size);
 
     if (parse_ret != UVC_SUCCESS) {
       ret = parse_ret;
@@ -1106,6 +1428,10 @@ uvc_error_t uvc_scan_control(uvc_device_handle_t *devh, uvc_device_info_t *info)
     buffer += block_size;
   }
 
+  if (ret == UVC_SUCCESS)
+    info->deferred_slots_used = uvc_index_frames(info, info->arena->frame_index,
+                                                 info->arena->max.frame_index);
+
   UVC_EXIT(ret);
   return ret;
 }
@@ -1145,7 +1471,11 @@ uvc_error_t uvc_parse_vc_header(uvc_device_t *dev,
   }
 
   for (i = 12; i < block_size; ++i) {
-    scan_ret = uvc_scan_streaming(dev, info, block[i]);
+    if (info->defer_streaming && block[i] < 32) {
+      info->deferred_ifs |= 1u << block[i];
+      continue;
+    }
+    scan_ret = uvc_scan_streaming(dev, info, block[i], &info->stream_ifs);
     if (scan_ret != UVC_SUCCESS) {
       ret = scan_ret;
       break;
@@ -1174,7 +1504,11 @@ uvc_error_t uvc_parse_vc_input_terminal(uvc_device_t *dev,
     return UVC_SUCCESS;
   }
 
-  term = calloc(1, sizeof(*term));
+  term = DESC_ARENA_TAKE(info->arena, input_terms, 1);
+  if (!term) {
+    UVC_EXIT(UVC_ERROR_NO_MEM);
+    return UVC_ERROR_NO_MEM;
+  }
 
   term->bTerminalID = block[3];
   term->wTerminalType = SW_TO_SHORT(&block[4]);
@@ -1203,7 +1537,12 @@ uvc_error_t uvc_parse_vc_processing_unit(uvc_device_t *dev,
 
   UVC_ENTER();
 
-  unit = calloc(1, sizeof(*unit));
+  unit = DESC_ARENA_TAKE(info->arena, processing_units, 1);
+  if (!unit) {
+    UVC_EXIT(UVC_ERROR_NO_MEM);
+    return UVC_ERROR_NO_MEM;
+  }
+
   unit->bUnitID = block[3];
   unit->bSourceID = block[4];
 
@@ -1227,7 +1566,12 @@ uvc_error_t uvc_parse_vc_selector_unit(uvc_device_t *dev,
 
   UVC_ENTER();
 
-  unit = calloc(1, sizeof(*unit));
+  unit = DESC_ARENA_TAKE(info->arena, selector_units, 1);
+  if (!unit) {
+    UVC_EXIT(UVC_ERROR_NO_MEM);
+    return UVC_ERROR_NO_MEM;
+  }
+
   unit->bUnitID = block[3];
 
   DL_APPEND(info->ctrl_if.selector_unit_descs, unit);
@@ -1243,13 +1587,19 @@ uvc_error_t uvc_parse_vc_selector_unit(uvc_device_t *dev,
 uvc_error_t uvc_parse_vc_extension_unit(uvc_device_t *dev,
 					uvc_device_info_t *info,
 					const unsigned char *block, size_t block_size) {
-  uvc_extension_unit_t *unit = calloc(1, sizeof(*unit));
+  uvc_extension_unit_t *unit;
   const uint8_t *start_of_controls;
   int size_of_controls, num_in_pins;
   int i;
 
   UVC_ENTER();
 
+  unit = DESC_ARENA_TAKE(info->arena, extension_units, 1);
+  if (!unit) {
+    UVC_EXIT(UVC_ERROR_NO_MEM);
+    return UVC_ERROR_NO_MEM;
+  }
+
   unit->bUnitID = block[3];
   memcpy(unit->guidExtensionCode, &block[4], 16);
 
@@ -1315,10 +1665,14 @@ uvc_error_t uvc_parse_vc(
 /** @internal
  * Process a VideoStreaming interface
  * @ingroup device
+ *
+ * The interface is appended to @p stream_ifs, which is normally
+ * &info->stream_ifs.
  */
 uvc_error_t uvc_scan_streaming(uvc_device_t *dev,
 			       uvc_device_info_t *info,
-			       int interface_idx) {
+			       int interface_idx,
+			       uvc_streaming_interface_t **stream_ifs) {
   const struct libusb_interface_descriptor *if_desc;
   const unsigned char *buffer;
   size_t buffer_left, block_size;
@@ -1329,14 +1683,24 @@ uvc_error_t uvc_scan_streaming(uvc_device_t *dev,
 
   ret = UVC_SUCCESS;
 
+  if (interface_idx >= info->config->bNumInterfaces) {
+    UVC_EXIT(UVC_ERROR_INVALID_DEVICE);
+    return UVC_ERROR_INVALID_DEVICE;
+  }
+
   if_desc = &(info->config->interface[interface_idx].altsetting[0]);
   buffer = if_desc->extra;
   buffer_left = if_desc->extra_length;
 
-  stream_if = calloc(1, sizeof(*stream_if));
+  stream_if = DESC_ARENA_TAKE(info->arena, stream_ifs, 1);
+  if (!stream_if) {
+    UVC_EXIT(UVC_ERROR_NO_MEM);
+    return UVC_ERROR_NO_MEM;
+  }
+
   stream_if->parent = info;
   stream_if->bInterfaceNumber = if_desc->bInterfaceNumber;
-  DL_APPEND(info->stream_ifs, stream_if);
+  DL_APPEND(*stream_ifs, stream_if);
 
   while (buffer_left >= 3) {
     block_size = buffer[0];
@@ -1355,6 +1719,93 @@ uvc_error_t uvc_scan_streaming(uvc_device_t *dev,
   return ret;
 }
 
+/* Link a fully parsed interface into info->stream_ifs in interface number
+ * order. Readers walk the list through next without info_mutex, so the node
+ * is complete before the one store that makes it reachable. */
+static void uvc_publish_stream_if(uvc_device_info_t *info,
+                                  uvc_streaming_interface_t *stream_if) {
+  uvc_streaming_interface_t *head = info->stream_ifs, *pos;
+
+  DL_FOREACH(head, pos) {
+    if (pos->bInterfaceNumber > stream_if->bInterfaceNumber)
+      break;
+  }
+
+  if (!head) {
+    stream_if->prev = stream_if;
+    stream_if->next = NULL;
+    __atomic_store_n(&info->stream_ifs, stream_if, __ATOMIC_RELEASE);
+  } else if (!pos) {
+    stream_if->prev = head->prev;
+    stream_if->next = NULL;
+    __atomic_store_n(&head->prev->next, stream_if, __ATOMIC_RELEASE);
+    head->prev = stream_if;
+  } else {
+    stream_if->prev = pos->prev;
+    stream_if->next = pos;
+    if (pos == head)
+      __atomic_store_n(&info->stream_ifs, stream_if, __ATOMIC_RELEASE);
+    else
+      __atomic_store_n(&pos->prev->next, stream_if, __ATOMIC_RELEASE);
+    pos->prev = stream_if;
+  }
+}
+
+/** @internal
+ * @brief Parse streaming interfaces left out by UVC_OPEN_DEFER_STREAMING
+ * @ingroup device
+ *
+ * Each interface is parsed into the arena reserved for it at open time,
+ * gets its frame lookup table and only then is linked into the tree in
+ * interface number order, so unlocked readers never see it half built.
+ * Once none are left, the complete tree is saved to the descriptor cache,
+ * if one is set.
+ *
+ * @param devh Device handle
+ * @param interface_number Interface to parse, or -1 for all of them
+ */
+uvc_error_t uvc_scan_deferred_streaming(uvc_device_handle_t *devh, int interface_number) {
+  uvc_device_info_t *info = devh->info;
+  uvc_streaming_interface_t *stream_if;
+  uvc_error_t ret = UVC_SUCCESS;
+  int i;
+
+  pthread_mutex_lock(&devh->info_mutex);
+
+  for (i = 0; i < 32 && info->deferred_ifs && ret == UVC_SUCCESS; ++i) {
+    if (!(info->deferred_ifs & (1u << i)))
+      continue;
+    if (interface_number >= 0 && (i >= info->config->bNumInterfaces ||
+        info->config->interface[i].altsetting[0].bInterfaceNumber != interface_number))
+      continue;
+
+    info->deferred_ifs &= ~(1u << i);
+    stream_if = NULL;
+    ret = uvc_scan_streaming(devh->dev, info, i, &stream_if);
+    if (ret != UVC_SUCCESS)
+      break;
+
+    info->deferred_slots_used +=
+      uvc_index_stream_frames(stream_if, info->arena->frame_index + info->deferred_slots_used,
+                              info->arena->max.frame_index - info->deferred_slots_used);
+    uvc_publish_stream_if(info, stream_if);
+
+    if (!info->deferred_ifs && devh->dev->ctx->desc_cache_dir) {
+      struct libusb_device_descriptor desc;
+
+      if (libusb_get_device_descriptor(devh->dev->usb_dev, &desc) == LIBUSB_SUCCESS &&
+          uvc_desc_cache_store(devh->dev->ctx->desc_cache_dir, &desc,
+                               uvc_desc_cache_key(&desc, info->config), info) != UVC_SUCCESS) {
+        UVC_DEBUG("could not cache descriptors in %s", devh->dev->ctx->desc_cache_dir);
+      }
+    }
+  }
+
+  pthread_mutex_unlock(&devh->info_mutex);
+
+  return ret;
+}
+
 /** @internal
  * @brief Parse a VideoStreaming header block.
  * @ingroup device
@@ -1381,7 +1832,11 @@ uvc_error_t uvc_parse_vs_format_uncompressed(uvc_streaming_interface_t *stream_i
 					     size_t block_size) {
   UVC_ENTER();
 
-  uvc_format_desc_t *format = calloc(1, sizeof(*format));
+  uvc_format_desc_t *format = DESC_ARENA_TAKE(stream_if->parent->arena, formats, 1);
+  if (!format) {
+    UVC_EXIT(UVC_ERROR_NO_MEM);
+    return UVC_ERROR_NO_MEM;
+  }
 
   format->parent = stream_if;
   format->bDescriptorSubtype = block[2];
@@ -1411,7 +1866,11 @@ uvc_error_t uvc_parse_vs_frame_format(uvc_streaming_interface_t *stream_if,
 					     size_t block_size) {
   UVC_ENTER();
 
-  uvc_format_desc_t *format = calloc(1, sizeof(*format));
+  uvc_format_desc_t *format = DESC_ARENA_TAKE(stream_if->parent->arena, formats, 1);
+  if (!format) {
+    UVC_EXIT(UVC_ERROR_NO_MEM);
+    return UVC_ERROR_NO_MEM;
+  }
 
   format->parent = stream_if;
   format->bDescriptorSubtype = block[2];
@@ -1441,7 +1900,11 @@ uvc_error_t uvc_parse_vs_format_mjpeg(uvc_streaming_interface_t *stream_if,
 					     size_t block_size) {
   UVC_ENTER();
 
-  uvc_format_desc_t *format = calloc(1, sizeof(*format));
+  uvc_format_desc_t *format = DESC_ARENA_TAKE(stream_if->parent->arena, formats, 1);
+  if (!format) {
+    UVC_EXIT(UVC_ERROR_NO_MEM);
+    return UVC_ERROR_NO_MEM;
+  }
 
   format->parent = stream_if;
   format->bDescriptorSubtype = block[2];
@@ -1477,7 +1940,11 @@ uvc_error_t uvc_parse_vs_frame_frame(uvc_streaming_interface_t *stream_if,
   UVC_ENTER();
 
   format = stream_if->format_descs->prev;
-  frame = calloc(1, sizeof(*frame));
+  frame = DESC_ARENA_TAKE(stream_if->parent->arena, frames, 1);
+  if (!frame) {
+    UVC_EXIT(UVC_ERROR_NO_MEM);
+    return UVC_ERROR_NO_MEM;
+  }
 
   frame->parent = format;
 
@@ -1497,7 +1964,11 @@ uvc_error_t uvc_parse_vs_frame_frame(uvc_streaming_interface_t *stream_if,
     frame->dwMaxFrameInterval = DW_TO_INT(&block[30]);
     frame->dwFrameIntervalStep = DW_TO_INT(&block[34]);
   } else {
-    frame->intervals = calloc(block[21] + 1, sizeof(frame->intervals[0]));
+    frame->intervals = DESC_ARENA_TAKE(stream_if->parent->arena, intervals, block[21] + 1);
+    if (!frame->intervals) {
+      UVC_EXIT(UVC_ERROR_NO_MEM);
+      return UVC_ERROR_NO_MEM;
+    }
     p = &block[26];
 
     for (i = 0; i < block[21]; ++i) {
@@ -1529,7 +2000,11 @@ uvc_error_t uvc_parse_vs_frame_uncompressed(uvc_streaming_interface_t *stream_if
   UVC_ENTER();
 
   format = stream_if->format_descs->prev;
-  frame = calloc(1, sizeof(*frame));
+  frame = DESC_ARENA_TAKE(stream_if->parent->arena, frames, 1);
+  if (!frame) {
+    UVC_EXIT(UVC_ERROR_NO_MEM);
+    return UVC_ERROR_NO_MEM;
+  }
 
   frame->parent = format;
 
@@ -1549,7 +2024,11 @@ uvc_error_t uvc_parse_vs_frame_uncompressed(uvc_streaming_interface_t *stream_if
     frame->dwMaxFrameInterval = DW_TO_INT(&block[30]);
     frame->dwFrameIntervalStep = DW_TO_INT(&block[34]);
   } else {
-    frame->intervals = calloc(block[25] + 1, sizeof(frame->intervals[0]));
+    frame->intervals = DESC_ARENA_TAKE(stream_if->parent->arena, intervals, block[25] + 1);
+    if (!frame->intervals) {
+      UVC_EXIT(UVC_ERROR_NO_MEM);
+      return UVC_ERROR_NO_MEM;
+    }
     p = &block[26];
 
     for (i = 0; i < block[25]; ++i) {
@@ -1582,20 +2061,30 @@ uvc_error_t uvc_parse_vs_still_image_frame(uvc_streaming_interface_t *stream_if,
   UVC_ENTER();
 
   format = stream_if->format_descs->prev;
-  frame = calloc(1, sizeof(*frame));
+  frame = DESC_ARENA_TAKE(stream_if->parent->arena, still_frames, 1);
+  if (!frame) {
+    UVC_EXIT(UVC_ERROR_NO_MEM);
+    return UVC_ERROR_NO_MEM;
+  }
 
   frame->parent = format;
 
   frame->bDescriptorSubtype = block[2];
   frame->bEndPointAddress   = block[3];
   uint8_t numImageSizePatterns = block[4];
+  uvc_still_frame_res_t *res_array = DESC_ARENA_TAKE(stream_if->parent->arena, still_res,
+                                                     numImageSizePatterns);
+  if (!res_array) {
+    UVC_EXIT(UVC_ERROR_NO_MEM);
+    return UVC_ERROR_NO_MEM;
+  }
 
   frame->imageSizePatterns = NULL;
 
   p = &block[5];
 
   for (i = 1; i <= numImageSizePatterns; ++i) {
-    uvc_still_frame_res_t* res = calloc(1, sizeof(uvc_still_frame_res_t));
+    uvc_still_frame_res_t* res = &res_array[i - 1];
     res->bResolutionIndex = i;
     res->wWidth = SW_TO_SHORT(p);
     p += 2;
@@ -1610,7 +2099,12 @@ uvc_error_t uvc_parse_vs_still_image_frame(uvc_streaming_interface_t *stream_if,
 
   if(frame->bNumCompressionPattern)
   {
-      frame->bCompression = calloc(frame->bNumCompressionPattern, sizeof(frame->bCompression[0]));
+      frame->bCompression = DESC_ARENA_TAKE(stream_if->parent->arena, compression,
+                                            frame->bNumCompressionPattern);
+      if (!frame->bCompression) {
+        UVC_EXIT(UVC_ERROR_NO_MEM);
+        return UVC_ERROR_NO_MEM;
+      }
       for(i = 0; i < frame->bNumCompressionPattern; ++i)
       {
           ++p;
@@ -1703,8 +2197,12 @@ void uvc_free_devh(uvc_device_handle_t *devh) {
   if (devh->info)
     uvc_free_device_info(devh->info);
 
-  if (devh->status_xfer)
-    libusb_free_transfer(devh->status_xfer);
+  uvc_status_free(devh);
+  uvc_ctrl_cache_free(devh);
+  uvc_ctrl_async_free(devh);
+  pthread_mutex_destroy(&devh->info_mutex);
+  pthread_mutex_destroy(&devh->ctrl_writer_mutex);
+  pthread_rwlock_destroy(&devh->usb_devh_lock);
 
   free(devh);
 
@@ -1726,16 +2224,22 @@ void uvc_close(uvc_device_handle_t *devh) {
   if (devh->streams)
     uvc_stop_streaming(devh);
 
+  uvc_stop_ctrl_writer(devh);
+  uvc_ctrl_async_drain(devh);
+  uvc_status_stop(devh);
+
   uvc_release_if(devh, devh->info->ctrl_if.bInterfaceNumber);
 
   /* If we are managing the libusb context and this is the last open device,
-   * then we need to cancel the handler thread. When we call libusb_close,
+   * then we need to cancel the handler thread (unless the device index still
+   * needs it for hotplug events). When we call libusb_close,
    * it'll cause a return from the thread's libusb_handle_events call, after
    * which the handler thread will check the flag we set and then exit. */
-  if (ctx->own_usb_ctx && ctx->open_devices == devh && devh->next == NULL) {
+  if (ctx->own_usb_ctx && ctx->open_devices == devh && devh->next == NULL && !ctx->dev_index) {
     ctx->kill_handler_thread = 1;
     libusb_close(devh->usb_devh);
     pthread_join(ctx->handler_thread, NULL);
+    ctx->handler_thread_running = 0;
   } else {
     libusb_close(devh->usb_devh);
   }
@@ -1767,6 +2271,24 @@ size_t uvc_num_devices(uvc_context_t *ctx) {
   return count;
 }
 
+/** @internal
+ * @brief Keep the control cache in step with a VideoControl status packet
+ *
+ * Runs as soon as the packet arrives, even when the event itself is queued
+ * for the application (see status.c). This covers any unit, extension
+ * units included: a value change carries the new value, anything else
+ * (info, failure, min or max) drops the control.
+ */
+void uvc_status_update_caches(uvc_device_handle_t *devh, const uint8_t *data, int len) {
+  if (len < 5 || data[1] == 0 || data[2] != 0)
+    return;
+
+  if (data[4] == UVC_STATUS_ATTRIBUTE_VALUE_CHANGE)
+    uvc_ctrl_cache_update_cur(devh, data[1], data[3], data + 5, len - 5);
+  else
+    uvc_ctrl_cache_invalidate_ctrl(devh, data[1], data[3]);
+}
+
 void uvc_process_control_status(uvc_device_handle_t *devh, unsigned char *data, int len) {
   enum uvc_status_class status_class;
   uint8_t originator = 0, selector = 0, event = 0;
@@ -1879,19 +2401,20 @@ void uvc_process_streaming_status(uvc_device_handle_t *devh, unsigned char *data
   UVC_EXIT_VOID();
 }
 
-void uvc_process_status_xfer(uvc_device_handle_t *devh, struct libusb_transfer *transfer) {
+/** @internal
+ * @brief Hand a status packet to the application's callbacks
+ */
+void uvc_process_status_packet(uvc_device_handle_t *devh, uint8_t *data, int len) {
   
   UVC_ENTER();
 
-  /* printf("Got transfer of aLen = %d\n", transfer->actual_length); */
-
-  if (transfer->actual_length > 0) {
-    switch (transfer->buffer[0] & 0x0f) {
+  if (len > 0) {
+    switch (data[0] & 0x0f) {
     case 1: /* VideoControl interface */
-      uvc_process_control_status(devh, transfer->buffer, transfer->actual_length);
+      uvc_process_control_status(devh, data, len);
       break;
     case 2:  /* VideoStreaming interface */
-      uvc_process_streaming_status(devh, transfer->buffer, transfer->actual_length);
+      uvc_process_streaming_status(devh, data, len);
       break;
     }
   }
@@ -1899,40 +2422,6 @@ void uvc_process_status_xfer(uvc_device_handle_t *devh, struct libusb_transfer *
   UVC_EXIT_VOID();
 }
 
-/** @internal
- * @brief Process asynchronous status updates from the device.
- */
-void LIBUSB_CALL _uvc_status_callback(struct libusb_transfer *transfer) {
-  UVC_ENTER();
-
-  uvc_device_handle_t *devh = (uvc_device_handle_t *) transfer->user_data;
-
-  switch (transfer->status) {
-  case LIBUSB_TRANSFER_ERROR:
-  case LIBUSB_TRANSFER_CANCELLED:
-  case LIBUSB_TRANSFER_NO_DEVICE:
-    UVC_DEBUG("not processing/resubmitting, status = %d", transfer->status);
-    UVC_EXIT_VOID();
-    return;
-  case LIBUSB_TRANSFER_COMPLETED:
-    uvc_process_status_xfer(devh, transfer);
-    break;
-  case LIBUSB_TRANSFER_TIMED_OUT:
-  case LIBUSB_TRANSFER_STALL:
-  case LIBUSB_TRANSFER_OVERFLOW:
-    UVC_DEBUG("retrying transfer, status = %d", transfer->status);
-    break;
-  }
-
-#ifdef UVC_DEBUGGING
-  uvc_error_t ret =
-#endif
-      libusb_submit_transfer(transfer);
-  UVC_DEBUG("libusb_submit_transfer() = %d", ret);
-
-  UVC_EXIT_VOID();
-}
-
 /** @brief Set a callback function to receive status updates
  *
  * @ingroup device
@@ -1971,6 +2460,9 @@ void uvc_set_button_callback(uvc_device_handle_t *devh,
  * @param devh Device handle to an open UVC device
  */
 const uvc_format_desc_t *uvc_get_format_descs(uvc_device_handle_t *devh) {
+  if (uvc_scan_deferred_streaming(devh, -1) != UVC_SUCCESS || !devh->info->stream_ifs)
+    return NULL;
+
   return devh->info->stream_ifs->format_descs;
 }
 
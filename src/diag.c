@@ -163,6 +163,7 @@ void uvc_print_diag(uvc_device_handle_t *devh, FILE *stream) {
         "\tbcdUVC: 0x%04x\n",
         devh->info->ctrl_if.bcdUVC);
 
+    uvc_scan_deferred_streaming(devh, -1);
     DL_FOREACH(devh->info->stream_ifs, stream_if) {
       uvc_format_desc_t *fmt_desc;
 
@@ -292,6 +293,8 @@ void uvc_print_frameformats(uvc_device_handle_t *devh) {
   if (devh->info->ctrl_if.bcdUVC) {
     uvc_streaming_interface_t *stream_if;
     int stream_idx = 0;
+
+    uvc_scan_deferred_streaming(devh, -1);
     DL_FOREACH(devh->info->stream_ifs, stream_if) {
       uvc_format_desc_t *fmt_desc;
       ++stream_idx;
@@ -220,3 +220,83 @@ uvc_error_t uvc_mjpeg2gray(uvc_frame_t *in, uvc_frame_t *out) {
 
   return uvc_mjpeg_convert(in, out);
 }
+
+/** @internal
+ * @brief Reduce an MJPEG frame to the DC coefficients of its luma blocks
+ *
+ * Only the entropy-coded data is decoded; there is no inverse DCT, upsampling
+ * or colour conversion. Each output pixel is the mean luma of one 8x8 block,
+ * so @p out is a GRAY8 frame an eighth of the width and height of @p in
+ * (rounded up).
+ *
+ * @param in MJPEG frame
+ * @param out GRAY8 frame of block means
+ */
+uvc_error_t uvc_mjpeg_dc2gray(uvc_frame_t *in, uvc_frame_t *out) {
+  struct jpeg_decompress_struct dinfo;
+  struct error_mgr jerr;
+  jvirt_barray_ptr *coefs;
+  jpeg_component_info *comp;
+  JDIMENSION bx, by;
+  int q;
+
+  if (in->frame_format != UVC_FRAME_FORMAT_MJPEG)
+    return UVC_ERROR_INVALID_PARAM;
+
+  dinfo.err = jpeg_std_error(&jerr.super);
+  jerr.super.error_exit = _error_exit;
+
+  if (setjmp(jerr.jmp)) {
+    goto fail;
+  }
+
+  jpeg_create_decompress(&dinfo);
+  jpeg_mem_src(&dinfo, in->data, in->data_bytes);
+  jpeg_read_header(&dinfo, TRUE);
+
+  if (dinfo.dc_huff_tbl_ptrs[0] == NULL) {
+    /* This frame is missing the Huffman tables: fill in the standard ones */
+    insert_huff_tables(&dinfo);
+  }
+
+  coefs = jpeg_read_coefficients(&dinfo);
+  comp = &dinfo.comp_info[0];
+  if (!comp->quant_table)
+    goto fail;
+  q = comp->quant_table->quantval[0];
+
+  if (uvc_ensure_frame_size(out, comp->width_in_blocks * comp->height_in_blocks) < 0) {
+    jpeg_destroy_decompress(&dinfo);
+    return UVC_ERROR_NO_MEM;
+  }
+
+  out->width = comp->width_in_blocks;
+  out->height = comp->height_in_blocks;
+  out->frame_format = UVC_FRAME_FORMAT_GRAY8;
+  out->step = out->width;
+  out->sequence = in->sequence;
+  out->capture_time = in->capture_time;
+  out->capture_time_finished = in->capture_time_finished;
+  out->source = in->source;
+
+  for (by = 0; by < comp->height_in_blocks; ++by) {
+    JBLOCKARRAY rows = (*dinfo.mem->access_virt_barray)((j_common_ptr) &dinfo, coefs[0],
+                                                        by, 1, FALSE);
+    uint8_t *dst = (uint8_t *) out->data + by * out->step;
+
+    for (bx = 0; bx < comp->width_in_blocks; ++bx) {
+      /* DC is eight times the level-shifted block mean */
+      int v = (rows[0][bx][0] * q + 4) / 8 + 128;
+
+      dst[bx] = v < 0 ? 0 : v > 255 ? 255 : v;
+    }
+  }
+
+  jpeg_finish_decompress(&dinfo);
+  jpeg_destroy_decompress(&dinfo);
+  return UVC_SUCCESS;
+
+fail:
+  jpeg_destroy_decompress(&dinfo);
+  return UVC_ERROR_OTHER;
+}
@@ -0,0 +1,344 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (C) 2010-2012 Ken Tossell
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the author nor other contributors may be
+*     used to endorse or promote products derived from this software
+*     without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+/**
+ * @file frame-stats.c
+ * @brief Cheap per-frame luma statistics for software exposure, white
+ * balance and focus loops.
+ *
+ * Luma is read in place from YUYV, UYVY, NV12 and GRAY8 frames. MJPEG frames
+ * are reduced to the DC coefficients of their luma blocks, without an inverse
+ * DCT, and measured at block resolution.
+ *
+ * The gradient sums run through SSE2 or NEON when the compiler targets them;
+ * the histogram is scalar, spread over four sub-histograms so that runs of
+ * equal samples do not serialise on one counter.
+ */
+#include "libuvc/libuvc.h"
+#include "libuvc/libuvc_internal.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+#define STATS_DEFAULT_CLIP_LOW 2
+#define STATS_DEFAULT_CLIP_HIGH 253
+
+/* Samples per vector pass before the 32-bit lane sums are flushed; keeps
+ * them from overflowing on very wide frames */
+#define STATS_CHUNK 4096
+
+/* Sum of squared differences between the luma samples of @p a and @p b,
+ * n samples @p step bytes apart */
+static uint64_t stats_ssd_scalar(const uint8_t *a, const uint8_t *b, size_t step, size_t n) {
+  uint64_t sum = 0;
+  size_t i;
+
+  for (i = 0; i < n; ++i) {
+    int d = (int) a[i * step] - (int) b[i * step];
+    sum += (uint32_t) (d * d);
+  }
+
+  return sum;
+}
+
+/* Samples the vector loops may cover. With two bytes per sample, a vector
+ * load ending on the last sample's luma would read the byte after it, which
+ * for UYVY can lie past the end of the frame; leave that sample to the
+ * scalar loop. */
+static inline size_t stats_vector_limit(size_t step, size_t n) {
+  return step == 1 || n == 0 ? n : n - 1;
+}
+
+#if defined(__SSE2__)
+static inline uint64_t stats_hsum_epi32(__m128i acc) {
+  uint32_t lanes[4];
+
+  _mm_storeu_si128((__m128i *) lanes, acc);
+  return (uint64_t) lanes[0] + lanes[1] + lanes[2] + lanes[3];
+}
+
+/* Vector part of stats_ssd(); returns the number of samples done */
+static size_t stats_ssd_simd(const uint8_t *a, const uint8_t *b, size_t step, size_t n,
+                             uint64_t *sum) {
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i mask = _mm_set1_epi16(0x00ff);
+  size_t width = step == 1 ? 16 : 8;
+  size_t last = stats_vector_limit(step, n);
+  size_t i = 0;
+
+  while (i + width <= last) {
+    size_t end = last - i > STATS_CHUNK ? i + STATS_CHUNK : last;
+    __m128i acc = zero;
+
+    if (step == 1) {
+      for (; i + 16 <= end; i += 16) {
+        __m128i va = _mm_loadu_si128((const __m128i *) (a + i));
+        __m128i vb = _mm_loadu_si128((const __m128i *) (b + i));
+        __m128i lo = _mm_sub_epi16(_mm_unpacklo_epi8(va, zero), _mm_unpacklo_epi8(vb, zero));
+        __m128i hi = _mm_sub_epi16(_mm_unpackhi_epi8(va, zero), _mm_unpackhi_epi8(vb, zero));
+
+        acc = _mm_add_epi32(acc, _mm_madd_epi16(lo, lo));
+        acc = _mm_add_epi32(acc, _mm_madd_epi16(hi, hi));
+      }
+    } else {
+      /* Two bytes per sample, luma in the low byte */
+      for (; i + 8 <= end; i += 8) {
+        __m128i va = _mm_and_si128(_mm_loadu_si128((const __m128i *) (a + 2 * i)), mask);
+        __m128i vb = _mm_and_si128(_mm_loadu_si128((const __m128i *) (b + 2 * i)), mask);
+        __m128i d = _mm_sub_epi16(va, vb);
+
+        acc = _mm_add_epi32(acc, _mm_madd_epi16(d, d));
+      }
+    }
+
+    *sum += stats_hsum_epi32(acc);
+  }
+
+  return i;
+}
+#elif defined(__ARM_NEON)
+static inline uint64_t stats_hsum_u32(uint32x4_t acc) {
+  uint64x2_t wide = vpaddlq_u32(acc);
+
+  return vgetq_lane_u64(wide, 0) + vgetq_lane_u64(wide, 1);
+}
+
+static inline void stats_ssd_vec(uint8x16_t va, uint8x16_t vb, uint32x4_t *acc) {
+  uint8x16_t d = vabdq_u8(va, vb);
+
+  *acc = vpadalq_u16(*acc, vmull_u8(vget_low_u8(d), vget_low_u8(d)));
+  *acc = vpadalq_u16(*acc, vmull_u8(vget_high_u8(d), vget_high_u8(d)));
+}
+
+/* Vector part of stats_ssd(); returns the number of samples done */
+static size_t stats_ssd_simd(const uint8_t *a, const uint8_t *b, size_t step, size_t n,
+                             uint64_t *sum) {
+  size_t last = stats_vector_limit(step, n);
+  size_t i = 0;
+
+  while (i + 16 <= last) {
+    size_t end = last - i > STATS_CHUNK ? i + STATS_CHUNK : last;
+    uint32x4_t acc = vdupq_n_u32(0);
+
+    if (step == 1) {
+      for (; i + 16 <= end; i += 16)
+        stats_ssd_vec(vld1q_u8(a + i), vld1q_u8(b + i), &acc);
+    } else {
+      for (; i + 16 <= end; i += 16)
+        stats_ssd_vec(vld2q_u8(a + 2 * i).val[0], vld2q_u8(b + 2 * i).val[0], &acc);
+    }
+
+    *sum += stats_hsum_u32(acc);
+  }
+
+  return i;
+}
+#else
+static size_t stats_ssd_simd(const uint8_t *a, const uint8_t *b, size_t step, size_t n,
+                             uint64_t *sum) {
+  return 0;
+}
+#endif
+
+static uint64_t stats_ssd(const uint8_t *a, const uint8_t *b, size_t step, size_t n) {
+  uint64_t sum = 0;
+  size_t done = stats_ssd_simd(a, b, step, n, &sum);
+
+  return sum + stats_ssd_scalar(a + done * step, b + done * step, step, n - done);
+}
+
+static void stats_hist(const uint8_t *p, size_t step, size_t n, uint32_t hist[4][256]) {
+  size_t i = 0;
+
+  for (; i + 4 <= n; i += 4) {
+    hist[0][p[i * step]]++;
+    hist[1][p[(i + 1) * step]]++;
+    hist[2][p[(i + 2) * step]]++;
+    hist[3][p[(i + 3) * step]]++;
+  }
+  for (; i < n; ++i)
+    hist[0][p[i * step]]++;
+}
+
+/* Measure the cell [x0, x1) x [y0, y1) of a luma plane */
+static void stats_cell(const uint8_t *plane, size_t pitch, size_t step,
+                       size_t x0, size_t x1, size_t y0, size_t y1,
+                       const uvc_frame_stats_params_t *params, uvc_frame_stats_t *stats) {
+  uint32_t hist[4][256];
+  uint64_t grad = 0, weighted = 0;
+  size_t n = x1 - x0, y, v;
+  uint32_t low = 0, high = 0;
+
+  memset(hist, 0, sizeof(hist));
+  memset(stats, 0, sizeof(*stats));
+
+  for (y = y0; y < y1; y += params->row_step) {
+    const uint8_t *row = plane + y * pitch + x0 * step;
+
+    stats_hist(row, step, n, hist);
+    if (n > 1)
+      grad += stats_ssd(row + step, row, step, n - 1);
+    if (y + 1 < y1)
+      grad += stats_ssd(row + pitch, row, step, n);
+    stats->samples += n;
+  }
+
+  for (v = 0; v < 256; ++v) {
+    stats->hist[v] = hist[0][v] + hist[1][v] + hist[2][v] + hist[3][v];
+    weighted += (uint64_t) v * stats->hist[v];
+    if (v <= params->clip_low)
+      low += stats->hist[v];
+    if (v >= params->clip_high)
+      high += stats->hist[v];
+  }
+
+  if (stats->samples) {
+    stats->mean = (double) weighted / stats->samples;
+    stats->clipped_low = (double) low / stats->samples;
+    stats->clipped_high = (double) high / stats->samples;
+    stats->sharpness = (double) grad / stats->samples;
+  }
+}
+
+/** @brief Fill in the default frame statistics parameters
+ * @ingroup frame
+ *
+ * One cell covering the whole frame, every row, and clipping thresholds for
+ * full-range video. Use 16 and 235 for limited-range sources.
+ */
+void uvc_frame_stats_params_init(uvc_frame_stats_params_t *params) {
+  params->grid_cols = 1;
+  params->grid_rows = 1;
+  params->clip_low = STATS_DEFAULT_CLIP_LOW;
+  params->clip_high = STATS_DEFAULT_CLIP_HIGH;
+  params->row_step = 1;
+}
+
+/** @brief Measure the luma histogram, mean, clipping and sharpness of a frame
+ * @ingroup frame
+ *
+ * Works on the frame as captured, without conversion, and is cheap enough
+ * to run on every frame from the frame callback. Sharpness is the gradient
+ * energy (squared differences to the right and lower neighbours within the
+ * cell), which peaks when the image is in focus.
+ *
+ * MJPEG frames are measured on the DC coefficients of their luma blocks:
+ * each sample is the mean of an 8x8 block, so the histogram counts blocks
+ * and sharpness only sees detail coarser than a block.
+ *
+ * @param frame Frame in YUYV, UYVY, NV12, GRAY8 or MJPEG (with JPEG support)
+ * @param params Grid and thresholds, or NULL for uvc_frame_stats_params_init()'s
+ * @param[out] stats grid_cols * grid_rows cells, row by row from the top left
+ * @return UVC_SUCCESS, or UVC_ERROR_NOT_SUPPORTED for other formats
+ */
+uvc_error_t uvc_get_frame_stats(uvc_frame_t *frame, const uvc_frame_stats_params_t *params,
+                                uvc_frame_stats_t *stats) {
+  uvc_frame_stats_params_t defaults;
+  const uint8_t *plane;
+  uvc_frame_t *dc = NULL;
+  size_t step, pitch, width, height;
+  int col, row;
+  uvc_error_t ret = UVC_SUCCESS;
+
+  if (!params) {
+    uvc_frame_stats_params_init(&defaults);
+    params = &defaults;
+  }
+
+  if (params->grid_cols <= 0 || params->grid_rows <= 0 || params->row_step <= 0)
+    return UVC_ERROR_INVALID_PARAM;
+
+  switch (frame->frame_format) {
+  case UVC_FRAME_FORMAT_YUYV:
+    plane = frame->data;
+    step = 2;
+    break;
+  case UVC_FRAME_FORMAT_UYVY:
+    plane = (const uint8_t *) frame->data + 1;
+    step = 2;
+    break;
+  case UVC_FRAME_FORMAT_NV12:
+  case UVC_FRAME_FORMAT_GRAY8:
+    plane = frame->data;
+    step = 1;
+    break;
+#ifdef LIBUVC_HAS_JPEG
+  case UVC_FRAME_FORMAT_MJPEG:
+    dc = uvc_allocate_frame(0);
+    if (!dc)
+      return UVC_ERROR_NO_MEM;
+    ret = uvc_mjpeg_dc2gray(frame, dc);
+    if (ret != UVC_SUCCESS) {
+      uvc_free_frame(dc);
+      return ret;
+    }
+    frame = dc;
+    plane = frame->data;
+    step = 1;
+    break;
+#endif
+  default:
+    return UVC_ERROR_NOT_SUPPORTED;
+  }
+
+  width = frame->width;
+  height = frame->height;
+  pitch = frame->step ? frame->step : width * step;
+  if (width < (size_t) params->grid_cols || height < (size_t) params->grid_rows ||
+      frame->data_bytes < pitch * (height - 1) + width * step) {
+    ret = UVC_ERROR_INVALID_PARAM;
+    goto done;
+  }
+
+  for (row = 0; row < params->grid_rows; ++row) {
+    size_t y0 = height * row / params->grid_rows;
+    size_t y1 = height * (row + 1) / params->grid_rows;
+
+    for (col = 0; col < params->grid_cols; ++col) {
+      size_t x0 = width * col / params->grid_cols;
+      size_t x1 = width * (col + 1) / params->grid_cols;
+
+      stats_cell(plane, pitch, step, x0, x1, y0, y1, params,
+                 &stats[row * params->grid_cols + col]);
+    }
+  }
+
+done:
+  if (dc)
+    uvc_free_frame(dc);
+
+  return ret;
+}
@@ -44,8 +44,14 @@ uvc_error_t uvc_init(uvc_context_t **pctx, struct libusb_context *usb_ctx) {
     ctx->usb_ctx = usb_ctx;
   }
 
-  if (ctx != NULL)
+  if (ctx != NULL) {
+    pthread_mutex_init(&ctx->desc_cache_mutex, NULL);
+    pthread_mutex_init(&ctx->probe_cache_mutex, NULL);
+    pthread_mutex_init(&ctx->string_cache_mutex, NULL);
+    pthread_mutex_init(&ctx->quirks_mutex, NULL);
+    ctx->probe_cache_enabled = 1;
     *pctx = ctx;
+  }
 
   return ret;
 }
@@ -69,9 +75,21 @@ void uvc_exit(uvc_context_t *ctx) {
     uvc_close(devh);
   }
 
+  uvc_set_device_index_enabled(ctx, 0);
+
   if (ctx->own_usb_ctx)
     libusb_exit(ctx->usb_ctx);
 
+  uvc_desc_cache_free(ctx);
+  pthread_mutex_destroy(&ctx->desc_cache_mutex);
+  free(ctx->desc_cache_dir);
+  uvc_probe_cache_free(ctx);
+  pthread_mutex_destroy(&ctx->probe_cache_mutex);
+  free(ctx->probe_cache_dir);
+  uvc_string_cache_free(ctx);
+  pthread_mutex_destroy(&ctx->string_cache_mutex);
+  pthread_mutex_destroy(&ctx->quirks_mutex);
+  free(ctx->quirks);
   free(ctx);
 }
 
@@ -84,7 +102,11 @@ void uvc_exit(uvc_context_t *ctx) {
  * are already open (and being handled).
  */
 void uvc_start_handler_thread(uvc_context_t *ctx) {
-  if (ctx->own_usb_ctx)
-    pthread_create(&ctx->handler_thread, NULL, _uvc_handle_events, (void*) ctx);
+  if (ctx->own_usb_ctx) {
+    /* left set by the previous thread's shutdown */
+    ctx->kill_handler_thread = 0;
+    if (pthread_create(&ctx->handler_thread, NULL, _uvc_handle_events, (void*) ctx) == 0)
+      ctx->handler_thread_running = 1;
+  }
 }
 
@@ -33,6 +33,9 @@
 *********************************************************************/
 #include <string.h>
 #include <stdlib.h>
+#include <time.h>
+#include "libuvc/libuvc.h"
+#include "libuvc/libuvc_internal.h"
 
 #if __APPLE__
 char *strndup(const char *s, size_t n) {
@@ -56,3 +59,12 @@ char *strndup(const char *s, size_t n) {
 }
 #endif
 
+/** @internal
+ * @brief Monotonic time in microseconds (CLOCK_MONOTONIC)
+ */
+uint64_t uvc_now_us(void) {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t) ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
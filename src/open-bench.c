@@ -0,0 +1,994 @@
+/* uvc-open-bench: measure descriptor parsing and device open cost.
+ *
+ * Parses a configuration descriptor blob over and over with
+ * uvc_scan_control(), the code uvc_open() runs to build the descriptor tree,
+ * and reports parse and free time, allocations and bytes per parse and the
+ * peak heap use during a parse. The blob is either read from a file (the
+ * raw "descriptors" file of a device in sysfs, or a bare configuration
+ * descriptor) or synthesized. By default the synthesized blob has the shape
+ * of the Logitech C920 in cameras/: three formats with 19, 17 and 17 frames
+ * of 7 intervals each, six extension units and eleven alternate settings.
+ *
+ * With --open, real devices are also opened and closed repeatedly, and the
+ * same numbers are reported for uvc_open() and uvc_close().
+ *
+ * With --lazy, parsing is also timed the way uvc_open_with_flags() does it
+ * with UVC_OPEN_DEFER_STREAMING (VideoControl only, streaming interfaces
+ * left for first use), and --open runs open with that flag and
+ * UVC_OPEN_NO_STATUS.
+ *
+ * With --desc-cache, the parsed blob is also saved to a descriptor cache
+ * and loading it back is timed against parsing (and --open runs use the
+ * cache, so the first open fills it and the rest load from it).
+ *
+ * Allocations are counted by wrapping malloc and friends, which needs glibc;
+ * elsewhere those fields are null.
+ */
+#include "libuvc/libuvc.h"
+#include "libuvc/libuvc_internal.h"
+#include "tools-common.h"
+
+#include <getopt.h>
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#define BENCH_COUNT_ALLOCS 1
+#endif
+
+/* Limits on the shape of blobs read from files */
+#define BENCH_MAX_INTERFACES 16
+#define BENCH_MAX_ALTSETTINGS 32
+#define BENCH_MAX_ENDPOINTS 4
+
+struct alloc_stats {
+  long count;
+  long bytes;
+  long live;
+  long peak;
+};
+
+static volatile int alloc_counting;
+static struct alloc_stats allocs;
+
+#ifdef BENCH_COUNT_ALLOCS
+/* Interpose the allocator; the library's calls resolve to these. */
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t nmemb, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+extern void __libc_free(void *ptr);
+
+static void note_alloc(void *ptr) {
+  long size = (long) malloc_usable_size(ptr);
+
+  allocs.count++;
+  allocs.bytes += size;
+  allocs.live += size;
+  if (allocs.live > allocs.peak)
+    allocs.peak = allocs.live;
+}
+
+void *malloc(size_t size) {
+  void *ptr = __libc_malloc(size);
+
+  if (alloc_counting && ptr)
+    note_alloc(ptr);
+  return ptr;
+}
+
+void *calloc(size_t nmemb, size_t size) {
+  void *ptr = __libc_calloc(nmemb, size);
+
+  if (alloc_counting && ptr)
+    note_alloc(ptr);
+  return ptr;
+}
+
+void *realloc(void *ptr, size_t size) {
+  void *ret;
+
+  if (alloc_counting && ptr)
+    allocs.live -= (long) malloc_usable_size(ptr);
+  ret = __libc_realloc(ptr, size);
+  if (alloc_counting && ret)
+    note_alloc(ret);
+  return ret;
+}
+
+void free(void *ptr) {
+  if (alloc_counting && ptr)
+    allocs.live -= (long) malloc_usable_size(ptr);
+  __libc_free(ptr);
+}
+#endif
+
+static void alloc_begin(void) {
+  memset(&allocs, 0, sizeof(allocs));
+  alloc_counting = 1;
+}
+
+static void alloc_end(void) {
+  alloc_counting = 0;
+}
+
+/** A configuration descriptor split up the way libusb presents it */
+struct bench_config {
+  struct libusb_config_descriptor config;
+  struct libusb_interface interfaces[BENCH_MAX_INTERFACES];
+  struct libusb_interface_descriptor alts[BENCH_MAX_INTERFACES][BENCH_MAX_ALTSETTINGS];
+  struct libusb_endpoint_descriptor eps[BENCH_MAX_INTERFACES][BENCH_MAX_ALTSETTINGS][BENCH_MAX_ENDPOINTS];
+  uint16_t vid, pid;
+  size_t config_bytes;
+};
+
+/** Attach a descriptor that follows an interface or endpoint to its "extra" */
+static void append_extra(const unsigned char **extra, int *extra_length, const uint8_t *desc) {
+  if (!*extra)
+    *extra = desc;
+  *extra_length = (int) (desc + desc[0] - *extra);
+}
+
+/** Split a raw configuration descriptor (optionally preceded by the device
+ * descriptor, as in sysfs) into libusb's structures */
+static int load_config(struct bench_config *bc, const uint8_t *blob, size_t len) {
+  const uint8_t *p = blob, *end = blob + len;
+  struct libusb_interface_descriptor *alt = NULL;
+  struct libusb_endpoint_descriptor *ep = NULL;
+  int num_alts[BENCH_MAX_INTERFACES] = { 0 };
+  int i;
+
+  memset(bc, 0, sizeof(*bc));
+
+  if (len >= 18 && p[0] == 18 && p[1] == LIBUSB_DT_DEVICE) {
+    bc->vid = SW_TO_SHORT(p + 8);
+    bc->pid = SW_TO_SHORT(p + 10);
+    p += 18;
+  }
+
+  if (end - p < 9 || p[1] != LIBUSB_DT_CONFIG || SW_TO_SHORT(p + 2) > end - p)
+    return -1;
+
+  end = p + SW_TO_SHORT(p + 2);
+  bc->config_bytes = end - p;
+  bc->config.bLength = p[0];
+  bc->config.bDescriptorType = p[1];
+  bc->config.wTotalLength = SW_TO_SHORT(p + 2);
+  bc->config.bNumInterfaces = p[4];
+  bc->config.bConfigurationValue = p[5];
+  bc->config.iConfiguration = p[6];
+  bc->config.bmAttributes = p[7];
+  bc->config.MaxPower = p[8];
+  bc->config.interface = bc->interfaces;
+  p += p[0];
+
+  if (bc->config.bNumInterfaces > BENCH_MAX_INTERFACES)
+    return -1;
+
+  for (; end - p >= 2 && p[0] >= 2 && p[0] <= end - p; p += p[0]) {
+    if (p[1] == LIBUSB_DT_INTERFACE && p[0] >= 9) {
+      if (p[2] >= BENCH_MAX_INTERFACES || num_alts[p[2]] >= BENCH_MAX_ALTSETTINGS) {
+        alt = NULL;
+        ep = NULL;
+        continue;
+      }
+      alt = &bc->alts[p[2]][num_alts[p[2]]];
+      alt->bLength = p[0];
+      alt->bDescriptorType = p[1];
+      alt->bInterfaceNumber = p[2];
+      alt->bAlternateSetting = p[3];
+      alt->bInterfaceClass = p[5];
+      alt->bInterfaceSubClass = p[6];
+      alt->bInterfaceProtocol = p[7];
+      alt->iInterface = p[8];
+      alt->endpoint = bc->eps[p[2]][num_alts[p[2]]];
+      num_alts[p[2]]++;
+      ep = NULL;
+    } else if (p[1] == LIBUSB_DT_ENDPOINT && p[0] >= 7) {
+      if (!alt || alt->bNumEndpoints >= BENCH_MAX_ENDPOINTS) {
+        ep = NULL;
+        continue;
+      }
+      ep = (struct libusb_endpoint_descriptor *) &alt->endpoint[alt->bNumEndpoints++];
+      ep->bLength = p[0];
+      ep->bDescriptorType = p[1];
+      ep->bEndpointAddress = p[2];
+      ep->bmAttributes = p[3];
+      ep->wMaxPacketSize = SW_TO_SHORT(p + 4);
+      ep->bInterval = p[6];
+    } else if (ep) {
+      append_extra(&ep->extra, &ep->extra_length, p);
+    } else if (alt) {
+      append_extra(&alt->extra, &alt->extra_length, p);
+    } else {
+      append_extra(&bc->config.extra, &bc->config.extra_length, p);
+    }
+  }
+
+  for (i = 0; i < bc->config.bNumInterfaces; ++i) {
+    bc->interfaces[i].altsetting = bc->alts[i];
+    bc->interfaces[i].num_altsetting = num_alts[i];
+    if (!num_alts[i])
+      return -1;
+  }
+
+  return 0;
+}
+
+/** Growable byte buffer for the synthesizer */
+struct blob {
+  uint8_t *data;
+  size_t len, cap;
+};
+
+static uint8_t *blob_add(struct blob *b, size_t n) {
+  uint8_t *p;
+
+  if (b->len + n > b->cap) {
+    b->cap = (b->len + n) * 2;
+    b->data = realloc(b->data, b->cap);
+  }
+  p = b->data + b->len;
+  memset(p, 0, n);
+  b->len += n;
+  return p;
+}
+
+static void put16(uint8_t *p, uint16_t v) {
+  p[0] = v;
+  p[1] = v >> 8;
+}
+
+static void put32(uint8_t *p, uint32_t v) {
+  put16(p, v);
+  put16(p + 2, v >> 16);
+}
+
+static const uint16_t synth_sizes[][2] = {
+  { 640, 480 }, { 160, 90 }, { 160, 120 }, { 176, 144 }, { 320, 180 }, { 320, 240 },
+  { 352, 288 }, { 432, 240 }, { 640, 360 }, { 800, 448 }, { 800, 600 }, { 864, 480 },
+  { 960, 720 }, { 1024, 576 }, { 1280, 720 }, { 1600, 896 }, { 1920, 1080 },
+  { 2304, 1296 }, { 2304, 1536 }
+};
+
+static const uint8_t synth_guid_yuy2[16] = {
+  'Y', 'U', 'Y', '2', 0x00, 0x00, 0x10, 0x00, 0x80, 0x00, 0x00, 0xaa, 0x00, 0x38, 0x9b, 0x71
+};
+
+static const uint8_t synth_guid_h264[16] = {
+  'H', '2', '6', '4', 0x00, 0x00, 0x10, 0x00, 0x80, 0x00, 0x00, 0xaa, 0x00, 0x38, 0x9b, 0x71
+};
+
+/** Build a device plus configuration descriptor for a camera with the given
+ * number of frames per format (formats cycle through YUY2, MJPEG and H.264) */
+static int synth_config(struct blob *b, const int *frames, int num_formats, int num_intervals) {
+  size_t config_start, vc_start, vs_start;
+  uint8_t *p;
+  int f, i, k;
+
+  if (num_formats < 1 || num_formats > 255 || num_intervals < 1 || num_intervals > 50)
+    return -1;
+
+  /* device descriptor */
+  p = blob_add(b, 18);
+  p[0] = 18;
+  p[1] = LIBUSB_DT_DEVICE;
+  put16(p + 2, 0x0200);
+  p[4] = 0xef;
+  p[5] = 2;
+  p[6] = 1;
+  p[7] = 64;
+  put16(p + 8, 0x046d);
+  put16(p + 10, 0x082d);
+  put16(p + 12, 0x0011);
+  p[17] = 1;
+
+  config_start = b->len;
+  p = blob_add(b, 9);
+  p[0] = 9;
+  p[1] = LIBUSB_DT_CONFIG;
+  p[4] = 2;
+  p[5] = 1;
+  p[7] = 0x80;
+  p[8] = 250;
+
+  /* interface association */
+  p = blob_add(b, 8);
+  p[0] = 8;
+  p[1] = 11;
+  p[3] = 2;
+  p[4] = 14;
+  p[5] = 3;
+
+  /* VideoControl interface */
+  p = blob_add(b, 9);
+  p[0] = 9;
+  p[1] = LIBUSB_DT_INTERFACE;
+  p[4] = 1;
+  p[5] = 14;
+  p[6] = 1;
+
+  vc_start = b->len;
+  p = blob_add(b, 13);
+  p[0] = 13;
+  p[1] = 0x24;
+  p[2] = UVC_VC_HEADER;
+  put16(p + 3, 0x0100);
+  put32(p + 7, 30000000);
+  p[11] = 1;
+  p[12] = 1;
+
+  p = blob_add(b, 18);
+  p[0] = 18;
+  p[1] = 0x24;
+  p[2] = UVC_VC_INPUT_TERMINAL;
+  p[3] = 1;
+  put16(p + 4, UVC_ITT_CAMERA);
+  p[14] = 3;
+  p[15] = 0x0a;
+  p[16] = 0x0a;
+  p[17] = 0x02;
+
+  p = blob_add(b, 11);
+  p[0] = 11;
+  p[1] = 0x24;
+  p[2] = UVC_VC_PROCESSING_UNIT;
+  p[3] = 3;
+  p[4] = 1;
+  put16(p + 5, 16384);
+  p[7] = 2;
+  p[8] = 0xff;
+  p[9] = 0x37;
+
+  for (i = 0; i < 6; ++i) {
+    p = blob_add(b, 27);
+    p[0] = 27;
+    p[1] = 0x24;
+    p[2] = UVC_VC_EXTENSION_UNIT;
+    p[3] = 8 + i;
+    memset(p + 4, 0x40 + i, 16);
+    p[20] = 8;
+    p[21] = 1;
+    p[22] = i ? 8 + i - 1 : 3;
+    p[23] = 2;
+    p[24] = 0xff;
+    p[25] = 0x03;
+  }
+
+  p = blob_add(b, 9);
+  p[0] = 9;
+  p[1] = 0x24;
+  p[2] = UVC_VC_OUTPUT_TERMINAL;
+  p[3] = 4;
+  put16(p + 4, 0x0101);
+  p[7] = 13;
+  put16(b->data + vc_start + 5, (uint16_t) (b->len - vc_start));
+
+  p = blob_add(b, 7);
+  p[0] = 7;
+  p[1] = LIBUSB_DT_ENDPOINT;
+  p[2] = 0x83;
+  p[3] = 3;
+  put16(p + 4, 64);
+  p[6] = 8;
+
+  p = blob_add(b, 5);
+  p[0] = 5;
+  p[1] = 0x25;
+  p[2] = 3;
+  put16(p + 3, 64);
+
+  /* VideoStreaming interface, alternate setting 0 */
+  p = blob_add(b, 9);
+  p[0] = 9;
+  p[1] = LIBUSB_DT_INTERFACE;
+  p[2] = 1;
+  p[5] = 14;
+  p[6] = 2;
+
+  vs_start = b->len;
+  p = blob_add(b, 13 + num_formats);
+  p[0] = 13 + num_formats;
+  p[1] = 0x24;
+  p[2] = UVC_VS_INPUT_HEADER;
+  p[3] = num_formats;
+  p[6] = 0x81;
+  p[8] = 4;
+  p[12] = 1;
+
+  for (f = 0; f < num_formats; ++f) {
+    int kind = f % 3, n = frames[f];
+
+    if (n < 1 || n > 255)
+      return -1;
+
+    if (kind == 0) {
+      p = blob_add(b, 27);
+      p[0] = 27;
+      p[2] = UVC_VS_FORMAT_UNCOMPRESSED;
+      memcpy(p + 5, synth_guid_yuy2, 16);
+      p[21] = 16;
+    } else if (kind == 1) {
+      p = blob_add(b, 11);
+      p[0] = 11;
+      p[2] = UVC_VS_FORMAT_MJPEG;
+      p[5] = 1;
+    } else {
+      p = blob_add(b, 28);
+      p[0] = 28;
+      p[2] = UVC_VS_FORMAT_FRAME_BASED;
+      memcpy(p + 5, synth_guid_h264, 16);
+      p[21] = 16;
+      p[27] = 1;
+    }
+    p[1] = 0x24;
+    p[3] = f + 1;
+    p[4] = n;
+    p[kind == 1 ? 6 : 22] = 1;
+
+    for (i = 0; i < n; ++i) {
+      const uint16_t *size = synth_sizes[i % (sizeof(synth_sizes) / sizeof(synth_sizes[0]))];
+      uint32_t frame_bytes = (uint32_t) size[0] * size[1] * 2;
+
+      p = blob_add(b, 26 + 4 * num_intervals);
+      p[0] = 26 + 4 * num_intervals;
+      p[1] = 0x24;
+      p[2] = kind == 0 ? UVC_VS_FRAME_UNCOMPRESSED
+        : kind == 1 ? UVC_VS_FRAME_MJPEG : UVC_VS_FRAME_FRAME_BASED;
+      p[3] = i + 1;
+      put16(p + 5, size[0]);
+      put16(p + 7, size[1]);
+      put32(p + 9, frame_bytes * 8 * 5);
+      put32(p + 13, frame_bytes * 8 * 30);
+      if (kind == 2) {
+        put32(p + 17, 333333);
+        p[21] = num_intervals;
+      } else {
+        put32(p + 17, frame_bytes);
+        put32(p + 21, 333333);
+        p[25] = num_intervals;
+      }
+      for (k = 0; k < num_intervals; ++k)
+        put32(p + 26 + 4 * k, 333333 + 166667 * k);
+    }
+
+    p = blob_add(b, 6);
+    p[0] = 6;
+    p[1] = 0x24;
+    p[2] = UVC_VS_COLORFORMAT;
+    p[3] = 1;
+    p[4] = 1;
+    p[5] = 4;
+  }
+  put16(b->data + vs_start + 4, (uint16_t) (b->len - vs_start));
+
+  /* isochronous alternate settings */
+  for (i = 1; i <= 10; ++i) {
+    p = blob_add(b, 9);
+    p[0] = 9;
+    p[1] = LIBUSB_DT_INTERFACE;
+    p[2] = 1;
+    p[3] = i;
+    p[4] = 1;
+    p[5] = 14;
+    p[6] = 2;
+
+    p = blob_add(b, 7);
+    p[0] = 7;
+    p[1] = LIBUSB_DT_ENDPOINT;
+    p[2] = 0x81;
+    p[3] = 5;
+    put16(p + 4, i < 7 ? 192 * i : 0x1400 | (i - 6) * 0x0100);
+    p[6] = 1;
+  }
+
+  if (b->len - config_start > 0xffff)
+    return -1;
+  put16(b->data + config_start + 2, (uint16_t) (b->len - config_start));
+
+  return 0;
+}
+
+static int read_file(const char *path, struct blob *b) {
+  FILE *fp = fopen(path, "rb");
+  size_t n;
+
+  if (!fp)
+    return -1;
+
+  while (!feof(fp)) {
+    uint8_t *p = blob_add(b, 4096);
+
+    n = fread(p, 1, 4096, fp);
+    b->len -= 4096 - n;
+    if (ferror(fp)) {
+      fclose(fp);
+      return -1;
+    }
+  }
+
+  fclose(fp);
+  return 0;
+}
+
+struct timing {
+  double min_us, p50_us, p99_us, mean_us;
+};
+
+static void summarize(double *samples, int count, struct timing *t) {
+  double sum = 0;
+  int i;
+
+  for (i = 0; i < count; ++i)
+    sum += samples[i];
+
+  qsort(samples, count, sizeof(double), tool_compare_double);
+  t->min_us = samples[0];
+  t->p50_us = tool_percentile(samples, count, 50);
+  t->p99_us = tool_percentile(samples, count, 99);
+  t->mean_us = sum / count;
+}
+
+static void write_timing(FILE *fp, const char *indent, const char *name, const struct timing *t) {
+  fprintf(fp, "%s\"%s\": {\"min\": %.2f, \"p50\": %.2f, \"p99\": %.2f, \"mean\": %.2f},\n",
+          indent, name, t->min_us, t->p50_us, t->p99_us, t->mean_us);
+}
+
+static void write_allocs(FILE *fp, const char *indent, const char *what,
+                         const struct alloc_stats *a, int last) {
+#ifdef BENCH_COUNT_ALLOCS
+  fprintf(fp, "%s\"allocations_per_%s\": %ld,\n%s\"allocated_bytes_per_%s\": %ld,\n"
+          "%s\"peak_heap_bytes\": %ld%s\n",
+          indent, what, a->count, indent, what, a->bytes, indent, a->peak, last ? "" : ",");
+#else
+  (void) a;
+  fprintf(fp, "%s\"allocations_per_%s\": null,\n%s\"allocated_bytes_per_%s\": null,\n"
+          "%s\"peak_heap_bytes\": null%s\n", indent, what, indent, what, indent, last ? "" : ",");
+#endif
+}
+
+/** Time parsing with the streaming interfaces deferred, then parsing those */
+static void bench_parse_deferred(FILE *fp, struct bench_config *bc, int iterations) {
+  struct alloc_stats parse_allocs;
+  struct timing parse_t, rest_t;
+  double *parse_samples, *rest_samples;
+  uvc_context_t ctx;
+  uvc_device_t dev;
+  uvc_device_handle_t devh;
+  uvc_error_t res = UVC_SUCCESS;
+  int n;
+
+  /* just enough of a handle for uvc_scan_deferred_streaming() */
+  memset(&ctx, 0, sizeof(ctx));
+  memset(&dev, 0, sizeof(dev));
+  memset(&devh, 0, sizeof(devh));
+  dev.ctx = &ctx;
+  devh.dev = &dev;
+  pthread_mutex_init(&devh.info_mutex, NULL);
+
+  parse_samples = malloc(iterations * sizeof(double));
+  rest_samples = malloc(iterations * sizeof(double));
+  memset(&parse_allocs, 0, sizeof(parse_allocs));
+
+  for (n = 0; n < iterations && res == UVC_SUCCESS; ++n) {
+    uvc_device_info_t *info = calloc(1, sizeof(*info));
+    double start;
+
+    info->config = &bc->config;
+    info->defer_streaming = 1;
+
+    if (n == 0)
+      alloc_begin();
+    start = tool_now();
+    res = uvc_scan_control(NULL, info, bc->vid, bc->pid);
+    parse_samples[n] = (tool_now() - start) * 1e6;
+    if (n == 0) {
+      alloc_end();
+      parse_allocs = allocs;
+    }
+
+    devh.info = info;
+    start = tool_now();
+    if (res == UVC_SUCCESS)
+      res = uvc_scan_deferred_streaming(&devh, -1);
+    rest_samples[n] = (tool_now() - start) * 1e6;
+
+    info->config = NULL;
+    uvc_free_device_info(info);
+  }
+
+  fprintf(fp, ",\n  \"parse_deferred\": {\n");
+  if (res != UVC_SUCCESS) {
+    fprintf(fp, "    \"error\": ");
+    tool_json_string(fp, uvc_strerror(res));
+    fprintf(fp, "\n  }");
+  } else {
+    summarize(parse_samples, iterations, &parse_t);
+    summarize(rest_samples, iterations, &rest_t);
+    write_timing(fp, "    ", "parse_us", &parse_t);
+    write_timing(fp, "    ", "deferred_us", &rest_t);
+    write_allocs(fp, "    ", "parse", &parse_allocs, 1);
+    fprintf(fp, "  }");
+  }
+
+  pthread_mutex_destroy(&devh.info_mutex);
+  free(parse_samples);
+  free(rest_samples);
+}
+
+/** Save the parsed blob to the descriptor cache, then time loading it back */
+static void bench_cache(FILE *fp, struct bench_config *bc, const char *dir, int iterations) {
+  struct libusb_device_descriptor desc;
+  uvc_device_info_t *info;
+  struct alloc_stats load_allocs;
+  struct timing load_t, free_t;
+  double *load_samples, *free_samples;
+  uvc_context_t *ctx;
+  uint64_t key;
+  uvc_error_t res;
+  int n;
+
+  memset(&desc, 0, sizeof(desc));
+  memset(&load_allocs, 0, sizeof(load_allocs));
+  desc.idVendor = bc->vid;
+  desc.idProduct = bc->pid;
+  key = uvc_desc_cache_key(&desc, &bc->config);
+
+  fprintf(fp, ",\n  \"cache\": {\n");
+
+  info = calloc(1, sizeof(*info));
+  info->config = &bc->config;
+  res = uvc_scan_control(NULL, info, bc->vid, bc->pid);
+  if (res == UVC_SUCCESS)
+    res = uvc_desc_cache_store(dir, &desc, key, info);
+  info->config = NULL;
+  uvc_free_device_info(info);
+  if (res == UVC_SUCCESS)
+    res = uvc_init(&ctx, NULL);
+  if (res != UVC_SUCCESS) {
+    fprintf(fp, "    \"error\": ");
+    tool_json_string(fp, uvc_strerror(res));
+    fprintf(fp, "\n  }");
+    return;
+  }
+
+  uvc_set_desc_cache_dir(ctx, dir);
+  load_samples = malloc(iterations * sizeof(double));
+  free_samples = malloc(iterations * sizeof(double));
+
+  /* the first load maps the file; the rest reuse the mapping */
+  for (n = 0; n < iterations; ++n) {
+    double start;
+
+    if (n == 1)
+      alloc_begin();
+    start = tool_now();
+    res = uvc_desc_cache_load(ctx, &desc, key, &info);
+    load_samples[n] = (tool_now() - start) * 1e6;
+    if (n == 1) {
+      alloc_end();
+      load_allocs = allocs;
+    }
+    if (res != UVC_SUCCESS)
+      break;
+
+    start = tool_now();
+    uvc_free_device_info(info);
+    free_samples[n] = (tool_now() - start) * 1e6;
+  }
+
+  if (res != UVC_SUCCESS) {
+    fprintf(fp, "    \"error\": ");
+    tool_json_string(fp, uvc_strerror(res));
+    fprintf(fp, "\n  }");
+  } else {
+    summarize(load_samples, iterations, &load_t);
+    summarize(free_samples, iterations, &free_t);
+    write_timing(fp, "    ", "load_us", &load_t);
+    write_timing(fp, "    ", "free_us", &free_t);
+    write_allocs(fp, "    ", "load", &load_allocs, 1);
+    fprintf(fp, "  }");
+  }
+
+  free(load_samples);
+  free(free_samples);
+  uvc_exit(ctx);
+}
+
+/** Repeatedly open and close every matching device */
+static void bench_open(FILE *fp, uvc_context_t *ctx, int vid, int pid, int iterations,
+                       int flags) {
+  uvc_device_t **list;
+  double *open_samples, *close_samples;
+  int d, n, first = 1;
+
+  fprintf(fp, ",\n  \"open_flags\": %d,\n  \"open\": [", flags);
+
+  if (uvc_get_device_list(ctx, &list) != UVC_SUCCESS) {
+    fprintf(fp, "]");
+    return;
+  }
+
+  open_samples = malloc(iterations * sizeof(double));
+  close_samples = malloc(iterations * sizeof(double));
+
+  for (d = 0; list[d]; ++d) {
+    uvc_device_descriptor_t *desc;
+    struct alloc_stats open_allocs;
+    struct timing open_t, close_t;
+    uint16_t dev_vid = 0, dev_pid = 0;
+    uvc_error_t res = UVC_SUCCESS;
+
+    if (uvc_get_device_descriptor(list[d], &desc) == UVC_SUCCESS) {
+      dev_vid = desc->idVendor;
+      dev_pid = desc->idProduct;
+      uvc_free_device_descriptor(desc);
+    }
+    if ((vid && vid != dev_vid) || (pid && pid != dev_pid))
+      continue;
+
+    memset(&open_allocs, 0, sizeof(open_allocs));
+    for (n = 0; n < iterations; ++n) {
+      uvc_device_handle_t *devh;
+      double start = tool_now();
+
+      if (n == 0)
+        alloc_begin();
+      res = uvc_open_with_flags(list[d], &devh, flags);
+      if (n == 0) {
+        alloc_end();
+        open_allocs = allocs;
+      }
+      open_samples[n] = (tool_now() - start) * 1e6;
+      if (res != UVC_SUCCESS)
+        break;
+
+      start = tool_now();
+      uvc_close(devh);
+      close_samples[n] = (tool_now() - start) * 1e6;
+    }
+
+    fprintf(fp, "%s\n    {\n      \"vid\": \"%04x\",\n      \"pid\": \"%04x\",\n"
+            "      \"bus\": %u,\n      \"address\": %u,\n",
+            first ? "" : ",", dev_vid, dev_pid,
+            uvc_get_bus_number(list[d]), uvc_get_device_address(list[d]));
+    first = 0;
+
+    if (res != UVC_SUCCESS) {
+      fprintf(fp, "      \"error\": ");
+      tool_json_string(fp, uvc_strerror(res));
+      fprintf(fp, "\n    }");
+      continue;
+    }
+
+    summarize(open_samples, iterations, &open_t);
+    summarize(close_samples, iterations, &close_t);
+    write_timing(fp, "      ", "open_us", &open_t);
+    write_timing(fp, "      ", "close_us", &close_t);
+    write_allocs(fp, "      ", "open", &open_allocs, 1);
+    fprintf(fp, "    }");
+  }
+
+  fprintf(fp, "%s]", first ? "" : "\n  ");
+
+  free(open_samples);
+  free(close_samples);
+  uvc_free_device_list(list, 1);
+}
+
+static void usage(const char *argv0) {
+  fprintf(stderr,
+          "Usage: %s [options] [DESCRIPTORS]\n"
+          "  DESCRIPTORS            raw descriptors (sysfs \"descriptors\" file or a\n"
+          "                         configuration descriptor); default: synthesized\n"
+          "  -s, --synth F:N:I      synthesize F formats of N frames with I intervals each\n"
+          "  -i, --iterations N     parses (and opens) to time (default 1000)\n"
+          "      --open             also open and close attached devices\n"
+          "      --lazy             also time deferred parsing, and open devices with\n"
+          "                         deferred streaming interfaces and no status reads\n"
+          "  -v, --device VID:PID   only open this device (hex)\n"
+          "  -c, --desc-cache DIR   also time loading the parsed blob from a descriptor\n"
+          "                         cache in DIR, and open devices with that cache\n"
+          "  -o, --output FILE      write JSON to FILE instead of stdout\n",
+          argv0);
+}
+
+int main(int argc, char **argv) {
+  static const struct option long_options[] = {
+    { "synth", required_argument, NULL, 's' },
+    { "iterations", required_argument, NULL, 'i' },
+    { "open", no_argument, NULL, 'O' },
+    { "lazy", no_argument, NULL, 'L' },
+    { "device", required_argument, NULL, 'v' },
+    { "desc-cache", required_argument, NULL, 'c' },
+    { "output", required_argument, NULL, 'o' },
+    { "help", no_argument, NULL, 'h' },
+    { NULL, 0, NULL, 0 }
+  };
+  static const int c920_frames[] = { 19, 17, 17 };
+  int num_formats = 3, num_frames = 0, num_intervals = 7;
+  int *frames;
+  int iterations = 1000, do_open = 0, lazy = 0, vid = 0, pid = 0;
+  const char *output = NULL, *source = NULL, *cache_dir = NULL;
+  struct bench_config *bc;
+  struct blob b = { NULL, 0, 0 };
+  struct alloc_stats parse_allocs;
+  struct timing parse_t, free_t;
+  double *parse_samples, *free_samples;
+  int streams = 0, formats = 0, frame_count = 0, intervals = 0, xus = 0;
+  long rss_kb, peak_kb;
+  uvc_context_t *ctx = NULL;
+  FILE *fp = stdout;
+  int opt, n, f;
+
+  while ((opt = getopt_long(argc, argv, "s:i:v:c:o:h", long_options, NULL)) != -1) {
+    switch (opt) {
+    case 's':
+      if (sscanf(optarg, "%d:%d:%d", &num_formats, &num_frames, &num_intervals) != 3) {
+        fprintf(stderr, "bad shape '%s'\n", optarg);
+        return 1;
+      }
+      break;
+    case 'i':
+      iterations = atoi(optarg);
+      break;
+    case 'O':
+      do_open = 1;
+      break;
+    case 'L':
+      lazy = 1;
+      break;
+    case 'v':
+      if (sscanf(optarg, "%x:%x", &vid, &pid) != 2) {
+        fprintf(stderr, "bad device '%s'\n", optarg);
+        return 1;
+      }
+      break;
+    case 'c':
+      cache_dir = optarg;
+      break;
+    case 'o':
+      output = optarg;
+      break;
+    default:
+      usage(argv[0]);
+      return opt == 'h' ? 0 : 1;
+    }
+  }
+
+  if (iterations <= 0 || optind + 1 < argc || num_formats < 1 || num_formats > 255) {
+    usage(argv[0]);
+    return 1;
+  }
+
+  if (optind < argc) {
+    source = argv[optind];
+    if (read_file(source, &b)) {
+      perror(source);
+      return 1;
+    }
+  } else {
+    frames = malloc(num_formats * sizeof(int));
+    for (f = 0; f < num_formats; ++f)
+      frames[f] = num_frames ? num_frames : c920_frames[f % 3];
+    if (synth_config(&b, frames, num_formats, num_intervals)) {
+      fprintf(stderr, "cannot synthesize %d:%d:%d, too large\n",
+              num_formats, num_frames, num_intervals);
+      return 1;
+    }
+    free(frames);
+    source = num_frames ? "synthetic" : "synthetic (C920 shape)";
+  }
+
+  bc = calloc(1, sizeof(*bc));
+  if (load_config(bc, b.data, b.len)) {
+    fprintf(stderr, "%s: not a usable configuration descriptor\n", source);
+    return 1;
+  }
+
+  parse_samples = malloc(iterations * sizeof(double));
+  free_samples = malloc(iterations * sizeof(double));
+
+  for (n = 0; n < iterations; ++n) {
+    uvc_device_info_t *info = calloc(1, sizeof(*info));
+    uvc_error_t res;
+    double start;
+
+    info->config = &bc->config;
+
+    if (n == 0)
+      alloc_begin();
+    start = tool_now();
+    res = uvc_scan_control(NULL, info, bc->vid, bc->pid);
+    parse_samples[n] = (tool_now() - start) * 1e6;
+    if (n == 0) {
+      alloc_end();
+      parse_allocs = allocs;
+    }
+
+    if (res != UVC_SUCCESS) {
+      uvc_perror(res, "uvc_scan_control");
+      return 1;
+    }
+
+    if (n == 0) {
+      uvc_streaming_interface_t *stream_if;
+      uvc_format_desc_t *format;
+      uvc_frame_desc_t *frame;
+      uvc_extension_unit_t *xu;
+
+      DL_FOREACH(info->stream_ifs, stream_if) {
+        streams++;
+        DL_FOREACH(stream_if->format_descs, format) {
+          formats++;
+          DL_FOREACH(format->frame_descs, frame) {
+            frame_count++;
+            intervals += frame->bFrameIntervalType;
+          }
+        }
+      }
+      DL_FOREACH(info->ctrl_if.extension_unit_descs, xu)
+        xus++;
+    }
+
+    info->config = NULL;
+    start = tool_now();
+    uvc_free_device_info(info);
+    free_samples[n] = (tool_now() - start) * 1e6;
+  }
+
+  summarize(parse_samples, iterations, &parse_t);
+  summarize(free_samples, iterations, &free_t);
+
+  if (output) {
+    fp = fopen(output, "w");
+    if (!fp) {
+      perror(output);
+      fp = stdout;
+    }
+  }
+
+  fprintf(fp, "{\n  \"source\": ");
+  tool_json_string(fp, source);
+  fprintf(fp, ",\n  \"vid\": \"%04x\",\n  \"pid\": \"%04x\",\n  \"config_bytes\": %zu,\n",
+          bc->vid, bc->pid, bc->config_bytes);
+  fprintf(fp, "  \"tree\": {\"streaming_interfaces\": %d, \"formats\": %d, \"frames\": %d, "
+          "\"intervals\": %d, \"extension_units\": %d},\n",
+          streams, formats, frame_count, intervals, xus);
+  fprintf(fp, "  \"iterations\": %d,\n  \"parse\": {\n", iterations);
+  write_timing(fp, "    ", "parse_us", &parse_t);
+  write_timing(fp, "    ", "free_us", &free_t);
+  write_allocs(fp, "    ", "parse", &parse_allocs, 1);
+  fprintf(fp, "  }");
+
+  if (lazy)
+    bench_parse_deferred(fp, bc, iterations);
+
+  if (cache_dir)
+    bench_cache(fp, bc, cache_dir, iterations);
+
+  if (do_open) {
+    uvc_error_t res = uvc_init(&ctx, NULL);
+
+    if (res < 0) {
+      uvc_perror(res, "uvc_init");
+    } else {
+      if (cache_dir)
+        uvc_set_desc_cache_dir(ctx, cache_dir);
+      bench_open(fp, ctx, vid, pid, iterations,
+                 lazy ? UVC_OPEN_DEFER_STREAMING | UVC_OPEN_NO_STATUS : 0);
+      uvc_exit(ctx);
+    }
+  }
+
+  tool_memory_kb(&rss_kb, &peak_kb);
+  fprintf(fp, ",\n  \"peak_rss_kb\": %ld\n}\n", peak_kb);
+
+  if (fp != stdout)
+    fclose(fp);
+
+  free(parse_samples);
+  free(free_samples);
+  free(bc);
+  free(b.data);
+
+  return 0;
+}
@@ -0,0 +1,530 @@
+/* uvc-perf: hot-path throughput and latency benchmarks with baselines.
+ *
+ * Runs payload ingest, pixel-format conversion, MJPEG decode and
+ * end-to-end (first payload to user callback) latency benchmarks on
+ * synthetic streams, then compares the results against a baseline file.
+ * With --check the exit status is non-zero when any metric falls outside
+ * its tolerance band, so it can gate changes to src/stream.c and
+ * src/frame.c in CI.
+ *
+ * Absolute numbers only hold for the machine they were taken on, so each
+ * metric is divided by a reference measured in the same run with plain
+ * memcpy() of a frame: throughput by frames copied per second, latency by
+ * the time one copy takes. The baseline holds these ratios. The suite
+ * runs several rounds and keeps the best of each, which a briefly busy
+ * machine does not disturb.
+ *
+ * Baseline file format, one metric per line ('#' starts a comment):
+ *   <metric> <value relative to its reference> <tolerance percent>
+ */
+#include "libuvc/libuvc.h"
+#include "libuvc/libuvc_internal.h"
+#include "tools-common.h"
+
+#include <getopt.h>
+
+#ifdef LIBUVC_HAS_JPEG
+#include <jpeglib.h>
+#endif
+
+#define PERF_WIDTH 1280
+#define PERF_HEIGHT 720
+#define PERF_DEFAULT_TOLERANCE 25.0
+/* The suite runs this many times, keeping each metric's best result */
+#define PERF_ROUNDS 3
+
+/* References the metrics are scaled by */
+enum {
+  REF_COPY,
+  REF_COPY_US,
+  REF_COUNT
+};
+
+static const char *ref_names[REF_COUNT] = {
+  "copy_frames_per_s", "copy_frame_us"
+};
+
+static double refs[REF_COUNT];
+
+struct perf_metric {
+  const char *name;
+  const char *unit;
+  /** 1 if larger values are better, 0 if smaller values are better */
+  int higher_is_better;
+  /** REF_* the value is divided by for the baseline */
+  int ref;
+  /** Multiplies the tolerance written with --write, for noisy metrics */
+  double noise;
+  double value;
+  int measured;
+};
+
+enum {
+  METRIC_INGEST,
+  METRIC_YUYV2RGB,
+  METRIC_UYVY2BGR,
+  METRIC_UYVY2RGB,
+  METRIC_MJPEG_DECODE,
+  METRIC_LATENCY_P50,
+  METRIC_LATENCY_P99,
+  METRIC_COUNT
+};
+
+static struct perf_metric metrics[METRIC_COUNT] = {
+  { .name = "ingest_payloads_per_s", .unit = "payloads/s", .higher_is_better = 1,
+    .ref = REF_COPY, .noise = 1 },
+  { .name = "yuyv2rgb_mpix_per_s", .unit = "MPix/s", .higher_is_better = 1,
+    .ref = REF_COPY, .noise = 1 },
+  { .name = "uyvy2bgr_mpix_per_s", .unit = "MPix/s", .higher_is_better = 1,
+    .ref = REF_COPY, .noise = 1 },
+  { .name = "uyvy2rgb_mpix_per_s", .unit = "MPix/s", .higher_is_better = 1,
+    .ref = REF_COPY, .noise = 1 },
+  { .name = "mjpeg_decode_fps", .unit = "frames/s", .higher_is_better = 1,
+    .ref = REF_COPY, .noise = 1 },
+  { .name = "e2e_latency_p50_us", .unit = "us", .higher_is_better = 0,
+    .ref = REF_COPY_US, .noise = 1 },
+  { .name = "e2e_latency_p99_us", .unit = "us", .higher_is_better = 0,
+    .ref = REF_COPY_US, .noise = 2 },
+};
+
+static double bench_time = 1.0;
+
+/** Run time of one benchmark in one round */
+static double round_time(void) {
+  return bench_time / PERF_ROUNDS;
+}
+
+/** Keep the best of the values measured for a metric over the rounds */
+static void metric_record(int metric, double value) {
+  struct perf_metric *m = &metrics[metric];
+
+  if (!m->measured || (m->higher_is_better ? value > m->value : value < m->value))
+    m->value = value;
+  m->measured = 1;
+}
+
+/** A metric divided by its reference, or 0 if either is missing */
+static double metric_relative(const struct perf_metric *m) {
+  return m->measured && refs[m->ref] > 0 ? m->value / refs[m->ref] : 0;
+}
+
+/** Frame-sized memcpy()s per second. Run before each benchmark; the
+ * fastest run is the reference, like the best result of each metric. */
+static void bench_copy(void) {
+  size_t bytes = PERF_WIDTH * PERF_HEIGHT * 2;
+  uint8_t *src = malloc(bytes), *dst = malloc(bytes);
+  volatile uint8_t sink = 0;
+  uint64_t frames = 0;
+  double start, elapsed;
+
+  if (src && dst) {
+    memset(src, 0x5a, bytes);
+
+    start = tool_now();
+    do {
+      memcpy(dst, src, bytes);
+      sink ^= dst[frames % bytes];
+      frames++;
+      elapsed = tool_now() - start;
+    } while (elapsed < round_time() / 4);
+
+    if (frames / elapsed > refs[REF_COPY]) {
+      refs[REF_COPY] = frames / elapsed;
+      refs[REF_COPY_US] = elapsed / frames * 1e6;
+    }
+  }
+
+  (void) sink;
+  free(src);
+  free(dst);
+}
+
+/** Payloads per second through _uvc_process_payload(), no consumer */
+static int bench_ingest(uvc_context_t *ctx) {
+  uvc_device_handle_t *devh;
+  uvc_stream_handle_t *strmh;
+  uint64_t payloads = 0;
+  double start, elapsed;
+
+  if (uvc_synthetic_open(ctx, UVC_FRAME_FORMAT_YUYV, PERF_WIDTH, PERF_HEIGHT, 0, &devh))
+    return -1;
+  if (uvc_synthetic_stream_start(devh, &strmh, NULL, NULL, 0)) {
+    uvc_synthetic_close(devh);
+    return -1;
+  }
+
+  start = tool_now();
+  do {
+    payloads += uvc_synthetic_push_frame(strmh, devh->synthetic->image,
+                                         devh->synthetic->image_bytes);
+    elapsed = tool_now() - start;
+  } while (elapsed < round_time());
+
+  metric_record(METRIC_INGEST, payloads / elapsed);
+
+  uvc_synthetic_close(devh);
+  return 0;
+}
+
+static void bench_convert(int metric, enum uvc_frame_format in_format,
+                          uvc_error_t (*convert)(uvc_frame_t *, uvc_frame_t *)) {
+  uvc_frame_t *in = uvc_allocate_frame(PERF_WIDTH * PERF_HEIGHT * 2);
+  uvc_frame_t *out = uvc_allocate_frame(PERF_WIDTH * PERF_HEIGHT * 3);
+  uint64_t frames = 0;
+  double start, elapsed;
+  size_t i;
+
+  in->width = PERF_WIDTH;
+  in->height = PERF_HEIGHT;
+  in->step = PERF_WIDTH * 2;
+  in->frame_format = in_format;
+  for (i = 0; i < in->data_bytes; ++i)
+    ((uint8_t *) in->data)[i] = (uint8_t) (i * 7);
+
+  start = tool_now();
+  do {
+    if (convert(in, out) != UVC_SUCCESS)
+      break;
+    frames++;
+    elapsed = tool_now() - start;
+  } while (elapsed < round_time());
+
+  if (frames)
+    metric_record(metric, frames * (double) PERF_WIDTH * PERF_HEIGHT / elapsed / 1e6);
+
+  uvc_free_frame(in);
+  uvc_free_frame(out);
+}
+
+#ifdef LIBUVC_HAS_JPEG
+/** Encode the synthetic test pattern as a baseline JPEG */
+static int encode_test_jpeg(unsigned char **jpeg, unsigned long *jpeg_bytes) {
+  struct jpeg_compress_struct cinfo;
+  struct jpeg_error_mgr jerr;
+  JSAMPROW row;
+  unsigned char *rgb = malloc(PERF_WIDTH * 3);
+  int x;
+
+  if (!rgb)
+    return -1;
+
+  cinfo.err = jpeg_std_error(&jerr);
+  jpeg_create_compress(&cinfo);
+  *jpeg = NULL;
+  *jpeg_bytes = 0;
+  jpeg_mem_dest(&cinfo, jpeg, jpeg_bytes);
+
+  cinfo.image_width = PERF_WIDTH;
+  cinfo.image_height = PERF_HEIGHT;
+  cinfo.input_components = 3;
+  cinfo.in_color_space = JCS_RGB;
+  jpeg_set_defaults(&cinfo);
+  jpeg_set_quality(&cinfo, 85, TRUE);
+  jpeg_start_compress(&cinfo, TRUE);
+
+  row = rgb;
+  while (cinfo.next_scanline < cinfo.image_height) {
+    for (x = 0; x < PERF_WIDTH; ++x) {
+      rgb[x * 3] = (unsigned char) x;
+      rgb[x * 3 + 1] = (unsigned char) cinfo.next_scanline;
+      rgb[x * 3 + 2] = (unsigned char) (x ^ cinfo.next_scanline);
+    }
+    jpeg_write_scanlines(&cinfo, &row, 1);
+  }
+
+  jpeg_finish_compress(&cinfo);
+  jpeg_destroy_compress(&cinfo);
+  free(rgb);
+
+  return 0;
+}
+
+static void bench_mjpeg(void) {
+  unsigned char *jpeg;
+  unsigned long jpeg_bytes;
+  uvc_frame_t in;
+  uvc_frame_t *out;
+  uint64_t frames = 0;
+  double start, elapsed;
+
+  if (encode_test_jpeg(&jpeg, &jpeg_bytes))
+    return;
+
+  memset(&in, 0, sizeof(in));
+  in.data = jpeg;
+  in.data_bytes = jpeg_bytes;
+  in.width = PERF_WIDTH;
+  in.height = PERF_HEIGHT;
+  in.frame_format = UVC_FRAME_FORMAT_MJPEG;
+
+  out = uvc_allocate_frame(PERF_WIDTH * PERF_HEIGHT * 3);
+
+  start = tool_now();
+  do {
+    if (uvc_mjpeg2rgb(&in, out) != UVC_SUCCESS)
+      break;
+    frames++;
+    elapsed = tool_now() - start;
+  } while (elapsed < round_time());
+
+  if (frames)
+    metric_record(METRIC_MJPEG_DECODE, frames / elapsed);
+
+  uvc_free_frame(out);
+  free(jpeg);
+}
+#endif
+
+struct latency_state {
+  pthread_mutex_t mutex;
+  pthread_cond_t cond;
+  double pushed_at;
+  double *samples;
+  size_t count;
+};
+
+static void latency_cb(uvc_frame_t *frame, void *ptr) {
+  struct latency_state *st = ptr;
+  double now = tool_now();
+
+  (void) frame;
+  pthread_mutex_lock(&st->mutex);
+  st->samples[st->count++] = (now - st->pushed_at) * 1e6;
+  pthread_cond_signal(&st->cond);
+  pthread_mutex_unlock(&st->mutex);
+}
+
+/** Time from the first payload of a frame to the user callback seeing it */
+static int bench_latency(uvc_context_t *ctx) {
+  uvc_device_handle_t *devh;
+  uvc_stream_handle_t *strmh;
+  struct latency_state st;
+  size_t max_samples = 100000;
+  double start;
+
+  memset(&st, 0, sizeof(st));
+  pthread_mutex_init(&st.mutex, NULL);
+  pthread_cond_init(&st.cond, NULL);
+  st.samples = malloc(max_samples * sizeof(double));
+
+  if (!st.samples ||
+      uvc_synthetic_open(ctx, UVC_FRAME_FORMAT_YUYV, PERF_WIDTH, PERF_HEIGHT, 0, &devh)) {
+    free(st.samples);
+    return -1;
+  }
+  if (uvc_synthetic_stream_start(devh, &strmh, latency_cb, &st, 0)) {
+    uvc_synthetic_close(devh);
+    free(st.samples);
+    return -1;
+  }
+
+  start = tool_now();
+  while (st.count < max_samples && tool_now() - start < round_time()) {
+    size_t expect = st.count + 1;
+
+    st.pushed_at = tool_now();
+    uvc_synthetic_push_frame(strmh, devh->synthetic->image, devh->synthetic->image_bytes);
+
+    /* wait for the callback so frames are never coalesced */
+    pthread_mutex_lock(&st.mutex);
+    while (st.count < expect)
+      pthread_cond_wait(&st.cond, &st.mutex);
+    pthread_mutex_unlock(&st.mutex);
+  }
+
+  uvc_synthetic_close(devh);
+
+  if (st.count) {
+    qsort(st.samples, st.count, sizeof(double), tool_compare_double);
+    metric_record(METRIC_LATENCY_P50, tool_percentile(st.samples, st.count, 50));
+    metric_record(METRIC_LATENCY_P99, tool_percentile(st.samples, st.count, 99));
+  }
+
+  free(st.samples);
+  pthread_cond_destroy(&st.cond);
+  pthread_mutex_destroy(&st.mutex);
+
+  return 0;
+}
+
+static struct perf_metric *find_metric(const char *name) {
+  int i;
+
+  for (i = 0; i < METRIC_COUNT; ++i) {
+    if (!strcmp(metrics[i].name, name))
+      return &metrics[i];
+  }
+
+  return NULL;
+}
+
+/** Compare results to a baseline file; returns the number of regressions */
+static int check_baseline(const char *path, int *checked) {
+  FILE *fp = fopen(path, "r");
+  char line[256], name[64];
+  double baseline, tolerance;
+  int regressions = 0;
+
+  *checked = 0;
+
+  if (!fp) {
+    perror(path);
+    return -1;
+  }
+
+  printf("\n%-24s %14s %14s %8s  %s\n", "metric", "baseline", "measured", "delta", "result");
+
+  while (fgets(line, sizeof(line), fp)) {
+    struct perf_metric *m;
+    double delta;
+    int ok;
+
+    if (line[0] == '#' || sscanf(line, "%63s %lf %lf", name, &baseline, &tolerance) < 2)
+      continue;
+
+    m = find_metric(name);
+    if (!m || !metric_relative(m)) {
+      printf("%-24s %14.4f %14s %8s  skipped\n", name, baseline, "-", "-");
+      continue;
+    }
+
+    delta = baseline ? (metric_relative(m) - baseline) / baseline * 100.0 : 0;
+    ok = m->higher_is_better ? delta >= -tolerance : delta <= tolerance;
+    printf("%-24s %14.4f %14.4f %+7.1f%%  %s\n", name, baseline, metric_relative(m), delta,
+           ok ? "ok" : "REGRESSION");
+
+    (*checked)++;
+    if (!ok)
+      regressions++;
+  }
+
+  fclose(fp);
+
+  return regressions;
+}
+
+static int write_baseline(const char *path, double tolerance) {
+  FILE *fp = fopen(path, "w");
+  int i;
+
+  if (!fp) {
+    perror(path);
+    return -1;
+  }
+
+  fprintf(fp, "# uvc-perf baseline: <metric> <value relative to its reference> "
+          "<tolerance percent>\n");
+  fprintf(fp, "# recorded with");
+  for (i = 0; i < REF_COUNT; ++i)
+    fprintf(fp, " %s %.2f", ref_names[i], refs[i]);
+  fprintf(fp, "\n");
+  for (i = 0; i < METRIC_COUNT; ++i) {
+    if (metric_relative(&metrics[i]))
+      fprintf(fp, "%-24s %.4f %.0f\n", metrics[i].name, metric_relative(&metrics[i]),
+              tolerance * metrics[i].noise);
+  }
+
+  fclose(fp);
+
+  return 0;
+}
+
+static void usage(const char *argv0) {
+  fprintf(stderr,
+          "Usage: %s [options]\n"
+          "  -b, --baseline FILE   compare against FILE\n"
+          "  -c, --check           exit with status 1 on any regression (needs --baseline)\n"
+          "  -w, --write FILE      record the results as a new baseline\n"
+          "  -T, --tolerance PCT   tolerance written with --write (default %.0f)\n"
+          "  -t, --time SEC        run time per benchmark (default 1)\n",
+          argv0, PERF_DEFAULT_TOLERANCE);
+}
+
+int main(int argc, char **argv) {
+  static const struct option long_options[] = {
+    { "baseline", required_argument, NULL, 'b' },
+    { "check", no_argument, NULL, 'c' },
+    { "write", required_argument, NULL, 'w' },
+    { "tolerance", required_argument, NULL, 'T' },
+    { "time", required_argument, NULL, 't' },
+    { "help", no_argument, NULL, 'h' },
+    { NULL, 0, NULL, 0 }
+  };
+  const char *baseline = NULL, *write_path = NULL;
+  double tolerance = PERF_DEFAULT_TOLERANCE;
+  int check = 0, regressions = 0, checked = 0;
+  uvc_context_t *ctx;
+  int opt, round, i;
+
+  while ((opt = getopt_long(argc, argv, "b:cw:T:t:h", long_options, NULL)) != -1) {
+    switch (opt) {
+    case 'b':
+      baseline = optarg;
+      break;
+    case 'c':
+      check = 1;
+      break;
+    case 'w':
+      write_path = optarg;
+      break;
+    case 'T':
+      tolerance = atof(optarg);
+      break;
+    case 't':
+      bench_time = atof(optarg);
+      break;
+    default:
+      usage(argv[0]);
+      return opt == 'h' ? 0 : 2;
+    }
+  }
+
+  if ((check && !baseline) || bench_time <= 0) {
+    usage(argv[0]);
+    return 2;
+  }
+
+  if (uvc_init(&ctx, NULL) < 0) {
+    fprintf(stderr, "uvc_init failed\n");
+    return 2;
+  }
+
+  for (round = 0; round < PERF_ROUNDS; ++round) {
+    bench_copy();
+    bench_ingest(ctx);
+    bench_copy();
+    bench_convert(METRIC_YUYV2RGB, UVC_FRAME_FORMAT_YUYV, uvc_yuyv2rgb);
+    bench_copy();
+    bench_convert(METRIC_UYVY2BGR, UVC_FRAME_FORMAT_UYVY, uvc_uyvy2bgr);
+    bench_copy();
+    bench_convert(METRIC_UYVY2RGB, UVC_FRAME_FORMAT_UYVY, uvc_uyvy2rgb);
+#ifdef LIBUVC_HAS_JPEG
+    bench_copy();
+    bench_mjpeg();
+#endif
+    bench_copy();
+    bench_latency(ctx);
+  }
+
+  uvc_exit(ctx);
+
+  for (i = 0; i < REF_COUNT; ++i)
+    printf("%-24s %14.2f (reference)\n", ref_names[i], refs[i]);
+  for (i = 0; i < METRIC_COUNT; ++i) {
+    if (metrics[i].measured)
+      printf("%-24s %14.2f %-10s %10.4f x %s\n", metrics[i].name, metrics[i].value,
+             metrics[i].unit, metric_relative(&metrics[i]), ref_names[metrics[i].ref]);
+  }
+
+  if (write_path && write_baseline(write_path, tolerance))
+    return 2;
+
+  if (baseline) {
+    regressions = check_baseline(baseline, &checked);
+    if (regressions < 0)
+      return 2;
+    printf("\n%d of %d metrics regressed\n", regressions, checked);
+  }
+
+  return check && regressions ? 1 : 0;
+}
@@ -0,0 +1,462 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (C) 2010-2012 Ken Tossell
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the author nor other contributors may be
+*     used to endorse or promote products derived from this software
+*     without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+/**
+ * @internal
+ * @file probe-cache.c
+ * @brief Cache of negotiated streaming parameters.
+ *
+ * Probing a streaming mode (uvc_probe_stream_ctrl()) takes a SET_CUR and a
+ * GET_CUR on the probe control, and some cameras spend hundreds of
+ * milliseconds working out their answer. For a given device model, firmware
+ * and bus speed the answer to the same request does not change, so
+ * successful probes are remembered per device identity and request, and a
+ * repeated probe is answered from memory without touching the device.
+ *
+ * A cached answer is only trusted once the device has accepted it: when it
+ * is committed, uvc_probe_cache_commit() reads the commit control back with
+ * a single GET_CUR. If the commit fails or the device reports different
+ * parameters, the entry is dropped and the mode is probed and committed the
+ * usual way.
+ *
+ * With a cache directory set (uvc_set_probe_cache()), each device's entries
+ * also live in a file there, so the next process can skip probing too:
+ *
+ *   header: char[4] magic "UVCP", u32 version, u64 key, u32 entry count,
+ *           u32 entry size
+ *   entry:  u8 interface, 34-byte request, 34-byte answer
+ *
+ * The header is in host order; requests and answers are in the wire format
+ * of the probe control (uvc_stream_ctrl_pack()).
+ */
+#include "libuvc/libuvc.h"
+#include "libuvc/libuvc_internal.h"
+
+#include <unistd.h>
+
+#define PROBE_CACHE_VERSION 1
+#define PROBE_CTRL_LEN 34
+#define PROBE_ENTRY_LEN (1 + 2 * PROBE_CTRL_LEN)
+/* Entries kept per device; the oldest goes first */
+#define PROBE_CACHE_MAX_ENTRIES 64
+
+static const char probe_cache_magic[4] = { 'U', 'V', 'C', 'P' };
+
+struct probe_cache_header {
+  char magic[4];
+  uint32_t version;
+  uint64_t key;
+  uint32_t num_entries;
+  uint32_t entry_len;
+};
+
+/** One request and the answer the device negotiated for it */
+struct probe_cache_entry {
+  uint8_t iface;
+  uint8_t request[PROBE_CTRL_LEN];
+  uvc_stream_ctrl_t result;
+};
+
+/** Entries of one device identity */
+struct uvc_probe_cache_dev {
+  struct uvc_probe_cache_dev *prev, *next;
+  uint64_t key;
+  uint16_t vid, pid;
+  struct probe_cache_entry entries[PROBE_CACHE_MAX_ENTRIES];
+  int num_entries;
+};
+
+/* Identity of the device behind @p devh; 0 if it has none (synthetic devices) */
+static uint64_t probe_cache_key(uvc_device_handle_t *devh) {
+  struct libusb_device_descriptor desc;
+  uint64_t key = 0;
+
+  if (devh->probe_key_ready)
+    return devh->probe_key;
+
+  if (devh->dev->usb_dev && devh->info->config &&
+      libusb_get_device_descriptor(devh->dev->usb_dev, &desc) == LIBUSB_SUCCESS) {
+    /* descriptors pin down model and firmware; the bus speed bounds the
+     * payload sizes the device will agree to */
+    key = uvc_desc_cache_key(&desc, devh->info->config);
+    key ^= (uint64_t) (libusb_get_device_speed(devh->dev->usb_dev) + 1) * 0x9e3779b97f4a7c15ULL;
+    if (!key)
+      key = 1;
+  }
+
+  devh->probe_key = key;
+  devh->probe_key_ready = 1;
+
+  return key;
+}
+
+static char *probe_cache_path(const char *dir, const struct uvc_probe_cache_dev *pdev) {
+  size_t len = strlen(dir) + 64;
+  char *path = malloc(len);
+
+  if (path)
+    snprintf(path, len, "%s/%04x-%04x-%016llx.uvcp", dir, pdev->vid, pdev->pid,
+             (unsigned long long) pdev->key);
+
+  return path;
+}
+
+/* Read a device's entries from the cache directory, if it has a file there */
+static void probe_cache_read(const char *dir, struct uvc_probe_cache_dev *pdev) {
+  struct probe_cache_header hdr;
+  uint8_t buf[PROBE_ENTRY_LEN];
+  char *path;
+  FILE *fp;
+  uint32_t i;
+
+  path = probe_cache_path(dir, pdev);
+  if (!path)
+    return;
+
+  fp = fopen(path, "rb");
+  free(path);
+  if (!fp)
+    return;
+
+  if (fread(&hdr, sizeof(hdr), 1, fp) != 1 || memcmp(hdr.magic, probe_cache_magic, 4) ||
+      hdr.version != PROBE_CACHE_VERSION || hdr.key != pdev->key ||
+      hdr.entry_len != PROBE_ENTRY_LEN || hdr.num_entries > PROBE_CACHE_MAX_ENTRIES) {
+    fclose(fp);
+    return;
+  }
+
+  for (i = 0; i < hdr.num_entries && fread(buf, sizeof(buf), 1, fp) == 1; ++i) {
+    struct probe_cache_entry *entry = &pdev->entries[pdev->num_entries++];
+
+    memset(entry, 0, sizeof(*entry));
+    entry->iface = buf[0];
+    memcpy(entry->request, buf + 1, PROBE_CTRL_LEN);
+    uvc_stream_ctrl_unpack(&entry->result, buf + 1 + PROBE_CTRL_LEN, PROBE_CTRL_LEN);
+    entry->result.bInterfaceNumber = entry->iface;
+  }
+
+  fclose(fp);
+}
+
+/* Replace a device's file with its current entries */
+static void probe_cache_write(const char *dir, const struct uvc_probe_cache_dev *pdev) {
+  struct probe_cache_header hdr;
+  uint8_t buf[PROBE_ENTRY_LEN];
+  char *path, *tmp_path;
+  int i, ok;
+  FILE *fp;
+
+  path = probe_cache_path(dir, pdev);
+  tmp_path = path ? malloc(strlen(path) + 32) : NULL;
+  if (!tmp_path) {
+    free(path);
+    return;
+  }
+  sprintf(tmp_path, "%s.%ld.tmp", path, (long) getpid());
+
+  memset(&hdr, 0, sizeof(hdr));
+  memcpy(hdr.magic, probe_cache_magic, 4);
+  hdr.version = PROBE_CACHE_VERSION;
+  hdr.key = pdev->key;
+  hdr.num_entries = pdev->num_entries;
+  hdr.entry_len = PROBE_ENTRY_LEN;
+
+  fp = fopen(tmp_path, "wb");
+  if (fp) {
+    ok = fwrite(&hdr, sizeof(hdr), 1, fp) == 1;
+    for (i = 0; ok && i < pdev->num_entries; ++i) {
+      buf[0] = pdev->entries[i].iface;
+      memcpy(buf + 1, pdev->entries[i].request, PROBE_CTRL_LEN);
+      uvc_stream_ctrl_pack(&pdev->entries[i].result, buf + 1 + PROBE_CTRL_LEN);
+      ok = fwrite(buf, sizeof(buf), 1, fp) == 1;
+    }
+    if (fclose(fp))
+      ok = 0;
+    if (!ok || rename(tmp_path, path)) {
+      UVC_DEBUG("could not save negotiated parameters in %s", dir);
+      unlink(tmp_path);
+    }
+  }
+
+  free(tmp_path);
+  free(path);
+}
+
+/* Entries of the device behind @p devh, loaded from disk on first use.
+ * Called with probe_cache_mutex held. */
+static struct uvc_probe_cache_dev *probe_cache_dev(uvc_device_handle_t *devh, int create) {
+  uvc_context_t *ctx = devh->dev->ctx;
+  struct libusb_device_descriptor desc;
+  struct uvc_probe_cache_dev *pdev;
+  uint64_t key = probe_cache_key(devh);
+
+  if (!key)
+    return NULL;
+
+  DL_FOREACH(ctx->probe_cache, pdev) {
+    if (pdev->key == key)
+      return pdev;
+  }
+
+  if (!create || libusb_get_device_descriptor(devh->dev->usb_dev, &desc) != LIBUSB_SUCCESS)
+    return NULL;
+
+  pdev = calloc(1, sizeof(*pdev));
+  if (!pdev)
+    return NULL;
+
+  pdev->key = key;
+  pdev->vid = desc.idVendor;
+  pdev->pid = desc.idProduct;
+  if (ctx->probe_cache_dir)
+    probe_cache_read(ctx->probe_cache_dir, pdev);
+  DL_APPEND(ctx->probe_cache, pdev);
+
+  return pdev;
+}
+
+static struct probe_cache_entry *probe_cache_find(struct uvc_probe_cache_dev *pdev,
+                                                  const uvc_stream_ctrl_t *request) {
+  uint8_t packed[PROBE_CTRL_LEN];
+  int i;
+
+  uvc_stream_ctrl_pack(request, packed);
+
+  for (i = 0; i < pdev->num_entries; ++i) {
+    if (pdev->entries[i].iface == request->bInterfaceNumber &&
+        !memcmp(pdev->entries[i].request, packed, PROBE_CTRL_LEN))
+      return &pdev->entries[i];
+  }
+
+  return NULL;
+}
+
+/** @internal
+ * @brief Answer a probe from the cache
+ *
+ * On a hit, @p ctrl is replaced with the negotiated parameters and the
+ * device handle remembers that they still have to be checked on commit.
+ *
+ * @return UVC_SUCCESS, or UVC_ERROR_NOT_FOUND if the probe has to go to the device
+ */
+uvc_error_t uvc_probe_cache_lookup(uvc_device_handle_t *devh, uvc_stream_ctrl_t *ctrl) {
+  uvc_context_t *ctx = devh->dev->ctx;
+  struct uvc_probe_cache_dev *pdev;
+  struct probe_cache_entry *entry = NULL;
+
+  if (!ctx->probe_cache_enabled || (devh->quirks.flags & UVC_QUIRK_PROBE_NO_CACHE))
+    return UVC_ERROR_NOT_FOUND;
+
+  pthread_mutex_lock(&ctx->probe_cache_mutex);
+  pdev = probe_cache_dev(devh, 1);
+  if (pdev)
+    entry = probe_cache_find(pdev, ctrl);
+  if (entry) {
+    devh->probe_request = *ctrl;
+    devh->probe_result = entry->result;
+    devh->probe_pending = 1;
+    *ctrl = entry->result;
+  }
+  pthread_mutex_unlock(&ctx->probe_cache_mutex);
+
+  if (!entry)
+    return UVC_ERROR_NOT_FOUND;
+
+  UVC_DEBUG("probe of format %d frame %d answered from cache",
+            ctrl->bFormatIndex, ctrl->bFrameIndex);
+
+  return UVC_SUCCESS;
+}
+
+/** @internal
+ * @brief Remember what the device negotiated for a probe request
+ */
+void uvc_probe_cache_store(uvc_device_handle_t *devh, const uvc_stream_ctrl_t *request,
+                           const uvc_stream_ctrl_t *result) {
+  uvc_context_t *ctx = devh->dev->ctx;
+  struct uvc_probe_cache_dev *pdev;
+  struct probe_cache_entry *entry;
+
+  if (!ctx->probe_cache_enabled || (devh->quirks.flags & UVC_QUIRK_PROBE_NO_CACHE))
+    return;
+
+  pthread_mutex_lock(&ctx->probe_cache_mutex);
+
+  pdev = probe_cache_dev(devh, 1);
+  if (!pdev) {
+    pthread_mutex_unlock(&ctx->probe_cache_mutex);
+    return;
+  }
+
+  entry = probe_cache_find(pdev, request);
+  if (!entry) {
+    if (pdev->num_entries == PROBE_CACHE_MAX_ENTRIES) {
+      memmove(&pdev->entries[0], &pdev->entries[1],
+              (PROBE_CACHE_MAX_ENTRIES - 1) * sizeof(pdev->entries[0]));
+      pdev->num_entries--;
+    }
+    entry = &pdev->entries[pdev->num_entries++];
+    entry->iface = request->bInterfaceNumber;
+    uvc_stream_ctrl_pack(request, entry->request);
+  }
+  entry->result = *result;
+
+  if (ctx->probe_cache_dir)
+    probe_cache_write(ctx->probe_cache_dir, pdev);
+
+  pthread_mutex_unlock(&ctx->probe_cache_mutex);
+}
+
+/* Forget the answer to a request the device no longer agrees with */
+static void probe_cache_drop(uvc_device_handle_t *devh, const uvc_stream_ctrl_t *request) {
+  uvc_context_t *ctx = devh->dev->ctx;
+  struct uvc_probe_cache_dev *pdev;
+  struct probe_cache_entry *entry = NULL;
+
+  pthread_mutex_lock(&ctx->probe_cache_mutex);
+  pdev = probe_cache_dev(devh, 0);
+  if (pdev)
+    entry = probe_cache_find(pdev, request);
+  if (entry) {
+    memmove(entry, entry + 1, (&pdev->entries[--pdev->num_entries] - entry) * sizeof(*entry));
+    if (ctx->probe_cache_dir)
+      probe_cache_write(ctx->probe_cache_dir, pdev);
+  }
+  pthread_mutex_unlock(&ctx->probe_cache_mutex);
+}
+
+/* Whether the committed parameters read back match what was committed */
+static int probe_cache_agrees(const uvc_stream_ctrl_t *committed, const uvc_stream_ctrl_t *cur) {
+  return committed->bFormatIndex == cur->bFormatIndex &&
+         committed->bFrameIndex == cur->bFrameIndex &&
+         committed->dwFrameInterval == cur->dwFrameInterval &&
+         committed->dwMaxVideoFrameSize == cur->dwMaxVideoFrameSize &&
+         committed->dwMaxPayloadTransferSize == cur->dwMaxPayloadTransferSize;
+}
+
+/** @internal
+ * @brief Commit negotiated streaming parameters
+ *
+ * Parameters that came from the cache rather than from a probe are read
+ * back with GET_CUR after the commit. If the device disagrees or refuses
+ * the commit, the entry is dropped and the original request is probed and
+ * committed again; @p ctrl then holds what the device negotiated.
+ */
+uvc_error_t uvc_probe_cache_commit(uvc_device_handle_t *devh, uvc_stream_ctrl_t *ctrl) {
+  uint8_t a[PROBE_CTRL_LEN], b[PROBE_CTRL_LEN];
+  uvc_stream_ctrl_t cur;
+  uvc_error_t ret;
+  int from_cache = 0;
+
+  if (devh->probe_pending) {
+    uvc_stream_ctrl_pack(ctrl, a);
+    uvc_stream_ctrl_pack(&devh->probe_result, b);
+    from_cache = devh->probe_result.bInterfaceNumber == ctrl->bInterfaceNumber &&
+                 !memcmp(a, b, PROBE_CTRL_LEN);
+    devh->probe_pending = 0;
+  }
+
+  ret = uvc_query_stream_ctrl(devh, ctrl, 0, UVC_SET_CUR);
+  if (!from_cache)
+    return ret;
+
+  if (ret == UVC_SUCCESS) {
+    cur = *ctrl;
+    ret = uvc_query_stream_ctrl(devh, &cur, 0, UVC_GET_CUR);
+    if (ret == UVC_SUCCESS && probe_cache_agrees(ctrl, &cur))
+      return UVC_SUCCESS;
+  }
+
+  UVC_DEBUG("device disagrees with cached parameters for format %d frame %d, probing",
+            ctrl->bFormatIndex, ctrl->bFrameIndex);
+  probe_cache_drop(devh, &devh->probe_request);
+
+  *ctrl = devh->probe_request;
+  ret = uvc_probe_stream_ctrl(devh, ctrl);
+  if (ret == UVC_SUCCESS)
+    ret = uvc_query_stream_ctrl(devh, ctrl, 0, UVC_SET_CUR);
+
+  return ret;
+}
+
+/** @internal
+ * @brief Drop the context's cached parameters
+ */
+void uvc_probe_cache_free(uvc_context_t *ctx) {
+  struct uvc_probe_cache_dev *pdev, *tmp;
+
+  pthread_mutex_lock(&ctx->probe_cache_mutex);
+  DL_FOREACH_SAFE(ctx->probe_cache, pdev, tmp) {
+    DL_DELETE(ctx->probe_cache, pdev);
+    free(pdev);
+  }
+  pthread_mutex_unlock(&ctx->probe_cache_mutex);
+}
+
+/** @brief Configure the cache of negotiated streaming parameters
+ * @ingroup streaming
+ *
+ * uvc_probe_stream_ctrl() remembers what a device negotiated for each
+ * request and answers the same request from memory next time, keyed by the
+ * device's descriptors and bus speed. Answers from the cache are checked
+ * with one GET_CUR when they are committed and probed afresh if the device
+ * disagrees. The cache is enabled by default and kept in memory only.
+ *
+ * With a directory, entries are also saved there and read back by later
+ * processes. The directory must exist and be writable for entries to be
+ * saved. Configure the cache before opening devices.
+ *
+ * @param ctx UVC context
+ * @param enabled Whether to cache negotiated parameters
+ * @param dir Directory to keep them in across processes, or NULL
+ */
+uvc_error_t uvc_set_probe_cache(uvc_context_t *ctx, int enabled, const char *dir) {
+  char *copy = NULL;
+
+  if (dir) {
+    copy = strdup(dir);
+    if (!copy)
+      return UVC_ERROR_NO_MEM;
+  }
+
+  /* entries read from the old directory would be written to the new one */
+  uvc_probe_cache_free(ctx);
+
+  pthread_mutex_lock(&ctx->probe_cache_mutex);
+  ctx->probe_cache_enabled = enabled ? 1 : 0;
+  free(ctx->probe_cache_dir);
+  ctx->probe_cache_dir = copy;
+  pthread_mutex_unlock(&ctx->probe_cache_mutex);
+
+  return UVC_SUCCESS;
+}
@@ -0,0 +1,395 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (C) 2010-2012 Ken Tossell
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the author nor other contributors may be
+*     used to endorse or promote products derived from this software
+*     without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+/**
+ * @defgroup quirks Device quirks
+ * @brief Workarounds and streaming parameters for particular devices
+ *
+ * Each entry covers a vendor ID with ranges of product IDs and bcdDevice
+ * revisions, and records how those devices depart from the specification
+ * (enum uvc_quirk_flag) and how their streams should be set up: transfers
+ * in flight, packets per isochronous transfer, bulk transfer size, and a
+ * dwMaxVideoFrameSize they are known to get wrong.
+ *
+ * The table below is compiled into the library. uvc_load_quirks() reads
+ * further entries from a file; those are checked first, so a file can
+ * override a built-in entry as well as add new ones. The entry that
+ * applies to a device is copied into its handle at uvc_open() and used
+ * when streams are negotiated and started.
+ *
+ * A quirks file has one entry per line; '#' starts a comment:
+ *
+ *     # vendor:product[-last] [bcd=first-last] [flag ...] [key=value ...]
+ *     05ac:8501 header-isight header-length
+ *     1234:5678-567a bcd=0100-01ff transfers=32 packets=8 fix-bandwidth
+ *     abcd:0001 bulk-size=65536 bad-frame-size=0x96000
+ *
+ * Flags are not-uvc, vendor-class, header-isight, header-length,
+ * header-reserved, probe-short, fix-bandwidth and probe-no-cache (see enum
+ * uvc_quirk_flag). Keys are transfers, packets, bulk-size and
+ * bad-frame-size, which also accepts "any".
+ */
+#include "libuvc/libuvc.h"
+#include "libuvc/libuvc_internal.h"
+
+#include <ctype.h>
+
+uvc_frame_desc_t *uvc_find_frame_desc(uvc_device_handle_t *devh,
+    uint16_t format_id, uint16_t frame_id);
+
+/* Transfers a stream keeps in flight unless its entry says otherwise */
+#ifdef LIBUVC_NUM_TRANSFER_BUFS
+#define QUIRKS_DEFAULT_TRANSFERS LIBUVC_NUM_TRANSFER_BUFS
+#elif defined(__APPLE__) && defined(__MACH__)
+#define QUIRKS_DEFAULT_TRANSFERS 20
+#else
+#define QUIRKS_DEFAULT_TRANSFERS 100
+#endif
+
+static const uvc_quirks_t uvc_builtin_quirks[] = {
+  /* The Imaging Source: look like UVC, but aren't */
+  { .idVendor = 0x199e, .idProduct_min = 0x8201, .idProduct_max = 0x8208,
+    .bcdDevice_min = 0x0000, .bcdDevice_max = 0xffff,
+    .flags = UVC_QUIRK_NOT_UVC },
+  /* The Imaging Source: UVC in vendor-specific interfaces */
+  { .idVendor = 0x199e, .idProduct_min = 0x8101, .idProduct_max = 0x8102,
+    .bcdDevice_min = 0x0000, .bcdDevice_max = 0xffff,
+    .flags = UVC_QUIRK_VENDOR_CLASS },
+  /* Apple built-in iSight: one tagged header per frame */
+  { .idVendor = 0x05ac, .idProduct_min = 0x8501, .idProduct_max = 0x8501,
+    .bcdDevice_min = 0x0000, .bcdDevice_max = 0xffff,
+    .flags = UVC_QUIRK_HEADER_ISIGHT | UVC_QUIRK_HEADER_LENGTH },
+};
+
+static const struct {
+  const char *name;
+  uint32_t flag;
+} quirk_names[] = {
+  { "not-uvc", UVC_QUIRK_NOT_UVC },
+  { "vendor-class", UVC_QUIRK_VENDOR_CLASS },
+  { "header-isight", UVC_QUIRK_HEADER_ISIGHT },
+  { "header-length", UVC_QUIRK_HEADER_LENGTH },
+  { "header-reserved", UVC_QUIRK_HEADER_RESERVED },
+  { "probe-short", UVC_QUIRK_PROBE_SHORT },
+  { "fix-bandwidth", UVC_QUIRK_FIX_BANDWIDTH },
+  { "probe-no-cache", UVC_QUIRK_PROBE_NO_CACHE },
+};
+
+static int quirks_match(const uvc_quirks_t *q, uint16_t vid, uint16_t pid, int bcd) {
+  return q->idVendor == vid && pid >= q->idProduct_min && pid <= q->idProduct_max &&
+         (bcd < 0 || (bcd >= q->bcdDevice_min && bcd <= q->bcdDevice_max));
+}
+
+/** @internal
+ * @brief Find the quirks entry for a device
+ *
+ * Entries loaded with uvc_load_quirks() are checked before the built-in
+ * ones; the first match wins. Devices without an entry get an all-default
+ * one. Either way, the number of transfers is filled in.
+ *
+ * @param ctx UVC context, or NULL to check the built-in table only
+ * @param bcd bcdDevice, or -1 to match any revision
+ * @param[out] quirks Copy of the entry
+ */
+void uvc_quirks_lookup(uvc_context_t *ctx, uint16_t vid, uint16_t pid, int bcd,
+                       uvc_quirks_t *quirks) {
+  int found = 0;
+  size_t i;
+
+  memset(quirks, 0, sizeof(*quirks));
+
+  if (ctx) {
+    pthread_mutex_lock(&ctx->quirks_mutex);
+    for (i = 0; !found && i < (size_t) ctx->num_quirks; ++i) {
+      if (quirks_match(&ctx->quirks[i], vid, pid, bcd)) {
+        *quirks = ctx->quirks[i];
+        found = 1;
+      }
+    }
+    pthread_mutex_unlock(&ctx->quirks_mutex);
+  }
+
+  for (i = 0; !found && i < sizeof(uvc_builtin_quirks) / sizeof(uvc_builtin_quirks[0]); ++i) {
+    if (quirks_match(&uvc_builtin_quirks[i], vid, pid, bcd)) {
+      *quirks = uvc_builtin_quirks[i];
+      found = 1;
+    }
+  }
+
+  if (!quirks->num_transfers)
+    quirks->num_transfers = QUIRKS_DEFAULT_TRANSFERS;
+  if (quirks->num_transfers > LIBUVC_MAX_TRANSFER_BUFS)
+    quirks->num_transfers = LIBUVC_MAX_TRANSFER_BUFS;
+}
+
+/** @internal
+ * @brief Correct what a device answered to a probe, as its quirks say
+ *
+ * Called after every GET on the probe or commit control.
+ */
+void uvc_quirks_fix_stream_ctrl(uvc_device_handle_t *devh, uvc_stream_ctrl_t *ctrl) {
+  const uvc_quirks_t *quirks = &devh->quirks;
+  uvc_frame_desc_t *frame;
+  uvc_format_desc_t *format;
+  int uncompressed;
+
+  if (!quirks->bad_frame_size && !(quirks->flags & UVC_QUIRK_FIX_BANDWIDTH))
+    return;
+
+  frame = uvc_find_frame_desc(devh, ctrl->bFormatIndex, ctrl->bFrameIndex);
+  if (!frame)
+    return;
+  format = frame->parent;
+  uncompressed = format->bDescriptorSubtype == UVC_VS_FORMAT_UNCOMPRESSED;
+
+  if (quirks->bad_frame_size && (quirks->bad_frame_size == 0xffffffff ||
+                                 ctrl->dwMaxVideoFrameSize == quirks->bad_frame_size)) {
+    uint32_t size = uncompressed
+      ? (uint32_t) frame->wWidth * frame->wHeight * format->bBitsPerPixel / 8
+      : frame->dwMaxVideoFrameBufferSize;
+
+    if (size) {
+      UVC_DEBUG("replacing dwMaxVideoFrameSize %u with %u", ctrl->dwMaxVideoFrameSize, size);
+      ctrl->dwMaxVideoFrameSize = size;
+    }
+  }
+
+  /* Only isochronous interfaces have altsettings to choose by bandwidth */
+  if ((quirks->flags & UVC_QUIRK_FIX_BANDWIDTH) && uncompressed &&
+      devh->info->config && ctrl->bInterfaceNumber < devh->info->config->bNumInterfaces &&
+      devh->info->config->interface[ctrl->bInterfaceNumber].num_altsetting > 1) {
+    uint32_t interval = ctrl->dwFrameInterval > 100000
+      ? ctrl->dwFrameInterval : frame->dwDefaultFrameInterval;
+    uint64_t bandwidth;
+
+    if (!interval)
+      return;
+
+    /* Frame size times frames per second, divided by the number of USB
+     * frames (or microframes) per second, plus a 12-byte header */
+    bandwidth = (uint64_t) frame->wWidth * frame->wHeight / 8 * format->bBitsPerPixel;
+    bandwidth *= 10000000 / interval + 1;
+    bandwidth /= 1000;
+    if (libusb_get_device_speed(devh->dev->usb_dev) >= LIBUSB_SPEED_HIGH)
+      bandwidth /= 8;
+    bandwidth += 12;
+    if (bandwidth < 1024)
+      bandwidth = 1024;
+
+    if (bandwidth < ctrl->dwMaxPayloadTransferSize) {
+      UVC_DEBUG("replacing dwMaxPayloadTransferSize %u with %u",
+                ctrl->dwMaxPayloadTransferSize, (uint32_t) bandwidth);
+      ctrl->dwMaxPayloadTransferSize = (uint32_t) bandwidth;
+    }
+  }
+}
+
+static int quirks_parse_number(const char *s, uint32_t max, uint32_t *value) {
+  char *end;
+  unsigned long v;
+
+  if (!isdigit((unsigned char) *s))
+    return -1;
+
+  v = strtoul(s, &end, 0);
+  if (*end || v > max)
+    return -1;
+
+  *value = (uint32_t) v;
+  return 0;
+}
+
+/* Parses "first[-last]" of hex numbers */
+static int quirks_parse_range(const char *s, uint16_t *first, uint16_t *last) {
+  unsigned int a, b;
+  int n;
+
+  if (sscanf(s, "%4x%n", &a, &n) != 1)
+    return -1;
+  b = a;
+  if (s[n] == '-') {
+    s += n + 1;
+    if (sscanf(s, "%4x%n", &b, &n) != 1 || b < a)
+      return -1;
+  }
+  if (s[n])
+    return -1;
+
+  *first = (uint16_t) a;
+  *last = (uint16_t) b;
+  return 0;
+}
+
+static int quirks_parse_line(char *line, uvc_quirks_t *q) {
+  char *tok, *save = NULL;
+  unsigned int vid;
+  int n;
+
+  memset(q, 0, sizeof(*q));
+  q->bcdDevice_max = 0xffff;
+
+  tok = strtok_r(line, " \t", &save);
+  if (sscanf(tok, "%4x%n", &vid, &n) != 1 || tok[n] != ':' ||
+      quirks_parse_range(tok + n + 1, &q->idProduct_min, &q->idProduct_max))
+    return -1;
+  q->idVendor = (uint16_t) vid;
+
+  while ((tok = strtok_r(NULL, " \t", &save)) != NULL) {
+    char *value = strchr(tok, '=');
+    uint32_t v;
+    size_t i;
+
+    if (!value) {
+      for (i = 0; i < sizeof(quirk_names) / sizeof(quirk_names[0]); ++i) {
+        if (!strcmp(tok, quirk_names[i].name))
+          break;
+      }
+      if (i == sizeof(quirk_names) / sizeof(quirk_names[0]))
+        return -1;
+      q->flags |= quirk_names[i].flag;
+      continue;
+    }
+
+    *value++ = '\0';
+    if (!strcmp(tok, "bcd")) {
+      if (quirks_parse_range(value, &q->bcdDevice_min, &q->bcdDevice_max))
+        return -1;
+    } else if (!strcmp(tok, "transfers")) {
+      if (quirks_parse_number(value, LIBUVC_MAX_TRANSFER_BUFS, &v))
+        return -1;
+      q->num_transfers = (uint16_t) v;
+    } else if (!strcmp(tok, "packets")) {
+      if (quirks_parse_number(value, 0xffff, &v))
+        return -1;
+      q->packets_per_transfer = (uint16_t) v;
+    } else if (!strcmp(tok, "bulk-size")) {
+      if (quirks_parse_number(value, 0xffffffff, &q->bulk_transfer_size))
+        return -1;
+    } else if (!strcmp(tok, "bad-frame-size")) {
+      if (!strcmp(value, "any"))
+        q->bad_frame_size = 0xffffffff;
+      else if (quirks_parse_number(value, 0xffffffff, &q->bad_frame_size))
+        return -1;
+    } else {
+      return -1;
+    }
+  }
+
+  return 0;
+}
+
+/** @brief Load device quirks from a file
+ * @ingroup quirks
+ *
+ * The entries replace those of any earlier call and take precedence over
+ * the built-in table. They apply to devices opened afterwards.
+ *
+ * @param ctx UVC context
+ * @param path Quirks file (see @ref quirks), or NULL to drop the loaded entries
+ * @return UVC_ERROR_INVALID_PARAM if a line could not be parsed, in which
+ *   case the previous entries are kept
+ */
+uvc_error_t uvc_load_quirks(uvc_context_t *ctx, const char *path) {
+  uvc_quirks_t *quirks = NULL, *grown;
+  int num_quirks = 0, line_no = 0;
+  char line[512];
+  FILE *fp = NULL;
+  uvc_error_t ret = UVC_SUCCESS;
+
+  UVC_ENTER();
+
+  if (path) {
+    fp = fopen(path, "r");
+    if (!fp) {
+      UVC_EXIT(UVC_ERROR_NOT_FOUND);
+      return UVC_ERROR_NOT_FOUND;
+    }
+  }
+
+  while (fp && fgets(line, sizeof(line), fp)) {
+    char *p = strchr(line, '#');
+
+    line_no++;
+    if (p)
+      *p = '\0';
+    for (p = line; isspace((unsigned char) *p); ++p)
+      ;
+    if (!*p)
+      continue;
+    p[strcspn(p, "\r\n")] = '\0';
+
+    grown = realloc(quirks, (num_quirks + 1) * sizeof(*quirks));
+    if (!grown) {
+      ret = UVC_ERROR_NO_MEM;
+      break;
+    }
+    quirks = grown;
+
+    if (quirks_parse_line(p, &quirks[num_quirks])) {
+      UVC_DEBUG("%s:%d: bad quirks entry", path, line_no);
+      ret = UVC_ERROR_INVALID_PARAM;
+      break;
+    }
+    num_quirks++;
+  }
+
+  if (fp)
+    fclose(fp);
+
+  if (ret != UVC_SUCCESS) {
+    free(quirks);
+    UVC_EXIT(ret);
+    return ret;
+  }
+
+  pthread_mutex_lock(&ctx->quirks_mutex);
+  grown = ctx->quirks;
+  ctx->quirks = quirks;
+  ctx->num_quirks = num_quirks;
+  pthread_mutex_unlock(&ctx->quirks_mutex);
+
+  free(grown);
+
+  UVC_EXIT(UVC_SUCCESS);
+  return UVC_SUCCESS;
+}
+
+/** @brief Get the quirks entry an open device was matched with
+ * @ingroup quirks
+ *
+ * @return The entry, valid until uvc_close(); an all-default entry if the
+ *   device has none
+ */
+const uvc_quirks_t *uvc_get_quirks(uvc_device_handle_t *devh) {
+  return &devh->quirks;
+}
@@ -0,0 +1,232 @@
+/* uvc-replay: push a recorded VideoStreaming capture through the payload
+ * parser offline.
+ *
+ * Reads a replay file (see replay.c; produce one from a usbmon capture with
+ * uvc-usbmon-import), hands every transfer to _uvc_process_payload() on a
+ * synthetic stream of the given mode, and reports how many frames were
+ * assembled, which of them carried payload header errors, and how fast the
+ * parser got through the data. Optionally writes each assembled frame to a
+ * directory for inspection.
+ */
+#include "libuvc/libuvc.h"
+#include "libuvc/libuvc_internal.h"
+#include "tools-common.h"
+
+#include <getopt.h>
+
+struct replay_state {
+  const char *dump_dir;
+  size_t expected_bytes;
+
+  uint32_t last_seq;
+  int frame_bad;
+
+  uint64_t frames;
+  uint64_t bad_frames;
+  uint64_t short_frames;
+  uint64_t errors;
+  uint64_t error_counts[TOOL_PAYLOAD_ERROR_SLOTS];
+  uint64_t dumped;
+};
+
+static void dump_frame(struct replay_state *st, uvc_stream_handle_t *strmh) {
+  char path[4096];
+  FILE *fp;
+
+  snprintf(path, sizeof(path), "%s/frame_%06llu.raw", st->dump_dir,
+           (unsigned long long) st->frames);
+  fp = fopen(path, "wb");
+  if (!fp) {
+    perror(path);
+    st->dump_dir = NULL;
+    return;
+  }
+  if (strmh->hold_bytes)
+    fwrite(strmh->holdbuf, strmh->hold_bytes, 1, fp);
+  fclose(fp);
+  st->dumped++;
+}
+
+/* Runs after every payload. Errors are attributed to the frame in progress;
+ * a change of strmh->seq means a frame was handed over to holdbuf. */
+static void replay_payload_cb(uvc_stream_handle_t *strmh, void *ptr) {
+  struct replay_state *st = ptr;
+
+  if (strmh->frame.error_code != PAYLOAD_ERROR_NONE) {
+    st->errors++;
+    st->error_counts[tool_payload_error_slot(strmh->frame.error_code)]++;
+    strmh->frame.error_code = PAYLOAD_ERROR_NONE;
+    st->frame_bad = 1;
+  }
+
+  if (strmh->seq == st->last_seq)
+    return;
+
+  st->last_seq = strmh->seq;
+  st->frames++;
+  if (st->frame_bad)
+    st->bad_frames++;
+  if (st->expected_bytes && strmh->hold_bytes != st->expected_bytes)
+    st->short_frames++;
+  if (st->dump_dir)
+    dump_frame(st, strmh);
+  st->frame_bad = 0;
+}
+
+static void usage(const char *argv0) {
+  fprintf(stderr,
+          "Usage: %s [options] CAPTURE.uvcr\n"
+          "  -f, --format NAME    yuyv, uyvy, nv12, gray8, bgr, mjpeg (default mjpeg)\n"
+          "  -s, --size WxH       frame size (default 1280x720)\n"
+          "  -m, --max-frame N    dwMaxVideoFrameSize to assume, if the device's was larger\n"
+          "  -o, --dump DIR       write each assembled frame to DIR/frame_NNNNNN.raw\n",
+          argv0);
+}
+
+int main(int argc, char **argv) {
+  static const struct option long_options[] = {
+    { "format", required_argument, NULL, 'f' },
+    { "size", required_argument, NULL, 's' },
+    { "max-frame", required_argument, NULL, 'm' },
+    { "dump", required_argument, NULL, 'o' },
+    { "help", no_argument, NULL, 'h' },
+    { NULL, 0, NULL, 0 }
+  };
+  enum uvc_frame_format format = UVC_FRAME_FORMAT_MJPEG;
+  int width = 1280, height = 720;
+  unsigned long max_frame = 0;
+  struct replay_state st;
+  uvc_replay_header_t hdr;
+  uvc_replay_record_t rec;
+  uvc_context_t *ctx;
+  uvc_device_handle_t *devh;
+  uvc_stream_handle_t *strmh;
+  uint64_t records = 0, skipped = 0, payloads = 0, bytes = 0;
+  uint64_t first_ts = 0, last_ts = 0;
+  double start, elapsed;
+  uvc_error_t res;
+  FILE *fp;
+  int opt, i;
+
+  memset(&st, 0, sizeof(st));
+  memset(&rec, 0, sizeof(rec));
+
+  while ((opt = getopt_long(argc, argv, "f:s:m:o:h", long_options, NULL)) != -1) {
+    switch (opt) {
+    case 'f':
+      if (tool_parse_format(optarg, &format) || format == UVC_FRAME_FORMAT_ANY ||
+          format == UVC_FRAME_FORMAT_H264) {
+        fprintf(stderr, "unknown format '%s'\n", optarg);
+        return 1;
+      }
+      break;
+    case 's':
+      if (tool_parse_size(optarg, &width, &height)) {
+        fprintf(stderr, "bad size '%s'\n", optarg);
+        return 1;
+      }
+      break;
+    case 'm':
+      max_frame = strtoul(optarg, NULL, 0);
+      break;
+    case 'o':
+      st.dump_dir = optarg;
+      break;
+    default:
+      usage(argv[0]);
+      return opt == 'h' ? 0 : 1;
+    }
+  }
+
+  if (optind + 1 != argc) {
+    usage(argv[0]);
+    return 1;
+  }
+
+  fp = fopen(argv[optind], "rb");
+  if (!fp) {
+    perror(argv[optind]);
+    return 1;
+  }
+
+  res = uvc_replay_read_header(fp, &hdr);
+  if (res != UVC_SUCCESS) {
+    fprintf(stderr, "%s: not a replay file\n", argv[optind]);
+    fclose(fp);
+    return 1;
+  }
+
+  res = uvc_init(&ctx, NULL);
+  if (res < 0) {
+    uvc_perror(res, "uvc_init");
+    fclose(fp);
+    return 1;
+  }
+
+  /* interval 0: frames come from the file, not a producer thread */
+  res = uvc_synthetic_open(ctx, format, width, height, 0, &devh);
+  if (res == UVC_SUCCESS && max_frame)
+    res = uvc_synthetic_set_max_frame_size(devh, (uint32_t) max_frame);
+  if (res == UVC_SUCCESS)
+    res = uvc_synthetic_stream_start(devh, &strmh, NULL, NULL, 0);
+  if (res != UVC_SUCCESS) {
+    uvc_perror(res, "synthetic stream");
+    uvc_exit(ctx);
+    fclose(fp);
+    return 1;
+  }
+
+  if (format != UVC_FRAME_FORMAT_MJPEG)
+    st.expected_bytes = strmh->cur_ctrl.dwMaxVideoFrameSize;
+  st.last_seq = strmh->seq;
+
+  start = tool_now();
+  while ((res = uvc_replay_read_record(fp, &rec)) == UVC_SUCCESS) {
+    size_t fed;
+
+    if (records == 0)
+      first_ts = rec.timestamp_us;
+    last_ts = rec.timestamp_us;
+    records++;
+    bytes += rec.data_len;
+
+    fed = uvc_replay_feed(strmh, &rec, replay_payload_cb, &st);
+    payloads += fed;
+    skipped += (rec.type == UVC_REPLAY_BULK ? 1 : rec.num_packets) - fed;
+  }
+  elapsed = tool_now() - start;
+
+  if (res != UVC_ERROR_NOT_FOUND)
+    fprintf(stderr, "%s: truncated or corrupt after %llu records\n", argv[optind],
+            (unsigned long long) records);
+
+  printf("capture:      bus %u device %u endpoint 0x%02x, %.3f s\n",
+         hdr.bus, hdr.device, hdr.endpoint, (last_ts - first_ts) / 1e6);
+  printf("mode:         %s %dx%d, max frame %u bytes\n", tool_format_name(format),
+         width, height, strmh->cur_ctrl.dwMaxVideoFrameSize);
+  printf("transfers:    %llu\n", (unsigned long long) records);
+  printf("payloads:     %llu (%llu failed packets skipped)\n",
+         (unsigned long long) payloads, (unsigned long long) skipped);
+  printf("bytes:        %llu\n", (unsigned long long) bytes);
+  printf("frames:       %llu\n", (unsigned long long) st.frames);
+  printf("bad frames:   %llu\n", (unsigned long long) st.bad_frames);
+  if (st.expected_bytes)
+    printf("short frames: %llu\n", (unsigned long long) st.short_frames);
+  printf("errors:       %llu\n", (unsigned long long) st.errors);
+  for (i = 1; i < TOOL_PAYLOAD_ERROR_SLOTS; ++i) {
+    if (st.error_counts[i])
+      printf("  %-22s %llu\n", tool_payload_error_name(i),
+             (unsigned long long) st.error_counts[i]);
+  }
+  if (st.dumped)
+    printf("dumped:       %llu frames\n", (unsigned long long) st.dumped);
+  printf("parse time:   %.3f s (%.0f payloads/s)\n", elapsed,
+         elapsed > 0 ? payloads / elapsed : 0.0);
+
+  uvc_replay_free_record(&rec);
+  uvc_synthetic_close(devh);
+  uvc_exit(ctx);
+  fclose(fp);
+
+  return res == UVC_ERROR_NOT_FOUND ? 0 : 2;
+}
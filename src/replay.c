@@ -0,0 +1,246 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (C) 2010-2012 Ken Tossell
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the author nor other contributors may be
+*     used to endorse or promote products derived from this software
+*     without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+/**
+ * @internal
+ * @file replay.c
+ * @brief Recorded VideoStreaming transfers, for offline replay.
+ *
+ * A replay file holds the completed IN transfers of one VideoStreaming
+ * endpoint, with per-packet status and lengths for isochronous transfers.
+ * All integers are little-endian.
+ *
+ *   file header (16 bytes):
+ *     char[4] magic "UVCR", u16 version (1), u8 bus, u8 device,
+ *     u8 endpoint, u8 reserved[7]
+ *   record, repeated:
+ *     u8 type (0 isochronous, 1 bulk), u8 reserved[3],
+ *     i32 status (URB status as captured, 0 on success),
+ *     u64 timestamp in microseconds,
+ *     u32 number of iso packets (0 for bulk), u32 data length,
+ *     packets[n] { i32 status, u32 length },
+ *     data: the packets' payloads back to back (or the bulk payload)
+ *
+ * uvc_replay_feed() hands a record to a stream the same way
+ * _uvc_stream_callback() hands a completed libusb transfer to it.
+ */
+#include "libuvc/libuvc.h"
+#include "libuvc/libuvc_internal.h"
+
+static const char uvc_replay_magic[4] = { 'U', 'V', 'C', 'R' };
+
+static void put_le(uint8_t *p, uint64_t v, int bytes) {
+  int i;
+
+  for (i = 0; i < bytes; ++i)
+    p[i] = (uint8_t) (v >> (8 * i));
+}
+
+static uint64_t get_le(const uint8_t *p, int bytes) {
+  uint64_t v = 0;
+  int i;
+
+  for (i = bytes - 1; i >= 0; --i)
+    v = (v << 8) | p[i];
+
+  return v;
+}
+
+/** @internal
+ * @brief Write the file header
+ */
+uvc_error_t uvc_replay_write_header(FILE *fp, const uvc_replay_header_t *hdr) {
+  uint8_t buf[UVC_REPLAY_HEADER_SIZE];
+
+  memset(buf, 0, sizeof(buf));
+  memcpy(buf, uvc_replay_magic, 4);
+  put_le(buf + 4, UVC_REPLAY_VERSION, 2);
+  buf[6] = hdr->bus;
+  buf[7] = hdr->device;
+  buf[8] = hdr->endpoint;
+
+  return fwrite(buf, sizeof(buf), 1, fp) == 1 ? UVC_SUCCESS : UVC_ERROR_IO;
+}
+
+/** @internal
+ * @brief Read and check the file header
+ */
+uvc_error_t uvc_replay_read_header(FILE *fp, uvc_replay_header_t *hdr) {
+  uint8_t buf[UVC_REPLAY_HEADER_SIZE];
+
+  if (fread(buf, sizeof(buf), 1, fp) != 1)
+    return UVC_ERROR_IO;
+
+  if (memcmp(buf, uvc_replay_magic, 4) || get_le(buf + 4, 2) != UVC_REPLAY_VERSION)
+    return UVC_ERROR_NOT_SUPPORTED;
+
+  hdr->bus = buf[6];
+  hdr->device = buf[7];
+  hdr->endpoint = buf[8];
+
+  return UVC_SUCCESS;
+}
+
+/** @internal
+ * @brief Append one transfer to a replay file
+ */
+uvc_error_t uvc_replay_write_record(FILE *fp, const uvc_replay_record_t *rec) {
+  uint8_t buf[24];
+  uint32_t i;
+
+  memset(buf, 0, sizeof(buf));
+  buf[0] = rec->type;
+  put_le(buf + 4, (uint32_t) rec->status, 4);
+  put_le(buf + 8, rec->timestamp_us, 8);
+  put_le(buf + 16, rec->num_packets, 4);
+  put_le(buf + 20, rec->data_len, 4);
+
+  if (fwrite(buf, sizeof(buf), 1, fp) != 1)
+    return UVC_ERROR_IO;
+
+  for (i = 0; i < rec->num_packets; ++i) {
+    put_le(buf, (uint32_t) rec->packets[i].status, 4);
+    put_le(buf + 4, rec->packets[i].length, 4);
+    if (fwrite(buf, 8, 1, fp) != 1)
+      return UVC_ERROR_IO;
+  }
+
+  if (rec->data_len && fwrite(rec->data, rec->data_len, 1, fp) != 1)
+    return UVC_ERROR_IO;
+
+  return UVC_SUCCESS;
+}
+
+/** @internal
+ * @brief Read the next transfer from a replay file
+ *
+ * The record's packet and data buffers are reused between calls; free them
+ * with uvc_replay_free_record() when done.
+ *
+ * @return UVC_SUCCESS, UVC_ERROR_NOT_FOUND at end of file, or an error
+ */
+uvc_error_t uvc_replay_read_record(FILE *fp, uvc_replay_record_t *rec) {
+  uint8_t buf[24];
+  uint32_t i, packet_total = 0;
+
+  if (fread(buf, sizeof(buf), 1, fp) != 1)
+    return feof(fp) ? UVC_ERROR_NOT_FOUND : UVC_ERROR_IO;
+
+  rec->type = buf[0];
+  rec->status = (int32_t) get_le(buf + 4, 4);
+  rec->timestamp_us = get_le(buf + 8, 8);
+  rec->num_packets = (uint32_t) get_le(buf + 16, 4);
+  rec->data_len = (uint32_t) get_le(buf + 20, 4);
+
+  if (rec->num_packets > rec->packets_alloc) {
+    void *p = realloc(rec->packets, rec->num_packets * sizeof(*rec->packets));
+    if (!p)
+      return UVC_ERROR_NO_MEM;
+    rec->packets = p;
+    rec->packets_alloc = rec->num_packets;
+  }
+
+  for (i = 0; i < rec->num_packets; ++i) {
+    if (fread(buf, 8, 1, fp) != 1)
+      return UVC_ERROR_IO;
+    rec->packets[i].status = (int32_t) get_le(buf, 4);
+    rec->packets[i].length = (uint32_t) get_le(buf + 4, 4);
+    packet_total += rec->packets[i].length;
+  }
+
+  if (rec->num_packets && packet_total != rec->data_len)
+    return UVC_ERROR_INVALID_PARAM;
+
+  if (rec->data_len > rec->data_alloc) {
+    void *p = realloc(rec->data, rec->data_len);
+    if (!p)
+      return UVC_ERROR_NO_MEM;
+    rec->data = p;
+    rec->data_alloc = rec->data_len;
+  }
+
+  if (rec->data_len && fread(rec->data, rec->data_len, 1, fp) != 1)
+    return UVC_ERROR_IO;
+
+  return UVC_SUCCESS;
+}
+
+/** @internal
+ * @brief Release the buffers held by a record
+ */
+void uvc_replay_free_record(uvc_replay_record_t *rec) {
+  free(rec->packets);
+  free(rec->data);
+  memset(rec, 0, sizeof(*rec));
+}
+
+/** @internal
+ * @brief Hand a recorded transfer to a stream
+ *
+ * Failed bulk transfers and isochronous packets with a non-zero status are
+ * skipped, as _uvc_stream_callback() does for live transfers.
+ *
+ * @param strmh Stream to feed, usually from uvc_synthetic_stream_start()
+ * @param rec Recorded transfer
+ * @param payload_cb Called after each payload has been processed, or NULL
+ * @param user_ptr Passed to @p payload_cb
+ * @return Number of payloads passed to _uvc_process_payload()
+ */
+size_t uvc_replay_feed(uvc_stream_handle_t *strmh, const uvc_replay_record_t *rec,
+                       uvc_replay_payload_cb_t *payload_cb, void *user_ptr) {
+  size_t offset = 0, fed = 0;
+  uint32_t i;
+
+  if (rec->type == UVC_REPLAY_BULK) {
+    if (rec->status != 0)
+      return 0;
+    _uvc_process_payload(strmh, rec->data, rec->data_len);
+    if (payload_cb)
+      payload_cb(strmh, user_ptr);
+    return 1;
+  }
+
+  for (i = 0; i < rec->num_packets; ++i) {
+    if (rec->packets[i].status == 0) {
+      _uvc_process_payload(strmh, rec->data + offset, rec->packets[i].length);
+      if (payload_cb)
+        payload_cb(strmh, user_ptr);
+      fed++;
+    } else {
+      UVC_DEBUG("bad packet (isochronous transfer); status: %d", rec->packets[i].status);
+    }
+    offset += rec->packets[i].length;
+  }
+
+  return fed;
+}
@@ -0,0 +1,577 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (C) 2010-2012 Ken Tossell
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the author nor other contributors may be
+*     used to endorse or promote products derived from this software
+*     without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+/**
+ * @internal
+ * @file status.c
+ * @brief Status interrupt transfers and the per-device event queue.
+ *
+ * Several interrupt transfers are kept in flight on the VideoControl
+ * status endpoint so that packets arriving back to back are not held up
+ * waiting for a resubmission. Every packet updates the control cache at
+ * once. What happens next depends on the device's mode:
+ *
+ * - by default the status and button callbacks run right away, on the
+ *   thread handling libusb events, as they always have;
+ * - with the queue enabled (uvc_set_status_queue_enabled()) the packet is
+ *   pushed onto a single-producer ring and the application takes it off
+ *   on its own thread with uvc_read_status_event() or
+ *   uvc_dispatch_status_events(), waking on uvc_get_status_fd(). Slow
+ *   application code can then no longer delay video transfers.
+ *
+ * libusb runs one event handler at a time, so there is only ever one
+ * producer, and it never blocks: when the ring is full the packet is
+ * dropped and counted as lost. Consumers serialize on a mutex that the
+ * producer never touches.
+ */
+#include "libuvc/libuvc.h"
+#include "libuvc/libuvc_internal.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/eventfd.h>
+#endif
+
+/** Smallest status transfer buffer; packets are at most wMaxPacketSize */
+#define STATUS_MIN_BUF 32
+
+typedef struct uvc_status_queue {
+  uvc_status_event_t events[LIBUVC_STATUS_QUEUE_LEN];
+  /** Next slot to fill (producer) and to empty (consumers); free-running */
+  uint32_t head, tail;
+  volatile int enabled;
+  /** Readable while events may be waiting: an eventfd, or a pipe's read end */
+  int fd, wfd;
+  pthread_mutex_t read_mutex;
+  uint64_t received, queued, lost;
+} uvc_status_queue_t;
+
+static void status_signal(uvc_status_queue_t *q) {
+#ifdef __linux__
+  uint64_t one = 1;
+  ssize_t ret = write(q->wfd, &one, sizeof(one));
+#else
+  char one = 1;
+  ssize_t ret = write(q->wfd, &one, 1);
+#endif
+  (void) ret;
+}
+
+/* Reset the descriptor; only called once the queue has been seen empty */
+static void status_drain_fd(uvc_status_queue_t *q) {
+  uint64_t buf[8];
+
+  while (read(q->fd, buf, sizeof(buf)) > 0)
+    ;
+}
+
+/* Producer side: never blocks */
+static void status_push(uvc_status_queue_t *q, const uint8_t *data, int len) {
+  uint32_t head = q->head;
+  uint32_t tail = __atomic_load_n(&q->tail, __ATOMIC_ACQUIRE);
+  uvc_status_event_t *ev;
+
+  if (head - tail >= LIBUVC_STATUS_QUEUE_LEN) {
+    __atomic_add_fetch(&q->lost, 1, __ATOMIC_RELAXED);
+    return;
+  }
+
+  ev = &q->events[head % LIBUVC_STATUS_QUEUE_LEN];
+  ev->timestamp_us = uvc_now_us();
+  ev->data_len = len < UVC_STATUS_EVENT_MAX_LEN ? (size_t) len : UVC_STATUS_EVENT_MAX_LEN;
+  memcpy(ev->data, data, ev->data_len);
+
+  __atomic_store_n(&q->head, head + 1, __ATOMIC_RELEASE);
+  __atomic_add_fetch(&q->queued, 1, __ATOMIC_RELAXED);
+
+  status_signal(q);
+}
+
+/* Consumer side; caller holds read_mutex */
+static int status_pop(uvc_status_queue_t *q, uvc_status_event_t *event) {
+  uint32_t tail = q->tail;
+  uint32_t head = __atomic_load_n(&q->head, __ATOMIC_ACQUIRE);
+
+  if (head == tail)
+    return 0;
+
+  *event = q->events[tail % LIBUVC_STATUS_QUEUE_LEN];
+  __atomic_store_n(&q->tail, tail + 1, __ATOMIC_RELEASE);
+
+  return 1;
+}
+
+/* Guards transfer->user_data of status transfers, which uvc_status_stop()
+ * clears when it leaves transfers behind for their callbacks to free. It is
+ * only held while a callback looks up its handle: status_in_callback then
+ * keeps the handle alive, so that events are dispatched without it. */
+static pthread_mutex_t status_owner_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static void LIBUSB_CALL _uvc_status_callback(struct libusb_transfer *transfer) {
+  uvc_device_handle_t *devh;
+  int i;
+
+  UVC_ENTER();
+
+  pthread_mutex_lock(&status_owner_mutex);
+  devh = (uvc_device_handle_t *) transfer->user_data;
+  if (!devh) {
+    /* the handle was closed without waiting for this transfer */
+    pthread_mutex_unlock(&status_owner_mutex);
+    libusb_free_transfer(transfer);
+    UVC_EXIT_VOID();
+    return;
+  }
+  pthread_mutex_lock(&devh->status_mutex);
+  devh->status_in_callback++;
+  pthread_mutex_unlock(&devh->status_mutex);
+  pthread_mutex_unlock(&status_owner_mutex);
+
+  switch (transfer->status) {
+  case LIBUSB_TRANSFER_COMPLETED:
+    if (transfer->actual_length > 0)
+      uvc_status_received(devh, transfer->buffer, transfer->actual_length);
+    break;
+  case LIBUSB_TRANSFER_TIMED_OUT:
+  case LIBUSB_TRANSFER_STALL:
+  case LIBUSB_TRANSFER_OVERFLOW:
+    UVC_DEBUG("retrying transfer, status = %d", transfer->status);
+    break;
+  default:
+    UVC_DEBUG("not processing/resubmitting, status = %d", transfer->status);
+    pthread_mutex_lock(&devh->status_mutex);
+    goto retire;
+  }
+
+  /* checked and resubmitted under the lock, so that uvc_status_stop()
+   * either sees the transfer in flight or keeps it from going out */
+  pthread_mutex_lock(&devh->status_mutex);
+  if (!devh->status_stopping && libusb_submit_transfer(transfer) == 0) {
+    devh->status_in_callback--;
+    pthread_cond_broadcast(&devh->status_cond);
+    pthread_mutex_unlock(&devh->status_mutex);
+    UVC_EXIT_VOID();
+    return;
+  }
+
+retire:
+  for (i = 0; i < LIBUVC_NUM_STATUS_XFERS; ++i) {
+    if (devh->status_xfers[i] == transfer)
+      devh->status_xfers_live &= ~(1u << i);
+  }
+  devh->status_xfers_active--;
+  devh->status_in_callback--;
+  pthread_cond_broadcast(&devh->status_cond);
+  pthread_mutex_unlock(&devh->status_mutex);
+
+  UVC_EXIT_VOID();
+}
+
+/** @internal
+ * @brief Set up the status state of a new device handle
+ */
+void uvc_status_init(uvc_device_handle_t *devh) {
+  pthread_mutex_init(&devh->status_mutex, NULL);
+  pthread_cond_init(&devh->status_cond, NULL);
+}
+
+/** @internal
+ * @brief Start reading the status endpoint, if the device has one and the
+ * handle was not opened with UVC_OPEN_NO_STATUS
+ *
+ * Fails only if no transfer at all could be submitted.
+ */
+uvc_error_t uvc_status_start(uvc_device_handle_t *devh) {
+  uint8_t ep = devh->info->ctrl_if.bEndpointAddress;
+  int buf_len, i, ret = UVC_SUCCESS;
+
+  if (!ep || (devh->open_flags & UVC_OPEN_NO_STATUS))
+    return UVC_SUCCESS;
+
+  devh->status_stopping = 0;
+
+  buf_len = libusb_get_max_packet_size(libusb_get_device(devh->usb_devh), ep);
+  if (buf_len < STATUS_MIN_BUF)
+    buf_len = STATUS_MIN_BUF;
+
+  for (i = 0; i < LIBUVC_NUM_STATUS_XFERS; ++i) {
+    struct libusb_transfer *transfer = libusb_alloc_transfer(0);
+    uint8_t *buf = malloc(buf_len);
+
+    if (!transfer || !buf) {
+      libusb_free_transfer(transfer);
+      free(buf);
+      ret = UVC_ERROR_NO_MEM;
+      break;
+    }
+
+    libusb_fill_interrupt_transfer(transfer, devh->usb_devh, ep, buf, buf_len,
+                                   _uvc_status_callback, devh, 0);
+    transfer->flags = LIBUSB_TRANSFER_FREE_BUFFER;
+    devh->status_xfers[i] = transfer;
+
+    pthread_mutex_lock(&devh->status_mutex);
+    ret = libusb_submit_transfer(transfer);
+    UVC_DEBUG("libusb_submit_transfer() = %d", ret);
+    if (ret == 0) {
+      devh->status_xfers_active++;
+      devh->status_xfers_live |= 1u << i;
+    }
+    pthread_mutex_unlock(&devh->status_mutex);
+    if (ret)
+      break;
+  }
+
+  /* fewer transfers in flight only means more latency */
+  return devh->status_xfers_active ? UVC_SUCCESS : ret;
+}
+
+/** @internal
+ * @brief Cancel the status transfers
+ *
+ * With the library's own event thread running, waits for the transfers to
+ * retire. Otherwise nothing may be handling events while we wait, so the
+ * transfers still in flight are left to their callbacks, which free them
+ * when the cancellation completes.
+ */
+void uvc_status_stop(uvc_device_handle_t *devh) {
+  int wait = devh->dev->ctx->handler_thread_running;
+  int i;
+
+  pthread_mutex_lock(&devh->status_mutex);
+  devh->status_stopping = 1;
+  for (i = 0; i < LIBUVC_NUM_STATUS_XFERS; ++i) {
+    if (devh->status_xfers_live & (1u << i))
+      libusb_cancel_transfer(devh->status_xfers[i]);
+  }
+  while (wait && devh->status_xfers_active > 0)
+    pthread_cond_wait(&devh->status_cond, &devh->status_mutex);
+  pthread_mutex_unlock(&devh->status_mutex);
+
+  if (wait)
+    return;
+
+  /* no callback can pick up the handle while we hold the owner lock; wait
+   * out the ones that already have */
+  pthread_mutex_lock(&status_owner_mutex);
+  pthread_mutex_lock(&devh->status_mutex);
+  while (devh->status_in_callback > 0)
+    pthread_cond_wait(&devh->status_cond, &devh->status_mutex);
+  for (i = 0; i < LIBUVC_NUM_STATUS_XFERS; ++i) {
+    if (devh->status_xfers_live & (1u << i)) {
+      devh->status_xfers[i]->user_data = NULL;
+      devh->status_xfers[i] = NULL;
+    }
+  }
+  devh->status_xfers_live = 0;
+  devh->status_xfers_active = 0;
+  pthread_mutex_unlock(&devh->status_mutex);
+  pthread_mutex_unlock(&status_owner_mutex);
+}
+
+/** @internal
+ * @brief Cancel the status transfers and wait until none is in flight
+ *
+ * Unlike uvc_status_stop(), handles libusb events itself when the library's
+ * event thread is not running, so that no transfer still refers to
+ * usb_devh when it returns.
+ */
+void uvc_status_drain(uvc_device_handle_t *devh) {
+  uvc_context_t *ctx = devh->dev->ctx;
+  int i;
+
+  if (ctx->handler_thread_running) {
+    uvc_status_stop(devh);
+    return;
+  }
+
+  pthread_mutex_lock(&devh->status_mutex);
+  devh->status_stopping = 1;
+  for (i = 0; i < LIBUVC_NUM_STATUS_XFERS; ++i) {
+    if (devh->status_xfers_live & (1u << i))
+      libusb_cancel_transfer(devh->status_xfers[i]);
+  }
+  while (devh->status_xfers_active > 0) {
+    struct timeval tv = { 0, 100000 };
+
+    /* the callbacks take status_mutex */
+    pthread_mutex_unlock(&devh->status_mutex);
+    libusb_handle_events_timeout_completed(ctx->usb_ctx, &tv, NULL);
+    pthread_mutex_lock(&devh->status_mutex);
+  }
+  pthread_mutex_unlock(&devh->status_mutex);
+}
+
+/** @internal
+ * @brief Replace the status transfers after usb_devh has changed
+ *
+ * The old transfers have retired (the device they were submitted to is
+ * gone); they are freed and new ones submitted on the current handle.
+ */
+uvc_error_t uvc_status_restart(uvc_device_handle_t *devh) {
+  int i;
+
+  uvc_status_stop(devh);
+
+  for (i = 0; i < LIBUVC_NUM_STATUS_XFERS; ++i) {
+    if (devh->status_xfers[i])
+      libusb_free_transfer(devh->status_xfers[i]);
+    devh->status_xfers[i] = NULL;
+  }
+
+  return uvc_status_start(devh);
+}
+
+/** @internal
+ * @brief Release the status transfers and queue; none may be in flight
+ */
+void uvc_status_free(uvc_device_handle_t *devh) {
+  uvc_status_queue_t *q = devh->status_queue;
+  int i;
+
+  for (i = 0; i < LIBUVC_NUM_STATUS_XFERS; ++i) {
+    if (devh->status_xfers[i])
+      libusb_free_transfer(devh->status_xfers[i]);
+    devh->status_xfers[i] = NULL;
+  }
+
+  if (q) {
+    close(q->fd);
+    if (q->wfd != q->fd)
+      close(q->wfd);
+    pthread_mutex_destroy(&q->read_mutex);
+    free(q);
+    devh->status_queue = NULL;
+  }
+
+  pthread_cond_destroy(&devh->status_cond);
+  pthread_mutex_destroy(&devh->status_mutex);
+}
+
+/** @internal
+ * @brief Handle one status packet, on the thread handling libusb events
+ */
+void uvc_status_received(uvc_device_handle_t *devh, const uint8_t *data, int len) {
+  uvc_status_queue_t *q = __atomic_load_n(&devh->status_queue, __ATOMIC_ACQUIRE);
+
+  if ((data[0] & 0x0f) == 1)
+    uvc_status_update_caches(devh, data, len);
+
+  if (q) {
+    __atomic_add_fetch(&q->received, 1, __ATOMIC_RELAXED);
+    if (q->enabled) {
+      status_push(q, data, len);
+      return;
+    }
+  }
+
+  uvc_process_status_packet(devh, (uint8_t *) data, len);
+}
+
+static uvc_error_t status_queue_create(uvc_device_handle_t *devh) {
+  uvc_status_queue_t *q = calloc(1, sizeof(*q));
+  int fds[2];
+
+  if (!q)
+    return UVC_ERROR_NO_MEM;
+
+#ifdef __linux__
+  q->fd = q->wfd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (q->fd < 0) {
+    free(q);
+    return UVC_ERROR_OTHER;
+  }
+#else
+  if (pipe(fds) < 0) {
+    free(q);
+    return UVC_ERROR_OTHER;
+  }
+  fcntl(fds[0], F_SETFL, O_NONBLOCK);
+  fcntl(fds[1], F_SETFL, O_NONBLOCK);
+  q->fd = fds[0];
+  q->wfd = fds[1];
+#endif
+  (void) fds;
+
+  pthread_mutex_init(&q->read_mutex, NULL);
+  __atomic_store_n(&devh->status_queue, q, __ATOMIC_RELEASE);
+
+  return UVC_SUCCESS;
+}
+
+/** @brief Queue status events for the application instead of calling back
+ * @ingroup device
+ *
+ * While enabled, the status and button callbacks are no longer called on
+ * the thread handling libusb events. Events are queued instead, and taken
+ * off with uvc_read_status_event() or uvc_dispatch_status_events(). The
+ * queue holds LIBUVC_STATUS_QUEUE_LEN events; events arriving while it is
+ * full are dropped and counted (see uvc_get_status_stats()).
+ *
+ * The control cache follows status events whether or not they are queued.
+ *
+ * @param devh UVC device handle
+ * @param enabled Nonzero to queue events, zero to call back again; events
+ *   still queued stay there
+ * @return UVC_SUCCESS, or an error if the queue could not be created
+ */
+uvc_error_t uvc_set_status_queue_enabled(uvc_device_handle_t *devh, int enabled) {
+  uvc_error_t ret = UVC_SUCCESS;
+
+  pthread_mutex_lock(&devh->status_mutex);
+  if (!devh->status_queue && enabled)
+    ret = status_queue_create(devh);
+  if (devh->status_queue)
+    devh->status_queue->enabled = enabled ? 1 : 0;
+  pthread_mutex_unlock(&devh->status_mutex);
+
+  return ret;
+}
+
+/** @brief File descriptor that polls readable while status events are queued
+ * @ingroup device
+ *
+ * Wait for it with poll(), select() or an event loop, then call
+ * uvc_read_status_event() with a zero timeout until it returns
+ * UVC_ERROR_TIMEOUT, or uvc_dispatch_status_events() once. Do not read from
+ * the descriptor or close it.
+ *
+ * @param devh UVC device handle
+ * @return Descriptor, or UVC_ERROR_INVALID_PARAM if the queue has never
+ *   been enabled
+ */
+int uvc_get_status_fd(uvc_device_handle_t *devh) {
+  return devh->status_queue ? devh->status_queue->fd : UVC_ERROR_INVALID_PARAM;
+}
+
+/** @brief Take the oldest event off the status queue
+ * @ingroup device
+ *
+ * @param devh UVC device handle
+ * @param[out] event Event
+ * @param timeout_ms How long to wait for an event: 0 not at all, -1 forever
+ * @return UVC_SUCCESS, UVC_ERROR_TIMEOUT if no event arrived in time, or
+ *   UVC_ERROR_INVALID_PARAM if the queue has never been enabled
+ */
+uvc_error_t uvc_read_status_event(uvc_device_handle_t *devh, uvc_status_event_t *event,
+                                  int timeout_ms) {
+  uvc_status_queue_t *q = devh->status_queue;
+  uint64_t deadline_us = 0;
+  int got;
+
+  if (!q)
+    return UVC_ERROR_INVALID_PARAM;
+
+  if (timeout_ms > 0)
+    deadline_us = uvc_now_us() + (uint64_t) timeout_ms * 1000;
+
+  for (;;) {
+    struct pollfd pfd;
+    int wait_ms = timeout_ms;
+
+    pthread_mutex_lock(&q->read_mutex);
+    got = status_pop(q, event);
+    if (!got) {
+      /* reset the descriptor, then look again for a push that raced it */
+      status_drain_fd(q);
+      got = status_pop(q, event);
+    }
+    pthread_mutex_unlock(&q->read_mutex);
+
+    if (got)
+      return UVC_SUCCESS;
+    if (timeout_ms == 0)
+      return UVC_ERROR_TIMEOUT;
+
+    if (timeout_ms > 0) {
+      uint64_t now = uvc_now_us();
+
+      if (now >= deadline_us)
+        return UVC_ERROR_TIMEOUT;
+      wait_ms = (int) ((deadline_us - now + 999) / 1000);
+    }
+
+    pfd.fd = q->fd;
+    pfd.events = POLLIN;
+    if (poll(&pfd, 1, wait_ms) < 0 && errno != EINTR)
+      return UVC_ERROR_OTHER;
+  }
+}
+
+/** @brief Run the status and button callbacks for every queued event
+ * @ingroup device
+ *
+ * The callbacks run on the calling thread, with the arguments they would
+ * have been given on the libusb event thread.
+ *
+ * @param devh UVC device handle
+ * @return Number of events dispatched
+ */
+int uvc_dispatch_status_events(uvc_device_handle_t *devh) {
+  uvc_status_event_t event;
+  int count = 0;
+
+  while (uvc_read_status_event(devh, &event, 0) == UVC_SUCCESS) {
+    uvc_process_status_packet(devh, event.data, (int) event.data_len);
+    count++;
+  }
+
+  return count;
+}
+
+/** @brief Status event counters
+ * @ingroup device
+ *
+ * @param devh UVC device handle
+ * @param[out] stats Counters since the queue was first enabled
+ */
+void uvc_get_status_stats(uvc_device_handle_t *devh, uvc_status_stats_t *stats) {
+  uvc_status_queue_t *q = devh->status_queue;
+
+  memset(stats, 0, sizeof(*stats));
+  pthread_mutex_lock(&devh->status_mutex);
+  stats->transfers_in_flight = devh->status_xfers_active;
+  pthread_mutex_unlock(&devh->status_mutex);
+
+  if (!q)
+    return;
+
+  stats->received = __atomic_load_n(&q->received, __ATOMIC_RELAXED);
+  stats->queued = __atomic_load_n(&q->queued, __ATOMIC_RELAXED);
+  stats->lost = __atomic_load_n(&q->lost, __ATOMIC_RELAXED);
+  stats->pending = __atomic_load_n(&q->head, __ATOMIC_ACQUIRE) -
+    __atomic_load_n(&q->tail, __ATOMIC_ACQUIRE);
+}
@@ -0,0 +1,445 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (C) 2010-2012 Ken Tossell
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the author nor other contributors may be
+*     used to endorse or promote products derived from this software
+*     without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+/**
+ * @internal
+ * @file stream-resume.c
+ * @brief Resuming a stream after its device drops off the bus.
+ *
+ * When a camera is reset or briefly unplugged, its transfers complete with
+ * LIBUSB_TRANSFER_NO_DEVICE and _uvc_stream_callback() retires them. For a
+ * stream with resume enabled, a thread then waits for a device with the
+ * same serial number (or, if it has none, the same vendor and product ID on
+ * the same port path) to appear, moves the device handle onto it with
+ * uvc_reattach_device(), commits the stream's last uvc_stream_ctrl_t again
+ * and restarts the transfers. The user callback thread keeps running
+ * through the outage, so frames resume on the same callback.
+ *
+ * With the device index enabled (see device-index.c) each poll for the
+ * returning device is a table lookup; otherwise it enumerates the bus.
+ */
+#include "libuvc/libuvc.h"
+#include "libuvc/libuvc_internal.h"
+#include <time.h>
+#include <errno.h>
+
+/** How often to look for the returning device */
+#define RESUME_POLL_MS 100
+#define RESUME_MAX_DEPTH 8
+
+struct uvc_stream_resume {
+  pthread_t thread;
+  /** Held while reattaching, so that uvc_stream_stop() cannot interleave */
+  pthread_mutex_t mutex;
+  /** Give up after this long without the device; 0 waits forever */
+  uint32_t timeout_ms;
+
+  /** Identity of the device to wait for */
+  uint16_t vid, pid;
+  char *serial;
+  uint8_t bus;
+  uint8_t num_ports;
+  uint8_t ports[RESUME_MAX_DEPTH];
+
+  /* The rest is protected by the stream's cb_mutex */
+  uint8_t stop;
+  /** A transfer has reported the device gone */
+  uint8_t lost;
+  /** Start of the outage in progress (CLOCK_MONOTONIC), or 0 */
+  uint64_t lost_us;
+  uvc_stream_resume_stats_t stats;
+};
+
+/** Serialises reattaching device handles, for streams sharing one */
+static pthread_mutex_t resume_reattach_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static void resume_notify(uvc_stream_handle_t *strmh, enum uvc_stream_resume_event event,
+                          uint64_t outage_us) {
+  if (strmh->resume_cb)
+    strmh->resume_cb(strmh, event, outage_us, strmh->resume_user_ptr);
+}
+
+/* Called with cb_mutex held */
+static int resume_transfers_pending(uvc_stream_handle_t *strmh) {
+  int i;
+
+  for (i = 0; i < LIBUVC_MAX_TRANSFER_BUFS; ++i) {
+    if (strmh->transfers[i])
+      return 1;
+  }
+
+  return 0;
+}
+
+/* Looks for the new instance of the stream's device */
+static uvc_error_t resume_find_device(uvc_stream_handle_t *strmh, uvc_device_t **dev) {
+  struct uvc_stream_resume *r = strmh->resume;
+  uvc_context_t *ctx = strmh->devh->dev->ctx;
+  uvc_error_t ret;
+
+  if (r->serial) {
+    ret = uvc_find_device(ctx, dev, r->vid, r->pid, r->serial);
+  } else {
+    ret = uvc_find_device_by_port(ctx, dev, r->bus, r->ports, r->num_ports);
+    if (ret == UVC_SUCCESS) {
+      struct libusb_device_descriptor desc;
+
+      if (libusb_get_device_descriptor((*dev)->usb_dev, &desc) != LIBUSB_SUCCESS ||
+          desc.idVendor != r->vid || desc.idProduct != r->pid) {
+        /* something else was plugged into the port */
+        uvc_unref_device(*dev);
+        ret = UVC_ERROR_NO_DEVICE;
+      }
+    }
+  }
+
+  /* libusb may not have processed the departure yet */
+  if (ret == UVC_SUCCESS && (*dev)->usb_dev == strmh->devh->dev->usb_dev) {
+    uvc_unref_device(*dev);
+    ret = UVC_ERROR_NO_DEVICE;
+  }
+
+  return ret;
+}
+
+/* One attempt at getting the stream going again. @p generation is the
+ * device handle's usb_generation when the device was lost; if another
+ * stream of the same handle has reattached it since, only this stream is
+ * restarted. */
+static uvc_error_t resume_reattach(uvc_stream_handle_t *strmh, uint32_t *generation) {
+  struct uvc_stream_resume *r = strmh->resume;
+  uvc_device_handle_t *devh = strmh->devh;
+  uvc_device_t *dev;
+  uvc_error_t ret = UVC_SUCCESS;
+
+  pthread_mutex_lock(&r->mutex);
+
+  pthread_mutex_lock(&resume_reattach_mutex);
+  if (devh->usb_generation == *generation) {
+    ret = resume_find_device(strmh, &dev);
+    if (ret == UVC_SUCCESS) {
+      ret = uvc_reattach_device(devh, dev);
+      uvc_unref_device(dev);
+    }
+  }
+  *generation = devh->usb_generation;
+  pthread_mutex_unlock(&resume_reattach_mutex);
+
+  if (ret == UVC_SUCCESS) {
+    pthread_mutex_lock(&strmh->cb_mutex);
+    r->lost = 0;
+    pthread_mutex_unlock(&strmh->cb_mutex);
+
+    if (strmh->running) {
+      uvc_stream_ctrl_t ctrl = strmh->cur_ctrl;
+
+      ret = uvc_query_stream_ctrl(devh, &ctrl, 1, UVC_SET_CUR);
+      if (ret == UVC_SUCCESS) {
+        ctrl = strmh->cur_ctrl;
+        ret = uvc_query_stream_ctrl(devh, &ctrl, 0, UVC_SET_CUR);
+      }
+      if (ret == UVC_SUCCESS)
+        ret = uvc_stream_resume_transfers(strmh);
+    }
+  }
+
+  pthread_mutex_unlock(&r->mutex);
+
+  UVC_DEBUG("reattach attempt: %s", uvc_strerror(ret));
+
+  return ret;
+}
+
+/* Handles one outage, from the last transfer retiring until the stream
+ * runs again, the timeout expires or resume is disabled */
+static void resume_recover(uvc_stream_handle_t *strmh) {
+  struct uvc_stream_resume *r = strmh->resume;
+  enum uvc_stream_resume_event outcome;
+  uint64_t start, outage;
+  uint32_t generation;
+
+  pthread_mutex_lock(&resume_reattach_mutex);
+  generation = strmh->devh->usb_generation;
+  pthread_mutex_unlock(&resume_reattach_mutex);
+
+  start = uvc_now_us();
+  pthread_mutex_lock(&strmh->cb_mutex);
+  r->lost_us = start;
+  r->stats.outages++;
+  pthread_mutex_unlock(&strmh->cb_mutex);
+
+  resume_notify(strmh, UVC_STREAM_DEVICE_LOST, 0);
+
+  for (;;) {
+    struct timespec ts;
+    int stop;
+
+    clock_gettime(CLOCK_REALTIME, &ts);
+    ts.tv_nsec += RESUME_POLL_MS * 1000000L;
+    if (ts.tv_nsec >= 1000000000L) {
+      ts.tv_sec++;
+      ts.tv_nsec -= 1000000000L;
+    }
+
+    pthread_mutex_lock(&strmh->cb_mutex);
+    while (!r->stop &&
+           pthread_cond_timedwait(&strmh->cb_cond, &strmh->cb_mutex, &ts) != ETIMEDOUT)
+      ;
+    stop = r->stop;
+    pthread_mutex_unlock(&strmh->cb_mutex);
+
+    if (stop)
+      return;
+
+    if (resume_reattach(strmh, &generation) == UVC_SUCCESS) {
+      outcome = UVC_STREAM_RESUMED;
+      break;
+    }
+
+    if (r->timeout_ms && uvc_now_us() - start >= (uint64_t) r->timeout_ms * 1000) {
+      outcome = UVC_STREAM_RESUME_FAILED;
+      break;
+    }
+  }
+
+  outage = uvc_now_us() - start;
+
+  pthread_mutex_lock(&strmh->cb_mutex);
+  r->lost_us = 0;
+  r->stats.total_outage_us += outage;
+  if (outcome == UVC_STREAM_RESUMED) {
+    r->stats.resumes++;
+    r->stats.last_outage_us = outage;
+    if (outage > r->stats.max_outage_us)
+      r->stats.max_outage_us = outage;
+  } else {
+    /* the stream stays dead; wait for nothing more */
+    r->lost = 0;
+  }
+  pthread_mutex_unlock(&strmh->cb_mutex);
+
+  resume_notify(strmh, outcome, outage);
+}
+
+static void *resume_thread(void *arg) {
+  uvc_stream_handle_t *strmh = arg;
+  struct uvc_stream_resume *r = strmh->resume;
+
+  pthread_mutex_lock(&strmh->cb_mutex);
+  while (!r->stop) {
+    /* wait for every transfer to retire before touching the handle */
+    if (!r->lost || resume_transfers_pending(strmh)) {
+      pthread_cond_wait(&strmh->cb_cond, &strmh->cb_mutex);
+      continue;
+    }
+
+    pthread_mutex_unlock(&strmh->cb_mutex);
+    resume_recover(strmh);
+    pthread_mutex_lock(&strmh->cb_mutex);
+  }
+  pthread_mutex_unlock(&strmh->cb_mutex);
+
+  return NULL;
+}
+
+/** @internal
+ * @brief Note that a transfer found the device gone
+ *
+ * Called with the stream's cb_mutex held.
+ */
+void uvc_stream_resume_device_lost(uvc_stream_handle_t *strmh) {
+  if (strmh->resume)
+    strmh->resume->lost = 1;
+}
+
+/** @internal
+ * @brief Keep a reattachment from running while the stream is changed
+ */
+void uvc_stream_resume_lock(uvc_stream_handle_t *strmh) {
+  if (strmh->resume)
+    pthread_mutex_lock(&strmh->resume->mutex);
+}
+
+/** @internal
+ * @brief Counterpart of uvc_stream_resume_lock()
+ */
+void uvc_stream_resume_unlock(uvc_stream_handle_t *strmh) {
+  if (strmh->resume)
+    pthread_mutex_unlock(&strmh->resume->mutex);
+}
+
+/** @brief Resume the stream automatically when its device comes back
+ * @ingroup streaming
+ *
+ * If the device drops off the bus while resume is enabled, the stream waits
+ * for it to re-enumerate, matching it by serial number or, for devices
+ * without one, by vendor and product ID and port path. It then reopens it,
+ * claims the same interfaces, writes back the cached control values (see
+ * uvc_set_ctrl_cur_cache() and ctrl-xu.c's shadow values), commits the last
+ * stream control block again and resumes delivering frames to the same
+ * callback. Outages are reported through uvc_stream_set_resume_callback()
+ * and counted in uvc_stream_get_resume_stats().
+ *
+ * Other handles on the device stay valid: they now refer to the new
+ * instance. The device must come back with the same descriptors.
+ *
+ * @param strmh Stream, opened but not necessarily started
+ * @param enabled Nonzero to resume after outages, zero to stop doing so
+ * @param timeout_ms Give up if the device is gone for longer; 0 waits forever
+ * @return UVC_ERROR_NOT_SUPPORTED for synthetic devices, else an error or SUCCESS
+ */
+uvc_error_t uvc_stream_set_resume_enabled(uvc_stream_handle_t *strmh, int enabled,
+                                          uint32_t timeout_ms) {
+  uvc_device_handle_t *devh = strmh->devh;
+  struct uvc_stream_resume *r = strmh->resume;
+  struct libusb_device_descriptor desc;
+  int n;
+
+  UVC_ENTER();
+
+  if (!enabled) {
+    if (r) {
+      pthread_mutex_lock(&strmh->cb_mutex);
+      r->stop = 1;
+      pthread_cond_broadcast(&strmh->cb_cond);
+      pthread_mutex_unlock(&strmh->cb_mutex);
+      pthread_join(r->thread, NULL);
+
+      pthread_mutex_lock(&strmh->cb_mutex);
+      strmh->resume = NULL;
+      pthread_mutex_unlock(&strmh->cb_mutex);
+
+      pthread_mutex_destroy(&r->mutex);
+      free(r->serial);
+      free(r);
+    }
+    UVC_EXIT(UVC_SUCCESS);
+    return UVC_SUCCESS;
+  }
+
+  if (r) {
+    r->timeout_ms = timeout_ms;
+    UVC_EXIT(UVC_SUCCESS);
+    return UVC_SUCCESS;
+  }
+
+#ifdef LIBUVC_HAS_SYNTHETIC
+  if (devh->synthetic) {
+    UVC_EXIT(UVC_ERROR_NOT_SUPPORTED);
+    return UVC_ERROR_NOT_SUPPORTED;
+  }
+#endif
+
+  if (libusb_get_device_descriptor(devh->dev->usb_dev, &desc) != LIBUSB_SUCCESS) {
+    UVC_EXIT(UVC_ERROR_IO);
+    return UVC_ERROR_IO;
+  }
+
+  r = calloc(1, sizeof(*r));
+  if (!r) {
+    UVC_EXIT(UVC_ERROR_NO_MEM);
+    return UVC_ERROR_NO_MEM;
+  }
+
+  r->timeout_ms = timeout_ms;
+  r->vid = desc.idVendor;
+  r->pid = desc.idProduct;
+  r->bus = libusb_get_bus_number(devh->dev->usb_dev);
+  n = libusb_get_port_numbers(devh->dev->usb_dev, r->ports, RESUME_MAX_DEPTH);
+  r->num_ports = n > 0 ? n : 0;
+
+  /* the lookup uvc_find_device() matches serial numbers with; without
+   * one, r->serial stays NULL and the device is matched by its port path */
+  uvc_string_cache_fetch(devh->dev, &desc, NULL, NULL, &r->serial);
+
+  pthread_mutex_init(&r->mutex, NULL);
+
+  pthread_mutex_lock(&strmh->cb_mutex);
+  strmh->resume = r;
+  pthread_mutex_unlock(&strmh->cb_mutex);
+
+  if (pthread_create(&r->thread, NULL, resume_thread, strmh)) {
+    pthread_mutex_lock(&strmh->cb_mutex);
+    strmh->resume = NULL;
+    pthread_mutex_unlock(&strmh->cb_mutex);
+    pthread_mutex_destroy(&r->mutex);
+    free(r->serial);
+    free(r);
+    UVC_EXIT(UVC_ERROR_OTHER);
+    return UVC_ERROR_OTHER;
+  }
+
+  UVC_EXIT(UVC_SUCCESS);
+  return UVC_SUCCESS;
+}
+
+/** @brief Set a callback to learn about a resumable stream's outages
+ * @ingroup streaming
+ *
+ * Set it before enabling resume with uvc_stream_set_resume_enabled().
+ *
+ * @param strmh Stream
+ * @param cb Called when the device is lost, when the stream resumes and when
+ * resuming gives up, with the outage duration; NULL for none
+ * @param user_ptr Passed to @p cb
+ */
+void uvc_stream_set_resume_callback(uvc_stream_handle_t *strmh,
+                                    uvc_stream_resume_callback_t cb,
+                                    void *user_ptr) {
+  strmh->resume_cb = cb;
+  strmh->resume_user_ptr = user_ptr;
+}
+
+/** @brief Get the outage counters of a resumable stream
+ * @ingroup streaming
+ *
+ * The counters start when resume is enabled; all are zero while it is not.
+ *
+ * @param strmh Stream
+ * @param[out] stats Counters
+ */
+void uvc_stream_get_resume_stats(uvc_stream_handle_t *strmh,
+                                 uvc_stream_resume_stats_t *stats) {
+  struct uvc_stream_resume *r;
+
+  memset(stats, 0, sizeof(*stats));
+
+  pthread_mutex_lock(&strmh->cb_mutex);
+  r = strmh->resume;
+  if (r) {
+    *stats = r->stats;
+    if (r->lost_us)
+      stats->total_outage_us += uvc_now_us() - r->lost_us;
+  }
+  pthread_mutex_unlock(&strmh->cb_mutex);
+}
@@ -184,6 +184,60 @@ static enum uvc_frame_format uvc_frame_format_for_guid(uint8_t guid[16]) {
   return UVC_FRAME_FORMAT_UNKNOWN;
 }
 
+/** @internal
+ * @brief Encode a streaming control block as sent to the device
+ * @param[in] ctrl Control block
+ * @param[out] buf 34 bytes; UVC 1.0 devices only take the first 26
+ */
+void uvc_stream_ctrl_pack(const uvc_stream_ctrl_t *ctrl, uint8_t *buf) {
+  SHORT_TO_SW(ctrl->bmHint, buf);
+  buf[2] = ctrl->bFormatIndex;
+  buf[3] = ctrl->bFrameIndex;
+  INT_TO_DW(ctrl->dwFrameInterval, buf + 4);
+  SHORT_TO_SW(ctrl->wKeyFrameRate, buf + 8);
+  SHORT_TO_SW(ctrl->wPFrameRate, buf + 10);
+  SHORT_TO_SW(ctrl->wCompQuality, buf + 12);
+  SHORT_TO_SW(ctrl->wCompWindowSize, buf + 14);
+  SHORT_TO_SW(ctrl->wDelay, buf + 16);
+  INT_TO_DW(ctrl->dwMaxVideoFrameSize, buf + 18);
+  INT_TO_DW(ctrl->dwMaxPayloadTransferSize, buf + 22);
+  INT_TO_DW ( ctrl->dwClockFrequency, buf + 26 );
+  buf[30] = ctrl->bmFramingInfo;
+  buf[31] = ctrl->bPreferredVersion;
+  buf[32] = ctrl->bMinVersion;
+  buf[33] = ctrl->bMaxVersion;
+  /** @todo support UVC 1.1 */
+}
+
+/** @internal
+ * @brief Decode a streaming control block as received from the device
+ * @param[out] ctrl Control block; fields past @p len are left alone
+ * @param[in] buf Received data
+ * @param[in] len 26 or 34
+ */
+void uvc_stream_ctrl_unpack(uvc_stream_ctrl_t *ctrl, const uint8_t *buf, size_t len) {
+  ctrl->bmHint = SW_TO_SHORT(buf);
+  ctrl->bFormatIndex = buf[2];
+  ctrl->bFrameIndex = buf[3];
+  ctrl->dwFrameInterval = DW_TO_INT(buf + 4);
+  ctrl->wKeyFrameRate = SW_TO_SHORT(buf + 8);
+  ctrl->wPFrameRate = SW_TO_SHORT(buf + 10);
+  ctrl->wCompQuality = SW_TO_SHORT(buf + 12);
+  ctrl->wCompWindowSize = SW_TO_SHORT(buf + 14);
+  ctrl->wDelay = SW_TO_SHORT(buf + 16);
+  ctrl->dwMaxVideoFrameSize = DW_TO_INT(buf + 18);
+  ctrl->dwMaxPayloadTransferSize = DW_TO_INT(buf + 22);
+
+  if (len == 34) {
+    ctrl->dwClockFrequency = DW_TO_INT ( buf + 26 );
+    ctrl->bmFramingInfo = buf[30];
+    ctrl->bPreferredVersion = buf[31];
+    ctrl->bMinVersion = buf[32];
+    ctrl->bMaxVersion = buf[33];
+    /** @todo support UVC 1.1 */
+  }
+}
+
 /** @internal
  * Run a streaming control query
  * @param[in] devh UVC device
@@ -202,72 +256,38 @@ uvc_error_t uvc_query_stream_ctrl(
 
   memset(buf, 0, sizeof(buf));
 
-  if (devh->info->ctrl_if.bcdUVC >= 0x0110)
+  if (devh->info->ctrl_if.bcdUVC >= 0x0110 &&
+      !(devh->quirks.flags & UVC_QUIRK_PROBE_SHORT))
     len = 34;
   else
     len = 26;
 
   /* prepare for a SET transfer */
-  if (req == UVC_SET_CUR) {
-    SHORT_TO_SW(ctrl->bmHint, buf);
-    buf[2] = ctrl->bFormatIndex;
-    buf[3] = ctrl->bFrameIndex;
-    INT_TO_DW(ctrl->dwFrameInterval, buf + 4);
-    SHORT_TO_SW(ctrl->wKeyFrameRate, buf + 8);
-    SHORT_TO_SW(ctrl->wPFrameRate, buf + 10);
-    SHORT_TO_SW(ctrl->wCompQuality, buf + 12);
-    SHORT_TO_SW(ctrl->wCompWindowSize, buf + 14);
-    SHORT_TO_SW(ctrl->wDelay, buf + 16);
-    INT_TO_DW(ctrl->dwMaxVideoFrameSize, buf + 18);
-    INT_TO_DW(ctrl->dwMaxPayloadTransferSize, buf + 22);
-
-    if (len == 34) {
-      INT_TO_DW ( ctrl->dwClockFrequency, buf + 26 );
-      buf[30] = ctrl->bmFramingInfo;
-      buf[31] = ctrl->bPreferredVersion;
-      buf[32] = ctrl->bMinVersion;
-      buf[33] = ctrl->bMaxVersion;
-      /** @todo support UVC 1.1 */
-    }
-  }
+  if (req == UVC_SET_CUR)
+    uvc_stream_ctrl_pack(ctrl, buf);
 
   /* do the transfer */
-  err = libusb_control_transfer(
-      devh->usb_devh,
+  err = uvc_usb_control_transfer(
+      devh,
       req == UVC_SET_CUR ? 0x21 : 0xA1,
       req,
       probe ? (UVC_VS_PROBE_CONTROL << 8) : (UVC_VS_COMMIT_CONTROL << 8),
       ctrl->bInterfaceNumber,
-      buf, len, 0
+      buf, len
   );
 
   if (err <= 0) {
     return err;
   }
 
+  /* a new mode can change which values some controls accept */
+  if (!probe && req == UVC_SET_CUR)
+    uvc_ctrl_cache_invalidate_ranges(devh);
+
   /* now decode following a GET transfer */
   if (req != UVC_SET_CUR) {
-    ctrl->bmHint = SW_TO_SHORT(buf);
-    ctrl->bFormatIndex = buf[2];
-    ctrl->bFrameIndex = buf[3];
-    ctrl->dwFrameInterval = DW_TO_INT(buf + 4);
-    ctrl->wKeyFrameRate = SW_TO_SHORT(buf + 8);
-    ctrl->wPFrameRate = SW_TO_SHORT(buf + 10);
-    ctrl->wCompQuality = SW_TO_SHORT(buf + 12);
-    ctrl->wCompWindowSize = SW_TO_SHORT(buf + 14);
-    ctrl->wDelay = SW_TO_SHORT(buf + 16);
-    ctrl->dwMaxVideoFrameSize = DW_TO_INT(buf + 18);
-    ctrl->dwMaxPayloadTransferSize = DW_TO_INT(buf + 22);
-
-    if (len == 34) {
-      ctrl->dwClockFrequency = DW_TO_INT ( buf + 26 );
-      ctrl->bmFramingInfo = buf[30];
-      ctrl->bPreferredVersion = buf[31];
-      ctrl->bMinVersion = buf[32];
-      ctrl->bMaxVersion = buf[33];
-      /** @todo support UVC 1.1 */
-    }
-    else
+    uvc_stream_ctrl_unpack(ctrl, buf, len);
+    if (len != 34)
       ctrl->dwClockFrequency = devh->info->ctrl_if.dwClockFrequency;
 
     /* fix up block for cameras that fail to set dwMax* */
@@ -278,6 +298,8 @@ uvc_error_t uvc_query_stream_ctrl(
         ctrl->dwMaxVideoFrameSize = frame->dwMaxVideoFrameBufferSize;
       }
     }
+
+    uvc_quirks_fix_stream_ctrl(devh, ctrl);
   }
 
   return UVC_SUCCESS;
@@ -312,13 +334,13 @@ uvc_error_t uvc_query_still_ctrl(
   }
 
   /* do the transfer */
-  err = libusb_control_transfer(
-      devh->usb_devh,
+  err = uvc_usb_control_transfer(
+      devh,
       req == UVC_SET_CUR ? 0x21 : 0xA1,
       req,
       probe ? (UVC_VS_STILL_PROBE_CONTROL << 8) : (UVC_VS_STILL_COMMIT_CONTROL << 8),
       still_ctrl->bInterfaceNumber,
-      buf, len, 0
+      buf, len
   );
 
   if (err <= 0) {
@@ -365,13 +387,13 @@ uvc_error_t uvc_trigger_still(
   buf = 1;
 
   /* do the transfer */
-  err = libusb_control_transfer(
-      devh->usb_devh,
+  err = uvc_usb_control_transfer(
+      devh,
       0x21, //type set
       UVC_SET_CUR,
       (UVC_VS_STILL_IMAGE_TRIGGER_CONTROL << 8),
       still_ctrl->bInterfaceNumber,
-      &buf, 1, 0);
+      &buf, 1);
 
   if (err <= 0) {
     return err;
@@ -390,6 +412,7 @@ uvc_error_t uvc_trigger_still(
  *             {uvc_get_stream_ctrl_format_size}
  */
 uvc_error_t uvc_stream_ctrl(uvc_stream_handle_t *strmh, uvc_stream_ctrl_t *ctrl) {
+  uvc_frame_desc_t *frame_desc;
   uvc_error_t ret;
 
   if (strmh->stream_if->bInterfaceNumber != ctrl->bInterfaceNumber)
@@ -399,14 +422,55 @@ uvc_error_t uvc_stream_ctrl(uvc_stream_handle_t *strmh, uvc_stream_ctrl_t *ctrl)
   if (strmh->running)
     return UVC_ERROR_BUSY;
 
-  ret = uvc_query_stream_ctrl(strmh->devh, ctrl, 0, UVC_SET_CUR);
+  frame_desc = uvc_find_frame_desc_stream(strmh, ctrl->bFormatIndex, ctrl->bFrameIndex);
+  if (!frame_desc)
+    return UVC_ERROR_INVALID_PARAM;
+
+  ret = uvc_probe_cache_commit(strmh->devh, ctrl);
   if (ret != UVC_SUCCESS)
     return ret;
 
   strmh->cur_ctrl = *ctrl;
+  _uvc_stream_set_mode(strmh, frame_desc,
+                       uvc_frame_format_for_guid(frame_desc->parent->guidFormat));
   return UVC_SUCCESS;
 }
 
+/** @internal
+ * @brief Record the mode frames will be delivered in
+ *
+ * Resolved once when the mode is set, so that the frame callback path
+ * does not have to look anything up in the descriptor tree.
+ *
+ * @param strmh Stream handle
+ * @param frame_desc Descriptor of the committed frame
+ * @param format Frame format of the committed format
+ */
+void _uvc_stream_set_mode(uvc_stream_handle_t *strmh, uvc_frame_desc_t *frame_desc,
+                          enum uvc_frame_format format) {
+  strmh->frame_desc = frame_desc;
+  strmh->frame_format = format;
+
+  switch (format) {
+  case UVC_FRAME_FORMAT_BGR:
+    strmh->frame_step = frame_desc->wWidth * 3;
+    break;
+  case UVC_FRAME_FORMAT_YUYV:
+    strmh->frame_step = frame_desc->wWidth * 2;
+    break;
+  case UVC_FRAME_FORMAT_NV12:
+    strmh->frame_step = frame_desc->wWidth;
+    break;
+  case UVC_FRAME_FORMAT_P010:
+    strmh->frame_step = frame_desc->wWidth * 2;
+    break;
+  default:
+    /* MJPEG, H.264 and anything else without a fixed stride */
+    strmh->frame_step = 0;
+    break;
+  }
+}
+
 /** @internal
  * @brief Find the descriptor for a specific frame configuration
  * @param stream_if Stream interface
@@ -419,6 +483,13 @@ static uvc_frame_desc_t *_uvc_find_frame_desc_stream_if(uvc_streaming_interface_
   uvc_format_desc_t *format = NULL;
   uvc_frame_desc_t *frame = NULL;
 
+  if (stream_if->frame_index) {
+    if (format_id < 1 || format_id > stream_if->frame_index_formats ||
+        frame_id < 1 || frame_id > stream_if->frame_index_frames)
+      return NULL;
+    return stream_if->frame_index[(format_id - 1) * stream_if->frame_index_frames + frame_id - 1];
+  }
+
   DL_FOREACH(stream_if->format_descs, format) {
     if (format->bFormatIndex == format_id) {
       DL_FOREACH(format->frame_descs, frame) {
@@ -448,6 +519,9 @@ uvc_frame_desc_t *uvc_find_frame_desc(uvc_device_handle_t *devh,
   uvc_streaming_interface_t *stream_if;
   uvc_frame_desc_t *frame;
 
+  if (uvc_scan_deferred_streaming(devh, -1) != UVC_SUCCESS)
+    return NULL;
+
   DL_FOREACH(devh->info->stream_ifs, stream_if) {
     frame = _uvc_find_frame_desc_stream_if(stream_if, format_id, frame_id);
     if (frame)
@@ -474,6 +548,13 @@ uvc_error_t uvc_get_stream_ctrl_format_size(
     int width, int height,
     int fps) {
   uvc_streaming_interface_t *stream_if;
+  uint8_t match_format, match_frame;
+  uint32_t match_interval;
+  uvc_error_t ret;
+
+  ret = uvc_scan_deferred_streaming(devh, -1);
+  if (ret != UVC_SUCCESS)
+    return ret;
 
   /* find a matching frame descriptor and interval */
   DL_FOREACH(devh->info->stream_ifs, stream_if) {
@@ -491,21 +572,13 @@ uvc_error_t uvc_get_stream_ctrl_format_size(
 
         uint32_t *interval;
 
-        ctrl->bInterfaceNumber = stream_if->bInterfaceNumber;
-        UVC_DEBUG("claiming streaming interface %d", stream_if->bInterfaceNumber );
-        uvc_claim_if(devh, ctrl->bInterfaceNumber);
-        /* get the max values */
-        uvc_query_stream_ctrl( devh, ctrl, 1, UVC_GET_MAX);
-
         if (frame->intervals) {
           for (interval = frame->intervals; *interval; ++interval) {
             // allow a fps rate of zero to mean "accept first rate available"
             if (10000000 / *interval == (unsigned int) fps || fps == 0) {
-
-              ctrl->bmHint = (1 << 0); /* don't negotiate interval */
-              ctrl->bFormatIndex = format->bFormatIndex;
-              ctrl->bFrameIndex = frame->bFrameIndex;
-              ctrl->dwFrameInterval = *interval;
+              match_format = format->bFormatIndex;
+              match_frame = frame->bFrameIndex;
+              match_interval = *interval;
 
               goto found;
             }
@@ -519,10 +592,9 @@ uvc_error_t uvc_get_stream_ctrl_format_size(
               && !(interval_offset
                    && (interval_offset % frame->dwFrameIntervalStep))) {
 
-            ctrl->bmHint = (1 << 0);
-            ctrl->bFormatIndex = format->bFormatIndex;
-            ctrl->bFrameIndex = frame->bFrameIndex;
-            ctrl->dwFrameInterval = interval_100ns;
+            match_format = format->bFormatIndex;
+            match_frame = frame->bFrameIndex;
+            match_interval = interval_100ns;
 
             goto found;
           }
@@ -534,9 +606,312 @@ uvc_error_t uvc_get_stream_ctrl_format_size(
   return UVC_ERROR_INVALID_MODE;
 
 found:
+  /* only the matching interface needs claiming and its maximum values */
+  ctrl->bInterfaceNumber = stream_if->bInterfaceNumber;
+  UVC_DEBUG("claiming streaming interface %d", stream_if->bInterfaceNumber );
+  uvc_claim_if(devh, ctrl->bInterfaceNumber);
+  uvc_query_stream_ctrl( devh, ctrl, 1, UVC_GET_MAX);
+
+  ctrl->bmHint = (1 << 0); /* don't negotiate interval */
+  ctrl->bFormatIndex = match_format;
+  ctrl->bFrameIndex = match_frame;
+  ctrl->dwFrameInterval = match_interval;
+
   return uvc_probe_stream_ctrl(devh, ctrl);
 }
 
+/** @brief Reset mode preferences to "anything goes"
+ * @ingroup streaming
+ */
+void uvc_mode_prefs_init(uvc_mode_prefs_t *prefs) {
+  memset(prefs, 0, sizeof(*prefs));
+}
+
+#define MODE_DEFAULT_ATTEMPTS 4
+
+/** Candidates collected by uvc_rank_stream_modes() */
+struct mode_scan {
+  const uvc_mode_prefs_t *prefs;
+  uvc_mode_candidate_t *modes;
+  int num_modes, cap;
+  double max_area, max_fps;
+};
+
+/* Position of the format in the preference list, or -1 if unwanted */
+static int _uvc_mode_format_rank(const uvc_mode_prefs_t *prefs, uvc_format_desc_t *format) {
+  int i;
+
+  if (!prefs->formats)
+    return uvc_frame_format_for_guid(format->guidFormat) != UVC_FRAME_FORMAT_UNKNOWN ? 0 : -1;
+
+  for (i = 0; i < prefs->num_formats; ++i) {
+    if (_uvc_frame_format_matches_guid(prefs->formats[i], format->guidFormat))
+      return i;
+  }
+
+  return -1;
+}
+
+/* Record one frame at one interval, unless a hard limit rules it out */
+static uvc_error_t _uvc_mode_add(struct mode_scan *scan, uvc_streaming_interface_t *stream_if,
+                                 uvc_frame_desc_t *frame, int rank, uint32_t interval) {
+  const uvc_mode_prefs_t *prefs = scan->prefs;
+  uvc_mode_candidate_t *mode;
+  double fps, area;
+  uint64_t bandwidth;
+
+  if (!interval)
+    return UVC_SUCCESS;
+
+  fps = 10000000.0 / interval;
+  bandwidth = frame->dwMaxVideoFrameBufferSize
+    ? (uint64_t) frame->dwMaxVideoFrameBufferSize * 10000000 / interval
+    : frame->dwMaxBitRate / 8;
+
+  /* 1% slack, so that 29.97 fps passes for 30 */
+  if (prefs->min_fps > 0 && fps * 1.01 < prefs->min_fps)
+    return UVC_SUCCESS;
+  if (prefs->max_bandwidth && bandwidth > prefs->max_bandwidth)
+    return UVC_SUCCESS;
+  if (prefs->aspect_num > 0 && prefs->aspect_den > 0) {
+    int64_t diff = (int64_t) frame->wWidth * prefs->aspect_den -
+                   (int64_t) frame->wHeight * prefs->aspect_num;
+
+    if ((diff < 0 ? -diff : diff) * 100 > (int64_t) frame->wHeight * prefs->aspect_num)
+      return UVC_SUCCESS;
+  }
+
+  if (scan->num_modes == scan->cap) {
+    int cap = scan->cap ? scan->cap * 2 : 64;
+    uvc_mode_candidate_t *modes = realloc(scan->modes, cap * sizeof(*modes));
+
+    if (!modes)
+      return UVC_ERROR_NO_MEM;
+    scan->modes = modes;
+    scan->cap = cap;
+  }
+
+  mode = &scan->modes[scan->num_modes];
+  mode->desc_index = scan->num_modes++;
+  mode->frame_desc = frame;
+  mode->frame_format = uvc_frame_format_for_guid(frame->parent->guidFormat);
+  mode->bInterfaceNumber = stream_if->bInterfaceNumber;
+  mode->bFormatIndex = frame->parent->bFormatIndex;
+  mode->bFrameIndex = frame->bFrameIndex;
+  mode->dwFrameInterval = interval;
+  mode->fps = fps;
+  mode->bandwidth = bandwidth;
+  /* the format rank until scoring; ties go to descriptor order */
+  mode->score = rank;
+
+  area = (double) frame->wWidth * frame->wHeight;
+  if (area > scan->max_area)
+    scan->max_area = area;
+  if (fps > scan->max_fps)
+    scan->max_fps = fps;
+
+  return UVC_SUCCESS;
+}
+
+/* Distance of one dimension from its target; falling short costs double */
+static double _uvc_mode_dim_cost(int have, int want) {
+  if (want <= 0)
+    return 0;
+  return have >= want ? (double) (have - want) / want : 2.0 * (want - have) / want;
+}
+
+static double _uvc_mode_score(const struct mode_scan *scan, const uvc_mode_candidate_t *mode) {
+  const uvc_mode_prefs_t *prefs = scan->prefs;
+  const uvc_frame_desc_t *frame = mode->frame_desc;
+  double res_cost, fps_cost;
+
+  if (prefs->width > 0 || prefs->height > 0) {
+    res_cost = _uvc_mode_dim_cost(frame->wWidth, prefs->width) +
+               _uvc_mode_dim_cost(frame->wHeight, prefs->height);
+  } else {
+    res_cost = 1.0 - (double) frame->wWidth * frame->wHeight / scan->max_area;
+  }
+
+  if (prefs->min_fps > 0)
+    fps_cost = (mode->fps - prefs->min_fps) / prefs->min_fps;
+  else
+    fps_cost = 1.0 - mode->fps / scan->max_fps;
+  if (fps_cost < 0)
+    fps_cost = 0;
+  if (fps_cost > 1)
+    fps_cost = 1;
+
+  /* resolution first, then format preference, then frame rate */
+  return 100.0 * res_cost + 10.0 * mode->score + fps_cost;
+}
+
+static int _uvc_mode_compare(const void *a, const void *b) {
+  const uvc_mode_candidate_t *ma = a, *mb = b;
+
+  if (ma->score != mb->score)
+    return ma->score < mb->score ? -1 : 1;
+  if (ma->bandwidth != mb->bandwidth)
+    return ma->bandwidth < mb->bandwidth ? -1 : 1;
+  /* keep descriptor order otherwise; modes are added in that order */
+  return ma->desc_index < mb->desc_index ? -1 : ma->desc_index > mb->desc_index;
+}
+
+/** @brief Score every streaming mode of a device against preferences
+ * @ingroup streaming
+ *
+ * Works from the parsed descriptors alone; nothing is sent to the device.
+ * Each frame descriptor contributes each of its discrete frame intervals,
+ * or, for a continuous range, its fastest interval and the slowest one
+ * that still meets prefs->min_fps. Modes that break a hard limit (format,
+ * minimum frame rate, bandwidth, aspect ratio) are left out; the rest are
+ * sorted by score, best first.
+ *
+ * @param devh Device handle
+ * @param prefs Preferences (see uvc_mode_prefs_t)
+ * @param[out] modes Where to store the best modes
+ * @param max_modes Size of @p modes
+ * @return Number of modes stored, or a uvc_error_t
+ */
+int uvc_rank_stream_modes(uvc_device_handle_t *devh, const uvc_mode_prefs_t *prefs,
+                          uvc_mode_candidate_t *modes, int max_modes) {
+  struct mode_scan scan;
+  uvc_streaming_interface_t *stream_if;
+  uvc_error_t ret = UVC_SUCCESS;
+  int i;
+
+  ret = uvc_scan_deferred_streaming(devh, -1);
+  if (ret != UVC_SUCCESS)
+    return ret;
+
+  memset(&scan, 0, sizeof(scan));
+  scan.prefs = prefs;
+
+  DL_FOREACH(devh->info->stream_ifs, stream_if) {
+    uvc_format_desc_t *format;
+
+    DL_FOREACH(stream_if->format_descs, format) {
+      uvc_frame_desc_t *frame;
+      int rank = _uvc_mode_format_rank(prefs, format);
+
+      if (rank < 0)
+        continue;
+
+      DL_FOREACH(format->frame_descs, frame) {
+        if (frame->intervals) {
+          uint32_t *interval;
+
+          for (interval = frame->intervals; *interval && ret == UVC_SUCCESS; ++interval)
+            ret = _uvc_mode_add(&scan, stream_if, frame, rank, *interval);
+        } else {
+          uint32_t fastest = frame->dwMinFrameInterval, slowest = fastest;
+
+          if (prefs->min_fps > 0) {
+            double limit = 10000000.0 / prefs->min_fps;
+
+            slowest = limit >= frame->dwMaxFrameInterval
+              ? frame->dwMaxFrameInterval : (uint32_t) limit;
+            if (slowest > fastest && frame->dwFrameIntervalStep)
+              slowest -= (slowest - fastest) % frame->dwFrameIntervalStep;
+          }
+
+          ret = _uvc_mode_add(&scan, stream_if, frame, rank, fastest);
+          if (ret == UVC_SUCCESS && slowest > fastest)
+            ret = _uvc_mode_add(&scan, stream_if, frame, rank, slowest);
+        }
+
+        if (ret != UVC_SUCCESS) {
+          free(scan.modes);
+          return ret;
+        }
+      }
+    }
+  }
+
+  for (i = 0; i < scan.num_modes; ++i)
+    scan.modes[i].score = _uvc_mode_score(&scan, &scan.modes[i]);
+  if (scan.num_modes)
+    qsort(scan.modes, scan.num_modes, sizeof(*scan.modes), _uvc_mode_compare);
+
+  if (max_modes > scan.num_modes)
+    max_modes = scan.num_modes;
+  if (max_modes > 0)
+    memcpy(modes, scan.modes, max_modes * sizeof(*modes));
+  free(scan.modes);
+
+  return max_modes > 0 ? max_modes : 0;
+}
+
+/** @brief Negotiate the best streaming mode for a set of preferences
+ * @ingroup streaming
+ *
+ * Ranks the device's modes with uvc_rank_stream_modes() and probes only
+ * the winner. If the device rejects it, the next best modes are tried in
+ * order, up to prefs->max_attempts in all. Each streaming interface is
+ * claimed and asked for its maximum values once, when its first candidate
+ * is probed.
+ *
+ * @param devh Device handle
+ * @param[out] ctrl Negotiated control block, ready for uvc_stream_open_ctrl()
+ * @param prefs Preferences (see uvc_mode_prefs_t)
+ * @param[out] chosen The mode that was negotiated, or NULL
+ * @return UVC_SUCCESS, UVC_ERROR_INVALID_MODE if no mode fits or the
+ * device took none of the candidates, or another error
+ */
+uvc_error_t uvc_select_stream_mode(uvc_device_handle_t *devh, uvc_stream_ctrl_t *ctrl,
+                                   const uvc_mode_prefs_t *prefs,
+                                   uvc_mode_candidate_t *chosen) {
+  uvc_mode_candidate_t *modes;
+  uvc_stream_ctrl_t max_ctrl;
+  int num_modes, attempts, i, max_if = -1;
+  uvc_error_t ret = UVC_ERROR_INVALID_MODE;
+
+  attempts = prefs->max_attempts > 0 ? prefs->max_attempts : MODE_DEFAULT_ATTEMPTS;
+  modes = malloc(attempts * sizeof(*modes));
+  if (!modes)
+    return UVC_ERROR_NO_MEM;
+
+  num_modes = uvc_rank_stream_modes(devh, prefs, modes, attempts);
+  if (num_modes < 0) {
+    free(modes);
+    return num_modes;
+  }
+
+  for (i = 0; i < num_modes; ++i) {
+    const uvc_mode_candidate_t *mode = &modes[i];
+
+    if (mode->bInterfaceNumber != max_if) {
+      memset(&max_ctrl, 0, sizeof(max_ctrl));
+      max_ctrl.bInterfaceNumber = mode->bInterfaceNumber;
+      UVC_DEBUG("claiming streaming interface %d", mode->bInterfaceNumber);
+      ret = uvc_claim_if(devh, mode->bInterfaceNumber);
+      if (ret != UVC_SUCCESS)
+        break;
+      uvc_query_stream_ctrl(devh, &max_ctrl, 1, UVC_GET_MAX);
+      max_if = mode->bInterfaceNumber;
+    }
+
+    *ctrl = max_ctrl;
+    ctrl->bmHint = (1 << 0); /* don't negotiate interval */
+    ctrl->bFormatIndex = mode->bFormatIndex;
+    ctrl->bFrameIndex = mode->bFrameIndex;
+    ctrl->dwFrameInterval = mode->dwFrameInterval;
+
+    ret = uvc_probe_stream_ctrl(devh, ctrl);
+    if (ret == UVC_SUCCESS) {
+      if (chosen)
+        *chosen = *mode;
+      break;
+    }
+
+    UVC_DEBUG("mode %dx%d @ %u rejected, trying the next",
+              mode->frame_desc->wWidth, mode->frame_desc->wHeight, mode->dwFrameInterval);
+  }
+
+  free(modes);
+
+  return ret;
+}
+
 /** Get a negotiated still control block for some common parameters.
  * @ingroup streaming
  *
@@ -611,6 +986,10 @@ uvc_error_t uvc_probe_stream_ctrl(
     uvc_stream_ctrl_t *ctrl) {
   uvc_stream_ctrl_t required_ctrl = *ctrl;
 
+  /* checked against the device when it is committed (see probe-cache.c) */
+  if (uvc_probe_cache_lookup(devh, ctrl) == UVC_SUCCESS)
+    return UVC_SUCCESS;
+
   uvc_query_stream_ctrl( devh, ctrl, 1, UVC_SET_CUR );
   uvc_query_stream_ctrl( devh, ctrl, 1, UVC_GET_CUR );
 
@@ -619,6 +998,8 @@ uvc_error_t uvc_probe_stream_ctrl(
     return UVC_ERROR_INVALID_MODE;
   }
 
+  uvc_probe_cache_store(devh, &required_ctrl, ctrl);
+
   return UVC_SUCCESS;
 }
 
@@ -711,6 +1092,26 @@ void save_payload_to_file(const uint8_t *payload, size_t header_len, const char*
 }
 
 
+/** @internal
+ * @brief Whether an iSight payload starts with a header
+ *
+ * Certain iSight cameras send header information in a packet with no image
+ * data, marked by a magic tag, and then packets with only image data and no
+ * headers until the next frame (see UVC_QUIRK_HEADER_ISIGHT).
+ *
+ * The iSight header: len(1), flags(1 or 2), 0x11 0x22 0x33 0x44 0xde 0xad
+ * 0xbe 0xef 0xde 0xad 0xfa 0xce
+ */
+static int _uvc_isight_header(const uint8_t *payload, size_t payload_len) {
+  static const uint8_t isight_tag[] = {
+    0x11, 0x22, 0x33, 0x44,
+    0xde, 0xad, 0xbe, 0xef, 0xde, 0xad, 0xfa, 0xce
+  };
+
+  return (payload_len >= 14 && !memcmp(isight_tag, payload + 2, sizeof(isight_tag))) ||
+         (payload_len >= 15 && !memcmp(isight_tag, payload + 3, sizeof(isight_tag)));
+}
+
 /** @internal
  * @brief Process a payload transfer
  * 
@@ -726,6 +1127,7 @@ void _uvc_process_payload(uvc_stream_handle_t *strmh, uint8_t *payload, size_t p
   size_t header_len;
   uint8_t header_info;
   size_t data_len;
+  int isight_header = 0;
 
   uint8_t payload_error_check = 0;
 
@@ -735,20 +1137,29 @@ void _uvc_process_payload(uvc_stream_handle_t *strmh, uint8_t *payload, size_t p
 
 
   // header length define
-  strmh->hle = payload[0];
+  if (strmh->devh->quirks.flags & UVC_QUIRK_HEADER_ISIGHT)
+    isight_header = _uvc_isight_header(payload, payload_len);
+
+  if ((strmh->devh->quirks.flags & UVC_QUIRK_HEADER_ISIGHT) && !isight_header) {
+    /* no iSight magic, so it's all image data */
+    strmh->hle = 0;
+  } else {
+    strmh->hle = payload[0];
+  }
 
   if (strmh->hle > payload_len) {
     printf("error packet: actual_len=%zu, header_len=%d\n", payload_len, strmh->hle);
     return;
   }
 
-  data_len = payload_len - strmh->hle;
+  /* what follows an iSight header is padding, not image data */
+  data_len = isight_header ? 0 : payload_len - strmh->hle;
 
   // valid hle
   if (strmh->hle < 2) {
     strmh->bfh = 0;
     }else {
-    if (strmh->hle > 14){
+    if (strmh->hle > 14 && !(strmh->devh->quirks.flags & UVC_QUIRK_HEADER_LENGTH)){
       strmh->frame.error_code = PAYLOAD_ERROR_BIG_HEADER_LENGTH;
       printf("error packet: header length too long");
       return;
@@ -772,7 +1183,9 @@ void _uvc_process_payload(uvc_stream_handle_t *strmh, uint8_t *payload, size_t p
     // fclose(file);
 
     //valid hle and pts, scr
-    if (strmh->bmbfh.bfh_pts && strmh->bmbfh.bfh_scr && strmh->hle != 0x0C) {
+    if (strmh->devh->quirks.flags & UVC_QUIRK_HEADER_LENGTH) {
+      /* the device pads its headers; lengths are not checked */
+    } else if (strmh->bmbfh.bfh_pts && strmh->bmbfh.bfh_scr && strmh->hle != 0x0C) {
       strmh->frame.error_code = PAYLOAD_ERROR_INVALID_HEADER_LENGTH;
       printf("invalid packet: pts&&scr but header length is not 0x0C \n");
       save_payload_to_file(payload, strmh->hle, "PAYLOAD_ERROR_INVALID_HEADER_LENGTH");
@@ -794,7 +1207,8 @@ void _uvc_process_payload(uvc_stream_handle_t *strmh, uint8_t *payload, size_t p
       // return;
     }
 
-    if (!strmh->bmbfh.bfh_eof){
+    if (!strmh->bmbfh.bfh_eof &&
+        !(strmh->devh->quirks.flags & UVC_QUIRK_HEADER_RESERVED)){
       if (strmh->bmbfh.bfh_res){
         strmh->frame.error_code = PAYLOAD_ERROR_RESERVED_BIT_SET;
         printf("invalid packet: reserved bit set \n");
@@ -915,8 +1329,11 @@ void LIBUSB_CALL _uvc_stream_callback(struct libusb_transfer *transfer) {
     UVC_DEBUG("not retrying transfer, status = %d", transfer->status);
     pthread_mutex_lock(&strmh->cb_mutex);
 
+    if (transfer->status == LIBUSB_TRANSFER_NO_DEVICE)
+      uvc_stream_resume_device_lost(strmh);
+
     /* Mark transfer as deleted. */
-    for(i=0; i < LIBUVC_NUM_TRANSFER_BUFS; i++) {
+    for(i=0; i < LIBUVC_MAX_TRANSFER_BUFS; i++) {
       if(strmh->transfers[i] == transfer) {
         UVC_DEBUG("Freeing transfer %d (%p)", i, transfer);
         free(transfer->buffer);
@@ -925,7 +1342,7 @@ void LIBUSB_CALL _uvc_stream_callback(struct libusb_transfer *transfer) {
         break;
       }
     }
-    if(i == LIBUVC_NUM_TRANSFER_BUFS ) {
+    if(i == LIBUVC_MAX_TRANSFER_BUFS ) {
       UVC_DEBUG("transfer %p not found; not freeing!", transfer);
     }
 
@@ -951,8 +1368,11 @@ void LIBUSB_CALL _uvc_stream_callback(struct libusb_transfer *transfer) {
         int i;
         pthread_mutex_lock(&strmh->cb_mutex);
 
+        if (libusbRet == LIBUSB_ERROR_NO_DEVICE)
+          uvc_stream_resume_device_lost(strmh);
+
         /* Mark transfer as deleted. */
-        for (i = 0; i < LIBUVC_NUM_TRANSFER_BUFS; i++) {
+        for (i = 0; i < LIBUVC_MAX_TRANSFER_BUFS; i++) {
           if (strmh->transfers[i] == transfer) {
             UVC_DEBUG("Freeing failed transfer %d (%p)", i, transfer);
             free(transfer->buffer);
@@ -961,7 +1381,7 @@ void LIBUSB_CALL _uvc_stream_callback(struct libusb_transfer *transfer) {
             break;
           }
         }
-        if (i == LIBUVC_NUM_TRANSFER_BUFS) {
+        if (i == LIBUVC_MAX_TRANSFER_BUFS) {
           UVC_DEBUG("failed transfer %p not found; not freeing!", transfer);
         }
 
@@ -973,7 +1393,7 @@ void LIBUSB_CALL _uvc_stream_callback(struct libusb_transfer *transfer) {
       pthread_mutex_lock(&strmh->cb_mutex);
 
       /* Mark transfer as deleted. */
-      for(i=0; i < LIBUVC_NUM_TRANSFER_BUFS; i++) {
+      for(i=0; i < LIBUVC_MAX_TRANSFER_BUFS; i++) {
         if(strmh->transfers[i] == transfer) {
           UVC_DEBUG("Freeing orphan transfer %d (%p)", i, transfer);
           free(transfer->buffer);
@@ -982,7 +1402,7 @@ void LIBUSB_CALL _uvc_stream_callback(struct libusb_transfer *transfer) {
           break;
         }
       }
-      if(i == LIBUVC_NUM_TRANSFER_BUFS ) {
+      if(i == LIBUVC_MAX_TRANSFER_BUFS ) {
         UVC_DEBUG("orphan transfer %p not found; not freeing!", transfer);
       }
 
@@ -1061,6 +1481,9 @@ static uvc_stream_handle_t *_uvc_get_stream_by_interface(uvc_device_handle_t *de
 static uvc_streaming_interface_t *_uvc_get_stream_if(uvc_device_handle_t *devh, int interface_idx) {
   uvc_streaming_interface_t *stream_if;
 
+  if (uvc_scan_deferred_streaming(devh, interface_idx) != UVC_SUCCESS)
+    return NULL;
+
   DL_FOREACH(devh->info->stream_ifs, stream_if) {
     if (stream_if->bInterfaceNumber == interface_idx)
       return stream_if;
@@ -1138,25 +1561,14 @@ fail:
   return ret;
 }
 
-/** Begin streaming video from the stream into the callback function.
- * @ingroup streaming
- *
- * @param strmh UVC stream
- * @param cb   User callback function. See {uvc_frame_callback_t} for restrictions.
- * @param flags Stream setup flags, currently undefined. Set this to zero. The lower bit
- * is reserved for backward compatibility.
+/** @internal
+ * @brief Select the altsetting for the committed mode and allocate transfers
  */
-uvc_error_t uvc_stream_start(
-    uvc_stream_handle_t *strmh,
-    uvc_frame_callback_t *cb,
-    void *user_ptr,
-    uint8_t flags
-) {
+static uvc_error_t _uvc_stream_alloc_transfers(uvc_stream_handle_t *strmh) {
   /* USB interface we'll be using */
   const struct libusb_interface *interface;
   int interface_id;
   char isochronous;
-  uvc_frame_desc_t *frame_desc;
   uvc_format_desc_t *format_desc;
   uvc_stream_ctrl_t *ctrl;
   uvc_error_t ret;
@@ -1166,32 +1578,15 @@ uvc_error_t uvc_stream_start(
   int transfer_id;
 
   ctrl = &strmh->cur_ctrl;
+  strmh->num_transfers = strmh->devh->quirks.num_transfers;
 
-  UVC_ENTER(); 
-
-  if (strmh->running) {
-    UVC_EXIT(UVC_ERROR_BUSY);
-    return UVC_ERROR_BUSY;
-  }
-
-  strmh->running = 1;
-  strmh->seq = 1;
-  strmh->fid = 0;
-  strmh->pts = 0;
-  strmh->last_scr = 0;
-
-  frame_desc = uvc_find_frame_desc_stream(strmh, ctrl->bFormatIndex, ctrl->bFrameIndex);
-  if (!frame_desc) {
-    ret = UVC_ERROR_INVALID_PARAM;
-    goto fail;
-  }
-  format_desc = frame_desc->parent;
+  /* resolved by uvc_stream_ctrl() */
+  if (!strmh->frame_desc)
+    return UVC_ERROR_INVALID_PARAM;
+  format_desc = strmh->frame_desc->parent;
 
-  strmh->frame_format = uvc_frame_format_for_guid(format_desc->guidFormat);
-  if (strmh->frame_format == UVC_FRAME_FORMAT_UNKNOWN) {
-    ret = UVC_ERROR_NOT_SUPPORTED;
-    goto fail;
-  }
+  if (strmh->frame_format == UVC_FRAME_FORMAT_UNKNOWN)
+    return UVC_ERROR_NOT_SUPPORTED;
 
   // Get the interface that provides the chosen format and frame configuration
   interface_id = strmh->stream_if->bInterfaceNumber;
@@ -1250,25 +1645,27 @@ uvc_error_t uvc_stream_start(
       }
 
       if (endpoint_bytes_per_packet >= config_bytes_per_packet) {
-        /* Transfers will be at most one frame long: Divide the maximum frame size
-         * by the size of the endpoint and round up */
-        packets_per_transfer = (ctrl->dwMaxVideoFrameSize +
-                                endpoint_bytes_per_packet - 1) / endpoint_bytes_per_packet;
-
-        /* But keep a reasonable limit: Otherwise we start dropping data */
-        if (packets_per_transfer > 32)
-          packets_per_transfer = 32;
-        
+        if (strmh->devh->quirks.packets_per_transfer) {
+          packets_per_transfer = strmh->devh->quirks.packets_per_transfer;
+        } else {
+          /* Transfers will be at most one frame long: Divide the maximum frame size
+           * by the size of the endpoint and round up */
+          packets_per_transfer = (ctrl->dwMaxVideoFrameSize +
+                                  endpoint_bytes_per_packet - 1) / endpoint_bytes_per_packet;
+
+          /* But keep a reasonable limit: Otherwise we start dropping data */
+          if (packets_per_transfer > 32)
+            packets_per_transfer = 32;
+        }
+
         total_transfer_size = packets_per_transfer * endpoint_bytes_per_packet;
         break;
       }
     }
 
     /* If we searched through all the altsettings and found nothing usable */
-    if (alt_idx == interface->num_altsetting) {
-      ret = UVC_ERROR_INVALID_MODE;
-      goto fail;
-    }
+    if (alt_idx == interface->num_altsetting)
+      return UVC_ERROR_INVALID_MODE;
 
     /* Select the altsetting */
     ret = libusb_set_interface_alt_setting(strmh->devh->usb_devh,
@@ -1276,11 +1673,11 @@ uvc_error_t uvc_stream_start(
                                            altsetting->bAlternateSetting);
     if (ret != UVC_SUCCESS) {
       UVC_DEBUG("libusb_set_interface_alt_setting failed");
-      goto fail;
+      return ret;
     }
 
     /* Set up the transfers */
-    for (transfer_id = 0; transfer_id < LIBUVC_NUM_TRANSFER_BUFS; ++transfer_id) {
+    for (transfer_id = 0; transfer_id < strmh->num_transfers; ++transfer_id) {
       transfer = libusb_alloc_transfer(packets_per_transfer);
       strmh->transfers[transfer_id] = transfer;      
       strmh->transfer_bufs[transfer_id] = malloc(total_transfer_size);
@@ -1293,31 +1690,38 @@ uvc_error_t uvc_stream_start(
       libusb_set_iso_packet_lengths(transfer, endpoint_bytes_per_packet);
     }
   } else {
-    for (transfer_id = 0; transfer_id < LIBUVC_NUM_TRANSFER_BUFS;
+    total_transfer_size = strmh->devh->quirks.bulk_transfer_size;
+    if (!total_transfer_size)
+      total_transfer_size = strmh->cur_ctrl.dwMaxPayloadTransferSize;
+
+    for (transfer_id = 0; transfer_id < strmh->num_transfers;
         ++transfer_id) {
       transfer = libusb_alloc_transfer(0);
       strmh->transfers[transfer_id] = transfer;
-      strmh->transfer_bufs[transfer_id] = malloc (
-          strmh->cur_ctrl.dwMaxPayloadTransferSize );
+      strmh->transfer_bufs[transfer_id] = malloc (total_transfer_size);
       libusb_fill_bulk_transfer ( transfer, strmh->devh->usb_devh,
           format_desc->parent->bEndpointAddress,
           strmh->transfer_bufs[transfer_id],
-          strmh->cur_ctrl.dwMaxPayloadTransferSize, _uvc_stream_callback,
+          total_transfer_size, _uvc_stream_callback,
           ( void* ) strmh, 5000 );
     }
   }
 
-  strmh->user_cb = cb;
-  strmh->user_ptr = user_ptr;
 
-  /* If the user wants it, set up a thread that calls the user's function
-   * with the contents of each frame.
-   */
-  if (cb) {
-    pthread_create(&strmh->cb_thread, NULL, _uvc_user_caller, (void*) strmh);
-  }
+  return UVC_SUCCESS;
+}
 
-  for (transfer_id = 0; transfer_id < LIBUVC_NUM_TRANSFER_BUFS;
+/** @internal
+ * @brief Submit the allocated transfers
+ *
+ * Transfers that fail to submit, and those after them, are freed.
+ *
+ * @return Number of transfers submitted
+ */
+static int _uvc_stream_submit_transfers(uvc_stream_handle_t *strmh) {
+  int transfer_id, ret;
+
+  for (transfer_id = 0; transfer_id < strmh->num_transfers;
       transfer_id++) {
     ret = libusb_submit_transfer(strmh->transfers[transfer_id]);
     if (ret != UVC_SUCCESS) {
@@ -1326,17 +1730,97 @@ uvc_error_t uvc_stream_start(
     }
   }
 
-  if ( ret != UVC_SUCCESS && transfer_id >= 0 ) {
-    for ( ; transfer_id < LIBUVC_NUM_TRANSFER_BUFS; transfer_id++) {
-      free ( strmh->transfers[transfer_id]->buffer );
-      libusb_free_transfer ( strmh->transfers[transfer_id]);
-      strmh->transfers[transfer_id] = 0;
+  if (transfer_id < strmh->num_transfers) {
+    int i;
+
+    /* the callback may already be freeing the submitted ones */
+    pthread_mutex_lock(&strmh->cb_mutex);
+    if (ret == LIBUSB_ERROR_NO_DEVICE)
+      uvc_stream_resume_device_lost(strmh);
+    for (i = transfer_id; i < strmh->num_transfers; i++) {
+      free ( strmh->transfers[i]->buffer );
+      libusb_free_transfer ( strmh->transfers[i]);
+      strmh->transfers[i] = 0;
     }
-    ret = UVC_SUCCESS;
+    pthread_cond_broadcast(&strmh->cb_cond);
+    pthread_mutex_unlock(&strmh->cb_mutex);
   }
 
+  return transfer_id;
+}
+
+/** @internal
+ * @brief Restart a running stream's transfers after uvc_reattach_device()
+ *
+ * The user callback thread and the frame sequence carry on; a frame that
+ * was being assembled when the device went away is dropped.
+ *
+ * @return UVC_ERROR_NO_DEVICE if no transfer could be submitted
+ */
+uvc_error_t uvc_stream_resume_transfers(uvc_stream_handle_t *strmh) {
+  uvc_error_t ret;
+
+  UVC_ENTER();
+
+  strmh->got_bytes = 0;
+  strmh->meta_got_bytes = 0;
+  strmh->fid = 0;
+
+  ret = _uvc_stream_alloc_transfers(strmh);
+  if (ret == UVC_SUCCESS && _uvc_stream_submit_transfers(strmh) == 0)
+    ret = UVC_ERROR_NO_DEVICE;
+
   UVC_EXIT(ret);
   return ret;
+}
+
+/** Begin streaming video from the stream into the callback function.
+ * @ingroup streaming
+ *
+ * @param strmh UVC stream
+ * @param cb   User callback function. See {uvc_frame_callback_t} for restrictions.
+ * @param flags Stream setup flags, currently undefined. Set this to zero. The lower bit
+ * is reserved for backward compatibility.
+ */
+uvc_error_t uvc_stream_start(
+    uvc_stream_handle_t *strmh,
+    uvc_frame_callback_t *cb,
+    void *user_ptr,
+    uint8_t flags
+) {
+  uvc_error_t ret;
+
+  UVC_ENTER(); 
+
+  if (strmh->running) {
+    UVC_EXIT(UVC_ERROR_BUSY);
+    return UVC_ERROR_BUSY;
+  }
+
+  strmh->running = 1;
+  strmh->seq = 1;
+  strmh->fid = 0;
+  strmh->pts = 0;
+  strmh->last_scr = 0;
+
+  ret = _uvc_stream_alloc_transfers(strmh);
+  if (ret != UVC_SUCCESS)
+    goto fail;
+
+  strmh->user_cb = cb;
+  strmh->user_ptr = user_ptr;
+
+  /* If the user wants it, set up a thread that calls the user's function
+   * with the contents of each frame.
+   */
+  if (cb) {
+    pthread_create(&strmh->cb_thread, NULL, _uvc_user_caller, (void*) strmh);
+  }
+
+  _uvc_stream_submit_transfers(strmh);
+
+  UVC_EXIT(UVC_SUCCESS);
+  return UVC_SUCCESS;
 fail:
   strmh->running = 0;
   UVC_EXIT(ret);
@@ -1401,44 +1885,12 @@ void *_uvc_user_caller(void *arg) {
  */
 void _uvc_populate_frame(uvc_stream_handle_t *strmh) { 
   uvc_frame_t *frame = &strmh->frame;
-  uvc_frame_desc_t *frame_desc;
-
-  /** @todo this stuff that hits the main config cache should really happen
-   * in start() so that only one thread hits these data. all of this stuff
-   * is going to be reopen_on_change anyway
-   */
-
-  frame_desc = uvc_find_frame_desc(strmh->devh, strmh->cur_ctrl.bFormatIndex,
-				   strmh->cur_ctrl.bFrameIndex);
 
+  /* the mode was resolved by _uvc_stream_set_mode() */
   frame->frame_format = strmh->frame_format;
-  
-  frame->width = frame_desc->wWidth;
-  frame->height = frame_desc->wHeight;
-  
-  switch (frame->frame_format) {
-  case UVC_FRAME_FORMAT_BGR:
-    frame->step = frame->width * 3;
-    break;
-  case UVC_FRAME_FORMAT_YUYV:
-    frame->step = frame->width * 2;
-    break;
-  case UVC_FRAME_FORMAT_NV12:
-    frame->step = frame->width;
-    break;
-  case UVC_FRAME_FORMAT_P010:
-    frame->step = frame->width * 2;
-        break;
-  case UVC_FRAME_FORMAT_MJPEG:
-    frame->step = 0;
-    break;
-  case UVC_FRAME_FORMAT_H264:
-    frame->step = 0;
-    break;
-  default:
-    frame->step = 0;
-    break;
-  }
+  frame->width = strmh->frame_desc->wWidth;
+  frame->height = strmh->frame_desc->wHeight;
+  frame->step = strmh->frame_step;
 
   frame->sequence = strmh->hold_seq;
   frame->capture_time_finished = strmh->capture_time_finished;
@@ -1569,25 +2021,28 @@ uvc_error_t uvc_stream_stop(uvc_stream_handle_t *strmh) {
   if (!strmh->running)
     return UVC_ERROR_INVALID_PARAM;
 
+  /* keeps a reattachment in progress from restarting the transfers */
+  uvc_stream_resume_lock(strmh);
   strmh->running = 0;
+  uvc_stream_resume_unlock(strmh);
 
   pthread_mutex_lock(&strmh->cb_mutex);
 
   /* Attempt to cancel any running transfers, we can't free them just yet because they aren't
    *   necessarily completed but they will be free'd in _uvc_stream_callback().
    */
-  for(i=0; i < LIBUVC_NUM_TRANSFER_BUFS; i++) {
+  for(i=0; i < LIBUVC_MAX_TRANSFER_BUFS; i++) {
     if(strmh->transfers[i] != NULL)
       libusb_cancel_transfer(strmh->transfers[i]);
   }
 
   /* Wait for transfers to complete/cancel */
   do {
-    for(i=0; i < LIBUVC_NUM_TRANSFER_BUFS; i++) {
+    for(i=0; i < LIBUVC_MAX_TRANSFER_BUFS; i++) {
       if(strmh->transfers[i] != NULL)
         break;
     }
-    if(i == LIBUVC_NUM_TRANSFER_BUFS )
+    if(i == LIBUVC_MAX_TRANSFER_BUFS )
       break;
     pthread_cond_wait(&strmh->cb_cond, &strmh->cb_mutex);
   } while(1);
@@ -1614,6 +2069,8 @@ uvc_error_t uvc_stream_stop(uvc_stream_handle_t *strmh) {
  * @param strmh UVC stream handle
  */
 void uvc_stream_close(uvc_stream_handle_t *strmh) {
+  uvc_stream_set_resume_enabled(strmh, 0, 0);
+
   if (strmh->running)
     uvc_stream_stop(strmh);
 
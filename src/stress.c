@@ -0,0 +1,351 @@
+/* uvc-stress: stream many cameras at once and report how each one keeps up.
+ *
+ * Opens every attached UVC device (or N synthetic devices with --virtual),
+ * negotiates the requested mode on each, streams them concurrently for a
+ * fixed duration and writes per-stream fps, dropped frames and payload
+ * errors, plus event-thread CPU time and process memory, as JSON.
+ */
+#include "libuvc/libuvc.h"
+#include "libuvc/libuvc_internal.h"
+#include "tools-common.h"
+
+#include <getopt.h>
+#include <unistd.h>
+
+struct stress_stream {
+  int index;
+  uvc_device_t *dev;
+  uvc_device_handle_t *devh;
+  uvc_stream_handle_t *strmh;
+  uvc_stream_ctrl_t ctrl;
+  uint16_t vid, pid;
+  char serial[64];
+  uint8_t bus, address;
+  uvc_error_t error;
+  const char *error_where;
+
+  /* written by the stream's callback thread only */
+  uint64_t frames;
+  uint64_t dropped;
+  uint64_t payload_errors;
+  uint64_t error_counts[TOOL_PAYLOAD_ERROR_SLOTS];
+  uint64_t bytes;
+  uint32_t last_seq;
+  double first_frame, last_frame;
+};
+
+static void stress_cb(uvc_frame_t *frame, void *ptr) {
+  struct stress_stream *s = ptr;
+  double now = tool_now();
+
+  if (s->frames == 0)
+    s->first_frame = now;
+  else if (frame->sequence > s->last_seq + 1)
+    s->dropped += frame->sequence - s->last_seq - 1;
+
+  s->last_seq = frame->sequence;
+  s->last_frame = now;
+  s->frames++;
+  s->bytes += frame->data_bytes;
+
+  if (frame->error_code != PAYLOAD_ERROR_NONE) {
+    s->payload_errors++;
+    s->error_counts[tool_payload_error_slot(frame->error_code)]++;
+    /* the error code is sticky until the consumer clears it */
+    frame->error_code = PAYLOAD_ERROR_NONE;
+  }
+}
+
+static void usage(const char *argv0) {
+  fprintf(stderr,
+          "Usage: %s [options]\n"
+          "  -f, --format NAME    any, yuyv, uyvy, nv12, gray8, bgr, mjpeg, h264 (default mjpeg)\n"
+          "  -s, --size WxH       frame size (default 1280x720)\n"
+          "  -r, --fps N          frame rate (default 30)\n"
+          "  -d, --duration SEC   streaming time (default 10)\n"
+          "  -n, --virtual N      stream N synthetic devices instead of real cameras\n"
+          "  -o, --output FILE    write JSON to FILE instead of stdout\n",
+          argv0);
+}
+
+static void stress_open_real(uvc_context_t *ctx, struct stress_stream **streams, int *count,
+                             enum uvc_frame_format format, int width, int height, int fps) {
+  uvc_device_t **list;
+  uvc_device_descriptor_t *desc;
+  int i, n = 0;
+
+  if (uvc_get_device_list(ctx, &list) != UVC_SUCCESS)
+    return;
+
+  while (list[n])
+    n++;
+
+  *streams = calloc(n ? n : 1, sizeof(**streams));
+  *count = n;
+
+  for (i = 0; i < n; ++i) {
+    struct stress_stream *s = &(*streams)[i];
+
+    s->index = i;
+    s->dev = list[i];
+    uvc_ref_device(s->dev);
+    s->bus = uvc_get_bus_number(s->dev);
+    s->address = uvc_get_device_address(s->dev);
+
+    if (uvc_get_device_descriptor(s->dev, &desc) == UVC_SUCCESS) {
+      s->vid = desc->idVendor;
+      s->pid = desc->idProduct;
+      if (desc->serialNumber)
+        snprintf(s->serial, sizeof(s->serial), "%s", desc->serialNumber);
+      uvc_free_device_descriptor(desc);
+    }
+
+    s->error = uvc_open(s->dev, &s->devh);
+    if (s->error != UVC_SUCCESS) {
+      s->error_where = "uvc_open";
+      s->devh = NULL;
+      continue;
+    }
+
+    s->error = uvc_get_stream_ctrl_format_size(s->devh, &s->ctrl, format, width, height, fps);
+    if (s->error != UVC_SUCCESS) {
+      s->error_where = "uvc_get_stream_ctrl_format_size";
+      continue;
+    }
+
+    s->error = uvc_start_streaming(s->devh, &s->ctrl, stress_cb, s, 0);
+    if (s->error != UVC_SUCCESS)
+      s->error_where = "uvc_start_streaming";
+  }
+
+  uvc_free_device_list(list, 1);
+}
+
+static void stress_open_virtual(uvc_context_t *ctx, struct stress_stream **streams, int count,
+                                enum uvc_frame_format format, int width, int height, int fps) {
+  int i;
+
+  *streams = calloc(count, sizeof(**streams));
+
+  if (format == UVC_FRAME_FORMAT_ANY)
+    format = UVC_FRAME_FORMAT_YUYV;
+
+  for (i = 0; i < count; ++i) {
+    struct stress_stream *s = &(*streams)[i];
+
+    s->index = i;
+    s->error = uvc_synthetic_open(ctx, format, width, height, 10000000 / fps, &s->devh);
+    if (s->error != UVC_SUCCESS) {
+      s->error_where = "uvc_synthetic_open";
+      s->devh = NULL;
+      continue;
+    }
+
+    s->error = uvc_synthetic_stream_start(s->devh, &s->strmh, stress_cb, s,
+                                          UVC_SYNTHETIC_PRODUCER);
+    if (s->error != UVC_SUCCESS) {
+      s->error_where = "uvc_synthetic_stream_start";
+      continue;
+    }
+    s->ctrl = s->strmh->cur_ctrl;
+  }
+}
+
+static void write_stream(FILE *fp, struct stress_stream *s, double duration) {
+  double span = s->last_frame - s->first_frame;
+  int i;
+
+  fprintf(fp, "    {\n      \"index\": %d,\n", s->index);
+  fprintf(fp, "      \"vid\": \"%04x\",\n      \"pid\": \"%04x\",\n", s->vid, s->pid);
+  fprintf(fp, "      \"serial\": ");
+  tool_json_string(fp, s->serial);
+  fprintf(fp, ",\n      \"bus\": %u,\n      \"address\": %u,\n", s->bus, s->address);
+
+  if (s->error != UVC_SUCCESS) {
+    fprintf(fp, "      \"error\": ");
+    tool_json_string(fp, uvc_strerror(s->error));
+    fprintf(fp, ",\n      \"error_where\": \"%s\"\n    }", s->error_where);
+    return;
+  }
+
+  fprintf(fp, "      \"format_index\": %u,\n      \"frame_index\": %u,\n"
+          "      \"frame_interval\": %u,\n      \"max_video_frame_size\": %u,\n"
+          "      \"max_payload_transfer_size\": %u,\n",
+          s->ctrl.bFormatIndex, s->ctrl.bFrameIndex, s->ctrl.dwFrameInterval,
+          s->ctrl.dwMaxVideoFrameSize, s->ctrl.dwMaxPayloadTransferSize);
+  fprintf(fp, "      \"frames\": %llu,\n", (unsigned long long) s->frames);
+  fprintf(fp, "      \"fps\": %.3f,\n",
+          s->frames > 1 && span > 0 ? (s->frames - 1) / span : s->frames / duration);
+  fprintf(fp, "      \"dropped\": %llu,\n", (unsigned long long) s->dropped);
+  fprintf(fp, "      \"bytes\": %llu,\n", (unsigned long long) s->bytes);
+  fprintf(fp, "      \"payload_errors\": %llu,\n", (unsigned long long) s->payload_errors);
+  fprintf(fp, "      \"payload_error_kinds\": {");
+  for (i = 1; i < TOOL_PAYLOAD_ERROR_SLOTS; ++i) {
+    fprintf(fp, "%s\"%s\": %llu", i > 1 ? ", " : "", tool_payload_error_name(i),
+            (unsigned long long) s->error_counts[i]);
+  }
+  fprintf(fp, "}");
+  if (s->devh && s->devh->synthetic) {
+    fprintf(fp, ",\n      \"payloads\": %llu",
+            (unsigned long long) s->devh->synthetic->payloads);
+  }
+  fprintf(fp, "\n    }");
+}
+
+int main(int argc, char **argv) {
+  static const struct option long_options[] = {
+    { "format", required_argument, NULL, 'f' },
+    { "size", required_argument, NULL, 's' },
+    { "fps", required_argument, NULL, 'r' },
+    { "duration", required_argument, NULL, 'd' },
+    { "virtual", required_argument, NULL, 'n' },
+    { "output", required_argument, NULL, 'o' },
+    { "help", no_argument, NULL, 'h' },
+    { NULL, 0, NULL, 0 }
+  };
+  enum uvc_frame_format format = UVC_FRAME_FORMAT_MJPEG;
+  int width = 1280, height = 720, fps = 30;
+  double duration = 10;
+  int virtual_count = 0;
+  const char *output = NULL;
+  uvc_context_t *ctx;
+  struct stress_stream *streams = NULL;
+  int count = 0, running = 0;
+  double start, elapsed, event_cpu = -1, process_cpu;
+  long rss_kb, peak_kb;
+  FILE *fp = stdout;
+  uvc_error_t res;
+  int opt, i;
+
+  while ((opt = getopt_long(argc, argv, "f:s:r:d:n:o:h", long_options, NULL)) != -1) {
+    switch (opt) {
+    case 'f':
+      if (tool_parse_format(optarg, &format)) {
+        fprintf(stderr, "unknown format '%s'\n", optarg);
+        return 1;
+      }
+      break;
+    case 's':
+      if (tool_parse_size(optarg, &width, &height)) {
+        fprintf(stderr, "bad size '%s'\n", optarg);
+        return 1;
+      }
+      break;
+    case 'r':
+      fps = atoi(optarg);
+      break;
+    case 'd':
+      duration = atof(optarg);
+      break;
+    case 'n':
+      virtual_count = atoi(optarg);
+      break;
+    case 'o':
+      output = optarg;
+      break;
+    default:
+      usage(argv[0]);
+      return opt == 'h' ? 0 : 1;
+    }
+  }
+
+  if (fps <= 0 || duration <= 0 || virtual_count < 0) {
+    usage(argv[0]);
+    return 1;
+  }
+
+  res = uvc_init(&ctx, NULL);
+  if (res < 0) {
+    uvc_perror(res, "uvc_init");
+    return 1;
+  }
+
+  if (virtual_count) {
+    count = virtual_count;
+    stress_open_virtual(ctx, &streams, count, format, width, height, fps);
+  } else {
+    stress_open_real(ctx, &streams, &count, format, width, height, fps);
+  }
+
+  for (i = 0; i < count; ++i) {
+    if (streams[i].error == UVC_SUCCESS)
+      running++;
+  }
+  fprintf(stderr, "streaming %d of %d %s device(s) for %.1f s\n",
+          running, count, virtual_count ? "synthetic" : "UVC", duration);
+
+  start = tool_now();
+  usleep((useconds_t) (duration * 1e6));
+  elapsed = tool_now() - start;
+
+  /* Sample thread CPU time before the threads go away. Real devices share
+   * the context's libusb event thread; synthetic devices each have a
+   * producer thread doing the same work. */
+  if (virtual_count) {
+    for (i = 0; i < count; ++i) {
+      double t;
+
+      if (!streams[i].devh || !streams[i].devh->synthetic->producer_running)
+        continue;
+      t = tool_thread_cpu(streams[i].devh->synthetic->producer);
+      if (t >= 0)
+        event_cpu = (event_cpu < 0 ? 0 : event_cpu) + t;
+    }
+  } else if (ctx->open_devices && ctx->own_usb_ctx) {
+    event_cpu = tool_thread_cpu(ctx->handler_thread);
+  }
+  process_cpu = tool_process_cpu();
+  tool_memory_kb(&rss_kb, &peak_kb);
+
+  for (i = 0; i < count; ++i) {
+    if (!streams[i].devh)
+      continue;
+    if (virtual_count) {
+      uvc_synthetic_close(streams[i].devh);
+    } else {
+      uvc_stop_streaming(streams[i].devh);
+    }
+  }
+
+  if (output) {
+    fp = fopen(output, "w");
+    if (!fp) {
+      perror(output);
+      fp = stdout;
+    }
+  }
+
+  fprintf(fp, "{\n  \"mode\": {\"format\": \"%s\", \"width\": %d, \"height\": %d, \"fps\": %d},\n",
+          tool_format_name(format), width, height, fps);
+  fprintf(fp, "  \"virtual\": %s,\n", virtual_count ? "true" : "false");
+  fprintf(fp, "  \"duration_s\": %.3f,\n", elapsed);
+  fprintf(fp, "  \"devices\": %d,\n  \"streaming\": %d,\n", count, running);
+  if (event_cpu >= 0)
+    fprintf(fp, "  \"event_thread_cpu_s\": %.6f,\n", event_cpu);
+  else
+    fprintf(fp, "  \"event_thread_cpu_s\": null,\n");
+  fprintf(fp, "  \"process_cpu_s\": %.6f,\n", process_cpu);
+  fprintf(fp, "  \"rss_kb\": %ld,\n  \"peak_rss_kb\": %ld,\n", rss_kb, peak_kb);
+  fprintf(fp, "  \"streams\": [\n");
+  for (i = 0; i < count; ++i) {
+    write_stream(fp, &streams[i], elapsed);
+    fprintf(fp, "%s\n", i + 1 < count ? "," : "");
+  }
+  fprintf(fp, "  ]\n}\n");
+
+  if (fp != stdout)
+    fclose(fp);
+
+  if (!virtual_count) {
+    for (i = 0; i < count; ++i) {
+      if (streams[i].devh)
+        uvc_close(streams[i].devh);
+      uvc_unref_device(streams[i].dev);
+    }
+  }
+
+  free(streams);
+  uvc_exit(ctx);
+
+  return running == count && count > 0 ? 0 : 2;
+}
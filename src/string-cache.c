@@ -0,0 +1,308 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (C) 2010-2012 Ken Tossell
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the author nor other contributors may be
+*     used to endorse or promote products derived from this software
+*     without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+/**
+ * @internal
+ * @file string-cache.c
+ * @brief Per-context cache of device string descriptors.
+ *
+ * The manufacturer, product and serial number strings can only be read by
+ * opening the device and sending it string descriptor requests, which takes
+ * several milliseconds per device. uvc_get_device_descriptor() and the
+ * serial number lookups of uvc_find_device(), uvc_find_devices() and the
+ * device index therefore keep the strings of every device they have asked,
+ * for as long as the context lives.
+ *
+ * An entry belongs to one attachment of one device: it is keyed by bus,
+ * port path and device address together with the vendor and product IDs
+ * and bcdDevice. The address changes whenever a device is plugged in, so a
+ * different camera on the same port never inherits its predecessor's
+ * strings.
+ *
+ * When several devices have to be asked at once, uvc_string_cache_prefetch()
+ * opens them from a few threads in parallel instead of one after another.
+ */
+#include "libuvc/libuvc.h"
+#include "libuvc/libuvc_internal.h"
+
+#define STRING_CACHE_MAX_DEPTH 8
+/* Entries kept per context; the oldest goes first */
+#define STRING_CACHE_MAX_ENTRIES 128
+/* Devices opened at the same time by uvc_string_cache_prefetch() */
+#define STRING_FETCH_THREADS 8
+
+struct uvc_string_cache_entry {
+  struct uvc_string_cache_entry *prev, *next;
+  uint16_t vid, pid, bcd;
+  uint8_t bus, address;
+  uint8_t num_ports;
+  uint8_t ports[STRING_CACHE_MAX_DEPTH];
+  char *manufacturer;
+  char *product;
+  char *serial;
+};
+
+/* Identity of one attachment of @p dev */
+static void string_cache_key(uvc_device_t *dev, const struct libusb_device_descriptor *desc,
+                             struct uvc_string_cache_entry *key) {
+  int n;
+
+  memset(key, 0, sizeof(*key));
+  key->vid = desc->idVendor;
+  key->pid = desc->idProduct;
+  key->bcd = desc->bcdDevice;
+  key->bus = libusb_get_bus_number(dev->usb_dev);
+  key->address = libusb_get_device_address(dev->usb_dev);
+  n = libusb_get_port_numbers(dev->usb_dev, key->ports, STRING_CACHE_MAX_DEPTH);
+  key->num_ports = n > 0 ? n : 0;
+}
+
+static int string_cache_same(const struct uvc_string_cache_entry *a,
+                             const struct uvc_string_cache_entry *b) {
+  return a->vid == b->vid && a->pid == b->pid && a->bcd == b->bcd &&
+         a->bus == b->bus && a->address == b->address && a->num_ports == b->num_ports &&
+         !memcmp(a->ports, b->ports, a->num_ports);
+}
+
+static char *string_dup(const char *s) {
+  return s ? strdup(s) : NULL;
+}
+
+/** @internal
+ * @brief Look up a device's strings without asking the device
+ *
+ * Each of @p manufacturer, @p product and @p serial may be NULL; the strings
+ * stored through the others are copies for the caller to free, or NULL if
+ * the device does not have them.
+ *
+ * @return UVC_SUCCESS, or UVC_ERROR_NOT_FOUND if the device has not been asked
+ */
+uvc_error_t uvc_string_cache_lookup(uvc_device_t *dev, const struct libusb_device_descriptor *desc,
+                                    char **manufacturer, char **product, char **serial) {
+  uvc_context_t *ctx = dev->ctx;
+  struct uvc_string_cache_entry key, *entry;
+
+  string_cache_key(dev, desc, &key);
+
+  pthread_mutex_lock(&ctx->string_cache_mutex);
+  DL_FOREACH(ctx->string_cache, entry) {
+    if (string_cache_same(entry, &key))
+      break;
+  }
+  if (entry) {
+    if (manufacturer)
+      *manufacturer = string_dup(entry->manufacturer);
+    if (product)
+      *product = string_dup(entry->product);
+    if (serial)
+      *serial = string_dup(entry->serial);
+  }
+  pthread_mutex_unlock(&ctx->string_cache_mutex);
+
+  return entry ? UVC_SUCCESS : UVC_ERROR_NOT_FOUND;
+}
+
+static char *string_fetch(libusb_device_handle *usb_devh, uint8_t index) {
+  unsigned char buf[256];
+  int len;
+
+  if (!index)
+    return NULL;
+
+  len = libusb_get_string_descriptor_ascii(usb_devh, index, buf, sizeof(buf) - 1);
+  if (len <= 0)
+    return NULL;
+
+  buf[len] = '\0';
+  return strdup((const char *) buf);
+}
+
+/** @internal
+ * @brief Get a device's strings, asking the device if they are not cached
+ *
+ * Arguments and results as for uvc_string_cache_lookup(). Devices that
+ * cannot be opened are not cached, so they are asked again next time.
+ *
+ * @return UVC_SUCCESS, or the error from opening the device
+ */
+uvc_error_t uvc_string_cache_fetch(uvc_device_t *dev, const struct libusb_device_descriptor *desc,
+                                   char **manufacturer, char **product, char **serial) {
+  uvc_context_t *ctx = dev->ctx;
+  struct uvc_string_cache_entry *entry, *old;
+  libusb_device_handle *usb_devh;
+  uvc_error_t ret;
+
+  if (uvc_string_cache_lookup(dev, desc, manufacturer, product, serial) == UVC_SUCCESS)
+    return UVC_SUCCESS;
+
+  ret = libusb_open(dev->usb_dev, &usb_devh);
+  if (ret != UVC_SUCCESS)
+    return ret;
+
+  entry = calloc(1, sizeof(*entry));
+  if (!entry) {
+    libusb_close(usb_devh);
+    return UVC_ERROR_NO_MEM;
+  }
+
+  string_cache_key(dev, desc, entry);
+  entry->serial = string_fetch(usb_devh, desc->iSerialNumber);
+  entry->manufacturer = string_fetch(usb_devh, desc->iManufacturer);
+  entry->product = string_fetch(usb_devh, desc->iProduct);
+  libusb_close(usb_devh);
+
+  if (manufacturer)
+    *manufacturer = string_dup(entry->manufacturer);
+  if (product)
+    *product = string_dup(entry->product);
+  if (serial)
+    *serial = string_dup(entry->serial);
+
+  pthread_mutex_lock(&ctx->string_cache_mutex);
+  /* another thread may have asked the same device meanwhile */
+  DL_FOREACH(ctx->string_cache, old) {
+    if (string_cache_same(old, entry))
+      break;
+  }
+  if (old) {
+    DL_DELETE(ctx->string_cache, old);
+  } else if (ctx->string_cache_size == STRING_CACHE_MAX_ENTRIES) {
+    old = ctx->string_cache;
+    DL_DELETE(ctx->string_cache, old);
+  } else {
+    ctx->string_cache_size++;
+  }
+  DL_APPEND(ctx->string_cache, entry);
+  pthread_mutex_unlock(&ctx->string_cache_mutex);
+
+  if (old) {
+    free(old->manufacturer);
+    free(old->product);
+    free(old->serial);
+    free(old);
+  }
+
+  return UVC_SUCCESS;
+}
+
+struct string_prefetch {
+  uvc_device_t **devs;
+  int num_devs;
+  int next;
+  pthread_mutex_t mutex;
+};
+
+static void *string_prefetch_thread(void *arg) {
+  struct string_prefetch *pf = arg;
+
+  for (;;) {
+    struct libusb_device_descriptor desc;
+    int i;
+
+    pthread_mutex_lock(&pf->mutex);
+    i = pf->next++;
+    pthread_mutex_unlock(&pf->mutex);
+
+    if (i >= pf->num_devs)
+      break;
+
+    if (libusb_get_device_descriptor(pf->devs[i]->usb_dev, &desc) == LIBUSB_SUCCESS)
+      uvc_string_cache_fetch(pf->devs[i], &desc, NULL, NULL, NULL);
+  }
+
+  return NULL;
+}
+
+/** @internal
+ * @brief Make sure the strings of several devices are cached
+ *
+ * Devices not in the cache yet are opened from up to STRING_FETCH_THREADS
+ * threads at once, so asking a dozen identical cameras for their serial
+ * numbers takes about as long as asking one or two.
+ *
+ * @param devs Devices to ask
+ * @param num_devs Number of entries in @p devs
+ */
+void uvc_string_cache_prefetch(uvc_device_t **devs, int num_devs) {
+  struct string_prefetch pf;
+  pthread_t threads[STRING_FETCH_THREADS];
+  int num_threads = 0, i;
+
+  memset(&pf, 0, sizeof(pf));
+  pf.devs = malloc(num_devs * sizeof(*pf.devs));
+  if (!pf.devs)
+    return;
+
+  for (i = 0; i < num_devs; ++i) {
+    struct libusb_device_descriptor desc;
+
+    if (libusb_get_device_descriptor(devs[i]->usb_dev, &desc) == LIBUSB_SUCCESS &&
+        uvc_string_cache_lookup(devs[i], &desc, NULL, NULL, NULL) != UVC_SUCCESS)
+      pf.devs[pf.num_devs++] = devs[i];
+  }
+
+  if (pf.num_devs > 1) {
+    pthread_mutex_init(&pf.mutex, NULL);
+
+    for (i = 0; i < STRING_FETCH_THREADS && i < pf.num_devs; ++i) {
+      if (pthread_create(&threads[num_threads], NULL, string_prefetch_thread, &pf))
+        break;
+      num_threads++;
+    }
+    /* this thread helps, and carries on alone if no thread could start */
+    string_prefetch_thread(&pf);
+
+    for (i = 0; i < num_threads; ++i)
+      pthread_join(threads[i], NULL);
+
+    pthread_mutex_destroy(&pf.mutex);
+  }
+
+  free(pf.devs);
+}
+
+/** @internal
+ * @brief Drop the context's cached strings
+ */
+void uvc_string_cache_free(uvc_context_t *ctx) {
+  struct uvc_string_cache_entry *entry, *tmp;
+
+  DL_FOREACH_SAFE(ctx->string_cache, entry, tmp) {
+    DL_DELETE(ctx->string_cache, entry);
+    free(entry->manufacturer);
+    free(entry->product);
+    free(entry->serial);
+    free(entry);
+  }
+  ctx->string_cache_size = 0;
+}
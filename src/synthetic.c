@@ -0,0 +1,861 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (C) 2010-2012 Ken Tossell
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the name of the author nor other contributors may be
+*     used to endorse or promote products derived from this software
+*     without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+/**
+ * @internal
+ * @file synthetic.c
+ * @brief In-memory UVC devices that feed generated payloads into the
+ * normal stream path.
+ *
+ * A synthetic device has a parsed descriptor tree with one streaming
+ * interface, one format and one frame, but no USB device behind it.
+ * Payloads are handed straight to _uvc_process_payload(), so frame
+ * assembly, header validation and the user callback thread behave as
+ * they do for a real camera. Tools use this to measure and exercise the
+ * library without hardware.
+ *
+ * The device also has a camera terminal and a processing unit carrying
+ * every standard control in uvc_ctrl_defs, and an extension unit with
+ * four controls of 1, 2, 4 and 16 bytes. uvc_get_ctrl() and
+ * uvc_set_ctrl() answer these from memory, after an optional delay that
+ * stands in for the USB round trip. Optionally, brightness, gain and
+ * exposure changes brighten or darken the producer's image after a
+ * pipeline delay, the way a sensor would.
+ */
+#include "libuvc/libuvc.h"
+#include "libuvc/libuvc_internal.h"
+#include <time.h>
+#include <errno.h>
+
+/** Size of the payload header emitted by the generator (PTS and SCR present) */
+#define SYNTHETIC_HEADER_LEN 12
+
+#define SYNTHETIC_TERMINAL_ID 1
+#define SYNTHETIC_PROCESSING_UNIT_ID 2
+#define SYNTHETIC_EXTENSION_UNIT_ID 3
+#define SYNTHETIC_CTRL_MAX_LEN 16
+/** Largest change of the image's luma offset from one frame to the next */
+#define SYNTHETIC_LUMA_STEP 8
+
+/** Emulated control: capabilities and the values a device would report */
+typedef struct uvc_synthetic_ctrl {
+  uint8_t unit;
+  uint8_t selector;
+  uint8_t length;
+  uint8_t info;
+  uint8_t min[SYNTHETIC_CTRL_MAX_LEN];
+  uint8_t max[SYNTHETIC_CTRL_MAX_LEN];
+  uint8_t res[SYNTHETIC_CTRL_MAX_LEN];
+  uint8_t def[SYNTHETIC_CTRL_MAX_LEN];
+  uint8_t cur[SYNTHETIC_CTRL_MAX_LEN];
+} uvc_synthetic_ctrl_t;
+
+/** Lengths of the extension unit's controls, selectors 1 up */
+static const uint8_t _synthetic_xu_lengths[] = { 1, 2, 4, 16 };
+
+static const uint8_t _synthetic_guid_suffix[12] = {
+  0x00, 0x00, 0x10, 0x00, 0x80, 0x00, 0x00, 0xaa, 0x00, 0x38, 0x9b, 0x71
+};
+
+/** @internal
+ * @brief Describe how a synthetic frame of the given format is laid out
+ *
+ * @param[out] fourcc Four-character code for uncompressed formats
+ * @param[out] bpp Bits per pixel, 0 for compressed formats
+ * @return UVC_SUCCESS or UVC_ERROR_NOT_SUPPORTED
+ */
+static uvc_error_t _uvc_synthetic_format_info(enum uvc_frame_format format,
+                                              const char **fourcc,
+                                              uint8_t *bpp) {
+  switch (format) {
+  case UVC_FRAME_FORMAT_YUYV:
+    *fourcc = "YUY2";
+    *bpp = 16;
+    break;
+  case UVC_FRAME_FORMAT_UYVY:
+    *fourcc = "UYVY";
+    *bpp = 16;
+    break;
+  case UVC_FRAME_FORMAT_NV12:
+    *fourcc = "NV12";
+    *bpp = 12;
+    break;
+  case UVC_FRAME_FORMAT_GRAY8:
+    *fourcc = "Y800";
+    *bpp = 8;
+    break;
+  case UVC_FRAME_FORMAT_BGR:
+    *fourcc = "BGR3";
+    *bpp = 24;
+    break;
+  case UVC_FRAME_FORMAT_MJPEG:
+    *fourcc = "MJPG";
+    *bpp = 0;
+    break;
+  default:
+    return UVC_ERROR_NOT_SUPPORTED;
+  }
+
+  return UVC_SUCCESS;
+}
+
+static int _uvc_synthetic_clamp(int v) {
+  return v < 0 ? 0 : v > 255 ? 255 : v;
+}
+
+/** @internal
+ * @brief Fill the synthetic frame with a deterministic test pattern
+ */
+static void _uvc_synthetic_fill_pattern(uvc_synthetic_device_t *synth) {
+  uint8_t *p = synth->image;
+  size_t i;
+
+#define SYNTHETIC_LUMA(i) \
+  ((uint8_t) _uvc_synthetic_clamp((int) ((i) % synth->width % 256) + synth->luma_offset))
+
+  switch (synth->format) {
+  case UVC_FRAME_FORMAT_YUYV:
+    for (i = 0; i + 1 < synth->image_bytes; i += 2) {
+      p[i] = SYNTHETIC_LUMA(i / 2);
+      p[i + 1] = 128;
+    }
+    break;
+  case UVC_FRAME_FORMAT_UYVY:
+    for (i = 0; i + 1 < synth->image_bytes; i += 2) {
+      p[i] = 128;
+      p[i + 1] = SYNTHETIC_LUMA(i / 2);
+    }
+    break;
+  default:
+    for (i = 0; i < synth->image_bytes; ++i)
+      p[i] = SYNTHETIC_LUMA(i);
+    break;
+  }
+
+#undef SYNTHETIC_LUMA
+}
+
+/* Each byte of a control ranges from 0 to 0x7f in steps of 1 (in the first
+ * byte), and starts at its default of 0x40. */
+static void _uvc_synthetic_init_ctrl(uvc_synthetic_ctrl_t *ctrl, uint8_t unit,
+                                     uint8_t selector, uint8_t length) {
+  ctrl->unit = unit;
+  ctrl->selector = selector;
+  ctrl->length = length;
+  ctrl->info = UVC_CONTROL_CAP_GET | UVC_CONTROL_CAP_SET;
+  memset(ctrl->max, 0x7f, length);
+  ctrl->res[0] = 1;
+  memset(ctrl->def, 0x40, length);
+  memcpy(ctrl->cur, ctrl->def, length);
+}
+
+/** @internal
+ * @brief Give a synthetic device a camera terminal and a processing unit
+ * with every standard control on them, and an extension unit with a few
+ * controls of different lengths
+ */
+static uvc_error_t _uvc_synthetic_add_controls(uvc_device_handle_t *devh) {
+  uvc_synthetic_device_t *synth = devh->synthetic;
+  uvc_input_terminal_t *term = &devh->info->arena->input_terms[0];
+  uvc_processing_unit_t *proc = &devh->info->arena->processing_units[0];
+  uvc_extension_unit_t *ext = &devh->info->arena->extension_units[0];
+  size_t i;
+
+  term->bTerminalID = SYNTHETIC_TERMINAL_ID;
+  term->wTerminalType = UVC_ITT_CAMERA;
+  DL_APPEND(devh->info->ctrl_if.input_term_descs, term);
+
+  proc->bUnitID = SYNTHETIC_PROCESSING_UNIT_ID;
+  proc->bSourceID = SYNTHETIC_TERMINAL_ID;
+  DL_APPEND(devh->info->ctrl_if.processing_unit_descs, proc);
+
+  ext->bUnitID = SYNTHETIC_EXTENSION_UNIT_ID;
+  memcpy(ext->guidExtensionCode, "libuvc-synthetic", 16);
+  DL_APPEND(devh->info->ctrl_if.extension_unit_descs, ext);
+
+  synth->ctrls = calloc(uvc_ctrl_def_count + sizeof(_synthetic_xu_lengths),
+                        sizeof(*synth->ctrls));
+  if (!synth->ctrls)
+    return UVC_ERROR_NO_MEM;
+
+  for (i = 0; i < uvc_ctrl_def_count; ++i) {
+    const uvc_ctrl_def_t *def = &uvc_ctrl_defs[i];
+    uint8_t unit;
+
+    if (def->length > SYNTHETIC_CTRL_MAX_LEN)
+      continue;
+
+    if (def->unit_type == UVC_CTRL_UNIT_CAMERA_TERMINAL) {
+      term->bmControls |= 1ULL << (def->selector - 1);
+      unit = SYNTHETIC_TERMINAL_ID;
+    } else if (def->unit_type == UVC_CTRL_UNIT_PROCESSING_UNIT) {
+      proc->bmControls |= 1ULL << (def->selector - 1);
+      unit = SYNTHETIC_PROCESSING_UNIT_ID;
+    } else {
+      continue;
+    }
+
+    _uvc_synthetic_init_ctrl(&synth->ctrls[synth->num_ctrls++], unit, def->selector,
+                             def->length);
+  }
+
+  for (i = 0; i < sizeof(_synthetic_xu_lengths); ++i) {
+    ext->bmControls |= 1ULL << i;
+    _uvc_synthetic_init_ctrl(&synth->ctrls[synth->num_ctrls++], SYNTHETIC_EXTENSION_UNIT_ID,
+                             (uint8_t) (i + 1), _synthetic_xu_lengths[i]);
+  }
+
+  return UVC_SUCCESS;
+}
+
+/** @internal
+ * @brief Create an in-memory device that streams a single mode
+ *
+ * The handle is not added to the context's list of open devices and must
+ * be released with uvc_synthetic_close(), not uvc_close().
+ *
+ * @param ctx Context the device pretends to belong to
+ * @param format Frame format to advertise (YUYV, UYVY, NV12, GRAY8, BGR or MJPEG)
+ * @param width Frame width in pixels
+ * @param height Frame height in pixels
+ * @param interval Frame interval in 100ns units; 0 generates frames as fast as possible
+ * @param[out] devhp Handle on the new device
+ */
+uvc_error_t uvc_synthetic_open(
+    uvc_context_t *ctx,
+    enum uvc_frame_format format,
+    uint16_t width,
+    uint16_t height,
+    uint32_t interval,
+    uvc_device_handle_t **devhp) {
+  uvc_device_handle_t *devh = NULL;
+  uvc_synthetic_device_t *synth;
+  struct uvc_desc_counts counts;
+  uvc_streaming_interface_t *stream_if;
+  uvc_format_desc_t *format_desc;
+  uvc_frame_desc_t *frame_desc;
+  const char *fourcc;
+  uint8_t bpp;
+  uvc_error_t ret;
+
+  UVC_ENTER();
+
+  ret = _uvc_synthetic_format_info(format, &fourcc, &bpp);
+  if (ret != UVC_SUCCESS || width == 0 || height == 0) {
+    ret = ret != UVC_SUCCESS ? ret : UVC_ERROR_INVALID_PARAM;
+    UVC_EXIT(ret);
+    return ret;
+  }
+
+  devh = calloc(1, sizeof(*devh));
+  if (!devh)
+    goto fail_mem;
+  uvc_ctrl_cache_init(devh);
+  uvc_ctrl_async_init(devh);
+  uvc_status_init(devh);
+  pthread_mutex_init(&devh->info_mutex, NULL);
+  pthread_mutex_init(&devh->ctrl_writer_mutex, NULL);
+  pthread_rwlock_init(&devh->usb_devh_lock, NULL);
+
+  devh->dev = calloc(1, sizeof(*devh->dev));
+  devh->info = calloc(1, sizeof(*devh->info));
+  devh->synthetic = synth = calloc(1, sizeof(*synth));
+  if (synth) {
+    pthread_mutex_init(&synth->ctrl_mutex, NULL);
+    pthread_mutex_init(&synth->image_mutex, NULL);
+  }
+  if (!devh->dev || !devh->info || !synth)
+    goto fail_mem;
+
+  devh->dev->ctx = ctx;
+  devh->dev->ref = 1;
+  uvc_quirks_lookup(ctx, 0, 0, -1, &devh->quirks);
+
+  /* the same single block of nodes uvc_scan_control() would allocate */
+  memset(&counts, 0, sizeof(counts));
+  counts.input_terms = counts.processing_units = counts.extension_units = 1;
+  counts.stream_ifs = counts.formats = counts.frames = 1;
+  counts.intervals = 2;
+  counts.frame_index = 1;
+  devh->info->arena = uvc_desc_arena_alloc(&counts);
+  if (!devh->info->arena)
+    goto fail_mem;
+  devh->info->arena->used = counts;
+
+  devh->info->ctrl_if.parent = devh->info;
+  devh->info->ctrl_if.bcdUVC = 0x0110;
+  devh->info->ctrl_if.dwClockFrequency = 48000000;
+  if (_uvc_synthetic_add_controls(devh) != UVC_SUCCESS)
+    goto fail_mem;
+
+  stream_if = &devh->info->arena->stream_ifs[0];
+  stream_if->parent = devh->info;
+  stream_if->bInterfaceNumber = 1;
+  stream_if->bEndpointAddress = 0x81;
+  DL_APPEND(devh->info->stream_ifs, stream_if);
+
+  format_desc = &devh->info->arena->formats[0];
+  format_desc->parent = stream_if;
+  format_desc->bFormatIndex = 1;
+  format_desc->bNumFrameDescriptors = 1;
+  format_desc->bDefaultFrameIndex = 1;
+  if (format == UVC_FRAME_FORMAT_MJPEG) {
+    format_desc->bDescriptorSubtype = UVC_VS_FORMAT_MJPEG;
+    memcpy(format_desc->fourccFormat, fourcc, 4);
+  } else {
+    format_desc->bDescriptorSubtype = UVC_VS_FORMAT_UNCOMPRESSED;
+    memcpy(format_desc->guidFormat, fourcc, 4);
+    memcpy(format_desc->guidFormat + 4, _synthetic_guid_suffix, 12);
+    format_desc->bBitsPerPixel = bpp;
+  }
+  DL_APPEND(stream_if->format_descs, format_desc);
+
+  frame_desc = &devh->info->arena->frames[0];
+  frame_desc->parent = format_desc;
+  frame_desc->bDescriptorSubtype = format == UVC_FRAME_FORMAT_MJPEG
+    ? UVC_VS_FRAME_MJPEG : UVC_VS_FRAME_UNCOMPRESSED;
+  frame_desc->bFrameIndex = 1;
+  frame_desc->wWidth = width;
+  frame_desc->wHeight = height;
+  /* MJPEG frames are bounded by the size of the equivalent YUYV frame */
+  frame_desc->dwMaxVideoFrameBufferSize = (uint32_t) width * height * (bpp ? bpp : 16) / 8;
+  frame_desc->dwDefaultFrameInterval = interval;
+  frame_desc->bFrameIntervalType = 1;
+  frame_desc->intervals = devh->info->arena->intervals;
+  frame_desc->intervals[0] = interval;
+  DL_APPEND(format_desc->frame_descs, frame_desc);
+  uvc_index_frames(devh->info, devh->info->arena->frame_index, counts.frame_index);
+
+  synth->format = format;
+  synth->width = width;
+  synth->height = height;
+  synth->interval = interval;
+  synth->max_payload = 3 * 1024;
+  synth->image_bytes = frame_desc->dwMaxVideoFrameBufferSize;
+  synth->image = malloc(synth->image_bytes);
+  if (!synth->image)
+    goto fail_mem;
+  _uvc_synthetic_fill_pattern(synth);
+
+  *devhp = devh;
+
+  UVC_EXIT(UVC_SUCCESS);
+  return UVC_SUCCESS;
+
+fail_mem:
+  if (devh)
+    uvc_synthetic_close(devh);
+  UVC_EXIT(UVC_ERROR_NO_MEM);
+  return UVC_ERROR_NO_MEM;
+}
+
+/** @internal
+ * @brief Replace the frame the producer emits
+ *
+ * Useful for compressed formats, where the default test pattern is not a
+ * decodable image. Frames longer than the advertised maximum are rejected.
+ */
+uvc_error_t uvc_synthetic_set_frame(uvc_device_handle_t *devh,
+                                    const uint8_t *data, size_t data_bytes) {
+  uvc_synthetic_device_t *synth = devh->synthetic;
+
+  if (!synth || data_bytes == 0 ||
+      data_bytes > devh->info->stream_ifs->format_descs->frame_descs->dwMaxVideoFrameBufferSize)
+    return UVC_ERROR_INVALID_PARAM;
+
+  pthread_mutex_lock(&synth->image_mutex);
+  memcpy(synth->image, data, data_bytes);
+  synth->image_bytes = data_bytes;
+  synth->custom_image = 1;
+  pthread_mutex_unlock(&synth->image_mutex);
+
+  return UVC_SUCCESS;
+}
+
+/** @internal
+ * @brief Set the largest payload the generator emits, header included
+ *
+ * Defaults to 3072 bytes, the size of a high-bandwidth high-speed
+ * isochronous packet. Must be called before the stream is started.
+ */
+uvc_error_t uvc_synthetic_set_max_payload(uvc_device_handle_t *devh, size_t max_payload) {
+  if (!devh->synthetic || max_payload <= SYNTHETIC_HEADER_LEN)
+    return UVC_ERROR_INVALID_PARAM;
+
+  devh->synthetic->max_payload = max_payload;
+
+  return UVC_SUCCESS;
+}
+
+/** @internal
+ * @brief Override the advertised maximum frame size (dwMaxVideoFrameSize)
+ *
+ * For replaying traffic from devices whose frames exceed the size implied
+ * by the format and resolution. Must be called before the stream is started.
+ */
+uvc_error_t uvc_synthetic_set_max_frame_size(uvc_device_handle_t *devh, uint32_t max_frame_size) {
+  uvc_synthetic_device_t *synth = devh->synthetic;
+  uvc_frame_desc_t *frame_desc;
+  uint8_t *image;
+
+  if (!synth || devh->streams || max_frame_size == 0)
+    return UVC_ERROR_INVALID_PARAM;
+
+  frame_desc = devh->info->stream_ifs->format_descs->frame_descs;
+  if (max_frame_size > frame_desc->dwMaxVideoFrameBufferSize) {
+    image = realloc(synth->image, max_frame_size);
+    if (!image)
+      return UVC_ERROR_NO_MEM;
+    synth->image = image;
+  } else if (synth->image_bytes > max_frame_size) {
+    synth->image_bytes = max_frame_size;
+  }
+  frame_desc->dwMaxVideoFrameBufferSize = max_frame_size;
+
+  return UVC_SUCCESS;
+}
+
+/** @internal
+ * @brief Make every control request on the device take this long
+ *
+ * @param delay_us Emulated round-trip time in microseconds, 0 to answer at once
+ */
+void uvc_synthetic_set_ctrl_delay(uvc_device_handle_t *devh, uint32_t delay_us) {
+  devh->synthetic->ctrl_delay_us = delay_us;
+}
+
+/** @internal
+ * @brief Make brightness, gain and exposure changes show in the image
+ *
+ * Once enabled, writing one of these controls moves the luma of the
+ * producer's frames by the sum of their distances from their defaults.
+ * The image starts moving @p response_frames frames after the write and
+ * then ramps by up to 8 levels per frame, like a sensor pipeline followed
+ * by a smoothing ISP.
+ *
+ * @param enabled 0 to leave the image alone
+ * @param response_frames Frames before the image starts to change
+ */
+void uvc_synthetic_set_ctrl_response(uvc_device_handle_t *devh, int enabled,
+                                     uint32_t response_frames) {
+  uvc_synthetic_device_t *synth = devh->synthetic;
+
+  pthread_mutex_lock(&synth->ctrl_mutex);
+  synth->ctrl_response = enabled;
+  synth->response_frames = response_frames;
+  pthread_mutex_unlock(&synth->ctrl_mutex);
+}
+
+/** @internal
+ * @brief Work out where a control write sends the image's luma
+ *
+ * Called with ctrl_mutex held.
+ */
+static void _uvc_synthetic_ctrl_written(uvc_synthetic_device_t *synth) {
+  static const int affecting[] = {
+    UVC_CTRL_DEF_BRIGHTNESS, UVC_CTRL_DEF_GAIN, UVC_CTRL_DEF_EXPOSURE_ABS
+  };
+  int target = 0;
+  size_t i, j;
+
+  for (i = 0; i < sizeof(affecting) / sizeof(affecting[0]); ++i) {
+    const uvc_ctrl_def_t *def = &uvc_ctrl_defs[affecting[i]];
+
+    for (j = 0; j < synth->num_ctrls; ++j) {
+      uvc_synthetic_ctrl_t *ctrl = &synth->ctrls[j];
+
+      if (ctrl->selector == def->selector &&
+          ctrl->unit == (def->unit_type == UVC_CTRL_UNIT_CAMERA_TERMINAL
+                         ? SYNTHETIC_TERMINAL_ID : SYNTHETIC_PROCESSING_UNIT_ID))
+        target += (int) ctrl->cur[0] - ctrl->def[0];
+    }
+  }
+
+  if (target != synth->luma_target) {
+    synth->luma_target = target;
+    /* frames is advanced by the producer, which does not take ctrl_mutex */
+    synth->luma_target_frame = __atomic_load_n(&synth->frames, __ATOMIC_RELAXED) +
+                               synth->response_frames;
+  }
+}
+
+/** @internal
+ * @brief Move the image one step towards the luma the controls ask for
+ *
+ * Called with image_mutex held. A frame installed with
+ * uvc_synthetic_set_frame() is left as it is.
+ */
+static void _uvc_synthetic_step_response(uvc_synthetic_device_t *synth) {
+  int delta;
+
+  pthread_mutex_lock(&synth->ctrl_mutex);
+
+  delta = synth->luma_target - synth->luma_offset;
+  if (synth->ctrl_response && delta && synth->frames >= synth->luma_target_frame) {
+    if (delta > SYNTHETIC_LUMA_STEP)
+      delta = SYNTHETIC_LUMA_STEP;
+    else if (delta < -SYNTHETIC_LUMA_STEP)
+      delta = -SYNTHETIC_LUMA_STEP;
+    synth->luma_offset += delta;
+    if (!synth->custom_image)
+      _uvc_synthetic_fill_pattern(synth);
+  }
+
+  pthread_mutex_unlock(&synth->ctrl_mutex);
+}
+
+/** @internal
+ * @brief Answer a control request from the emulated controls
+ *
+ * Behaves like the control transfer a real device would see: unknown
+ * controls and rejected requests fail with UVC_ERROR_PIPE, as a stall would.
+ *
+ * @return Number of bytes transferred, or a uvc_error_t
+ */
+int uvc_synthetic_ctrl_transfer(uvc_device_handle_t *devh, enum uvc_req_code req_code,
+                                uint8_t unit, uint8_t selector, void *data, int len) {
+  uvc_synthetic_device_t *synth = devh->synthetic;
+  uvc_synthetic_ctrl_t *ctrl = NULL;
+  const uint8_t *src = NULL;
+  uint8_t *buf = data;
+  int ret = UVC_ERROR_PIPE;
+  size_t i;
+
+  if (synth->ctrl_delay_us) {
+    struct timespec ts;
+
+    ts.tv_sec = synth->ctrl_delay_us / 1000000;
+    ts.tv_nsec = (long) (synth->ctrl_delay_us % 1000000) * 1000;
+    while (nanosleep(&ts, &ts) == -1 && errno == EINTR)
+      ;
+  }
+
+  pthread_mutex_lock(&synth->ctrl_mutex);
+
+  for (i = 0; i < synth->num_ctrls; ++i) {
+    if (synth->ctrls[i].unit == unit && synth->ctrls[i].selector == selector) {
+      ctrl = &synth->ctrls[i];
+      break;
+    }
+  }
+
+  if (ctrl) {
+    switch (req_code) {
+    case UVC_SET_CUR:
+      if ((ctrl->info & UVC_CONTROL_CAP_SET) && len == ctrl->length) {
+        memcpy(ctrl->cur, data, len);
+        ret = len;
+        if (synth->ctrl_response)
+          _uvc_synthetic_ctrl_written(synth);
+      }
+      break;
+    case UVC_GET_CUR:
+      src = ctrl->cur;
+      break;
+    case UVC_GET_MIN:
+      src = ctrl->min;
+      break;
+    case UVC_GET_MAX:
+      src = ctrl->max;
+      break;
+    case UVC_GET_RES:
+      src = ctrl->res;
+      break;
+    case UVC_GET_DEF:
+      src = ctrl->def;
+      break;
+    case UVC_GET_LEN:
+      if (len >= 2) {
+        SHORT_TO_SW(ctrl->length, buf);
+        ret = 2;
+      }
+      break;
+    case UVC_GET_INFO:
+      if (len >= 1) {
+        buf[0] = ctrl->info;
+        ret = 1;
+      }
+      break;
+    default:
+      break;
+    }
+
+    if (src && len > 0) {
+      ret = len < ctrl->length ? len : ctrl->length;
+      memcpy(data, src, ret);
+    }
+  }
+
+  pthread_mutex_unlock(&synth->ctrl_mutex);
+
+  return ret;
+}
+
+/** @internal
+ * @brief Deliver a status packet as if it had come from the status endpoint
+ */
+void uvc_synthetic_status_packet(uvc_device_handle_t *devh, const uint8_t *data, int len) {
+  if (len > 0)
+    uvc_status_received(devh, data, len);
+}
+
+/** @internal
+ * @brief Hand one payload (iso packet or bulk transfer) to the stream
+ */
+void uvc_synthetic_feed(uvc_stream_handle_t *strmh, uint8_t *payload, size_t payload_len) {
+  _uvc_process_payload(strmh, payload, payload_len);
+  strmh->devh->synthetic->payloads++;
+}
+
+/** @internal
+ * @brief Split a frame into payloads and feed them to the stream
+ *
+ * Each payload carries a 12-byte header with PTS and SCR; the FID bit
+ * toggles per frame and EOF marks the last payload.
+ *
+ * @return Number of payloads generated
+ */
+size_t uvc_synthetic_push_frame(uvc_stream_handle_t *strmh,
+                                const uint8_t *data, size_t data_bytes) {
+  uvc_synthetic_device_t *synth = strmh->devh->synthetic;
+  size_t chunk = synth->max_payload - SYNTHETIC_HEADER_LEN;
+  size_t offset = 0;
+  size_t count = 0;
+  uint32_t pts = synth->frames * (synth->interval ? synth->interval : 1);
+  uint8_t fid = synth->frames & 1;
+
+  do {
+    size_t len = data_bytes - offset < chunk ? data_bytes - offset : chunk;
+    uint32_t stc = (uint32_t) synth->payloads;
+    uint8_t *hdr = synth->payload_buf;
+
+    hdr[0] = SYNTHETIC_HEADER_LEN;
+    hdr[1] = UVC_STREAM_EOH | UVC_STREAM_PTS | UVC_STREAM_SCR | fid;
+    if (offset + len == data_bytes)
+      hdr[1] |= UVC_STREAM_EOF;
+    INT_TO_DW(pts, hdr + 2);
+    INT_TO_DW(stc, hdr + 6);
+    SHORT_TO_SW(count, hdr + 10);
+    memcpy(hdr + SYNTHETIC_HEADER_LEN, data + offset, len);
+
+    uvc_synthetic_feed(strmh, hdr, SYNTHETIC_HEADER_LEN + len);
+
+    offset += len;
+    count++;
+  } while (offset < data_bytes);
+
+  __atomic_add_fetch(&synth->frames, 1, __ATOMIC_RELAXED);
+
+  return count;
+}
+
+/** @internal
+ * @brief Producer thread standing in for the USB event handler
+ */
+static void *_uvc_synthetic_producer(void *arg) {
+  uvc_stream_handle_t *strmh = (uvc_stream_handle_t *) arg;
+  uvc_synthetic_device_t *synth = strmh->devh->synthetic;
+  struct timespec next;
+
+  clock_gettime(CLOCK_MONOTONIC, &next);
+
+  while (synth->producer_running) {
+    pthread_mutex_lock(&synth->image_mutex);
+    _uvc_synthetic_step_response(synth);
+    uvc_synthetic_push_frame(strmh, synth->image, synth->image_bytes);
+    pthread_mutex_unlock(&synth->image_mutex);
+
+    if (synth->interval) {
+      next.tv_nsec += (long) synth->interval * 100;
+      next.tv_sec += next.tv_nsec / 1000000000;
+      next.tv_nsec %= 1000000000;
+      while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL) == EINTR)
+        ;
+    }
+  }
+
+  return NULL;
+}
+
+/** @internal
+ * @brief Start streaming from a synthetic device
+ *
+ * Mirrors uvc_stream_open_ctrl() followed by uvc_stream_start(), minus the
+ * USB traffic. With UVC_SYNTHETIC_PRODUCER set in @p flags, a thread pushes
+ * frames at the advertised frame interval; otherwise the caller drives the
+ * stream with uvc_synthetic_push_frame() or uvc_synthetic_feed().
+ *
+ * @param devh Synthetic device
+ * @param[out] strmhp New stream handle
+ * @param cb User callback function, or NULL to poll with uvc_stream_get_frame()
+ * @param user_ptr Passed to @p cb
+ * @param flags UVC_SYNTHETIC_* flags
+ */
+uvc_error_t uvc_synthetic_stream_start(
+    uvc_device_handle_t *devh,
+    uvc_stream_handle_t **strmhp,
+    uvc_frame_callback_t *cb,
+    void *user_ptr,
+    uint8_t flags) {
+  uvc_synthetic_device_t *synth = devh->synthetic;
+  uvc_frame_desc_t *frame_desc;
+  uvc_stream_handle_t *strmh;
+
+  UVC_ENTER();
+
+  if (!synth || devh->streams) {
+    UVC_EXIT(UVC_ERROR_BUSY);
+    return UVC_ERROR_BUSY;
+  }
+
+  frame_desc = devh->info->stream_ifs->format_descs->frame_descs;
+
+  strmh = calloc(1, sizeof(*strmh));
+  synth->payload_buf = malloc(synth->max_payload);
+  if (!strmh || !synth->payload_buf) {
+    free(strmh);
+    free(synth->payload_buf);
+    synth->payload_buf = NULL;
+    UVC_EXIT(UVC_ERROR_NO_MEM);
+    return UVC_ERROR_NO_MEM;
+  }
+
+  strmh->devh = devh;
+  strmh->stream_if = devh->info->stream_ifs;
+  strmh->frame.library_owns_data = 1;
+
+  strmh->cur_ctrl.bmHint = 1;
+  strmh->cur_ctrl.bFormatIndex = 1;
+  strmh->cur_ctrl.bFrameIndex = 1;
+  strmh->cur_ctrl.dwFrameInterval = synth->interval;
+  strmh->cur_ctrl.dwMaxVideoFrameSize = frame_desc->dwMaxVideoFrameBufferSize;
+  strmh->cur_ctrl.dwMaxPayloadTransferSize = synth->max_payload;
+  strmh->cur_ctrl.dwClockFrequency = devh->info->ctrl_if.dwClockFrequency;
+  strmh->cur_ctrl.bInterfaceNumber = strmh->stream_if->bInterfaceNumber;
+
+  strmh->outbuf = malloc(strmh->cur_ctrl.dwMaxVideoFrameSize);
+  strmh->holdbuf = malloc(strmh->cur_ctrl.dwMaxVideoFrameSize);
+  strmh->meta_outbuf = malloc(LIBUVC_XFER_META_BUF_SIZE);
+  strmh->meta_holdbuf = malloc(LIBUVC_XFER_META_BUF_SIZE);
+
+  pthread_mutex_init(&strmh->cb_mutex, NULL);
+  pthread_cond_init(&strmh->cb_cond, NULL);
+
+  DL_APPEND(devh->streams, strmh);
+
+  strmh->running = 1;
+  strmh->seq = 1;
+  _uvc_stream_set_mode(strmh, frame_desc, synth->format);
+  strmh->user_cb = cb;
+  strmh->user_ptr = user_ptr;
+
+  if (cb)
+    pthread_create(&strmh->cb_thread, NULL, _uvc_user_caller, (void*) strmh);
+
+  if (flags & UVC_SYNTHETIC_PRODUCER) {
+    synth->producer_running = 1;
+    pthread_create(&synth->producer, NULL, _uvc_synthetic_producer, (void*) strmh);
+  }
+
+  *strmhp = strmh;
+
+  UVC_EXIT(UVC_SUCCESS);
+  return UVC_SUCCESS;
+}
+
+/** @internal
+ * @brief Stop and free a stream started with uvc_synthetic_stream_start()
+ */
+void uvc_synthetic_stream_stop(uvc_stream_handle_t *strmh) {
+  uvc_device_handle_t *devh = strmh->devh;
+  uvc_synthetic_device_t *synth = devh->synthetic;
+
+  UVC_ENTER();
+
+  if (synth->producer_running) {
+    synth->producer_running = 0;
+    pthread_join(synth->producer, NULL);
+  }
+
+  pthread_mutex_lock(&strmh->cb_mutex);
+  strmh->running = 0;
+  pthread_cond_broadcast(&strmh->cb_cond);
+  pthread_mutex_unlock(&strmh->cb_mutex);
+
+  if (strmh->user_cb)
+    pthread_join(strmh->cb_thread, NULL);
+
+  if (strmh->frame.data)
+    free(strmh->frame.data);
+
+  free(strmh->outbuf);
+  free(strmh->holdbuf);
+  free(strmh->meta_outbuf);
+  free(strmh->meta_holdbuf);
+
+  pthread_cond_destroy(&strmh->cb_cond);
+  pthread_mutex_destroy(&strmh->cb_mutex);
+
+  DL_DELETE(devh->streams, strmh);
+  free(strmh);
+
+  free(synth->payload_buf);
+  synth->payload_buf = NULL;
+
+  UVC_EXIT_VOID();
+}
+
+/** @internal
+ * @brief Release a synthetic device and any stream still running on it
+ */
+void uvc_synthetic_close(uvc_device_handle_t *devh) {
+  UVC_ENTER();
+
+  if (devh->streams)
+    uvc_synthetic_stream_stop(devh->streams);
+
+  uvc_stop_ctrl_writer(devh);
+
+  if (devh->synthetic) {
+    free(devh->synthetic->image);
+    free(devh->synthetic->ctrls);
+    pthread_mutex_destroy(&devh->synthetic->ctrl_mutex);
+    pthread_mutex_destroy(&devh->synthetic->image_mutex);
+    free(devh->synthetic);
+  }
+
+  free(devh->dev);
+  uvc_free_devh(devh);
+
+  UVC_EXIT_VOID();
+}
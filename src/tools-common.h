@@ -0,0 +1,182 @@
+/** @file tools-common.h
+ * @brief Small helpers shared by the command-line tools in src/.
+ *
+ * Not part of the library; every function here is static inline so each tool
+ * stays a single translation unit.
+ */
+#ifndef LIBUVC_TOOLS_COMMON_H
+#define LIBUVC_TOOLS_COMMON_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/resource.h>
+
+#include "libuvc/libuvc.h"
+
+static const struct {
+  const char *name;
+  enum uvc_frame_format format;
+} tool_formats[] = {
+  { "any", UVC_FRAME_FORMAT_ANY },
+  { "yuyv", UVC_FRAME_FORMAT_YUYV },
+  { "uyvy", UVC_FRAME_FORMAT_UYVY },
+  { "nv12", UVC_FRAME_FORMAT_NV12 },
+  { "gray8", UVC_FRAME_FORMAT_GRAY8 },
+  { "bgr", UVC_FRAME_FORMAT_BGR },
+  { "mjpeg", UVC_FRAME_FORMAT_MJPEG },
+  { "h264", UVC_FRAME_FORMAT_H264 },
+};
+
+/** Parse a format name as accepted on the command line (case-insensitive) */
+static inline int tool_parse_format(const char *name, enum uvc_frame_format *format) {
+  size_t i;
+
+  for (i = 0; i < sizeof(tool_formats) / sizeof(tool_formats[0]); ++i) {
+    if (!strcasecmp(name, tool_formats[i].name)) {
+      *format = tool_formats[i].format;
+      return 0;
+    }
+  }
+
+  return -1;
+}
+
+static inline const char *tool_format_name(enum uvc_frame_format format) {
+  size_t i;
+
+  for (i = 0; i < sizeof(tool_formats) / sizeof(tool_formats[0]); ++i) {
+    if (tool_formats[i].format == format)
+      return tool_formats[i].name;
+  }
+
+  return "unknown";
+}
+
+#define TOOL_PAYLOAD_ERROR_SLOTS 11
+
+/** Slot (0 to TOOL_PAYLOAD_ERROR_SLOTS - 1) of a payload error code */
+static inline int tool_payload_error_slot(payload_error_t code) {
+  if (code <= 0 && code >= PAYLOAD_ERROR_FRAME_ID_FLIPPED)
+    return -code;
+  return TOOL_PAYLOAD_ERROR_SLOTS - 1;
+}
+
+/** Name of a slot returned by tool_payload_error_slot() */
+static inline const char *tool_payload_error_name(int slot) {
+  static const char *const names[TOOL_PAYLOAD_ERROR_SLOTS] = {
+    "none", "small_header_length", "big_header_length", "invalid_header_length",
+    "reserved_bit_set", "error_bit_set", "wrong_end_of_packet", "overflow",
+    "no_end_of_header", "frame_id_flipped", "unknown"
+  };
+
+  return slot >= 0 && slot < TOOL_PAYLOAD_ERROR_SLOTS ? names[slot] : "unknown";
+}
+
+/** Parse "WIDTHxHEIGHT" */
+static inline int tool_parse_size(const char *arg, int *width, int *height) {
+  return sscanf(arg, "%dx%d", width, height) == 2 && *width > 0 && *height > 0 ? 0 : -1;
+}
+
+/** Monotonic time in seconds */
+static inline double tool_now(void) {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static inline double tool_timespec_sec(const struct timespec *ts) {
+  return ts->tv_sec + ts->tv_nsec / 1e9;
+}
+
+/** CPU time consumed by a thread, in seconds, or -1 if unavailable */
+static inline double tool_thread_cpu(pthread_t thread) {
+#if defined(_POSIX_THREAD_CPUTIME) && _POSIX_THREAD_CPUTIME >= 0
+  clockid_t clk;
+  struct timespec ts;
+
+  if (pthread_getcpuclockid(thread, &clk) == 0 && clock_gettime(clk, &ts) == 0)
+    return tool_timespec_sec(&ts);
+#else
+  (void) thread;
+#endif
+  return -1;
+}
+
+/** CPU time consumed by the whole process (user + system), in seconds */
+static inline double tool_process_cpu(void) {
+  struct rusage ru;
+
+  getrusage(RUSAGE_SELF, &ru);
+  return ru.ru_utime.tv_sec + ru.ru_utime.tv_usec / 1e6 +
+    ru.ru_stime.tv_sec + ru.ru_stime.tv_usec / 1e6;
+}
+
+/** Current and peak resident set size of the process in kB.
+ * The current value is 0 where /proc is not available. */
+static inline void tool_memory_kb(long *rss_kb, long *peak_kb) {
+  struct rusage ru;
+  FILE *fp;
+  char line[128];
+
+  *rss_kb = 0;
+  *peak_kb = 0;
+
+  fp = fopen("/proc/self/status", "r");
+  if (fp) {
+    while (fgets(line, sizeof(line), fp)) {
+      if (!strncmp(line, "VmRSS:", 6))
+        *rss_kb = strtol(line + 6, NULL, 10);
+      else if (!strncmp(line, "VmHWM:", 6))
+        *peak_kb = strtol(line + 6, NULL, 10);
+    }
+    fclose(fp);
+  }
+
+  if (*peak_kb == 0) {
+    getrusage(RUSAGE_SELF, &ru);
+#if defined(__APPLE__) && defined(__MACH__)
+    *peak_kb = ru.ru_maxrss / 1024;
+#else
+    *peak_kb = ru.ru_maxrss;
+#endif
+  }
+}
+
+/** qsort() comparator for doubles */
+static inline int tool_compare_double(const void *a, const void *b) {
+  double x = *(const double *) a, y = *(const double *) b;
+  return x < y ? -1 : x > y;
+}
+
+/** Nearest-rank percentile (0-100) of @p count sorted samples */
+static inline double tool_percentile(const double *sorted, size_t count, double pct) {
+  size_t rank;
+
+  if (count == 0)
+    return 0;
+
+  rank = (size_t) (pct / 100 * count);
+  return sorted[rank < count ? rank : count - 1];
+}
+
+/** Write a string as a JSON string literal */
+static inline void tool_json_string(FILE *fp, const char *s) {
+  fputc('"', fp);
+  for (; s && *s; ++s) {
+    if (*s == '"' || *s == '\\')
+      fprintf(fp, "\\%c", *s);
+    else if ((unsigned char) *s < 0x20)
+      fprintf(fp, "\\u%04x", *s);
+    else
+      fputc(*s, fp);
+  }
+  fputc('"', fp);
+}
+
+#endif // !def(LIBUVC_TOOLS_COMMON_H)
@@ -0,0 +1,399 @@
+/* uvc-usbmon-import: extract VideoStreaming payloads from a usbmon capture.
+ *
+ * Reads a Linux usbmon capture in pcap or pcapng format (link types
+ * LINKTYPE_USB_LINUX and LINKTYPE_USB_LINUX_MMAPPED, as written by
+ * Wireshark, dumpcap or tcpdump -i usbmonN), keeps the completed IN
+ * transfers of one isochronous or bulk endpoint, and writes them to a
+ * replay file for uvc-replay. Isochronous transfers keep their per-packet
+ * status and length; those need the 64-byte "mmapped" header, which is
+ * what current kernels and capture tools produce.
+ */
+#include "libuvc/libuvc.h"
+#include "libuvc/libuvc_internal.h"
+
+#include <errno.h>
+#include <getopt.h>
+
+#define LINKTYPE_USB_LINUX 189
+#define LINKTYPE_USB_LINUX_MMAPPED 220
+
+#define USBMON_XFER_ISO 0
+#define USBMON_XFER_BULK 3
+
+#define PCAPNG_SHB 0x0A0D0D0A
+#define PCAPNG_IDB 1
+#define PCAPNG_SPB 3
+#define PCAPNG_EPB 6
+
+#define MAX_INTERFACES 64
+
+struct import_state {
+  int bus, device, endpoint;
+  int swap;
+  FILE *out;
+  uvc_replay_record_t rec;
+  uint64_t transfers, packets, bad_packets, truncated_packets, bytes, skipped_189_iso;
+};
+
+static uint16_t rd16(const uint8_t *p, int swap) {
+  return swap ? (uint16_t) (p[0] << 8 | p[1]) : (uint16_t) (p[1] << 8 | p[0]);
+}
+
+static uint32_t rd32(const uint8_t *p, int swap) {
+  return swap
+    ? (uint32_t) p[0] << 24 | (uint32_t) p[1] << 16 | (uint32_t) p[2] << 8 | p[3]
+    : (uint32_t) p[3] << 24 | (uint32_t) p[2] << 16 | (uint32_t) p[1] << 8 | p[0];
+}
+
+static uint64_t rd64(const uint8_t *p, int swap) {
+  return swap
+    ? (uint64_t) rd32(p, 1) << 32 | rd32(p + 4, 1)
+    : (uint64_t) rd32(p + 4, 0) << 32 | rd32(p, 0);
+}
+
+static int reserve_data(uvc_replay_record_t *rec, uint32_t len) {
+  if (len > rec->data_alloc) {
+    void *p = realloc(rec->data, len);
+    if (!p)
+      return -1;
+    rec->data = p;
+    rec->data_alloc = len;
+  }
+
+  return 0;
+}
+
+/** Handle one captured usbmon event */
+static int import_usbmon(struct import_state *st, int linktype,
+                         const uint8_t *pkt, uint32_t caplen) {
+  size_t hdr_len = linktype == LINKTYPE_USB_LINUX_MMAPPED ? 64 : 48;
+  uint8_t event, xfer_type, ep, dev;
+  uint16_t bus;
+  uint32_t len_cap, ndesc = 0, i;
+  const uint8_t *data;
+  size_t data_avail;
+  uvc_replay_record_t *rec = &st->rec;
+
+  if (caplen < hdr_len)
+    return 0;
+
+  event = pkt[8];
+  xfer_type = pkt[9];
+  ep = pkt[10];
+  dev = pkt[11];
+  bus = rd16(pkt + 12, st->swap);
+
+  /* completions of IN isochronous or bulk transfers only */
+  if (event != 'C' || !(ep & 0x80) || (ep & 0x7f) == 0 ||
+      (xfer_type != USBMON_XFER_ISO && xfer_type != USBMON_XFER_BULK))
+    return 0;
+
+  if (st->bus < 0 || st->device < 0 || st->endpoint < 0) {
+    if ((st->bus >= 0 && st->bus != bus) || (st->device >= 0 && st->device != dev) ||
+        (st->endpoint >= 0 && st->endpoint != ep))
+      return 0;
+    st->bus = bus;
+    st->device = dev;
+    st->endpoint = ep;
+    fprintf(stderr, "using bus %u device %u endpoint 0x%02x (%s)\n", bus, dev, ep,
+            xfer_type == USBMON_XFER_ISO ? "isochronous" : "bulk");
+  } else if (st->bus != bus || st->device != dev || st->endpoint != ep) {
+    return 0;
+  }
+
+  if (ftell(st->out) == 0) {
+    uvc_replay_header_t hdr = { (uint8_t) bus, dev, ep };
+    if (uvc_replay_write_header(st->out, &hdr))
+      return -1;
+  }
+
+  len_cap = rd32(pkt + 36, st->swap);
+  rec->status = (int32_t) rd32(pkt + 28, st->swap);
+  rec->timestamp_us = rd64(pkt + 16, st->swap) * 1000000ull + rd32(pkt + 24, st->swap);
+
+  if (xfer_type == USBMON_XFER_BULK) {
+    data_avail = caplen - hdr_len;
+    rec->type = UVC_REPLAY_BULK;
+    rec->num_packets = 0;
+    rec->data_len = (uint32_t) (len_cap < data_avail ? len_cap : data_avail);
+    if (reserve_data(rec, rec->data_len))
+      return -1;
+    memcpy(rec->data, pkt + hdr_len, rec->data_len);
+  } else {
+    if (linktype != LINKTYPE_USB_LINUX_MMAPPED) {
+      /* no per-packet descriptors in the 48-byte header */
+      st->skipped_189_iso++;
+      return 0;
+    }
+
+    ndesc = rd32(pkt + 60, st->swap);
+    if (hdr_len + (size_t) ndesc * 16 > caplen)
+      return 0;
+
+    data = pkt + hdr_len + ndesc * 16;
+    data_avail = caplen - hdr_len - ndesc * 16;
+
+    if (ndesc > rec->packets_alloc) {
+      void *p = realloc(rec->packets, ndesc * sizeof(*rec->packets));
+      if (!p)
+        return -1;
+      rec->packets = p;
+      rec->packets_alloc = ndesc;
+    }
+
+    rec->type = UVC_REPLAY_ISOCHRONOUS;
+    rec->num_packets = ndesc;
+    rec->data_len = 0;
+
+    /* first pass: lengths, to size the compacted buffer */
+    for (i = 0; i < ndesc; ++i) {
+      const uint8_t *d = pkt + hdr_len + i * 16;
+      uint32_t off = rd32(d + 4, st->swap);
+      uint32_t len = rd32(d + 8, st->swap);
+
+      rec->packets[i].status = (int32_t) rd32(d, st->swap);
+      if (off > data_avail) {
+        len = 0;
+      } else if (len > data_avail - off) {
+        len = (uint32_t) (data_avail - off);
+      }
+      if (len != rd32(d + 8, st->swap)) {
+        /* not fully captured (snaplen); replay skips it */
+        rec->packets[i].status = -ENODATA;
+        st->truncated_packets++;
+      }
+      rec->packets[i].length = len;
+      rec->data_len += len;
+      if (rec->packets[i].status != 0)
+        st->bad_packets++;
+    }
+
+    if (reserve_data(rec, rec->data_len))
+      return -1;
+
+    rec->data_len = 0;
+    for (i = 0; i < ndesc; ++i) {
+      uint32_t off = rd32(pkt + hdr_len + i * 16 + 4, st->swap);
+      memcpy(rec->data + rec->data_len, data + off, rec->packets[i].length);
+      rec->data_len += rec->packets[i].length;
+    }
+    st->packets += ndesc;
+  }
+
+  st->transfers++;
+  st->bytes += rec->data_len;
+
+  return uvc_replay_write_record(st->out, rec) ? -1 : 0;
+}
+
+static int import_pcap(struct import_state *st, FILE *in, const uint8_t *magic) {
+  uint8_t hdr[24], rechdr[16];
+  uint32_t m = rd32(magic, 0), linktype;
+  uint8_t *buf = NULL;
+  size_t buf_size = 0;
+
+  st->swap = (m == 0xd4c3b2a1 || m == 0x4d3cb2a1);
+  memcpy(hdr, magic, 4);
+  if (fread(hdr + 4, 20, 1, in) != 1)
+    return -1;
+
+  linktype = rd32(hdr + 20, st->swap) & 0x0fffffff;
+  if (linktype != LINKTYPE_USB_LINUX && linktype != LINKTYPE_USB_LINUX_MMAPPED) {
+    fprintf(stderr, "not a usbmon capture (link type %u)\n", linktype);
+    return -1;
+  }
+
+  while (fread(rechdr, sizeof(rechdr), 1, in) == 1) {
+    uint32_t caplen = rd32(rechdr + 8, st->swap);
+
+    if (caplen > buf_size) {
+      uint8_t *p = realloc(buf, caplen);
+      if (!p)
+        break;
+      buf = p;
+      buf_size = caplen;
+    }
+    if (caplen && fread(buf, caplen, 1, in) != 1)
+      break;
+    if (import_usbmon(st, (int) linktype, buf, caplen))
+      break;
+  }
+
+  free(buf);
+  return 0;
+}
+
+static int import_pcapng(struct import_state *st, FILE *in, const uint8_t *magic) {
+  int linktypes[MAX_INTERFACES];
+  int num_ifaces = 0;
+  uint8_t bhdr[8];
+  uint8_t *buf = NULL;
+  size_t buf_size = 0;
+  int first = 1;
+
+  memcpy(bhdr, magic, 4);
+  if (fread(bhdr + 4, 4, 1, in) != 1)
+    return -1;
+
+  for (;;) {
+    uint32_t type, len, body;
+
+    if (!first && fread(bhdr, sizeof(bhdr), 1, in) != 1)
+      break;
+
+    if (first || rd32(bhdr, 0) == PCAPNG_SHB) {
+      uint8_t bom[4];
+
+      /* byte order comes from the section header's magic */
+      if (fread(bom, 4, 1, in) != 1)
+        break;
+      st->swap = rd32(bom, 0) != 0x1A2B3C4D;
+      len = rd32(bhdr + 4, st->swap);
+      if (len < 16 || fseek(in, len - 12, SEEK_CUR))
+        break;
+      num_ifaces = 0;
+      first = 0;
+      continue;
+    }
+
+    type = rd32(bhdr, st->swap);
+    len = rd32(bhdr + 4, st->swap);
+    if (len < 12)
+      break;
+    body = len - 8;
+
+    if (body > buf_size) {
+      uint8_t *p = realloc(buf, body);
+      if (!p)
+        break;
+      buf = p;
+      buf_size = body;
+    }
+    if (fread(buf, body, 1, in) != 1)
+      break;
+
+    if (type == PCAPNG_IDB && body >= 8) {
+      if (num_ifaces < MAX_INTERFACES)
+        linktypes[num_ifaces++] = rd16(buf, st->swap);
+    } else if (type == PCAPNG_EPB && body >= 24) {
+      uint32_t iface = rd32(buf, st->swap);
+      uint32_t caplen = rd32(buf + 12, st->swap);
+
+      if (iface < (uint32_t) num_ifaces && caplen <= body - 24 &&
+          (linktypes[iface] == LINKTYPE_USB_LINUX ||
+           linktypes[iface] == LINKTYPE_USB_LINUX_MMAPPED)) {
+        if (import_usbmon(st, linktypes[iface], buf + 20, caplen))
+          break;
+      }
+    } else if (type == PCAPNG_SPB && body >= 8 && num_ifaces > 0) {
+      if (linktypes[0] == LINKTYPE_USB_LINUX || linktypes[0] == LINKTYPE_USB_LINUX_MMAPPED) {
+        uint32_t caplen = body - 8;
+        uint32_t origlen = rd32(buf, st->swap);
+        if (import_usbmon(st, linktypes[0], buf + 4, origlen < caplen ? origlen : caplen))
+          break;
+      }
+    }
+  }
+
+  free(buf);
+  return 0;
+}
+
+static void usage(const char *argv0) {
+  fprintf(stderr,
+          "Usage: %s [options] CAPTURE.pcap[ng] OUTPUT.uvcr\n"
+          "  -b, --bus N        USB bus number (default: first match)\n"
+          "  -d, --device N     USB device address (default: first match)\n"
+          "  -e, --endpoint EP  IN endpoint address, e.g. 0x81 (default: first match)\n",
+          argv0);
+}
+
+int main(int argc, char **argv) {
+  static const struct option long_options[] = {
+    { "bus", required_argument, NULL, 'b' },
+    { "device", required_argument, NULL, 'd' },
+    { "endpoint", required_argument, NULL, 'e' },
+    { "help", no_argument, NULL, 'h' },
+    { NULL, 0, NULL, 0 }
+  };
+  struct import_state st;
+  uint8_t magic[4];
+  FILE *in;
+  int opt, ret;
+
+  memset(&st, 0, sizeof(st));
+  st.bus = st.device = st.endpoint = -1;
+
+  while ((opt = getopt_long(argc, argv, "b:d:e:h", long_options, NULL)) != -1) {
+    switch (opt) {
+    case 'b':
+      st.bus = (int) strtol(optarg, NULL, 0);
+      break;
+    case 'd':
+      st.device = (int) strtol(optarg, NULL, 0);
+      break;
+    case 'e':
+      st.endpoint = (int) strtol(optarg, NULL, 0) | 0x80;
+      break;
+    default:
+      usage(argv[0]);
+      return opt == 'h' ? 0 : 1;
+    }
+  }
+
+  if (argc - optind != 2) {
+    usage(argv[0]);
+    return 1;
+  }
+
+  in = fopen(argv[optind], "rb");
+  if (!in) {
+    perror(argv[optind]);
+    return 1;
+  }
+  st.out = fopen(argv[optind + 1], "wb");
+  if (!st.out) {
+    perror(argv[optind + 1]);
+    fclose(in);
+    return 1;
+  }
+
+  if (fread(magic, 4, 1, in) != 1) {
+    fprintf(stderr, "%s: empty file\n", argv[optind]);
+    ret = -1;
+  } else if (rd32(magic, 0) == PCAPNG_SHB) {
+    ret = import_pcapng(&st, in, magic);
+  } else {
+    uint32_t m = rd32(magic, 0);
+    if (m == 0xa1b2c3d4 || m == 0xd4c3b2a1 || m == 0xa1b23c4d || m == 0x4d3cb2a1) {
+      ret = import_pcap(&st, in, magic);
+    } else {
+      fprintf(stderr, "%s: not a pcap or pcapng file\n", argv[optind]);
+      ret = -1;
+    }
+  }
+
+  fclose(in);
+  fclose(st.out);
+  uvc_replay_free_record(&st.rec);
+
+  if (ret)
+    return 1;
+
+  if (st.transfers == 0) {
+    fprintf(stderr, "no matching isochronous or bulk IN transfers found\n");
+    if (st.skipped_189_iso)
+      fprintf(stderr, "%llu isochronous transfers skipped: capture lacks per-packet "
+              "descriptors (use LINKTYPE_USB_LINUX_MMAPPED)\n",
+              (unsigned long long) st.skipped_189_iso);
+    return 1;
+  }
+
+  printf("transfers: %llu\nisochronous packets: %llu (%llu with error status, "
+         "%llu truncated by snaplen)\npayload bytes: %llu\n",
+         (unsigned long long) st.transfers, (unsigned long long) st.packets,
+         (unsigned long long) st.bad_packets, (unsigned long long) st.truncated_packets,
+         (unsigned long long) st.bytes);
+
+  return 0;
+}